@@ -7,6 +7,7 @@
 
 #include <cstdlib> // EXIT_SUCCESS
 #include <iostream>
+#include <string>
 
 int main(int ac, char **av)
 //
@@ -21,11 +22,16 @@ int main(int ac, char **av)
 //   snapshotDeltaRecReset     : reset and clear previous snapshotDelta rec info and status
 //   snapshotDeltaRecDump file : output snapshotDelta rec info to the file. required "stop" first.
 //
+// With -extrapolation option, this program shows tile extrapolation timing (non cached vs cached)
+// and cache hit rate instead of pack-tile analysis.
+//
 {
-    if (ac != 2) {
-        std::cerr << "Usage : " << av[0] << " snapshotDeltaDumpFile" << std::endl;
-    } else {
+    if (ac == 2) {
         scene_rdl2::grid_util::PackTilesTest::replaySnapshotDelta(av[1]);
+    } else if (ac == 3 && std::string(av[2]) == "-extrapolation") {
+        scene_rdl2::grid_util::PackTilesTest::replaySnapshotDeltaExtrapolation(av[1]);
+    } else {
+        std::cerr << "Usage : " << av[0] << " snapshotDeltaDumpFile [-extrapolation]" << std::endl;
     }
 
     return EXIT_SUCCESS;
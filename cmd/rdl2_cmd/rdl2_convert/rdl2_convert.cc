@@ -1,14 +1,23 @@
 // Copyright 2023 DreamWorks Animation LLC
 // SPDX-License-Identifier: Apache-2.0
 
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/scene/rdl2/rdl2.h>
 #include <scene_rdl2/render/logging/logging.h>
+#include <scene_rdl2/render/util/Files.h>
 
 #include <boost/program_options.hpp>
 
 #include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
 
 using namespace scene_rdl2;
 
@@ -27,6 +36,43 @@ printUsage(std::ostream& o, const char* name, const po::options_description& opt
             options << std::endl;
 }
 
+size_t
+fileSize(const std::string& filename)
+{
+    struct stat statBuf;
+    return (stat(filename.c_str(), &statBuf) == 0) ? static_cast<size_t>(statBuf.st_size) : 0;
+}
+
+// Total size of the written file. Split mode (no extension) writes both .rdla and .rdlb
+size_t
+outputSize(const std::string& filename)
+{
+    if (util::lowerCaseExtension(filename).empty()) {
+        return fileSize(filename + ".rdla") + fileSize(filename + ".rdlb");
+    }
+    return fileSize(filename);
+}
+
+size_t
+peakRssKB()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss); // KByte on linux
+}
+
+std::string
+throughputStr(const size_t bytes, const size_t objects, const float sec)
+{
+    const float mb = static_cast<float>(bytes) / (1024.0f * 1024.0f);
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(3) << sec << " sec "
+         << std::setprecision(2) << mb << " MB "
+         << ((sec > 0.0f) ? mb / sec : 0.0f) << " MB/sec "
+         << std::setprecision(0) << ((sec > 0.0f) ? static_cast<float>(objects) / sec : 0.0f) << " objects/sec";
+    return ostr.str();
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
@@ -41,6 +87,10 @@ int main(int argc, char* argv[])
         ("in,i", po::value<std::string>()->required(), "Input file (.rdla | .rdlb)")
         ("out,o", po::value<std::string>()->required(), "Output file (.rdla | .rdlb)")
         ("elements,e", po::value<size_t>(&elemsPerLine)->default_value(0), "Number of ascii array elements per-line, 0=unlimited")
+        ("serial,s", "Disable parallel binary decode/encode")
+        ("benchmark,b", "Report read/write time, throughput and peak RSS")
+        ("root,r", po::value<std::vector<std::string>>()->multitoken(),
+            "Only convert the given SceneObjects and everything they reference (rdla input only)")
         ("dso_path,d", po::value<std::string>(),
             "The path to the dsos"); // dummy to please boost, will parse below;
 
@@ -83,11 +133,45 @@ int main(int argc, char* argv[])
         if (!dsoPath.empty()) {
             context.setDsoPath(dsoPath);
         }
-        rdl2::readSceneFromFile(varsMap["in"].as<std::string>(), context);
-        rdl2::writeSceneToFile(context, varsMap["out"].as<std::string>(),
+
+        const std::string inFile = varsMap["in"].as<std::string>();
+        const std::string outFile = varsMap["out"].as<std::string>();
+        const bool parallel = !varsMap.count("serial");
+
+        rec_time::RecTime recTime;
+        recTime.start();
+        if (varsMap.count("root")) {
+            if (util::lowerCaseExtension(inFile) != "rdla") {
+                throw except::ValueError("--root requires .rdla input");
+            }
+            rdl2::AsciiReader reader(context);
+            reader.fromFileSubset(inFile, varsMap["root"].as<std::vector<std::string>>());
+        } else {
+            rdl2::readSceneFromFile(inFile, context, parallel);
+        }
+        const float readSec = recTime.end();
+        const size_t readPeakRss = peakRssKB();
+
+        recTime.start();
+        rdl2::writeSceneToFile(context, outFile,
                                true, // deltaEncoding
                                true, // skipDefaults
-                               elemsPerLine);
+                               elemsPerLine,
+                               parallel);
+        const float writeSec = recTime.end();
+
+        if (varsMap.count("benchmark")) {
+            size_t objects = 0;
+            for (auto itr = context.beginSceneObject(); itr != context.endSceneObject(); ++itr) ++objects;
+
+            std::cerr << "rdl2_convert benchmark (" << (parallel ? "parallel" : "serial") << ") {\n"
+                      << "  objects:" << objects << '\n'
+                      << "  read  : " << throughputStr(fileSize(inFile), objects, readSec) << '\n'
+                      << "  write : " << throughputStr(outputSize(outFile), objects, writeSec) << '\n'
+                      << "  peakRSS after read : " << readPeakRss / 1024 << " MB\n"
+                      << "  peakRSS after write: " << peakRssKB() / 1024 << " MB\n"
+                      << "}" << std::endl;
+        }
     } catch (std::exception& e) {
         logging::Logger::error(e.what());
         return EXIT_FAILURE;
@@ -8,6 +8,7 @@
 
 // Library
 #include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/render/logging/logging.h>
 #include <scene_rdl2/scene/rdl2/rdl2.h>
 #include <scene_rdl2/scene/rdl2/Types.h>
@@ -30,6 +31,11 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <libgen.h>
+#include <sys/resource.h>
+
+// TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 // Boost
 #include <boost/program_options.hpp>
@@ -50,6 +56,8 @@ const std::string BO_BUILT_IN_S = "builtin";
 const std::string BO_SPARSED_S = "sparse";
 const std::string BO_RDL2_VERSION_S = "rdl2_version";
 const std::string BO_MOONRAY_VERSION_S = "moonray_version";
+const std::string BO_SERIAL_S = "serial";
+const std::string BO_BENCHMARK_S = "benchmark";
 
 const std::string JSON_EXTENSION = ".json";
 const std::string PATH_SEPARATOR = bf::path("/").string(); // make native path separator
@@ -72,6 +80,18 @@ const std::string ATTR_BIND_LABEL = "bindable";
 const std::string ATTR_FILENAME_LABEL = "filename";
 const std::string ATTR_INTERFACE_LABEL = "interface";
 
+const std::string SCENE_CLASSES_KEY = "scene_classes";
+
+// Number of classes converted to JSON text at once. Bounds the memory held by
+// not yet written class text.
+constexpr size_t STREAM_BATCH_SIZE = 256;
+
+// Benchmark counters, reported at the end when --benchmark is given
+struct BenchmarkStats {
+    size_t mClasses = 0;
+    size_t mBytes = 0;
+} gBenchmarkStats;
+
 // This struct hold properties specific to
 // Class and Groupings files such as file path, extension, and
 // write fuctions
@@ -106,6 +126,8 @@ parseCommandLine(int argc, char* argv[], std::string& dsoPath)
             (BO_SPARSED_S.c_str(), "Create separate class files for each RDL2 DSO")
             (BO_RDL2_VERSION_S.c_str(), po::value<std::string>(), "rdl2 version to embed in output file")
             (BO_MOONRAY_VERSION_S.c_str(), po::value<std::string>(), "Moonray version to embed in output file")
+            (BO_SERIAL_S.c_str(), "Convert classes to JSON on a single thread")
+            (BO_BENCHMARK_S.c_str(), "Report time, throughput and peak RSS to stderr")
             ;
 
     po::variables_map vm;
@@ -375,39 +397,109 @@ maybeLoadDso(rdl2::SceneContext& ctx, const std::string& pathOrClassName, const
     return result;
 }
 
+// Re-indents multi-line JSON text produced by StyledStreamWriter so that it can be
+// nested inside the streamed document. Trailing newline is dropped.
 void
-createFile(const rdl2::SceneClass* scene_class, 
-           const po::variables_map& options, 
-           const GeneratorData& data, const std::string& outputPath= "")
+appendIndented(std::string& dst, const std::string& src, const std::string& indent)
 {
-    // Get json data
-    Json::Value root;
+    size_t end = src.size();
+    while (end > 0 && src[end - 1] == '\n') --end;
+    for (size_t i = 0; i < end; ++i) {
+        dst += src[i];
+        if (src[i] == '\n') dst += indent;
+    }
+}
 
-    writeVersionInfo(root);
+std::string
+classToJsonText(const rdl2::SceneClass& cls, const GeneratorData& data, const std::string& indent)
+{
+    Json::Value classRoot;
+    data.mWriteJson(classRoot, cls);
 
-    Json::Value sceneObjects;
-    data.mWriteJson(sceneObjects, *scene_class);
-    root["scene_classes"] = sceneObjects;
+    std::ostringstream ostr;
+    Json::StyledStreamWriter writer;
+    writer.write(ostr, classRoot[cls.getName()]);
 
-    // Set default output to stdout
-    std::ostream* out = &std::cout;
-    std::ofstream outfile;
+    std::string text = indent + Json::valueToQuotedString(cls.getName().c_str()) + " : ";
+    appendIndented(text, ostr.str(), indent);
+    return text;
+}
 
-    auto outFileName = outputPath;
-    if (!outFileName.empty()) {
-        setupOutputFile(outFileName, scene_class->getName(), options, 
-            data.mExtension);
-        outfile.open(outFileName.c_str(), std::ios_base::out);
-        Logger::debug("Using file: ", outFileName);
-        out = &outfile;
+// Writes a document which parses to the same JSON value as dumping the whole Json::Value
+// tree by StyledStreamWriter, but scene classes are converted to text in parallel batches
+// and written out as soon as each batch is done, so only one batch is alive at a time.
+// The text layout is not the same as the whole tree dump (i.e. indentation of the nested
+// classes). The output does not depend on the parallel flag. Returns the number of bytes written.
+size_t
+writeJsonStream(std::ostream& out, std::vector<const rdl2::SceneClass*> sceneClasses,
+                const bool parallel, const GeneratorData& data)
+{
+    // Json::Value objects keep members sorted by name. Keep the same order.
+    std::sort(sceneClasses.begin(), sceneClasses.end(),
+              [](const rdl2::SceneClass* a, const rdl2::SceneClass* b) { return a->getName() < b->getName(); });
+    sceneClasses.erase(std::unique(sceneClasses.begin(), sceneClasses.end(),
+                                   [](const rdl2::SceneClass* a, const rdl2::SceneClass* b) {
+                                       return a->getName() == b->getName();
+                                   }),
+                       sceneClasses.end());
+
+    size_t bytes = 0;
+    auto put = [&](const std::string& str) {
+        out << str;
+        bytes += str.size();
+    };
+
+    auto writeSceneClasses = [&]() {
+        put("\t" + Json::valueToQuotedString(SCENE_CLASSES_KEY.c_str()) + " : \n\t{\n");
+        std::vector<std::string> texts;
+        for (size_t start = 0; start < sceneClasses.size(); start += STREAM_BATCH_SIZE) {
+            const size_t end = std::min(start + STREAM_BATCH_SIZE, sceneClasses.size());
+            texts.assign(end - start, std::string());
+            auto convert = [&](const size_t i) {
+                texts[i - start] = classToJsonText(*sceneClasses[i], data, "\t\t");
+            };
+            if (parallel) {
+                tbb::parallel_for(tbb::blocked_range<size_t>(start, end),
+                                  [&](const tbb::blocked_range<size_t>& range) {
+                                      for (size_t i = range.begin(); i < range.end(); ++i) convert(i);
+                                  });
+            } else {
+                for (size_t i = start; i < end; ++i) convert(i);
+            }
+            for (size_t i = start; i < end; ++i) {
+                put(texts[i - start]);
+                put((i + 1 < sceneClasses.size()) ? ",\n" : "\n");
+            }
+        }
+        put("\t}");
+    };
+
+    Json::Value header;
+    writeVersionInfo(header);
+    std::vector<std::string> keys = header.getMemberNames();
+    keys.push_back(SCENE_CLASSES_KEY);
+    std::sort(keys.begin(), keys.end());
+
+    put("{\n");
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == SCENE_CLASSES_KEY) {
+            writeSceneClasses();
+        } else {
+            std::ostringstream ostr;
+            Json::StyledStreamWriter writer;
+            writer.write(ostr, header[keys[i]]);
+            std::string text = "\t" + Json::valueToQuotedString(keys[i].c_str()) + " : ";
+            appendIndented(text, ostr.str(), "\t");
+            put(text);
+        }
+        put((i + 1 < keys.size()) ? ",\n" : "\n");
     }
+    put("}\n");
+    out.flush();
 
-    Json::StyledStreamWriter writer;
-    writer.write(*out, root);
-
-    if (outfile.is_open()) {
-        outfile.close();
-    }
+    gBenchmarkStats.mClasses += sceneClasses.size();
+    gBenchmarkStats.mBytes += bytes;
+    return bytes;
 }
 
 void
@@ -415,18 +507,6 @@ createFile(const std::vector<const rdl2::SceneClass*>& scene_classes,
            const po::variables_map& options, 
            const GeneratorData& data, const std::string& outputPath= "")
 {
-    // Get json data
-    Json::Value root;
-
-    writeVersionInfo(root);
-
-    Json::Value sceneObjects;
-    for (const rdl2::SceneClass* scene_class : scene_classes) {
-        data.mWriteJson(sceneObjects, *scene_class);
-    }
-
-    root["scene_classes"] = sceneObjects;
-
     std::ostream* out = &std::cout;
     std::ofstream outfile;
 
@@ -439,14 +519,38 @@ createFile(const std::vector<const rdl2::SceneClass*>& scene_classes,
         out = &outfile;
     }
 
-    Json::StyledStreamWriter writer;
-    writer.write(*out, root);
+    writeJsonStream(*out, scene_classes, !options.count(BO_SERIAL_S), data);
 
     if (outfile.is_open()) {
         outfile.close();
     }
 }
 
+void
+createFile(const rdl2::SceneClass* scene_class, 
+           const po::variables_map& options, 
+           const GeneratorData& data, const std::string& outputPath= "")
+{
+    createFile(std::vector<const rdl2::SceneClass*>(1, scene_class), options, data, outputPath);
+}
+
+void
+showBenchmark(const float sec)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    const float mb = static_cast<float>(gBenchmarkStats.mBytes) / (1024.0f * 1024.0f);
+    std::cerr << "rdl2_json_exporter benchmark {\n"
+              << std::fixed << std::setprecision(3)
+              << "  time    : " << sec << " sec\n"
+              << "  classes : " << gBenchmarkStats.mClasses << " ("
+              << std::setprecision(1) << ((sec > 0.0f) ? gBenchmarkStats.mClasses / sec : 0.0f) << " classes/sec)\n"
+              << std::setprecision(2)
+              << "  output  : " << mb << " MB (" << ((sec > 0.0f) ? mb / sec : 0.0f) << " MB/sec)\n"
+              << "  peakRSS : " << usage.ru_maxrss / 1024 << " MB\n"
+              << "}" << std::endl;
+}
+
 void
 createFiles(rdl2::SceneContext& ctx, const po::variables_map& options, const GeneratorData& data)
 {
@@ -542,6 +646,9 @@ int main(int argc, char* argv[])
     // Create the GeneratorData for class and groupings files
     GeneratorData jsonGeneratorData(BO_OUT_PATH_S, JSON_EXTENSION, writeJson);
 
+    rec_time::RecTime recTime;
+    recTime.start();
+
     try {
         // If we've specified one or more input paths
         if (options.count(BO_IN_PATH_S)) {
@@ -556,6 +663,10 @@ int main(int argc, char* argv[])
         std::exit(EXIT_FAILURE);
     }
 
+    if (options.count(BO_BENCHMARK_S)) {
+        showBenchmark(recTime.end());
+    }
+
     return EXIT_SUCCESS;
 }
 
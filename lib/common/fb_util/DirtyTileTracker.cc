@@ -0,0 +1,131 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "DirtyTileTracker.h"
+
+#include <scene_rdl2/common/platform/Platform.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+void
+DirtyTileTracker::init(const unsigned width, const unsigned height)
+{
+    mWidth = width;
+    mHeight = height;
+    mNumTilesX = (width + 7) >> 3;
+    mNumTilesY = (height + 7) >> 3;
+
+    const size_t numWords = (static_cast<size_t>(getNumTiles()) + 63) >> 6;
+    if (numWords != mNumWords) {
+        mNumWords = numWords;
+        mBits.reset(numWords ? new std::atomic<uint64_t>[numWords] : nullptr);
+    }
+    clear();
+}
+
+void
+DirtyTileTracker::markRegion(const unsigned minX, const unsigned maxX,
+                             const unsigned minY, const unsigned maxY)
+{
+    if (minX >= maxX || minY >= maxY) return;
+
+    const unsigned tileMinX = minX >> 3;
+    const unsigned tileMaxX = std::min((maxX + 7) >> 3, mNumTilesX);
+    const unsigned tileMinY = minY >> 3;
+    const unsigned tileMaxY = std::min((maxY + 7) >> 3, mNumTilesY);
+    for (unsigned tileY = tileMinY; tileY < tileMaxY; ++tileY) {
+        for (unsigned tileX = tileMinX; tileX < tileMaxX; ++tileX) {
+            markTile(tileY * mNumTilesX + tileX);
+        }
+    }
+}
+
+void
+DirtyTileTracker::markAll()
+{
+    if (!mNumWords) return;
+    for (size_t i = 0; i < mNumWords - 1; ++i) {
+        mBits[i].store(~static_cast<uint64_t>(0x0), std::memory_order_relaxed);
+    }
+    const unsigned lastBits = getNumTiles() - static_cast<unsigned>((mNumWords - 1) << 6);
+    mBits[mNumWords - 1].fetch_or((lastBits == 64) ?
+                                  ~static_cast<uint64_t>(0x0) :
+                                  ((static_cast<uint64_t>(0x1) << lastBits) - 1),
+                                  std::memory_order_relaxed);
+}
+
+void
+DirtyTileTracker::clear()
+{
+    for (size_t i = 0; i < mNumWords; ++i) {
+        mBits[i].store(0x0, std::memory_order_relaxed);
+    }
+}
+
+unsigned
+DirtyTileTracker::getNumDirtyTiles() const
+{
+    unsigned total = 0;
+    for (size_t i = 0; i < mNumWords; ++i) {
+        total += static_cast<unsigned>(__builtin_popcountll(mBits[i].load(std::memory_order_relaxed)));
+    }
+    return total;
+}
+
+void
+DirtyTileTracker::extractDirtyTileIds(std::vector<unsigned> &tileIds)
+{
+    tileIds.clear();
+    for (size_t i = 0; i < mNumWords; ++i) {
+        if (!mBits[i].load(std::memory_order_relaxed)) continue;
+        // exchange() does not lose the marks which are set by the other threads at the same time
+        uint64_t bits = mBits[i].exchange(0x0, std::memory_order_acq_rel);
+        while (bits) {
+            tileIds.push_back(static_cast<unsigned>((i << 6) + __builtin_ctzll(bits)));
+            bits &= bits - 1;   // clear lowest set bit
+        }
+    }
+}
+
+void
+DirtyTileTracker::extractDirtyTiles(std::vector<Tile> &tiles)
+{
+    std::vector<unsigned> tileIds;
+    extractDirtyTileIds(tileIds);
+
+    tiles.resize(tileIds.size());
+    for (size_t i = 0; i < tileIds.size(); ++i) {
+        tiles[i] = tileIdToTile(tileIds[i]);
+    }
+}
+
+Tile
+DirtyTileTracker::tileIdToTile(const unsigned tileId) const
+{
+    MNRY_ASSERT(tileId < getNumTiles());
+
+    const unsigned minX = (tileId % mNumTilesX) << 3;
+    const unsigned minY = (tileId / mNumTilesX) << 3;
+    return Tile(minX, std::min(minX + 8, mWidth), minY, std::min(minY + 8, mHeight));
+}
+
+std::string
+DirtyTileTracker::show() const
+{
+    std::ostringstream ostr;
+    ostr << "DirtyTileTracker {\n"
+         << "  mWidth:" << mWidth << " mHeight:" << mHeight << '\n'
+         << "  mNumTilesX:" << mNumTilesX << " mNumTilesY:" << mNumTilesY << '\n'
+         << "  getNumDirtyTiles():" << getNumDirtyTiles() << '\n'
+         << "}";
+    return ostr.str();
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,91 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Tracking changed tiles of a tiled PixelBuffer --
+//
+// Keeps one bit per 8x8 tile of the tiled buffer and records which tiles are updated since the
+// last extractDirtyTiles() call. Progressive updates only need to pack and send these tiles
+// instead of scanning the whole buffer. mark*() functions are thread safe and are designed to
+// be called from the render threads which update the buffer. A tile which is marked during
+// extractDirtyTiles() is either returned by this call or kept for the next call, never lost.
+//
+// This is a separate object from PixelBuffer because PixelBuffer<T> must keep the same
+// layout for all T (VariablePixelBuffer depends on it) and most of the buffers don't need it.
+//
+
+#include "FbTypes.h"
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>             // uint64_t
+#include <string>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+class DirtyTileTracker
+{
+public:
+    DirtyTileTracker() :
+        mWidth(0),
+        mHeight(0),
+        mNumTilesX(0),
+        mNumTilesY(0),
+        mNumWords(0)
+    {}
+
+    // original width and height (not need to tile aligned). All tiles are clean after init.
+    void init(const unsigned width, const unsigned height);
+
+    unsigned getWidth() const { return mWidth; }
+    unsigned getHeight() const { return mHeight; }
+    unsigned getNumTiles() const { return mNumTilesX * mNumTilesY; }
+
+    unsigned getTileId(const unsigned x, const unsigned y) const { return (y >> 3) * mNumTilesX + (x >> 3); }
+
+    void markPixel(const unsigned x, const unsigned y) { markTile(getTileId(x, y)); }
+    void markTile(const unsigned tileId)
+    {
+        std::atomic<uint64_t> &word = mBits[tileId >> 6];
+        const uint64_t mask = static_cast<uint64_t>(0x1) << (tileId & 63);
+        // skip atomic RMW if already marked. Avoids cache line bouncing between render threads
+        if (!(word.load(std::memory_order_relaxed) & mask)) {
+            word.fetch_or(mask, std::memory_order_relaxed);
+        }
+    }
+    void markRegion(const unsigned minX, const unsigned maxX,  // max is non-inclusive
+                    const unsigned minY, const unsigned maxY);
+    void markAll();
+    void clear();
+
+    bool isDirty(const unsigned tileId) const
+    {
+        return (mBits[tileId >> 6].load(std::memory_order_relaxed) >> (tileId & 63)) & 0x1;
+    }
+    unsigned getNumDirtyTiles() const;
+
+    // Returns dirty tiles in tileId order and clears them.
+    // Tile is clipped by original width and height.
+    void extractDirtyTileIds(std::vector<unsigned> &tileIds);
+    void extractDirtyTiles(std::vector<Tile> &tiles);
+
+    Tile tileIdToTile(const unsigned tileId) const;
+
+    std::string show() const;
+
+private:
+    unsigned mWidth, mHeight;   // original image size
+    unsigned mNumTilesX, mNumTilesY;
+
+    size_t mNumWords;
+    std::unique_ptr<std::atomic<uint64_t>[]> mBits; // 1 bit for each tile
+};
+
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,288 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "FramePool.h"
+
+#include <scene_rdl2/render/util/Memory.h>
+#include <scene_rdl2/render/util/StrUtil.h>
+
+#include <cstring>
+#include <new>
+#include <sstream>
+
+#include <sys/mman.h>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+namespace {
+
+inline size_t
+roundUp(const size_t size, const size_t unit)
+{
+    return (size + unit - 1) & ~(unit - 1);
+}
+
+} // namespace
+
+// static function
+FramePool &
+FramePool::get()
+{
+    // Never destructed. See the comment at the top of FramePool.h
+    static FramePool *sFramePool = new FramePool;
+    return *sFramePool;
+}
+
+FramePool::FramePool() :
+    mHugePage(false),
+    mLazyZero(false),
+    mMaxCachedBytes(sDefaultMaxCachedBytes),
+    mOsAllocTotal(0),
+    mReuseTotal(0),
+    mCachedBytes(0),
+    mInUseBytes(0)
+{
+}
+
+void *
+FramePool::alloc(const size_t size, const size_t alignment)
+{
+    MNRY_ASSERT(alignment <= sPageSize);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const size_t roundedSize = roundUpSize(size);
+    auto itr = mFreeList.find(Key(roundedSize, alignment));
+    if (itr != mFreeList.end() && !itr->second.empty()) {
+        void *ptr = itr->second.back();
+        itr->second.pop_back();
+        mCachedBytes -= roundedSize;
+        mInUseBytes += roundedSize;
+        ++mReuseTotal;
+        return ptr;
+    }
+
+    void *ptr = osAlloc(roundedSize, alignment);
+    mInUseBytes += roundedSize;
+    ++mOsAllocTotal;
+    return ptr;
+}
+
+void
+FramePool::free(void *ptr, const size_t size, const size_t alignment)
+{
+    if (!ptr) return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    size_t roundedSize = size;
+    if (size >= sMmapThreshold) {
+        // HugePage mode might be changed after alloc(). We use the size which is recorded by osAlloc()
+        auto itr = mMmapBlockSize.find(ptr);
+        roundedSize = (itr != mMmapBlockSize.end()) ? itr->second : roundUp(size, sPageSize);
+    }
+    mInUseBytes -= roundedSize;
+
+    if (roundedSize > mMaxCachedBytes) {
+        osFree(ptr, roundedSize);
+        return;
+    }
+    if (mCachedBytes + roundedSize > mMaxCachedBytes) {
+        trimUntil(mMaxCachedBytes - roundedSize);
+    }
+    mFreeList[Key(roundedSize, alignment)].push_back(ptr);
+    mCachedBytes += roundedSize;
+}
+
+void
+FramePool::zero(void *ptr, const size_t size) const
+{
+    if (!ptr || !size) return;
+
+    if (size >= sMmapThreshold && getLazyZero()) {
+        // mmap block is page aligned and its size is rounded up to the page size. So we can
+        // release the last partial page as well.
+        if (::madvise(ptr, roundUp(size, sPageSize), MADV_DONTNEED) == 0) return;
+    }
+    std::memset(ptr, 0, size);
+}
+
+void
+FramePool::setHugePage(const bool flag)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mHugePage = flag;
+}
+
+bool
+FramePool::getHugePage() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mHugePage;
+}
+
+void
+FramePool::setLazyZero(const bool flag)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mLazyZero = flag;
+}
+
+bool
+FramePool::getLazyZero() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLazyZero;
+}
+
+void
+FramePool::setMaxCachedBytes(const size_t size)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMaxCachedBytes = size;
+    trimUntil(mMaxCachedBytes);
+}
+
+size_t
+FramePool::getMaxCachedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mMaxCachedBytes;
+}
+
+void
+FramePool::trim()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    trimUntil(0);
+}
+
+size_t
+FramePool::getOsAllocTotal() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mOsAllocTotal;
+}
+
+size_t
+FramePool::getReuseTotal() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mReuseTotal;
+}
+
+size_t
+FramePool::getCachedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCachedBytes;
+}
+
+size_t
+FramePool::getInUseBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mInUseBytes;
+}
+
+void
+FramePool::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mOsAllocTotal = 0;
+    mReuseTotal = 0;
+}
+
+std::string
+FramePool::show() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::ostringstream ostr;
+    ostr << "FramePool {\n"
+         << "  mHugePage:" << str_util::boolStr(mHugePage) << '\n'
+         << "  mLazyZero:" << str_util::boolStr(mLazyZero) << '\n'
+         << "  mMaxCachedBytes:" << str_util::byteStr(mMaxCachedBytes) << '\n'
+         << "  mOsAllocTotal:" << mOsAllocTotal << '\n'
+         << "  mReuseTotal:" << mReuseTotal << '\n'
+         << "  mCachedBytes:" << str_util::byteStr(mCachedBytes) << '\n'
+         << "  mInUseBytes:" << str_util::byteStr(mInUseBytes) << '\n'
+         << "  mFreeList (size:" << mFreeList.size() << ") {\n";
+    for (const auto &itr : mFreeList) {
+        if (itr.second.empty()) continue;
+        ostr << "    size:" << str_util::byteStr(itr.first.first)
+             << " align:" << itr.first.second
+             << " blocks:" << itr.second.size() << '\n';
+    }
+    ostr << "  }\n"
+         << "}";
+    return ostr.str();
+}
+
+//------------------------------------------------------------------------------------------
+
+size_t
+FramePool::roundUpSize(const size_t size) const
+{
+    if (size < sMmapThreshold) return size; // alignedMalloc block : no page rounding
+    return roundUp(size, (mHugePage) ? sHugePageSize : sPageSize);
+}
+
+void *
+FramePool::osAlloc(const size_t roundedSize, const size_t alignment)
+{
+    if (roundedSize < sMmapThreshold) {
+        void *ptr = util::alignedMalloc(roundedSize, alignment);
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    const size_t mapAlign = (mHugePage) ? sHugePageSize : sPageSize;
+    const size_t mapSize = roundedSize + mapAlign - sPageSize;
+    void *map = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (map == MAP_FAILED) throw std::bad_alloc();
+
+    // trim head and tail in order to align to mapAlign
+    char *head = static_cast<char *>(map);
+    char *ptr = reinterpret_cast<char *>(roundUp(reinterpret_cast<size_t>(head), mapAlign));
+    char *tail = ptr + roundedSize;
+    if (ptr != head) ::munmap(head, ptr - head);
+    if (tail != head + mapSize) ::munmap(tail, head + mapSize - tail);
+
+    if (mHugePage) {
+        (void)::madvise(ptr, roundedSize, MADV_HUGEPAGE); // just a hint. We don't care the error
+    }
+
+    mMmapBlockSize[ptr] = roundedSize;
+    return ptr;
+}
+
+void
+FramePool::osFree(void *ptr, const size_t roundedSize)
+{
+    if (roundedSize < sMmapThreshold) {
+        util::alignedFree(ptr);
+        return;
+    }
+    mMmapBlockSize.erase(ptr);
+    ::munmap(ptr, roundedSize);
+}
+
+void
+FramePool::trimUntil(const size_t cachedBytes)
+{
+    // release bigger blocks first
+    for (auto itr = mFreeList.rbegin(); itr != mFreeList.rend() && mCachedBytes > cachedBytes; ++itr) {
+        std::vector<void *> &blocks = itr->second;
+        while (!blocks.empty() && mCachedBytes > cachedBytes) {
+            osFree(blocks.back(), itr->first.first);
+            blocks.pop_back();
+            mCachedBytes -= itr->first.first;
+        }
+    }
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
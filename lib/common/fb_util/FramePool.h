@@ -0,0 +1,116 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+//
+// -- Process wide pool of frame buffer storage --
+//
+// PixelBuffer<T> (and VariablePixelBuffer through it) gets its storage from this pool. Every
+// resolution or format change used to allocate a new aligned block and free the old one, which
+// costs page faults on the first touch of every page and a full memset by clear(). The pool
+// keeps released blocks in free lists keyed by (rounded byte size, alignment) and hands them
+// back to the next init() which requests the same key. So toggling resolution (i.e. 1080p
+// <-> 4K on the interactive session) does not go back to the OS after the first round.
+//
+// Blocks which are equal or bigger than sMmapThreshold are directly allocated by mmap and their
+// size is rounded up to the page size. Smaller blocks are allocated by util::alignedMalloc with
+// their own size and are only reused by the request of the same size.
+//
+// Options :
+//   HugePage : mmap blocks are rounded up and aligned to 2MB and advised as transparent huge
+//              pages. This reduces TLB misses and page fault count on the big frame buffers.
+//   LazyZero : zero() releases whole pages of mmap blocks by MADV_DONTNEED instead of memset.
+//              Released pages are read back as zero and physical pages are assigned again at
+//              the first write. This is a win when only a part of the buffer is written after
+//              clear (i.e. sparse tile updates). If the whole buffer is written right after
+//              clear, memset is cheaper because of the page faults. Off by default.
+//
+// Released blocks are kept up to MaxCachedBytes (sDefaultMaxCachedBytes by default, enough for
+// a 4K RGBA float buffer and a few smaller ones) in total. Blocks which exceed this limit are
+// returned to the OS immediately. Cached blocks stay until trim() is called or the limit is
+// lowered, and setMaxCachedBytes(0) disables the caching. All APIs are MT-safe.
+//
+// The pool is intentionally never destructed, so that PixelBuffers which live in static
+// storage can safely release their blocks at the process exit.
+//
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+class FramePool
+{
+public:
+    static constexpr size_t sMmapThreshold = 1024 * 1024; // byte
+    static constexpr size_t sPageSize = 4096;
+    static constexpr size_t sHugePageSize = 2 * 1024 * 1024;
+    static constexpr size_t sDefaultMaxCachedBytes = 256 * 1024 * 1024;
+
+    static FramePool &get();
+
+    // Non-copyable
+    FramePool &operator =(const FramePool &) = delete;
+    FramePool(const FramePool &) = delete;
+
+    // alignment should be power of 2 and equal or less than sPageSize.
+    // Returned block is not initialized. Throw std::bad_alloc if failed.
+    void *alloc(const size_t size, const size_t alignment);
+    // size and alignment should be the same as alloc()
+    void free(void *ptr, const size_t size, const size_t alignment);
+
+    // Zero clear the block which is allocated by alloc(). Uses MADV_DONTNEED if LazyZero is on.
+    void zero(void *ptr, const size_t size) const;
+
+    void setHugePage(const bool flag); // only affects blocks which are allocated after this call
+    bool getHugePage() const;
+    void setLazyZero(const bool flag);
+    bool getLazyZero() const;
+    void setMaxCachedBytes(const size_t size); // trims cached blocks if needed
+    size_t getMaxCachedBytes() const;
+
+    void trim(); // return all cached blocks to the OS
+
+    size_t getOsAllocTotal() const; // number of allocations from the OS
+    size_t getReuseTotal() const;   // number of allocations satisfied by cached blocks
+    size_t getCachedBytes() const;  // total size of the cached (released) blocks
+    size_t getInUseBytes() const;   // total size of the blocks which are not released yet
+    void resetStats();              // reset OsAllocTotal and ReuseTotal
+
+    std::string show() const;
+
+private:
+    using Key = std::pair<size_t, size_t>; // (rounded size, alignment)
+
+    FramePool();
+
+    size_t roundUpSize(const size_t size) const; // need mMutex
+    void *osAlloc(const size_t roundedSize, const size_t alignment); // need mMutex
+    void osFree(void *ptr, const size_t roundedSize); // need mMutex
+    void trimUntil(const size_t cachedBytes); // need mMutex
+
+    mutable std::mutex mMutex;
+
+    bool mHugePage;
+    bool mLazyZero;
+    size_t mMaxCachedBytes;
+
+    std::map<Key, std::vector<void *>> mFreeList;
+    std::unordered_map<void *, size_t> mMmapBlockSize; // rounded size of all mmap blocks
+
+    size_t mOsAllocTotal;
+    size_t mReuseTotal;
+    size_t mCachedBytes;
+    size_t mInUseBytes;
+};
+
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "FramePool.h"
 #include <scene_rdl2/render/util/Memory.h>
 #include "ispc/PixelBuffer.hh"
 
@@ -24,9 +25,10 @@ template<typename T>
 class PixelBuffer
 {
     static_assert(std::is_trivially_destructible<T>::value, "We don't call destructors");
-    struct AlignedDeleter
+    struct PoolDeleter
     {
-        void operator()(T* t) const { util::alignedFreeArray(t); }
+        void operator()(T* t) const { FramePool::get().free(t, mSize, CACHE_LINE_SIZE); }
+        size_t mSize;
     };
 
 public:
@@ -51,11 +53,13 @@ public:
         MNRY_ASSERT(bytesToAllocate);
 
         if (mBytesAllocated < bytesToAllocate) {
-            mBytesAllocated = bytesToAllocate;
             // mRawData is a member of the Hybrid Uniform Data struct so that ISPC can access it.
             // This (deliberately) doesn't call the constructor on objects!
-            mRawData = (uint8_t *)util::alignedMallocArray<T>(area, CACHE_LINE_SIZE), AlignedDeleter();
-            mData.reset((T*)mRawData);
+            // Storage comes from the FramePool and goes back to it when the last shared_ptr
+            // (including the ones returned by getDataShared()) is released.
+            mRawData = (uint8_t *)FramePool::get().alloc(bytesToAllocate, CACHE_LINE_SIZE);
+            mData.reset((T*)mRawData, PoolDeleter {bytesToAllocate});
+            mBytesAllocated = bytesToAllocate;
         }
 
         MNRY_ASSERT(mBytesAllocated >= bytesToAllocate);
@@ -78,12 +82,12 @@ public:
         mRawData = nullptr;
     }
 
-    // Clear the buffer to zeros.
+    // Clear the buffer to zeros. This might be done by releasing pages if FramePool LazyZero is on.
     void clear()
     {
         static_assert(std::is_trivially_copyable<T>::value, "Calling memset");
         if (mData) {
-            std::memset(mData.get(), 0, mBytesAllocated);
+            FramePool::get().zero(mData.get(), mBytesAllocated);
         }
     }
 
@@ -9,9 +9,17 @@
 
 #include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <math.h>
 #include <limits.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif // end __AVX2__
+
 // Define this to use a table for the gamma correction. In practice this is much
 // faster than calling powf repeatedly.
 #define USE_TABLE_FOR_GAMMA
@@ -284,106 +292,268 @@ gammaCorrectColorComponent(float &x)
 #endif
 }
 
-finline uint8_t
-gammaCorrectDitherQuantize(float in, unsigned int x, unsigned int y)
-{
-    gammaCorrectColorComponent(in);
-    return uint8_t(in + sDitherMatrix[y & 7][x & 7]);
-}
-
-template <typename SRC_BUFFER_TYPE>
+template <unsigned N, typename SRC_PIXEL_TYPE, typename GET_CHANNEL>
 void
-computeNormalizedScaleAndOffset(Vec3f &offset, float &scale, const SRC_BUFFER_TYPE &srcBuffer)
-{
-    offset = Vec3f(0.f);
-    scale = 1.f;
-
-    Vec3f min = Vec3f(std::numeric_limits<float>::max());
-    Vec3f max = Vec3f(std::numeric_limits<float>::min());
+computeNormalizedScaleAndOffsetMain(float offset[N], float &scale,
+                                    const PixelBuffer<SRC_PIXEL_TYPE> &srcBuffer,
+                                    GET_CHANNEL const &getChannel, // float getChannel(const SRC_PIXEL_TYPE &, unsigned c)
+                                    bool parallel)
+{
+    struct MinMax {
+        float mMin[N];
+        float mMax[N];
+    };
 
     const unsigned int w = srcBuffer.getWidth();
     const unsigned int h = srcBuffer.getHeight();
-    for (unsigned int y = 0; y < h; ++y) {
+
+    // min/max of each row are computed in parallel and then merged in row order, so the result
+    // is exactly the same as single thread scan.
+    std::vector<MinMax> rowMinMax(h);
+    simpleLoop(parallel, 0u, h, [&](unsigned y) {
+        MinMax &mm = rowMinMax[y];
+        for (unsigned c = 0; c < N; ++c) {
+            mm.mMin[c] = std::numeric_limits<float>::max();
+            mm.mMax[c] = std::numeric_limits<float>::min();
+        }
+        const SRC_PIXEL_TYPE *src = srcBuffer.getRow(y);
         for (unsigned int x = 0; x < w; ++x) {
-            const auto &p = srcBuffer.getPixel(x, y);
-            if (math::isfinite(p[0])) {
-                if (p[0] < min[0]) min[0] = p[0];
-                if (p[0] > max[0]) max[0] = p[0];
-            }
-            if (math::isfinite(p[1])) {
-                if (p[1] < min[1]) min[1] = p[1];
-                if (p[1] > max[1]) max[1] = p[1];
-            }
-            if (math::isfinite(p[2])) {
-                if (p[2] < min[2]) min[2] = p[2];
-                if (p[2] > max[2]) max[2] = p[2];
+            for (unsigned c = 0; c < N; ++c) {
+                const float p = getChannel(src[x], c);
+                if (math::isfinite(p)) {
+                    if (p < mm.mMin[c]) mm.mMin[c] = p;
+                    if (p > mm.mMax[c]) mm.mMax[c] = p;
+                }
             }
         }
+    });
+
+    MinMax total;
+    for (unsigned c = 0; c < N; ++c) {
+        total.mMin[c] = std::numeric_limits<float>::max();
+        total.mMax[c] = std::numeric_limits<float>::min();
     }
-    const Vec3f diff = max - min;
-    const float maxDiff = std::max(diff[0], std::max(diff[1], diff[2]));
+    for (unsigned int y = 0; y < h; ++y) {
+        for (unsigned c = 0; c < N; ++c) {
+            if (rowMinMax[y].mMin[c] < total.mMin[c]) total.mMin[c] = rowMinMax[y].mMin[c];
+            if (rowMinMax[y].mMax[c] > total.mMax[c]) total.mMax[c] = rowMinMax[y].mMax[c];
+        }
+    }
+
+    float maxDiff = total.mMax[0] - total.mMin[0];
+    for (unsigned c = 1; c < N; ++c) {
+        maxDiff = std::max(maxDiff, total.mMax[c] - total.mMin[c]);
+    }
+    scale = 1.f;
     if (maxDiff > MIN_NORMALIZED_DISTANCE) {
         scale = 1.f / maxDiff;
     }
-    offset = -min;
+    for (unsigned c = 0; c < N; ++c) {
+        offset[c] = -total.mMin[c];
+    }
 }
 
-void
-computeNormalizedScaleAndOffset(Vec2f &offset, float &scale, const Float2Buffer &srcBuffer)
+//------------------------------------------------------------------------------------------
+//
+// Exposure + gamma + 8bit quantize pipeline shared by gammaAndQuantizeTo8bit() and
+// extract*() functions. Source pixels are converted to channel major float values 8 pixels
+// at a time and quantized by AVX2 when it's available. Every step is the same float
+// operation as the scalar code, so both versions return the same result.
+//
+struct QuantizeParam
+{
+    bool mNormalize;     // (v + offset) * scale instead of exposure, user gamma and clamp
+    bool mSaturate;      // clamp by saturate() (extract*()) instead of max(min(v, 1), 0)
+    bool mApplyGamma;    // gamma 2.2 correction
+    bool mUserGamma;     // pow(v, 1 / gamma). Skipped if gamma is 1 because pow(v, 1) is v
+    bool mAlphaThrough;  // 4th channel is only clamped and dithered (Rgba8888)
+    float mExposureScale;
+    float mInvGamma;
+    float mOffset[3];
+    float mScale;
+};
+
+QuantizeParam
+setupQuantizeParam(PixelBufferUtilOptions options, float exposure, float gamma)
+{
+    QuantizeParam param;
+    param.mNormalize = options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE;
+    param.mSaturate = false;
+    param.mApplyGamma = options & PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
+    param.mUserGamma = (gamma != 1.f);
+    param.mAlphaThrough = false;
+    param.mExposureScale = pow(2.f, exposure);
+    param.mInvGamma = 1.f / gamma;
+    param.mOffset[0] = param.mOffset[1] = param.mOffset[2] = 0.f;
+    param.mScale = 1.f;
+    return param;
+}
+
+finline uint8_t
+quantizeChannel(const QuantizeParam &param, float v, unsigned c, unsigned x, unsigned y)
 {
-    offset = Vec2f(0.f);
-    scale = 1.f;
+    if (c == 3 && param.mAlphaThrough) {
+        // no exposure and gamma for alpha, only the clamp without normalize
+        if (!param.mNormalize) v = max(min(v, 1.f), 0.f);
+    } else if (param.mNormalize) {
+        v = (v + param.mOffset[c]) * param.mScale;
+    } else {
+        // Apply exposure and user gamma, then clamp to 0.0 -> 1.0 range.
+        v *= param.mExposureScale;
+        if (param.mUserGamma) v = pow(v, param.mInvGamma);
+        v = (param.mSaturate) ? saturate(v) : max(min(v, 1.f), 0.f);
+    }
+    if (param.mApplyGamma && !(c == 3 && param.mAlphaThrough)) {
+        gammaCorrectColorComponent(v);
+    }
 
-    Vec2f min = Vec2f(std::numeric_limits<float>::max());
-    Vec2f max = Vec2f(std::numeric_limits<float>::min());
+    // Dither and quantize to 8-bit.
+    return uint8_t(v + sDitherMatrix[y & 7][x & 7]);
+}
 
-    const unsigned int w = srcBuffer.getWidth();
-    const unsigned int h = srcBuffer.getHeight();
-    for (unsigned int y = 0; y < h; ++y) {
-        for (unsigned int x = 0; x < w; ++x) {
-            const auto &p = srcBuffer.getPixel(x, y);
-            if (math::isfinite(p[0])) {
-                if (p[0] < min[0]) min[0] = p[0];
-                if (p[0] > max[0]) max[0] = p[0];
-            }
-            if (math::isfinite(p[1])) {
-                if (p[1] < min[1]) min[1] = p[1];
-                if (p[1] > max[1]) max[1] = p[1];
-            }
+#if defined(__AVX2__)
+finline __m256i
+quantizeChannel8(const QuantizeParam &param, const float *val, unsigned c, unsigned y)
+//
+// AVX2 version of quantizeChannel() for 8 pixels. x of the first pixel has to be a
+// multiple of 8 in order to use a row of the dither matrix as is.
+//
+{
+    const bool alpha = (c == 3 && param.mAlphaThrough);
+
+    __m256 v = _mm256_loadu_ps(val);
+    if (alpha) {
+        // no exposure and gamma for alpha, only the clamp without normalize
+        if (!param.mNormalize) {
+            v = _mm256_max_ps(_mm256_setzero_ps(), _mm256_min_ps(v, _mm256_set1_ps(1.f)));
+        }
+    } else if (param.mNormalize) {
+        v = _mm256_mul_ps(_mm256_add_ps(v, _mm256_set1_ps(param.mOffset[c])), _mm256_set1_ps(param.mScale));
+    } else {
+        v = _mm256_mul_ps(v, _mm256_set1_ps(param.mExposureScale));
+        if (param.mUserGamma) {
+            alignas(32) float tmp[8];
+            _mm256_store_ps(tmp, v);
+            for (unsigned i = 0; i < 8; ++i) tmp[i] = pow(tmp[i], param.mInvGamma);
+            v = _mm256_load_ps(tmp);
+        }
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.f);
+        if (param.mSaturate) {
+            v = _mm256_min_ps(one, _mm256_max_ps(zero, v)); // keeps NaN as saturate()
+        } else {
+            v = _mm256_max_ps(zero, _mm256_min_ps(v, one)); // same operand order as math::min/max
         }
     }
-    const Vec2f diff = max - min;
-    const float maxDiff = std::max(diff[0], diff[1]);
-    if (maxDiff > MIN_NORMALIZED_DISTANCE) {
-        scale = 1.f / maxDiff;
+
+    if (param.mApplyGamma && !alpha) {
+#ifdef USE_TABLE_FOR_GAMMA
+        // Table ids are computed by SIMD and tables are read by scalar load. This is faster than
+        // gather instruction and keeps tables in L1.
+        const __m256i u = _mm256_castps_si256(v);
+        alignas(32) int id1[8], id2[8];
+        _mm256_store_si256((__m256i *)id1, _mm256_and_si256(_mm256_srli_epi32(u, 13), _mm256_set1_epi32(0x3ff)));
+        _mm256_store_si256((__m256i *)id2, _mm256_and_si256(_mm256_srli_epi32(u, 23), _mm256_set1_epi32(0xff)));
+        alignas(32) float t1[8], t2[8];
+        for (unsigned i = 0; i < 8; ++i) {
+            t1[i] = sGammaTable1[id1[i]];
+            t2[i] = sGammaTable2[id2[i]];
+        }
+        v = _mm256_mul_ps(_mm256_load_ps(t1), _mm256_load_ps(t2));
+#else
+        alignas(32) float tmp[8];
+        _mm256_store_ps(tmp, v);
+        for (unsigned i = 0; i < 8; ++i) gammaCorrectColorComponent(tmp[i]);
+        v = _mm256_load_ps(tmp);
+#endif
+    }
+
+    // Dither and quantize to 8-bit. uint8_t(float) keeps low 8 bits of truncated integer.
+    v = _mm256_add_ps(v, _mm256_loadu_ps(sDitherMatrix[y & 7]));
+    return _mm256_and_si256(_mm256_cvttps_epi32(v), _mm256_set1_epi32(0xff));
+}
+#endif // end __AVX2__
+
+finline void
+storeQuantized(ByteColor *dst, const uint32_t *packed, unsigned n)
+{
+    for (unsigned i = 0; i < n; ++i) {
+        dst[i].r = static_cast<uint8_t>(packed[i]);
+        dst[i].g = static_cast<uint8_t>(packed[i] >> 8);
+        dst[i].b = static_cast<uint8_t>(packed[i] >> 16);
     }
-    offset = -min;
 }
 
+finline void
+storeQuantized(ByteColor4 *dst, const uint32_t *packed, unsigned n)
+{
+    std::memcpy(dst, packed, n * sizeof(ByteColor4));
+}
 
+// Converts srcBuffer to 8bit destBuffer.
+// s2c(src, v) sets numChan channel values of one pixel into v[]. numChan = 1 is output as grey,
+// numChan = 2 as (v0, v1, 0), numChan = 3 or 4 as is.
+template <typename DEST_PIXEL_TYPE, typename SRC_PIXEL_TYPE, typename SRC_TO_CHANNELS>
 void
-computeNormalizedScaleAndOffset(float &offset, float &scale, const FloatBuffer &srcBuffer)
+quantizePixelBuffer(PixelBuffer<DEST_PIXEL_TYPE> &destBuffer,
+                    const PixelBuffer<SRC_PIXEL_TYPE> &srcBuffer,
+                    const QuantizeParam &param,
+                    const unsigned numChan,
+                    SRC_TO_CHANNELS const &s2c,
+                    PixelBufferUtilOptions options)
 {
-    offset = 0.f;
-    scale = 1.f;
+    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+    const bool simd = !(options & PIXEL_BUFFER_UTIL_OPTIONS_NO_SIMD);
 
-    float min = std::numeric_limits<float>::max();
-    float max = std::numeric_limits<float>::min();
+    const unsigned w = srcBuffer.getWidth();
+    const unsigned h = srcBuffer.getHeight();
 
-    const unsigned int w = srcBuffer.getWidth();
-    const unsigned int h = srcBuffer.getHeight();
-    for (unsigned int y = 0; y < h; ++y) {
-        for (unsigned int x = 0; x < w; ++x) {
-            const float p = srcBuffer.getPixel(x, y);
-            if (math::isfinite(p) && p > max) max = p;
-            if (math::isfinite(p) && p < min) min = p;
+    destBuffer.init(w, h);
+
+    simpleLoop(parallel, 0u, h, [&](unsigned y) {
+        DEST_PIXEL_TYPE *dst = destBuffer.getRow(y);
+        const SRC_PIXEL_TYPE *src = srcBuffer.getRow(y);
+
+        for (unsigned x = 0; x < w; x += 8) {
+            const unsigned n = std::min(8u, w - x);
+
+            alignas(32) float val[4][8];
+            for (unsigned i = 0; i < n; ++i) {
+                float v[4];
+                s2c(src[x + i], v);
+                for (unsigned c = 0; c < numChan; ++c) val[c][i] = v[c];
+            }
+
+            alignas(32) uint32_t packed[8];
+#if defined(__AVX2__)
+            if (simd && n == 8) {
+                __m256i q[4];
+                for (unsigned c = 0; c < numChan; ++c) q[c] = quantizeChannel8(param, val[c], c, y);
+                __m256i p;
+                switch (numChan) {
+                case 1 : p = _mm256_or_si256(q[0], _mm256_or_si256(_mm256_slli_epi32(q[0], 8),
+                                                                   _mm256_slli_epi32(q[0], 16))); break;
+                case 2 : p = _mm256_or_si256(q[0], _mm256_slli_epi32(q[1], 8)); break;
+                case 3 : p = _mm256_or_si256(q[0], _mm256_or_si256(_mm256_slli_epi32(q[1], 8),
+                                                                   _mm256_slli_epi32(q[2], 16))); break;
+                default : p = _mm256_or_si256(_mm256_or_si256(q[0], _mm256_slli_epi32(q[1], 8)),
+                                              _mm256_or_si256(_mm256_slli_epi32(q[2], 16),
+                                                              _mm256_slli_epi32(q[3], 24))); break;
+                }
+                _mm256_store_si256((__m256i *)packed, p);
+                storeQuantized(dst + x, packed, n);
+                continue;
+            }
+#endif // end __AVX2__
+            for (unsigned i = 0; i < n; ++i) {
+                uint32_t q[4] = {0, 0, 0, 0};
+                for (unsigned c = 0; c < numChan; ++c) q[c] = quantizeChannel(param, val[c][i], c, x + i, y);
+                if (numChan == 1) q[1] = q[2] = q[0];
+                packed[i] = q[0] | (q[1] << 8) | (q[2] << 16) | (q[3] << 24);
+            }
+            storeQuantized(dst + x, packed, n);
         }
-    }
-    const float diff = max - min;
-    if (diff > MIN_NORMALIZED_DISTANCE) {
-        scale = 1.f / diff;
-    }
-    offset = -min;
+    });
 }
 
 }   // End of anon namespace.
@@ -395,59 +565,19 @@ gammaAndQuantizeTo8bit(Rgb888Buffer& destBuffer,
                        PixelBufferUtilOptions options, 
                        float exposure, float gamma)
 {
-    const bool applyGamma = options & PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
-    const bool normalize  = options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE;
-    const bool parallel   = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
-
-    const RenderColor zeroColor(0.0f);
-    const RenderColor oneColor(1.0f);
+    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
 
-    // TODO: parallelize
-    Vec3f offset(0.f);
-    float scale(1.f);
-    if (normalize) {
-        computeNormalizedScaleAndOffset(offset, scale, srcBuffer);
+    QuantizeParam param = setupQuantizeParam(options, exposure, gamma);
+    if (param.mNormalize) {
+        computeNormalizedScaleAndOffsetMain<3>(param.mOffset, param.mScale, srcBuffer,
+                                               [](const RenderColor &p, unsigned c) { return p[c]; },
+                                               parallel);
     }
 
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor *dest,
-                                                  const RenderColor &src,
-                                                  unsigned x, unsigned y) {
-        RenderColor p = src;
-
-        if (normalize) {
-            p[0] = (p[0] + offset[0]) * scale;
-            p[1] = (p[1] + offset[1]) * scale;
-            p[2] = (p[2] + offset[2]) * scale;
-        } else {          
-            // Apply exposure
-            float exposureScale = pow(2.f, exposure);
-            p[0] *= exposureScale;
-            p[1] *= exposureScale;
-            p[2] *= exposureScale;
-
-            // Apply user gamma
-            p[0] = pow(p[0], 1.f / gamma);
-            p[1] = pow(p[1], 1.f / gamma);
-            p[2] = pow(p[2], 1.f / gamma);
-
-            // Clamp pixels to 0.0 -> 1.0 range.
-            p = min(p, oneColor);
-            p = max(p, zeroColor);
-        }
-
-        if (applyGamma) {
-            gammaCorrectColorComponent(p[0]);
-            gammaCorrectColorComponent(p[1]);
-            gammaCorrectColorComponent(p[2]);
-        }
-
-        // Dither and quantize to 8-bit.
-        float ditherVal = sDitherMatrix[y & 7][x & 7];
-        dest->r = uint8_t(p[0] + ditherVal);
-        dest->g = uint8_t(p[1] + ditherVal);
-        dest->b = uint8_t(p[2] + ditherVal);
-
-    }, parallel);
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 3,
+                        [](const RenderColor &src, float v[4]) {
+                            v[0] = src[0]; v[1] = src[1]; v[2] = src[2];
+                        }, options);
 }
 
 static void
@@ -456,47 +586,19 @@ gammaAndQuantizeTo8bit(Rgb888Buffer& destBuffer,
                        PixelBufferUtilOptions options, 
                        float exposure, float gamma)
 {
-    const bool applyGamma = options & PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
-    const bool normalize  = options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE;
-    const bool parallel   = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
 
-    float offset(0.f);
-    float scale(1.f);
-    if (normalize) {
-        computeNormalizedScaleAndOffset(offset, scale, srcBuffer);
+    QuantizeParam param = setupQuantizeParam(options, exposure, gamma);
+    if (param.mNormalize) {
+        computeNormalizedScaleAndOffsetMain<1>(param.mOffset, param.mScale, srcBuffer,
+                                               [](const float &p, unsigned) { return p; },
+                                               parallel);
     }
 
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor *dest,
-                                                   const float &src,
-                                                   unsigned x, unsigned y) {
-        float p = src;
-
-        if (normalize) {
-            p = (p + offset) * scale;
-        } else {
-            // Apply exposure
-            float exposureScale = pow(2.f, exposure);
-            p *= exposureScale;
-
-            // Apply user gamma
-            p = pow(p, 1.f / gamma);
-
-            // Clamp pixels to 0.0 -> 1.0 range.
-            p = min(p, 1.f);
-            p = max(p, 0.f);
-        }
-
-        if (applyGamma) {
-            gammaCorrectColorComponent(p);
-        }
-
-        // Dither and quantize to 8-bit.
-        float ditherVal = sDitherMatrix[y & 7][x & 7];
-        dest->r = uint8_t(p + ditherVal);
-        dest->g = dest->r;
-        dest->b = dest->r;
-
-    }, parallel);
+    // dest->r = dest->g = dest->b = src
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 1,
+                        [](const float &src, float v[4]) { v[0] = src; },
+                        options);
 }
 
 static void
@@ -505,60 +607,21 @@ gammaAndQuantizeTo8bit(Rgb888Buffer& destBuffer,
                        PixelBufferUtilOptions options, 
                        float exposure, float gamma)
 {
-    const bool applyGamma = options & PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
-    const bool normalize  = options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE;
-    const bool parallel   = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+
+    QuantizeParam param = setupQuantizeParam(options, exposure, gamma);
+    if (param.mNormalize) {
+        computeNormalizedScaleAndOffsetMain<2>(param.mOffset, param.mScale, srcBuffer,
+                                               [](const Vec2f &p, unsigned c) { return p[c]; },
+                                               parallel);
+    }
 
     // dest->r = src[0]
     // dest->g = src[1]
     // dest->b = 0
-
-    const Vec2f zeroVec2f(0.f);
-    const Vec2f oneVec2f(1.f);
-
-
-    // TODO: parallelize
-    Vec2f offset(0.f);
-    float scale(1.f);
-    if (normalize) {
-        computeNormalizedScaleAndOffset(offset, scale, srcBuffer);
-    }
-
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor *dest,
-                                                  const Vec2f &src,
-                                                  unsigned x, unsigned y) {
-        Vec2f p = src;
-
-
-        if (normalize) {
-            p = (p + offset) * scale;
-        } else {
-            // Apply exposure
-            float exposureScale = pow(2.f, exposure);
-            p[0] *= exposureScale;
-            p[1] *= exposureScale;
-
-            // Apply user gamma
-            p[0] = pow(p[0], 1.f / gamma);
-            p[1] = pow(p[1], 1.f / gamma);
-
-            // Clamp pixels to 0.0 -> 1.0 range.
-            p = min(p, oneVec2f);
-            p = max(p, zeroVec2f);
-        }
-
-        if (applyGamma) {
-            gammaCorrectColorComponent(p[0]);
-            gammaCorrectColorComponent(p[1]);
-        }
-
-        // Dither and quantize to 8-bit.
-        float ditherVal = sDitherMatrix[y & 7][x & 7];
-        dest->r = uint8_t(p[0] + ditherVal);
-        dest->g = uint8_t(p[1] + ditherVal);
-        dest->b = 0.f;
-
-    }, parallel);
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 2,
+                        [](const Vec2f &src, float v[4]) { v[0] = src[0]; v[1] = src[1]; },
+                        options);
 }
 
 static void
@@ -567,56 +630,19 @@ gammaAndQuantizeTo8bit(Rgb888Buffer& destBuffer,
                        PixelBufferUtilOptions options, 
                        float exposure, float gamma)
 {
-    const bool applyGamma = options & PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
-    const bool normalize  = options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE;
-    const bool parallel   = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
-
-    const Vec3f zeroVec3f(0.f);
-    const Vec3f oneVec3f(1.f);
+    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
 
-    Vec3f offset(0.f);
-    float scale(1.f);
-    if (normalize) {
-        computeNormalizedScaleAndOffset(offset, scale, srcBuffer);
+    QuantizeParam param = setupQuantizeParam(options, exposure, gamma);
+    if (param.mNormalize) {
+        computeNormalizedScaleAndOffsetMain<3>(param.mOffset, param.mScale, srcBuffer,
+                                               [](const Vec3f &p, unsigned c) { return p[c]; },
+                                               parallel);
     }
 
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor *dest,
-                                                  const Vec3f &src,
-                                                  unsigned x, unsigned y) {
-        Vec3f p = src;
-
-        if (normalize) {
-            p = (p + offset) * scale;
-        } else {
-            // Apply exposure
-            float exposureScale = pow(2.f, exposure);
-            p[0] *= exposureScale;
-            p[1] *= exposureScale;
-            p[2] *= exposureScale;
-
-            // Apply user gamma
-            p[0] = pow(p[0], 1.f / gamma);
-            p[1] = pow(p[1], 1.f / gamma);
-            p[2] = pow(p[2], 1.f / gamma);
-
-            // Clamp pixels to 0.0 -> 1.0 range.
-            p = min(p, oneVec3f);
-            p = max(p, zeroVec3f);
-        }
-
-        if (applyGamma) {
-            gammaCorrectColorComponent(p[0]);
-            gammaCorrectColorComponent(p[1]);
-            gammaCorrectColorComponent(p[2]);
-        }
-
-        // Dither and quantize to 8-bit.
-        float ditherVal = sDitherMatrix[y & 7][x & 7];
-        dest->r = uint8_t(p[0] + ditherVal);
-        dest->g = uint8_t(p[1] + ditherVal);
-        dest->b = uint8_t(p[2] + ditherVal);
-
-    }, parallel);
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 3,
+                        [](const Vec3f &src, float v[4]) {
+                            v[0] = src[0]; v[1] = src[1]; v[2] = src[2];
+                        }, options);
 }
 
 void
@@ -647,59 +673,20 @@ gammaAndQuantizeTo8bit(Rgba8888Buffer& destBuffer,
                        PixelBufferUtilOptions options, 
                        float exposure, float gamma)
 {
-    const bool applyGamma = options & PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
-    const bool normalize  = options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE;
-    const bool parallel   = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
-
-    const RenderColor zeroColor(0.0f);
-    const RenderColor oneColor(1.0f);
+    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
 
-    Vec3f offset(0.f);
-    float scale(1.f);
-    if (normalize) {
-        computeNormalizedScaleAndOffset(offset, scale, srcBuffer);
+    QuantizeParam param = setupQuantizeParam(options, exposure, gamma);
+    param.mAlphaThrough = true;
+    if (param.mNormalize) {
+        computeNormalizedScaleAndOffsetMain<3>(param.mOffset, param.mScale, srcBuffer,
+                                               [](const RenderColor &p, unsigned c) { return p[c]; },
+                                               parallel);
     }
 
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor4 *dest,
-                                                  const RenderColor &src,
-                                                  unsigned x, unsigned y) {
-        RenderColor p = src;
-
-        if (normalize) {
-            p[0] = (p[0] + offset[0]) * scale;
-            p[1] = (p[1] + offset[1]) * scale;
-            p[2] = (p[2] + offset[2]) * scale;
-        } else {
-            // Apply exposure
-            float exposureScale = pow(2.f, exposure);
-            p[0] *= exposureScale;
-            p[1] *= exposureScale;
-            p[2] *= exposureScale;
-
-            // Apply user gamma
-            p[0] = pow(p[0], 1.f / gamma);
-            p[1] = pow(p[1], 1.f / gamma);
-            p[2] = pow(p[2], 1.f / gamma);
-
-            // Clamp pixels to 0.0 -> 1.0 range.
-            p = min(p, oneColor);
-            p = max(p, zeroColor);
-        }
-
-        if (applyGamma) {
-            gammaCorrectColorComponent(p[0]);
-            gammaCorrectColorComponent(p[1]);
-            gammaCorrectColorComponent(p[2]);
-        }
-
-        // Dither and quantize to 8-bit.
-        float ditherVal = sDitherMatrix[y & 7][x & 7];
-        dest->r = uint8_t(p[0] + ditherVal);
-        dest->g = uint8_t(p[1] + ditherVal);
-        dest->b = uint8_t(p[2] + ditherVal);
-        dest->a = uint8_t(p[3] + ditherVal);
-
-    }, parallel);
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 4,
+                        [](const RenderColor &src, float v[4]) {
+                            v[0] = src[0]; v[1] = src[1]; v[2] = src[2]; v[3] = src[3];
+                        }, options);
 }
 
 template<typename SRC_PIXEL_TYPE, typename SRC_TO_CHANNEL>
@@ -710,15 +697,14 @@ extractChannelInternal(Rgb888Buffer& destBuffer,
                        PixelBufferUtilOptions options,
                        float exposure, float gamma)
 {
-    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+    // v = gamma22(saturate(pow(s2c(src) * gain, userGamma))) + dither
+    // dest->r = dest->g = dest->b = v
+    QuantizeParam param = setupQuantizeParam(PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA, exposure, gamma);
+    param.mSaturate = true;
 
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor *dest, const SRC_PIXEL_TYPE &src,
-                                                  unsigned x, unsigned y) {
-        float gain = pow(2.f, exposure);
-        float userGamma = 1.f / gamma;                                       
-        uint8_t v = gammaCorrectDitherQuantize(saturate(pow(s2c(src) * gain, userGamma)), x, y);
-        dest->r = dest->g = dest->b = v;
-    }, parallel);
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 1,
+                        [&](const SRC_PIXEL_TYPE &src, float v[4]) { v[0] = s2c(src); },
+                        options);
 }
 
 void
@@ -860,8 +846,10 @@ extractAlphaChannel(Rgb888Buffer& destBuffer,
                     PixelBufferUtilOptions options,
                     float exposure, float gamma)
 {
+    const float gain = pow(2.f, exposure);
+    const float userGamma = 1.f / gamma;
     extractAlphaChannelInternal(destBuffer, srcBuffer,
-                                [exposure, gamma](const RenderColor &v) { return uint8_t(saturate(pow(v.w * pow(2.f, exposure), 1.f / gamma)) * 255.f); },
+                                [gain, userGamma](const RenderColor &v) { return uint8_t(saturate(pow(v.w * gain, userGamma)) * 255.f); },
                                 options);
 }
 
@@ -901,16 +889,12 @@ extractLuminanceInternal(Rgb888Buffer& destBuffer,
                          float gamma)
 
 {
-    const bool parallel = options & PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+    QuantizeParam param = setupQuantizeParam(PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA, exposure, gamma);
+    param.mSaturate = true;
 
-    processPixelBuffer(destBuffer, srcBuffer, [&](ByteColor *dest, const SRC_PIXEL_TYPE &src,
-                                                  unsigned x, unsigned y) {
-        float gain = pow(2.f, exposure);
-        float userGamma = 1.f / gamma;
-        float lum = saturate(pow(luminance(s2c(src)) * gain, userGamma));
-        uint8_t v = gammaCorrectDitherQuantize(lum, x, y);
-        dest->r = dest->g = dest->b = v;
-    }, parallel);
+    quantizePixelBuffer(destBuffer, srcBuffer, param, 1,
+                        [&](const SRC_PIXEL_TYPE &src, float v[4]) { v[0] = luminance(s2c(src)); },
+                        options);
 }
 
 void
@@ -24,7 +24,11 @@ enum  {
     PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE      = 1 << 1,
 
     // Use threads for operation
-    PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL       = 1 << 2
+    PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL       = 1 << 2,
+
+    // Use scalar code instead of SIMD kernels (for testing and debugging purpose).
+    // Result is the same.
+    PIXEL_BUFFER_UTIL_OPTIONS_NO_SIMD        = 1 << 3
 };
 
 typedef unsigned int PixelBufferUtilOptions;
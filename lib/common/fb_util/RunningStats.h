@@ -68,6 +68,9 @@ public:
     T variance() const;
     T standardDeviation() const;
 
+    // merge rhs statistics by parallel Welford algorithm (Chan et al.)
+    RunningStatsLightWeight& operator+=(const RunningStatsLightWeight& rhs);
+
     void set(const unsigned int i, const T &oldM, const T &newM, const T &oldS, const T &newS) {
         n = i; mOldM = oldM; mNewM = newM; mOldS = oldS; mNewS = newS;
     }
@@ -284,6 +287,27 @@ T RunningStatsLightWeight<T>::standardDeviation() const
     return std::sqrt(variance());
 }
 
+template <typename T>
+RunningStatsLightWeight<T>& RunningStatsLightWeight<T>::operator+=(const RunningStatsLightWeight& rhs)
+{
+    if (rhs.n == 0) return *this;
+    if (n == 0) {
+        *this = rhs;
+        return *this;
+    }
+
+    const uint32_t combinedN = n + rhs.n;
+    const float ratio = static_cast<float>(rhs.n) / static_cast<float>(combinedN);
+    const T delta = rhs.mNewM - mNewM;
+
+    mNewM = mNewM + delta * ratio;
+    mNewS = mNewS + rhs.mNewS + delta * delta * (static_cast<float>(n) * ratio);
+    mOldM = mNewM;
+    mOldS = mNewS;
+    n = combinedN;
+    return *this;
+}
+
 template <typename T>
 std::string
 RunningStatsLightWeight<T>::show() const
@@ -0,0 +1,374 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "RunningStatsTiledBuffer.h"
+
+#include <scene_rdl2/common/platform/Platform.h> // finline
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif // end __AVX2__
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+#if defined(__AVX2__)
+namespace {
+
+finline __m256i
+laneMask8(const uint64_t pixMask, const unsigned blockId)
+//
+// expand 8 bits of pixMask for 8 pixels (blockId = row of the tile) to AVX2 lane mask
+//
+{
+    const __m256i bitSel = _mm256_setr_epi32(0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80);
+    const __m256i bits = _mm256_set1_epi32(static_cast<int>((pixMask >> (blockId << 3)) & 0xff));
+    return _mm256_cmpeq_epi32(_mm256_and_si256(bits, bitSel), bitSel);
+}
+
+} // namespace
+#endif // end __AVX2__
+
+void
+RunningStatsTiledBuffer::init(const unsigned width, const unsigned height, const unsigned numChan)
+{
+    MNRY_ASSERT(numChan > 0 && numChan <= sMaxNumChan);
+
+    mWidth = width;
+    mHeight = height;
+    mNumTilesX = (width + 7) >> 3;
+    mNumTilesY = (height + 7) >> 3;
+    mNumChan = numChan;
+
+    mNumSample.init(getAlignedWidth(), getAlignedHeight());
+    mStats.init(64 * 2 * mNumChan, getNumTiles());
+}
+
+void
+RunningStatsTiledBuffer::cleanUp()
+{
+    mWidth = 0;
+    mHeight = 0;
+    mNumTilesX = 0;
+    mNumTilesY = 0;
+    mNumChan = 0;
+
+    mNumSample.cleanUp();
+    mStats.cleanUp();
+}
+
+void
+RunningStatsTiledBuffer::clear()
+{
+    // mean and S are cleared as well, pushTile() and combineTile() start from 0
+    mNumSample.clear();
+    mStats.clear();
+}
+
+void
+RunningStatsTiledBuffer::clearTile(const unsigned tileId)
+{
+    std::memset(mNumSample.getData() + (tileId << 6), 0x0, sizeof(unsigned int) * 64);
+    std::memset(getMean(tileId, 0), 0x0, sizeof(float) * 64 * 2 * mNumChan);
+}
+
+size_t
+RunningStatsTiledBuffer::getMemoryUsage() const
+{
+    return (sizeof(RunningStatsTiledBuffer) +
+            static_cast<size_t>(mNumSample.getArea()) * sizeof(unsigned int) +
+            static_cast<size_t>(mStats.getArea()) * sizeof(float));
+}
+
+bool
+RunningStatsTiledBuffer::isSameSize(const RunningStatsTiledBuffer &buff) const
+{
+    return (mWidth == buff.mWidth && mHeight == buff.mHeight && mNumChan == buff.mNumChan);
+}
+
+//------------------------------------------------------------------------------------------
+
+void
+RunningStatsTiledBuffer::pushTile(const unsigned tileId, const float *val, const uint64_t pixMask)
+//
+// AVX2 version of pushTile_SISD()
+//
+{
+#if defined(__AVX2__)
+    unsigned int *numSample = mNumSample.getData() + (tileId << 6);
+    for (unsigned blockId = 0; blockId < 8; ++blockId) {
+        if (!((pixMask >> (blockId << 3)) & 0xff)) continue;
+
+        const unsigned offset = blockId << 3;
+        const __m256i mask = laneMask8(pixMask, blockId);
+        const __m256 maskF = _mm256_castsi256_ps(mask);
+
+        // mask is -1 for active lanes, so subtraction increments n of active lanes only
+        const __m256i n = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(numSample + offset)), mask);
+        const __m256 invN = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_cvtepi32_ps(n));
+        _mm256_storeu_si256((__m256i *)(numSample + offset), n);
+
+        for (unsigned chan = 0; chan < mNumChan; ++chan) {
+            float *meanPtr = getMean(tileId, chan) + offset;
+            float *sPtr = getS(tileId, chan) + offset;
+            const __m256 x = _mm256_loadu_ps(val + chan * 64 + offset);
+            const __m256 oldMean = _mm256_loadu_ps(meanPtr);
+            const __m256 oldS = _mm256_loadu_ps(sPtr);
+
+            // See Knuth TAOCP vol 2, 3rd edition, page 232
+            const __m256 delta = _mm256_sub_ps(x, oldMean);
+            const __m256 newMean = _mm256_add_ps(oldMean, _mm256_mul_ps(delta, invN));
+            const __m256 newS = _mm256_add_ps(oldS, _mm256_mul_ps(delta, _mm256_sub_ps(x, newMean)));
+
+            _mm256_storeu_ps(meanPtr, _mm256_blendv_ps(oldMean, newMean, maskF));
+            _mm256_storeu_ps(sPtr, _mm256_blendv_ps(oldS, newS, maskF));
+        }
+    }
+#else // else __AVX2__
+    pushTile_SISD(tileId, val, pixMask);
+#endif // end !__AVX2__
+}
+
+void
+RunningStatsTiledBuffer::pushTile_SISD(const unsigned tileId, const float *val, const uint64_t pixMask)
+{
+    unsigned int *numSample = mNumSample.getData() + (tileId << 6);
+    for (unsigned pixId = 0; pixId < 64; ++pixId) {
+        if (!(pixMask & (static_cast<uint64_t>(0x1) << pixId))) continue;
+
+        const unsigned n = ++numSample[pixId];
+        const float invN = 1.0f / static_cast<float>(n);
+        for (unsigned chan = 0; chan < mNumChan; ++chan) {
+            float &mean = getMean(tileId, chan)[pixId];
+            float &s = getS(tileId, chan)[pixId];
+            const float x = val[chan * 64 + pixId];
+            const float delta = x - mean;
+            mean += delta * invN;
+            s += delta * (x - mean);
+        }
+    }
+}
+
+void
+RunningStatsTiledBuffer::push(const unsigned x, const unsigned y, const float *val)
+{
+    const unsigned offset = pixOffset(x, y);
+    const unsigned tileId = offset >> 6;
+    const unsigned pixId = offset & 63;
+
+    const unsigned n = ++(mNumSample.getData()[offset]);
+    const float invN = 1.0f / static_cast<float>(n);
+    for (unsigned chan = 0; chan < mNumChan; ++chan) {
+        float &mean = getMean(tileId, chan)[pixId];
+        float &s = getS(tileId, chan)[pixId];
+        const float delta = val[chan] - mean;
+        mean += delta * invN;
+        s += delta * (val[chan] - mean);
+    }
+}
+
+void
+RunningStatsTiledBuffer::combineTile(const unsigned tileId,
+                                     const RunningStatsTiledBuffer &src,
+                                     const uint64_t pixMask)
+//
+// AVX2 version of combineTile_SISD()
+//
+{
+    MNRY_ASSERT(isSameSize(src));
+
+#if defined(__AVX2__)
+    unsigned int *numSampleA = mNumSample.getData() + (tileId << 6);
+    const unsigned int *numSampleB = src.mNumSample.getData() + (tileId << 6);
+    for (unsigned blockId = 0; blockId < 8; ++blockId) {
+        if (!((pixMask >> (blockId << 3)) & 0xff)) continue;
+
+        const unsigned offset = blockId << 3;
+        const __m256i mask = laneMask8(pixMask, blockId);
+        const __m256 maskF = _mm256_castsi256_ps(mask);
+
+        const __m256i nA = _mm256_loadu_si256((const __m256i *)(numSampleA + offset));
+        const __m256i nB = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(numSampleB + offset)), mask);
+        const __m256i n = _mm256_add_epi32(nA, nB);
+        _mm256_storeu_si256((__m256i *)(numSampleA + offset), n);
+
+        // n = 0 pixels get ratioB = 0 and keep mean and S as is
+        const __m256 nF = _mm256_max_ps(_mm256_cvtepi32_ps(n), _mm256_set1_ps(1.0f));
+        const __m256 ratioB = _mm256_div_ps(_mm256_cvtepi32_ps(nB), nF);
+        const __m256 crossAB = _mm256_mul_ps(_mm256_cvtepi32_ps(nA), ratioB);
+
+        for (unsigned chan = 0; chan < mNumChan; ++chan) {
+            float *meanPtrA = getMean(tileId, chan) + offset;
+            float *sPtrA = getS(tileId, chan) + offset;
+            const __m256 meanA = _mm256_loadu_ps(meanPtrA);
+            const __m256 sA = _mm256_loadu_ps(sPtrA);
+            const __m256 meanB = _mm256_loadu_ps(src.getMean(tileId, chan) + offset);
+            const __m256 sB = _mm256_loadu_ps(src.getS(tileId, chan) + offset);
+
+            // Chan et al. parallel algorithm
+            const __m256 delta = _mm256_sub_ps(meanB, meanA);
+            const __m256 mean = _mm256_add_ps(meanA, _mm256_mul_ps(delta, ratioB));
+            const __m256 s = _mm256_add_ps(_mm256_add_ps(sA, sB),
+                                           _mm256_mul_ps(_mm256_mul_ps(delta, delta), crossAB));
+
+            _mm256_storeu_ps(meanPtrA, _mm256_blendv_ps(meanA, mean, maskF));
+            _mm256_storeu_ps(sPtrA, _mm256_blendv_ps(sA, s, maskF));
+        }
+    }
+#else // else __AVX2__
+    combineTile_SISD(tileId, src, pixMask);
+#endif // end !__AVX2__
+}
+
+void
+RunningStatsTiledBuffer::combineTile_SISD(const unsigned tileId,
+                                          const RunningStatsTiledBuffer &src,
+                                          const uint64_t pixMask)
+{
+    MNRY_ASSERT(isSameSize(src));
+
+    unsigned int *numSampleA = mNumSample.getData() + (tileId << 6);
+    const unsigned int *numSampleB = src.mNumSample.getData() + (tileId << 6);
+    for (unsigned pixId = 0; pixId < 64; ++pixId) {
+        if (!(pixMask & (static_cast<uint64_t>(0x1) << pixId))) continue;
+
+        const unsigned nA = numSampleA[pixId];
+        const unsigned nB = numSampleB[pixId];
+        if (!nB) continue;
+        const unsigned n = nA + nB;
+        numSampleA[pixId] = n;
+
+        const float ratioB = static_cast<float>(nB) / static_cast<float>(n);
+        const float crossAB = static_cast<float>(nA) * ratioB;
+        for (unsigned chan = 0; chan < mNumChan; ++chan) {
+            float &meanA = getMean(tileId, chan)[pixId];
+            float &sA = getS(tileId, chan)[pixId];
+            const float delta = src.getMean(tileId, chan)[pixId] - meanA;
+            meanA += delta * ratioB;
+            sA += src.getS(tileId, chan)[pixId] + delta * delta * crossAB;
+        }
+    }
+}
+
+RunningStatsTiledBuffer &
+RunningStatsTiledBuffer::operator +=(const RunningStatsTiledBuffer &src)
+{
+    MNRY_ASSERT(isSameSize(src));
+
+    tbb::parallel_for(0u, getNumTiles(), [&](unsigned tileId) {
+            combineTile(tileId, src, ~static_cast<uint64_t>(0x0));
+        });
+    return *this;
+}
+
+uint64_t
+RunningStatsTiledBuffer::snapshotTile(const unsigned tileId, const RunningStatsTiledBuffer &src)
+{
+    MNRY_ASSERT(isSameSize(src));
+
+    unsigned int *dstN = mNumSample.getData() + (tileId << 6);
+    const unsigned int *srcN = src.mNumSample.getData() + (tileId << 6);
+
+    uint64_t activeMask = 0x0;
+#if defined(__AVX2__)
+    for (unsigned blockId = 0; blockId < 8; ++blockId) {
+        const unsigned offset = blockId << 3;
+        const __m256i nDst = _mm256_loadu_si256((const __m256i *)(dstN + offset));
+        const __m256i nSrc = _mm256_loadu_si256((const __m256i *)(srcN + offset));
+        const __m256i zero = _mm256_setzero_si256();
+        activeMask |= (static_cast<uint64_t>
+                       (~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(nSrc, zero))) & 0xff)
+                       << offset);
+
+        const __m256 updateF = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_cmpeq_epi32(nDst, nSrc), zero));
+        if (!_mm256_movemask_ps(updateF)) continue;
+
+        _mm256_storeu_si256((__m256i *)(dstN + offset), nSrc);
+        for (unsigned chan = 0; chan < mNumChan; ++chan) {
+            float *dstMean = getMean(tileId, chan) + offset;
+            float *dstS = getS(tileId, chan) + offset;
+            _mm256_storeu_ps(dstMean, _mm256_blendv_ps(_mm256_loadu_ps(dstMean),
+                                                       _mm256_loadu_ps(src.getMean(tileId, chan) + offset),
+                                                       updateF));
+            _mm256_storeu_ps(dstS, _mm256_blendv_ps(_mm256_loadu_ps(dstS),
+                                                    _mm256_loadu_ps(src.getS(tileId, chan) + offset),
+                                                    updateF));
+        }
+    }
+#else // else __AVX2__
+    for (unsigned pixId = 0; pixId < 64; ++pixId) {
+        if (srcN[pixId]) activeMask |= (static_cast<uint64_t>(0x1) << pixId);
+        if (dstN[pixId] == srcN[pixId]) continue;
+
+        dstN[pixId] = srcN[pixId];
+        for (unsigned chan = 0; chan < mNumChan; ++chan) {
+            getMean(tileId, chan)[pixId] = src.getMean(tileId, chan)[pixId];
+            getS(tileId, chan)[pixId] = src.getS(tileId, chan)[pixId];
+        }
+    }
+#endif // end !__AVX2__
+    return activeMask;
+}
+
+//------------------------------------------------------------------------------------------
+
+float
+RunningStatsTiledBuffer::mean(const unsigned x, const unsigned y, const unsigned chan) const
+{
+    const unsigned offset = pixOffset(x, y);
+    return (mNumSample.getData()[offset]) ? getMean(offset >> 6, chan)[offset & 63] : 0.0f;
+}
+
+float
+RunningStatsTiledBuffer::variance(const unsigned x, const unsigned y, const unsigned chan) const
+{
+    const unsigned offset = pixOffset(x, y);
+    const unsigned n = mNumSample.getData()[offset];
+    return (n > 1) ? getS(offset >> 6, chan)[offset & 63] / static_cast<float>(n - 1) : 0.0f;
+}
+
+float
+RunningStatsTiledBuffer::maxVariance(const unsigned x, const unsigned y) const
+{
+    float v = variance(x, y, 0);
+    for (unsigned chan = 1; chan < mNumChan; ++chan) {
+        v = std::max(v, variance(x, y, chan));
+    }
+    return v;
+}
+
+void
+RunningStatsTiledBuffer::extractVariance(PixelBuffer<float> &dst) const
+{
+    dst.init(mWidth, mHeight);
+    tbb::parallel_for(0u, mHeight, [&](unsigned y) {
+            float *dstRow = dst.getRow(y);
+            for (unsigned x = 0; x < mWidth; ++x) {
+                dstRow[x] = maxVariance(x, y);
+            }
+        });
+}
+
+std::string
+RunningStatsTiledBuffer::show() const
+{
+    std::ostringstream ostr;
+    ostr << "RunningStatsTiledBuffer {\n"
+         << "  mWidth:" << mWidth << " mHeight:" << mHeight << '\n'
+         << "  mNumTilesX:" << mNumTilesX << " mNumTilesY:" << mNumTilesY << '\n'
+         << "  mNumChan:" << mNumChan << '\n'
+         << "  getMemoryUsage():" << getMemoryUsage() << " byte\n"
+         << "}";
+    return ostr.str();
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,212 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Structure of arrays version of RunningStatsLightWeight pixel buffer --
+//
+// PixelBuffer<RunningStatsLightWeight<T>> keeps (n, oldM, newM, oldS, newS) interleaved for
+// each pixel and is updated one pixel at a time by push(). This buffer keeps the same
+// Welford statistics (n, mean, S) as separate arrays in the same 8x8 tiled layout as the
+// tiled buffers of grid_util::Fb/FbAov (pixOffset = (tileId << 6) + (y & 7) * 8 + (x & 7)).
+// This drops the duplicated oldM/oldS values (float : 20 -> 12 bytes, Vec3f : 52 -> 28 bytes
+// per pixel) and the tile level push, combine (parallel Welford merge) and snapshot are
+// executed 8 pixels at a time by AVX2.
+//
+// Statistics of each channel are independent. Up to 3 channels are supported in order to
+// cover RunningStatsLightWeight<float>, <Vec2f> and <Vec3f>.
+// This is an opt-in alternative to the *VarianceBuffer types (StatisticsPixelBuffer.h), which
+// stay PixelBuffer<RunningStatsLightWeight<T>>. fromPixelBuffer()/toPixelBuffer() convert between them.
+//
+
+#include "PixelBuffer.h"
+#include "RunningStats.h"
+
+#include <scene_rdl2/common/math/Vec2.h>
+#include <scene_rdl2/common/math/Vec3.h>
+
+#include <stdint.h>             // uint64_t
+#include <string>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+class RunningStatsTiledBuffer
+{
+public:
+    static constexpr unsigned sMaxNumChan = 3;
+
+    RunningStatsTiledBuffer() :
+        mWidth(0),
+        mHeight(0),
+        mNumTilesX(0),
+        mNumTilesY(0),
+        mNumChan(0)
+    {}
+
+    // original width and height (not need to tile aligned), numChan = 1 ~ sMaxNumChan
+    void init(const unsigned width, const unsigned height, const unsigned numChan);
+    void cleanUp();                   // free internal memory
+    void clear();                     // set all pixels to n = 0
+    void clearTile(const unsigned tileId);
+
+    unsigned getWidth() const { return mWidth; }
+    unsigned getHeight() const { return mHeight; }
+    unsigned getAlignedWidth() const { return mNumTilesX << 3; }
+    unsigned getAlignedHeight() const { return mNumTilesY << 3; }
+    unsigned getNumTiles() const { return mNumTilesX * mNumTilesY; }
+    unsigned getNumChan() const { return mNumChan; }
+    size_t getMemoryUsage() const; // byte
+    bool isSameSize(const RunningStatsTiledBuffer &buff) const;
+
+    //------------------------------
+
+    // push one sample to each pixel of the tile which is marked by pixMask.
+    // val is channel major : val[chan * 64 + pixOffsetInTile]
+    void pushTile(const unsigned tileId, const float *val, const uint64_t pixMask);
+    // for testing purpose
+    void pushTile_SISD(const unsigned tileId, const float *val, const uint64_t pixMask);
+
+    // push one sample to one pixel. val has getNumChan() values
+    void push(const unsigned x, const unsigned y, const float *val);
+    // same as above by the pixel type of RunningStatsLightWeight<T> (float, math::Vec2f or math::Vec3f)
+    template <typename T> void push(const unsigned x, const unsigned y, const T &val);
+
+    // merge src statistics into this buffer by parallel Welford algorithm for the pixels of
+    // the tile which is marked by pixMask. Result is same as pushing all the samples of src.
+    void combineTile(const unsigned tileId, const RunningStatsTiledBuffer &src, const uint64_t pixMask);
+    // for testing purpose
+    void combineTile_SISD(const unsigned tileId, const RunningStatsTiledBuffer &src, const uint64_t pixMask);
+
+    // combine all the tiles by multi-thread. src should be the same size
+    RunningStatsTiledBuffer &operator +=(const RunningStatsTiledBuffer &src);
+
+    // make snapshot of src tile into this buffer.
+    // Only pixels which have different sample count are copied and return active pixel mask
+    // for this tile (= pixels which have at least 1 sample) like SnapshotUtil.
+    uint64_t snapshotTile(const unsigned tileId, const RunningStatsTiledBuffer &src);
+
+    //------------------------------
+
+    unsigned numDataValues(const unsigned x, const unsigned y) const { return mNumSample.getData()[pixOffset(x, y)]; }
+    float mean(const unsigned x, const unsigned y, const unsigned chan) const;
+    float variance(const unsigned x, const unsigned y, const unsigned chan) const;
+    float maxVariance(const unsigned x, const unsigned y) const; // max variance of all channels
+
+    // output variance image (max of all channels) in non tiled format.
+    // dst is initialized by original resolution.
+    void extractVariance(PixelBuffer<float> &dst) const;
+
+    //------------------------------
+
+    // conversion between PixelBuffer<RunningStatsLightWeight<T>> (non tiled format).
+    // T is float, math::Vec2f or math::Vec3f.
+    template <typename T> void fromPixelBuffer(const PixelBuffer<RunningStatsLightWeight<T>> &src);
+    template <typename T> void toPixelBuffer(PixelBuffer<RunningStatsLightWeight<T>> &dst) const;
+
+    std::string show() const;
+
+protected:
+    unsigned pixOffset(const unsigned x, const unsigned y) const {
+        return ((((y >> 3) * mNumTilesX) + (x >> 3)) << 6) + ((y & 7) << 3) + (x & 7);
+    }
+
+    // mean and S of chan for the tile
+    float *getMean(const unsigned tileId, const unsigned chan) {
+        return mStats.getData() + (tileId * mNumChan * 2 + chan) * 64;
+    }
+    const float *getMean(const unsigned tileId, const unsigned chan) const {
+        return mStats.getData() + (tileId * mNumChan * 2 + chan) * 64;
+    }
+    float *getS(const unsigned tileId, const unsigned chan) { return getMean(tileId, chan) + mNumChan * 64; }
+    const float *getS(const unsigned tileId, const unsigned chan) const { return getMean(tileId, chan) + mNumChan * 64; }
+
+    unsigned mWidth, mHeight;   // original image size
+    unsigned mNumTilesX, mNumTilesY;
+    unsigned mNumChan;
+
+    PixelBuffer<unsigned int> mNumSample; // tiled format : tile aligned resolution
+    PixelBuffer<float> mStats;            // each tile : mean[chan][64], S[chan][64]
+};
+
+namespace detail {
+
+inline unsigned runningStatsNumChan(float) { return 1; }
+inline unsigned runningStatsNumChan(const math::Vec2f &) { return 2; }
+inline unsigned runningStatsNumChan(const math::Vec3f &) { return 3; }
+
+inline float runningStatsChan(float v, unsigned) { return v; }
+inline float runningStatsChan(const math::Vec2f &v, unsigned chan) { return v[chan]; }
+inline float runningStatsChan(const math::Vec3f &v, unsigned chan) { return v[chan]; }
+
+inline void runningStatsSetChan(float &v, unsigned, float f) { v = f; }
+inline void runningStatsSetChan(math::Vec2f &v, unsigned chan, float f) { v[chan] = f; }
+inline void runningStatsSetChan(math::Vec3f &v, unsigned chan, float f) { v[chan] = f; }
+
+} // namespace detail
+
+template <typename T>
+void
+RunningStatsTiledBuffer::push(const unsigned x, const unsigned y, const T &val)
+{
+    MNRY_ASSERT(detail::runningStatsNumChan(T()) == mNumChan);
+
+    float v[sMaxNumChan];
+    for (unsigned chan = 0; chan < mNumChan; ++chan) v[chan] = detail::runningStatsChan(val, chan);
+    push(x, y, static_cast<const float *>(v));
+}
+
+template <typename T>
+void
+RunningStatsTiledBuffer::fromPixelBuffer(const PixelBuffer<RunningStatsLightWeight<T>> &src)
+{
+    init(src.getWidth(), src.getHeight(), detail::runningStatsNumChan(T()));
+    clear();
+    for (unsigned y = 0; y < mHeight; ++y) {
+        for (unsigned x = 0; x < mWidth; ++x) {
+            const RunningStatsLightWeight<T> &pix = src.getPixel(x, y);
+            const unsigned n = static_cast<unsigned>(pix.numDataValues());
+            if (!n) continue;
+
+            const unsigned offset = pixOffset(x, y);
+            const unsigned tileId = offset >> 6;
+            const unsigned pixId = offset & 63;
+            mNumSample.getData()[offset] = n;
+            const T m = pix.mean();
+            const T v = pix.variance();
+            for (unsigned chan = 0; chan < mNumChan; ++chan) {
+                getMean(tileId, chan)[pixId] = detail::runningStatsChan(m, chan);
+                getS(tileId, chan)[pixId] = detail::runningStatsChan(v, chan) * static_cast<float>(n - 1);
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+RunningStatsTiledBuffer::toPixelBuffer(PixelBuffer<RunningStatsLightWeight<T>> &dst) const
+{
+    MNRY_ASSERT(detail::runningStatsNumChan(T()) == mNumChan);
+
+    dst.init(mWidth, mHeight);
+    for (unsigned y = 0; y < mHeight; ++y) {
+        for (unsigned x = 0; x < mWidth; ++x) {
+            const unsigned offset = pixOffset(x, y);
+            const unsigned tileId = offset >> 6;
+            const unsigned pixId = offset & 63;
+            T m = getZero<T>();
+            T s = getZero<T>();
+            for (unsigned chan = 0; chan < mNumChan; ++chan) {
+                detail::runningStatsSetChan(m, chan, getMean(tileId, chan)[pixId]);
+                detail::runningStatsSetChan(s, chan, getS(tileId, chan)[pixId]);
+            }
+            dst.getPixel(x, y).set(mNumSample.getData()[offset], m, m, s, s);
+        }
+    }
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
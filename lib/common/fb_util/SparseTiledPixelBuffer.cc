@@ -0,0 +1,115 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "SparseTiledPixelBuffer.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif // end __AVX2__
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+namespace {
+
+constexpr size_t sTileGrainSize = 256; // number of tiles for each parallel task
+
+inline void
+copyTileNonTemporal(uint8_t *dst, const uint8_t *src, const size_t size)
+{
+#if defined(__AVX2__)
+    // Non-temporal store needs 32 byte aligned destination. Copy the unaligned head and tail
+    // by memcpy. This works for any destination because the packed buffer is supplied by the
+    // caller (i.e. ValueContainerEnq's buffer) and its alignment is unknown.
+    size_t head = std::min(size, static_cast<size_t>((32 - (reinterpret_cast<uintptr_t>(dst) & 31)) & 31));
+    if (head) std::memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 32 <= size; i += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + i),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+    }
+    if (i < size) std::memcpy(dst + i, src + i, size - i);
+#else // else __AVX2__
+    std::memcpy(dst, src, size);
+#endif // end !__AVX2__
+}
+
+template <bool pack>
+void
+copyTiles(uint8_t *tiledBuffer,
+          uint8_t *packedBuffer,
+          const size_t tileBytes,
+          const unsigned *tileIds,
+          const size_t numTiles,
+          const bool parallel)
+{
+    const bool nonTemporal = (tileBytes * numTiles > sNonTemporalCopyThreshold);
+
+    auto copyRange = [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; ++i) {
+            uint8_t *tiled = tiledBuffer + static_cast<size_t>(tileIds[i]) * tileBytes;
+            uint8_t *packed = packedBuffer + i * tileBytes;
+            uint8_t *dst = (pack) ? packed : tiled;
+            const uint8_t *src = (pack) ? tiled : packed;
+            if (nonTemporal) {
+                copyTileNonTemporal(dst, src, tileBytes);
+            } else {
+                std::memcpy(dst, src, tileBytes);
+            }
+        }
+#if defined(__AVX2__)
+        // make non-temporal stores visible before the task finishes.
+        if (nonTemporal) _mm_sfence();
+#endif // end __AVX2__
+    };
+
+    if (!parallel || numTiles <= sTileGrainSize) {
+        copyRange(0, numTiles);
+    } else {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numTiles, sTileGrainSize),
+                          [&](const tbb::blocked_range<size_t> &range) {
+                              copyRange(range.begin(), range.end());
+                          });
+    }
+}
+
+} // namespace
+
+void
+packTiles(uint8_t *dstPackedBuffer,
+          const uint8_t *srcTiledBuffer,
+          const size_t tileBytes,
+          const unsigned *tileIds,
+          const size_t numTiles,
+          const bool parallel)
+{
+    MNRY_ASSERT(dstPackedBuffer && srcTiledBuffer);
+
+    copyTiles<true>(const_cast<uint8_t *>(srcTiledBuffer), dstPackedBuffer,
+                    tileBytes, tileIds, numTiles, parallel);
+}
+
+void
+unpackTiles(uint8_t *dstTiledBuffer,
+            const uint8_t *srcPackedBuffer,
+            const size_t tileBytes,
+            const unsigned *tileIds,
+            const size_t numTiles,
+            const bool parallel)
+{
+    MNRY_ASSERT(dstTiledBuffer && srcPackedBuffer);
+
+    copyTiles<false>(dstTiledBuffer, const_cast<uint8_t *>(srcPackedBuffer),
+                     tileBytes, tileIds, numTiles, parallel);
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -10,6 +10,7 @@
 #include <scene_rdl2/common/platform/Platform.h>
 
 #include <type_traits>
+#include <vector>
 
 namespace scene_rdl2 {
 namespace fb_util {
@@ -18,6 +19,36 @@ namespace fb_util {
 // Sparse tile buffer functionality. 
 //
 
+// Byte level tile copy between a tiled buffer and a packed buffer. tileBytes is the size of
+// one 64 pixel tile (64 * sizeof(pixel)) and tileIds are coarse tile ids
+// (= tiled offset of the tile / 64). The packed buffer keeps the tiles in tileIds order.
+// Tiles are copied by multiple threads if parallel is true. When the total copy size is
+// larger than sNonTemporalCopyThreshold, the destination is written by non-temporal stores
+// so that a large copy does not flush the cache which is used by the other threads.
+constexpr size_t sNonTemporalCopyThreshold = 4 * 1024 * 1024; // byte
+
+void packTiles(uint8_t *dstPackedBuffer,
+               const uint8_t *srcTiledBuffer,
+               const size_t tileBytes,
+               const unsigned *tileIds,
+               const size_t numTiles,
+               const bool parallel);
+void unpackTiles(uint8_t *dstTiledBuffer,
+                 const uint8_t *srcPackedBuffer,
+                 const size_t tileBytes,
+                 const unsigned *tileIds,
+                 const size_t numTiles,
+                 const bool parallel);
+
+inline void
+tilesToTileIds(const Tiler &tiler, const std::vector<Tile> &tiles, std::vector<unsigned> &tileIds)
+{
+    tileIds.resize(tiles.size());
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        tileIds[i] = tiler.linearCoordsToCoarseTileOffset(tiles[i].mMinX, tiles[i].mMinY) >> 6;
+    }
+}
+
 // Pack sparse tile data into the supplied memory block, given a tiled source
 // buffer and the corresponding tile list. 
 // The buffer passed in much be numTiles * 64 * sizeof(PIXEL_TYPE) in length.
@@ -26,29 +57,23 @@ template<typename PIXEL_TYPE>
 inline bool
 packSparseTiles(PIXEL_TYPE *dstPackedBuffer,
                 PixelBuffer<PIXEL_TYPE> const &srcTiledBuffer,
-                const std::vector<Tile> &tiles)
+                const std::vector<Tile> &tiles,
+                const bool parallel = false)
 {
     MNRY_ASSERT(dstPackedBuffer);
     MNRY_ASSERT(srcTiledBuffer.getWidth() % 8 == 0);
     MNRY_ASSERT(srcTiledBuffer.getHeight() % 8 == 0);
 
-    unsigned numTiles = (unsigned)tiles.size();
-    if (numTiles == 0) {
+    if (tiles.empty()) {
         return false;
     }
 
-    Tiler tiler(srcTiledBuffer.getWidth(), srcTiledBuffer.getHeight());
+    std::vector<unsigned> tileIds;
+    tilesToTileIds(Tiler(srcTiledBuffer.getWidth(), srcTiledBuffer.getHeight()), tiles, tileIds);
 
-    const PIXEL_TYPE *src = srcTiledBuffer.getData();
-    PIXEL_TYPE *dst = dstPackedBuffer;
-    for (unsigned i = 0; i < numTiles; ++i) {
-        const Tile &tile = tiles[i];
-        unsigned ofs = tiler.linearCoordsToCoarseTileOffset(tile.mMinX, tile.mMinY);
-        memcpy(dst, src + ofs, sizeof(PIXEL_TYPE) * 64);
-        dst += 64;
-    }
-
-    MNRY_ASSERT(dst == dstPackedBuffer + numTiles * 64);
+    packTiles(reinterpret_cast<uint8_t *>(dstPackedBuffer),
+              reinterpret_cast<const uint8_t *>(srcTiledBuffer.getData()),
+              sizeof(PIXEL_TYPE) * 64, tileIds.data(), tileIds.size(), parallel);
 
     return true;
 }
@@ -59,33 +84,32 @@ template<typename PIXEL_TYPE>
 inline bool
 unpackSparseTiles(PixelBuffer<PIXEL_TYPE> *dstTiledBuffer,
                   const PIXEL_TYPE *srcPackedData,
-                  const std::vector<Tile> &tiles)
+                  const std::vector<Tile> &tiles,
+                  const bool parallel = false)
 {
     MNRY_ASSERT(dstTiledBuffer);
     MNRY_ASSERT(dstTiledBuffer->getWidth() % 8 == 0);
     MNRY_ASSERT(dstTiledBuffer->getHeight() % 8 == 0);
 
-    unsigned numTiles = (unsigned)tiles.size();
-    if (numTiles == 0 || dstTiledBuffer->getArea() == 0) {
+    if (tiles.empty() || dstTiledBuffer->getArea() == 0) {
         return false;
     }
 
     unsigned w = dstTiledBuffer->getWidth();
     unsigned h = dstTiledBuffer->getHeight();
 
-    Tiler tiler(w, h);
-
-    const PIXEL_TYPE *src = srcPackedData;
-    PIXEL_TYPE *dst = dstTiledBuffer->getData();
-    for (unsigned i = 0; i < numTiles; ++i) {
-        const Tile &tile = tiles[i];
+#ifdef DEBUG
+    for (const Tile &tile : tiles) {
         MNRY_ASSERT(tile.mMaxX <= w && tile.mMaxY <= h);
-        unsigned ofs = tiler.linearCoordsToCoarseTileOffset(tile.mMinX, tile.mMinY);
-        memcpy(dst + ofs, src, sizeof(PIXEL_TYPE) * 64);
-        src += 64;
     }
+#endif // end DEBUG
+
+    std::vector<unsigned> tileIds;
+    tilesToTileIds(Tiler(w, h), tiles, tileIds);
 
-    MNRY_ASSERT(src == srcPackedData + numTiles * 64);
+    unpackTiles(reinterpret_cast<uint8_t *>(dstTiledBuffer->getData()),
+                reinterpret_cast<const uint8_t *>(srcPackedData),
+                sizeof(PIXEL_TYPE) * 64, tileIds.data(), tileIds.size(), parallel);
 
     return true;
 }
@@ -14,6 +14,7 @@ typedef PixelBuffer<RunningStatsLightWeight<float>> RgbVarianceBuffer;
 typedef PixelBuffer<RunningStatsLightWeight<float>> FloatVarianceBuffer;         // This is simply the float variance of a float variable
 typedef PixelBuffer<RunningStatsLightWeight<math::Vec2f>> Float2VarianceBuffer;  // We collect the statistics of a 2D vector, but we only write out the maximum variance
 typedef PixelBuffer<RunningStatsLightWeight<math::Vec3f>> Float3VarianceBuffer;  // We collect the statistics of a 3D vector, but we only write out the maximum variance
+// RunningStatsTiledBuffer.h is an opt-in structure of arrays tiled version of the buffers above.
 
 // fulldump version for snapshot and file output
 typedef PixelBuffer<RunningStatsLightWeightFulldump<float>> RgbVarianceFulldumpBuffer; // illuminance of RGB channels
@@ -1113,6 +1113,118 @@ TileExtrapolation::TileExtrapolation()
         mExtrapolationPhaseManager_bundle7[pixId].init(pixId, 7);
         mExtrapolationPhaseManager_bundle8[pixId].init(pixId, 8);
     }
+
+    //
+    // precompute known patterns : full tile and coarse pass 4 pixels (every 4 pixels) and
+    // 16 pixels (every 2 pixels) lattice with all the offsets. Single pixel does not need a table.
+    //
+    addPreset(~static_cast<uint64_t>(0x0));
+    for (int step : {4, 2}) {
+        for (int offY = 0; offY < step; ++offY) {
+            for (int offX = 0; offX < step; ++offX) {
+                uint64_t mask = 0x0;
+                for (int y = offY; y < 8; y += step) {
+                    for (int x = offX; x < 8; x += step) {
+                        mask |= static_cast<uint64_t>(0x1) << ((y << 3) + x);
+                    }
+                }
+                addPreset(mask);
+            }
+        }
+    }
+
+    mCache.reset(new CacheEntry[sCacheSize]);
+    for (unsigned i = 0; i < sCacheSize; ++i) {
+        mCache[i].mSeq.store(0, std::memory_order_relaxed);
+        mCache[i].mMask.store(0x0, std::memory_order_relaxed);
+        for (int j = 0; j < 8; ++j) mCache[i].mPixId[j].store(0x0, std::memory_order_relaxed);
+    }
+
+    mCacheStats.store(false, std::memory_order_relaxed);
+    resetCacheStats();
+}
+
+void
+TileExtrapolation::searchActiveNearestPixelCached(const uint64_t activePixelMask,
+                                                  int extrapolatePixIdArray[64]) const
+{
+    const bool stats = mCacheStats.load(std::memory_order_relaxed);
+
+    if (countBit64(activePixelMask) <= 1) {
+        // single pixel : all pixels use this pixel. No active pixel : -1 (same as searchActiveNearestPixel)
+        const int pixId = (activePixelMask) ? static_cast<int>(countRightZeroBit(activePixelMask)) : -1;
+        for (int i = 0; i < 64; ++i) extrapolatePixIdArray[i] = pixId;
+        if (stats) mCachePresetHit.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (const uint64_t *packed = findPreset(activePixelMask)) {
+        unpackPixIdArray(packed, extrapolatePixIdArray);
+        if (stats) mCachePresetHit.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    CacheEntry &entry = mCache[hashMask(activePixelMask, sCacheSize)];
+
+    //
+    // lookup : sequence lock reader. Retry is not needed, just fall back to the search.
+    //
+    const unsigned seq = entry.mSeq.load(std::memory_order_acquire);
+    if (!(seq & 0x1) && entry.mMask.load(std::memory_order_relaxed) == activePixelMask) {
+        uint64_t packed[8];
+        for (int i = 0; i < 8; ++i) packed[i] = entry.mPixId[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.mSeq.load(std::memory_order_relaxed) == seq) {
+            unpackPixIdArray(packed, extrapolatePixIdArray);
+            if (stats) mCacheHit.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    //
+    // miss : search and update the entry. Skip update if another thread is updating it.
+    //
+    searchActiveNearestPixel(activePixelMask, extrapolatePixIdArray);
+    if (stats) mCacheMiss.fetch_add(1, std::memory_order_relaxed);
+
+    unsigned currSeq = entry.mSeq.load(std::memory_order_relaxed);
+    if (!(currSeq & 0x1) &&
+        entry.mSeq.compare_exchange_strong(currSeq, currSeq + 1, std::memory_order_acquire)) {
+        // Odd mSeq has to be visible before any of the data stores. Otherwise a reader could see
+        // the new data with the old even mSeq.
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t packed[8];
+        packPixIdArray(extrapolatePixIdArray, packed);
+        entry.mMask.store(activePixelMask, std::memory_order_relaxed);
+        for (int i = 0; i < 8; ++i) entry.mPixId[i].store(packed[i], std::memory_order_relaxed);
+        entry.mSeq.store(currSeq + 2, std::memory_order_release);
+    }
+}
+
+void
+TileExtrapolation::resetCacheStats()
+{
+    mCachePresetHit.store(0, std::memory_order_relaxed);
+    mCacheHit.store(0, std::memory_order_relaxed);
+    mCacheMiss.store(0, std::memory_order_relaxed);
+}
+
+std::string
+TileExtrapolation::showCacheStats() const
+{
+    const uint64_t presetHit = getCachePresetHit();
+    const uint64_t hit = getCacheHit();
+    const uint64_t miss = getCacheMiss();
+    const uint64_t total = presetHit + hit + miss;
+    auto pct = [&](uint64_t v) { return (total) ? static_cast<float>(v) / static_cast<float>(total) * 100.0f : 0.0f; };
+
+    std::ostringstream ostr;
+    ostr << "TileExtrapolation cache stats (total:" << total << ") {\n"
+         << "  presetHit:" << presetHit << " (" << std::setprecision(3) << pct(presetHit) << "%)\n"
+         << "  cacheHit:" << hit << " (" << pct(hit) << "%)\n"
+         << "  cacheMiss:" << miss << " (" << pct(miss) << "%)\n"
+         << "}";
+    return ostr.str();
 }
 
 std::string
@@ -1175,6 +1287,53 @@ TileExtrapolation::getPhaseManager(const int maskBundleTotal, const int pixId) c
     return mExtrapolationPhaseManager_bundle2[pixId]; // useless return val.
 }
 
+// static function
+void
+TileExtrapolation::packPixIdArray(const int extrapolatePixIdArray[64], uint64_t packed[8])
+{
+    for (int i = 0; i < 8; ++i) {
+        uint64_t word = 0x0;
+        for (int j = 0; j < 8; ++j) {
+            word |= static_cast<uint64_t>(static_cast<uint8_t>(extrapolatePixIdArray[(i << 3) + j])) << (j << 3);
+        }
+        packed[i] = word;
+    }
+}
+
+// static function
+void
+TileExtrapolation::unpackPixIdArray(const uint64_t packed[8], int extrapolatePixIdArray[64])
+{
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            extrapolatePixIdArray[(i << 3) + j] = static_cast<int8_t>((packed[i] >> (j << 3)) & 0xff);
+        }
+    }
+}
+
+void
+TileExtrapolation::addPreset(const uint64_t mask)
+{
+    int extrapolatePixIdArray[64];
+    searchActiveNearestPixel(mask, extrapolatePixIdArray);
+
+    unsigned id = hashMask(mask, sPresetTableSize);
+    while (mPreset[id].mMask && mPreset[id].mMask != mask) id = (id + 1) & (sPresetTableSize - 1);
+    mPreset[id].mMask = mask;
+    packPixIdArray(extrapolatePixIdArray, mPreset[id].mPixId);
+}
+
+const uint64_t *
+TileExtrapolation::findPreset(const uint64_t mask) const
+{
+    unsigned id = hashMask(mask, sPresetTableSize);
+    while (mPreset[id].mMask) {
+        if (mPreset[id].mMask == mask) return mPreset[id].mPixId;
+        id = (id + 1) & (sPresetTableSize - 1);
+    }
+    return nullptr;
+}
+
 // static function
 uint64_t
 TileExtrapolation::getPixelSearchMask(const int x, const int y, const int maskId) // for debug
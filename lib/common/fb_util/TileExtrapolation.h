@@ -17,10 +17,15 @@
 // See TileExtrapolation.cc for more detail of extrapolation logic itself.
 //
 // Call TileExtrapolation::searchActiveNearestPixel() to do tile extrapolation.
+// TileExtrapolation::searchActiveNearestPixelCached() returns the same result for the whole
+// tile by the memoized result of the active pixel mask.
 //
 
 #include <scene_rdl2/common/platform/Intrinsics.h>
 
+#include <atomic>
+#include <memory>
+#include <stdint.h>             // uint64_t
 #include <string>
 #include <vector>
 
@@ -489,6 +494,25 @@ public:
         }
     }
 
+    //
+    // Same result as searchActiveNearestPixel() for the whole tile. MT-safe.
+    // Most of the tiles in progressive rendering share a handful of mask patterns (full tile,
+    // single pixel and coarse pass 1/4/16 pixels lattice). Results of these known patterns are
+    // precomputed by the constructor and the results of other patterns are memoized by a small
+    // direct mapped cache (sCacheSize entries). Cache entries are protected by a sequence
+    // counter, so lookup never takes a lock and a reader never sees a half written entry.
+    //
+    void searchActiveNearestPixelCached(const uint64_t activePixelMask, int extrapolatePixIdArray[64]) const;
+
+    // Cache hit statistics for performance analysis. Counters are only updated after
+    // setCacheStats(true) because atomic counting from all the threads is not free.
+    void setCacheStats(const bool sw) { mCacheStats.store(sw, std::memory_order_relaxed); }
+    void resetCacheStats();
+    uint64_t getCachePresetHit() const { return mCachePresetHit.load(std::memory_order_relaxed); }
+    uint64_t getCacheHit() const { return mCacheHit.load(std::memory_order_relaxed); }
+    uint64_t getCacheMiss() const { return mCacheMiss.load(std::memory_order_relaxed); }
+    std::string showCacheStats() const;
+
     static std::string showMask(const std::string &hd, const uint64_t mask);
     static std::string showPixIdArray(const std::string &hd, const int extrapolatePixIdArray[64]);
 
@@ -508,6 +532,32 @@ protected:
     finline uint64_t countBit64(uint64_t mask64) const;
     finline uint64_t countRightZeroBit(uint64_t mask64) const;
 
+    static constexpr unsigned sPresetTableSize = 64; // open addressing table. 21 patterns are used
+    static constexpr unsigned sCacheSize = 1024;     // must be power of 2
+
+    // 64 pixIds as int8_t are packed into 8 uint64_t
+    static void packPixIdArray(const int extrapolatePixIdArray[64], uint64_t packed[8]);
+    static void unpackPixIdArray(const uint64_t packed[8], int extrapolatePixIdArray[64]);
+    static unsigned hashMask(const uint64_t mask, const unsigned tableSize) {
+        return static_cast<unsigned>((mask * 0x9e3779b97f4a7c15ULL) >> 32) & (tableSize - 1);
+    }
+
+    void addPreset(const uint64_t mask);
+    const uint64_t *findPreset(const uint64_t mask) const; // return nullptr if not found
+
+    struct PresetEntry
+    {
+        uint64_t mMask {0};     // 0 : empty
+        uint64_t mPixId[8];
+    };
+
+    struct alignas(64) CacheEntry
+    {
+        std::atomic<unsigned> mSeq;      // odd : under update
+        std::atomic<uint64_t> mMask;     // 0 : empty
+        std::atomic<uint64_t> mPixId[8];
+    };
+
     //------------------------------
 
     //
@@ -522,6 +572,14 @@ protected:
     TileExtrapolationPhaseManager mExtrapolationPhaseManager_bundle6[64];
     TileExtrapolationPhaseManager mExtrapolationPhaseManager_bundle7[64];
     TileExtrapolationPhaseManager mExtrapolationPhaseManager_bundle8[64];
+
+    PresetEntry mPreset[sPresetTableSize];
+    std::unique_ptr<CacheEntry[]> mCache;
+
+    std::atomic<bool> mCacheStats;
+    mutable std::atomic<uint64_t> mCachePresetHit;
+    mutable std::atomic<uint64_t> mCacheHit;
+    mutable std::atomic<uint64_t> mCacheMiss;
 }; // TileExtrapolation
 
 finline uint64_t
@@ -0,0 +1,85 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "TilePyramidFill.h"
+
+#include <algorithm>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+void
+TilePyramidFill::pushPull(const int width, const int height, const int chanTotal,
+                          std::vector<float> &val, std::vector<char> &valid)
+{
+    if (std::all_of(valid.begin(), valid.end(), [](char v) { return v != 0; })) return;
+    if (width == 1 && height == 1) return; // no valid cell at all
+
+    //
+    // pull : coarse cell is the mean of the valid 2x2 cells
+    //
+    const int coarseW = (width + 1) / 2;
+    const int coarseH = (height + 1) / 2;
+    std::vector<float> coarseVal(static_cast<size_t>(coarseW) * coarseH * chanTotal, 0.0f);
+    std::vector<char> coarseValid(static_cast<size_t>(coarseW) * coarseH, 0);
+    for (int cy = 0; cy < coarseH; ++cy) {
+        for (int cx = 0; cx < coarseW; ++cx) {
+            float *dst = &coarseVal[(static_cast<size_t>(cy) * coarseW + cx) * chanTotal];
+            int validTotal = 0;
+            for (int y = cy * 2; y < std::min(cy * 2 + 2, height); ++y) {
+                for (int x = cx * 2; x < std::min(cx * 2 + 2, width); ++x) {
+                    const size_t cellId = static_cast<size_t>(y) * width + x;
+                    if (!valid[cellId]) continue;
+                    for (int c = 0; c < chanTotal; ++c) dst[c] += val[cellId * chanTotal + c];
+                    ++validTotal;
+                }
+            }
+            if (validTotal) {
+                const float scale = 1.0f / static_cast<float>(validTotal);
+                for (int c = 0; c < chanTotal; ++c) dst[c] *= scale;
+                coarseValid[static_cast<size_t>(cy) * coarseW + cx] = 1;
+            }
+        }
+    }
+
+    pushPull(coarseW, coarseH, chanTotal, coarseVal, coarseValid);
+
+    //
+    // push : invalid cell is the bilinear interpolation of the coarse level
+    //
+    auto pos = [](const int cell, const int coarseTotal, int &c0, int &c1, float &t) {
+        float p = (static_cast<float>(cell) + 0.5f) * 0.5f - 0.5f;
+        p = std::min(std::max(p, 0.0f), static_cast<float>(coarseTotal - 1));
+        c0 = static_cast<int>(p);
+        c1 = std::min(c0 + 1, coarseTotal - 1);
+        t = p - static_cast<float>(c0);
+    };
+    for (int y = 0; y < height; ++y) {
+        int y0, y1;
+        float ty;
+        pos(y, coarseH, y0, y1, ty);
+        for (int x = 0; x < width; ++x) {
+            const size_t cellId = static_cast<size_t>(y) * width + x;
+            if (valid[cellId]) continue;
+            int x0, x1;
+            float tx;
+            pos(x, coarseW, x0, x1, tx);
+            const float *v00 = &coarseVal[(static_cast<size_t>(y0) * coarseW + x0) * chanTotal];
+            const float *v01 = &coarseVal[(static_cast<size_t>(y0) * coarseW + x1) * chanTotal];
+            const float *v10 = &coarseVal[(static_cast<size_t>(y1) * coarseW + x0) * chanTotal];
+            const float *v11 = &coarseVal[(static_cast<size_t>(y1) * coarseW + x1) * chanTotal];
+            float *dst = &val[cellId * chanTotal];
+            for (int c = 0; c < chanTotal; ++c) {
+                const float a = v00[c] + (v01[c] - v00[c]) * tx;
+                const float b = v10[c] + (v11[c] - v10[c]) * tx;
+                dst[c] = a + (b - a) * ty;
+            }
+            valid[cellId] = 1;
+        }
+    }
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
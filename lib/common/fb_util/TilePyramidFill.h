@@ -0,0 +1,223 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Cross tile extrapolation for fully inactive tiles --
+//
+// TileExtrapolation only fills the pixels inside a tile which has at least one active pixel.
+// Fully inactive tiles stay empty and early progressive frames look blocky or black.
+// TilePyramidFill fills these tiles from the neighboring tiles by push-pull on the tile grid.
+//
+//   1) Each tile which has active pixels becomes one cell of the tile grid. The cell value is
+//      the mean of the sampled active pixels (1/4 of the pixels by mask operation).
+//   2) Pull : build coarser levels by averaging the valid 2x2 cells until all cells are valid.
+//   3) Push : fill invalid cells of each finer level by bilinear interpolation of the coarser
+//      level. After this, every cell of the tile grid has a value.
+//   4) Pixels of the fully inactive tiles are filled by bilinear interpolation of the tile grid.
+//      So the result is a smooth gradient and not a flat 8x8 block.
+//
+// This runs after TileExtrapolation, so the partially active tiles are still extrapolated by the
+// precomputed search masks and this class only touches fully inactive tiles. The search masks
+// only cover the pixels inside a tile which has an active pixel, so they are not used here.
+// The pyramid only has one cell per tile (130K cells at 4K), so the cost is dominated by step 4
+// which is proportional to the number of the fully inactive tiles.
+//
+// fill() is not incremental. Each call scans the tile masks and rebuilds the pyramid from the
+// current pixel values, because the active tiles keep updating their pixels between progressive
+// passes and cached cells would be stale. The cost goes down as the tiles activate and fill()
+// returns right after the tile mask scan once every tile has active pixels.
+// Step 1 and 4 run in parallel by tbb.
+//
+// Pixel type T has to be a set of float channels (i.e. float, Vec2f, Vec3f, Vec4f).
+// The channel loop has a compile time trip count and the compiler vectorizes it.
+// The filled values are blends of the neighboring tiles, so this is only meant for the color
+// data. Non-color data (depth, sample count, weight, id, ...) should stay with TileExtrapolation's
+// nearest pixel copy: blending them is meaningless and an infinite depth turns into NaN.
+// Fb only applies this to the beauty buffers.
+//
+
+#include "ActivePixels.h"
+#include "PixelBuffer.h"
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <stdint.h>             // uint64_t
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+
+class TilePyramidFill
+{
+public:
+    // 1 pixel of each 2x2 pixels. Used to compute the cell value of the tile.
+    static constexpr uint64_t sSampleMask = 0x0055005500550055ULL;
+
+    // Fill all fully inactive tiles. return filled tile total.
+    template <typename T>
+    static unsigned fill(const ActivePixels &activePixels, PixelBuffer<T> &bufferTiled,
+                         const bool parallel = true)
+    {
+        if (!activePixels.getNumTiles()) return 0;
+        return fill(activePixels, bufferTiled,
+                    0, 0,
+                    static_cast<int>(activePixels.getAlignedWidth()) - 1,
+                    static_cast<int>(activePixels.getAlignedHeight()) - 1,
+                    parallel);
+    }
+
+    // Only uses the tiles inside the ROI and only fills the pixels inside the ROI.
+    // minSX, minSY, maxSX, maxSY are inclusive pixel positions. (same as Fb::extrapolateROITiles)
+    // return filled tile total.
+    template <typename T>
+    static unsigned fill(const ActivePixels &activePixels, PixelBuffer<T> &bufferTiled,
+                         const int minSX, const int minSY, const int maxSX, const int maxSY,
+                         const bool parallel = true);
+
+    // Push-pull of the width x height grid. Each cell has chanTotal floats.
+    // Invalid cells are filled and valid becomes all 1. Nothing happens if no cell is valid.
+    // Public for the test program.
+    static void pushPull(const int width, const int height, const int chanTotal,
+                         std::vector<float> &val, std::vector<char> &valid);
+
+private:
+    template <typename F>
+    static void loop(const bool parallel, const int total, F func)
+    {
+        if (parallel) {
+            tbb::parallel_for(0, total, func);
+        } else {
+            for (int i = 0; i < total; ++i) func(i);
+        }
+    }
+
+    // bilinear sample position of the pixel (0 ~ 7) inside the cell along one axis.
+    static void samplePos(const int cell, const int pix, const int cellTotal, int &c0, int &c1, float &t)
+    {
+        float pos = static_cast<float>(cell) + (static_cast<float>(pix) + 0.5f) * 0.125f - 0.5f;
+        if (pos < 0.0f) pos = 0.0f;
+        const float maxPos = static_cast<float>(cellTotal - 1);
+        if (pos > maxPos) pos = maxPos;
+        c0 = static_cast<int>(pos);
+        c1 = (c0 + 1 < cellTotal) ? c0 + 1 : c0;
+        t = pos - static_cast<float>(c0);
+    }
+};
+
+template <typename T>
+unsigned
+TilePyramidFill::fill(const ActivePixels &activePixels, PixelBuffer<T> &bufferTiled,
+                      const int minSX, const int minSY, const int maxSX, const int maxSY,
+                      const bool parallel)
+{
+    static_assert(sizeof(T) % sizeof(float) == 0, "T must be a set of float channels");
+    constexpr int chanTotal = static_cast<int>(sizeof(T) / sizeof(float));
+
+    const int numTilesX = static_cast<int>(activePixels.getNumTilesX());
+    const int minTileX = minSX >> 3;
+    const int minTileY = minSY >> 3;
+    const int gridW = (maxSX >> 3) - minTileX + 1;
+    const int gridH = (maxSY >> 3) - minTileY + 1;
+    if (gridW <= 0 || gridH <= 0) return 0;
+
+    auto tileIdOf = [&](const int cellId) {
+        return (minTileY + cellId / gridW) * numTilesX + minTileX + cellId % gridW;
+    };
+
+    std::vector<int> emptyCells;
+    for (int cellId = 0; cellId < gridW * gridH; ++cellId) {
+        if (!activePixels.getTileMask(static_cast<unsigned>(tileIdOf(cellId)))) emptyCells.push_back(cellId);
+    }
+    // nothing to fill or no source. The tile mask scan is the only cost after every tile becomes active.
+    if (emptyCells.empty() || static_cast<int>(emptyCells.size()) == gridW * gridH) return 0;
+
+    //
+    // cell value : mean of the sampled active pixels of the tile
+    //
+    std::vector<float> val(static_cast<size_t>(gridW) * gridH * chanTotal, 0.0f);
+    std::vector<char> valid(static_cast<size_t>(gridW) * gridH, 0);
+    loop(parallel, gridH, [&](const int gy) {
+            for (int cellId = gy * gridW; cellId < (gy + 1) * gridW; ++cellId) {
+                const unsigned tileId = static_cast<unsigned>(tileIdOf(cellId));
+                const uint64_t mask = activePixels.getTileMask(tileId);
+                if (!mask) continue;
+
+                uint64_t sampleMask = mask & sSampleMask;
+                if (!sampleMask) sampleMask = mask;
+                const float *tile = reinterpret_cast<const float *>(bufferTiled.getData() + (tileId << 6));
+                float *dst = &val[static_cast<size_t>(cellId) * chanTotal];
+                int sampleTotal = 0;
+                while (sampleMask) {
+                    const int pixId = __builtin_ctzll(sampleMask);
+                    sampleMask &= sampleMask - 1;
+                    for (int c = 0; c < chanTotal; ++c) dst[c] += tile[pixId * chanTotal + c];
+                    ++sampleTotal;
+                }
+                const float scale = 1.0f / static_cast<float>(sampleTotal);
+                for (int c = 0; c < chanTotal; ++c) dst[c] *= scale;
+                valid[cellId] = 1;
+            }
+        });
+
+    pushPull(gridW, gridH, chanTotal, val, valid);
+
+    //
+    // fill pixels of the fully inactive tiles by bilinear interpolation of the cells.
+    // Each row first interpolates the 3 cells (left, center, right) along y and then each pixel
+    // only needs one lerp along x.
+    //
+    loop(parallel, static_cast<int>(emptyCells.size()), [&](const int id) {
+            const int cellId = emptyCells[id];
+            const int gx = cellId % gridW;
+            const int gy = cellId / gridW;
+            const int baseSX = (minTileX + gx) << 3;
+            const int baseSY = (minTileY + gy) << 3;
+            const int minPX = std::max(minSX - baseSX, 0);
+            const int maxPX = std::min(maxSX - baseSX, 7);
+            const int minPY = std::max(minSY - baseSY, 0);
+            const int maxPY = std::min(maxSY - baseSY, 7);
+            float *tile = reinterpret_cast<float *>(bufferTiled.getData() + (tileIdOf(cellId) << 6));
+
+            int cols[3];        // left, center, right cells
+            for (int k = 0; k < 3; ++k) cols[k] = std::min(std::max(gx - 1 + k, 0), gridW - 1);
+            int xa[8], xb[8];   // index of cols
+            float tx[8];
+            for (int px = minPX; px <= maxPX; ++px) {
+                int x0, x1;
+                samplePos(gx, px, gridW, x0, x1, tx[px]);
+                xa[px] = x0 - (gx - 1);
+                xb[px] = x1 - (gx - 1);
+            }
+
+            for (int py = minPY; py <= maxPY; ++py) {
+                int y0, y1;
+                float ty;
+                samplePos(gy, py, gridH, y0, y1, ty);
+                const float *row0 = &val[static_cast<size_t>(y0) * gridW * chanTotal];
+                const float *row1 = &val[static_cast<size_t>(y1) * gridW * chanTotal];
+                float rowVal[3][chanTotal];
+                for (int k = 0; k < 3; ++k) {
+                    const float *v0 = row0 + cols[k] * chanTotal;
+                    const float *v1 = row1 + cols[k] * chanTotal;
+                    for (int c = 0; c < chanTotal; ++c) rowVal[k][c] = v0[c] + (v1[c] - v0[c]) * ty;
+                }
+
+                float *dst = tile + ((py << 3) + minPX) * chanTotal;
+                for (int px = minPX; px <= maxPX; ++px, dst += chanTotal) {
+                    const float *a = rowVal[xa[px]];
+                    const float *b = rowVal[xb[px]];
+                    for (int c = 0; c < chanTotal; ++c) dst[c] = a[c] + (b[c] - a[c]) * tx[px];
+                }
+            }
+        });
+
+    return static_cast<unsigned>(emptyCells.size());
+}
+
+} // namespace fb_util
+} // namespace scene_rdl2
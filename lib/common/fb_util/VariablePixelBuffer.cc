@@ -200,27 +200,27 @@ VariablePixelBuffer::gammaAndQuantizeTo8bit(const RenderBuffer& srcBuffer,
 }
 
 bool
-VariablePixelBuffer::packSparseTiles(uint8_t *dstPackedBuffer, const std::vector<Tile> &tiles) const
+VariablePixelBuffer::packSparseTiles(uint8_t *dstPackedBuffer, const std::vector<Tile> &tiles, bool parallel) const
 {
     switch (mFormat)
     {
     case RGB888:
-        return fb_util::packSparseTiles((ByteColor *)dstPackedBuffer, getRgb888Buffer(), tiles);
+        return fb_util::packSparseTiles((ByteColor *)dstPackedBuffer, getRgb888Buffer(), tiles, parallel);
 
     case RGBA8888:
-        return fb_util::packSparseTiles((ByteColor4 *)dstPackedBuffer, getRgba8888Buffer(), tiles);
+        return fb_util::packSparseTiles((ByteColor4 *)dstPackedBuffer, getRgba8888Buffer(), tiles, parallel);
 
     case FLOAT:
-        return fb_util::packSparseTiles((float *)dstPackedBuffer, getFloatBuffer(), tiles);
+        return fb_util::packSparseTiles((float *)dstPackedBuffer, getFloatBuffer(), tiles, parallel);
 
     case FLOAT2:
-        return fb_util::packSparseTiles((math::Vec2f *)dstPackedBuffer, getFloat2Buffer(), tiles);
+        return fb_util::packSparseTiles((math::Vec2f *)dstPackedBuffer, getFloat2Buffer(), tiles, parallel);
 
     case FLOAT3:
-        return fb_util::packSparseTiles((math::Vec3f *)dstPackedBuffer, getFloat3Buffer(), tiles);
+        return fb_util::packSparseTiles((math::Vec3f *)dstPackedBuffer, getFloat3Buffer(), tiles, parallel);
 
     case FLOAT4:
-        return fb_util::packSparseTiles((math::Vec4f *)dstPackedBuffer, getFloat4Buffer(), tiles);
+        return fb_util::packSparseTiles((math::Vec4f *)dstPackedBuffer, getFloat4Buffer(), tiles, parallel);
 
     case UNINITIALIZED:
         break;
@@ -233,27 +233,27 @@ VariablePixelBuffer::packSparseTiles(uint8_t *dstPackedBuffer, const std::vector
 }
 
 bool
-VariablePixelBuffer::unpackSparseTiles(const uint8_t *srcPackedData, const std::vector<Tile> &tiles)
+VariablePixelBuffer::unpackSparseTiles(const uint8_t *srcPackedData, const std::vector<Tile> &tiles, bool parallel)
 {
     switch (mFormat)
     {
     case RGB888:
-        return fb_util::unpackSparseTiles(&getRgb888Buffer(), (const ByteColor *)srcPackedData, tiles);
+        return fb_util::unpackSparseTiles(&getRgb888Buffer(), (const ByteColor *)srcPackedData, tiles, parallel);
 
     case RGBA8888:
-        return fb_util::unpackSparseTiles(&getRgba8888Buffer(), (const ByteColor4 *)srcPackedData, tiles);
+        return fb_util::unpackSparseTiles(&getRgba8888Buffer(), (const ByteColor4 *)srcPackedData, tiles, parallel);
 
     case FLOAT:
-        return fb_util::unpackSparseTiles(&getFloatBuffer(), (const float *)srcPackedData, tiles);
+        return fb_util::unpackSparseTiles(&getFloatBuffer(), (const float *)srcPackedData, tiles, parallel);
 
     case FLOAT2:
-        return fb_util::unpackSparseTiles(&getFloat2Buffer(), (const math::Vec2f *)srcPackedData, tiles);
+        return fb_util::unpackSparseTiles(&getFloat2Buffer(), (const math::Vec2f *)srcPackedData, tiles, parallel);
 
     case FLOAT3:
-        return fb_util::unpackSparseTiles(&getFloat3Buffer(), (const math::Vec3f *)srcPackedData, tiles);
+        return fb_util::unpackSparseTiles(&getFloat3Buffer(), (const math::Vec3f *)srcPackedData, tiles, parallel);
 
     case FLOAT4:
-        return fb_util::unpackSparseTiles(&getFloat4Buffer(), (const math::Vec4f *)srcPackedData, tiles);
+        return fb_util::unpackSparseTiles(&getFloat4Buffer(), (const math::Vec4f *)srcPackedData, tiles, parallel);
 
     case UNINITIALIZED:
         break;
@@ -265,6 +265,32 @@ VariablePixelBuffer::unpackSparseTiles(const uint8_t *srcPackedData, const std::
     return false;
 }
 
+bool
+VariablePixelBuffer::packSparseTiles(uint8_t *dstPackedBuffer, const unsigned *tileIds, size_t numTiles,
+                                     bool parallel) const
+{
+    if (mFormat == UNINITIALIZED || isVarianceFormat(mFormat) || numTiles == 0) {
+        return false;
+    }
+
+    MNRY_ASSERT(getWidth() % 8 == 0 && getHeight() % 8 == 0);
+    fb_util::packTiles(dstPackedBuffer, getData(), getSizeOfPixel() * 64, tileIds, numTiles, parallel);
+    return true;
+}
+
+bool
+VariablePixelBuffer::unpackSparseTiles(const uint8_t *srcPackedData, const unsigned *tileIds, size_t numTiles,
+                                       bool parallel)
+{
+    if (mFormat == UNINITIALIZED || isVarianceFormat(mFormat) || numTiles == 0 || getArea() == 0) {
+        return false;
+    }
+
+    MNRY_ASSERT(getWidth() % 8 == 0 && getHeight() % 8 == 0);
+    fb_util::unpackTiles(getData(), srcPackedData, getSizeOfPixel() * 64, tileIds, numTiles, parallel);
+    return true;
+}
+
 void
 VariablePixelBuffer::untile(const VariablePixelBuffer &tiledBuffer, const Tiler &tiler, bool parallel)
 {
@@ -60,6 +60,13 @@ public:
     // Returned in bytes.
     unsigned getSizeOfPixel() const;
 
+    // Statistics formats (*_VARIANCE and *_VARIANCE_FULLDUMP). Their pixels are
+    // RunningStatsLightWeight records and can't be packed as raw tile data.
+    static bool isVarianceFormat(Format format)
+    {
+        return (format >= RGB_VARIANCE && format <= FLOAT3_VARIANCE_FULLDUMP);
+    }
+
     void clear();
     void clear(float val);
 
@@ -76,9 +83,18 @@ public:
 
     void gammaAndQuantizeTo8bit(const RenderBuffer& srcBuffer, PixelBufferUtilOptions options, float exposure, float gamma);
 
-    bool packSparseTiles(uint8_t *dstPackedBuffer, const std::vector<Tile> &tiles) const;
+    bool packSparseTiles(uint8_t *dstPackedBuffer, const std::vector<Tile> &tiles, bool parallel = false) const;
+
+    bool unpackSparseTiles(const uint8_t *srcPackedData, const std::vector<Tile> &tiles, bool parallel = false);
+
+    // Same as above but tiles are specified by coarse tile id (= tiled offset of the tile / 64).
+    // Packed data size is numTiles * 64 * getSizeOfPixel() byte.
+    // Return false if the format is UNINITIALIZED or isVarianceFormat().
+    bool packSparseTiles(uint8_t *dstPackedBuffer, const unsigned *tileIds, size_t numTiles,
+                         bool parallel = false) const;
 
-    bool unpackSparseTiles(const uint8_t *srcPackedData, const std::vector<Tile> &tiles);
+    bool unpackSparseTiles(const uint8_t *srcPackedData, const unsigned *tileIds, size_t numTiles,
+                           bool parallel = false);
 
     // Takes the tiledBuffer and untiles it into "this".
     void untile(const VariablePixelBuffer &tiledBuffer, const Tiler &tiler, bool parallel);
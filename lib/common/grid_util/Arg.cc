@@ -170,7 +170,7 @@ Arg::msg(const std::string &msg) const
 
     if (mTlSvr) {
         // output to TlSvr if necessary
-        if (!mTlSvr->send(msg)) flag = false; // blocking function
+        if (!mTlSvr->send(msg)) flag = false; // non blocking, sent by the TlSvr::recvWait() thread
     }
 
     // output to msgHandler if necessary
@@ -6,7 +6,6 @@
 #include "DebugConsoleDriver.h"
 
 #include <iostream>
-#include <unistd.h>
 
 namespace scene_rdl2 {
 namespace grid_util {
@@ -52,6 +51,7 @@ DebugConsoleDriver::initialize(unsigned short port)
 DebugConsoleDriver::~DebugConsoleDriver()
 {
     mThreadShutdown = true; // This is the only place mThreadShutdown is set to true
+    mTlSvr.wakeup();        // wake up threadMain which is waiting for the next event
     if (mThread.joinable()) {
         mThread.join();
     }
@@ -60,7 +60,8 @@ DebugConsoleDriver::~DebugConsoleDriver()
 void
 DebugConsoleDriver::showString(const std::string &msg)
 {
-    mTlSvr.send(msg + ((msg.back() == '\n') ? "" : "\n"));
+    // non blocking. Safe to call from any thread (i.e. streaming stats from render threads)
+    mTlSvr.broadcast(msg + ((!msg.empty() && msg.back() == '\n') ? "" : "\n"));
 }
 
 //------------------------------------------------------------------------------------------
@@ -83,18 +84,16 @@ DebugConsoleDriver::threadMain(DebugConsoleDriver *driver)
             break;
         }
 
-        driver->mThreadState = ThreadState::BUSY;
+        // sleep until the next TlSvr event or wakeup() by the destructor
         std::string recvBuff;
-        int recvByte = driver->mTlSvr.recv(recvBuff, tlSvrMsgCallBackFunc, tlSvrMsgCallBackFunc);
+        int recvByte = driver->mTlSvr.recvWait(recvBuff, -1, tlSvrMsgCallBackFunc, tlSvrMsgCallBackFunc);
         if (recvByte == 0 || recvByte == -1) {
-            // empty or EOF
-            driver->mThreadState = ThreadState::IDLE;
-            usleep(10000); // 10000us = 10ms : wake up every 10ms and check TlSvr
-            
+            // empty or EOF : nothing to do
         } else if (recvByte < -1) { // error
             std::cerr << "telnet server failed\n";
             break;
         } else {
+            driver->mThreadState = ThreadState::BUSY;
             Arg arg(recvBuff, &(driver->mTlSvr)); // construct Arg by received command-line
             if (!driver->mParser.main(arg)) { // evaluate command-line by predefined command
                 std::cerr << ">> DebugConsoleDriver.cc eval() failed\n";
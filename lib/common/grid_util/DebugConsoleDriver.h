@@ -47,9 +47,9 @@ class DebugConsoleDriver
 // arras multi-machine configurations.)
 //
 // This class boots an independent thread in order to charge a debug console operation inside
-// the initialize(). If we don't have any incoming socket connection, this debug console threads
-// almost always asleep and minimizes the CPU overhead. This debug console thread is automatically
-// shut down inside the destructor.
+// the initialize(). This debug console thread sleeps inside TlSvr::recvWait() until the next
+// socket event and never wakes up while idle. Multiple telnet clients can connect at the same
+// time. This debug console thread is automatically shut down inside the destructor.
 //
 {
 public:
@@ -71,7 +71,7 @@ public:
 
     Parser & getRootParser() { return mParser; }
 
-    void showString(const std::string &msg); // msg goes to TlSvr if available
+    void showString(const std::string &msg); // msg goes to all TlSvr clients if available. non blocking
 
 private:
     static void threadMain(DebugConsoleDriver *driver);
@@ -21,11 +21,14 @@
 #include <scene_rdl2/common/fb_util/ActivePixels.h>
 #include <scene_rdl2/common/fb_util/FbTypes.h>
 #include <scene_rdl2/common/fb_util/TileExtrapolation.h>
+#include <scene_rdl2/common/fb_util/TilePyramidFill.h>
 #include <scene_rdl2/common/math/Viewport.h>
 #include <scene_rdl2/common/platform/Platform.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
 
 #include <tbb/parallel_for.h>
 
+#include <atomic>
 #include <cstring>              // memset()
 #include <memory>               // shared_ptr
 #include <mutex>
@@ -83,7 +86,10 @@ public:
         mWeightBufferCoarsePassPrecision(CoarsePassPrecision::F32),
         mWeightBufferFinePassPrecision(FinePassPrecision::F32),
         mRenderBufferOddStatus(false),
-        mRenderOutputStatus(false) {}
+        mRenderOutputStatus(false),
+        mEmptyTileFill(true),
+        mEmptyTileFillSec(0.0f),
+        mEmptyTileFillTileTotal(0) {}
 
     // so far copy constructor is not used. But we need definition for vector<Fb>.
     // We only need vector<Fb>.resize() at initialization stage and vector size never changed
@@ -93,7 +99,10 @@ public:
         mAlignedWidth(0), mAlignedHeight(0),
         mPixelInfoStatus(false), mHeatMapStatus(false), mWeightBufferStatus(false),
         mRenderBufferOddStatus(false),
-        mRenderOutputStatus(false) {}
+        mRenderOutputStatus(false),
+        mEmptyTileFill(true),
+        mEmptyTileFillSec(0.0f),
+        mEmptyTileFillTileTotal(0) {}
 
     // width, height are original size and not need to be tile aligned
     finline void init(const math::Viewport &rezedViewport);
@@ -221,6 +230,16 @@ public:
     finline void extrapolateRenderOutput(const std::string &aovName,
                                          const int minSX, const int minSY, const int maxSX, const int maxSY);
 
+    // Fully inactive tiles of the beauty buffers (RenderBuffer and RenderBufferOdd) are filled from
+    // the neighboring tiles by fb_util::TilePyramidFill after the tile extrapolation. (default is on)
+    // Other buffers (pixelInfo depth, heatMap, weight and renderOutput) are never blended and only
+    // use the nearest active pixel copy inside the tile. Filled tile total and time of the last
+    // extrapolateRenderBuffer*() call are kept for the statistics.
+    void setEmptyTileFill(const bool sw) { mEmptyTileFill = sw; }
+    bool getEmptyTileFill() const { return mEmptyTileFill; }
+    float getEmptyTileFillSec() const { return mEmptyTileFillSec.load(std::memory_order_relaxed); }
+    unsigned getEmptyTileFillTileTotal() const { return mEmptyTileFillTileTotal.load(std::memory_order_relaxed); }
+
     //------------------------------
 
     void untileBeauty(const bool isSrgb, const bool top2bottom, const math::Viewport *roi,
@@ -431,6 +450,13 @@ private:
     std::unordered_map<std::string, FbAovShPtr> mRenderOutput;
     mutable std::mutex mMutex;
 
+    //
+    // Cross tile extrapolation for fully inactive tiles
+    //
+    bool mEmptyTileFill;
+    mutable std::atomic<float> mEmptyTileFillSec;          // last beauty fill
+    mutable std::atomic<unsigned> mEmptyTileFillTileTotal; // last beauty fill
+
     //------------------------------
 
     // This is an array of activePixels which records snapshotDelta action in particular period
@@ -544,6 +570,9 @@ private:
     template <typename B>
     void extrapolateROITiles(const int minSX, const int minSY, const int maxSX, const int maxSY,
                              const ActivePixels &activePixels, B &bufferTiled) const;
+    template <typename B>
+    void extrapolateEmptyTiles(const int minSX, const int minSY, const int maxSX, const int maxSY,
+                               const ActivePixels &activePixels, B &bufferTiled) const;
     template <typename T>
     void extrapolateTile(const uint64_t mask, T *firstValOfTile) const;
     template <typename T>
@@ -851,12 +880,16 @@ finline void
 Fb::extrapolateRenderBuffer()
 {
     extrapolateAllTiles(mActivePixels, mRenderBufferTiled);
+    extrapolateEmptyTiles(0, 0,
+                          static_cast<int>(getAlignedWidth()) - 1, static_cast<int>(getAlignedHeight()) - 1,
+                          mActivePixels, mRenderBufferTiled);
 }
 
 finline void
 Fb::extrapolateRenderBuffer(const int minSX, const int minSY, const int maxSX, const int maxSY)
 {
     extrapolateROITiles(minSX, minSY, maxSX, maxSY, mActivePixels, mRenderBufferTiled);
+    extrapolateEmptyTiles(minSX, minSY, maxSX, maxSY, mActivePixels, mRenderBufferTiled);
 }
 
 finline void
@@ -906,6 +939,9 @@ Fb::extrapolateRenderBufferOdd()
 {
     if (!mRenderBufferOddStatus) return;
     extrapolateAllTiles(mActivePixelsRenderBufferOdd, mRenderBufferOddTiled);
+    extrapolateEmptyTiles(0, 0,
+                          static_cast<int>(getAlignedWidth()) - 1, static_cast<int>(getAlignedHeight()) - 1,
+                          mActivePixelsRenderBufferOdd, mRenderBufferOddTiled);
 }
 
 finline void
@@ -913,6 +949,7 @@ Fb::extrapolateRenderBufferOdd(const int minSX, const int minSY, const int maxSX
 {
     if (!mRenderBufferOddStatus) return;
     extrapolateROITiles(minSX, minSY, maxSX, maxSY, mActivePixelsRenderBufferOdd, mRenderBufferOddTiled);
+    extrapolateEmptyTiles(minSX, minSY, maxSX, maxSY, mActivePixelsRenderBufferOdd, mRenderBufferOddTiled);
 }
 
 finline void
@@ -1067,12 +1104,32 @@ Fb::extrapolateROITiles(const int minSX, const int minSY, const int maxSX, const
 }
 #endif // end !SINGLE_THREAD    
 
+template <typename B>
+void
+Fb::extrapolateEmptyTiles(const int minSX, const int minSY, const int maxSX, const int maxSY,
+                          const ActivePixels &activePixels, B &bufferTiled) const
+{
+    if (!mEmptyTileFill) return;
+
+    rec_time::RecTime recTime;
+    recTime.start();
+#   ifdef SINGLE_THREAD
+    constexpr bool parallel = false;
+#   else // else SINGLE_THREAD
+    constexpr bool parallel = true;
+#   endif // end !SINGLE_THREAD
+    unsigned filledTileTotal =
+        fb_util::TilePyramidFill::fill(activePixels, bufferTiled, minSX, minSY, maxSX, maxSY, parallel);
+    mEmptyTileFillSec.store(recTime.end(), std::memory_order_relaxed);
+    mEmptyTileFillTileTotal.store(filledTileTotal, std::memory_order_relaxed);
+}
+
 template <typename T>
 void
 Fb::extrapolateTile(const uint64_t mask, T *firstValOfTile) const
 {
     int extrapolationPixIdArray[sPixelsPerTile];
-    getTileExtrapolation().searchActiveNearestPixel(mask, extrapolationPixIdArray);
+    getTileExtrapolation().searchActiveNearestPixelCached(mask, extrapolationPixIdArray);
     for (int pixId = 0; pixId < static_cast<int>(sPixelsPerTile); ++pixId) {
         if (pixId != extrapolationPixIdArray[pixId]) {
             firstValOfTile[pixId] = firstValOfTile[extrapolationPixIdArray[pixId]];
@@ -1086,10 +1143,9 @@ Fb::extrapolateTile(const uint64_t mask, T *firstValOfTile,
                     const int minLocalX, const int minLocalY,
                     const int maxLocalX, const int maxLocalY) const
 {
+    // The cached result covers the whole tile and we only use the pixels inside the ROI.
     int extrapolationPixIdArray[sPixelsPerTile];
-    getTileExtrapolation().searchActiveNearestPixel(mask, extrapolationPixIdArray,
-                                                    minLocalX, maxLocalX + 1,
-                                                    minLocalY, maxLocalY + 1);
+    getTileExtrapolation().searchActiveNearestPixelCached(mask, extrapolationPixIdArray);
     for (int localY = minLocalY; localY <= maxLocalY; ++localY) {
         for (int localX = minLocalX; localX <= maxLocalX; ++localX) {
             int pixId = (localY << 3) + localX;
@@ -4,6 +4,7 @@
 //
 //
 #include "Fb.h"
+#include <scene_rdl2/common/rec_time/RecZone.h>
 #include <scene_rdl2/render/logging/logging.h>
 
 namespace scene_rdl2 {
@@ -134,6 +135,8 @@ Fb::accumulateAllFbs(const int numMachines,
 // This function is used on progmcrt_merge computation
 //
 {
+    REC_ZONE("Fb::accumulateAllFbs");
+
     auto bufferSetupFunc = [&](unsigned bufferId, const Fb &src) {
         switch (bufferId) {
         case 0 : {
@@ -154,6 +154,12 @@ public:
         mData.resize(data.size());
         for (size_t id = 0; id < data.size(); ++id) { mData[id] = data[id]; }
     }
+    LatencyItem(const Key key, const uint32_t time, const std::vector<uint32_t> &data) :
+        // Construct by recorded delta time. Used by offline analysis
+        mTime(time),
+        mKey(key),
+        mData(data)
+    {}
     LatencyItem(const LatencyItem &src) {
         mTime = src.mTime;
         mKey = src.mKey;
@@ -162,6 +168,8 @@ public:
     }
 
     uint32_t time() const { return mTime; }
+    Key key() const { return mKey; }
+    const std::vector<uint32_t> &data() const { return mData; }
 
     finline static uint64_t getCurrentMicroSec();
     finline static uint64_t getLatencyMicroSec(const uint64_t startTime);
@@ -173,6 +181,7 @@ public:
     std::string show(const std::string &hd, const uint64_t timeBase, const uint32_t prevTime,
                      const int allTimeLen = 6, const int deltaTimeLen = 5) const;
     static std::string timeStr(const uint64_t &time);
+    static std::string keyStr(const Key &key);
 
     // micro-sec to milli-sec conversion and output by string
     static std::string usec2msecStr(const uint64_t uSec, const int len = 6); // %len.2 (default %6.2)
@@ -182,8 +191,6 @@ protected:
     Key mKey;
 
     std::vector<uint32_t> mData;
-
-    static std::string keyStr(const Key &key);
 }; // LatencyItem
 
 finline uint64_t
@@ -282,10 +289,13 @@ public:
     LatencyLog() : mMachineId(0), mSnapshotId(0), mDataSize(0), mTimeBase(0) {}
 
     void setName(const std::string &name) { mName = name; }
+    const std::string &getName() const { return mName; }
     void setMachineId(const int id) { mMachineId = id; }
     uint32_t getMachineId() const { return mMachineId; }
     void setSnapshotId(const uint32_t id) { mSnapshotId = id; }
+    uint32_t getSnapshotId() const { return mSnapshotId; }
     void addDataSize(const size_t dataSize) { mDataSize += dataSize; }
+    size_t getDataSize() const { return mDataSize; }
 
     finline void start();
     finline void enq(const LatencyItem::Key key);
@@ -296,6 +306,12 @@ public:
     finline void decode(const void *data, const size_t dataSize);
 
     uint64_t getTimeBase() const { return mTimeBase; }
+    const std::vector<LatencyItem> &getLog() const { return mLog; }
+
+    // Rebuild log by recorded values instead of the current time. Used by offline analysis and testing
+    void setTimeBase(const uint64_t timeBase) { mTimeBase = timeBase; }
+    void enqRecorded(const LatencyItem::Key key, const uint32_t time,
+                     const std::vector<uint32_t> &data = {}) { mLog.emplace_back(key, time, data); }
 
     std::string show(const std::string &hd) const;
 
@@ -437,6 +453,8 @@ public:
     void decode(VContainerDeq &vContainerDeq);
     void decode(const void *data, const size_t dataSize);
 
+    const std::vector<std::vector<LatencyLog>> &getMachine() const { return mMachine; }
+
     std::string show(const std::string &hd) const;
 
 protected:
@@ -0,0 +1,596 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "LatencyLogCollector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+namespace {
+
+const std::string sRecordTag = "LatencyLogCollectorRecord";
+constexpr unsigned int sRecordVersion = 1;
+
+std::string
+signedUsec2msecStr(const int64_t uSec, const int len = 8)
+{
+    const float mSec = static_cast<float>(uSec) / 1000.0f;
+    std::ostringstream ostr;
+    ostr << std::setw(len) << std::fixed << std::setprecision(2) << mSec;
+    return ostr.str();
+}
+
+} // namespace
+
+void
+LatencyLogCollector::reset()
+{
+    mSenderLogs.clear();
+    mReceiverLogs.clear();
+    mRoundTripSamples.clear();
+
+    mSenderTable.clear();
+    mClockOffset.clear();
+    mClockOffsetByRoundTrip.clear();
+    mTimelines.clear();
+}
+
+void
+LatencyLogCollector::addSenderLog(const LatencyLog &log)
+{
+    mSenderLogs.push_back(log);
+}
+
+void
+LatencyLogCollector::addSenderLog(const void *data, const size_t dataSize)
+{
+    mSenderLogs.emplace_back();
+    mSenderLogs.back().decode(data, dataSize);
+}
+
+void
+LatencyLogCollector::addUpstream(const LatencyLogUpstream &upstream)
+{
+    for (const auto &machine : upstream.getMachine()) {
+        for (const auto &log : machine) {
+            addSenderLog(log);
+        }
+    }
+}
+
+void
+LatencyLogCollector::addReceiverLog(const LatencyLog &log)
+{
+    mReceiverLogs.push_back(log);
+}
+
+void
+LatencyLogCollector::addReceiverLog(const void *data, const size_t dataSize)
+{
+    mReceiverLogs.emplace_back();
+    mReceiverLogs.back().decode(data, dataSize);
+}
+
+void
+LatencyLogCollector::addRoundTripSample(const int machineId, const RoundTripSample &sample)
+{
+    mRoundTripSamples[machineId].push_back(sample);
+}
+
+void
+LatencyLogCollector::build(const int64_t minOneWayDelayMicroSec)
+{
+    mSenderTable.clear();
+    for (size_t logId = 0; logId < mSenderLogs.size(); ++logId) {
+        const LatencyLog &log = mSenderLogs[logId];
+        // The latest one wins if the same machineId/snapshotId is added more than once.
+        mSenderTable[SenderKey(static_cast<int>(log.getMachineId()), log.getSnapshotId())] = logId;
+    }
+
+    estimateClockOffsets(minOneWayDelayMicroSec);
+
+    mTimelines.clear();
+    for (size_t logId = 0; logId < mReceiverLogs.size(); ++logId) {
+        buildTimeline(logId);
+    }
+}
+
+bool
+LatencyLogCollector::getClockOffset(const int machineId, int64_t &offsetMicroSec) const
+{
+    auto itr = mClockOffset.find(machineId);
+    if (itr == mClockOffset.end()) return false;
+    offsetMicroSec = itr->second;
+    return true;
+}
+
+bool
+LatencyLogCollector::getPercentile(const Metric metric, const float percentile, int64_t &microSec) const
+{
+    std::vector<int64_t> samples = collectMetric(metric);
+    if (samples.empty()) return false;
+
+    std::sort(samples.begin(), samples.end());
+    // nearest-rank method
+    const float p = std::max(0.0f, std::min(100.0f, percentile));
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0f * static_cast<float>(samples.size())));
+    rank = std::max(rank, static_cast<size_t>(1));
+    microSec = samples[rank - 1];
+    return true;
+}
+
+void
+LatencyLogCollector::encode(VContainerEnq &vContainerEnq) const
+{
+    vContainerEnq.enqString(sRecordTag);
+    vContainerEnq.enqVLUInt(sRecordVersion);
+
+    vContainerEnq.enqVLSizeT(mSenderLogs.size());
+    for (const auto &log : mSenderLogs) {
+        log.encode(vContainerEnq);
+    }
+    vContainerEnq.enqVLSizeT(mReceiverLogs.size());
+    for (const auto &log : mReceiverLogs) {
+        log.encode(vContainerEnq);
+    }
+
+    vContainerEnq.enqVLSizeT(mRoundTripSamples.size());
+    for (const auto &itr : mRoundTripSamples) {
+        vContainerEnq.enqVLInt(itr.first);
+        vContainerEnq.enqVLSizeT(itr.second.size());
+        for (const auto &sample : itr.second) {
+            vContainerEnq.enqMask64(sample.mT0);
+            vContainerEnq.enqMask64(sample.mT1);
+            vContainerEnq.enqMask64(sample.mT2);
+            vContainerEnq.enqMask64(sample.mT3);
+        }
+    }
+}
+
+bool
+LatencyLogCollector::decode(VContainerDeq &vContainerDeq)
+{
+    reset();
+
+    std::string tag;
+    vContainerDeq.deqString(tag);
+    if (tag != sRecordTag) return false;
+    unsigned int version;
+    vContainerDeq.deqVLUInt(version);
+    if (version != sRecordVersion) return false;
+
+    size_t total;
+    vContainerDeq.deqVLSizeT(total);
+    mSenderLogs.resize(total);
+    for (auto &log : mSenderLogs) {
+        log.decode(vContainerDeq);
+    }
+    vContainerDeq.deqVLSizeT(total);
+    mReceiverLogs.resize(total);
+    for (auto &log : mReceiverLogs) {
+        log.decode(vContainerDeq);
+    }
+
+    size_t machineTotal;
+    vContainerDeq.deqVLSizeT(machineTotal);
+    for (size_t i = 0; i < machineTotal; ++i) {
+        int machineId;
+        vContainerDeq.deqVLInt(machineId);
+        vContainerDeq.deqVLSizeT(total);
+        std::vector<RoundTripSample> &samples = mRoundTripSamples[machineId];
+        samples.resize(total);
+        for (auto &sample : samples) {
+            vContainerDeq.deqMask64(sample.mT0);
+            vContainerDeq.deqMask64(sample.mT1);
+            vContainerDeq.deqMask64(sample.mT2);
+            vContainerDeq.deqMask64(sample.mT3);
+        }
+    }
+    return true;
+}
+
+bool
+LatencyLogCollector::saveRecord(const std::string &filename) const
+{
+    std::string buff;
+    VContainerEnq vContainerEnq(&buff);
+    encode(vContainerEnq);
+    const size_t dataSize = vContainerEnq.finalize();
+
+    std::ofstream ofs(filename, std::ios::trunc | std::ios::binary);
+    if (!ofs) return false;
+    ofs.write(buff.data(), dataSize);
+    return static_cast<bool>(ofs);
+}
+
+bool
+LatencyLogCollector::loadRecord(const std::string &filename)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs) return false;
+    const std::string buff((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    try {
+        VContainerDeq vContainerDeq(buff.data(), buff.size());
+        return decode(vContainerDeq);
+    }
+    catch (...) {
+        reset();
+        return false;
+    }
+}
+
+std::string
+LatencyLogCollector::showClockOffset(const std::string &hd) const
+{
+    std::ostringstream ostr;
+    ostr << hd << "clockOffset (total:" << mClockOffset.size() << ") {\n";
+    for (const auto &itr : mClockOffset) {
+        auto byRoundTrip = mClockOffsetByRoundTrip.find(itr.first);
+        const bool roundTrip = (byRoundTrip != mClockOffsetByRoundTrip.end()) && byRoundTrip->second;
+        ostr << hd << "  machineId:" << std::setw(3) << itr.first
+             << " offset:" << signedUsec2msecStr(itr.second) << "ms"
+             << " (" << (roundTrip ? "round-trip" : "one-way") << ")\n";
+    }
+    ostr << hd << "}";
+    return ostr.str();
+}
+
+std::string
+LatencyLogCollector::showTimeline(const std::string &hd, const size_t frameId) const
+{
+    if (frameId >= mTimelines.size()) return hd + "frameId out of range";
+
+    const FrameTimeline &timeline = mTimelines[frameId];
+    const uint64_t origin = timeline.mStart;
+
+    std::ostringstream ostr;
+    ostr << hd << "frame:" << frameId << " latency:" << signedUsec2msecStr(timeline.latency()) << "ms {\n";
+    ostr << hd << "  contributions (total:" << timeline.mContributions.size() << ") {\n";
+    for (size_t cId = 0; cId < timeline.mContributions.size(); ++cId) {
+        const Contribution &c = timeline.mContributions[cId];
+        ostr << hd << "    "
+             << ((static_cast<int>(cId) == timeline.mCriticalContributionId) ? '*' : ' ')
+             << "mId:" << std::setw(3) << c.mMachineId << " snapshotId:" << std::setw(5) << c.mSnapshotId;
+        if (c.mHasSenderLog) {
+            ostr << " start:" << signedUsec2msecStr(static_cast<int64_t>(c.mSenderStart - origin))
+                 << " send:" << signedUsec2msecStr(static_cast<int64_t>(c.mSenderSend - origin));
+        } else {
+            ostr << " (no sender log)";
+        }
+        ostr << " recvStart:" << signedUsec2msecStr(static_cast<int64_t>(c.mRecvStart - origin))
+             << " recvEnd:" << signedUsec2msecStr(static_cast<int64_t>(c.mRecvEnd - origin)) << " ms\n";
+    }
+    ostr << hd << "  }\n";
+    ostr << hd << "  criticalPath (total:" << timeline.mCriticalPath.size() << ") {\n";
+    for (const auto &segment : timeline.mCriticalPath) {
+        ostr << hd << "    " << signedUsec2msecStr(static_cast<int64_t>(segment.mStart - origin))
+             << "ms +" << signedUsec2msecStr(segment.duration()) << "ms ";
+        if (segment.mMachineId >= 0) ostr << "mId:" << segment.mMachineId << ' ';
+        ostr << segment.mLabel << '\n';
+    }
+    ostr << hd << "  }\n";
+    ostr << hd << "}";
+    return ostr.str();
+}
+
+std::string
+LatencyLogCollector::showCriticalPath(const std::string &hd) const
+//
+// Summarize critical path segments over all the frames by label
+//
+{
+    struct Total {
+        int64_t mSum = 0;
+        size_t mCount = 0;
+    };
+    std::vector<std::string> labels; // keep first appearance order
+    std::map<std::string, Total> totals;
+    int64_t latencySum = 0;
+    for (const auto &timeline : mTimelines) {
+        latencySum += timeline.latency();
+        for (const auto &segment : timeline.mCriticalPath) {
+            auto itr = totals.find(segment.mLabel);
+            if (itr == totals.end()) {
+                labels.push_back(segment.mLabel);
+                itr = totals.emplace(segment.mLabel, Total()).first;
+            }
+            itr->second.mSum += segment.duration();
+            itr->second.mCount++;
+        }
+    }
+
+    size_t labelLen = 0;
+    for (const auto &label : labels) labelLen = std::max(labelLen, label.size());
+
+    std::ostringstream ostr;
+    ostr << hd << "criticalPath (frameTotal:" << mTimelines.size() << ") {\n";
+    for (const auto &label : labels) {
+        const Total &total = totals[label];
+        const int64_t avg = total.mSum / static_cast<int64_t>(total.mCount);
+        const float pct = (latencySum > 0) ?
+            static_cast<float>(total.mSum) / static_cast<float>(latencySum) * 100.0f : 0.0f;
+        ostr << hd << "  " << std::setw(labelLen) << std::left << label << std::right
+             << " avg:" << signedUsec2msecStr(avg) << "ms"
+             << std::setw(7) << std::fixed << std::setprecision(2) << pct << " %"
+             << " (count:" << total.mCount << ")\n";
+    }
+    ostr << hd << "}";
+    return ostr.str();
+}
+
+std::string
+LatencyLogCollector::showPercentile(const std::string &hd) const
+{
+    static const Metric metrics[] = {
+        Metric::FRAME_LATENCY, Metric::SENDER_COMPUTE, Metric::NETWORK, Metric::RECEIVER_MERGE
+    };
+    static const float percentiles[] = {50.0f, 90.0f, 99.0f, 100.0f};
+
+    std::ostringstream ostr;
+    ostr << hd << "percentile (ms) {\n";
+    for (const Metric metric : metrics) {
+        const size_t total = collectMetric(metric).size();
+        ostr << hd << "  " << std::setw(14) << std::left << metricStr(metric) << std::right;
+        if (!total) {
+            ostr << " no sample\n";
+            continue;
+        }
+        for (const float p : percentiles) {
+            int64_t v = 0;
+            getPercentile(metric, p, v);
+            ostr << ((p < 100.0f) ? " p" : " max") ;
+            if (p < 100.0f) ostr << static_cast<int>(p);
+            ostr << ':' << signedUsec2msecStr(v);
+        }
+        ostr << " (sample:" << total << ")\n";
+    }
+    ostr << hd << "}";
+    return ostr.str();
+}
+
+//------------------------------------------------------------------------------------------
+
+void
+LatencyLogCollector::estimateClockOffsets(const int64_t minOneWayDelayMicroSec)
+{
+    mClockOffset.clear();
+    mClockOffsetByRoundTrip.clear();
+
+    // round-trip samples first : pick minimum delay sample
+    for (const auto &itr : mRoundTripSamples) {
+        if (itr.second.empty()) continue;
+        const RoundTripSample *best = &itr.second[0];
+        for (const auto &sample : itr.second) {
+            if (sample.delay() < best->delay()) best = &sample;
+        }
+        mClockOffset[itr.first] = best->offset();
+        mClockOffsetByRoundTrip[itr.first] = true;
+    }
+
+    // one-way SEND_MSG -> RECV_PROGRESSIVEFRAME_START pairs for the rest
+    std::map<int, int64_t> minOneWay;
+    for (const auto &receiverLog : mReceiverLogs) {
+        const uint64_t timeBase = receiverLog.getTimeBase();
+        for (const auto &item : receiverLog.getLog()) {
+            if (item.key() != Key::RECV_PROGRESSIVEFRAME_START || item.data().size() < 2) continue;
+            const int machineId = static_cast<int>(item.data()[0]);
+            if (mClockOffset.count(machineId)) continue; // already estimated by round-trip
+
+            const LatencyLog *senderLog = findSenderLog(machineId, item.data()[1]);
+            uint64_t sendTime;
+            if (!senderLog || !findItemTime(*senderLog, Key::SEND_MSG, sendTime)) continue;
+
+            const int64_t delta = static_cast<int64_t>(timeBase + item.time() - sendTime);
+            auto minItr = minOneWay.find(machineId);
+            if (minItr == minOneWay.end()) {
+                minOneWay[machineId] = delta;
+            } else {
+                minItr->second = std::min(minItr->second, delta);
+            }
+        }
+    }
+    for (const auto &itr : minOneWay) {
+        mClockOffset[itr.first] = itr.second - minOneWayDelayMicroSec;
+        mClockOffsetByRoundTrip[itr.first] = false;
+    }
+}
+
+void
+LatencyLogCollector::buildTimeline(const size_t receiverLogId)
+{
+    const LatencyLog &receiverLog = mReceiverLogs[receiverLogId];
+    const std::vector<LatencyItem> &items = receiverLog.getLog();
+    if (items.empty()) return;
+    const uint64_t timeBase = receiverLog.getTimeBase();
+
+    FrameTimeline timeline;
+    timeline.mReceiverLogId = receiverLogId;
+    timeline.mCriticalContributionId = -1;
+
+    for (size_t itemId = 0; itemId < items.size(); ++itemId) {
+        const LatencyItem &item = items[itemId];
+        if (item.key() != Key::RECV_PROGRESSIVEFRAME_START || item.data().size() < 2) continue;
+
+        Contribution c;
+        c.mMachineId = static_cast<int>(item.data()[0]);
+        c.mSnapshotId = item.data()[1];
+        c.mRecvStart = timeBase + item.time();
+        c.mRecvEnd = c.mRecvStart;
+        for (size_t endId = itemId + 1; endId < items.size(); ++endId) {
+            if (items[endId].key() == Key::RECV_PROGRESSIVEFRAME_START) break;
+            if (items[endId].key() == Key::RECV_PROGRESSIVEFRAME_END) {
+                c.mRecvEnd = timeBase + items[endId].time();
+                break;
+            }
+        }
+
+        c.mHasSenderLog = false;
+        c.mSenderStart = c.mSenderSend = c.mRecvStart;
+        const LatencyLog *senderLog = findSenderLog(c.mMachineId, c.mSnapshotId);
+        if (senderLog && !senderLog->getLog().empty()) {
+            const int64_t offset = clockOffset(c.mMachineId);
+            const uint64_t senderBase = senderLog->getTimeBase() + static_cast<uint64_t>(offset);
+            uint64_t sendTime;
+            if (!findItemTime(*senderLog, Key::SEND_MSG, sendTime)) {
+                sendTime = senderLog->getTimeBase() + senderLog->getLog().back().time();
+            }
+            c.mHasSenderLog = true;
+            c.mSenderStart = senderBase + senderLog->getLog().front().time();
+            c.mSenderSend = sendTime + static_cast<uint64_t>(offset);
+        }
+        timeline.mContributions.push_back(c);
+    }
+
+    uint64_t endTime;
+    if (!findItemTime(receiverLog, Key::MERGE_SEND_MSG, endTime)) {
+        endTime = timeBase + items.back().time();
+    }
+    timeline.mEnd = endTime;
+    timeline.mStart = timeBase + items.front().time();
+
+    uint64_t latestRecvEnd = 0;
+    for (size_t cId = 0; cId < timeline.mContributions.size(); ++cId) {
+        const Contribution &c = timeline.mContributions[cId];
+        timeline.mStart = std::min(timeline.mStart, c.mSenderStart);
+        if (timeline.mCriticalContributionId < 0 || latestRecvEnd < c.mRecvEnd) {
+            latestRecvEnd = c.mRecvEnd;
+            timeline.mCriticalContributionId = static_cast<int>(cId);
+        }
+    }
+
+    buildCriticalPath(timeline);
+    mTimelines.push_back(std::move(timeline));
+}
+
+void
+LatencyLogCollector::buildCriticalPath(FrameTimeline &timeline) const
+//
+// critical path = sender steps of the latest arrived contribution -> network -> receive ->
+//                 receiver steps after that receive until MERGE_SEND_MSG
+//
+{
+    const LatencyLog &receiverLog = mReceiverLogs[timeline.mReceiverLogId];
+    const uint64_t receiverBase = receiverLog.getTimeBase();
+    auto push = [&](std::string &&label, const int machineId, const uint64_t start, const uint64_t end) {
+        timeline.mCriticalPath.push_back(Segment {std::move(label), machineId, start, end});
+    };
+
+    uint64_t recvEnd = timeline.mStart;
+    if (timeline.mCriticalContributionId >= 0) {
+        const Contribution &c = timeline.mContributions[timeline.mCriticalContributionId];
+        if (c.mHasSenderLog) {
+            const LatencyLog *senderLog = findSenderLog(c.mMachineId, c.mSnapshotId);
+            const uint64_t senderBase = senderLog->getTimeBase() + static_cast<uint64_t>(clockOffset(c.mMachineId));
+            const std::vector<LatencyItem> &items = senderLog->getLog();
+            for (size_t i = 1; i < items.size(); ++i) {
+                push("mcrt:" + LatencyItem::keyStr(items[i - 1].key()) + "->" + LatencyItem::keyStr(items[i].key()),
+                     c.mMachineId, senderBase + items[i - 1].time(), senderBase + items[i].time());
+                if (items[i].key() == Key::SEND_MSG) break;
+            }
+            push("network", c.mMachineId, c.mSenderSend, c.mRecvStart);
+        }
+        push("merge:RECV_PROGRESSIVEFRAME", -1, c.mRecvStart, c.mRecvEnd);
+        recvEnd = c.mRecvEnd;
+    }
+
+    // receiver steps after the critical receive
+    std::string prevLabel = "RECV_PROGRESSIVEFRAME_END";
+    uint64_t prevTime = recvEnd;
+    for (const auto &item : receiverLog.getLog()) {
+        const uint64_t time = receiverBase + item.time();
+        if (time < recvEnd || time > timeline.mEnd) continue;
+        if (item.key() == Key::RECV_PROGRESSIVEFRAME_START || item.key() == Key::RECV_PROGRESSIVEFRAME_END) {
+            continue;
+        }
+        push("merge:" + prevLabel + "->" + LatencyItem::keyStr(item.key()), -1, prevTime, time);
+        prevLabel = LatencyItem::keyStr(item.key());
+        prevTime = time;
+        if (item.key() == Key::MERGE_SEND_MSG) break;
+    }
+}
+
+const LatencyLog *
+LatencyLogCollector::findSenderLog(const int machineId, const uint32_t snapshotId) const
+{
+    auto itr = mSenderTable.find(SenderKey(machineId, snapshotId));
+    if (itr == mSenderTable.end()) return nullptr;
+    return &mSenderLogs[itr->second];
+}
+
+int64_t
+LatencyLogCollector::clockOffset(const int machineId) const
+{
+    int64_t offset = 0;
+    getClockOffset(machineId, offset);
+    return offset;
+}
+
+// static function
+bool
+LatencyLogCollector::findItemTime(const LatencyLog &log, const Key key, uint64_t &time)
+{
+    for (const auto &item : log.getLog()) {
+        if (item.key() == key) {
+            time = log.getTimeBase() + item.time();
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<int64_t>
+LatencyLogCollector::collectMetric(const Metric metric) const
+{
+    std::vector<int64_t> samples;
+    for (const auto &timeline : mTimelines) {
+        switch (metric) {
+        case Metric::FRAME_LATENCY :
+            samples.push_back(timeline.latency());
+            break;
+        case Metric::SENDER_COMPUTE :
+            for (const auto &c : timeline.mContributions) {
+                if (c.mHasSenderLog) samples.push_back(static_cast<int64_t>(c.mSenderSend - c.mSenderStart));
+            }
+            break;
+        case Metric::NETWORK :
+            for (const auto &c : timeline.mContributions) {
+                if (c.mHasSenderLog) samples.push_back(static_cast<int64_t>(c.mRecvStart - c.mSenderSend));
+            }
+            break;
+        case Metric::RECEIVER_MERGE :
+            if (timeline.mCriticalContributionId >= 0) {
+                const Contribution &c = timeline.mContributions[timeline.mCriticalContributionId];
+                samples.push_back(static_cast<int64_t>(timeline.mEnd - c.mRecvEnd));
+            }
+            break;
+        }
+    }
+    return samples;
+}
+
+// static function
+const char *
+LatencyLogCollector::metricStr(const Metric metric)
+{
+    switch (metric) {
+    case Metric::FRAME_LATENCY : return "frameLatency";
+    case Metric::SENDER_COMPUTE : return "senderCompute";
+    case Metric::NETWORK : return "network";
+    case Metric::RECEIVER_MERGE : return "receiverMerge";
+    }
+    return "?";
+}
+
+} // namespace grid_util
+} // namespace scene_rdl2
+
@@ -0,0 +1,153 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Cluster-wide latency analysis by LatencyLog --
+//
+// LatencyLogCollector gathers LatencyLog records from N sender (mcrt computation) machines and
+// the receiver (mcrt_merge computation), aligns all of them onto the receiver clock and builds
+// a merged timeline for every merged frame.
+//
+// Each machine stamps LatencyLog by its own gettimeofday clock. The clock offset of each sender
+// (receiver clock = sender clock + offset) is estimated by
+//   a) round-trip samples (NTP style, t0/t3 by sender clock, t1/t2 by receiver clock) if they are
+//      provided. The sample which has the minimum round-trip delay is used.
+//   b) otherwise by the one-way SEND_MSG -> RECV_PROGRESSIVEFRAME_START pairs found inside the logs.
+//      The minimum observed (recv - send) minus the user defined minimum one-way network delay is used.
+// LatencyClockOffset which is set by hand on each machine is already included in the recorded time.
+//
+// All the input logs can be saved into a record file and loaded later, so analysis can be done
+// offline against recorded logs.
+//
+// Typical usage
+//   LatencyLogCollector collector;
+//   collector.addSenderLog(..);   // for each mcrt LatencyLog
+//   collector.addReceiverLog(..); // for each mcrt_merge LatencyLog
+//   collector.build();
+//   std::cerr << collector.showCriticalPath("") << '\n' << collector.showPercentile("") << '\n';
+//
+
+#include "LatencyLog.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+class LatencyLogCollector
+{
+public:
+    using VContainerDeq = rdl2::ValueContainerDeq;
+    using VContainerEnq = rdl2::ValueContainerEnq;
+    using Key = LatencyItem::Key;
+
+    struct RoundTripSample {
+        uint64_t mT0;           // sender clock   : request send
+        uint64_t mT1;           // receiver clock : request receive
+        uint64_t mT2;           // receiver clock : reply send
+        uint64_t mT3;           // sender clock   : reply receive
+
+        int64_t offset() const {
+            return ((static_cast<int64_t>(mT1 - mT0)) + (static_cast<int64_t>(mT2 - mT3))) / 2;
+        }
+        int64_t delay() const {
+            return static_cast<int64_t>(mT3 - mT0) - static_cast<int64_t>(mT2 - mT1);
+        }
+    };
+
+    struct Segment {
+        std::string mLabel;
+        int mMachineId;         // -1 : receiver
+        uint64_t mStart;        // usec by receiver clock
+        uint64_t mEnd;          // usec by receiver clock
+
+        int64_t duration() const { return static_cast<int64_t>(mEnd - mStart); }
+    };
+
+    struct Contribution {
+        int mMachineId;
+        uint32_t mSnapshotId;
+        bool mHasSenderLog;
+        uint64_t mSenderStart;  // receiver clock
+        uint64_t mSenderSend;   // receiver clock
+        uint64_t mRecvStart;
+        uint64_t mRecvEnd;
+    };
+
+    struct FrameTimeline {
+        size_t mReceiverLogId;
+        uint64_t mStart;        // earliest sender START by receiver clock
+        uint64_t mEnd;          // receiver MERGE_SEND_MSG (or last record)
+        std::vector<Contribution> mContributions;
+        int mCriticalContributionId; // -1 : no contribution
+        std::vector<Segment> mCriticalPath;
+
+        int64_t latency() const { return static_cast<int64_t>(mEnd - mStart); }
+    };
+
+    void reset();
+
+    void addSenderLog(const LatencyLog &log);
+    void addSenderLog(const void *data, const size_t dataSize); // encoded LatencyLog
+    void addUpstream(const LatencyLogUpstream &upstream);       // all sender logs inside upstream
+    void addReceiverLog(const LatencyLog &log);
+    void addReceiverLog(const void *data, const size_t dataSize); // encoded LatencyLog
+    void addRoundTripSample(const int machineId, const RoundTripSample &sample);
+
+    // Estimates clock offsets and builds all frame timelines.
+    void build(const int64_t minOneWayDelayMicroSec = 0);
+
+    bool getClockOffset(const int machineId, int64_t &offsetMicroSec) const;
+    const std::vector<FrameTimeline> &getTimelines() const { return mTimelines; }
+
+    // percentile : 0.0 ~ 100.0. Returns false if there is no sample.
+    enum class Metric : int { FRAME_LATENCY, SENDER_COMPUTE, NETWORK, RECEIVER_MERGE };
+    bool getPercentile(const Metric metric, const float percentile, int64_t &microSec) const;
+
+    // Record file for offline analysis
+    void encode(VContainerEnq &vContainerEnq) const;
+    bool decode(VContainerDeq &vContainerDeq); // return false if data is not a record
+    bool saveRecord(const std::string &filename) const;
+    bool loadRecord(const std::string &filename);
+
+    std::string showClockOffset(const std::string &hd) const;
+    std::string showTimeline(const std::string &hd, const size_t frameId) const;
+    std::string showCriticalPath(const std::string &hd) const;
+    std::string showPercentile(const std::string &hd) const;
+
+protected:
+    using SenderKey = std::pair<int, uint32_t>; // machineId, snapshotId
+
+    std::vector<LatencyLog> mSenderLogs;
+    std::vector<LatencyLog> mReceiverLogs;
+    std::map<int, std::vector<RoundTripSample>> mRoundTripSamples;
+
+    std::map<SenderKey, size_t> mSenderTable; // sender log index
+    std::map<int, int64_t> mClockOffset;      // machineId -> offset usec
+    std::map<int, bool> mClockOffsetByRoundTrip;
+    std::vector<FrameTimeline> mTimelines;
+
+    //------------------------------
+
+    void estimateClockOffsets(const int64_t minOneWayDelayMicroSec);
+    void buildTimeline(const size_t receiverLogId);
+    void buildCriticalPath(FrameTimeline &timeline) const;
+
+    const LatencyLog *findSenderLog(const int machineId, const uint32_t snapshotId) const;
+    int64_t clockOffset(const int machineId) const;
+
+    static bool findItemTime(const LatencyLog &log, const Key key, uint64_t &time);
+    std::vector<int64_t> collectMetric(const Metric metric) const;
+    static const char *metricStr(const Metric metric);
+}; // LatencyLogCollector
+
+} // namespace grid_util
+} // namespace scene_rdl2
+
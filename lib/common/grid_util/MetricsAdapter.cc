@@ -0,0 +1,114 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "MetricsAdapter.h"
+#include "Fb.h"
+#include "LatencyLog.h"
+#include "RenderPrepStats.h"
+
+#include <scene_rdl2/common/rec_time/RecTimeLap.h>
+#include <scene_rdl2/render/util/StrUtil.h>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+namespace {
+
+std::string
+addLabel(const std::string &labels, const std::string &key, const std::string &value)
+{
+    std::string label = key + "=\"";
+    for (char c : value) {
+        if (c == '\\') label += "\\\\";
+        else if (c == '"') label += "\\\"";
+        else if (c == '\n') label += "\\n";
+        else label += c;
+    }
+    label += '"';
+    return (labels.empty()) ? label : str_util::stringCat(labels, ",", label);
+}
+
+} // namespace
+
+RenderPrepStatsMetrics::RenderPrepStatsMetrics(MetricsRegistry &registry, const std::string &prefix,
+                                               const std::string &labels) :
+    mStage(registry.gauge(prefix + "_render_prep_stage", "RenderPrepStats stage", labels)),
+    mSteps(registry.gauge(prefix + "_render_prep_steps", "renderPrep current steps", labels)),
+    mStepsTotal(registry.gauge(prefix + "_render_prep_steps_total", "renderPrep estimated total steps",
+                               labels))
+{
+}
+
+void
+RenderPrepStatsMetrics::update(const RenderPrepStats &stats)
+{
+    mStage.set(static_cast<double>(static_cast<unsigned>(stats.stage())));
+    mSteps.set(static_cast<double>(stats.getCurrSteps()));
+    mStepsTotal.set(static_cast<double>(stats.getTotalSteps()));
+}
+
+//------------------------------------------------------------------------------------------
+
+FbMetrics::FbMetrics(MetricsRegistry &registry, const std::string &prefix, const std::string &labels) :
+    mActivePixels(registry.gauge(prefix + "_fb_active_pixels", "Fb active pixel total", labels))
+{
+}
+
+void
+FbMetrics::update(const Fb &fb)
+{
+    mActivePixels.set(static_cast<double>(fb.getActivePixelsTotal()));
+}
+
+//------------------------------------------------------------------------------------------
+
+void
+RecTimeLapMetrics::update(rec_time::RecTimeLap &recTimeLap)
+{
+    if (recTimeLap.isReset()) return; // no interval yet
+
+    for (size_t id = mSections.size(); id < recTimeLap.getSectionTotal(); ++id) {
+        mSections.push_back(&mRegistry.gauge(mName, "RecTimeLap section last interval (millisec)",
+                                             addLabel(mLabels, "section",
+                                                      recTimeLap.getSection(id).getName())));
+    }
+    for (size_t id = 0; id < mSections.size(); ++id) {
+        mSections[id]->set(recTimeLap.getLastMsec(id));
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+LatencyLogMetrics::LatencyLogMetrics(MetricsRegistry &registry, const std::string &prefix,
+                                     const std::vector<double> &bounds, const std::string &labels) :
+    mLatency(registry.histogram(prefix + "_latency_seconds", "LatencyLog latency", bounds, labels)),
+    mBytes(registry.counter(prefix + "_latency_log_bytes_total", "LatencyLog data size", labels))
+{
+}
+
+void
+LatencyLogMetrics::observe(const LatencyLog &latencyLog)
+{
+    if (latencyLog.getLog().empty()) return;
+
+    // item time is microsec from LatencyLog::start()
+    mLatency.observe(static_cast<double>(latencyLog.getLog().back().time()) / 1000000.0);
+    mBytes.inc(latencyLog.getDataSize());
+}
+
+//------------------------------------------------------------------------------------------
+
+MemPoolMetrics::MemPoolMetrics(MetricsRegistry &registry, const std::string &prefix,
+                               const std::string &labels) :
+    mEntries(registry.gauge(prefix + "_mempool_entries", "MemPool allocated entries", labels)),
+    mBlockBytes(registry.gauge(prefix + "_mempool_block_bytes", "MemPool block manager memory usage",
+                               labels)),
+    mFailedAllocs(registry.gauge(prefix + "_mempool_failed_allocs", "MemPool failed entry allocations",
+                                 labels))
+{
+}
+
+} // namespace grid_util
+} // namespace scene_rdl2
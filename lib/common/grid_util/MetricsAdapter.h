@@ -0,0 +1,150 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Export existing stats objects to MetricsRegistry --
+//
+// RenderPrepStats, Fb, RecTimeLap, LatencyLog and MemPool are updated by their owner thread
+// without any synchronization, so they can not be read from the MetricsSvr thread by
+// MetricsRegistry::addCallback(). Instead, the owner thread calls update() (or observe()) of
+// the adapter at the point where it already finished its own update (i.e. when a renderPrep
+// progress message or a ProgressiveFrame is sent). The adapter copies the values into the
+// lock-free metrics of the registry and snapshot() only reads them.
+//
+// All metrics are registered by the constructor (RecTimeLapMetrics registers one gauge for
+// each section at the first update()) and metric names start with prefix.
+//
+//    MetricsRegistry registry;
+//    RenderPrepStatsMetrics renderPrepMetrics(registry, "mcrt");
+//    LatencyLogMetrics latencyMetrics(registry, "mcrt");
+//
+//    renderPrepMetrics.update(renderPrepStats); // after renderPrepStats is updated
+//    latencyMetrics.observe(latencyLog);        // after latencyLog is sent
+//
+
+#include "MetricsRegistry.h"
+
+#include <string>
+#include <vector>
+
+namespace scene_rdl2 {
+
+namespace rec_time {
+class RecTimeLap;
+} // namespace rec_time
+
+namespace grid_util {
+
+class Fb;
+class LatencyLog;
+class RenderPrepStats;
+
+class RenderPrepStatsMetrics
+//
+// <prefix>_render_prep_stage       : RenderPrepStats::Stage value
+// <prefix>_render_prep_steps       : current steps
+// <prefix>_render_prep_steps_total : estimated total steps
+//
+{
+public:
+    RenderPrepStatsMetrics(MetricsRegistry &registry, const std::string &prefix,
+                           const std::string &labels = "");
+
+    void update(const RenderPrepStats &stats);
+
+private:
+    MetricGauge &mStage;
+    MetricGauge &mSteps;
+    MetricGauge &mStepsTotal;
+};
+
+class FbMetrics
+//
+// <prefix>_fb_active_pixels : active pixel total of the beauty buffer
+//
+{
+public:
+    FbMetrics(MetricsRegistry &registry, const std::string &prefix, const std::string &labels = "");
+
+    void update(const Fb &fb);
+
+private:
+    MetricGauge &mActivePixels;
+};
+
+class RecTimeLapMetrics
+//
+// <prefix>_lap_section_msec{section="<name>"} : last interval of each section by millisec
+//
+{
+public:
+    RecTimeLapMetrics(MetricsRegistry &registry, const std::string &prefix,
+                      const std::string &labels = "") :
+        mRegistry(registry),
+        mName(prefix + "_lap_section_msec"),
+        mLabels(labels)
+    {}
+
+    // Sections which are registered after the first update() are added at the next update().
+    void update(rec_time::RecTimeLap &recTimeLap);
+
+private:
+    MetricsRegistry &mRegistry;
+    std::string mName;
+    std::string mLabels;
+    std::vector<MetricGauge *> mSections;
+};
+
+class LatencyLogMetrics
+//
+// <prefix>_latency_seconds        : histogram of the time from LatencyLog::start() to the last item
+// <prefix>_latency_log_bytes_total : total of LatencyLog::getDataSize()
+//
+{
+public:
+    LatencyLogMetrics(MetricsRegistry &registry, const std::string &prefix,
+                      const std::vector<double> &bounds = {0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0},
+                      const std::string &labels = "");
+
+    void observe(const LatencyLog &latencyLog); // empty log is skipped
+
+private:
+    MetricHistogram &mLatency;
+    MetricCounter &mBytes;
+};
+
+class MemPoolMetrics
+//
+// <prefix>_mempool_entries       : entries allocated by the pool
+// <prefix>_mempool_block_bytes   : memory usage of the block manager
+// <prefix>_mempool_failed_allocs : entry allocations which failed
+//
+// update() is a template in order to accept any MemPool<BLOCK_TYPE, ENTRY_TYPE> without
+// linking render_util.
+//
+{
+public:
+    MemPoolMetrics(MetricsRegistry &registry, const std::string &prefix, const std::string &labels = "");
+
+    template <typename MEM_POOL>
+    void update(const MEM_POOL &memPool)
+    {
+        mEntries.set(static_cast<double>(memPool.getNumEntriesAllocated()));
+        if (memPool.getMemBlockManager()) {
+            mBlockBytes.set(static_cast<double>(memPool.getMemBlockManager()->getMemoryUsage()));
+        }
+        mFailedAllocs.set(static_cast<double>(memPool.getStats().mCounters[MEM_POOL::FAILED_ENTRY_ALLOCS]));
+    }
+
+private:
+    MetricGauge &mEntries;
+    MetricGauge &mBlockBytes;
+    MetricGauge &mFailedAllocs;
+};
+
+} // namespace grid_util
+} // namespace scene_rdl2
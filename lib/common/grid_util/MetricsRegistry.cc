@@ -0,0 +1,261 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "MetricsRegistry.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/render/util/StrUtil.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+namespace {
+
+bool
+isValidName(const std::string &name)
+{
+    // [a-zA-Z_:][a-zA-Z0-9_:]*
+    if (name.empty()) return false;
+    for (size_t i = 0; i < name.size(); ++i) {
+        const char c = name[i];
+        const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+        const bool digit = (c >= '0' && c <= '9');
+        if (!(alpha || (i > 0 && digit))) return false;
+    }
+    return true;
+}
+
+std::string
+valStr(const double v)
+{
+    if (std::isnan(v)) return "NaN";
+    if (std::isinf(v)) return (v > 0.0) ? "+Inf" : "-Inf";
+
+    // shortest representation which round trips, so 0.1 is "0.1" and not "0.10000000000000001".
+    // Integral digits are kept, so 800000 is not "8e+05".
+    constexpr int maxPrecision = std::numeric_limits<double>::max_digits10;
+    const double absV = std::fabs(v);
+    const int intDigits = (absV >= 1.0) ? static_cast<int>(std::log10(absV)) + 1 : 1;
+    char buff[32];
+    int precision = 1;
+    for (; precision < maxPrecision; ++precision) {
+        std::snprintf(buff, sizeof(buff), "%.*g", precision, v);
+        if (std::strtod(buff, nullptr) == v) break;
+    }
+    std::snprintf(buff, sizeof(buff), "%.*g", std::max(precision, std::min(intDigits, maxPrecision)), v);
+    return buff;
+}
+
+std::string
+escapeHelp(const std::string &help)
+{
+    std::string out;
+    for (char c : help) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    return out;
+}
+
+std::string
+labelStr(const std::string &labels, const std::string &addLabel = "")
+{
+    if (labels.empty() && addLabel.empty()) return "";
+    return str_util::stringCat("{", labels, ((!labels.empty() && !addLabel.empty()) ? "," : ""), addLabel, "}");
+}
+
+} // namespace
+
+uint64_t
+MetricCounter::get() const
+{
+    uint64_t total = 0;
+    for (const Shard &shard : mShard) {
+        total += shard.mVal.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+//------------------------------------------------------------------------------------------
+
+MetricHistogram::MetricHistogram(const std::vector<double> &bounds) :
+    mBounds(bounds)
+{
+    std::sort(mBounds.begin(), mBounds.end());
+    mBounds.erase(std::unique(mBounds.begin(), mBounds.end()), mBounds.end());
+    if (mBounds.size() >= sMaxBucketTotal) {
+        throw except::ValueError(str_util::stringCat("MetricHistogram too many bounds:",
+                                                     std::to_string(mBounds.size()),
+                                                     " max:", std::to_string(sMaxBucketTotal - 1)));
+    }
+
+    for (Shard &shard : mShard) {
+        for (auto &count : shard.mCount) count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void
+MetricHistogram::observe(const double v)
+{
+    // first bucket which satisfies v <= bound. NaN goes to +Inf bucket
+    const size_t bucketId = (std::isnan(v)) ?
+        mBounds.size() :
+        std::lower_bound(mBounds.begin(), mBounds.end(), v) - mBounds.begin();
+    Shard &shard = mShard[util::threadShardId()];
+    shard.mCount[bucketId].fetch_add(1, std::memory_order_relaxed);
+    metrics_detail::atomicAdd(shard.mSum, v);
+}
+
+void
+MetricHistogram::get(std::vector<uint64_t> &bucketCount, double &sum, uint64_t &count) const
+{
+    bucketCount.assign(mBounds.size() + 1, 0);
+    sum = 0.0;
+    count = 0;
+    for (const Shard &shard : mShard) {
+        for (size_t i = 0; i <= mBounds.size(); ++i) {
+            const uint64_t c = shard.mCount[i].load(std::memory_order_relaxed);
+            bucketCount[i] += c;
+            count += c;
+        }
+        sum += shard.mSum.load(std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------------------
+
+MetricCounter &
+MetricsRegistry::counter(const std::string &name, const std::string &help, const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Metric &metric = findOrAdd(name, help, Type::COUNTER, labels);
+    if (!metric.mCounter) metric.mCounter.reset(new MetricCounter);
+    return *metric.mCounter;
+}
+
+MetricGauge &
+MetricsRegistry::gauge(const std::string &name, const std::string &help, const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Metric &metric = findOrAdd(name, help, Type::GAUGE, labels);
+    if (!metric.mGauge) metric.mGauge.reset(new MetricGauge);
+    return *metric.mGauge;
+}
+
+MetricHistogram &
+MetricsRegistry::histogram(const std::string &name, const std::string &help,
+                           const std::vector<double> &bounds, const std::string &labels)
+{
+    std::unique_ptr<MetricHistogram> histogram(new MetricHistogram(bounds)); // throw before registration
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    Metric &metric = findOrAdd(name, help, Type::HISTOGRAM, labels);
+    if (!metric.mHistogram) metric.mHistogram = std::move(histogram);
+    return *metric.mHistogram;
+}
+
+void
+MetricsRegistry::addCallback(const std::string &name, const std::string &help, const CallBack &callBack,
+                             const std::string &labels)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    findOrAdd(name, help, Type::CALLBACK, labels).mCallBack = callBack;
+}
+
+size_t
+MetricsRegistry::getMetricTotal() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t total = 0;
+    for (const auto &itr : mFamilies) total += itr.second.mMetrics.size();
+    return total;
+}
+
+std::string
+MetricsRegistry::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    std::ostringstream ostr;
+    for (const auto &itr : mFamilies) {
+        const std::string &name = itr.first;
+        const Family &family = itr.second;
+
+        const char *typeStr = "gauge";
+        if (family.mType == Type::COUNTER) typeStr = "counter";
+        else if (family.mType == Type::HISTOGRAM) typeStr = "histogram";
+        ostr << "# HELP " << name << ' ' << escapeHelp(family.mHelp) << '\n'
+             << "# TYPE " << name << ' ' << typeStr << '\n';
+
+        for (const auto &metric : family.mMetrics) {
+            switch (family.mType) {
+            case Type::COUNTER :
+                ostr << name << labelStr(metric->mLabels) << ' ' << metric->mCounter->get() << '\n';
+                break;
+            case Type::GAUGE :
+                ostr << name << labelStr(metric->mLabels) << ' ' << valStr(metric->mGauge->get()) << '\n';
+                break;
+            case Type::CALLBACK :
+                ostr << name << labelStr(metric->mLabels) << ' ' << valStr(metric->mCallBack()) << '\n';
+                break;
+            case Type::HISTOGRAM : {
+                const MetricHistogram &histogram = *metric->mHistogram;
+                std::vector<uint64_t> bucketCount;
+                double sum;
+                uint64_t count;
+                histogram.get(bucketCount, sum, count);
+
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < bucketCount.size(); ++i) {
+                    cumulative += bucketCount[i];
+                    const std::string le =
+                        (i < histogram.getBounds().size()) ? valStr(histogram.getBounds()[i]) : "+Inf";
+                    ostr << name << "_bucket" << labelStr(metric->mLabels, "le=\"" + le + "\"")
+                         << ' ' << cumulative << '\n';
+                }
+                ostr << name << "_sum" << labelStr(metric->mLabels) << ' ' << valStr(sum) << '\n'
+                     << name << "_count" << labelStr(metric->mLabels) << ' ' << count << '\n';
+            } break;
+            }
+        }
+    }
+    return ostr.str();
+}
+
+MetricsRegistry::Metric &
+MetricsRegistry::findOrAdd(const std::string &name, const std::string &help, const Type type,
+                           const std::string &labels)
+{
+    if (!isValidName(name)) {
+        throw except::ValueError(str_util::stringCat("MetricsRegistry invalid metric name:\"", name, "\""));
+    }
+
+    auto itr = mFamilies.find(name);
+    if (itr == mFamilies.end()) {
+        itr = mFamilies.emplace(name, Family {type, help, {}}).first;
+    } else if (itr->second.mType != type) {
+        throw except::ValueError(str_util::stringCat("MetricsRegistry metric \"", name,
+                                                     "\" is already registered as a different type"));
+    }
+
+    Family &family = itr->second;
+    for (auto &metric : family.mMetrics) {
+        if (metric->mLabels == labels) return *metric;
+    }
+    family.mMetrics.emplace_back(new Metric);
+    family.mMetrics.back()->mLabels = labels;
+    return *family.mMetrics.back();
+}
+
+} // namespace grid_util
+} // namespace scene_rdl2
@@ -0,0 +1,190 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Metrics registry for render node internals --
+//
+// Keeps counters, gauges and histograms and outputs all of them as Prometheus text exposition
+// format (version 0.0.4) by snapshot(). MetricsSvr serves this snapshot over a TCP or unix
+// domain socket.
+//
+// Registration is protected by a mutex and is expected to be done at setup time. The returned
+// metric object is owned by the registry and stays valid until the registry is destructed.
+// Updating metric objects is lock-free and designed to be called from the render threads.
+// Counters and histograms are split into per-thread shards in order to avoid cache line
+// contention between threads. snapshot() sums up the shards and its cost only depends on the
+// number of the registered metrics, not on the update frequency.
+//
+// Values which are already tracked by other thread safe objects can be exported by addCallback()
+// without touching their update code. The callback is evaluated by snapshot() and has to be
+// thread safe. RenderPrepStats, Fb, RecTimeLap, LatencyLog and MemPool are not thread safe and
+// are exported by the adapters in MetricsAdapter.h instead.
+//
+//    MetricsRegistry registry;
+//    MetricCounter &sendCounter = registry.counter("mcrt_progressive_frame_send_total",
+//                                                  "Number of sent ProgressiveFrame messages");
+//    MetricHistogram &latency = registry.histogram("mcrt_snapshot_seconds", "snapshot time",
+//                                                  {0.001, 0.005, 0.01, 0.05, 0.1});
+//    registry.addCallback("mcrt_frame_id", "current frame id",
+//                         [&]() { return static_cast<double>(frameId.load()); });
+//
+//    sendCounter.inc();        // render threads
+//    latency.observe(sec);
+//
+
+#include <scene_rdl2/render/util/AtomicFloat.h> // std::atomic<double> has to be the same in all files
+#include <scene_rdl2/render/util/ThreadShard.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>             // uint64_t
+#include <string>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+namespace metrics_detail {
+
+inline void
+atomicAdd(std::atomic<double> &target, const double v)
+{
+    double curr = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(curr, curr + v, std::memory_order_relaxed)) {}
+}
+
+} // namespace metrics_detail
+
+class MetricCounter
+//
+// Monotonically increasing counter. (Prometheus counter type)
+//
+{
+public:
+    void inc(const uint64_t n = 1)
+    {
+        mShard[util::threadShardId()].mVal.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const;
+
+private:
+    struct alignas(util::sThreadShardAlign) Shard { std::atomic<uint64_t> mVal {0}; };
+
+    Shard mShard[util::sThreadShardTotal];
+};
+
+class MetricGauge
+//
+// Value which goes up and down. (Prometheus gauge type)
+//
+{
+public:
+    void set(const double v) { mVal.store(v, std::memory_order_relaxed); }
+    void add(const double v) { metrics_detail::atomicAdd(mVal, v); }
+
+    double get() const { return mVal.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> mVal {0.0};
+};
+
+class MetricHistogram
+//
+// Distribution of observed values by fixed buckets. (Prometheus histogram type)
+// Bucket bounds are upper bounds (inclusive) in ascending order. +Inf bucket is added internally.
+// Bucket counts are kept inside of each per-thread shard, so observe() only touches the cache
+// lines of the calling thread's shard. Up to sMaxBucketTotal buckets including +Inf.
+//
+{
+public:
+    static constexpr size_t sMaxBucketTotal = 32;
+
+    // throw except::ValueError if bounds has more than sMaxBucketTotal - 1 unique values
+    explicit MetricHistogram(const std::vector<double> &bounds);
+
+    void observe(const double v);
+
+    const std::vector<double> &getBounds() const { return mBounds; }
+
+    // non cumulative count of each bucket (size = bounds + 1 : last one is +Inf), sum and count.
+    void get(std::vector<uint64_t> &bucketCount, double &sum, uint64_t &count) const;
+
+private:
+    struct alignas(util::sThreadShardAlign) Shard
+    {
+        std::atomic<uint64_t> mCount[sMaxBucketTotal]; // bounds + 1 are used
+        std::atomic<double> mSum {0.0};
+    };
+
+    std::vector<double> mBounds;
+    Shard mShard[util::sThreadShardTotal];
+};
+
+class MetricsRegistry
+{
+public:
+    using CallBack = std::function<double()>;
+
+    MetricsRegistry() = default;
+
+    // Non-copyable
+    MetricsRegistry &operator =(const MetricsRegistry &) = delete;
+    MetricsRegistry(const MetricsRegistry &) = delete;
+
+    // Register a new metric or return the already registered one which has the same name and
+    // labels. labels is Prometheus label format without braces. (i.e. "aov=\"beauty\"")
+    // throw except::ValueError if name is not a valid metric name, same name is already
+    // registered as a different type or histogram has too many bounds.
+    MetricCounter &counter(const std::string &name, const std::string &help,
+                           const std::string &labels = "");
+    MetricGauge &gauge(const std::string &name, const std::string &help,
+                       const std::string &labels = "");
+    MetricHistogram &histogram(const std::string &name, const std::string &help,
+                               const std::vector<double> &bounds,
+                               const std::string &labels = "");
+
+    // gauge which is evaluated by snapshot(). Replace callback if already registered.
+    void addCallback(const std::string &name, const std::string &help, const CallBack &callBack,
+                     const std::string &labels = "");
+
+    size_t getMetricTotal() const;
+
+    // Prometheus text exposition format. Metrics are sorted by name.
+    std::string snapshot() const;
+
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM, CALLBACK };
+
+    struct Metric
+    {
+        std::string mLabels;
+        std::unique_ptr<MetricCounter> mCounter;
+        std::unique_ptr<MetricGauge> mGauge;
+        std::unique_ptr<MetricHistogram> mHistogram;
+        CallBack mCallBack;
+    };
+
+    struct Family
+    {
+        Type mType;
+        std::string mHelp;
+        std::vector<std::unique_ptr<Metric>> mMetrics;
+    };
+
+    Metric &findOrAdd(const std::string &name, const std::string &help, const Type type,
+                      const std::string &labels); // need mMutex
+
+    mutable std::mutex mMutex;
+    std::map<std::string, Family> mFamilies;
+};
+
+} // namespace grid_util
+} // namespace scene_rdl2
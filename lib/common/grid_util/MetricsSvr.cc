@@ -0,0 +1,223 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "MetricsSvr.h"
+#include "LiteralUtil.h"
+#include "SockUtil.h"
+
+#include <scene_rdl2/render/util/StrUtil.h>
+
+#include <iostream>
+
+#include <arpa/inet.h>          // ::inet_pton()
+#include <fcntl.h>              // ::fcntl()
+#include <netinet/in.h>         // struct sockaddr_in
+#include <poll.h>               // ::poll()
+#include <string.h>
+#include <sys/eventfd.h>        // ::eventfd()
+#include <sys/socket.h>         // ::socket()
+#include <sys/un.h>             // struct sockaddr_un
+#include <unistd.h>             // ::close()
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+int
+MetricsSvr::openTcp(const int port, const std::string &bindAddr)
+{
+    if (mBaseSock != -1) return 0; // already opened
+
+    struct sockaddr_in in;
+    bzero(&in, sizeof(in));
+    in.sin_family = AF_INET;
+    in.sin_port = htons(static_cast<uint16_t>(port)); // put in net order
+    if (::inet_pton(AF_INET, bindAddr.c_str(), &in.sin_addr) != 1) {
+        std::cerr << ">> MetricsSvr.cc invalid bind address:" << bindAddr << '\n';
+        return 0;
+    }
+
+    if ((mBaseSock = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        mBaseSock = -1;
+        std::cerr << ">> MetricsSvr.cc ::socket() failed. errno:" << errno << " " << strerror(errno) << '\n';
+        return 0;
+    }
+
+    int status = 1;
+    (void)::setsockopt(mBaseSock, SOL_SOCKET, SO_REUSEADDR, (char *)&status, sizeof(status));
+
+    socklen_t inLen = sizeof(in);
+    if (::bind(mBaseSock, (struct sockaddr *)&in, sizeof(in)) < 0 ||
+        ::getsockname(mBaseSock, (struct sockaddr *)&in, &inLen) != 0 ||
+        ::listen(mBaseSock, 16) < 0) {
+        std::cerr << ">> MetricsSvr.cc TCP " << bindAddr << ":" << port << " open failed. errno:" << errno
+                  << " " << strerror(errno) << '\n';
+        ::close(mBaseSock);
+        mBaseSock = -1;
+        return 0;
+    }
+    mPort = ntohs(in.sin_port);
+
+    if (!bootThread()) {
+        close();
+        return 0;
+    }
+    return mPort;
+}
+
+bool
+MetricsSvr::openUnix(const std::string &path)
+{
+    if (mBaseSock != -1) return false; // already opened
+
+    struct sockaddr_un un;
+    bzero(&un, sizeof(un));
+    if (path.empty() || path.size() >= sizeof(un.sun_path)) {
+        std::cerr << ">> MetricsSvr.cc invalid unix domain socket path:" << path << '\n';
+        return false;
+    }
+    un.sun_family = AF_UNIX;
+    strncpy(un.sun_path, path.c_str(), sizeof(un.sun_path) - 1);
+
+    if ((mBaseSock = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        mBaseSock = -1;
+        std::cerr << ">> MetricsSvr.cc ::socket() failed. errno:" << errno << " " << strerror(errno) << '\n';
+        return false;
+    }
+
+    ::unlink(path.c_str());     // remove old socket file
+    if (::bind(mBaseSock, (struct sockaddr *)&un, sizeof(un)) < 0 ||
+        ::listen(mBaseSock, 16) < 0) {
+        std::cerr << ">> MetricsSvr.cc unix domain socket:" << path << " open failed. errno:" << errno
+                  << " " << strerror(errno) << '\n';
+        ::close(mBaseSock);
+        mBaseSock = -1;
+        return false;
+    }
+    mUnixPath = path;
+
+    if (!bootThread()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void
+MetricsSvr::close()
+{
+    if (mThread.joinable()) {
+        uint64_t one = 1;
+        (void)::write(mWakeupFd, &one, sizeof(one));
+        mThread.join();
+    }
+    if (mWakeupFd != -1) {
+        ::close(mWakeupFd);
+        mWakeupFd = -1;
+    }
+    if (mBaseSock != -1) {
+        ::close(mBaseSock);
+        mBaseSock = -1;
+    }
+    if (!mUnixPath.empty()) {
+        ::unlink(mUnixPath.c_str());
+        mUnixPath.clear();
+    }
+    mPort = 0;
+}
+
+//------------------------------------------------------------------------------------------
+
+bool
+MetricsSvr::bootThread()
+{
+    mWakeupFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mWakeupFd == -1) {
+        std::cerr << ">> MetricsSvr.cc ::eventfd() failed. errno:" << errno << " " << strerror(errno) << '\n';
+        return false;
+    }
+    mThread = std::thread([this]() { threadMain(); });
+    return true;
+}
+
+void
+MetricsSvr::threadMain()
+{
+    struct pollfd fds[2];
+    fds[0].fd = mBaseSock;
+    fds[0].events = POLLIN;
+    fds[1].fd = mWakeupFd;
+    fds[1].events = POLLIN;
+
+    while (true) {
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << ">> MetricsSvr.cc ::poll() failed. errno:" << errno << " " << strerror(errno) << '\n';
+            break;
+        }
+        if (fds[1].revents) break; // shutdown
+
+        if (fds[0].revents & POLLIN) {
+            int sock = ::accept4(mBaseSock, nullptr, nullptr, SOCK_CLOEXEC);
+            if (sock < 0) continue; // EINTR, ECONNABORTED etc : try next
+            serve(sock);
+            ::close(sock);
+        }
+    }
+}
+
+void
+MetricsSvr::serve(int sock) const
+{
+    struct timeval tv;
+    tv.tv_sec = sIoTimeoutMs / 1000;
+    tv.tv_usec = (sIoTimeoutMs % 1000) * 1000;
+    ::setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    setSockBufferSize(sock, SOL_SOCKET, 256_KiB);
+
+    //
+    // read request if the client sends it within sIoTimeoutMs. We only need the first line.
+    //
+    std::string request;
+    struct pollfd fd;
+    fd.fd = sock;
+    fd.events = POLLIN;
+    while (request.find('\n') == std::string::npos && request.size() < 4096) {
+        fd.revents = 0;
+        if (::poll(&fd, 1, sIoTimeoutMs) <= 0) break; // timeout : client which does not send request
+        char buff[1024];
+        ssize_t rSize = ::recv(sock, buff, sizeof(buff), 0);
+        if (rSize <= 0) break;
+        request.append(buff, static_cast<size_t>(rSize));
+    }
+
+    const std::string body = mRegistry.snapshot();
+    std::string response;
+    if (request.compare(0, 4, "GET ") == 0) {
+        response = str_util::stringCat("HTTP/1.0 200 OK\r\n",
+                                       "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n",
+                                       "Content-Length: ", std::to_string(body.size()), "\r\n",
+                                       "\r\n",
+                                       body);
+    } else {
+        response = body;
+    }
+
+    const char *cPtr = response.data();
+    size_t size = response.size();
+    while (size) {
+        ssize_t wSize = ::send(sock, cPtr, size, MSG_NOSIGNAL);
+        if (wSize < 0) {
+            if (errno == EINTR) continue;
+            break;              // timeout or closed by client
+        }
+        cPtr += wSize;
+        size -= static_cast<size_t>(wSize);
+    }
+}
+
+} // namespace grid_util
+} // namespace scene_rdl2
@@ -0,0 +1,75 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+#include "MetricsRegistry.h"
+
+#include <string>
+#include <thread>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+class MetricsSvr
+//
+// Serves MetricsRegistry::snapshot() over a TCP or unix domain socket.
+// This class boots an independent thread which sleeps inside ::poll() until a connection
+// arrives and never wakes up while idle. Each connection gets one snapshot and is closed.
+// If the client sends a HTTP GET request (i.e. Prometheus scrape or curl), the snapshot is
+// returned as a HTTP/1.0 response. Otherwise (i.e. nc) only the snapshot text is returned.
+// Reading the request and sending the response are limited by sIoTimeoutMs, so a stuck
+// client never blocks the server for long. Only one of TCP or unix domain socket is opened.
+// The TCP socket is bound to the loopback address unless a wider address is requested
+// explicitly, so metrics are not exposed to the network by default.
+//
+{
+public:
+    static constexpr int sIoTimeoutMs = 1000;
+    static constexpr const char *sLoopbackAddr = "127.0.0.1";
+
+    explicit MetricsSvr(const MetricsRegistry &registry) :
+        mRegistry(registry),
+        mBaseSock(-1),
+        mWakeupFd(-1),
+        mPort(0)
+    {}
+    ~MetricsSvr() { close(); }
+
+    // Non-copyable
+    MetricsSvr &operator =(const MetricsSvr &) = delete;
+    MetricsSvr(const MetricsSvr &) = delete;
+
+    // If you set port as 0, kernel find available port for you.
+    // bindAddr is an IPv4 address in dotted decimal. Default is the loopback address (local
+    // scrape only). Use "0.0.0.0" (all interfaces) or a specific interface address to accept
+    // remote scrape.
+    // return opened port number. 0 is error
+    int openTcp(const int port, const std::string &bindAddr = sLoopbackAddr);
+
+    // return false if failed. Existing file at the path is removed.
+    bool openUnix(const std::string &path);
+
+    void close();               // shutdown thread and close socket
+
+    int getPort() const { return mPort; }
+
+private:
+    bool bootThread();
+    void threadMain();
+    void serve(int sock) const;
+
+    const MetricsRegistry &mRegistry;
+
+    int mBaseSock;
+    int mWakeupFd;              // eventfd for shutdown
+    int mPort;                  // TCP port. 0 if not TCP
+    std::string mUnixPath;      // unix domain socket path. empty if not unix domain
+
+    std::thread mThread;
+};
+
+} // namespace grid_util
+} // namespace scene_rdl2
@@ -5,6 +5,7 @@
 //
 #include "PackTiles.h"
 #include "PackActiveTiles.h"
+#include "Sha1Util.h"
 
 #include <scene_rdl2/common/fb_util/ActivePixels.h>
 #include <scene_rdl2/common/fb_util/GammaF2C.h>
@@ -16,8 +17,10 @@
 #include <scene_rdl2/common/math/Vec4.h>
 #include <scene_rdl2/common/platform/Platform.h> // for definition of finline
 #include <scene_rdl2/common/rec_time/RecTime.h>
+#include <scene_rdl2/common/rec_time/RecZone.h>
 #include <scene_rdl2/scene/rdl2/ValueContainerDeq.h>
 #include <scene_rdl2/scene/rdl2/ValueContainerEnq.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerSink.h>
 
 #include <iomanip>
 #include <openssl/sha.h>
@@ -37,6 +40,65 @@
 namespace scene_rdl2 {
 namespace grid_util {
 
+class PackTilesOutput
+//
+// Output of the PackTilesImpl encode functions. Encoded data is appended to a std::string or
+// streamed to a rdl2::ValueContainerSink. In both cases the SHA1 hash space is reserved in front
+// of the data and patched after the encode.
+//
+{
+public:
+    static constexpr unsigned HASH_SIZE = PackTiles::HASH_SIZE;
+
+    PackTilesOutput(std::string &str) : mStr(&str), mSink(nullptr) {}
+    PackTilesOutput(rdl2::ValueContainerSink &sink) : mStr(nullptr), mSink(&sink) {}
+
+    size_t size() const { return (mStr) ? mStr->size() : mSink->size(); }
+
+    // append HASH_SIZE zero bytes and return offset of them
+    size_t appendHashSpace()
+    {
+        const size_t offset = size();
+        if (mStr) {
+            mStr->append(HASH_SIZE, 0x0);
+        } else {
+            const unsigned char zero[HASH_SIZE] = {};
+            mSink->append(zero, HASH_SIZE);
+        }
+        return offset;
+    }
+
+    rdl2::ValueContainerEnq makeEnq()
+    {
+        return (mStr) ? rdl2::ValueContainerEnq(mStr) : rdl2::ValueContainerEnq(mSink);
+    }
+
+    // compute SHA1 of the data [dataOffset, dataOffset + dataSize) and save it at hashOffset
+    void setSha1Hash(const size_t hashOffset, const size_t dataOffset, const size_t dataSize)
+    {
+        if (mStr) {
+            const unsigned char *srcPtr =
+                reinterpret_cast<const unsigned char *>((uintptr_t)(mStr->data()) +
+                                                        static_cast<uintptr_t>(dataOffset));
+            unsigned char *dstPtr =
+                reinterpret_cast<unsigned char *>((uintptr_t)(mStr->data()) +
+                                                  static_cast<uintptr_t>(hashOffset));
+            SHA1(srcPtr, dataSize, dstPtr);
+        } else {
+            Sha1Gen sha1;
+            sha1.init();
+            mSink->crawl(dataOffset, dataSize,
+                         [&](const char *data, size_t size) { sha1.updateByteData(data, size); });
+            const Sha1Gen::Hash hash = sha1.finalize();
+            mSink->overwrite(hashOffset, hash.data(), HASH_SIZE);
+        }
+    }
+
+private:
+    std::string *mStr;
+    rdl2::ValueContainerSink *mSink;
+};
+
 //
 // Regarding precision control. currently we are using UC8 (8bit precision),
 // H16 (half float precision) and F32 (full single float precision) depending on the situation.
@@ -77,7 +139,7 @@ public:
     encode(const ActivePixels &activePixels,      // should be constructed by original w, h
            const RenderBuffer &renderBufferTiled, // tile aligned resolution : non normalized color
            const FloatBuffer &weightBufferTiled,  // tile aligned resolution
-           std::string &output,
+           PackTilesOutput output,
            const PrecisionMode precisionMode, // precision which is used in this encoding operation
            const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
            const FinePassPrecision finePassPrecision,     // minimum fine pass precision
@@ -91,7 +153,7 @@ public:
     static size_t
     encode(const ActivePixels &activePixels,      // should be constructed by original w, h
            const RenderBuffer &renderBufferTiled, // tile aligned reso : normalized color
-           std::string &output,
+           PackTilesOutput output,
            const PrecisionMode precisionMode, // precision which is used in this encoding operation
            const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
            const FinePassPrecision finePassPrecision,     // minimum fine pass precision
@@ -130,7 +192,7 @@ public:
     static size_t
     encodePixelInfo(const ActivePixels &activePixels,
                     const PixelInfoBuffer &pixelInfoBufferTiled,
-                    std::string &output,
+                    PackTilesOutput output,
                     const PrecisionMode precisionMode, // precision which is used in this encoding operation
                     const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
                     const FinePassPrecision finePassPrecision,     // minimum fine pass precision
@@ -157,7 +219,7 @@ public:
     encodeHeatMap(const ActivePixels &activePixels,
                   const FloatBuffer &heatMapSecBufferTiled, // non normalize sec
                   const FloatBuffer &heatMapWeightBufferTiled,
-                  std::string &output,
+                  PackTilesOutput output,
                   const bool noNumSampleMode,
                   const bool withSha1Hash = false,
                   const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
@@ -167,7 +229,7 @@ public:
     static size_t
     encodeHeatMap(const ActivePixels &activePixels,
                   const FloatBuffer &heatMapSecBufferTiled, // normalize sec
-                  std::string &output,
+                  PackTilesOutput output,
                   const bool withSha1Hash = false,
                   const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
@@ -199,7 +261,7 @@ public:
     static size_t
     encodeWeightBuffer(const ActivePixels &activePixels,
                        const FloatBuffer &weightBufferTiled,
-                       std::string &output,
+                       PackTilesOutput output,
                        const PrecisionMode precisionMode, // precision which is used in this encode operation
                        const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
                        const FinePassPrecision finePassPrecision,     // minimum fine pass precision
@@ -229,7 +291,7 @@ public:
                        const VariablePixelBuffer &renderOutputBufferTiled, // non normalized value
                        const float renderOutputBufferDefaultValue,
                        const FloatBuffer &renderOutputWeightBufferTiled,
-                       std::string &output,
+                       PackTilesOutput output,
                        const PrecisionMode precisionMode, // precision which is used in this encode operation
                        const bool noNumSampleMode,
                        const bool doNormalizeMode,
@@ -245,7 +307,7 @@ public:
     encodeRenderOutputMerge(const ActivePixels &activePixels,
                             const VariablePixelBuffer &renderOutputBufferTiled, // normalized value
                             const float renderOutputBufferDefaultValue,
-                            std::string &output,
+                            PackTilesOutput output,
                             const PrecisionMode precisionMode, // precision which is used in this encode func
                             const bool closestFilterStatus,
                             const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
@@ -270,7 +332,7 @@ public:
     //
     static size_t
     encodeRenderOutputReference(const FbReferenceType &referenceType,
-                                std::string &output,
+                                PackTilesOutput output,
                                 const bool withSha1Hash = false,
                                 const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
     static bool
@@ -633,7 +695,7 @@ protected:
                              const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
                              const FinePassPrecision finePassPrecision, // minimum fine pass precision
                              const ActivePixels &activePixels,
-                             std::string &output,
+                             PackTilesOutput output,
                              const bool withSha1Hash,
                              F enqTilePixelBlockFunc) {
         //------------------------------
@@ -643,17 +705,14 @@ protected:
         // hash data is outside valueContainer region. This cause verify hash very easily for
         // packTile data. (See verifyDecodeHash()).
         //
-        size_t hashOffset = output.size();
-        for (size_t i = 0; i < HASH_SIZE; ++i) {
-            output.push_back(0x0);
-        }
-        size_t dataOffset = output.size(); // data start offset insize output string
+        size_t hashOffset = output.appendHashSpace();
+        size_t dataOffset = output.size(); // data start offset insize output
 
         //------------------------------
         //
         // data encode
         //
-        VContainerEnq vContainerEnq(&output);
+        VContainerEnq vContainerEnq = output.makeEnq();
 
         enqHeaderBlock(enqFormatVer,
                        dataType, FbReferenceType::UNDEF, &activePixels, defaultValue, precisionMode,
@@ -697,14 +756,7 @@ protected:
         //
         if (withSha1Hash) {
             // When withSha1Hash = true, we compute hash and save to preallocated location.
-            const unsigned char *srcPtr =
-                reinterpret_cast<const unsigned char *>((uintptr_t)(output.data()) +
-                                                        static_cast<uintptr_t>(dataOffset));
-            size_t srcSize = dataSize;
-            unsigned char *dstPtr =
-                reinterpret_cast<unsigned char *>((uintptr_t)(output.data()) +
-                                                  static_cast<uintptr_t>(hashOffset));
-            SHA1(srcPtr, srcSize, dstPtr);
+            output.setSha1Hash(hashOffset, dataOffset, dataSize);
         }
 
         return dataSize + HASH_SIZE;
@@ -1280,7 +1332,7 @@ size_t
 PackTilesImpl::encode(const ActivePixels &activePixels,
                       const RenderBuffer &renderBufferTiled, // non-normalized color
                       const FloatBuffer &weightBufferTiled,
-                      std::string &output,
+                      PackTilesOutput output,
                       const PrecisionMode precisionMode,
                       const CoarsePassPrecision coarsePassPrecision,
                       const FinePassPrecision finePassPrecision,
@@ -1378,7 +1430,7 @@ template <bool renderBufferOdd>
 size_t
 PackTilesImpl::encode(const ActivePixels &activePixels,
                       const RenderBuffer &renderBufferTiled, // normalized color
-                      std::string &output,
+                      PackTilesOutput output,
                       const PrecisionMode precisionMode,
                       const CoarsePassPrecision coarsePassPrecision,
                       const FinePassPrecision finePassPrecision,
@@ -1763,7 +1815,7 @@ PackTilesImpl::deqTileMaskBlock(VContainerDeq &vContainerDeq,
 size_t
 PackTilesImpl::encodePixelInfo(const ActivePixels &activePixels,
                                const PixelInfoBuffer &pixelInfoBufferTiled,
-                               std::string &output,
+                               PackTilesOutput output,
                                const PrecisionMode precisionMode,
                                const CoarsePassPrecision coarsePassPrecision,
                                const FinePassPrecision finePassPrecision,
@@ -1883,7 +1935,7 @@ size_t
 PackTilesImpl::encodeHeatMap(const ActivePixels &activePixels,
                              const FloatBuffer &heatMapSecBufferTiled, // non-normalized sec
                              const FloatBuffer &heatMapWeightBufferTiled,
-                             std::string &output,
+                             PackTilesOutput output,
                              const bool noNumSampleMode,
                              const bool withSha1Hash,
                              const EnqFormatVer enqFormatVer)
@@ -1973,7 +2025,7 @@ PackTilesImpl::encodeHeatMap(const ActivePixels &activePixels,
 size_t
 PackTilesImpl::encodeHeatMap(const ActivePixels &activePixels,
                              const FloatBuffer &heatMapSecBufferTiled, // normalized sec
-                             std::string &output,
+                             PackTilesOutput output,
                              const bool withSha1Hash,
                              const EnqFormatVer enqFormatVer)
 //
@@ -2161,7 +2213,7 @@ PackTilesImpl::decodeHeatMap(const void *addr,
 size_t
 PackTilesImpl::encodeWeightBuffer(const ActivePixels &activePixels,
                                   const FloatBuffer &weightBufferTiled,
-                                  std::string &output,
+                                  PackTilesOutput output,
                                   const PrecisionMode precisionMode,
                                   const CoarsePassPrecision coarsePassPrecision,
                                   const FinePassPrecision finePassPrecision,
@@ -2287,7 +2339,7 @@ PackTilesImpl::encodeRenderOutput(const ActivePixels &activePixels,
                                   const VariablePixelBuffer &renderOutputBufferTiled, // non-normalized
                                   const float renderOutputBufferDefaultValue,
                                   const FloatBuffer &renderOutputWeightBufferTiled,
-                                  std::string &output,
+                                  PackTilesOutput output,
                                   const PrecisionMode precisionMode,
                                   const bool noNumSampleMode,
                                   const bool doNormalizeMode, // do normalize or not
@@ -2709,7 +2761,7 @@ size_t
 PackTilesImpl::encodeRenderOutputMerge(const ActivePixels &activePixels,
                                        const VariablePixelBuffer &renderOutputBufferTiled, // normalized
                                        const float renderOutputBufferDefaultValue,
-                                       std::string &output,
+                                       PackTilesOutput output,
                                        const PrecisionMode precisionMode,
                                        const bool closestFilterStatus,
                                        const CoarsePassPrecision coarsePassPrecision,
@@ -3086,7 +3138,7 @@ PackTilesImpl::decodeRenderOutput(const void *addr,
 // stataic function
 size_t
 PackTilesImpl::encodeRenderOutputReference(const FbReferenceType &referenceType,
-                                           std::string &output,
+                                           PackTilesOutput output,
                                            const bool withSha1Hash,
                                            const EnqFormatVer enqFormatVer)
 {
@@ -3097,17 +3149,14 @@ PackTilesImpl::encodeRenderOutputReference(const FbReferenceType &referenceType,
     // hash data is outside valueContainer region. This cause verify hash very easily for packTile data.
     // (See verifyDecodeHash()).
     //
-    size_t hashOffset = output.size();
-    for (size_t i = 0; i < HASH_SIZE; ++i) {
-        output.push_back(0x0);
-    }
-    size_t dataOffset = output.size(); // data start offset insize output string
+    size_t hashOffset = output.appendHashSpace();
+    size_t dataOffset = output.size(); // data start offset insize output
 
     //------------------------------
     //
     // data encode
     //
-    VContainerEnq vContainerEnq(&output);
+    VContainerEnq vContainerEnq = output.makeEnq();
 
     enqHeaderBlock(enqFormatVer,
                    DataType::REFERENCE, referenceType,
@@ -3127,13 +3176,7 @@ PackTilesImpl::encodeRenderOutputReference(const FbReferenceType &referenceType,
     //
     if (withSha1Hash) {
         // When withSha1Hash = true, we compute hash and save to preallocated location.
-        const unsigned char *srcPtr =
-            reinterpret_cast<const unsigned char *>((uintptr_t)(output.data()) +
-                                                    static_cast<uintptr_t>(dataOffset));
-        unsigned srcSize = dataSize;
-        unsigned char *dstPtr = reinterpret_cast<unsigned char *>((uintptr_t)(output.data()) +
-                                                                  static_cast<uintptr_t>(hashOffset));
-        SHA1(srcPtr, srcSize, dstPtr);
+        output.setSha1Hash(hashOffset, dataOffset, dataSize);
     }
 
     return dataSize + HASH_SIZE;
@@ -4203,6 +4246,39 @@ PackTiles::encode(const bool renderBufferOdd,
                   const bool withSha1Hash,
                   const EnqFormatVer enqFormatVer)
 {
+    REC_ZONE("PackTiles::encode");
+
+    if (renderBufferOdd) {
+        return PackTilesImpl::encode<true>(activePixels, renderBufferTiled, weightBufferTiled,
+                                           output,
+                                           precisionMode, coarsePassPrecision, finePassPrecision,
+                                           noNumSampleMode, withSha1Hash,
+                                           enqFormatVer);
+    } else {
+        return PackTilesImpl::encode<false>(activePixels, renderBufferTiled, weightBufferTiled,
+                                            output,
+                                            precisionMode, coarsePassPrecision, finePassPrecision,
+                                            noNumSampleMode, withSha1Hash,
+                                            enqFormatVer);
+    }
+}
+
+// static function
+size_t
+PackTiles::encode(const bool renderBufferOdd,
+                  const ActivePixels &activePixels,      // constructed by original w, h
+                  const RenderBuffer &renderBufferTiled, // tile aligned reso : non normalized color
+                  const FloatBuffer &weightBufferTiled,  // tile aligned resolution
+                  rdl2::ValueContainerSink &output,
+                  const PrecisionMode precisionMode,
+                  const CoarsePassPrecision coarsePassPrecision,
+                  const FinePassPrecision finePassPrecision,
+                  const bool noNumSampleMode,
+                  const bool withSha1Hash,
+                  const EnqFormatVer enqFormatVer)
+{
+    REC_ZONE("PackTiles::encode");
+
     if (renderBufferOdd) {
         return PackTilesImpl::encode<true>(activePixels, renderBufferTiled, weightBufferTiled,
                                            output,
@@ -4232,6 +4308,33 @@ PackTiles::encode(const bool renderBufferOdd,
                   const bool withSha1Hash,
                   const EnqFormatVer enqFormatVer)
 {
+    REC_ZONE("PackTiles::encode");
+
+    if (renderBufferOdd) {
+        return PackTilesImpl::encode<true>(activePixels, renderBufferTiled, output,
+                                           precisionMode, coarsePassPrecision, finePassPrecision,
+                                           withSha1Hash, enqFormatVer);
+    } else {
+        return PackTilesImpl::encode<false>(activePixels, renderBufferTiled, output,
+                                            precisionMode, coarsePassPrecision, finePassPrecision,
+                                            withSha1Hash, enqFormatVer);
+    }
+}
+
+// static function
+size_t
+PackTiles::encode(const bool renderBufferOdd,
+                  const ActivePixels &activePixels,      // constructed by original w, h
+                  const RenderBuffer &renderBufferTiled, // tile aligned reso : normalized color
+                  rdl2::ValueContainerSink &output,
+                  const PrecisionMode precisionMode,
+                  const CoarsePassPrecision coarsePassPrecision,
+                  const FinePassPrecision finePassPrecision,
+                  const bool withSha1Hash,
+                  const EnqFormatVer enqFormatVer)
+{
+    REC_ZONE("PackTiles::encode");
+
     if (renderBufferOdd) {
         return PackTilesImpl::encode<true>(activePixels, renderBufferTiled, output,
                                            precisionMode, coarsePassPrecision, finePassPrecision,
@@ -4257,6 +4360,8 @@ PackTiles::decode(const bool renderBufferOdd,                // in
                   FinePassPrecision &finePassPrecision,      // out : minimum fine pass precision
                   unsigned char *sha1HashDigest)
 {
+    REC_ZONE("PackTiles::decode");
+
     if (renderBufferOdd) {
         return PackTilesImpl::decode<true>(addr,
                                            dataSize,
@@ -4292,6 +4397,8 @@ PackTiles::decode(const bool renderBufferOdd,                // in
                   FinePassPrecision &finePassPrecision,      // out : minimum fine pass precision
                   unsigned char *sha1HashDigest)
 {
+    REC_ZONE("PackTiles::decode");
+
     if (renderBufferOdd) {
         return PackTilesImpl::decode<true>(addr, dataSize, activePixels,
                                            normalizedRenderBufferTiled,
@@ -4329,6 +4436,25 @@ PackTiles::encodePixelInfo(const ActivePixels &activePixels,
                                           withSha1Hash, enqFormatVer);
 }
 
+// static function
+size_t
+PackTiles::encodePixelInfo(const ActivePixels &activePixels,
+                           const PixelInfoBuffer &pixelInfoBufferTiled,
+                           rdl2::ValueContainerSink &output,
+                           const PrecisionMode precisionMode,
+                           const CoarsePassPrecision coarsePassPrecision,
+                           const FinePassPrecision finePassPrecision,
+                           const bool withSha1Hash,
+                           const EnqFormatVer enqFormatVer)
+{
+    return PackTilesImpl::encodePixelInfo(activePixels, pixelInfoBufferTiled,
+                                          output,
+                                          precisionMode,
+                                          coarsePassPrecision,
+                                          finePassPrecision,
+                                          withSha1Hash, enqFormatVer);
+}
+
 // static function
 bool
 PackTiles::decodePixelInfo(const void *addr,                   // in
@@ -4367,6 +4493,21 @@ PackTiles::encodeHeatMap(const ActivePixels &activePixels,
                                         noNumSampleMode, withSha1Hash, enqFormatVer);
 }
 
+// static function
+size_t
+PackTiles::encodeHeatMap(const ActivePixels &activePixels,
+                         const FloatBuffer &heatMapSecBufferTiled, // non normalize sec
+                         const FloatBuffer &heatMapWeightBufferTiled,
+                         rdl2::ValueContainerSink &output,
+                         const bool noNumSampleMode,
+                         const bool withSha1Hash,
+                         const EnqFormatVer enqFormatVer)
+{
+    return PackTilesImpl::encodeHeatMap(activePixels, heatMapSecBufferTiled, heatMapWeightBufferTiled,
+                                        output,
+                                        noNumSampleMode, withSha1Hash, enqFormatVer);
+}
+
 // Sec : float * 1
 // static function
 size_t
@@ -4381,6 +4522,19 @@ PackTiles::encodeHeatMap(const ActivePixels &activePixels,
                                         withSha1Hash, enqFormatVer);
 }
 
+// static function
+size_t
+PackTiles::encodeHeatMap(const ActivePixels &activePixels,
+                         const FloatBuffer &heatMapSecBufferTiled, // normalize sec
+                         rdl2::ValueContainerSink &output,
+                         const bool withSha1Hash,
+                         const EnqFormatVer enqFormatVer)
+{
+    return PackTilesImpl::encodeHeatMap(activePixels, heatMapSecBufferTiled,
+                                        output,
+                                        withSha1Hash, enqFormatVer);
+}
+
 // Sec + numSample : float * 1 + u_int
 // static function
 bool
@@ -4438,6 +4592,27 @@ PackTiles::encodeWeightBuffer(const ActivePixels &activePixels,
                                              enqFormatVer);
 }
 
+// static function
+size_t
+PackTiles::encodeWeightBuffer(const ActivePixels &activePixels,
+                              const FloatBuffer &weightBufferTiled,
+                              rdl2::ValueContainerSink &output,
+                              const PrecisionMode precisionMode,
+                              const CoarsePassPrecision coarsePassPrecision,
+                              const FinePassPrecision finePassPrecision,
+                              const bool withSha1Hash,
+                              const EnqFormatVer enqFormatVer)
+{
+    return PackTilesImpl::encodeWeightBuffer(activePixels,
+                                             weightBufferTiled,
+                                             output,
+                                             precisionMode,
+                                             coarsePassPrecision,
+                                             finePassPrecision,
+                                             withSha1Hash,
+                                             enqFormatVer);
+}
+
 // static function
 bool
 PackTiles::decodeWeightBuffer(const void *addr,               // in
@@ -4496,6 +4671,40 @@ PackTiles::encodeRenderOutput(const ActivePixels &activePixels,
                                              withSha1Hash,
                                              enqFormatVer);
 }
+
+// static function
+size_t
+PackTiles::encodeRenderOutput(const ActivePixels &activePixels,
+                              const VariablePixelBuffer &renderOutputBufferTiled, // non normalized value
+                              const float renderOutputBufferDefaultValue,
+                              const FloatBuffer &renderOutputWeightBufferTiled,
+                              rdl2::ValueContainerSink &output,
+                              const PrecisionMode precisionMode,
+                              const bool noNumSampleMode,
+                              const bool doNormalizeMode,
+                              const bool closestFilterStatus,
+                              const unsigned closestFilterAovOriginalNumChan,
+                              const CoarsePassPrecision coarsePassPrecision,
+                              const FinePassPrecision finePassPrecision,
+                              const bool withSha1Hash,
+                              const EnqFormatVer enqFormatVer)
+// closestFilterAovOriginalNumChan is only used when closestFilterStatus is true
+{
+    return PackTilesImpl::encodeRenderOutput(activePixels,
+                                             renderOutputBufferTiled,
+                                             renderOutputBufferDefaultValue,
+                                             renderOutputWeightBufferTiled,
+                                             output,
+                                             precisionMode,
+                                             noNumSampleMode,
+                                             doNormalizeMode,
+                                             closestFilterStatus,
+                                             closestFilterAovOriginalNumChan,
+                                             coarsePassPrecision,
+                                             finePassPrecision,
+                                             withSha1Hash,
+                                             enqFormatVer);
+}
     
 // for mcrt_dataio::MergeFbSender (progmcrtmerge)
 // VariableValue(float1|float2|float3|float4)
@@ -4524,6 +4733,31 @@ PackTiles::encodeRenderOutputMerge(const ActivePixels &activePixels,
                                                   enqFormatVer);
 }
 
+// static function
+size_t
+PackTiles::encodeRenderOutputMerge(const ActivePixels &activePixels,
+                                   const VariablePixelBuffer &renderOutputBufferTiled, // normalized
+                                   const float renderOutputBufferDefaultValue,
+                                   rdl2::ValueContainerSink &output,
+                                   const PrecisionMode precisionMode,
+                                   const bool closestFilterStatus,
+                                   const CoarsePassPrecision coarsePassPrecision,
+                                   const FinePassPrecision finePassPrecision,
+                                   const bool withSha1Hash,
+                                   const EnqFormatVer enqFormatVer)
+{
+    return PackTilesImpl::encodeRenderOutputMerge(activePixels,
+                                                  renderOutputBufferTiled,
+                                                  renderOutputBufferDefaultValue,
+                                                  output,
+                                                  precisionMode,
+                                                  closestFilterStatus,
+                                                  coarsePassPrecision,
+                                                  finePassPrecision,
+                                                  withSha1Hash,
+                                                  enqFormatVer);
+}
+
 // VariableValue(float1|float2|float3|float4) + numSample : float * (1|2|3|4) + u_int
 // or
 // VariableValue(float1|float2|float3|float4)             : float * (1|2|3|4)
@@ -4557,6 +4791,16 @@ PackTiles::encodeRenderOutputReference(const FbReferenceType &referenceType,
 {
     return PackTilesImpl::encodeRenderOutputReference(referenceType, output, withSha1Hash, enqFormatVer);
 }
+
+// static function
+size_t
+PackTiles::encodeRenderOutputReference(const FbReferenceType &referenceType,
+                                       rdl2::ValueContainerSink &output,
+                                       const bool withSha1Hash,
+                                       const EnqFormatVer enqFormatVer)
+{
+    return PackTilesImpl::encodeRenderOutputReference(referenceType, output, withSha1Hash, enqFormatVer);
+}
     
 // static function
 bool
@@ -39,6 +39,7 @@ namespace scene_rdl2 {
 namespace rdl2 {
     class ValueContainerDeq;
     class ValueContainerEnq;
+    class ValueContainerSink;
 }
 
 namespace grid_util {
@@ -106,6 +107,10 @@ public:
 
     static DataType decodeDataType(const void *addr, const size_t dataSize);
 
+    // Every encode API has 2 versions. One appends the encoded data to a std::string and another
+    // streams it to a rdl2::ValueContainerSink (i.e. chunk chain or file) without building one
+    // big contiguous std::string. Both of them create exactly the same byte sequence.
+
     //------------------------------
     //
     // RenderBuffer (beauty/alpha) / RenderBufferOdd (beautyAux/alphaAux)
@@ -125,6 +130,18 @@ public:
            const bool noNumSampleMode,
            const bool withSha1Hash = false,
            const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encode(const bool renderBufferOdd,
+           const ActivePixels &activePixels,      // constructed by original w, h
+           const RenderBuffer &renderBufferTiled, // tile aligned reso : non normalized color
+           const FloatBuffer &weightBufferTiled,  // tile aligned resolution
+           rdl2::ValueContainerSink &output,
+           const PrecisionMode precisionMode,             // current precision mode
+           const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
+           const FinePassPrecision finePassPrecision,     // minimum fine pass precision
+           const bool noNumSampleMode,
+           const bool withSha1Hash = false,
+           const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     // for McrtMergeComputation
     // RGBA : float * 4
@@ -138,6 +155,16 @@ public:
            const FinePassPrecision finePassPrecision,     // minimum fine pass precision
            const bool withSha1Hash = false,
            const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encode(const bool renderBufferOdd,
+           const ActivePixels &activePixels,      // constructed by original w, h
+           const RenderBuffer &renderBufferTiled, // tile aligned reso : normalized color
+           rdl2::ValueContainerSink &output,
+           const PrecisionMode precisionMode,             // current precision mode
+           const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
+           const FinePassPrecision finePassPrecision,     // minimum fine pass precision
+           const bool withSha1Hash = false,
+           const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     // RGBA + numSample : float * 4 + u_int
     static bool
@@ -177,6 +204,15 @@ public:
                     const FinePassPrecision finePassPrecision,     // minimum fine pass precision
                     const bool withSha1Hash = false,
                     const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodePixelInfo(const ActivePixels &activePixels,
+                    const PixelInfoBuffer &pixelInfoBufferTiled,
+                    rdl2::ValueContainerSink &output,
+                    const PrecisionMode precisionMode,             // current precision mode
+                    const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
+                    const FinePassPrecision finePassPrecision,     // minimum fine pass precision
+                    const bool withSha1Hash = false,
+                    const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     static bool
     decodePixelInfo(const void *addr,                         // in
@@ -202,6 +238,14 @@ public:
                   const bool noNumSampleMode,
                   const bool withSha1Hash = false,
                   const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodeHeatMap(const ActivePixels &activePixels,
+                  const FloatBuffer &heatMapSecBufferTiled, // non normalize sec
+                  const FloatBuffer &heatMapWeightBufferTiled,
+                  rdl2::ValueContainerSink &output,
+                  const bool noNumSampleMode,
+                  const bool withSha1Hash = false,
+                  const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     // Sec : float * 1
     // no precision related argument because heatMap always uses H16
@@ -211,6 +255,12 @@ public:
                   std::string &output,
                   const bool withSha1Hash = false,
                   const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodeHeatMap(const ActivePixels &activePixels,
+                  const FloatBuffer &heatMapSecBufferTiled, // normalize sec
+                  rdl2::ValueContainerSink &output,
+                  const bool withSha1Hash = false,
+                  const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     // Sec + numSample : float * 1 + u_int
     // no precision related argument because heatMap always uses H16
@@ -246,6 +296,15 @@ public:
                        const FinePassPrecision finePassPrecision,     // minimum fine pass precision
                        const bool withSha1Hash = false,
                        const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodeWeightBuffer(const ActivePixels &activePixels,
+                       const FloatBuffer &weightBufferTiled,
+                       rdl2::ValueContainerSink &output,
+                       const PrecisionMode precisionMode,             // current precision mode
+                       const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
+                       const FinePassPrecision finePassPrecision,     // minimum fine pass precision
+                       const bool withSha1Hash = false,
+                       const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     static bool
     decodeWeightBuffer(const void *addr,               // in
@@ -280,6 +339,21 @@ public:
                        const FinePassPrecision finePassPrecision,      // minimum fine pass precision
                        const bool withSha1Hash = false,
                        const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodeRenderOutput(const ActivePixels &activePixels,
+                       const VariablePixelBuffer &renderOutputBufferTiled, // non normalized value
+                       const float renderOutputBufferDefaultValue,
+                       const FloatBuffer &renderOutputWeightBufferTiled,
+                       rdl2::ValueContainerSink &output,
+                       const PrecisionMode precisionMode, // current precision mode
+                       const bool noNumSampleMode,
+                       const bool doNormalizeMode,
+                       const bool closestFilterStatus,
+                       const unsigned closestFilterAovOriginalNumChan, // only use closestFilter on
+                       const CoarsePassPrecision coarsePassPrecision,  // minimum coarse pass precision
+                       const FinePassPrecision finePassPrecision,      // minimum fine pass precision
+                       const bool withSha1Hash = false,
+                       const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
     // for mcrt_dataio::MergeFbSender (progmcrtmerge)
     // VariableValue(float1|float2|float3|float4)
     static size_t
@@ -293,6 +367,17 @@ public:
                             const FinePassPrecision finePassPrecision,     // minimum fine pass precision
                             const bool withSha1Hash = false,
                             const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodeRenderOutputMerge(const ActivePixels &activePixels,
+                            const VariablePixelBuffer &renderOutputBufferTiled, // normalized value
+                            const float renderOutputBufferDefaultValue,
+                            rdl2::ValueContainerSink &output,
+                            const PrecisionMode precisionMode, // current precision mode
+                            const bool closestFilterStatus,
+                            const CoarsePassPrecision coarsePassPrecision, // minimum coarse pass precision
+                            const FinePassPrecision finePassPrecision,     // minimum fine pass precision
+                            const bool withSha1Hash = false,
+                            const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
 
     // VariableValue(float1|float2|float3|float4) + numSample : float * (1|2|3|4) + u_int
     // or
@@ -314,6 +399,11 @@ public:
                                 std::string &output,
                                 const bool withSha1Hash = false,
                                 const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
+    static size_t
+    encodeRenderOutputReference(const FbReferenceType &referenceType,
+                                rdl2::ValueContainerSink &output,
+                                const bool withSha1Hash = false,
+                                const EnqFormatVer enqFormatVer = EnqFormatVer::VER2);
     static bool
     decodeRenderOutputReference(const void *addr, const size_t dataSize, // input
                                 FbAovShPtr &fbAov, // output
@@ -11,6 +11,8 @@
 #include "PackActiveTiles.h"
 
 #include <scene_rdl2/common/fb_util/ActivePixels.h>
+#include <scene_rdl2/common/fb_util/TileExtrapolation.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
 
 #include <fstream>
 
@@ -237,6 +239,75 @@ PackTilesTest::replaySnapshotDelta_dumpActivePixPos(const std::string &filename,
               << " done" << std::endl;
 }
 
+// static function
+void
+PackTilesTest::replaySnapshotDeltaExtrapolation(const std::string &filename)
+{
+    // Typically, cerr output from this function will be used by gnuplot.
+    // So we output start by # symbol about comment information.
+
+    std::cerr << "#>> PackTilestest.cc replaySnapshotDeltaExtrapolation() filename:" << filename
+              << " start" << std::endl;
+
+    ActivePixelsArray activePixelsArray;
+    if (!readActivePixelsArray(filename, activePixelsArray)) {
+        std::cerr << "read activePixelsArray failed." << std::endl;
+        return;
+    }
+    if (!activePixelsArray.size()) return;
+
+    //------------------------------
+
+    fb_util::TileExtrapolation tileExtrapolation;
+    tileExtrapolation.setCacheStats(true);
+
+    fb_util::ActivePixels accumulated;
+    accumulated.init(activePixelsArray.get(0).getWidth(), activePixelsArray.get(0).getHeight());
+    accumulated.reset();
+
+    std::cerr << "# 1      2               3          4          5          6" << std::endl;
+    std::cerr << "# coarse partialTileTotal searchTime cachedTime presetHit% cacheHit%" << std::endl;
+
+    const uint64_t fullMask = ~static_cast<uint64_t>(0x0);
+    int pixIdArray[64];
+    float searchTimeTotal = 0.0f;
+    float cachedTimeTotal = 0.0f;
+    for (size_t i = 0; i < activePixelsArray.size(); ++i) {
+        if (!accumulated.orOp(activePixelsArray.get(i))) continue; // different resolution
+
+        std::vector<uint64_t> masks;
+        for (unsigned tileId = 0; tileId < accumulated.getNumTiles(); ++tileId) {
+            const uint64_t mask = accumulated.getTileMask(tileId);
+            if (mask && mask != fullMask) masks.push_back(mask);
+        }
+
+        rec_time::RecTime recTime;
+        recTime.start();
+        for (uint64_t mask : masks) tileExtrapolation.searchActiveNearestPixel(mask, pixIdArray);
+        const float searchTime = recTime.end() * 1000.0f; // millisec
+
+        tileExtrapolation.resetCacheStats();
+        recTime.start();
+        for (uint64_t mask : masks) tileExtrapolation.searchActiveNearestPixelCached(mask, pixIdArray);
+        const float cachedTime = recTime.end() * 1000.0f; // millisec
+
+        const float total = std::max(static_cast<float>(masks.size()), 1.0f);
+        std::cerr << activePixelsArray.getCoarsePass(i) << ' '
+                  << masks.size() << ' '
+                  << searchTime << ' '
+                  << cachedTime << ' '
+                  << static_cast<float>(tileExtrapolation.getCachePresetHit()) / total * 100.0f << ' '
+                  << static_cast<float>(tileExtrapolation.getCacheHit()) / total * 100.0f << std::endl;
+        searchTimeTotal += searchTime;
+        cachedTimeTotal += cachedTime;
+    }
+
+    std::cerr << "# searchTimeTotal:" << searchTimeTotal << " ms"
+              << " cachedTimeTotal:" << cachedTimeTotal << " ms" << std::endl;
+    std::cerr << "#>> PackTilestest.cc replaySnapshotDeltaExtrapolation() filename:" << filename
+              << " done" << std::endl;
+}
+
 } // namespace grid_util
 } // namespace scene_rdl2
 
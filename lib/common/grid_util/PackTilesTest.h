@@ -70,6 +70,18 @@ public:
     //   snapshotDeltaRecDump file : output snapshotDelta rec info to the file. required "stop" first.
     //
     static void replaySnapshotDelta_dumpActivePixPos(const std::string &filename, const unsigned snapshotId);
+
+    //
+    // TileExtrapolation timing test using already dumped ActivePixelsArray data
+    //   search : TileExtrapolation::searchActiveNearestPixel()
+    //   cached : TileExtrapolation::searchActiveNearestPixelCached()
+    //
+    // Each snapshot is ORed into the accumulated ActivePixels (same as the Fb on the receiver side)
+    // and all the partially active tiles of the accumulated ActivePixels are extrapolated.
+    // The cache hit rate of each snapshot is also shown.
+    // See replaySnapshotDelta() about how to create the snapshotDeltaDump file.
+    //
+    static void replaySnapshotDeltaExtrapolation(const std::string &filename);
 };
 
 } // namespace grid_util
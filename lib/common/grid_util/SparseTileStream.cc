@@ -0,0 +1,138 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "SparseTileStream.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/render/util/StrUtil.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerDeq.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerEnq.h>
+
+#include <algorithm>
+
+namespace scene_rdl2 {
+namespace grid_util {
+
+namespace {
+
+void
+verifyTileFormat(const fb_util::VariablePixelBuffer &tiledBuffer, const char *funcName)
+{
+    const fb_util::VariablePixelBuffer::Format format = tiledBuffer.getFormat();
+    if (format == fb_util::VariablePixelBuffer::UNINITIALIZED ||
+        fb_util::VariablePixelBuffer::isVarianceFormat(format)) {
+        throw except::RuntimeError(str_util::stringCat("SparseTileStream::", funcName,
+                                                       "() unsupported format:",
+                                                       std::to_string(static_cast<unsigned>(format))));
+    }
+}
+
+} // namespace
+
+// static function
+void
+SparseTileStream::enqTiles(const VariablePixelBuffer &tiledBuffer,
+                           const std::vector<unsigned> &tileIds,
+                           VContainerEnq &vContainerEnq,
+                           const bool parallel)
+{
+    verifyTileFormat(tiledBuffer, "enqTiles");
+    MNRY_ASSERT(tiledBuffer.getWidth() % 8 == 0 && tiledBuffer.getHeight() % 8 == 0);
+
+    vContainerEnq.enqUInt(static_cast<unsigned>(tiledBuffer.getFormat()));
+    vContainerEnq.enqUInt(tiledBuffer.getWidth());
+    vContainerEnq.enqUInt(tiledBuffer.getHeight());
+
+    // dirty tiles are sorted, so delta of tileIds is mostly 1 byte by stream VByte coding.
+    std::vector<unsigned> deltaIds(tileIds.size());
+    unsigned prevId = 0;
+    for (size_t i = 0; i < tileIds.size(); ++i) {
+        deltaIds[i] = tileIds[i] - prevId; // wrap around is fine for unsorted tileIds
+        prevId = tileIds[i];
+    }
+    vContainerEnq.enqStreamVByteUIntVector(deltaIds);
+
+    if (tileIds.empty()) return;
+    const size_t tileBytes = static_cast<size_t>(tiledBuffer.getSizeOfPixel()) * 64;
+    for (size_t start = 0; start < tileIds.size(); start += sBatchTiles) {
+        const size_t numTiles = std::min(sBatchTiles, tileIds.size() - start);
+        uint8_t *dst = static_cast<uint8_t *>(vContainerEnq.enqReserveMem(numTiles * tileBytes));
+        if (!tiledBuffer.packSparseTiles(dst, &tileIds[start], numTiles, parallel)) {
+            throw except::RuntimeError("SparseTileStream::enqTiles() packSparseTiles failed");
+        }
+    }
+}
+
+// static function
+size_t
+SparseTileStream::enqDirtyTiles(const VariablePixelBuffer &tiledBuffer,
+                                DirtyTileTracker &tracker,
+                                VContainerEnq &vContainerEnq,
+                                const bool parallel)
+{
+    verifyTileFormat(tiledBuffer, "enqDirtyTiles");
+    MNRY_ASSERT(tracker.getNumTiles() == tiledBuffer.getArea() / 64);
+
+    std::vector<unsigned> tileIds;
+    tracker.extractDirtyTileIds(tileIds);
+    enqTiles(tiledBuffer, tileIds, vContainerEnq, parallel);
+    return tileIds.size();
+}
+
+// static function
+void
+SparseTileStream::deqTiles(VContainerDeq &vContainerDeq,
+                           VariablePixelBuffer &tiledBuffer,
+                           std::vector<unsigned> *tileIds,
+                           const bool parallel)
+{
+    unsigned format, width, height;
+    vContainerDeq.deqUInt(format);
+    vContainerDeq.deqUInt(width);
+    vContainerDeq.deqUInt(height);
+    if (format >= static_cast<unsigned>(VariablePixelBuffer::NUM_FORMATS) ||
+        VariablePixelBuffer::isVarianceFormat(static_cast<VariablePixelBuffer::Format>(format)) ||
+        (width % 8) != 0 || (height % 8) != 0) {
+        throw except::RuntimeError(str_util::stringCat("SparseTileStream::deqTiles() broken data."
+                                                       " format:", std::to_string(format),
+                                                       " width:", std::to_string(width),
+                                                       " height:", std::to_string(height)));
+    }
+
+    std::vector<unsigned> work;
+    std::vector<unsigned> &ids = (tileIds) ? *tileIds : work;
+    vContainerDeq.deqStreamVByteUIntVector(ids);
+    const unsigned numTilesTotal = (width >> 3) * (height >> 3);
+    unsigned currId = 0;
+    for (unsigned &id : ids) {
+        currId += id;
+        if (currId >= numTilesTotal) {
+            throw except::RuntimeError(str_util::stringCat("SparseTileStream::deqTiles() broken data."
+                                                           " tileId:", std::to_string(currId),
+                                                           " numTiles:", std::to_string(numTilesTotal)));
+        }
+        id = currId;
+    }
+
+    const VariablePixelBuffer::Format fmt = static_cast<VariablePixelBuffer::Format>(format);
+    if (tiledBuffer.getFormat() != fmt ||
+        tiledBuffer.getWidth() != width || tiledBuffer.getHeight() != height) {
+        tiledBuffer.init(fmt, width, height);
+        tiledBuffer.clear();
+    }
+
+    if (ids.empty()) return;
+    const size_t tileBytes = static_cast<size_t>(tiledBuffer.getSizeOfPixel()) * 64;
+    for (size_t start = 0; start < ids.size(); start += sBatchTiles) {
+        const size_t numTiles = std::min(sBatchTiles, ids.size() - start);
+        const uint8_t *src = static_cast<const uint8_t *>(vContainerDeq.skipByteData(numTiles * tileBytes));
+        if (!tiledBuffer.unpackSparseTiles(src, &ids[start], numTiles, parallel)) {
+            throw except::RuntimeError("SparseTileStream::deqTiles() unpackSparseTiles failed");
+        }
+    }
+}
+
+} // namespace grid_util
+} // namespace scene_rdl2
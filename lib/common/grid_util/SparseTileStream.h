@@ -0,0 +1,74 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+//
+// -- Streaming sparse tiles of a tiled VariablePixelBuffer into ValueContainerEnq --
+//
+// Packs the selected 8x8 tiles of a tiled buffer directly into the ValueContainerEnq buffer
+// (or the staging buffer of a ValueContainerSink) without an intermediate packed buffer.
+// Tiles are packed batch by batch, so a sink flushes the packed data while the following tiles
+// are packed and the staging buffer does not need to hold the whole packed image.
+// Combined with fb_util::DirtyTileTracker, only the tiles which are changed since the last
+// send are encoded.
+//
+// Data layout
+//   format, width, height : variable length unsigned int (tile aligned width and height)
+//   tileIds               : stream VByte coded delta of coarse tile ids
+//   pixel data            : numTiles * 64 * sizeOfPixel byte, tileIds order
+//
+
+#include <scene_rdl2/common/fb_util/DirtyTileTracker.h>
+#include <scene_rdl2/common/fb_util/VariablePixelBuffer.h>
+
+#include <vector>
+
+namespace scene_rdl2 {
+
+namespace rdl2 {
+    class ValueContainerDeq;
+    class ValueContainerEnq;
+}
+
+namespace grid_util {
+
+class SparseTileStream
+{
+public:
+    using DirtyTileTracker = fb_util::DirtyTileTracker;
+    using VariablePixelBuffer = fb_util::VariablePixelBuffer;
+
+    using VContainerDeq = rdl2::ValueContainerDeq;
+    using VContainerEnq = rdl2::ValueContainerEnq;
+
+    static constexpr size_t sBatchTiles = 1024; // number of tiles packed at once
+
+    // tiledBuffer should be tile aligned resolution.
+    // throw except::RuntimeError if the format is UNINITIALIZED or a variance format
+    // (VariablePixelBuffer::isVarianceFormat()) which has no raw tile data.
+    static void enqTiles(const VariablePixelBuffer &tiledBuffer,
+                         const std::vector<unsigned> &tileIds,
+                         VContainerEnq &vContainerEnq,
+                         const bool parallel);
+
+    // enqueue the tiles which are marked since the last call and clear them.
+    // Return the number of enqueued tiles. Throws like enqTiles() and keeps the tiles marked.
+    static size_t enqDirtyTiles(const VariablePixelBuffer &tiledBuffer,
+                                DirtyTileTracker &tracker,
+                                VContainerEnq &vContainerEnq,
+                                const bool parallel);
+
+    // Decode and update the tiles of tiledBuffer. tiledBuffer is initialized (and cleared)
+    // if the format or resolution is different. tileIds returns updated tiles if not null.
+    // throw except::RuntimeError if the data is broken or has a variance format.
+    static void deqTiles(VContainerDeq &vContainerDeq,
+                         VariablePixelBuffer &tiledBuffer,
+                         std::vector<unsigned> *tileIds,
+                         const bool parallel);
+};
+
+} // namespace grid_util
+} // namespace scene_rdl2
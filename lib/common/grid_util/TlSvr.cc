@@ -9,12 +9,16 @@
 
 #include <scene_rdl2/render/util/StrUtil.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
 #include <fcntl.h>              // ::fcntl()
 #include <netinet/in.h>         // struct sockaddr_in
 #include <netinet/tcp.h>        // TCP_NODELAY
 #include <string.h>
+#include <sys/epoll.h>          // ::epoll_create1()
+#include <sys/eventfd.h>        // ::eventfd()
 #include <sys/socket.h>         // ::socket()
 #include <unistd.h>             // ::read()
 
@@ -26,10 +30,14 @@ static constexpr const char *msgHead = ">TLSvr<"; // message head strings for *M
 TlSvr::TlSvr() :
     mPort(-1),
     mBaseSock(-1),
-    mSock(-1),
-    mConnectionReady(false),
-    mRecvSize(0),
-    mEndLine(false)
+    mEpollFd(-1),
+    mWakeupFd(-1),
+    mSendKickFd(-1),
+    mSendKickPending(false),
+    mClientIdNext(1),
+    mCurrClientId(0),
+    mDroppedSendSize(0),
+    mEofTotal(0)
 {
 }
 
@@ -50,10 +58,25 @@ TlSvr::open(const int serverPortNum,
 {
     mPort = serverPortNum; // You can use 0 for auto port search by kernel
 
+    //
+    // wakeup() and send() might be called before the server port is opened (delayed open).
+    // So eventfds are created here.
+    //
+    if (mWakeupFd == -1 || mSendKickFd == -1) {
+        if (mWakeupFd == -1) mWakeupFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mSendKickFd == -1) mSendKickFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mWakeupFd == -1 || mSendKickFd == -1) {
+            if (errMsgCallBack) {
+                errMsgCallBack(str_util::stringCat(msgHead, " ::eventfd() failed. ",
+                                                   "errno:", std::to_string(errno), " ", strerror(errno)));
+            }
+            return 0;           // error
+        }
+    }
+
     if (mPort == 0) {
         // server port open
         if (!setupServerPort(infoMsgCallBack, errMsgCallBack)) {
-            mConnectionReady = false;
             return 0;           // error
         }
     }
@@ -62,188 +85,220 @@ TlSvr::open(const int serverPortNum,
 }
 
 int
-TlSvr::recv(std::string &recvStr,
-            INFOMSG_CALLBACK infoMsgCallBack,
-            ERRMSG_CALLBACK errMsgCallBack)
+TlSvr::recvWait(std::string &recvStr,
+                const int timeoutMs,
+                INFOMSG_CALLBACK infoMsgCallBack,
+                ERRMSG_CALLBACK errMsgCallBack)
 //
-// return recv total byte. non blocking function.
+// return recv total byte.
 // return size does not include last 0x0
 //    0 : empty
-//   -1 : EOF
+//   -1 : EOF : one of the clients closed connection
 //   -2 : ERROR : other error
 //
 {
-    if (!mConnectionReady) {
-        if (!setupServerPort(infoMsgCallBack, errMsgCallBack)) {
-            mConnectionReady = false;
-            return -2;          // error
-        }
-
-        if (mSock == -1) {
-            mConnectionReady = false;
-            return 0;          // still no incoming socket -> return empty status
-        }
-
-        mConnectionReady = true; // connection establised
-        mRecvSize = 0;           // receive size initialize
-        recvStr = "";
+    if (mPort == -1) {
+        return 0;               // not opened : skip
     }
-
-    //
-    // socket data check by select
-    //
-    switch (socketCheck(errMsgCallBack)) {
-    case 1 :                    // active
-        break;
-    case 0 :                    // empty
-        return 0;
-    case -1 :                   // error
+    if (!setupServerPort(infoMsgCallBack, errMsgCallBack)) {
         return -2;              // error
     }
 
-    //
-    // read data
-    //
-    if (mEndLine) {
-        mRecvSize = 0;          // previous session was ended by '\n'
-        mEndLine = false;
-        recvStr = "";
+    if (popLine(recvStr)) return static_cast<int>(recvStr.size());
+    if (mEofTotal) {
+        mEofTotal--;
+        return -1;              // EOF
     }
 
-    char c;
-    while (1) {
-        int rSize = static_cast<int>(::read(mSock, &c, 1)); // read 1byte
-
-        if (rSize == 0) {
-            if (mRecvSize == 0) {
-                connectionClosed(infoMsgCallBack);
-                return -1;      // EOF
-            } else {
-                recvStr += '\n';
-                mEndLine = true;
-                mRecvSize++;
-            }
-            
-        } else if (rSize == 1) {
-            if (c == '\r') {    // 0xd : CR
-                continue;       // skip \r
-            }
-
-            recvStr += c;
-
-            mRecvSize++;
+    //
+    // Send kick only writes the send buffers and does not return to the caller. So keep waiting
+    // until the other event happens or timeoutMs is over.
+    //
+    const auto startTime = std::chrono::steady_clock::now();
+    while (true) {
+        int waitMs = timeoutMs;
+        if (timeoutMs > 0) {
+            const auto elapsedMs =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                      startTime).count();
+            waitMs = std::max(0, timeoutMs - static_cast<int>(elapsedMs));
+        }
 
-            if (c == 0x0) {
-                recvStr += '\n';
-                mEndLine = true;
-                mRecvSize++;
-                break;          // end message
-                
-            } else if (c == '\n') {
-                mEndLine = true;
-                break;          // end line
+        constexpr int maxEvents = 16;
+        struct epoll_event events[maxEvents];
+        int eventTotal = ::epoll_wait(mEpollFd, events, maxEvents, waitMs);
+        if (eventTotal < 0) {
+            if (errno == EINTR) return 0; // interrupted by signal : empty
+            if (errMsgCallBack) {
+                errMsgCallBack(str_util::stringCat(msgHead, " ::epoll_wait() failed. ",
+                                                   "errno:", std::to_string(errno), " ", strerror(errno)));
             }
+            return -2;              // error
+        }
 
-        } else {
-            if (rSize < 0) {
-                if (errno == EAGAIN) {
-                    return 0;  // empty : try again
-
-                } else if (errno == EBADF) {
-                    //
-                    // Probably other side of socket process is killed somehow.
-                    //
-                    connectionClosed(infoMsgCallBack);
-                    return -1;  // EOF
-
-                } else {
-                    //
-                    // error
-                    //
-                    if (errMsgCallBack) {
-                        errMsgCallBack
-                            (str_util::stringCat(msgHead, " unknown socket receive error. ",
-                                                 "errno:", std::to_string(errno), " ", strerror(errno)));
-                    }
-                    return -2;  // error
+        bool returnToCaller = (eventTotal == 0 || timeoutMs == 0); // timeout or non blocking
+        for (int i = 0; i < eventTotal; ++i) {
+            const int fd = events[i].data.fd;
+            const uint32_t ev = events[i].events;
+            if (fd == mWakeupFd) {
+                uint64_t count;
+                (void)::read(mWakeupFd, &count, sizeof(count)); // reset eventfd counter
+                returnToCaller = true;
+
+            } else if (fd == mSendKickFd) {
+                uint64_t count;
+                (void)::read(mSendKickFd, &count, sizeof(count)); // reset eventfd counter
+                flushAllSend(infoMsgCallBack);
+
+            } else if (fd == mBaseSock) {
+                if (!acceptSocket(infoMsgCallBack, errMsgCallBack)) {
+                    return -2;      // error
                 }
+                returnToCaller = true;
+
             } else {
-                if (errMsgCallBack) {
-                    errMsgCallBack(str_util::stringCat(msgHead, " unknown socket receive error. ",
-                                                       "recvSize:", std::to_string(rSize)));
+                //
+                // Only this thread adds or removes the clients. So client is valid without mMutex
+                // and socket read/write is done without mMutex.
+                //
+                Client *client = findClient(fd);
+                if (!client) continue; // already closed
+
+                bool alive = true;
+                if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    alive = readSocket(client, errMsgCallBack);
+                    returnToCaller = true;
+                }
+                if (alive && (ev & EPOLLOUT)) {
+                    alive = flushSend(client);
+                }
+                if (!alive) {
+                    connectionClosed(client, infoMsgCallBack);
+                    mEofTotal++;
+                    returnToCaller = true;
                 }
-                return -2;      // error
             }
         }
+        if (returnToCaller || !mRecvLines.empty() || mEofTotal) break;
     }
 
-    if (mEndLine) {
-        return mRecvSize;
+    if (popLine(recvStr)) return static_cast<int>(recvStr.size());
+    if (mEofTotal) {
+        mEofTotal--;
+        return -1;              // EOF
     }
+    return 0;                   // empty or data is not terminated by '\n' yet.
+}
 
-    return 0;                  // empty or data is not terminated by '\n' yet.
+void
+TlSvr::wakeup()
+{
+    if (mWakeupFd != -1) {
+        uint64_t one = 1;
+        (void)::write(mWakeupFd, &one, sizeof(one));
+    }
 }
 
 bool
 TlSvr::send(const std::string &sendStr,
-            INFOMSG_CALLBACK infoMsgCallBack,
-            ERRMSG_CALLBACK errMsgCallBack )
+            INFOMSG_CALLBACK /*infoMsgCallBack*/,
+            ERRMSG_CALLBACK /*errMsgCallBack*/)
+//
+// Only appends to the send buffer. Socket write is done by the recvWait() thread.
+//
 {
-    if (!mConnectionReady) {
-        return true;            // not ready to send -> skip
-    }
-
-    const char* cPtr = sendStr.c_str();
-    int size = (int)sendStr.size();
-    while (1) {
-        int wSize = static_cast<int>(::write(mSock, cPtr, size));
-        if (wSize == 0) {
-            continue;           // retry 
-        } else if (wSize < 0) {
-            if (errno == EAGAIN) continue;       // retry
-            if (errno == EINTR) continue;        // retry
-            if (errno == EPIPE) { // Broken pipe
-                connectionClosed(infoMsgCallBack); // Probably other side of connection may be closed.
-                return false;
-            } else {
-                if (errMsgCallBack) {
-                    errMsgCallBack
-                        (str_util::stringCat(msgHead, " unknown socket send error. ",
-                                             " errno:", std::to_string(errno), " ", strerror(errno)));
-                }
-                connectionClosed(infoMsgCallBack);
-                return false;
+    bool kick = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mClients.empty()) {
+            return true;        // not ready to send -> skip
+        }
+
+        if (mCurrClientId) {
+            auto itr = std::find_if(mClients.begin(), mClients.end(),
+                                    [&](const std::unique_ptr<Client> &client) {
+                                        return client->mId == mCurrClientId;
+                                    });
+            if (itr == mClients.end()) {
+                return false;   // connection closed
             }
+            kick = enqSend(itr->get(), sendStr);
         } else {
-            size -= wSize;
-            if (size == 0) break; // sent all -> finish
-            cPtr = (const char*)((uintptr_t)cPtr + (uintptr_t)wSize);
+            for (auto &client : mClients) {
+                if (enqSend(client.get(), sendStr)) kick = true;
+            }
         }
-    } // while(1)
+    }
+    if (kick) kickSend();
+    return true;
+}
 
+bool
+TlSvr::broadcast(const std::string &sendStr)
+{
+    bool kick = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto &client : mClients) {
+            if (enqSend(client.get(), sendStr)) kick = true;
+        }
+    }
+    if (kick) kickSend();
     return true;
 }
 
 void
 TlSvr::close()
 {
-    if (mSock != -1) {
-        ::close(mSock);
-        mSock = -1;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto &client : mClients) {
+            ::close(client->mSock);
+        }
+        mClients.clear();
+        mCurrClientId = 0;
+        mSendKickPending = false;
     }
+    mRecvLines.clear();
+    mEofTotal = 0;
 
     if (mBaseSock != -1) {
         ::close(mBaseSock);
         mBaseSock = -1;
     }
-
-    mConnectionReady = false;
+    if (mEpollFd != -1) {
+        ::close(mEpollFd);
+        mEpollFd = -1;
+    }
+    if (mWakeupFd != -1) {
+        ::close(mWakeupFd);
+        mWakeupFd = -1;
+    }
+    if (mSendKickFd != -1) {
+        ::close(mSendKickFd);
+        mSendKickFd = -1;
+    }
 }
 
 bool
 TlSvr::isConnectionEstablised() const
 {
-    return mConnectionReady;
+    return getClientTotal() > 0;
+}
+
+size_t
+TlSvr::getClientTotal() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mClients.size();
+}
+
+size_t
+TlSvr::getDroppedSendSize() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mDroppedSendSize;
 }
 
 //------------------------------------------------------------------------------
@@ -253,29 +308,46 @@ TlSvr::setupServerPort(INFOMSG_CALLBACK infoMsgCallBack,
                        ERRMSG_CALLBACK errMsgCallBack)
 {
     //
-    // setup server socket stuff by non blocking access
+    // setup server socket and epoll by non blocking access
     //
-    if (mSock == -1) {
-        if (mBaseSock == -1) {
-            if (mPort == -1) {
-                return true;    // skip
-            }
+    if (mBaseSock != -1) {
+        return true;            // already setup
+    }
+    if (mPort == -1) {
+        return true;            // skip
+    }
 
-            //
-            // and socket bind and listen again
-            // compute mBaseSock and mPort (if needed)
-            //
-            if (!socketBindAndListen(infoMsgCallBack, errMsgCallBack)) {
-                return false;
-            }
-        }
+    //
+    // socket bind and listen : compute mBaseSock and mPort (if needed)
+    //
+    if (!socketBindAndListen(infoMsgCallBack, errMsgCallBack)) {
+        return false;
+    }
 
-        // compute mSock
-        if (!acceptSocket(infoMsgCallBack, errMsgCallBack)) {
-            ::close(mBaseSock);
-            mBaseSock = -1;
-            return false;
+    auto epollAdd = [&](int fd) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        return ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    };
+
+    if (mEpollFd == -1) {
+        mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    }
+    if (mEpollFd == -1 || !epollAdd(mBaseSock) ||
+        (mWakeupFd != -1 && !epollAdd(mWakeupFd)) ||
+        (mSendKickFd != -1 && !epollAdd(mSendKickFd))) {
+        if (errMsgCallBack) {
+            errMsgCallBack(str_util::stringCat(msgHead, " epoll setup failed. ",
+                                               "errno:", std::to_string(errno), " ", strerror(errno)));
+        }
+        ::close(mBaseSock);
+        mBaseSock = -1;
+        if (mEpollFd != -1) {
+            ::close(mEpollFd);
+            mEpollFd = -1;
         }
+        return false;
     }
 
     return true;
@@ -388,123 +460,321 @@ TlSvr::socketBindAndListen(INFOMSG_CALLBACK infoMsgCallBack,
 
 bool
 TlSvr::acceptSocket(INFOMSG_CALLBACK infoMsgCallBack, ERRMSG_CALLBACK errMsgCallBack)
+//
+// accept all the pending incoming connections
+//
 {
-    if (mSock != -1) {
-        return true;
-    }
-
-    struct sockaddr_in in2;
-    unsigned int addrlen = sizeof(in2);
+    while (true) {
+        struct sockaddr_in in2;
+        unsigned int addrlen = sizeof(in2);
+
+        int sock = ::accept(mBaseSock, (struct sockaddr *)&in2, &addrlen);
+        if (sock == -1) {
+            int errNum = errno;
+            if (errNum == EAGAIN || errNum == EWOULDBLOCK) { // no more incoming connection
+                return true;
+            } else if (errNum == EINTR || errNum == ECONNABORTED) { // try again
+                continue;
+            } else {
+                if (errMsgCallBack) {
+                    errMsgCallBack
+                        (str_util::stringCat(msgHead, " ::accept() returns error. ",
+                                             "errno:", std::to_string(errNum), " ", strerror(errNum)));
+                }
+                return false;
+            }
+        }
 
-    if ((mSock = ::accept(mBaseSock, (struct sockaddr *)&in2, &addrlen)) == -1) {
-        int errNum = errno;
-        if (errNum == EAGAIN) { // Resource temporarily unavailable => retry later
-            return true;
-        } else {
+        if (getClientTotal() >= sMaxClients) {
+            ::close(sock);
             if (errMsgCallBack) {
-                errMsgCallBack
-                    (str_util::stringCat(msgHead, " ::accept() returns error. ",
-                                         "errno:", std::to_string(errNum), " ", strerror(errNum)));
+                errMsgCallBack(str_util::stringCat(msgHead, " too many clients. connection refused. ",
+                                                   "max:", std::to_string(sMaxClients)));
             }
+            continue;
+        }
 
-            // errNum = EINTR : interrupted by other system call -> we should try again ?
-            // Please check Unix Network Programming P.67
+        //
+        // Set the close-on-exec flag so that the socket will not get inherited by child processes.
+        //
+        ::fcntl(sock, F_SETFD, FD_CLOEXEC);
 
-            return false;
+        //
+        // set socket option
+        //
+        int optV = 1;               // true
+        int optL = sizeof(int);
+        if (::setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&optV, optL) < 0 ||
+            ::setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, (char*)&optV, optL) < 0 ||
+            !setSockBufferSize(sock, SOL_SOCKET, 64_KiB) ||
+            ::fcntl(sock, F_SETFL, FNDELAY) < 0) { // set non blocking
+            ::close(sock);
+            if (errMsgCallBack) {
+                errMsgCallBack(str_util::stringCat(msgHead, " set socket option for newSocket failed"));
+            }
+            continue;           // skip this connection and keep other clients working
         }
-    }
 
-    //
-    // set socket option
-    //
-    int optV = 1;               // true
-    int optL = sizeof(int);
-    if (::setsockopt(mSock, IPPROTO_TCP, TCP_NODELAY, (char*)&optV, optL) < 0) {
-        if (errMsgCallBack) {
-            errMsgCallBack(str_util::stringCat(msgHead, " set socket option (TCP_NODELAY) failed"));
-        }
-        return false;
-    }
-    if (::setsockopt(mSock, SOL_SOCKET, SO_KEEPALIVE, (char*)&optV, optL) < 0) {
-        if (errMsgCallBack) {
-            errMsgCallBack(str_util::stringCat(msgHead, " set socket option (SO_KEEPALIVE) failed"));
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = sock;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, sock, &ev) < 0) {
+            ::close(sock);
+            if (errMsgCallBack) {
+                errMsgCallBack(str_util::stringCat(msgHead, " ::epoll_ctl() failed for newSocket"));
+            }
+            continue;
         }
-        return false;
-    }
-    if (!setSockBufferSize(mSock, SOL_SOCKET, 64_KiB)) {
-        if (errMsgCallBack) {
-            errMsgCallBack(str_util::stringCat(msgHead, " setSockBufferSize failed"));
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClients.emplace_back(new Client(sock, mClientIdNext++));
         }
-        return false;
-    }
 
-    //
-    // set non blocking
-    //
-    if (::fcntl(mSock, F_SETFL, FNDELAY) < 0) {
-        if (errMsgCallBack) {
-            errMsgCallBack(str_util::stringCat(msgHead, " set non blocking status for newSocket failed"));
+        if (infoMsgCallBack) {
+            infoMsgCallBack
+                (str_util::stringCat(msgHead, " connection established. port:", std::to_string(mPort)));
         }
-        return false;
     }
+}
 
-    //------------------------------
+void
+TlSvr::connectionClosed(Client *client, INFOMSG_CALLBACK infoMsgCallBack)
+//
+// recvWait() thread only
+//
+{
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, client->mSock, nullptr);
+    ::close(client->mSock);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (client->mId == mCurrClientId) mCurrClientId = 0;
+        mClients.erase(std::find_if(mClients.begin(), mClients.end(),
+                                    [&](const std::unique_ptr<Client> &c) { return c.get() == client; }));
+    }
 
     if (infoMsgCallBack) {
-        infoMsgCallBack
-            (str_util::stringCat(msgHead, " connection established. port:", std::to_string(mPort)));
+        infoMsgCallBack(str_util::stringCat(msgHead, " connection closed at the other side. ",
+                                            "port:", std::to_string(mPort)));
     }
+}
 
-    //
-    // close base socket in order to refuse other connection.
-    //
-    ::close(mBaseSock);
-    mBaseSock = -1;
+bool
+TlSvr::readSocket(Client *client, ERRMSG_CALLBACK errMsgCallBack)
+//
+// Read all the available data and split them into lines. recvWait() thread only.
+// return false if connection is closed or error.
+//
+{
+    auto pushLine = [&]() {
+        mRecvLines.emplace_back(client->mId, std::move(client->mRecvBuff));
+        client->mRecvBuff.clear();
+    };
+
+    char buff[4096];
+    while (true) {
+        ssize_t rSize = ::read(client->mSock, buff, sizeof(buff));
+        if (rSize > 0) {
+            for (ssize_t i = 0; i < rSize; ++i) {
+                const char c = buff[i];
+                if (c == '\r') {    // 0xd : CR
+                    continue;       // skip \r
+                }
+                client->mRecvBuff += c;
+                if (c == 0x0) {
+                    client->mRecvBuff += '\n'; // end message
+                    pushLine();
+                } else if (c == '\n') {
+                    pushLine();     // end line
+                }
+            }
+            if (client->mRecvBuff.size() > sMaxRecvLineSize) {
+                // no '\n' for too long. Drop this client instead of growing the buffer forever.
+                if (errMsgCallBack) {
+                    errMsgCallBack
+                        (str_util::stringCat(msgHead, " receive line exceeds ",
+                                             std::to_string(sMaxRecvLineSize), " byte. close client. ",
+                                             "port:", std::to_string(mPort)));
+                }
+                client->mRecvBuff.clear();
+                return false;
+            }
+        } else if (rSize == 0) {
+            if (!client->mRecvBuff.empty()) {
+                client->mRecvBuff += '\n';
+                pushLine();         // last line which is not terminated by '\n'
+            }
+            return false;           // EOF
+        } else {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;        // read all
+            } else if (errno == EINTR) {
+                continue;           // retry
+            } else if (errno != EBADF && errno != ECONNRESET) {
+                // EBADF/ECONNRESET : Probably other side of socket process is killed somehow.
+                if (errMsgCallBack) {
+                    errMsgCallBack
+                        (str_util::stringCat(msgHead, " unknown socket receive error. ",
+                                             "errno:", std::to_string(errno), " ", strerror(errno)));
+                }
+            }
+            return false;
+        }
+    }
+}
+
+bool
+TlSvr::enqSend(Client *client, const std::string &sendStr)
+//
+// need mMutex. return true if the recvWait() thread needs to be kicked.
+//
+{
+    if (client->mSendBuff.size() + client->mOutPendingSize + sendStr.size() > sMaxSendBuffSize) {
+        mDroppedSendSize += sendStr.size(); // client does not read : drop instead of blocking
+        return false;
+    }
 
+    client->mSendBuff += sendStr;
+    if (client->mWaitWritable || mSendKickPending) {
+        return false;           // written by EPOLLOUT or by the kick which is already pending
+    }
+    mSendKickPending = true;
     return true;
 }
 
 void
-TlSvr::connectionClosed(INFOMSG_CALLBACK infoMsgCallBack)
+TlSvr::kickSend()
 {
-    ::close(mSock);
-    mSock = -1;
-    mConnectionReady = false;
+    if (mSendKickFd != -1) {
+        uint64_t one = 1;
+        (void)::write(mSendKickFd, &one, sizeof(one));
+    }
+}
 
-    if (infoMsgCallBack) {
-        infoMsgCallBack(str_util::stringCat(msgHead, " connection closed at the other side. ",
-                                            "port:", std::to_string(mPort)));
+void
+TlSvr::flushAllSend(INFOMSG_CALLBACK infoMsgCallBack)
+//
+// Write the send buffers of all the clients. recvWait() thread only.
+//
+{
+    std::vector<Client *> clients;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSendKickPending = false;
+        for (auto &client : mClients) {
+            if (!client->mSendBuff.empty() && !client->mWaitWritable) clients.push_back(client.get());
+        }
+    }
+
+    for (Client *client : clients) {
+        if (!flushSend(client)) {
+            connectionClosed(client, infoMsgCallBack);
+            mEofTotal++;
+        }
     }
 }
 
-int
-TlSvr::socketCheck(ERRMSG_CALLBACK errMsgCallBack)
+bool
+TlSvr::flushSend(Client *client)
+//
+// Write the send buffer as much as socket accepts without blocking. The rest is written
+// when EPOLLOUT is reported to recvWait(). recvWait() thread only. mMutex is only held to
+// take the send buffer and not held during ::send().
+// return false if connection is broken.
+//
 {
-    fd_set fdset;
-    FD_ZERO(&fdset);
-    FD_SET(mSock, &fdset);
-
-    struct timeval tv;
-    tv.tv_sec = 0;              // no timeout. mSock is non-blocking
-    tv.tv_usec = 0;
-
-    int ret = ::select(mSock + 1, &fdset, 0x0, 0x0, &tv);
-    if (ret == 0) {
-        return 0;               // empty
-    } else if (ret < 0) {
-        if (errMsgCallBack) {
-            errMsgCallBack(str_util::stringCat(msgHead, " ::select() failed. retCode=", std::to_string(ret)));
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (client->mOutOffset == client->mOutBuff.size()) {
+            client->mOutBuff.clear();
+            client->mOutOffset = 0;
+            client->mOutBuff.swap(client->mSendBuff); // no copy. keeps both capacities
+        } else {
+            client->mOutBuff += client->mSendBuff;
+            client->mSendBuff.clear();
         }
-        return -1;              // error
-    } else {
-        if (FD_ISSET(mSock, &fdset)) {
+        client->mOutPendingSize = client->mOutBuff.size() - client->mOutOffset;
+    }
+
+    bool alive = true;
+    while (client->mOutOffset < client->mOutBuff.size()) {
+        ssize_t wSize = ::send(client->mSock,
+                               client->mOutBuff.data() + client->mOutOffset,
+                               client->mOutBuff.size() - client->mOutOffset,
+                               MSG_NOSIGNAL);
+        if (wSize > 0) {
+            client->mOutOffset += static_cast<size_t>(wSize);
+        } else if (wSize < 0 && errno == EINTR) {
+            continue;           // retry
+        } else if (wSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
         } else {
-            return 0;           // empty
+            alive = false;      // EPIPE etc. Probably other side of connection may be closed.
+            break;
+        }
+    }
+    if (!alive) return false;
+
+    const bool waitWritable = (client->mOutOffset < client->mOutBuff.size());
+    if (waitWritable) {
+        if (client->mOutOffset > client->mOutBuff.size() / 2) {
+            client->mOutBuff.erase(0, client->mOutOffset); // shrink consumed data
+            client->mOutOffset = 0;
+        }
+    } else {
+        client->mOutBuff.clear();
+        client->mOutOffset = 0;
+    }
+
+    bool updateEpoll = false;
+    bool kick = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        client->mOutPendingSize = client->mOutBuff.size() - client->mOutOffset;
+        if (waitWritable != client->mWaitWritable) {
+            client->mWaitWritable = waitWritable;
+            updateEpoll = true;
+        }
+        if (!waitWritable && !client->mSendBuff.empty() && !mSendKickPending) {
+            // enqSend() does not kick while waiting EPOLLOUT
+            mSendKickPending = true;
+            kick = true;
         }
     }
-    return 1;                   // active
+
+    if (updateEpoll) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP | (waitWritable ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        ev.data.fd = client->mSock;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, client->mSock, &ev);
+    }
+    if (kick) kickSend();
+    return true;
+}
+
+TlSvr::Client *
+TlSvr::findClient(int sock) const
+//
+// recvWait() thread only. Other threads never add or remove the clients.
+//
+{
+    for (auto &client : mClients) {
+        if (client->mSock == sock) return client.get();
+    }
+    return nullptr;
+}
+
+bool
+TlSvr::popLine(std::string &recvStr)
+{
+    if (mRecvLines.empty()) return false;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCurrClientId = mRecvLines.front().first; // send() replies to this client
+    recvStr = std::move(mRecvLines.front().second);
+    mRecvLines.pop_front();
+    return true;
 }
 
 } // namespace grid_util
 } // namespace scene_rdl2
-
@@ -7,42 +7,62 @@
 
 #include <scene_rdl2/render/util/StrUtil.h>
 
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace scene_rdl2 {
 namespace grid_util {
 
 class TlSvr
 //
-// This class provides the functionality of server side telnet connection. 
-// Only support p2p (point to point) connection so far and not support multiple
-// incoming input from multiple clients. Only support IPv4 so far.
+// This class provides the functionality of server side telnet connection.
+// Multiple telnet clients can connect at the same time. Only support IPv4 so far.
 // Using this class, it is very easy to implement interactive command line console
 // functionality to the non interactive application.
 //
+// Internally, all sockets are watched by epoll. recvWait() sleeps inside the kernel until
+// something happens (new connection, incoming command line, socket becomes writable or
+// wakeup() is called), so there is no wake up at all while idle.
+//
+// send() and broadcast() never block and never call any socket API. Data is appended to the
+// per-client send buffer under a short lock and the thread which runs recvWait() is kicked by
+// an eventfd. That thread writes the data to the socket outside of the lock as much as the
+// socket accepts, and the rest when the socket becomes writable (EPOLLOUT). So they can be
+// called from any thread (i.e. render threads streaming stats to the console) without stall,
+// and they never wait for a socket read or write by the recvWait() thread. Data is only
+// written while recvWait() is called. If a client does not read and its queued data exceeds
+// sMaxSendBuffSize, new data for this client is dropped.
+// A client which sends more than sMaxRecvLineSize bytes without '\n' is closed.
+//
 // The following is a pseudo code of typical implementation for command line console by TlSvr.
 // This implementation is one of the threads of the server process.
 //
 //    TlSvr svr;
 //    if (!svr.open(20000)) return; // port is 20000
 //
-//    while (1) {
+//    while (!shutdown) { // other thread sets shutdown = true and calls svr.wakeup()
 //        std::string cmdLine;
-//        int recvByte = svr.recv(cmdLine);
-//        if (recvByte == 0) {
-//            usleep(10000); // 10ms sleep for yielding CPU resource
+//        int recvByte = svr.recvWait(cmdLine, -1); // sleep until next event
+//        if (recvByte == 0 || recvByte == -1) {
+//            // empty or one of the clients closed connection
 //        } else if (recvByte < 0) {
 //            // error
 //            break;
 //        } else {
 //            // parse cmdLine here and do something ...
-//            svr.send("..test..test..test\n"); // you can send back string to the telnet client.
+//            svr.send("..test..test..test\n"); // send back string to the client of cmdLine.
 //            if (cmdLine == "exit") break;
 //        }
 //    }
 //    svr.close();
-//    
+//
+// Non blocking recv() (= recvWait() with 0 timeout) is still available for the application
+// which has its own polling loop.
+//
 {
 public:
     // These 2 callback definitions are used to define message display functionality.
@@ -53,9 +73,17 @@ public:
     using INFOMSG_CALLBACK = std::function<void(const std::string &)>;
     using ERRMSG_CALLBACK = std::function<void(const std::string &)>;
 
+    static constexpr size_t sMaxClients = 16;
+    static constexpr size_t sMaxSendBuffSize = 16 * 1024 * 1024; // byte, for each client
+    static constexpr size_t sMaxRecvLineSize = 1024 * 1024;      // byte, for each client
+
     TlSvr();
     ~TlSvr();
 
+    // Non-copyable
+    TlSvr &operator =(const TlSvr &) = delete;
+    TlSvr(const TlSvr &) = delete;
+
     //
     // You can use serverPortNum = 0 for auto search of available port by the kernel.
     // In this case, you can figure out the result port number by the return value of this API.
@@ -70,36 +98,87 @@ public:
              INFOMSG_CALLBACK infoMsgCallBack = nullptr,
              ERRMSG_CALLBACK errMsgCallBack = nullptr); // return opened port number. 0 is error
 
+    // Receive one command line from any client.
+    // Wait until the next event up to timeoutMs. (timeoutMs = -1 : no timeout, 0 : non blocking)
+    // return recv byte or 0:empty -1:EOF(one of the clients closed connection) -2:otherError
+    int recvWait(std::string &recvStr,
+                 const int timeoutMs,
+                 INFOMSG_CALLBACK infoMsgCallBack = nullptr,
+                 ERRMSG_CALLBACK errMsgCallBack = nullptr);
+
     // non blocking receive : return recv byte or 0:empty -1:EOF -2:otherError
     int recv(std::string & recvStr,
              INFOMSG_CALLBACK infoMsgCallBack = nullptr,
-             ERRMSG_CALLBACK errMsgCallBack = nullptr);
+             ERRMSG_CALLBACK errMsgCallBack = nullptr)
+    {
+        return recvWait(recvStr, 0, infoMsgCallBack, errMsgCallBack);
+    }
+
+    // Make recvWait() return immediately. MT-safe
+    void wakeup();
 
-    // blocking send
-    // Send only works after established socket connection by recv API.
+    // non blocking send to the client which sent the last command line received by recv.
+    // If there is no such client, send to all the clients. MT-safe.
+    // return false if the connection is already closed.
+    // The callbacks are kept for compatibility. Socket errors are reported by recvWait().
     bool send(const std::string & sendStr,
               INFOMSG_CALLBACK infoMsgCallBack = nullptr,
               ERRMSG_CALLBACK errMsgCallBack = nullptr);
 
+    // non blocking send to all the clients. MT-safe
+    bool broadcast(const std::string &sendStr);
+
     void close();
 
-    bool isConnectionEstablised() const; // true:establised false:not_yet
+    bool isConnectionEstablised() const; // true:at least 1 client is connected false:not_yet
+    size_t getClientTotal() const;
+    size_t getDroppedSendSize() const; // total dropped send data size (byte) by full send buffer
 
 protected:
+    struct Client
+    {
+        explicit Client(int sock, unsigned id) : mSock(sock), mId(id) {}
+
+        int mSock;
+        unsigned mId;                 // unique id. socket fd might be reused after close
+        std::string mRecvBuff;        // incomplete command line. recvWait() thread only
+
+        std::string mSendBuff;        // appended by send()/broadcast(). need mMutex
+        size_t mOutPendingSize {0};   // not yet written size of mOutBuff. need mMutex
+
+        std::string mOutBuff;         // data which is being written. recvWait() thread only
+        size_t mOutOffset {0};        // already written size of mOutBuff
+        bool mWaitWritable {false};   // waiting EPOLLOUT
+    };
+
     bool setupServerPort(INFOMSG_CALLBACK infoMsgCallBack, ERRMSG_CALLBACK errMsgCallBack);
     bool socketBindAndListen(INFOMSG_CALLBACK infoMsgCallBack, ERRMSG_CALLBACK errMsgCallBack);
     bool acceptSocket(INFOMSG_CALLBACK infoMsgCallBack, ERRMSG_CALLBACK errMsgCallBack);
-    void connectionClosed(INFOMSG_CALLBACK infoMsgCallBack);
-    int  socketCheck(ERRMSG_CALLBACK errMsgCallBack);
+    void connectionClosed(Client *client, INFOMSG_CALLBACK infoMsgCallBack);
+    bool readSocket(Client *client, ERRMSG_CALLBACK errMsgCallBack); // return false if EOF or error
+    bool enqSend(Client *client, const std::string &sendStr); // need mMutex. return true if kick is needed
+    void kickSend();
+    void flushAllSend(INFOMSG_CALLBACK infoMsgCallBack);
+    bool flushSend(Client *client);                            // return false if connection is broken
+    Client *findClient(int sock) const;
+    bool popLine(std::string &recvStr);
 
     int mPort;                  // server port
     int mBaseSock;              // server socket fd
-    int mSock;                  // incoming socket fd
-    bool mConnectionReady;      // connection-established(true) or not(false)
-    int mRecvSize;              // received data size
-    bool mEndLine;              // end line condition
+    int mEpollFd;
+    int mWakeupFd;              // eventfd for wakeup()
+    int mSendKickFd;            // eventfd to kick the recvWait() thread to write the send buffers
+
+    mutable std::mutex mMutex;  // for mClients and send buffers. never held during socket read/write
+    bool mSendKickPending;      // mSendKickFd is already kicked. need mMutex
+    std::vector<std::unique_ptr<Client>> mClients;
+    unsigned mClientIdNext;
+    unsigned mCurrClientId;     // client of the last received command line. 0 is none
+    size_t mDroppedSendSize;
+
+    std::deque<std::pair<unsigned, std::string>> mRecvLines; // received lines : (clientId, line)
+    int mEofTotal;              // closed connection count which is not reported by recv yet
 };
 
 } // namespace grid_util
 } // namespace scene_rdl2
-
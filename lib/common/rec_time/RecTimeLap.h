@@ -73,6 +73,7 @@ public:
         return true;
     }
 
+    size_t getSectionTotal() const { return mSections.size(); }
     const rec_time::RecTickManualInterval &getSection(const size_t sectionId) { return mSections[sectionId]; }
     const rec_time::RecDoubleManualInterval &getAuxSection(const size_t sectionId) { return mAuxSections[sectionId]; }
 
@@ -0,0 +1,520 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "RecZone.h"
+#include "RecTime.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+#include <unistd.h>             // getpid
+#include <x86intrin.h>          // __rdtsc
+
+namespace scene_rdl2 {
+namespace rec_time {
+
+class RecZoneProfiler::ThreadBuffer
+//
+// Single writer (owner thread) / multiple reader event buffer. Events are stored into
+// fixed size chunks which are never moved, and the number of valid events in a chunk is
+// published by a release store. So exporting never blocks the owner thread.
+//
+{
+public:
+    static constexpr size_t sChunkSize = 4096;
+
+    struct Chunk {
+        Event mEvents[sChunkSize];
+        std::atomic<size_t> mCount {0};
+        std::atomic<Chunk *> mNext {nullptr};
+    };
+
+    explicit ThreadBuffer(const uint32_t threadId) :
+        mThreadId(threadId),
+        mDepth(0),
+        mHead(new Chunk),
+        mTail(mHead)
+    {}
+    ~ThreadBuffer() { freeChunks(mHead); }
+
+    uint32_t getThreadId() const { return mThreadId; }
+
+    void setName(const std::string &name) { mName = name; } // under profiler mutex
+    const std::string &getName() const { return mName; }    // under profiler mutex
+
+    uint32_t depthEnter() { return mDepth++; }
+    uint32_t depthExit() { return (mDepth > 0) ? --mDepth : 0; }
+
+    void push(const Event &event) {
+        size_t count = mTail->mCount.load(std::memory_order_relaxed);
+        if (count == sChunkSize) {
+            Chunk *chunk = new Chunk;
+            mTail->mNext.store(chunk, std::memory_order_release);
+            mTail = chunk;
+            count = 0;
+        }
+        mTail->mEvents[count] = event;
+        mTail->mCount.store(count + 1, std::memory_order_release);
+    }
+
+    template <typename F>
+    void crawl(F func) const {
+        for (const Chunk *chunk = mHead; chunk; chunk = chunk->mNext.load(std::memory_order_acquire)) {
+            const size_t count = chunk->mCount.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i) {
+                func(chunk->mEvents[i]);
+            }
+        }
+    }
+
+    void reset() {
+        freeChunks(mHead->mNext.exchange(nullptr));
+        mHead->mCount.store(0, std::memory_order_release);
+        mTail = mHead;
+        mDepth = 0;
+    }
+
+private:
+    static void freeChunks(Chunk *chunk) {
+        while (chunk) {
+            Chunk *next = chunk->mNext.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    uint32_t mThreadId;
+    uint32_t mDepth;
+    std::string mName;
+
+    Chunk *mHead;
+    Chunk *mTail;
+};
+
+//------------------------------------------------------------------------------------------
+
+namespace {
+
+thread_local RecZoneProfiler::ThreadBuffer *tlsThreadBuffer = nullptr;
+
+std::string
+jsonEscape(const char *str)
+{
+    std::string out;
+    for (const char *c = str; *c; ++c) {
+        switch (*c) {
+        case '"' : out += "\\\""; break;
+        case '\\' : out += "\\\\"; break;
+        case '\n' : out += "\\n"; break;
+        case '\t' : out += "\\t"; break;
+        default :
+            if (static_cast<unsigned char>(*c) < 0x20) out += ' ';
+            else out += *c;
+            break;
+        }
+    }
+    return out;
+}
+
+//
+// Binary format helpers. All the integers are LEB128 variable length encoded.
+//
+void
+putVLUInt(std::string &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void
+putVLInt(std::string &out, const int64_t v)
+{
+    putVLUInt(out, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63)); // zig-zag
+}
+
+void
+putString(std::string &out, const std::string &str)
+{
+    putVLUInt(out, str.size());
+    out.append(str);
+}
+
+class BinaryReadCursor
+{
+public:
+    explicit BinaryReadCursor(const std::string &data) : mData(data), mPos(0) {}
+
+    bool getVLUInt(uint64_t &v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (mPos >= mData.size()) return false;
+            const uint8_t byte = static_cast<uint8_t>(mData[mPos++]);
+            v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+    bool getVLInt(int64_t &v) {
+        uint64_t u;
+        if (!getVLUInt(u)) return false;
+        v = static_cast<int64_t>((u >> 1) ^ (~(u & 1) + 1));
+        return true;
+    }
+    bool getString(std::string &str) {
+        uint64_t size;
+        if (!getVLUInt(size) || mData.size() - mPos < size) return false;
+        str = mData.substr(mPos, size);
+        mPos += size;
+        return true;
+    }
+    bool getRaw(void *dst, const size_t size) {
+        if (mData.size() - mPos < size) return false;
+        std::memcpy(dst, &mData[mPos], size);
+        mPos += size;
+        return true;
+    }
+
+private:
+    const std::string &mData;
+    size_t mPos;
+};
+
+constexpr char sBinaryMagic[4] = {'R', 'Z', 'N', '1'};
+
+} // namespace
+
+//------------------------------------------------------------------------------------------
+
+std::atomic<bool> RecZoneProfiler::sActive {false};
+
+// static function
+uint64_t
+RecZoneProfiler::tick()
+{
+    return __rdtsc();
+}
+
+// static function
+RecZoneProfiler &
+RecZoneProfiler::get()
+{
+    static RecZoneProfiler profiler;
+    return profiler;
+}
+
+void
+RecZoneProfiler::enable(const bool flag)
+{
+    if (flag) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mTicksPerMicroSec == 0.0f) {
+            // calibrate TSC frequency by gettimeofday over about 10ms
+            RecTime recTime;
+            const long long startMicroSec = recTime.getCurrentMicroSec();
+            const uint64_t startTick = tick();
+            long long endMicroSec = startMicroSec;
+            while (endMicroSec - startMicroSec < 10000) {
+                endMicroSec = recTime.getCurrentMicroSec();
+            }
+            const uint64_t endTick = tick();
+            mTicksPerMicroSec =
+                static_cast<float>(endTick - startTick) / static_cast<float>(endMicroSec - startMicroSec);
+            mBaseTick = startTick;
+        }
+    }
+    sActive.store(flag, std::memory_order_relaxed);
+}
+
+RecZoneProfiler::ThreadBuffer *
+RecZoneProfiler::getThreadBuffer()
+{
+    if (!tlsThreadBuffer) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mThreadBuffers.push_back(std::make_shared<ThreadBuffer>(static_cast<uint32_t>(mThreadBuffers.size())));
+        tlsThreadBuffer = mThreadBuffers.back().get();
+    }
+    return tlsThreadBuffer;
+}
+
+void
+RecZoneProfiler::setThreadName(const std::string &name)
+{
+    ThreadBuffer *buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(mMutex);
+    buffer->setName(name);
+}
+
+void
+RecZoneProfiler::zoneBegin()
+{
+    getThreadBuffer()->depthEnter();
+}
+
+void
+RecZoneProfiler::zoneEnd(const char *name, const uint64_t startTick, const uint64_t endTick)
+{
+    ThreadBuffer *buffer = getThreadBuffer();
+    const uint32_t depth = buffer->depthExit();
+    buffer->push(Event {name, startTick, endTick, depth});
+}
+
+void
+RecZoneProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto &buffer : mThreadBuffers) {
+        buffer->reset();
+    }
+}
+
+template <typename F>
+void
+RecZoneProfiler::crawlAllEvents(F func) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto &buffer : mThreadBuffers) {
+        buffer->crawl([&](const Event &event) { func(buffer->getThreadId(), event); });
+    }
+}
+
+std::string
+RecZoneProfiler::toChromeTraceJson() const
+{
+    const float ticksPerMicroSec = (mTicksPerMicroSec > 0.0f) ? mTicksPerMicroSec : 1.0f;
+    const int pid = static_cast<int>(getpid());
+
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(3);
+    ostr << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() -> const char * {
+        if (first) { first = false; return "\n"; }
+        return ",\n";
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto &buffer : mThreadBuffers) {
+            if (buffer->getName().empty()) continue;
+            ostr << separator()
+                 << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                 << ",\"tid\":" << buffer->getThreadId()
+                 << ",\"args\":{\"name\":\"" << jsonEscape(buffer->getName().c_str()) << "\"}}";
+        }
+    }
+
+    crawlAllEvents([&](uint32_t threadId, const Event &event) {
+            const double ts = static_cast<double>(static_cast<int64_t>(event.mStartTick - mBaseTick)) / ticksPerMicroSec;
+            const double dur = static_cast<double>(event.mEndTick - event.mStartTick) / ticksPerMicroSec;
+            ostr << separator()
+                 << "{\"name\":\"" << jsonEscape(event.mName) << "\",\"ph\":\"X\",\"pid\":" << pid
+                 << ",\"tid\":" << threadId << ",\"ts\":" << ts << ",\"dur\":" << dur
+                 << ",\"args\":{\"depth\":" << event.mDepth << "}}";
+        });
+    ostr << "\n]}\n";
+    return ostr.str();
+}
+
+bool
+RecZoneProfiler::saveChromeTrace(const std::string &filename) const
+{
+    std::ofstream ofs(filename);
+    if (!ofs) return false;
+    ofs << toChromeTraceJson();
+    return static_cast<bool>(ofs);
+}
+
+std::string
+RecZoneProfiler::toBinary() const
+//
+// magic "RZN1"
+// float ticksPerMicroSec, uint64_t baseTick (both raw), pid
+// numNames, { name }
+// numThreads, { threadId, threadName, numEvents, { nameId, depth, startTickDelta(zig-zag), durationTick } }
+//
+{
+    std::unordered_map<const char *, uint64_t> nameIdTable;
+    std::vector<std::string> names;
+    struct ThreadEvents {
+        uint32_t mThreadId;
+        std::string mName;
+        std::vector<Event> mEvents;
+    };
+    std::vector<ThreadEvents> threads;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto &buffer : mThreadBuffers) {
+            threads.push_back(ThreadEvents {buffer->getThreadId(), buffer->getName(), {}});
+            buffer->crawl([&](const Event &event) {
+                    if (nameIdTable.emplace(event.mName, names.size()).second) {
+                        names.emplace_back(event.mName);
+                    }
+                    threads.back().mEvents.push_back(event);
+                });
+        }
+    }
+
+    std::string out(sBinaryMagic, sizeof(sBinaryMagic));
+    out.append(reinterpret_cast<const char *>(&mTicksPerMicroSec), sizeof(mTicksPerMicroSec));
+    out.append(reinterpret_cast<const char *>(&mBaseTick), sizeof(mBaseTick));
+    putVLUInt(out, static_cast<uint64_t>(getpid()));
+    putVLUInt(out, names.size());
+    for (const auto &name : names) {
+        putString(out, name);
+    }
+    putVLUInt(out, threads.size());
+    for (const auto &thread : threads) {
+        putVLUInt(out, thread.mThreadId);
+        putString(out, thread.mName);
+        putVLUInt(out, thread.mEvents.size());
+        uint64_t prevStartTick = mBaseTick;
+        for (const auto &event : thread.mEvents) {
+            putVLUInt(out, nameIdTable[event.mName]);
+            putVLUInt(out, event.mDepth);
+            putVLInt(out, static_cast<int64_t>(event.mStartTick - prevStartTick));
+            putVLUInt(out, event.mEndTick - event.mStartTick);
+            prevStartTick = event.mStartTick;
+        }
+    }
+    return out;
+}
+
+bool
+RecZoneProfiler::saveBinary(const std::string &filename) const
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) return false;
+    const std::string data = toBinary();
+    ofs.write(data.data(), data.size());
+    return static_cast<bool>(ofs);
+}
+
+// static function
+bool
+RecZoneProfiler::binaryToChromeTraceJson(const std::string &binary, std::string &json)
+{
+    if (binary.size() < sizeof(sBinaryMagic) ||
+        std::memcmp(binary.data(), sBinaryMagic, sizeof(sBinaryMagic)) != 0) {
+        return false;
+    }
+
+    BinaryReadCursor cursor(binary);
+    char magic[sizeof(sBinaryMagic)];
+    float ticksPerMicroSec;
+    uint64_t baseTick;
+    uint64_t pid;
+    uint64_t numNames;
+    if (!cursor.getRaw(magic, sizeof(magic)) ||
+        !cursor.getRaw(&ticksPerMicroSec, sizeof(ticksPerMicroSec)) ||
+        !cursor.getRaw(&baseTick, sizeof(baseTick)) ||
+        !cursor.getVLUInt(pid) ||
+        !cursor.getVLUInt(numNames)) {
+        return false;
+    }
+    if (ticksPerMicroSec <= 0.0f) ticksPerMicroSec = 1.0f;
+
+    std::vector<std::string> names(numNames);
+    for (auto &name : names) {
+        if (!cursor.getString(name)) return false;
+    }
+
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(3);
+    ostr << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() -> const char * {
+        if (first) { first = false; return "\n"; }
+        return ",\n";
+    };
+
+    uint64_t numThreads;
+    if (!cursor.getVLUInt(numThreads)) return false;
+    for (uint64_t threadItem = 0; threadItem < numThreads; ++threadItem) {
+        uint64_t threadId, numEvents;
+        std::string threadName;
+        if (!cursor.getVLUInt(threadId) || !cursor.getString(threadName) || !cursor.getVLUInt(numEvents)) {
+            return false;
+        }
+        if (!threadName.empty()) {
+            ostr << separator()
+                 << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << threadId
+                 << ",\"args\":{\"name\":\"" << jsonEscape(threadName.c_str()) << "\"}}";
+        }
+
+        uint64_t startTick = baseTick;
+        for (uint64_t eventId = 0; eventId < numEvents; ++eventId) {
+            uint64_t nameId, depth, durationTick;
+            int64_t deltaTick;
+            if (!cursor.getVLUInt(nameId) || !cursor.getVLUInt(depth) ||
+                !cursor.getVLInt(deltaTick) || !cursor.getVLUInt(durationTick) ||
+                nameId >= names.size()) {
+                return false;
+            }
+            startTick += static_cast<uint64_t>(deltaTick);
+            const double ts = static_cast<double>(static_cast<int64_t>(startTick - baseTick)) / ticksPerMicroSec;
+            const double dur = static_cast<double>(durationTick) / ticksPerMicroSec;
+            ostr << separator()
+                 << "{\"name\":\"" << jsonEscape(names[nameId].c_str()) << "\",\"ph\":\"X\",\"pid\":" << pid
+                 << ",\"tid\":" << threadId << ",\"ts\":" << ts << ",\"dur\":" << dur
+                 << ",\"args\":{\"depth\":" << depth << "}}";
+        }
+    }
+    ostr << "\n]}\n";
+    json = ostr.str();
+    return true;
+}
+
+std::string
+RecZoneProfiler::show() const
+{
+    struct Summary {
+        std::string mName;
+        uint64_t mCount = 0;
+        uint64_t mTotalTick = 0;
+    };
+    std::unordered_map<const char *, size_t> idTable;
+    std::vector<Summary> summaries;
+    crawlAllEvents([&](uint32_t, const Event &event) {
+            auto itr = idTable.emplace(event.mName, summaries.size());
+            if (itr.second) {
+                summaries.push_back(Summary());
+                summaries.back().mName = event.mName;
+            }
+            Summary &summary = summaries[itr.first->second];
+            summary.mCount++;
+            summary.mTotalTick += event.mEndTick - event.mStartTick;
+        });
+    std::sort(summaries.begin(), summaries.end(),
+              [](const Summary &a, const Summary &b) { return a.mTotalTick > b.mTotalTick; });
+
+    const float tickMiSec = (mTicksPerMicroSec > 0.0f) ? 0.001f / mTicksPerMicroSec : 0.0f;
+    size_t nameWidth = 0;
+    for (const auto &summary : summaries) nameWidth = std::max(nameWidth, summary.mName.size());
+
+    std::ostringstream ostr;
+    ostr << "RecZone summary (total:" << summaries.size() << ") {\n";
+    for (const auto &summary : summaries) {
+        const float totalMiSec = static_cast<float>(summary.mTotalTick) * tickMiSec;
+        ostr << "  " << std::setw(nameWidth) << std::left << summary.mName << std::right
+             << " count:" << std::setw(8) << summary.mCount
+             << " total:" << std::setw(12) << std::fixed << std::setprecision(3) << totalMiSec << " ms"
+             << " avg:" << std::setw(10) << std::fixed << std::setprecision(5)
+             << totalMiSec / static_cast<float>(summary.mCount) << " ms\n";
+    }
+    ostr << "}";
+    return ostr.str();
+}
+
+} // namespace rec_time
+} // namespace scene_rdl2
+
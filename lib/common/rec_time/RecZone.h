@@ -0,0 +1,138 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+//
+// Hierarchical scoped-timer profiling.
+//
+// RecZone is a RAII timer which records a begin/end TSC pair into a thread-local event
+// buffer when it goes out of scope. Zones nest naturally by scope and can be used from
+// any thread. When profiling is disabled (default) a zone costs a single relaxed atomic
+// load. Collected events are exported as Chrome trace JSON (chrome://tracing, Perfetto)
+// or as a compact binary format which can be converted to Chrome trace JSON offline.
+//
+// Sample usage:
+//
+//   RecZoneProfiler::get().enable(true);
+//   ...
+//   {
+//       REC_ZONE("SceneContext::applyUpdates");
+//       ...
+//       {
+//           REC_ZONE("commit");
+//           ...
+//       }
+//   }
+//   ...
+//   RecZoneProfiler::get().saveChromeTrace("./trace.json");
+//
+// Zone names must be string literals (or any string which outlives the profiler),
+// only the pointer is recorded.
+//
+namespace scene_rdl2 {
+namespace rec_time {
+
+class RecZoneProfiler
+{
+public:
+    struct Event {
+        const char *mName;
+        uint64_t mStartTick;
+        uint64_t mEndTick;
+        uint32_t mDepth;        // nesting depth inside the thread, 0 is the outermost zone
+    };
+
+    class ThreadBuffer;
+
+    static RecZoneProfiler &get();
+
+    static bool isActive() { return sActive.load(std::memory_order_relaxed); }
+    static uint64_t tick(); // TSC. Only called while the profiler is active
+
+    // Enabling the profiler calibrates the TSC frequency (takes about 10ms) at the first call.
+    void enable(const bool flag);
+
+    // Thread name which is shown by the Chrome trace viewer for the calling thread.
+    void setThreadName(const std::string &name);
+
+    // Called by RecZone. Don't use directly.
+    void zoneBegin();
+    void zoneEnd(const char *name, const uint64_t startTick, const uint64_t endTick);
+
+    // Discards all recorded events. Should be called while no zone is running.
+    void reset();
+
+    // Exports can be taken at any time, events of the zones which are still running are
+    // not included.
+    std::string toChromeTraceJson() const;
+    bool saveChromeTrace(const std::string &filename) const;
+
+    std::string toBinary() const;
+    bool saveBinary(const std::string &filename) const;
+    // Converts toBinary() output to the Chrome trace JSON. Returns false if the data is broken.
+    static bool binaryToChromeTraceJson(const std::string &binary, std::string &json);
+
+    // Per zone name total/count/average summary
+    std::string show() const;
+
+    float getTicksPerMicroSec() const { return mTicksPerMicroSec; }
+
+private:
+    RecZoneProfiler() : mTicksPerMicroSec(0.0f), mBaseTick(0) {}
+
+    ThreadBuffer *getThreadBuffer();
+
+    template <typename F> void crawlAllEvents(F func) const; // func(uint32_t threadId, const Event &)
+
+    static std::atomic<bool> sActive;
+
+    float mTicksPerMicroSec;
+    uint64_t mBaseTick;
+
+    mutable std::mutex mMutex; // for mThreadBuffers
+    std::vector<std::shared_ptr<ThreadBuffer>> mThreadBuffers;
+};
+
+class RecZone
+{
+public:
+    explicit RecZone(const char *name) : mName(nullptr), mStartTick(0) {
+        if (RecZoneProfiler::isActive()) {
+            mName = name;
+            RecZoneProfiler::get().zoneBegin();
+            mStartTick = RecZoneProfiler::tick();
+        }
+    }
+    ~RecZone() {
+        if (mName) {
+            RecZoneProfiler::get().zoneEnd(mName, mStartTick, RecZoneProfiler::tick());
+        }
+    }
+
+    RecZone(const RecZone &) = delete;
+    RecZone &operator =(const RecZone &) = delete;
+
+private:
+    const char *mName;
+    uint64_t mStartTick;
+};
+
+} // namespace rec_time
+} // namespace scene_rdl2
+
+#define REC_ZONE_CONCAT_INNER(a, b) a##b
+#define REC_ZONE_CONCAT(a, b) REC_ZONE_CONCAT_INNER(a, b)
+#define REC_ZONE(name) \
+    scene_rdl2::rec_time::RecZone REC_ZONE_CONCAT(recZone_, __LINE__)(name)
+
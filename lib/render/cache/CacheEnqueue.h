@@ -34,6 +34,12 @@ public:
         mRuntimeVerify(false)
     {}
 
+    // streams the cache data to the sink instead of one contiguous buffer
+    explicit CacheEnqueue(rdl2::ValueContainerSink *sink) :
+        rdl2::ValueContainerEnq(sink),
+        mRuntimeVerify(false)
+    {}
+
     //------------------------------
     //
     // analyze scene purpose APIs for debug
@@ -19,6 +19,7 @@
 #include <log4cplus/version.h>
 
 #include <iostream>
+#include <new>
 #include <sstream>
 #include <string>
 #include <cstdio>
@@ -299,24 +300,137 @@ Logger::setInfoLevel()
 }
 
 
+namespace {
+
+constexpr size_t sCacheLineSize = util::sThreadShardAlign;
+
+} // end anonymous namespace
+
+void
+ObjectLogs::freeEventCounts()
+{
+    if (mEventCounts) {
+        const size_t total = static_cast<size_t>(getNumShards()) * mShardStride;
+        for (size_t i = 0; i < total; ++i) {
+            mEventCounts[i].~Counter();
+        }
+        ::operator delete(mEventCounts, std::align_val_t(sCacheLineSize));
+        mEventCounts = nullptr;
+    }
+}
+
 void
 ObjectLogs::setNumEvents(int n)
 {
     if (n == mNumEvents) return;
 
-    int * newEventCounts = new int [n];
-    int i = 0;
-    for (; i < std::min(n, mNumEvents); i++) {
-        newEventCounts[i] = mEventCounts[i];
-    }
-    for (; i < n; i++) {
-        newEventCounts[i] = 0;
+    constexpr int countersPerLine = static_cast<int>(sCacheLineSize / sizeof(Counter));
+    const int newStride = (n + countersPerLine - 1) / countersPerLine * countersPerLine;
+    const unsigned numShards = getNumShards();
+
+    Counter *newEventCounts = nullptr;
+    if (newStride > 0) {
+        const size_t total = static_cast<size_t>(numShards) * newStride;
+        newEventCounts = static_cast<Counter *>(::operator new(total * sizeof(Counter),
+                                                               std::align_val_t(sCacheLineSize)));
+        for (size_t i = 0; i < total; ++i) {
+            new (&newEventCounts[i]) Counter(0);
+        }
+        // Keep the previous counts, flattened into shard 0.
+        for (int i = 0; i < std::min(n, mNumEvents); i++) {
+            newEventCounts[i].store(getCount(LogEvent(i)), std::memory_order_relaxed);
+        }
     }
+
+    freeEventCounts();
     mNumEvents = n;
-    delete [] mEventCounts;
+    mShardStride = newStride;
     mEventCounts = newEventCounts;
 }
 
+void
+ObjectLogs::clear()
+{
+    const unsigned numShards = getNumShards();
+    for (unsigned shard = 0; shard < numShards; ++shard) {
+        Counter *counts = getShard(shard);
+        for (int i = 0; i < mNumEvents; i++) {
+            counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+int
+ObjectLogs::getCount(LogEvent event) const
+{
+    const unsigned numShards = getNumShards();
+    int count = 0;
+    for (unsigned shard = 0; shard < numShards; ++shard) {
+        count += getShard(shard)[(int)event].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+ObjectLogs &
+ObjectLogs::operator+=(const ObjectLogs &other)
+{
+    if (mNumEvents != other.mNumEvents) {
+        setNumEvents(other.mNumEvents);
+    }
+    // Merge into the shard of the calling thread, so operator+= may run
+    // concurrently with log() calls on this object.
+    Counter *counts = (mNumEvents > 0) ? getShard(util::threadShardId()) : nullptr;
+    for (int i = 0; i < mNumEvents; i++) {
+        counts[i].fetch_add(other.getCount(LogEvent(i)), std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+ObjectLogs &
+ObjectLogs::operator=(const ObjectLogs &src)
+{
+    if (this != &src) {
+        setNumEvents(src.mNumEvents);
+        clear();
+        *this += src;
+    }
+    return *this;
+}
+
+LogEvent
+LogEventRegistry::createEvent(LogLevel level,
+                              std::string eventDescription)
+{
+    if (level == FATAL_LEVEL) {
+        Logger::error("Fatal events are not supported while shading, using error instead");
+        level = ERROR_LEVEL;
+    }
+
+    std::lock_guard<std::mutex> lock(mCreateMutex);
+
+    auto itr = mEventTable.find(eventDescription);
+    if (itr != mEventTable.end()) {
+        return itr->second;
+    }
+
+    const int n = static_cast<int>(mDescriptions.size());
+    mLevels.push_back(level);
+    mDescriptions.push_back(eventDescription);
+    mEventTable.emplace(std::move(eventDescription), LogEvent(n));
+    mNumEvents.store(n + 1, std::memory_order_release);
+    return LogEvent(n);
+}
+
+void
+LogEventRegistry::clear()
+{
+    std::lock_guard<std::mutex> lock(mCreateMutex);
+    mLevels.clear();
+    mDescriptions.clear();
+    mEventTable.clear();
+    mNumEvents.store(0, std::memory_order_release);
+}
+
 void
 LogEventRegistry::report(const std::string& objectName,
                          const std::string& sceneClassName,
@@ -324,7 +438,8 @@ LogEventRegistry::report(const std::string& objectName,
 {
     if (!mLoggingGlobalSwitch) return;
 
-    for (size_t i = 0; i < mLevels.size(); i++) {
+    const int numEvents = std::min(getNumEvents(), log.getNumEvents());
+    for (int i = 0; i < numEvents; i++) {
         int c = log.getCount(LogEvent(i));
         if (c > 0) {
             LogLevel level = mLevels[i];
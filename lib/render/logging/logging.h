@@ -7,13 +7,17 @@
 #pragma once
 
 #include <scene_rdl2/render/util/AtomicFloat.h>
+#include <scene_rdl2/render/util/ThreadShard.h>
 
 #include <log4cplus/loglevel.h>
 
 #include <algorithm>
 #include <atomic>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace {
 
@@ -162,6 +166,14 @@ typedef int LogEvent;
 // logged. This count can be used at a later time (e.g. postFrame) to print actual
 // error messages.
 //
+// log() is safe to call from any number of threads at the same time. The counters
+// are split into util::sThreadShardTotal per-thread shards (see ThreadShard.h), each
+// shard padded out to its own cache lines, so threads logging against the same object
+// don't fight over a single cache line. Shards are only summed up on read (getCount()
+// and operator+=), which are expected to be called outside of the hot shading loop.
+// The counters of one object take util::sThreadShardTotal * roundUp(numEvents * 4, 64)
+// bytes, i.e. 1 KB for up to 16 events, and nothing until setNumEvents() is called.
+//
 // Sample usage:
 // 
 // LogEventRegistry registry;
@@ -177,51 +189,54 @@ typedef int LogEvent;
 class ObjectLogs
 {
 public:
-    ObjectLogs() {
-        mNumEvents = 0;
-        mEventCounts = nullptr;
-    }
+    ObjectLogs() :
+        mNumEvents(0),
+        mShardStride(0),
+        mEventCounts(nullptr)
+    {}
+
+    // Copies are flattened, the merged counts end up in a single shard.
+    ObjectLogs(const ObjectLogs &src) : ObjectLogs() { *this += src; }
+    ObjectLogs &operator=(const ObjectLogs &src);
 
     ~ObjectLogs() {
-        delete [] mEventCounts;
+        freeEventCounts();
     }
 
     // Sets the maximum number of event types that need to be supported by this
-    // object.
+    // object. This is not thread safe against concurrent log() calls.
     void setNumEvents(int n);
 
+    int getNumEvents() const { return mNumEvents; }
+
     // Sets all event counts to 0.
-    void clear() {
-        for (int i = 0; i < mNumEvents; i++) {
-            mEventCounts[i] = 0;
-        }
-    }
+    void clear();
 
-    // Records an event.
+    // Records an event. Lock-free, may be called concurrently from any thread.
     void log(LogEvent event) {
-        mEventCounts[(int)event]++;
+        getShard(util::threadShardId())[(int)event].fetch_add(1, std::memory_order_relaxed);
     }
 
     // Gets a count of how many times log(event) was called for event since
-    // the last clear.
-    int getCount(LogEvent event) const {
-        return mEventCounts[(int)event];
-    }
+    // the last clear. This sums up all the shards.
+    int getCount(LogEvent event) const;
 
     // Combines two ObjectLogs objects, summing their event counts
-    ObjectLogs &operator+=(const ObjectLogs & other) {
-        if (mNumEvents != other.mNumEvents) {
-            setNumEvents(other.mNumEvents);
-        }
-        for (int i = 0; i < mNumEvents; i++) {
-            mEventCounts[i] += other.mEventCounts[i];
-        }
-        return *this;
-    }
+    ObjectLogs &operator+=(const ObjectLogs & other);
+
+    // Number of counter shards used by every ObjectLogs.
+    static constexpr unsigned getNumShards() { return util::sThreadShardTotal; }
 
 private:
+    using Counter = std::atomic<int>;
+
+    Counter *getShard(unsigned shardId) const { return mEventCounts + shardId * mShardStride; }
+
+    void freeEventCounts();
+
     int mNumEvents;
-    int *mEventCounts;
+    int mShardStride;           // counters per shard, rounded up to whole cache lines
+    Counter *mEventCounts;      // getNumShards() * mShardStride counters
 };
 
 
@@ -231,42 +246,36 @@ private:
 // LogEventRegistry and ObjectLogs should be used in pairs, with LogEventRegistrys
 // maintaining string descriptions of events and ObjectLogs maintaining counts.
 // Typically there will be multiple ObjectLogs associated with the same LogEventRegistry
-// since we want to maintain a separate ObjectLog per thread to avoid synchronization.
+// since we want to maintain a separate ObjectLog per object.
+//
+// createEvent() is serialized by an internal mutex and is expected to be called during
+// setup (i.e. shader construction or update). All the lookup functions are lock-free
+// and may be called from any number of threads once the setup has finished.
 class LogEventRegistry
 {
  public:
-    LogEventRegistry() {}
+    LogEventRegistry() : mNumEvents(0) {}
 
     LogEvent createEvent(LogLevel level,
-                         std::string eventDescription) {
-
-        if (level == FATAL_LEVEL) {
-            Logger::error("Fatal events are not supported while shading, using error instead");
-            level = ERROR_LEVEL;
-        }
-        std::vector<std::string>::iterator itr = std::find(mDescriptions.begin(),
-                                                           mDescriptions.end(),
-                                                           eventDescription);
-        if (itr != mDescriptions.end()) {
-            return LogEvent(std::distance(mDescriptions.begin(), itr));
-        } else {
-            int n = static_cast<int>(mDescriptions.size());
-            mLevels.push_back(level);
-            mDescriptions.push_back(eventDescription);
-            return LogEvent(n);
-        }
-    }
+                         std::string eventDescription);
 
     // Returns a description of a given LogEvent.
     const std::string &getDescription(LogEvent event) const {
         return mDescriptions[(int)event];
     }
 
+    // Returns the logging level of a given LogEvent.
+    LogLevel getLevel(LogEvent event) const {
+        return mLevels[(int)event];
+    }
+
+    int getNumEvents() const { return mNumEvents.load(std::memory_order_acquire); }
+
     // Initializes an ObjectLog associated with this registry.
     // This sets the number of different types of LogEvents this ObjectLog
     // can expect.
     void initLog(ObjectLogs &logs) const {
-        logs.setNumEvents(static_cast<int>(mLevels.size()));
+        logs.setNumEvents(getNumEvents());
     }
 
     // Logs each event recorded in log for a object SceneObject i.e.
@@ -277,10 +286,7 @@ class LogEventRegistry
                 const ObjectLogs &log) const;
 
     // Clears the events and descriptions.
-    void clear() {
-        mLevels.clear();
-        mDescriptions.clear();
-    }
+    void clear();
 
     static void setLoggingGlobalSwitch(bool flag) { mLoggingGlobalSwitch = flag; }
     static bool getLoggingGlobalSwitch() { return mLoggingGlobalSwitch; }
@@ -288,6 +294,9 @@ class LogEventRegistry
 private:
     std::vector<LogLevel> mLevels;
     std::vector<std::string> mDescriptions;
+    std::unordered_map<std::string, LogEvent> mEventTable; // description -> event
+    std::atomic<int> mNumEvents;
+    std::mutex mCreateMutex;
 
     static std::atomic<bool> mLoggingGlobalSwitch;
 };
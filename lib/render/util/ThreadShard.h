@@ -0,0 +1,38 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+//
+// -- Per-thread shard id for contention free counters --
+//
+// Counters which are updated from many threads (ObjectLogs, MetricsRegistry) are split into
+// sThreadShardTotal shards, each one padded to its own cache line(s), and summed up on read.
+// Every thread picks the next shard id at its first call and keeps it for its lifetime. Threads
+// beyond sThreadShardTotal wrap around and share a shard, so the shard itself still has to be
+// updated atomically.
+//
+// The shard total is fixed in order to bound the memory footprint of the sharded objects:
+// each sharded counter set costs sThreadShardTotal * (counter bytes rounded up to
+// sThreadShardAlign) bytes independent of the hardware concurrency.
+//
+
+#include <atomic>
+
+namespace scene_rdl2 {
+namespace util {
+
+constexpr unsigned sThreadShardTotal = 16;
+constexpr unsigned sThreadShardAlign = 64; // cache line size
+
+inline unsigned
+threadShardId() // 0 ~ sThreadShardTotal - 1
+{
+    static std::atomic<unsigned> sThreadTotal {0};
+    thread_local const unsigned sShardId =
+        sThreadTotal.fetch_add(1, std::memory_order_relaxed) % sThreadShardTotal;
+    return sShardId;
+}
+
+} // namespace util
+} // namespace scene_rdl2
@@ -4,6 +4,7 @@
 
 #include "AsciiReader.h"
 
+#include "AsciiSubsetExtractor.h"
 #include "Attribute.h"
 #include "Displacement.h"
 #include "Geometry.h"
@@ -261,6 +262,14 @@ AsciiReader::fromFile(const std::string& filename)
     fromStream(in, chunkName);
 }
 
+void
+AsciiReader::fromFileSubset(const std::string& filename, const std::vector<std::string>& rootNames)
+{
+    AsciiSubsetExtractor extractor;
+    extractor.indexFile(filename);
+    fromString(extractor.extract(rootNames), '@' + filename);
+}
+
 void
 AsciiReader::fromStream(std::istream& input, const std::string& chunkName)
 {
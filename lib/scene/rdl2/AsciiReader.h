@@ -92,6 +92,18 @@ public:
      */
     void fromString(const std::string& code, const std::string& chunkName = "@rdla");
 
+    /**
+     * Reads only the part of the given rdla file which is needed by the root
+     * SceneObjects: the roots, every object reachable from them through
+     * attribute values, bindings, set contents and layer assignments, and all
+     * the statements which are not plain object definitions. The rest of the
+     * file is never evaluated. See AsciiSubsetExtractor for details.
+     *
+     * @param   filename    The path to the RDL ASCII file on the filesystem.
+     * @param   rootNames   Names of the root SceneObjects.
+     */
+    void fromFileSubset(const std::string& filename, const std::vector<std::string>& rootNames);
+
     /**
      * When enabled, questionable actions which may be mistakes (such as trying 
      * to set an attribute which doesn't exist) will cause an error rather than
@@ -0,0 +1,551 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "AsciiSubsetExtractor.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+#include <scene_rdl2/render/util/Strings.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+
+namespace {
+
+const std::string_view SCENE_VARIABLES_CLASS = "SceneVariables";
+const std::string_view SCENE_VARIABLES_OBJECT = "__SceneVariables__";
+
+//
+// Minimal Lua lexer helpers. All of them take the current position and return
+// the position right after the skipped token.
+//
+class Lexer
+{
+public:
+    Lexer(const char* data, size_t size) : mData(data), mSize(size) {}
+
+    static bool isSpace(const char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v'; }
+    static bool isWordHead(const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+    static bool isWord(const char c) { return isWordHead(c) || (c >= '0' && c <= '9'); }
+
+    char at(const size_t i) const { return (i < mSize) ? mData[i] : '\0'; }
+
+    bool isComment(const size_t i) const { return at(i) == '-' && at(i + 1) == '-'; }
+
+    // Returns the level (number of '=') of the long bracket at i, or -1 if there is none.
+    int longBracketLevel(size_t i) const {
+        if (at(i) != '[') return -1;
+        int level = 0;
+        for (++i; at(i) == '='; ++i) ++level;
+        return (at(i) == '[') ? level : -1;
+    }
+
+    size_t skipLongBracket(size_t i, const int level) const {
+        i += level + 2;
+        while (i < mSize) {
+            if (mData[i] == ']') {
+                size_t j = i + 1;
+                int l = 0;
+                while (at(j) == '=') { ++j; ++l; }
+                if (l == level && at(j) == ']') return j + 1;
+            }
+            ++i;
+        }
+        return mSize;
+    }
+
+    size_t skipQuoted(size_t i) const {
+        const char q = mData[i++];
+        while (i < mSize) {
+            const char c = mData[i];
+            if (c == '\\') { i += 2; continue; }
+            if (c == q) return i + 1;
+            if (c == '\n') return i; // unfinished string, let Lua complain later
+            ++i;
+        }
+        return mSize;
+    }
+
+    size_t skipComment(size_t i) const {
+        i += 2;
+        const int level = longBracketLevel(i);
+        if (level >= 0) return skipLongBracket(i, level);
+        while (i < mSize && mData[i] != '\n') ++i;
+        return i;
+    }
+
+    size_t skipWord(size_t i) const {
+        while (i < mSize && isWord(mData[i])) ++i;
+        return i;
+    }
+
+    size_t skipSpace(size_t i, const size_t end) const {
+        while (i < end && isSpace(mData[i])) ++i;
+        return i;
+    }
+
+    // Matches ( "name" ) starting at i (i points just after the identifier).
+    // Returns the position after ')' and sets name, or returns 0 if not matched.
+    size_t matchNameCall(size_t i, const size_t end, std::string_view& name) const {
+        i = skipSpace(i, end);
+        if (at(i) != '(') return 0;
+        i = skipSpace(i + 1, end);
+        if (i >= end || (mData[i] != '"' && mData[i] != '\'')) return 0;
+        const size_t strStart = i + 1;
+        const size_t strEnd = skipQuoted(i);
+        if (strEnd > end || mData[strEnd - 1] != mData[i]) return 0;
+        i = skipSpace(strEnd, end);
+        if (at(i) != ')') return 0;
+        name = std::string_view(mData + strStart, strEnd - 1 - strStart);
+        return i + 1;
+    }
+
+private:
+    const char* mData;
+    size_t mSize;
+};
+
+bool
+isBlockOpen(const std::string_view word)
+{
+    return word == "function" || word == "do" || word == "if" || word == "repeat";
+}
+
+bool
+isBlockClose(const std::string_view word)
+{
+    return word == "end" || word == "until";
+}
+
+bool
+isContinueWord(const std::string_view word)
+{
+    return word == "and" || word == "or" || word == "not" || word == "local" || word == "return";
+}
+
+bool
+isLuaKeyword(const std::string_view word)
+{
+    static const char* keywords[] = {
+        "and", "break", "do", "else", "elseif", "end", "false", "for", "function", "goto", "if", "in",
+        "local", "nil", "not", "or", "repeat", "return", "then", "true", "until", "while"
+    };
+    for (const char* k : keywords) {
+        if (word == k) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+AsciiSubsetExtractor::AsciiSubsetExtractor() :
+    mData(nullptr),
+    mSize(0),
+    mMapAddr(nullptr),
+    mMapSize(0),
+    mIndexSec(0.0f),
+    mClosureSec(0.0f),
+    mSelectedStatements(0),
+    mSelectedBytes(0)
+{
+}
+
+AsciiSubsetExtractor::~AsciiSubsetExtractor()
+{
+    clear();
+}
+
+void
+AsciiSubsetExtractor::indexFile(const std::string& filename)
+{
+    clear();
+
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw except::IoError(util::buildString("Could not open file '", filename, "' for reading."));
+    }
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) != 0) {
+        close(fd);
+        throw except::IoError(util::buildString("Could not stat file '", filename, "'."));
+    }
+
+    const size_t size = static_cast<size_t>(statBuf.st_size);
+    if (size > 0) {
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            throw except::IoError(util::buildString("Could not map file '", filename, "'."));
+        }
+        madvise(addr, size, MADV_SEQUENTIAL);
+        mMapAddr = addr;
+        mMapSize = size;
+        mData = static_cast<const char*>(addr);
+        mSize = size;
+    }
+    close(fd);
+
+    buildIndex();
+}
+
+void
+AsciiSubsetExtractor::indexString(const std::string& code)
+{
+    clear();
+    mCode = code;
+    mData = mCode.data();
+    mSize = mCode.size();
+    buildIndex();
+}
+
+std::vector<std::string>
+AsciiSubsetExtractor::closure(const std::vector<std::string>& rootNames) const
+{
+    const std::vector<char> selected = computeSelection(rootNames);
+
+    std::vector<std::string> names;
+    std::vector<char> done(mObjectNames.size(), 0);
+    for (size_t i = 0; i < mStatements.size(); ++i) {
+        const int32_t define = mStatements[i].mDefine;
+        if (!selected[i] || define < 0 || done[define]) continue;
+        done[define] = 1;
+        names.emplace_back(mObjectNames[define]);
+    }
+    return names;
+}
+
+std::string
+AsciiSubsetExtractor::extract(const std::vector<std::string>& rootNames) const
+{
+    const std::vector<char> selected = computeSelection(rootNames);
+
+    size_t total = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < mStatements.size(); ++i) {
+        if (selected[i]) {
+            total += mStatements[i].mLength + 1;
+            ++count;
+        }
+    }
+
+    std::string code;
+    code.reserve(total);
+    for (size_t i = 0; i < mStatements.size(); ++i) {
+        if (!selected[i]) continue;
+        const Statement& stmt = mStatements[i];
+        code.append(mData + stmt.mOffset, stmt.mLength);
+        if (code.back() != '\n') code += '\n';
+    }
+
+    mSelectedStatements.store(count, std::memory_order_relaxed);
+    mSelectedBytes.store(code.size(), std::memory_order_relaxed);
+    return code;
+}
+
+std::string
+AsciiSubsetExtractor::show() const
+{
+    std::ostringstream ostr;
+    ostr << "AsciiSubsetExtractor {\n"
+         << "  size:" << mSize << " byte\n"
+         << "  statements:" << mStatements.size() << '\n'
+         << "  objects:" << mObjectNames.size() << '\n'
+         << "  selectedStatements:" << mSelectedStatements.load(std::memory_order_relaxed) << '\n'
+         << "  selectedSize:" << mSelectedBytes.load(std::memory_order_relaxed) << " byte\n"
+         << std::fixed << std::setprecision(3)
+         << "  index:" << mIndexSec * 1000.0f << " ms\n"
+         << "  closure:" << mClosureSec.load(std::memory_order_relaxed) * 1000.0f << " ms\n"
+         << "}";
+    return ostr.str();
+}
+
+void
+AsciiSubsetExtractor::clear()
+{
+    mStatements.clear();
+    mObjectNames.clear();
+    mObjectStatements.clear();
+    mObjectIds.clear();
+
+    if (mMapAddr) {
+        munmap(mMapAddr, mMapSize);
+        mMapAddr = nullptr;
+        mMapSize = 0;
+    }
+    mCode.clear();
+    mData = nullptr;
+    mSize = 0;
+
+    mIndexSec = 0.0f;
+    mClosureSec.store(0.0f, std::memory_order_relaxed);
+    mSelectedStatements.store(0, std::memory_order_relaxed);
+    mSelectedBytes.store(0, std::memory_order_relaxed);
+}
+
+void
+AsciiSubsetExtractor::buildIndex()
+{
+    rec_time::RecTime recTime;
+    recTime.start();
+
+    splitStatements();
+    collectReferences();
+
+    mIndexSec = recTime.end();
+}
+
+void
+AsciiSubsetExtractor::splitStatements()
+//
+// Serial pass which finds top level statement boundaries and object definitions.
+// A statement ends at a newline (or ';') when no bracket or block is open, unless
+// the line obviously continues (trailing operator/comma, or the next line starts
+// with an operator or an opening bracket).
+//
+{
+    const Lexer lex(mData, mSize);
+
+    int depth = 0;      // (), {}, [] nesting
+    int blockDepth = 0; // function/do/if/repeat ... end/until nesting
+    size_t start = std::string::npos;
+    char lastSig = '\0';
+    std::string_view lastWord;
+
+    auto nextStartsContinuation = [&](size_t i) {
+        i = lex.skipSpace(i, mSize);
+        const char c = lex.at(i);
+        if (c == '-') return lex.at(i + 1) != '-';
+        if (std::strchr("{(.,=+*/^%<>~:]", c) && c != '\0') return true;
+        if (Lexer::isWordHead(c)) {
+            const std::string_view word(mData + i, lex.skipWord(i) - i);
+            return word == "and" || word == "or";
+        }
+        return false;
+    };
+    auto lastIsContinuation = [&]() {
+        if (lastSig == 'w') return isContinueWord(lastWord);
+        return lastSig != '\0' && std::strchr("=,({[+-*/^%<>~.:", lastSig) != nullptr;
+    };
+    auto finish = [&](const size_t end) {
+        mStatements.push_back(Statement {start, end - start, -1, {}});
+        start = std::string::npos;
+        lastSig = '\0';
+        lastWord = std::string_view();
+    };
+
+    size_t i = 0;
+    while (i < mSize) {
+        const char c = mData[i];
+        if (lex.isComment(i)) {
+            i = lex.skipComment(i);
+            continue;
+        }
+        if (c == '\n') {
+            if (start != std::string::npos && depth == 0 && blockDepth == 0 &&
+                !lastIsContinuation() && !nextStartsContinuation(i + 1)) {
+                finish(i + 1);
+            }
+            ++i;
+            continue;
+        }
+        if (Lexer::isSpace(c)) {
+            ++i;
+            continue;
+        }
+
+        if (start == std::string::npos) start = i;
+
+        if (c == '"' || c == '\'') {
+            i = lex.skipQuoted(i);
+            lastSig = '"';
+            continue;
+        }
+        if (c == '[') {
+            const int level = lex.longBracketLevel(i);
+            if (level >= 0) {
+                i = lex.skipLongBracket(i, level);
+                lastSig = '"';
+                continue;
+            }
+        }
+        if (Lexer::isWord(c)) {
+            const size_t end = lex.skipWord(i);
+            lastWord = std::string_view(mData + i, end - i);
+            if (isBlockOpen(lastWord)) ++blockDepth;
+            else if (isBlockClose(lastWord) && blockDepth > 0) --blockDepth;
+            lastSig = 'w';
+            i = end;
+            continue;
+        }
+
+        if (c == '(' || c == '{' || c == '[') ++depth;
+        else if ((c == ')' || c == '}' || c == ']') && depth > 0) --depth;
+        lastSig = c;
+        ++i;
+
+        if (c == ';' && depth == 0 && blockDepth == 0) finish(i);
+    }
+    if (start != std::string::npos) finish(mSize);
+
+    // Object definitions : ClassName("name") [{ ... }] or SceneVariables { ... }
+    for (size_t stmtId = 0; stmtId < mStatements.size(); ++stmtId) {
+        Statement& stmt = mStatements[stmtId];
+        const size_t end = stmt.mOffset + stmt.mLength;
+        size_t p = stmt.mOffset;
+        if (!Lexer::isWordHead(lex.at(p))) continue;
+        const size_t wordEnd = lex.skipWord(p);
+        const std::string_view word(mData + p, wordEnd - p);
+        if (isLuaKeyword(word)) continue;
+
+        std::string_view name;
+        size_t after = lex.matchNameCall(wordEnd, end, name);
+        if (!after) {
+            if (word != SCENE_VARIABLES_CLASS) continue;
+            after = wordEnd;
+            name = SCENE_VARIABLES_OBJECT;
+        }
+
+        // The rest has to be a body (or nothing), otherwise it is an expression we can't resolve.
+        after = lex.skipSpace(after, end);
+        while (after < end && lex.isComment(after)) after = lex.skipSpace(lex.skipComment(after), end);
+        if (after < end && mData[after] != '{' && mData[after] != ';') continue;
+
+        auto itr = mObjectIds.find(name);
+        uint32_t objId;
+        if (itr == mObjectIds.end()) {
+            objId = static_cast<uint32_t>(mObjectNames.size());
+            mObjectIds.emplace(name, objId);
+            mObjectNames.push_back(name);
+            mObjectStatements.emplace_back();
+        } else {
+            objId = itr->second;
+        }
+        stmt.mDefine = static_cast<int32_t>(objId);
+        mObjectStatements[objId].push_back(static_cast<uint32_t>(stmtId));
+    }
+}
+
+void
+AsciiSubsetExtractor::collectReferences()
+//
+// Parallel pass : every ClassName("name") pattern of a statement which names a
+// defined object is a reference. The name table is read only here.
+//
+{
+    const Lexer lex(mData, mSize);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, mStatements.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t stmtId = range.begin(); stmtId < range.end(); ++stmtId) {
+            Statement& stmt = mStatements[stmtId];
+            const size_t end = stmt.mOffset + stmt.mLength;
+            size_t i = stmt.mOffset;
+            while (i < end) {
+                const char c = mData[i];
+                if (lex.isComment(i)) {
+                    i = lex.skipComment(i);
+                } else if (c == '"' || c == '\'') {
+                    i = lex.skipQuoted(i);
+                } else if (c == '[' && lex.longBracketLevel(i) >= 0) {
+                    i = lex.skipLongBracket(i, lex.longBracketLevel(i));
+                } else if (Lexer::isWordHead(c)) {
+                    const size_t wordEnd = lex.skipWord(i);
+                    std::string_view name;
+                    const size_t after = lex.matchNameCall(wordEnd, end, name);
+                    if (after) {
+                        auto itr = mObjectIds.find(name);
+                        if (itr != mObjectIds.end() && static_cast<int32_t>(itr->second) != stmt.mDefine) {
+                            stmt.mRefs.push_back(itr->second);
+                        }
+                        i = after;
+                    } else {
+                        i = wordEnd;
+                    }
+                } else {
+                    ++i;
+                }
+            }
+            std::sort(stmt.mRefs.begin(), stmt.mRefs.end());
+            stmt.mRefs.erase(std::unique(stmt.mRefs.begin(), stmt.mRefs.end()), stmt.mRefs.end());
+        }
+    });
+}
+
+std::vector<char>
+AsciiSubsetExtractor::computeSelection(const std::vector<std::string>& rootNames) const
+//
+// Level synchronous parallel breadth first traversal over the object graph.
+// Returns the per statement selection flags.
+//
+{
+    rec_time::RecTime recTime;
+    recTime.start();
+
+    const size_t objTotal = mObjectNames.size();
+    std::unique_ptr<std::atomic<bool>[]> visited(new std::atomic<bool>[objTotal]);
+    for (size_t i = 0; i < objTotal; ++i) visited[i].store(false, std::memory_order_relaxed);
+
+    std::vector<uint32_t> frontier;
+    auto visit = [&](const uint32_t objId, auto& out) {
+        if (!visited[objId].exchange(true, std::memory_order_relaxed)) out.push_back(objId);
+    };
+
+    for (const std::string& rootName : rootNames) {
+        auto itr = mObjectIds.find(std::string_view(rootName));
+        if (itr != mObjectIds.end()) visit(itr->second, frontier);
+    }
+    // SceneVariables is an implicit root. Its camera, layer, resolution etc. are always needed.
+    auto sceneVarsItr = mObjectIds.find(SCENE_VARIABLES_OBJECT);
+    if (sceneVarsItr != mObjectIds.end()) visit(sceneVarsItr->second, frontier);
+    // Statements which are not object definitions are always kept, so are their references.
+    for (const Statement& stmt : mStatements) {
+        if (stmt.mDefine >= 0) continue;
+        for (const uint32_t ref : stmt.mRefs) visit(ref, frontier);
+    }
+
+    while (!frontier.empty()) {
+        tbb::concurrent_vector<uint32_t> next;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, frontier.size()),
+                          [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++i) {
+                for (const uint32_t stmtId : mObjectStatements[frontier[i]]) {
+                    for (const uint32_t ref : mStatements[stmtId].mRefs) visit(ref, next);
+                }
+            }
+        });
+        frontier.assign(next.begin(), next.end());
+    }
+
+    std::vector<char> selected(mStatements.size(), 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, mStatements.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const int32_t define = mStatements[i].mDefine;
+            selected[i] = (define < 0 || visited[define].load(std::memory_order_relaxed)) ? 1 : 0;
+        }
+    });
+
+    mClosureSec.store(recTime.end(), std::memory_order_relaxed);
+    return selected;
+}
+
+} // namespace rdl2
+} // namespace scene_rdl2
+
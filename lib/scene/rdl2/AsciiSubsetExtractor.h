@@ -0,0 +1,130 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <scene_rdl2/render/util/AtomicFloat.h> // std::atomic<float> has to be the same in all files
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <stdint.h>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+
+/**
+ * AsciiSubsetExtractor picks the part of an RDL ASCII (rdla) file which is
+ * needed by a set of root SceneObjects without evaluating the Lua code.
+ *
+ * The file is memory mapped and split into top level Lua statements by a
+ * light weight lexer (strings, long brackets, comments, bracket nesting and
+ * block keywords are honored). A statement of the form
+ *
+ *      ClassName("objectName") { ... }     (or just ClassName("objectName"))
+ *
+ * defines objectName. Every ClassName("name") pattern inside a statement is a
+ * reference to the SceneObject name. SceneVariables { ... } defines
+ * "__SceneVariables__", which is always added to the roots. All the other
+ * statements (local variables, functions, loops, etc.) can't be resolved
+ * statically, so they are always kept and the objects they reference are added
+ * to the roots.
+ *
+ * References are collected per statement in parallel and the reachability
+ * closure from the roots is computed by a parallel breadth first traversal.
+ * extract() returns the kept statements in the original order as rdla text,
+ * which can be handed to AsciiReader::fromString(). Only the index (statement
+ * ranges and object name table) is kept in memory besides the mapped file.
+ *
+ * Sample usage:
+ *
+ *      AsciiSubsetExtractor extractor;
+ *      extractor.indexFile("shot.rdla");
+ *      AsciiReader reader(context);
+ *      reader.fromString(extractor.extract({"/asset/layer"}), "@shot.rdla");
+ *
+ * AsciiReader::fromFileSubset() wraps this sequence.
+ */
+class AsciiSubsetExtractor
+{
+public:
+    AsciiSubsetExtractor();
+    ~AsciiSubsetExtractor();
+
+    AsciiSubsetExtractor(const AsciiSubsetExtractor&) = delete;
+    AsciiSubsetExtractor& operator=(const AsciiSubsetExtractor&) = delete;
+
+    /**
+     * Memory maps the given rdla file and builds the statement index.
+     *
+     * @throw   except::IoError     If the file can't be opened or mapped.
+     */
+    void indexFile(const std::string& filename);
+
+    /**
+     * Builds the statement index over a copy of the given rdla code.
+     */
+    void indexString(const std::string& code);
+
+    /**
+     * Returns the names of all the objects reachable from the roots
+     * (including the roots themselves and "__SceneVariables__" if the file
+     * has a SceneVariables block), sorted by the first definition in the
+     * file. Roots which are not defined in the file are ignored.
+     */
+    std::vector<std::string> closure(const std::vector<std::string>& rootNames) const;
+
+    /**
+     * Returns the rdla text which only contains the statements needed by the
+     * roots, in the original order.
+     */
+    std::string extract(const std::vector<std::string>& rootNames) const;
+
+    size_t getStatementCount() const { return mStatements.size(); }
+    size_t getObjectCount() const { return mObjectNames.size(); }
+
+    // Index/closure statistics of the last operations
+    std::string show() const;
+
+private:
+    struct Statement
+    {
+        size_t mOffset;
+        size_t mLength;
+        int32_t mDefine;            // object id, -1 : not an object definition
+        std::vector<uint32_t> mRefs; // referenced object ids
+    };
+
+    void clear();
+    void buildIndex();
+    void splitStatements();
+    void collectReferences();
+    std::vector<char> computeSelection(const std::vector<std::string>& rootNames) const;
+
+    const char* mData;
+    size_t mSize;
+    void* mMapAddr;
+    size_t mMapSize;
+    std::string mCode;              // used by indexString()
+
+    std::vector<Statement> mStatements;
+    std::vector<std::string_view> mObjectNames;                // object id -> name
+    std::vector<std::vector<uint32_t>> mObjectStatements;      // object id -> defining statements
+    std::unordered_map<std::string_view, uint32_t> mObjectIds; // name -> object id
+
+    // Statistics of the last operations. closure() and extract() are const and might be called
+    // concurrently, so they are updated atomically.
+    float mIndexSec;
+    mutable std::atomic<float> mClosureSec;
+    mutable std::atomic<size_t> mSelectedStatements;
+    mutable std::atomic<size_t> mSelectedBytes;
+};
+
+} // namespace rdl2
+} // namespace scene_rdl2
+
@@ -23,13 +23,20 @@
 
 #include <scene_rdl2/render/logging/logging.h>
 #include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecZone.h>
 #include <scene_rdl2/render/util/Strings.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
 #include <fstream>
 #include <istream>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <endian.h>
 #include <stdint.h>
 
@@ -38,9 +45,22 @@ using logging::Logger;
 
 namespace rdl2 {
 
+namespace {
+
+// Thrown by BinaryReader::referencedSceneObject() inside the parallel unpack
+// when the referenced SceneObject does not exist yet. Intentionally not an
+// except:: type, so it is not swallowed by the warning handlers of the unpack.
+struct MissingReference {};
+
+} // namespace
+
 BinaryReader::BinaryReader(SceneContext& context) :
     mContext(context),
-    mWarningsAsErrors(false)
+    mWarningsAsErrors(false),
+    mParallelDecoding(false),
+    mDeferMissingReferences(false),
+    mLazyDecoding(false),
+    mLazyMinVectorSize(1024)
 {
 }
 
@@ -65,6 +85,8 @@ BinaryReader::fromFile(const std::string& filename)
 void
 BinaryReader::fromStream(std::istream& input)
 {
+    REC_ZONE("BinaryReader::fromStream");
+
     // Read the manifest length from the stream and convert to native byte order.
     uint64_t manifestLen;
     input.read(reinterpret_cast<char*>(&manifestLen), sizeof(uint64_t));
@@ -83,12 +105,39 @@ BinaryReader::fromStream(std::istream& input)
     std::string payload(payloadLen, '\0');
     input.read(&(payload[0]), payloadLen);
 
-    fromBytes(manifest, payload);
+    if (mLazyDecoding) {
+        // Lazy values keep pointing into the payload, hand it over.
+        mRetainedPayload = std::make_shared<const std::string>(std::move(payload));
+        decodeBytes(manifest, *mRetainedPayload);
+    } else {
+        decodeBytes(manifest, payload);
+    }
 }
 
 void
 BinaryReader::fromBytes(const std::string& manifest, const std::string& payload)
 {
+    if (mLazyDecoding) {
+        // The caller owns payload, lazy values need a copy which outlives it.
+        mRetainedPayload = std::make_shared<const std::string>(payload);
+        decodeBytes(manifest, *mRetainedPayload);
+    } else {
+        decodeBytes(manifest, payload);
+    }
+}
+
+void
+BinaryReader::decodeBytes(const std::string& manifest, const std::string& payload)
+{
+    REC_ZONE("BinaryReader::fromBytes");
+
+    // Only the SceneObjects keep the lazy payload alive after the call.
+    struct RetainedPayloadRelease
+    {
+        ~RetainedPayloadRelease() { mPayload.reset(); }
+        std::shared_ptr<const std::string>& mPayload;
+    } retainedPayloadRelease {mRetainedPayload};
+
     Slice manifestBytes(manifest);
     Slice payloadBytes(payload);
 
@@ -96,8 +145,8 @@ BinaryReader::fromBytes(const std::string& manifest, const std::string& payload)
     RecordInfoVector records;
     readManifest(manifestBytes, records);
 
-    // Loop over records in the manifest and read each out of the payload.
-    // (This could be parallelized fairly easily if it's a bottleneck.)
+    // Verify record types up front so the parallel path fails the same way
+    // as the serial one before touching the SceneContext.
     for (RecordInfoVector::const_iterator iter = records.begin(); iter != records.end(); ++iter) {
         switch (iter->mType) {
         case SCENE_OBJECT :
@@ -109,7 +158,7 @@ BinaryReader::fromBytes(const std::string& manifest, const std::string& payload)
             break;
 
         case SCENE_OBJECT_2 :
-            readSceneObject(Slice(payloadBytes, iter->mOffset, iter->mSize));
+        case DEDUP_TABLE :
             break;
 
         default:
@@ -122,6 +171,31 @@ BinaryReader::fromBytes(const std::string& manifest, const std::string& payload)
             break;
         }
     }
+
+    // The dedup table is written after the objects which reference it, so
+    // read it before any object.
+    mDedupEntries.clear();
+    RecordInfoVector objectRecords;
+    objectRecords.reserve(records.size());
+    for (const RecordInfo& record : records) {
+        if (record.mType == DEDUP_TABLE) {
+            readDedupTable(Slice(payloadBytes, record.mOffset, record.mSize));
+        } else {
+            objectRecords.push_back(record);
+        }
+    }
+
+    if (mParallelDecoding && objectRecords.size() > 1) {
+        readSceneObjectsParallel(payloadBytes, objectRecords);
+    } else {
+        // Loop over records in the manifest and read each out of the payload.
+        for (RecordInfoVector::const_iterator iter = objectRecords.begin(); iter != objectRecords.end(); ++iter) {
+            readSceneObject(Slice(payloadBytes, iter->mOffset, iter->mSize));
+        }
+    }
+
+    // The entries point into the caller's payload.
+    mDedupEntries.clear();
 }
 
 void
@@ -143,21 +217,121 @@ BinaryReader::readManifest(Slice bytes, RecordInfoVector& info)
     }
 }
 
+void
+BinaryReader::readDedupTable(Slice bytes)
+{
+    ValueContainerDeq vContainerDeq(bytes.getData(), bytes.getLength());
+
+    size_t count;
+    vContainerDeq.deqVLSizeT(count);
+    for (size_t i = 0; i < count; ++i) {
+        size_t size;
+        vContainerDeq.deqVLSizeT(size);
+        const void* data = vContainerDeq.skipByteData(size);
+        mDedupEntries.emplace_back(data, size);
+    }
+}
+
 void
 BinaryReader::readSceneObject(Slice bytes)
 {
     const char *ptr = static_cast<const char *>(bytes.getData());
     ValueContainerDeq vContainerDeq(ptr, bytes.getLength());
 
+    SceneObject* sceneObject = createRecordSceneObject(vContainerDeq);
+    if (!sceneObject) return;
+
+    // Unpack the data into the object.
+    unpackSceneObject(vContainerDeq, *sceneObject);
+}
+
+void
+BinaryReader::readSceneObjectsParallel(const Slice& payloadBytes, const RecordInfoVector& records)
+//
+// SceneObject creation (which may load DSOs and decides the object order inside the
+// SceneContext) is done serially in manifest order. Only unpacking of attribute values,
+// which dominates the decode cost, runs in parallel. SceneContext::createSceneObject() is
+// thread safe, so lookups of referenced objects from the worker threads are fine.
+//
+{
+    const size_t total = records.size();
+    std::vector<SceneObject*> sceneObjects(total, nullptr);
+    std::unordered_set<SceneObject*> uniqueObjects;
+    bool duplicated = false;
+    for (size_t i = 0; i < total; ++i) {
+        const Slice bytes(payloadBytes, records[i].mOffset, records[i].mSize);
+        ValueContainerDeq vContainerDeq(bytes.getData(), bytes.getLength());
+        sceneObjects[i] = createRecordSceneObject(vContainerDeq);
+        if (sceneObjects[i] && !uniqueObjects.insert(sceneObjects[i]).second) {
+            duplicated = true;
+        }
+    }
+
+    auto unpackRecord = [&](const size_t i) {
+        if (!sceneObjects[i]) return;
+        const Slice bytes(payloadBytes, records[i].mOffset, records[i].mSize);
+        ValueContainerDeq vContainerDeq(bytes.getData(), bytes.getLength());
+        std::string klassName, objName;
+        vContainerDeq.deqString(klassName);
+        vContainerDeq.deqString(objName);
+        unpackSceneObject(vContainerDeq, *sceneObjects[i]);
+    };
+
+    if (duplicated) {
+        // Later records have to override earlier ones. Keep the record order.
+        for (size_t i = 0; i < total; ++i) unpackRecord(i);
+        return;
+    }
+
+    // The worker threads never create SceneObjects, so the creation order
+    // (i.e. SceneContext cameras and geometries) does not depend on the
+    // thread timing. A record which references a SceneObject that is neither
+    // in the context nor defined by the data is unpacked again serially
+    // afterwards, in manifest order. Unpacking a record is idempotent.
+    std::vector<char> deferred(total, 0);
+    mDeferMissingReferences = true;
+    try {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, total),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i < range.end(); ++i) {
+                                  try {
+                                      unpackRecord(i);
+                                  } catch (const MissingReference&) {
+                                      deferred[i] = 1;
+                                  }
+                              }
+                          });
+    } catch (...) {
+        mDeferMissingReferences = false;
+        throw;
+    }
+    mDeferMissingReferences = false;
+
+    for (size_t i = 0; i < total; ++i) {
+        if (deferred[i]) unpackRecord(i);
+    }
+}
+
+SceneObject*
+BinaryReader::referencedSceneObject(const std::string& klassName, const std::string& objName) const
+{
+    if (mDeferMissingReferences && !mContext.sceneObjectExists(objName)) {
+        throw MissingReference();
+    }
+    return mContext.createSceneObject(klassName, objName);
+}
+
+SceneObject*
+BinaryReader::createRecordSceneObject(ValueContainerDeq &vContainerDeq)
+{
     std::string klassName;
     std::string objName;
     vContainerDeq.deqString(klassName);
     vContainerDeq.deqString(objName);
 
-    SceneObject* sceneObject = nullptr;
     try {
         // Create the SceneObject.
-        sceneObject = mContext.createSceneObject(klassName, objName);
+        return mContext.createSceneObject(klassName, objName);
     } catch (except::IoError& e) {
         // Couldn't load DSO.
         std::string msg = util::buildString(objName, ": ", e.what());
@@ -166,11 +340,8 @@ BinaryReader::readSceneObject(Slice bytes)
         } else {
             logging::Logger::warn(msg);
         }
-        return;
     }
-
-    // Unpack the data into the object.
-    unpackSceneObject(vContainerDeq, *sceneObject);
+    return nullptr;
 }
 
 void
@@ -199,53 +370,53 @@ BinaryReader::unpackLayer(BinaryReaderLayerUnpackStrings &layerStrVectors, Layer
         // Unpack the geometry
         SceneObject *geomObj = nullptr;
         if (!geomKlassName[i].empty() && !geomObjName[i].empty()) {
-            geomObj = mContext.createSceneObject(geomKlassName[i], geomObjName[i]);
+            geomObj = referencedSceneObject(geomKlassName[i], geomObjName[i]);
         }
 
         // Unpack the material, might be null
         SceneObject* materialObj = nullptr;
         if (!materialKlassName.empty() && !materialKlassName[i].empty() && !materialObjName[i].empty()) {
-            materialObj = mContext.createSceneObject(materialKlassName[i], materialObjName[i]);
+            materialObj = referencedSceneObject(materialKlassName[i], materialObjName[i]);
         }
 
         // Unpack the lightset
         SceneObject* lightSetObj = nullptr;
         if (!lightSetKlassName.empty() && !lightSetKlassName[i].empty() && !lightSetObjName[i].empty()) {
-            lightSetObj = mContext.createSceneObject(lightSetKlassName[i], lightSetObjName[i]);
+            lightSetObj = referencedSceneObject(lightSetKlassName[i], lightSetObjName[i]);
         }
 
         // Unpack the lightfilterset
         SceneObject* lightFilterSetObj = nullptr;
         if (!lightFilterSetKlassName.empty() && !lightFilterSetKlassName[i].empty() &&
                 !lightFilterSetObjName[i].empty()) {
-            lightFilterSetObj = mContext.createSceneObject(lightFilterSetKlassName[i], lightFilterSetObjName[i]);
+            lightFilterSetObj = referencedSceneObject(lightFilterSetKlassName[i], lightFilterSetObjName[i]);
         }
 
         // Unpack the shadowset
         SceneObject* shadowSetObj = nullptr;
         if (!shadowSetKlassName.empty() && !shadowSetKlassName[i].empty() &&
                 !shadowSetObjName[i].empty()) {
-            shadowSetObj = mContext.createSceneObject(shadowSetKlassName[i], shadowSetObjName[i]);
+            shadowSetObj = referencedSceneObject(shadowSetKlassName[i], shadowSetObjName[i]);
         }
 
         // Unpack the shadowreceiverset
         SceneObject* shadowReceiverSetObj = nullptr;
         if (!shadowReceiverSetKlassName.empty() && !shadowReceiverSetKlassName[i].empty()
                                                 && !shadowReceiverSetObjName[i].empty()) {
-            shadowReceiverSetObj = mContext.createSceneObject(shadowReceiverSetKlassName[i],
+            shadowReceiverSetObj = referencedSceneObject(shadowReceiverSetKlassName[i],
                                                               shadowReceiverSetObjName[i]);
         }
 
         // Unpack the displacement, might be null
         SceneObject* displacementObj = nullptr;
         if (!displacementKlassName.empty() && !displacementKlassName[i].empty() && !displacementObjName[i].empty()) {
-            displacementObj = mContext.createSceneObject(displacementKlassName[i], displacementObjName[i]);
+            displacementObj = referencedSceneObject(displacementKlassName[i], displacementObjName[i]);
         }
 
         // Unpack the volumeShader, might be null
         SceneObject* volumeShaderObj = nullptr;
         if (!volumeShaderKlassName.empty() && !volumeShaderKlassName[i].empty() && !volumeShaderObjName[i].empty()) {
-            volumeShaderObj = mContext.createSceneObject(volumeShaderKlassName[i], volumeShaderObjName[i]);
+            volumeShaderObj = referencedSceneObject(volumeShaderKlassName[i], volumeShaderObjName[i]);
         }
 
         LayerAssignment layerAssignment;
@@ -357,7 +528,7 @@ BinaryReader::unpackSceneObject(ValueContainerDeq &vContainerDeq, SceneObject& s
             if (!sceneObject.isA<Layer>()) {
                 SceneObject *targetObject = nullptr;
                 if (!klassName.empty() && !objName.empty()) {
-                    targetObject = mContext.createSceneObject(klassName, objName);
+                    targetObject = referencedSceneObject(klassName, objName);
                 }
 
                 // Set the binding.
@@ -404,14 +575,224 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
                            int attributeId,
                            std::string &attributeName) const
 {
-    int timestepInt;
-    {
-        unsigned char uc;
-        vContainerDeq.deqUChar(uc);
-        timestepInt = static_cast<int>(uc);
+    unsigned char uc;
+    vContainerDeq.deqUChar(uc);
+
+    if (uc & DEDUP_VALUE_FLAG) {
+        // The value is stored in the dedup table.
+        AttributeTimestep timestep =
+            static_cast<AttributeTimestep>(static_cast<int>(uc & ~DEDUP_VALUE_FLAG));
+        size_t entryId = vContainerDeq.deqVLSizeT();
+        if (entryId >= mDedupEntries.size()) {
+            std::stringstream errMsg;
+            errMsg << "Dedup table entry " << entryId << " is out of range (" <<
+                mDedupEntries.size() << " entries) while parsing RDL2 binary file.";
+            throw except::IndexError(errMsg.str());
+        }
+        const Slice& entry = mDedupEntries[entryId].mBytes;
+        ValueContainerDeq entryDeq(entry.getData(), entry.getLength());
+        if (mLazyDecoding &&
+            deferValue(entryDeq, sceneObject, valueType, false,
+                       transientEncoding, attributeId, attributeName)) {
+            return;
+        }
+        if (shareDedupValue(entryId, sceneObject, valueType, timestep,
+                            transientEncoding, attributeId, attributeName)) {
+            return;
+        }
+        unpackValueData(entryDeq, sceneObject, valueType, timestep,
+                        transientEncoding, attributeId, attributeName);
+        return;
+    }
+
+    if (mLazyDecoding &&
+        deferValue(vContainerDeq, sceneObject, valueType, true,
+                   transientEncoding, attributeId, attributeName)) {
+        return;
     }
-    AttributeTimestep timestep = static_cast<AttributeTimestep>(static_cast<int>(timestepInt));
 
+    AttributeTimestep timestep = static_cast<AttributeTimestep>(static_cast<int>(uc));
+    unpackValueData(vContainerDeq, sceneObject, valueType, timestep,
+                    transientEncoding, attributeId, attributeName);
+}
+
+template <typename T, typename F>
+bool
+BinaryReader::shareDecodedValue(const DedupEntry& entry, ValueContainerUtil::ValueType valueType,
+                                SceneObject &sceneObject, const Attribute& attr, AttributeTimestep timestep,
+                                F deq) const
+{
+    std::call_once(entry.mDecodeFlag, [&]() {
+        auto value = std::make_shared<T>();
+        ValueContainerDeq valueDeq(entry.mBytes.getData(), entry.mBytes.getLength());
+        deq(valueDeq, *value);
+        entry.mValueType = valueType;
+        entry.mValue = std::move(value);
+    });
+
+    // Another object decoded the entry as a different type (broken file).
+    if (entry.mValueType != valueType) return false;
+
+    sceneObject.setShared(AttributeKey<T>(attr), std::static_pointer_cast<const T>(entry.mValue), timestep);
+    return true;
+}
+
+bool
+BinaryReader::shareDedupValue(std::size_t entryId,
+                              SceneObject &sceneObject,
+                              ValueContainerUtil::ValueType valueType,
+                              AttributeTimestep timestep,
+                              bool transientEncoding,
+                              int attributeId,
+                              const std::string &attributeName) const
+{
+    using ValueType = ValueContainerUtil::ValueType;
+
+    // Unknown attributes and type mismatches are reported by unpackValueData().
+    const SceneClass& sceneClass = sceneObject.getSceneClass();
+    const Attribute* attr = nullptr;
+    if (transientEncoding) {
+        attr = sceneClass.mAttributes[attributeId];
+    } else {
+        auto iter = sceneClass.mNameMap.find(attributeName);
+        if (iter == sceneClass.mNameMap.end()) return false;
+        attr = iter->second;
+    }
+    const ValueType attrValueType = ValueContainerUtil::rdlType2ValueType(attr->getType());
+    if (attrValueType != valueType &&
+        !(valueType == ValueType::INT_VECTOR_STREAM_VBYTE && attrValueType == ValueType::INT_VECTOR)) {
+        return false;
+    }
+
+    const DedupEntry& entry = mDedupEntries[entryId];
+    switch (valueType) {
+    case ValueType::INT_VECTOR :
+        return shareDecodedValue<IntVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, IntVector& vec) { deq.deqVLIntVector(vec); });
+    case ValueType::INT_VECTOR_STREAM_VBYTE :
+        return shareDecodedValue<IntVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, IntVector& vec) { deq.deqStreamVByteIntVector(vec); });
+    case ValueType::LONG_VECTOR :
+        return shareDecodedValue<LongVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, LongVector& vec) { deq.deqVLLongVector(vec); });
+    case ValueType::FLOAT_VECTOR :
+        return shareDecodedValue<FloatVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, FloatVector& vec) { deq.deqFloatVector(vec); });
+    case ValueType::DOUBLE_VECTOR :
+        return shareDecodedValue<DoubleVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, DoubleVector& vec) { deq.deqDoubleVector(vec); });
+    case ValueType::STRING_VECTOR :
+        return shareDecodedValue<StringVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, StringVector& vec) { deq.deqStringVector(vec); });
+    case ValueType::RGB_VECTOR :
+        return shareDecodedValue<RgbVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, RgbVector& vec) { deq.deqRgbVector(vec); });
+    case ValueType::RGBA_VECTOR :
+        return shareDecodedValue<RgbaVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, RgbaVector& vec) { deq.deqRgbaVector(vec); });
+    case ValueType::VEC2F_VECTOR :
+        return shareDecodedValue<Vec2fVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Vec2fVector& vec) { deq.deqVec2fVector(vec); });
+    case ValueType::VEC2D_VECTOR :
+        return shareDecodedValue<Vec2dVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Vec2dVector& vec) { deq.deqVec2dVector(vec); });
+    case ValueType::VEC3F_VECTOR :
+        return shareDecodedValue<Vec3fVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Vec3fVector& vec) { deq.deqVec3fVector(vec); });
+    case ValueType::VEC3D_VECTOR :
+        return shareDecodedValue<Vec3dVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Vec3dVector& vec) { deq.deqVec3dVector(vec); });
+    case ValueType::VEC4F_VECTOR :
+        return shareDecodedValue<Vec4fVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Vec4fVector& vec) { deq.deqVec4fVector(vec); });
+    case ValueType::VEC4D_VECTOR :
+        return shareDecodedValue<Vec4dVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Vec4dVector& vec) { deq.deqVec4dVector(vec); });
+    case ValueType::MAT4F_VECTOR :
+        return shareDecodedValue<Mat4fVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Mat4fVector& vec) { deq.deqMat4fVector(vec); });
+    case ValueType::MAT4D_VECTOR :
+        return shareDecodedValue<Mat4dVector>(entry, valueType, sceneObject, *attr, timestep,
+            [](ValueContainerDeq& deq, Mat4dVector& vec) { deq.deqMat4dVector(vec); });
+    default : return false; // BoolVector isn't a std::vector, it's copied by unpackValueData()
+    }
+}
+
+bool
+BinaryReader::deferValue(ValueContainerDeq &vContainerDeq,
+                         SceneObject &sceneObject,
+                         ValueContainerUtil::ValueType valueType,
+                         bool skipValue,
+                         bool transientEncoding,
+                         int attributeId,
+                         const std::string &attributeName) const
+{
+    using ValueType = ValueContainerUtil::ValueType;
+
+    // Encoded element size of the fixed size vectors, 0 for strings and
+    // the variable length encoded Int/Long vectors.
+    size_t elemSize = 0;
+    bool variableLength = false;
+    switch (valueType) {
+    case ValueType::BOOL_VECTOR :   elemSize = sizeof(char); break;
+    case ValueType::INT_VECTOR :    variableLength = true; break; // enqVLIntVector()
+    case ValueType::LONG_VECTOR :   variableLength = true; break; // enqVLLongVector()
+    case ValueType::FLOAT_VECTOR :  elemSize = sizeof(Float); break;
+    case ValueType::DOUBLE_VECTOR : elemSize = sizeof(Double); break;
+    case ValueType::STRING_VECTOR : elemSize = 0; break;
+    case ValueType::RGB_VECTOR :    elemSize = sizeof(Rgb); break;
+    case ValueType::RGBA_VECTOR :   elemSize = sizeof(Rgba); break;
+    case ValueType::VEC2F_VECTOR :  elemSize = sizeof(Vec2f); break;
+    case ValueType::VEC2D_VECTOR :  elemSize = sizeof(Vec2d); break;
+    case ValueType::VEC3F_VECTOR :  elemSize = sizeof(Vec3f); break;
+    case ValueType::VEC3D_VECTOR :  elemSize = sizeof(Vec3d); break;
+    case ValueType::VEC4F_VECTOR :  elemSize = sizeof(Vec4f); break;
+    case ValueType::VEC4D_VECTOR :  elemSize = sizeof(Vec4d); break;
+    case ValueType::MAT4F_VECTOR :  elemSize = sizeof(Mat4f); break;
+    case ValueType::MAT4D_VECTOR :  elemSize = sizeof(Mat4d); break;
+    default : return false; // scalars and SceneObject references
+    }
+
+    // Unknown attributes and type mismatches are reported by the eager path.
+    const SceneClass& sceneClass = sceneObject.getSceneClass();
+    const Attribute* attr = nullptr;
+    if (transientEncoding) {
+        attr = sceneClass.mAttributes[attributeId];
+    } else {
+        auto iter = sceneClass.mNameMap.find(attributeName);
+        if (iter == sceneClass.mNameMap.end()) return false;
+        attr = iter->second;
+    }
+    if (ValueContainerUtil::rdlType2ValueType(attr->getType()) != valueType) return false;
+
+    ValueContainerDeq valueDeq(vContainerDeq);
+    const size_t size = ValueContainerDeq(vContainerDeq).deqVLSizeT();
+    if (size < mLazyMinVectorSize) return false;
+
+    if (skipValue) {
+        vContainerDeq.deqVLSizeT();
+        if (variableLength) {
+            vContainerDeq.skipVLValues(size);
+        } else if (elemSize) {
+            vContainerDeq.skipByteData(elemSize * size);
+        } else {
+            for (size_t i = 0; i < size; ++i) vContainerDeq.skipString();
+        }
+    }
+
+    sceneObject.addLazyValue(*attr, valueDeq, mRetainedPayload);
+    return true;
+}
+
+void
+BinaryReader::unpackValueData(ValueContainerDeq &vContainerDeq,
+                              SceneObject &sceneObject,
+                              ValueContainerUtil::ValueType valueType,
+                              AttributeTimestep timestep,
+                              bool transientEncoding,
+                              int attributeId,
+                              std::string &attributeName) const
+{
     const SceneClass& sceneClass = sceneObject.getSceneClass();
 
     switch (valueType) {
@@ -437,7 +818,7 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
     } break;
     case ValueContainerUtil::ValueType::STRING : {
         String val; vContainerDeq.deqString(val);
-        sceneObject.set(keyGen<String>(transientEncoding, attributeId, attributeName, sceneClass), val, timestep);
+        sceneObject.set(keyGen<String>(transientEncoding, attributeId, attributeName, sceneClass), std::move(val), timestep);
     } break;
     case ValueContainerUtil::ValueType::RGB : {
         Rgb val; vContainerDeq.deqRgb(val);
@@ -485,7 +866,7 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
         vContainerDeq.deqSceneObject(klassName, objName);
         SceneObject *targetObject = nullptr;
         if (!klassName.empty() && !objName.empty()) {
-            targetObject = mContext.createSceneObject(klassName, objName);
+            targetObject = referencedSceneObject(klassName, objName);
         }
         sceneObject.set(keyGen<SceneObject *>(transientEncoding, attributeId, attributeName, sceneClass), targetObject);
     } break;
@@ -494,67 +875,71 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
 
     case ValueContainerUtil::ValueType::BOOL_VECTOR : {
         BoolVector vec; vContainerDeq.deqBoolVector(vec);
-        sceneObject.set(keyGen<BoolVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<BoolVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::INT_VECTOR : {
         IntVector vec; vContainerDeq.deqVLIntVector(vec); // We are using VariableLength version
-        sceneObject.set(keyGen<IntVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<IntVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
+    } break;
+    case ValueContainerUtil::ValueType::INT_VECTOR_STREAM_VBYTE : {
+        IntVector vec; vContainerDeq.deqStreamVByteIntVector(vec);
+        sceneObject.set(keyGen<IntVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::LONG_VECTOR : {
         LongVector vec; vContainerDeq.deqVLLongVector(vec); // We are using VariableLength version
-        sceneObject.set(keyGen<LongVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<LongVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::FLOAT_VECTOR : {
         FloatVector vec; vContainerDeq.deqFloatVector(vec);
-        sceneObject.set(keyGen<FloatVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<FloatVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::DOUBLE_VECTOR : {
         DoubleVector vec; vContainerDeq.deqDoubleVector(vec);
-        sceneObject.set(keyGen<DoubleVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<DoubleVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::STRING_VECTOR : {
         StringVector vec; vContainerDeq.deqStringVector(vec);
-        sceneObject.set(keyGen<StringVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<StringVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::RGB_VECTOR : {
         RgbVector vec; vContainerDeq.deqRgbVector(vec);
-        sceneObject.set(keyGen<RgbVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<RgbVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::RGBA_VECTOR : {
         RgbaVector vec; vContainerDeq.deqRgbaVector(vec);
-        sceneObject.set(keyGen<RgbaVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<RgbaVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::VEC2F_VECTOR : {
         Vec2fVector vec; vContainerDeq.deqVec2fVector(vec);
-        sceneObject.set(keyGen<Vec2fVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Vec2fVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::VEC2D_VECTOR : {
         Vec2dVector vec; vContainerDeq.deqVec2dVector(vec);
-        sceneObject.set(keyGen<Vec2dVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Vec2dVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::VEC3F_VECTOR : {
         Vec3fVector vec; vContainerDeq.deqVec3fVector(vec);
-        sceneObject.set(keyGen<Vec3fVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Vec3fVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::VEC3D_VECTOR : {
         Vec3dVector vec; vContainerDeq.deqVec3dVector(vec);
-        sceneObject.set(keyGen<Vec3dVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Vec3dVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::VEC4F_VECTOR : {
         Vec4fVector vec; vContainerDeq.deqVec4fVector(vec);
-        sceneObject.set(keyGen<Vec4fVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Vec4fVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::VEC4D_VECTOR : {
         Vec4dVector vec; vContainerDeq.deqVec4dVector(vec);
-        sceneObject.set(keyGen<Vec4dVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Vec4dVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::MAT4F_VECTOR : {
         Mat4fVector vec; vContainerDeq.deqMat4fVector(vec);
-        sceneObject.set(keyGen<Mat4fVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Mat4fVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
     case ValueContainerUtil::ValueType::MAT4D_VECTOR : {
         Mat4dVector vec; vContainerDeq.deqMat4dVector(vec);
-        sceneObject.set(keyGen<Mat4dVector>(transientEncoding, attributeId, attributeName, sceneClass), vec, timestep);
+        sceneObject.set(keyGen<Mat4dVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec), timestep);
     } break;
 
     case ValueContainerUtil::ValueType::SCENE_OBJECT_VECTOR : {
@@ -565,7 +950,7 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
         for (size_t i = 0; i < size; ++i) {
             SceneObject *targetObject = nullptr;
             if (!klassNameVec[i].empty() && !objNameVec[i].empty()) {
-                targetObject = mContext.createSceneObject(klassNameVec[i], objNameVec[i]);
+                targetObject = referencedSceneObject(klassNameVec[i], objNameVec[i]);
             }
             vec[i] = targetObject;
         }
@@ -579,7 +964,7 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
             std::sort(vec.begin(), vec.end());
         }
 
-        sceneObject.set(keyGen<SceneObjectVector>(transientEncoding, attributeId, attributeName, sceneClass), vec);
+        sceneObject.set(keyGen<SceneObjectVector>(transientEncoding, attributeId, attributeName, sceneClass), std::move(vec));
     } break;
 
     case ValueContainerUtil::ValueType::SCENE_OBJECT_INDEXABLE : {
@@ -590,7 +975,7 @@ BinaryReader::unpackValue(ValueContainerDeq &vContainerDeq,
         for (size_t i = 0; i < size; ++i) {
             SceneObject *targetObject = nullptr;
             if (!klassNameVec[i].empty() && !objNameVec[i].empty()) {
-                targetObject = mContext.createSceneObject(klassNameVec[i], objNameVec[i]);
+                targetObject = referencedSceneObject(klassNameVec[i], objNameVec[i]);
             }
             vec[i] = targetObject;
         }
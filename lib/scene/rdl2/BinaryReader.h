@@ -11,7 +11,9 @@
 #include "SceneClass.h"
 
 #include <cstddef>
+#include <deque>
 #include <istream>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <memory>
@@ -99,9 +101,14 @@ public:
     {
         UNKNOWN = 0,
         SCENE_OBJECT = 1,
-        SCENE_OBJECT_2 = 2
+        SCENE_OBJECT_2 = 2,
+        DEDUP_TABLE = 3
     };
 
+    // Set in the timestep byte of a value stored in the DEDUP_TABLE record.
+    // Must match BinaryWriter::DEDUP_VALUE_FLAG.
+    static constexpr unsigned char DEDUP_VALUE_FLAG = 0x80;
+
     /**
      * Constructs a BinaryReader that will decode RDL binary into the given
      * SceneContext.
@@ -153,7 +160,48 @@ public:
      */
     finline void setWarningsAsErrors(bool warningsAsErrors);
 
+    /**
+     * When enabled, fromBytes() creates all the SceneObjects in manifest order
+     * first and then unpacks the attribute values of every record in
+     * parallel. SceneObjects are only created serially, so the creation order
+     * (which decides SceneContext::getPrimaryCamera() fallback, camera and
+     * geometry iteration order) is the same as the serial decode for data
+     * written by BinaryWriter. SceneObjects which are only referenced (neither
+     * in the context nor defined in the data) are created by a serial pass
+     * after the parallel unpack, in manifest order, so they come after the
+     * defined ones. If the same SceneObject is defined by more than one
+     * record, the records are unpacked serially in order. Disabled by default.
+     *
+     * @param   parallelDecoding    True to unpack records in parallel.
+     */
+    finline void setParallelDecoding(bool parallelDecoding);
+
+    /**
+     * When enabled, vector attribute values with at least minVectorSize
+     * elements are not decoded by fromBytes(). The SceneObject keeps their
+     * position inside the payload and decodes each of them on the first
+     * get() (thread safe), so consumers which never look at the large
+     * vectors (lighting tools, rdl2_print, etc.) skip their decode and
+     * allocations entirely. The payload is kept alive until the last lazy
+     * value referencing it is decoded: fromStream()/fromFile() hand over
+     * their buffer, fromBytes() makes one copy of the payload.
+     *
+     * The attribute set/update flags are raised when the value is read, even
+     * if it turns out to be equal to the current value. Code reading the
+     * attribute storage without get() (e.g. ISPC shaders) has to call
+     * SceneObject::materializeLazyValues() first. SceneObject references are
+     * always decoded eagerly. Disabled by default.
+     *
+     * @param   lazyDecoding    True to defer the decode of large vectors.
+     * @param   minVectorSize   Minimum number of elements of a deferred value.
+     */
+    finline void setLazyDecoding(bool lazyDecoding, std::size_t minVectorSize = 1024);
+
 private:
+    // Shared implementation of fromStream() and fromBytes(). payload is
+    // owned by mRetainedPayload in lazy mode.
+    void decodeBytes(const std::string& manifest, const std::string& payload);
+
     // Internal structure for tracking message types, sizes, and offsets when
     // decoding the manifest.
     struct RecordInfo
@@ -170,9 +218,24 @@ private:
     // Helper function to decode the manifest and compute message offsets.
     void readManifest(Slice bytes, RecordInfoVector& info);
 
+    // Helper function for reading the DEDUP_TABLE record into mDedupEntries.
+    void readDedupTable(Slice bytes);
+
     // Helper function for reading SceneObject messages out of the payload.
     void readSceneObject(Slice bytes);
 
+    // Parallel version of the record loop inside fromBytes().
+    void readSceneObjectsParallel(const Slice& payloadBytes, const RecordInfoVector& records);
+
+    // Helper function which creates the SceneObject of the record.
+    // Returns nullptr if the DSO could not be loaded and warningsAsErrors is off.
+    SceneObject* createRecordSceneObject(ValueContainerDeq &vContainerDeq);
+
+    // Helper function which returns the SceneObject referenced by a value,
+    // creating it if needed. Inside the parallel unpack it throws instead of
+    // creating the SceneObject.
+    SceneObject* referencedSceneObject(const std::string& klassName, const std::string& objName) const;
+
     // Helper function for unpacking a Layer object one assignment
     // at a time
     void unpackLayer(BinaryReaderLayerUnpackStrings &layerStrVectors, Layer &layer) const;
@@ -186,9 +249,33 @@ private:
     void unpackValue(ValueContainerDeq &vContainerDeq, SceneObject &sceneObject,
                      ValueContainerUtil::ValueType valueType,
                      bool transientEncoding, int attributeId, std::string &attributeName) const;
+    void unpackValueData(ValueContainerDeq &vContainerDeq, SceneObject &sceneObject,
+                         ValueContainerUtil::ValueType valueType, AttributeTimestep timestep,
+                         bool transientEncoding, int attributeId, std::string &attributeName) const;
     void unpackLayerValue(ValueContainerDeq &vContainerDeq, BinaryReaderLayerUnpackStrings &layerStrVectors,
                           ValueContainerUtil::ValueType valueType, const std::string &attrName) const;
 
+    // Helper function which sets a value of the DEDUP_TABLE record as a
+    // shared value of the SceneObject, the entry is decoded by the first
+    // object which references it. Returns false if the value has to be
+    // unpacked by unpackValueData() instead.
+    bool shareDedupValue(std::size_t entryId, SceneObject &sceneObject,
+                         ValueContainerUtil::ValueType valueType, AttributeTimestep timestep,
+                         bool transientEncoding, int attributeId, const std::string &attributeName) const;
+
+    struct DedupEntry;
+    template <typename T, typename F>
+    bool shareDecodedValue(const DedupEntry& entry, ValueContainerUtil::ValueType valueType,
+                           SceneObject &sceneObject, const Attribute& attr, AttributeTimestep timestep,
+                           F deq) const;
+
+    // Helper function which registers a large vector value as a lazy value
+    // of the SceneObject (and skips it when skipValue is set). Returns false
+    // if the value has to be decoded eagerly.
+    bool deferValue(ValueContainerDeq &vContainerDeq, SceneObject &sceneObject,
+                    ValueContainerUtil::ValueType valueType, bool skipValue,
+                    bool transientEncoding, int attributeId, const std::string &attributeName) const;
+
     // Generate attribute key
     template <typename T> AttributeKey<T> keyGen(bool transientEncoding, int attrId, std::string &attrName,
                                                  const SceneClass &sceneClass) const {
@@ -199,6 +286,29 @@ private:
     SceneContext& mContext;
 
     bool mWarningsAsErrors;
+    bool mParallelDecoding;
+    bool mDeferMissingReferences; // only set during the parallel unpack
+    bool mLazyDecoding;
+    std::size_t mLazyMinVectorSize;
+
+    // Payload of the current lazy fromBytes() call. Shared with the
+    // SceneObjects which hold lazy values.
+    std::shared_ptr<const std::string> mRetainedPayload;
+
+    // An entry of the DEDUP_TABLE record. The decoded value is shared by all
+    // the objects which reference the entry.
+    struct DedupEntry
+    {
+        DedupEntry(const void* data, std::size_t size) : mBytes(data, size) {}
+
+        Slice mBytes; // points into the payload
+        mutable std::once_flag mDecodeFlag;
+        mutable ValueContainerUtil::ValueType mValueType;
+        mutable std::shared_ptr<const void> mValue;
+    };
+
+    // Entries of the DEDUP_TABLE record of the current fromBytes() call.
+    std::deque<DedupEntry> mDedupEntries;
 };
 
 void
@@ -207,6 +317,19 @@ BinaryReader::setWarningsAsErrors(bool warningsAsErrors)
     mWarningsAsErrors = warningsAsErrors;
 }
 
+void
+BinaryReader::setParallelDecoding(bool parallelDecoding)
+{
+    mParallelDecoding = parallelDecoding;
+}
+
+void
+BinaryReader::setLazyDecoding(bool lazyDecoding, std::size_t minVectorSize)
+{
+    mLazyDecoding = lazyDecoding;
+    mLazyMinVectorSize = minVectorSize;
+}
+
 } // namespace rdl2
 } // namespace scene_rdl2
 
@@ -10,15 +10,25 @@
 #include "SceneObject.h"
 #include "Types.h"
 #include "ValueContainerEnq.h"
+#include "ValueContainerSink.h"
 #include "Utils.h"
 
 #include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecZone.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include <cstddef>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <endian.h>
 #include <stdint.h>
 
@@ -39,15 +49,193 @@ isSkippedInSplitMode(const SceneObject& so)
             so.isA<Metadata>());
 }
 
+// Vector types whose values are deduplicated. SceneObject references are
+// short and resolved by name on the reader side, so they are always inlined.
+bool
+isDedupType(AttributeType type)
+{
+    switch (type) {
+    case TYPE_BOOL_VECTOR:
+    case TYPE_INT_VECTOR:
+    case TYPE_LONG_VECTOR:
+    case TYPE_FLOAT_VECTOR:
+    case TYPE_DOUBLE_VECTOR:
+    case TYPE_STRING_VECTOR:
+    case TYPE_RGB_VECTOR:
+    case TYPE_RGBA_VECTOR:
+    case TYPE_VEC2F_VECTOR:
+    case TYPE_VEC2D_VECTOR:
+    case TYPE_VEC3F_VECTOR:
+    case TYPE_VEC3D_VECTOR:
+    case TYPE_VEC4F_VECTOR:
+    case TYPE_VEC4D_VECTOR:
+    case TYPE_MAT4F_VECTOR:
+    case TYPE_MAT4D_VECTOR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Hash of the source data of a dedup candidate, the fixed size element
+// vectors are hashed as raw bytes.
+template <typename T>
+std::size_t
+hashValues(const std::vector<T>& values)
+{
+    return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(values.data()),
+                                                          values.size() * sizeof(T)));
+}
+
+std::size_t
+hashValues(const StringVector& values)
+{
+    std::size_t hash = values.size();
+    for (const String& value : values) hash = hash * 31 + std::hash<String>()(value);
+    return hash;
+}
+
+std::size_t
+hashValues(const BoolVector& values)
+{
+    std::size_t hash = values.size();
+    for (Bool value : values) hash = hash * 31 + static_cast<std::size_t>(value);
+    return hash;
+}
+
+// Bitwise compare, values which compare equal but encode differently
+// (0.0 and -0.0) must not share an entry.
+template <typename T>
+bool
+isSameValues(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+bool
+isSameValues(const StringVector& a, const StringVector& b)
+{
+    return a == b;
+}
+
+bool
+isSameValues(const BoolVector& a, const BoolVector& b)
+{
+    return a == b;
+}
+
+// Calls func with the value of an attribute of one of the dedup types.
+template <typename F>
+void
+visitDedupValue(const SceneObject& sObj, const Attribute& attr, int timeStep, F func)
+{
+    const AttributeTimestep timestep = static_cast<AttributeTimestep>(timeStep);
+    switch (attr.getType()) {
+    case TYPE_BOOL_VECTOR:   func(sObj.get(AttributeKey<BoolVector>(attr), timestep)); break;
+    case TYPE_INT_VECTOR:    func(sObj.get(AttributeKey<IntVector>(attr), timestep)); break;
+    case TYPE_LONG_VECTOR:   func(sObj.get(AttributeKey<LongVector>(attr), timestep)); break;
+    case TYPE_FLOAT_VECTOR:  func(sObj.get(AttributeKey<FloatVector>(attr), timestep)); break;
+    case TYPE_DOUBLE_VECTOR: func(sObj.get(AttributeKey<DoubleVector>(attr), timestep)); break;
+    case TYPE_STRING_VECTOR: func(sObj.get(AttributeKey<StringVector>(attr), timestep)); break;
+    case TYPE_RGB_VECTOR:    func(sObj.get(AttributeKey<RgbVector>(attr), timestep)); break;
+    case TYPE_RGBA_VECTOR:   func(sObj.get(AttributeKey<RgbaVector>(attr), timestep)); break;
+    case TYPE_VEC2F_VECTOR:  func(sObj.get(AttributeKey<Vec2fVector>(attr), timestep)); break;
+    case TYPE_VEC2D_VECTOR:  func(sObj.get(AttributeKey<Vec2dVector>(attr), timestep)); break;
+    case TYPE_VEC3F_VECTOR:  func(sObj.get(AttributeKey<Vec3fVector>(attr), timestep)); break;
+    case TYPE_VEC3D_VECTOR:  func(sObj.get(AttributeKey<Vec3dVector>(attr), timestep)); break;
+    case TYPE_VEC4F_VECTOR:  func(sObj.get(AttributeKey<Vec4fVector>(attr), timestep)); break;
+    case TYPE_VEC4D_VECTOR:  func(sObj.get(AttributeKey<Vec4dVector>(attr), timestep)); break;
+    case TYPE_MAT4F_VECTOR:  func(sObj.get(AttributeKey<Mat4fVector>(attr), timestep)); break;
+    case TYPE_MAT4D_VECTOR:  func(sObj.get(AttributeKey<Mat4dVector>(attr), timestep)); break;
+    default: break;
+    }
+}
+
+// Payload output of BinaryWriter::writeBytes(), std::string or ValueContainerSink.
+void
+appendBytes(std::string& payload, const std::string& bytes)
+{
+    payload.append(bytes);
+}
+
+void
+appendBytes(ValueContainerSink& payload, const std::string& bytes)
+{
+    payload.append(bytes.data(), bytes.size());
+}
+
+void
+reserveBytes(std::string& payload, std::size_t size)
+{
+    payload.reserve(size);
+}
+
+void
+reserveBytes(ValueContainerSink&, std::size_t)
+{
+    // The sink grows without copying the appended data.
+}
+
 } // namespace {
 
+// Filled by a serial pass over the objects before they are encoded, so the
+// entry ids only depend on the object order. The encoding threads only look
+// up the id of each value. Each entry is encoded once, from the first value
+// which created it.
+struct BinaryWriter::DedupTable
+{
+    struct Entry
+    {
+        const SceneObject* mObject;
+        const Attribute* mAttribute;
+        int mTimestep;
+        const void* mValue;
+    };
+
+    template <typename T>
+    void add(const SceneObject& sObj, const Attribute& attr, int timeStep, const T& value)
+    {
+        // Values shared by several objects (see SceneObject::setShared())
+        // have the same address, they don't need to be compared.
+        if (mValueIds.count(&value)) return;
+
+        const std::size_t hash = hashValues(value);
+        auto range = mIds.equal_range(hash);
+        for (auto itr = range.first; itr != range.second; ++itr) {
+            const Entry& entry = mEntries[itr->second];
+            if (entry.mAttribute->getType() == attr.getType() &&
+                isSameValues(*static_cast<const T*>(entry.mValue), value)) {
+                mValueIds.emplace(&value, itr->second);
+                return;
+            }
+        }
+        const std::size_t id = mEntries.size();
+        mIds.emplace(hash, id);
+        mValueIds.emplace(&value, id);
+        mEntries.push_back(Entry {&sObj, &attr, timeStep, &value});
+    }
+
+    std::size_t find(const void* value) const
+    {
+        return mValueIds.find(value)->second;
+    }
+
+    std::unordered_multimap<std::size_t, std::size_t> mIds; // source data hash -> entry id
+    std::unordered_map<const void*, std::size_t> mValueIds; // value address -> entry id
+    std::vector<Entry> mEntries;
+};
+
 BinaryWriter::BinaryWriter(const SceneContext& context) :
     mContext(context),
     mTransientEncoding(false),
     mDeltaEncoding(false),
     mSkipDefaults(false),
     mLargeVectorsOnly(false),
-    mMinVectorSize(0)
+    mMinVectorSize(0),
+    mParallelEncoding(false),
+    mDedupEncoding(false),
+    mDedupMinVectorSize(64),
+    mStreamVByteEncoding(false)
 {
 }
 
@@ -68,7 +256,12 @@ BinaryWriter::toFile(const std::string& filename) const
 void
 BinaryWriter::toStream(std::ostream& output) const
 {
-    std::string manifest, payload;
+    REC_ZONE("BinaryWriter::toStream");
+
+    // The frame starts with the manifest, which is only known once the
+    // payload is encoded. The payload is kept in chunks until then.
+    std::string manifest;
+    ValueContainerChunkSink payload;
     toBytes(manifest, payload);
 
     // Write the manifest length (in network byte order) to the stream.
@@ -83,26 +276,83 @@ BinaryWriter::toStream(std::ostream& output) const
     output.write(&(manifest[0]), manifest.size());
 
     // Write the payload.
-    output.write(&(payload[0]), payload.size());
+    payload.crawlAllChunks([&](const char* data, std::size_t size) { output.write(data, size); });
 }
 
 void
 BinaryWriter::toBytes(std::string& manifest, std::string& payload) const
+{
+    REC_ZONE("BinaryWriter::toBytes");
+
+    writeBytes(manifest, payload);
+}
+
+void
+BinaryWriter::toBytes(std::string& manifest, ValueContainerSink& payload) const
+{
+    REC_ZONE("BinaryWriter::toBytes");
+
+    writeBytes(manifest, payload);
+}
+
+template <typename Payload>
+void
+BinaryWriter::writeBytes(std::string& manifest, Payload& payload) const
 {
     RecordInfoVector records;
 
-    // Step over each SceneObject.
-    std::ptrdiff_t offset = 0;
+    std::vector<const SceneObject*> sceneObjects;
     for (SceneContext::SceneObjectConstIterator iter = mContext.beginSceneObject();
             iter != mContext.endSceneObject(); ++iter) {
         if (mDeltaEncoding && !iter->second->mDirty) {
             // If delta encoding, skip objects that aren't dirty.
             continue;
         }
+        sceneObjects.push_back(iter->second);
+    }
+
+    std::unique_ptr<DedupTable> dedupTable;
+    if (mDedupEncoding) {
+        dedupTable.reset(new DedupTable);
+        buildDedupTable(sceneObjects, *dedupTable);
+    }
+
+    std::ptrdiff_t offset = 0;
+    if (mParallelEncoding) {
+        // Pack each SceneObject into its own buffer, then concatenate them in order.
+        std::vector<std::string> objectBytes(sceneObjects.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, sceneObjects.size()),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i < range.end(); ++i) {
+                                  writeSceneObject(*sceneObjects[i], objectBytes[i],
+                                                   dedupTable.get());
+                              }
+                          });
+
+        std::size_t payloadSize = payload.size();
+        for (const std::string& bytes : objectBytes) payloadSize += bytes.size();
+        reserveBytes(payload, payloadSize);
+
+        records.reserve(objectBytes.size());
+        for (std::string& bytes : objectBytes) {
+            appendBytes(payload, bytes);
+            records.emplace_back(SCENE_OBJECT_2, offset, bytes.size());
+            offset += bytes.size();
+            std::string().swap(bytes); // release as we go to keep the peak memory down
+        }
+    } else {
+        // Step over each SceneObject.
+        for (const SceneObject* sceneObject : sceneObjects) {
+            std::size_t size = writeSceneObject(*sceneObject, payload, dedupTable.get());
+            records.emplace_back(SCENE_OBJECT_2, offset, size);
+            offset += size;
+        }
+    }
 
-        std::size_t size = writeSceneObject(*(iter->second), payload);
-        records.emplace_back(SCENE_OBJECT_2, offset, size);
-        offset += size;
+    // The table follows the objects which reference it.
+    if (dedupTable && !dedupTable->mEntries.empty()) {
+        std::size_t size = writeDedupTable(*dedupTable, payload);
+        records.emplace_back(DEDUP_TABLE, offset, size);
     }
 
     // Write the manifest once the payload is finished.
@@ -150,20 +400,114 @@ BinaryWriter::writeManifest(const RecordInfoVector& info, std::string& bytes) co
     vContainerEnq.finalize();
 }
 
+template <typename Payload>
 std::size_t
-BinaryWriter::writeSceneObject(const SceneObject& sceneObject, std::string& bytes) const
+BinaryWriter::writeSceneObject(const SceneObject& sceneObject, Payload& bytes,
+                               const DedupTable* dedupTable) const
 {
     ValueContainerEnq vContainerEnq(&bytes);
     {
         vContainerEnq.enqString(sceneObject.getSceneClass().getName());
         vContainerEnq.enqString(sceneObject.getName());
-        packSceneObject(sceneObject, vContainerEnq);
+        packSceneObject(sceneObject, vContainerEnq, dedupTable);
     }
     return vContainerEnq.finalize();
 }
 
 void
-BinaryWriter::packSceneObject(const SceneObject& sceneObject, ValueContainerEnq &vContainerEnq) const
+BinaryWriter::buildDedupTable(const std::vector<const SceneObject*>& sceneObjects, DedupTable& dedupTable) const
+{
+    // Same order as packSceneObject() visits the values.
+    for (const SceneObject* sceneObject : sceneObjects) {
+        const SceneClass& sceneClass = sceneObject->getSceneClass();
+        for (size_t i = 0; i < sceneClass.mAttributes.size(); ++i) {
+            const Attribute* attribute = sceneClass.mAttributes[i];
+            if (isSkippedAttribute(*sceneObject, i) || !isDedupValue(*sceneObject, *attribute)) continue;
+
+            int timestep = TIMESTEP_BEGIN;
+            do {
+                visitDedupValue(*sceneObject, *attribute, timestep, [&](const auto& value) {
+                    dedupTable.add(*sceneObject, *attribute, timestep, value);
+                });
+                ++timestep;
+            } while (attribute->isBlurrable() && timestep < NUM_TIMESTEPS);
+        }
+    }
+}
+
+template <typename Payload>
+std::size_t
+BinaryWriter::writeDedupTable(const DedupTable& dedupTable, Payload& bytes) const
+{
+    // Each entry is a finalized ValueContainer which holds a single encoded value.
+    std::vector<std::string> entryBytes(dedupTable.mEntries.size());
+    auto encodeEntry = [&](size_t i) {
+        const DedupTable::Entry& entry = dedupTable.mEntries[i];
+        ValueContainerEnq valueEnq(&entryBytes[i]);
+        packValueData(*entry.mObject, entry.mAttribute, entry.mTimestep, valueEnq);
+        valueEnq.finalize();
+    };
+    if (mParallelEncoding) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, entryBytes.size()),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i < range.end(); ++i) encodeEntry(i);
+                          });
+    } else {
+        for (size_t i = 0; i < entryBytes.size(); ++i) encodeEntry(i);
+    }
+
+    ValueContainerEnq vContainerEnq(&bytes);
+    {
+        vContainerEnq.enqVLSizeT(entryBytes.size());
+        for (std::string& entry : entryBytes) {
+            vContainerEnq.enqVLSizeT(entry.size());
+            vContainerEnq.enqByteData(entry.data(), entry.size());
+            std::string().swap(entry);
+        }
+    }
+    return vContainerEnq.finalize();
+}
+
+bool
+BinaryWriter::isSkippedAttribute(const SceneObject& sceneObject, std::size_t index) const
+{
+    const Attribute* attribute = sceneObject.getSceneClass().mAttributes[index];
+
+    if (mDeltaEncoding && !sceneObject.mAttributeSetMask.test(index)) {
+        // If delta encoding, skip attributes that aren't set.
+        return true;
+    }
+
+    if (mSkipDefaults &&
+        !mDeltaEncoding &&
+        sceneObject.isDefaultAndUnbound(*attribute)) {
+        return true;
+    }
+
+    if (mLargeVectorsOnly &&
+        (vectorSize(sceneObject, *attribute) < mMinVectorSize ||
+         isSkippedInSplitMode(sceneObject))) {
+        // writing the large vector part of a split file,
+        // skip non-vectors, small vectors and certain specific
+        // object types that are always written in ascii
+        return true;
+    }
+
+    return false;
+}
+
+bool
+BinaryWriter::isDedupValue(const SceneObject& sObj, const Attribute& attr) const
+{
+    // Layer values are unpacked by a dedicated path in the reader, keep them inline.
+    return !sObj.isA<Layer>() &&
+           isDedupType(attr.getType()) &&
+           vectorSize(sObj, attr) >= mDedupMinVectorSize;
+}
+
+void
+BinaryWriter::packSceneObject(const SceneObject& sceneObject, ValueContainerEnq &vContainerEnq,
+                              const DedupTable* dedupTable) const
 {
     const SceneClass& sceneClass = sceneObject.getSceneClass();
 
@@ -171,28 +515,16 @@ BinaryWriter::packSceneObject(const SceneObject& sceneObject, ValueContainerEnq
     for (size_t i = 0; i < sceneClass.mAttributes.size(); ++i) {
         const Attribute* attribute = sceneClass.mAttributes[i];
 
-        if (mDeltaEncoding && !sceneObject.mAttributeSetMask.test(i)) {
-            // If delta encoding, skip attributes that aren't set.
-            continue;
-        }
-
-        if (mSkipDefaults &&
-            !mDeltaEncoding &&
-            sceneObject.isDefaultAndUnbound(*attribute)) {
-            continue;
-        }
-
-        if (mLargeVectorsOnly &&
-            (vectorSize(sceneObject, *attribute) < mMinVectorSize ||
-             isSkippedInSplitMode(sceneObject))) {
-            // writing the large vector part of a split file,
-            // skip non-vectors, small vectors and certain specific
-            // object types that are always written in ascii
+        if (isSkippedAttribute(sceneObject, i)) {
             continue;
         }
 
         // Set the type and identifier of the attribute.
-        vContainerEnq.enqAttributeType(attribute->getType());
+        if (mStreamVByteEncoding && attribute->getType() == TYPE_INT_VECTOR) {
+            vContainerEnq.enqValueType(ValueContainerUtil::ValueType::INT_VECTOR_STREAM_VBYTE);
+        } else {
+            vContainerEnq.enqAttributeType(attribute->getType());
+        }
         vContainerEnq.enqBool(mTransientEncoding);
         if (mTransientEncoding) {
             int attributeId = static_cast<int>(i);
@@ -212,7 +544,7 @@ BinaryWriter::packSceneObject(const SceneObject& sceneObject, ValueContainerEnq
         // Set the value for each relevant timestep.
         int timestep = TIMESTEP_BEGIN;
         do {
-            packValue(sceneObject, attribute, timestep, vContainerEnq);
+            packValue(sceneObject, attribute, timestep, vContainerEnq, dedupTable);
             ++timestep;
         } while (attribute->isBlurrable() && timestep < NUM_TIMESTEPS);
     }
@@ -262,11 +594,30 @@ BinaryWriter::packSceneObject(const SceneObject& sceneObject, ValueContainerEnq
 }
 
 void
-BinaryWriter::packValue(const SceneObject& sObj, const Attribute* attr, int timeStep, ValueContainerEnq &vContainerEnq) const
+BinaryWriter::packValue(const SceneObject& sObj, const Attribute* attr, int timeStep, ValueContainerEnq &vContainerEnq,
+                        const DedupTable* dedupTable) const
 {
+    if (dedupTable && isDedupValue(sObj, *attr)) {
+        // The value is encoded once in the table, only store the entry id.
+        std::size_t entryId = 0;
+        visitDedupValue(sObj, *attr, timeStep, [&](const auto& value) {
+            entryId = dedupTable->find(&value);
+        });
+
+        vContainerEnq.enqUChar(static_cast<unsigned char>(timeStep) | DEDUP_VALUE_FLAG);
+        vContainerEnq.enqVLSizeT(entryId);
+        return;
+    }
+
     // Set the timestep.
     vContainerEnq.enqUChar(static_cast<unsigned char>(timeStep));
+    packValueData(sObj, attr, timeStep, vContainerEnq);
+}
 
+void
+BinaryWriter::packValueData(const SceneObject& sObj, const Attribute* attr, int timeStep,
+                            ValueContainerEnq &vContainerEnq) const
+{
     // Set the value based on the type.
     switch (attr->getType()) {
     case TYPE_UNKNOWN : break;
@@ -345,9 +696,14 @@ BinaryWriter::packValue(const SceneObject& sObj, const Attribute* attr, int time
                                              static_cast<AttributeTimestep>(timeStep)));
         break;
     case TYPE_INT_VECTOR:
-        // We are using VariableLength version
-        vContainerEnq.enqVLIntVector(sObj.get(AttributeKey<IntVector>(*attr),
-                                              static_cast<AttributeTimestep>(timeStep)));
+        if (mStreamVByteEncoding) {
+            vContainerEnq.enqStreamVByteIntVector(sObj.get(AttributeKey<IntVector>(*attr),
+                                                           static_cast<AttributeTimestep>(timeStep)));
+        } else {
+            // We are using VariableLength version
+            vContainerEnq.enqVLIntVector(sObj.get(AttributeKey<IntVector>(*attr),
+                                                  static_cast<AttributeTimestep>(timeStep)));
+        }
         break;
     case TYPE_LONG_VECTOR:
         // We are using VariableLength version
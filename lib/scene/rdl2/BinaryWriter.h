@@ -19,6 +19,7 @@ namespace scene_rdl2 {
 namespace rdl2 {
 
 class ValueContainerEnq;
+class ValueContainerSink;
 
 /**
  * A BinaryWriter object can encode a SceneContext into a binary stream of RDL
@@ -67,9 +68,15 @@ public:
     {
         UNKNOWN = 0,
         SCENE_OBJECT = 1,       // protbuf version
-        SCENE_OBJECT_2 = 2      // value container version
+        SCENE_OBJECT_2 = 2,     // value container version
+        DEDUP_TABLE = 3         // deduplicated vector values (see setDedupEncoding())
     };
 
+    // Set in the timestep byte of a value which is stored in the DEDUP_TABLE
+    // record. The timestep byte is followed by the table entry id instead of
+    // the value. Must match BinaryReader::DEDUP_VALUE_FLAG.
+    static constexpr unsigned char DEDUP_VALUE_FLAG = 0x80;
+
     /**
      * Constructs a BinaryWriter that will encode the given SceneContext into
      * RDL binary.
@@ -129,6 +136,49 @@ public:
     finline void setSplitMode(size_t minVectorSize);
     finline void clearSplitMode();
 
+    /**
+     * Encodes SceneObjects in parallel. Each SceneObject is packed into its
+     * own buffer and the buffers are concatenated in the original order, so
+     * the output is byte-identical to the serial encode. Disabled by default.
+     *
+     * @param   parallelEncoding    True to encode SceneObjects in parallel.
+     */
+    finline void setParallelEncoding(bool parallelEncoding);
+
+    /**
+     * Turns on content deduplication of vector attribute values. Every vector
+     * value with at least minVectorSize elements is encoded once into a
+     * DEDUP_TABLE record appended to the payload, and the attribute only
+     * stores the table entry id. Identical values (e.g. the same UserData or
+     * primitive attributes on thousands of instances) are then written and
+     * decoded once per toBytes() call, the BinaryReader shares the decoded
+     * value between the objects (see SceneObject::setShared()). Works
+     * together with delta encoding, the table only holds the values of the
+     * encoded deltas. SceneObject references and Layer assignments are never
+     * deduplicated. The output is the same with and without parallel
+     * encoding.
+     *
+     * The data can only be read by a BinaryReader which understands the
+     * DEDUP_TABLE record, so leave it off for files read by older versions.
+     * Disabled by default.
+     *
+     * @param   dedupEncoding   True to enable deduplication.
+     * @param   minVectorSize   Minimum number of elements of a deduplicated
+     *                          vector value.
+     */
+    finline void setDedupEncoding(bool dedupEncoding, std::size_t minVectorSize = 64);
+
+    /**
+     * Encodes IntVector attributes with stream VByte block coding instead of
+     * one variable length integer after another. The encoded size is about
+     * the same, but the values decode several times faster. The attributes
+     * are tagged with their own value type, so the data can only be read by a
+     * BinaryReader which understands it. Disabled by default.
+     *
+     * @param   streamVByteEncoding     True to enable stream VByte coding.
+     */
+    finline void setStreamVByteEncoding(bool streamVByteEncoding);
+
     /**
      * Opens the file with the given filename and attempts to write the RDL
      * binary to it. You can use the BinaryReader's fromFile() method to read
@@ -157,6 +207,19 @@ public:
      */
     void toBytes(std::string& manifest, std::string& payload) const;
 
+    /**
+     * Same as above, but the payload is streamed to the sink (e.g. a
+     * ValueContainerChunkSink or ValueContainerFileSink) instead of one
+     * contiguous byte string, so large contexts are never reallocated and
+     * copied while they are encoded. The payload is appended after whatever
+     * the sink already holds, and the number of payload bytes is the growth
+     * of payload.size(). The manifest is small and stays a byte string.
+     *
+     * @param   manifest    Output byte string to write the manifest data into.
+     * @param   payload     Sink to stream the payload data into.
+     */
+    void toBytes(std::string& manifest, ValueContainerSink& payload) const;
+
     /**
      * Dump scene context internal info to strings. This API is designed to debug
      * and/or to compare sceneContext internal information.
@@ -167,6 +230,9 @@ public:
     std::string show(const std::string &hd, const bool sort) const;
 
 private:
+    // Table of the deduplicated vector values of a single toBytes() call.
+    struct DedupTable;
+
     // Internal structure for tracking message types, sizes, and offsets when
     // encoding the manifest.
     struct RecordInfo
@@ -180,19 +246,47 @@ private:
     };
     typedef std::vector<RecordInfo> RecordInfoVector;
 
+    // Helper function to encode the manifest and the payload. Payload is
+    // std::string or ValueContainerSink.
+    template <typename Payload>
+    void writeBytes(std::string& manifest, Payload& payload) const;
+
     // Helper function to encode the manifest.
     void writeManifest(const RecordInfoVector& info, std::string& bytes) const;
 
     // Helper function for writing SceneObject messages out to the payload.
-    std::size_t writeSceneObject(const SceneObject& sceneObject, std::string& bytes) const;
+    // dedupTable is nullptr unless dedup encoding is enabled.
+    template <typename Payload>
+    std::size_t writeSceneObject(const SceneObject& sceneObject, Payload& bytes,
+                                 const DedupTable* dedupTable) const;
+
+    // Helper function which assigns the dedup table entry ids of all the
+    // values written for sceneObjects, in order.
+    void buildDedupTable(const std::vector<const SceneObject*>& sceneObjects, DedupTable& dedupTable) const;
+
+    // Helper function for writing the DEDUP_TABLE record out to the payload.
+    template <typename Payload>
+    std::size_t writeDedupTable(const DedupTable& dedupTable, Payload& bytes) const;
+
+    // Returns true if the attribute is not written for the SceneObject.
+    bool isSkippedAttribute(const SceneObject& sceneObject, std::size_t index) const;
+
+    // Returns true if the attribute value is written to the dedup table.
+    bool isDedupValue(const SceneObject& sObj, const Attribute& attr) const;
 
     // Helper function for packing an RDL SceneObject into a SceneObject ValueContainer.
-    void packSceneObject(const SceneObject& sceneObject, ValueContainerEnq &vContainer) const;
+    void packSceneObject(const SceneObject& sceneObject, ValueContainerEnq &vContainer,
+                         const DedupTable* dedupTable) const;
 
     // void packSceneObjectFormat(const SceneObject &sceneObject) const; // TMP
 
-    // Helper function for packing attribute values.
-    void packValue(const SceneObject& sObj, const Attribute* attr, int timeStep, ValueContainerEnq &vContainer) const;
+    // Helper function for packing attribute values (timestep and value).
+    void packValue(const SceneObject& sObj, const Attribute* attr, int timeStep, ValueContainerEnq &vContainer,
+                   const DedupTable* dedupTable) const;
+
+    // Helper function for packing the attribute value itself.
+    void packValueData(const SceneObject& sObj, const Attribute* attr, int timeStep,
+                       ValueContainerEnq &vContainer) const;
 
     // for debug show logic
     std::string showSceneObject(const SceneObject &sceneObject, const std::string &hd, const bool sort) const;
@@ -232,6 +326,17 @@ private:
     // Enables writing for "split mode", where only large vectors are written
     bool mLargeVectorsOnly;
     size_t mMinVectorSize;
+
+    // True if SceneObjects are encoded in parallel.
+    bool mParallelEncoding;
+
+    // True if large vector values are deduplicated, and the minimum vector
+    // size for it.
+    bool mDedupEncoding;
+    std::size_t mDedupMinVectorSize;
+
+    // True if IntVector values are encoded by stream VByte coding.
+    bool mStreamVByteEncoding;
 };
 
 void
@@ -252,6 +357,25 @@ BinaryWriter::setSkipDefaults(bool skipDefaults)
     mSkipDefaults = skipDefaults;
 }
 
+void
+BinaryWriter::setParallelEncoding(bool parallelEncoding)
+{
+    mParallelEncoding = parallelEncoding;
+}
+
+void
+BinaryWriter::setDedupEncoding(bool dedupEncoding, std::size_t minVectorSize)
+{
+    mDedupEncoding = dedupEncoding;
+    mDedupMinVectorSize = minVectorSize;
+}
+
+void
+BinaryWriter::setStreamVByteEncoding(bool streamVByteEncoding)
+{
+    mStreamVByteEncoding = streamVByteEncoding;
+}
+
 void
 BinaryWriter::setSplitMode(size_t minVectorSize)
 {
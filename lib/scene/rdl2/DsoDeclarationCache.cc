@@ -0,0 +1,562 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "DsoDeclarationCache.h"
+
+#include "Attribute.h"
+#include "SceneClass.h"
+#include "Types.h"
+#include "ValueContainerDeq.h"
+#include "ValueContainerEnq.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/render/util/Strings.h>
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+
+namespace {
+
+const std::string CACHE_MAGIC("rdl2DsoDeclarationCache");
+
+// Bump this whenever the encoding of the cache file or of the class
+// declarations changes. Files with another version are ignored.
+const unsigned int CACHE_VERSION = 1;
+
+// Typed encode/decode of attribute default values. Overloaded on the
+// attribute value type so that the record and replay switches below stay
+// symmetric.
+void enqValue(ValueContainerEnq& enq, const Bool& v) { enq.enqBool(v); }
+void enqValue(ValueContainerEnq& enq, const Int& v) { enq.enqInt(v); }
+void enqValue(ValueContainerEnq& enq, const Long& v) { enq.enqLong(v); }
+void enqValue(ValueContainerEnq& enq, const Float& v) { enq.enqFloat(v); }
+void enqValue(ValueContainerEnq& enq, const Double& v) { enq.enqDouble(v); }
+void enqValue(ValueContainerEnq& enq, const String& v) { enq.enqString(v); }
+void enqValue(ValueContainerEnq& enq, const Rgb& v) { enq.enqRgb(v); }
+void enqValue(ValueContainerEnq& enq, const Rgba& v) { enq.enqRgba(v); }
+void enqValue(ValueContainerEnq& enq, const Vec2f& v) { enq.enqVec2f(v); }
+void enqValue(ValueContainerEnq& enq, const Vec2d& v) { enq.enqVec2d(v); }
+void enqValue(ValueContainerEnq& enq, const Vec3f& v) { enq.enqVec3f(v); }
+void enqValue(ValueContainerEnq& enq, const Vec3d& v) { enq.enqVec3d(v); }
+void enqValue(ValueContainerEnq& enq, const Vec4f& v) { enq.enqVec4f(v); }
+void enqValue(ValueContainerEnq& enq, const Vec4d& v) { enq.enqVec4d(v); }
+void enqValue(ValueContainerEnq& enq, const Mat4f& v) { enq.enqMat4f(v); }
+void enqValue(ValueContainerEnq& enq, const Mat4d& v) { enq.enqMat4d(v); }
+void enqValue(ValueContainerEnq& enq, const BoolVector& v) { enq.enqBoolVector(v); }
+void enqValue(ValueContainerEnq& enq, const IntVector& v) { enq.enqIntVector(v); }
+void enqValue(ValueContainerEnq& enq, const LongVector& v) { enq.enqLongVector(v); }
+void enqValue(ValueContainerEnq& enq, const FloatVector& v) { enq.enqFloatVector(v); }
+void enqValue(ValueContainerEnq& enq, const DoubleVector& v) { enq.enqDoubleVector(v); }
+void enqValue(ValueContainerEnq& enq, const StringVector& v) { enq.enqStringVector(v); }
+void enqValue(ValueContainerEnq& enq, const RgbVector& v) { enq.enqRgbVector(v); }
+void enqValue(ValueContainerEnq& enq, const RgbaVector& v) { enq.enqRgbaVector(v); }
+void enqValue(ValueContainerEnq& enq, const Vec2fVector& v) { enq.enqVec2fVector(v); }
+void enqValue(ValueContainerEnq& enq, const Vec2dVector& v) { enq.enqVec2dVector(v); }
+void enqValue(ValueContainerEnq& enq, const Vec3fVector& v) { enq.enqVec3fVector(v); }
+void enqValue(ValueContainerEnq& enq, const Vec3dVector& v) { enq.enqVec3dVector(v); }
+void enqValue(ValueContainerEnq& enq, const Vec4fVector& v) { enq.enqVec4fVector(v); }
+void enqValue(ValueContainerEnq& enq, const Vec4dVector& v) { enq.enqVec4dVector(v); }
+void enqValue(ValueContainerEnq& enq, const Mat4fVector& v) { enq.enqMat4fVector(v); }
+void enqValue(ValueContainerEnq& enq, const Mat4dVector& v) { enq.enqMat4dVector(v); }
+
+void deqValue(ValueContainerDeq& deq, Bool& v) { deq.deqBool(v); }
+void deqValue(ValueContainerDeq& deq, Int& v) { deq.deqInt(v); }
+void deqValue(ValueContainerDeq& deq, Long& v) { deq.deqLong(v); }
+void deqValue(ValueContainerDeq& deq, Float& v) { deq.deqFloat(v); }
+void deqValue(ValueContainerDeq& deq, Double& v) { deq.deqDouble(v); }
+void deqValue(ValueContainerDeq& deq, String& v) { deq.deqString(v); }
+void deqValue(ValueContainerDeq& deq, Rgb& v) { deq.deqRgb(v); }
+void deqValue(ValueContainerDeq& deq, Rgba& v) { deq.deqRgba(v); }
+void deqValue(ValueContainerDeq& deq, Vec2f& v) { deq.deqVec2f(v); }
+void deqValue(ValueContainerDeq& deq, Vec2d& v) { deq.deqVec2d(v); }
+void deqValue(ValueContainerDeq& deq, Vec3f& v) { deq.deqVec3f(v); }
+void deqValue(ValueContainerDeq& deq, Vec3d& v) { deq.deqVec3d(v); }
+void deqValue(ValueContainerDeq& deq, Vec4f& v) { deq.deqVec4f(v); }
+void deqValue(ValueContainerDeq& deq, Vec4d& v) { deq.deqVec4d(v); }
+void deqValue(ValueContainerDeq& deq, Mat4f& v) { deq.deqMat4f(v); }
+void deqValue(ValueContainerDeq& deq, Mat4d& v) { deq.deqMat4d(v); }
+void deqValue(ValueContainerDeq& deq, BoolVector& v) { deq.deqBoolVector(v); }
+void deqValue(ValueContainerDeq& deq, IntVector& v) { deq.deqIntVector(v); }
+void deqValue(ValueContainerDeq& deq, LongVector& v) { deq.deqLongVector(v); }
+void deqValue(ValueContainerDeq& deq, FloatVector& v) { deq.deqFloatVector(v); }
+void deqValue(ValueContainerDeq& deq, DoubleVector& v) { deq.deqDoubleVector(v); }
+void deqValue(ValueContainerDeq& deq, StringVector& v) { deq.deqStringVector(v); }
+void deqValue(ValueContainerDeq& deq, RgbVector& v) { deq.deqRgbVector(v); }
+void deqValue(ValueContainerDeq& deq, RgbaVector& v) { deq.deqRgbaVector(v); }
+void deqValue(ValueContainerDeq& deq, Vec2fVector& v) { deq.deqVec2fVector(v); }
+void deqValue(ValueContainerDeq& deq, Vec2dVector& v) { deq.deqVec2dVector(v); }
+void deqValue(ValueContainerDeq& deq, Vec3fVector& v) { deq.deqVec3fVector(v); }
+void deqValue(ValueContainerDeq& deq, Vec3dVector& v) { deq.deqVec3dVector(v); }
+void deqValue(ValueContainerDeq& deq, Vec4fVector& v) { deq.deqVec4fVector(v); }
+void deqValue(ValueContainerDeq& deq, Vec4dVector& v) { deq.deqVec4dVector(v); }
+void deqValue(ValueContainerDeq& deq, Mat4fVector& v) { deq.deqMat4fVector(v); }
+void deqValue(ValueContainerDeq& deq, Mat4dVector& v) { deq.deqMat4dVector(v); }
+
+template <typename T>
+void
+enqDefault(ValueContainerEnq& enq, const Attribute& attribute)
+{
+    enqValue(enq, attribute.getDefaultValue<T>());
+}
+
+template <typename T>
+void
+declareWithDefault(SceneClass& sceneClass, ValueContainerDeq& deq,
+                   const std::string& name, AttributeFlags flags,
+                   SceneObjectInterface objectType,
+                   const std::vector<std::string>& aliases)
+{
+    T defaultValue = T();
+    deqValue(deq, defaultValue);
+    sceneClass.declareAttribute<T>(name, defaultValue, flags, objectType, aliases);
+}
+
+} // namespace
+
+/* static */
+std::shared_ptr<const CachedClassDeclaration>
+CachedClassDeclaration::record(const SceneClass& sceneClass, const std::string& filePath)
+{
+    // Blind data pointers are runtime addresses inside the DSO, which can't
+    // be reproduced without loading it.
+    if (!sceneClass.mData.empty()) {
+        return nullptr;
+    }
+
+    std::string bytes;
+    ValueContainerEnq enq(&bytes);
+
+    enq.enqInt(static_cast<int>(sceneClass.mDeclaredInterface));
+
+    std::unordered_map<const Attribute*, size_t> attributeIndices;
+    enq.enqVLSizeT(sceneClass.mAttributes.size());
+    for (const Attribute* attribute : sceneClass.mAttributes) {
+        attributeIndices.emplace(attribute, attributeIndices.size());
+
+        const AttributeType type = attribute->getType();
+        enq.enqUInt(static_cast<unsigned int>(type));
+        enq.enqString(attribute->getName());
+        enq.enqStringVector(attribute->getAliases());
+        enq.enqUInt(static_cast<unsigned int>(attribute->getFlags()));
+        enq.enqInt(static_cast<int>(attribute->getObjectType()));
+
+        switch (type) {
+        case TYPE_BOOL:          enqDefault<Bool>(enq, *attribute); break;
+        case TYPE_INT:           enqDefault<Int>(enq, *attribute); break;
+        case TYPE_LONG:          enqDefault<Long>(enq, *attribute); break;
+        case TYPE_FLOAT:         enqDefault<Float>(enq, *attribute); break;
+        case TYPE_DOUBLE:        enqDefault<Double>(enq, *attribute); break;
+        case TYPE_STRING:        enqDefault<String>(enq, *attribute); break;
+        case TYPE_RGB:           enqDefault<Rgb>(enq, *attribute); break;
+        case TYPE_RGBA:          enqDefault<Rgba>(enq, *attribute); break;
+        case TYPE_VEC2F:         enqDefault<Vec2f>(enq, *attribute); break;
+        case TYPE_VEC2D:         enqDefault<Vec2d>(enq, *attribute); break;
+        case TYPE_VEC3F:         enqDefault<Vec3f>(enq, *attribute); break;
+        case TYPE_VEC3D:         enqDefault<Vec3d>(enq, *attribute); break;
+        case TYPE_VEC4F:         enqDefault<Vec4f>(enq, *attribute); break;
+        case TYPE_VEC4D:         enqDefault<Vec4d>(enq, *attribute); break;
+        case TYPE_MAT4F:         enqDefault<Mat4f>(enq, *attribute); break;
+        case TYPE_MAT4D:         enqDefault<Mat4d>(enq, *attribute); break;
+        case TYPE_BOOL_VECTOR:   enqDefault<BoolVector>(enq, *attribute); break;
+        case TYPE_INT_VECTOR:    enqDefault<IntVector>(enq, *attribute); break;
+        case TYPE_LONG_VECTOR:   enqDefault<LongVector>(enq, *attribute); break;
+        case TYPE_FLOAT_VECTOR:  enqDefault<FloatVector>(enq, *attribute); break;
+        case TYPE_DOUBLE_VECTOR: enqDefault<DoubleVector>(enq, *attribute); break;
+        case TYPE_STRING_VECTOR: enqDefault<StringVector>(enq, *attribute); break;
+        case TYPE_RGB_VECTOR:    enqDefault<RgbVector>(enq, *attribute); break;
+        case TYPE_RGBA_VECTOR:   enqDefault<RgbaVector>(enq, *attribute); break;
+        case TYPE_VEC2F_VECTOR:  enqDefault<Vec2fVector>(enq, *attribute); break;
+        case TYPE_VEC2D_VECTOR:  enqDefault<Vec2dVector>(enq, *attribute); break;
+        case TYPE_VEC3F_VECTOR:  enqDefault<Vec3fVector>(enq, *attribute); break;
+        case TYPE_VEC3D_VECTOR:  enqDefault<Vec3dVector>(enq, *attribute); break;
+        case TYPE_VEC4F_VECTOR:  enqDefault<Vec4fVector>(enq, *attribute); break;
+        case TYPE_VEC4D_VECTOR:  enqDefault<Vec4dVector>(enq, *attribute); break;
+        case TYPE_MAT4F_VECTOR:  enqDefault<Mat4fVector>(enq, *attribute); break;
+        case TYPE_MAT4D_VECTOR:  enqDefault<Mat4dVector>(enq, *attribute); break;
+
+        case TYPE_SCENE_OBJECT:
+        case TYPE_SCENE_OBJECT_VECTOR:
+        case TYPE_SCENE_OBJECT_INDEXABLE:
+            // SceneObject attributes can't have a non-empty default.
+            break;
+
+        default:
+            return nullptr;
+        }
+
+        enq.enqVLSizeT(std::distance(attribute->beginMetadata(), attribute->endMetadata()));
+        for (auto iter = attribute->beginMetadata(); iter != attribute->endMetadata(); ++iter) {
+            enq.enqString(iter->first);
+            enq.enqString(iter->second);
+        }
+
+        enq.enqVLSizeT(std::distance(attribute->beginEnumValues(), attribute->endEnumValues()));
+        for (auto iter = attribute->beginEnumValues(); iter != attribute->endEnumValues(); ++iter) {
+            enq.enqInt(iter->first);
+            enq.enqString(iter->second);
+        }
+    }
+
+    // Groups are stored as (group index, attribute index) pairs in the order
+    // of the group map, which preserves the insertion order within a group.
+    enq.enqStringVector(sceneClass.mGroupNames);
+    enq.enqVLSizeT(sceneClass.mGroupMap.size());
+    for (const auto& item : sceneClass.mGroupMap) {
+        enq.enqVLSizeT(item.first);
+        enq.enqVLSizeT(attributeIndices.at(item.second));
+    }
+
+    enq.finalize();
+
+    return std::make_shared<const CachedClassDeclaration>(filePath, std::move(bytes));
+}
+
+SceneObjectInterface
+CachedClassDeclaration::declare(SceneClass& sceneClass) const
+{
+    ValueContainerDeq deq(mBytes.data(), mBytes.size());
+
+    const SceneObjectInterface interface = static_cast<SceneObjectInterface>(deq.deqInt());
+
+    const size_t attributeCount = deq.deqVLSizeT();
+    for (size_t i = 0; i < attributeCount; ++i) {
+        const AttributeType type = static_cast<AttributeType>(deq.deqUInt());
+        const std::string name = deq.deqString();
+        std::vector<std::string> aliases;
+        deq.deqStringVector(aliases);
+        const AttributeFlags flags = static_cast<AttributeFlags>(deq.deqUInt());
+        const SceneObjectInterface objectType = static_cast<SceneObjectInterface>(deq.deqInt());
+
+        switch (type) {
+        case TYPE_BOOL:
+            declareWithDefault<Bool>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_INT:
+            declareWithDefault<Int>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_LONG:
+            declareWithDefault<Long>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_FLOAT:
+            declareWithDefault<Float>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_DOUBLE:
+            declareWithDefault<Double>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_STRING:
+            declareWithDefault<String>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_RGB:
+            declareWithDefault<Rgb>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_RGBA:
+            declareWithDefault<Rgba>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC2F:
+            declareWithDefault<Vec2f>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC2D:
+            declareWithDefault<Vec2d>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC3F:
+            declareWithDefault<Vec3f>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC3D:
+            declareWithDefault<Vec3d>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC4F:
+            declareWithDefault<Vec4f>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC4D:
+            declareWithDefault<Vec4d>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_MAT4F:
+            declareWithDefault<Mat4f>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_MAT4D:
+            declareWithDefault<Mat4d>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_SCENE_OBJECT:
+            sceneClass.declareAttribute<SceneObject*>(name, flags, objectType, aliases);
+            break;
+        case TYPE_BOOL_VECTOR:
+            declareWithDefault<BoolVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_INT_VECTOR:
+            declareWithDefault<IntVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_LONG_VECTOR:
+            declareWithDefault<LongVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_FLOAT_VECTOR:
+            declareWithDefault<FloatVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_DOUBLE_VECTOR:
+            declareWithDefault<DoubleVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_STRING_VECTOR:
+            declareWithDefault<StringVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_RGB_VECTOR:
+            declareWithDefault<RgbVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_RGBA_VECTOR:
+            declareWithDefault<RgbaVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC2F_VECTOR:
+            declareWithDefault<Vec2fVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC2D_VECTOR:
+            declareWithDefault<Vec2dVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC3F_VECTOR:
+            declareWithDefault<Vec3fVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC3D_VECTOR:
+            declareWithDefault<Vec3dVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC4F_VECTOR:
+            declareWithDefault<Vec4fVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_VEC4D_VECTOR:
+            declareWithDefault<Vec4dVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_MAT4F_VECTOR:
+            declareWithDefault<Mat4fVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_MAT4D_VECTOR:
+            declareWithDefault<Mat4dVector>(sceneClass, deq, name, flags, objectType, aliases);
+            break;
+        case TYPE_SCENE_OBJECT_VECTOR:
+            sceneClass.declareAttribute<SceneObjectVector>(name, flags, objectType, aliases);
+            break;
+        case TYPE_SCENE_OBJECT_INDEXABLE:
+            sceneClass.declareAttribute<SceneObjectIndexable>(name, flags, objectType, aliases);
+            break;
+        default:
+            throw except::RuntimeError(util::buildString("Corrupted cached declaration of"
+                    " attribute '", name, "' from '", mFilePath, "'."));
+        }
+
+        Attribute* attribute = sceneClass.mAttributes.back();
+
+        const size_t metadataCount = deq.deqVLSizeT();
+        for (size_t j = 0; j < metadataCount; ++j) {
+            const std::string key = deq.deqString();
+            attribute->setMetadata(key, deq.deqString());
+        }
+
+        const size_t enumValueCount = deq.deqVLSizeT();
+        for (size_t j = 0; j < enumValueCount; ++j) {
+            const Int enumValue = deq.deqInt();
+            attribute->setEnumValue(enumValue, deq.deqString());
+        }
+    }
+
+    deq.deqStringVector(sceneClass.mGroupNames);
+    const size_t groupItemCount = deq.deqVLSizeT();
+    for (size_t i = 0; i < groupItemCount; ++i) {
+        const size_t groupIndex = deq.deqVLSizeT();
+        const size_t attributeIndex = deq.deqVLSizeT();
+        if (groupIndex >= sceneClass.mGroupNames.size() ||
+            attributeIndex >= sceneClass.mAttributes.size()) {
+            throw except::RuntimeError(util::buildString("Corrupted cached attribute"
+                    " groups from '", mFilePath, "'."));
+        }
+        sceneClass.mGroupMap.insert(std::make_pair(groupIndex,
+                                                   sceneClass.mAttributes[attributeIndex]));
+    }
+
+    return interface;
+}
+
+//------------------------------------------------------------------------------------------
+
+DsoDeclarationCache::DsoDeclarationCache() :
+    mDirty(false)
+{
+}
+
+DsoDeclarationCache::~DsoDeclarationCache()
+{
+}
+
+bool
+DsoDeclarationCache::load(const std::string& cacheFile)
+{
+    tbb::mutex::scoped_lock lock(mMutex);
+
+    mEntries.clear();
+    mDirty = false;
+
+    std::ifstream in(cacheFile, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    try {
+        ValueContainerDeq header(data.data(), data.size());
+        if (header.deqString() != CACHE_MAGIC || header.deqUInt() != CACHE_VERSION) {
+            return false;
+        }
+        const unsigned long payloadHash = header.deqULong();
+        const std::string payload = header.deqString();
+        if (std::hash<std::string_view>()(payload) != payloadHash) {
+            return false;
+        }
+
+        ValueContainerDeq deq(payload.data(), payload.size());
+        const size_t entryCount = deq.deqVLSizeT();
+        for (size_t i = 0; i < entryCount; ++i) {
+            const std::string filePath = deq.deqString();
+            Entry entry;
+            entry.mMtimeSec = deq.deqLong();
+            entry.mMtimeNsec = deq.deqLong();
+            entry.mSize = deq.deqLong();
+            entry.mDeclaration =
+                std::make_shared<const CachedClassDeclaration>(filePath, deq.deqString());
+            mEntries[filePath] = std::move(entry);
+        }
+    } catch (const std::exception&) {
+        mEntries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void
+DsoDeclarationCache::save(const std::string& cacheFile)
+{
+    tbb::mutex::scoped_lock lock(mMutex);
+
+    std::string payload;
+    {
+        ValueContainerEnq enq(&payload);
+        enq.enqVLSizeT(mEntries.size());
+        for (const auto& item : mEntries) {
+            enq.enqString(item.first);
+            enq.enqLong(item.second.mMtimeSec);
+            enq.enqLong(item.second.mMtimeNsec);
+            enq.enqLong(item.second.mSize);
+            enq.enqString(item.second.mDeclaration->getBytes());
+        }
+        enq.finalize();
+    }
+
+    std::string data;
+    {
+        ValueContainerEnq enq(&data);
+        enq.enqString(CACHE_MAGIC);
+        enq.enqUInt(CACHE_VERSION);
+        enq.enqULong(std::hash<std::string_view>()(payload));
+        enq.enqString(payload);
+        enq.finalize();
+    }
+
+    // Write to a unique temporary file next to the cache file, then rename it
+    // over the cache file.
+    const std::string tmpFile = util::buildString(cacheFile, ".tmp", getpid());
+    {
+        std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+        if (!out) {
+            std::remove(tmpFile.c_str());
+            throw except::IoError(util::buildString("Failed to write DSO declaration"
+                    " cache '", tmpFile, "'."));
+        }
+    }
+    if (std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+        std::remove(tmpFile.c_str());
+        throw except::IoError(util::buildString("Failed to rename DSO declaration"
+                " cache '", tmpFile, "' to '", cacheFile, "'."));
+    }
+
+    mDirty = false;
+}
+
+std::shared_ptr<const CachedClassDeclaration>
+DsoDeclarationCache::find(const std::string& filePath) const
+{
+    if (filePath.empty()) {
+        return nullptr;
+    }
+
+    Entry current;
+    if (!statFile(filePath, current)) {
+        return nullptr;
+    }
+
+    tbb::mutex::scoped_lock lock(mMutex);
+
+    auto iter = mEntries.find(filePath);
+    if (iter == mEntries.end() ||
+        iter->second.mMtimeSec != current.mMtimeSec ||
+        iter->second.mMtimeNsec != current.mMtimeNsec ||
+        iter->second.mSize != current.mSize) {
+        return nullptr;
+    }
+    return iter->second.mDeclaration;
+}
+
+bool
+DsoDeclarationCache::record(const SceneClass& sceneClass, const std::string& filePath)
+{
+    Entry entry;
+    if (filePath.empty() || !statFile(filePath, entry)) {
+        return false;
+    }
+
+    entry.mDeclaration = CachedClassDeclaration::record(sceneClass, filePath);
+    if (!entry.mDeclaration) {
+        return false;
+    }
+
+    tbb::mutex::scoped_lock lock(mMutex);
+
+    mEntries[filePath] = std::move(entry);
+    mDirty = true;
+    return true;
+}
+
+size_t
+DsoDeclarationCache::size() const
+{
+    tbb::mutex::scoped_lock lock(mMutex);
+    return mEntries.size();
+}
+
+/* static */
+bool
+DsoDeclarationCache::statFile(const std::string& filePath, Entry& entry)
+{
+    struct stat fileStat;
+    if (stat(filePath.c_str(), &fileStat) != 0) {
+        return false;
+    }
+    entry.mMtimeSec = fileStat.st_mtim.tv_sec;
+    entry.mMtimeNsec = fileStat.st_mtim.tv_nsec;
+    entry.mSize = fileStat.st_size;
+    return true;
+}
+
+} // namespace rdl2
+} // namespace scene_rdl2
+
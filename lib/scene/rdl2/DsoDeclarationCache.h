@@ -0,0 +1,141 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include "Types.h"
+
+#include <tbb/mutex.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <stdint.h>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+
+/**
+ * CachedClassDeclaration is the recorded result of running the rdl2_declare()
+ * function of a DSO: the declared interface, all the attributes (type, flags,
+ * object type, aliases, default value, metadata and enum values) and the
+ * attribute groups, encoded with ValueContainerEnq.
+ *
+ * declare() replays the recorded declarations on a new SceneClass, which ends
+ * up with exactly the same attributes, storage layout and groups as if the
+ * DSO declare() function had been called.
+ */
+class CachedClassDeclaration
+{
+public:
+    CachedClassDeclaration(const std::string& filePath, std::string&& bytes) :
+        mFilePath(filePath),
+        mBytes(std::move(bytes))
+    {}
+
+    /**
+     * Records the declarations of the given (complete) SceneClass. Returns
+     * nullptr if the SceneClass can't be replayed from a cache, which is the
+     * case when its declare() function attached blind data with
+     * declareDataPtr().
+     */
+    static std::shared_ptr<const CachedClassDeclaration> record(const SceneClass& sceneClass,
+                                                                const std::string& filePath);
+
+    /**
+     * Replays the recorded declarations on the given SceneClass.
+     *
+     * @return  The SceneObjectInterface the DSO declared.
+     * @throw   except::RuntimeError    If the recorded data is corrupted.
+     */
+    SceneObjectInterface declare(SceneClass& sceneClass) const;
+
+    /// The full path of the DSO these declarations came from.
+    const std::string& getFilePath() const { return mFilePath; }
+
+    const std::string& getBytes() const { return mBytes; }
+
+private:
+    const std::string mFilePath;
+    const std::string mBytes;
+};
+
+/**
+ * DsoDeclarationCache keeps CachedClassDeclarations keyed by DSO file path,
+ * modification time and size, and persists them in a single cache file.
+ *
+ * In proxy mode, SceneContext only needs the declarations of a DSO, so a
+ * valid cache entry makes it possible to create the SceneClass without
+ * dlopen()'ing the DSO at all. An entry is only used if the DSO on disk still
+ * has the recorded mtime and size, otherwise it is treated as a miss and
+ * replaced by the next record().
+ *
+ * Thread Safety:
+ *  - find() and record() can be called concurrently from multiple threads.
+ *  - load() and save() must not run concurrently with anything else.
+ */
+class DsoDeclarationCache
+{
+public:
+    DsoDeclarationCache();
+    ~DsoDeclarationCache();
+
+    DsoDeclarationCache(const DsoDeclarationCache&) = delete;
+    DsoDeclarationCache& operator=(const DsoDeclarationCache&) = delete;
+
+    /**
+     * Reads the cache file. A missing, truncated or otherwise unreadable
+     * cache file leaves the cache empty.
+     *
+     * @return  True if the cache file was read successfully.
+     */
+    bool load(const std::string& cacheFile);
+
+    /**
+     * Writes the cache file. The data is written to a temporary file first
+     * and renamed over the cache file, so concurrent readers of the cache
+     * file never see a partial file.
+     *
+     * @throw   except::IoError     If the cache file can't be written.
+     */
+    void save(const std::string& cacheFile);
+
+    /**
+     * Returns the declarations recorded for the DSO at the given path, or
+     * nullptr if there is no entry or the DSO changed since it was recorded.
+     */
+    std::shared_ptr<const CachedClassDeclaration> find(const std::string& filePath) const;
+
+    /**
+     * Records the declarations of the given SceneClass, which was declared by
+     * the DSO at the given path. Returns false if the SceneClass can't be
+     * cached.
+     */
+    bool record(const SceneClass& sceneClass, const std::string& filePath);
+
+    /// True if entries were recorded since the last load() or save().
+    bool isDirty() const { return mDirty; }
+
+    size_t size() const;
+
+private:
+    struct Entry
+    {
+        int64_t mMtimeSec;
+        int64_t mMtimeNsec;
+        int64_t mSize;
+        std::shared_ptr<const CachedClassDeclaration> mDeclaration;
+    };
+
+    static bool statFile(const std::string& filePath, Entry& entry);
+
+    mutable tbb::mutex mMutex;
+    std::unordered_map<std::string, Entry> mEntries;
+    bool mDirty;
+};
+
+} // namespace rdl2
+} // namespace scene_rdl2
+
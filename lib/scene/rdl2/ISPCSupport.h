@@ -38,6 +38,9 @@ struct SceneObjectISPC {
 typedef uniform int8*  uniform PTR8;
 typedef uniform int64* uniform PTR64;
 
+// varying flavor, when each program instance looks at its own SceneObject
+typedef uniform int8*  varying VPTR8;
+
 // when ISPC de-references the attribute key pointers it needs to
 //  get to the data contained therein.  The current AttributeKey
 //  type (class) cannot be digested by ISPC, so this proxy struct is used
@@ -188,6 +191,120 @@ inline uniform float<3> get(
 
     return result;
 }
+
+// ISPC RDL2 gather functions
+//
+// Varying shader code often needs the same attribute from a different
+// SceneObject in each program instance. Instead of a scalar loop over the
+// active lanes with the uniform get() functions above, these read the
+// attribute of every lane with a single gather:
+//
+//     VPTR8 base = getRdl2Attributes(sceneObj);
+//     varying float f = get(base, floatKey);
+//
+// All the SceneObjects must be non null and of a SceneClass the key belongs
+// to, since the same attribute offset is used for every lane.
+
+// the varying version of getRdl2Ctx(sceneObj).attributes
+inline VPTR8 getRdl2Attributes(VPTR8 sceneObj)
+{
+    // within each scene object, find mAttributeStorage and deref it
+    uniform int8* uniform * varying attribStoragePtr =
+        (uniform int8* uniform * varying)(sceneObj + SCENEOBJ_ATTRIB_OFFSET);
+    return *attribStoragePtr;
+}
+
+// bool
+inline varying bool get(
+    VPTR8 base,
+    const uniform BoolAttrKeyISPC * uniform keyIn)
+{
+    uniform AttributeKey* uniform key =
+        (uniform AttributeKey* uniform)keyIn;
+
+    // C++ bools are stored in a single byte
+    return *((uniform int8* varying)(base + key->mOffset)) != 0;
+}
+
+// int
+inline varying int get(
+    VPTR8 base,
+    const uniform IntAttrKeyISPC * uniform keyIn)
+{
+    uniform AttributeKey* uniform key =
+        (uniform AttributeKey* uniform)keyIn;
+
+    return *((uniform int* varying)(base + key->mOffset));
+}
+
+// float
+inline varying float get(
+    VPTR8 base,
+    const uniform FloatAttrKeyISPC * uniform keyIn)
+{
+    uniform AttributeKey* uniform key =
+        (uniform AttributeKey* uniform)keyIn;
+
+    return *((uniform float* varying)(base + key->mOffset));
+}
+
+// float2
+inline varying float<2> get(
+    VPTR8 base,
+    const uniform Float2AttrKeyISPC * uniform keyIn)
+{
+    varying float<2> result;
+    uniform AttributeKey* uniform key =
+        (uniform AttributeKey* uniform)keyIn;
+
+    uniform float* varying ans =
+        (uniform float* varying)(base + key->mOffset);
+
+    // component-wise, like the uniform version
+    result.x = ans[0];
+    result.y = ans[1];
+
+    return result;
+}
+
+// float3 (and Color)
+inline varying float<3> get(
+    VPTR8 base,
+    const uniform Float3AttrKeyISPC * uniform keyIn)
+{
+    varying float<3> result;
+    uniform AttributeKey* uniform key =
+        (uniform AttributeKey* uniform)keyIn;
+
+    uniform float* varying ans =
+        (uniform float* varying)(base + key->mOffset);
+
+    result.x = ans[0];
+    result.y = ans[1];
+    result.z = ans[2];
+
+    return result;
+}
+
+// float4 (and Color4)
+inline varying float<4> get(
+    VPTR8 base,
+    const uniform Float4AttrKeyISPC * uniform keyIn)
+{
+    varying float<4> result;
+    uniform AttributeKey* uniform key =
+        (uniform AttributeKey* uniform)keyIn;
+
+    uniform float* varying ans =
+        (uniform float* varying)(base + key->mOffset);
+
+    result.x = ans[0];
+    result.y = ans[1];
+    result.z = ans[2];
+    result.w = ans[3];
+
+    return result;
+}
 #endif
 
 
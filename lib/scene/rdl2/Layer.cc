@@ -19,6 +19,10 @@
 #include <scene_rdl2/common/except/exceptions.h>
 #include <scene_rdl2/render/util/Strings.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <atomic>
 #include <cstddef>
 #include <sstream>
 #include <string>
@@ -27,6 +31,34 @@
 
 namespace {
 
+// Key of an assignment in the batch assign() index. The part is an interned
+// part id of the LayerAssignmentBatch.
+struct GeometryPartKey
+{
+    const scene_rdl2::rdl2::SceneObject* mGeometry;
+    uint32_t mPartId;
+
+    bool operator==(const GeometryPartKey& other) const
+    {
+        return mGeometry == other.mGeometry && mPartId == other.mPartId;
+    }
+};
+
+struct GeometryPartKeyHash
+{
+    std::size_t operator()(const GeometryPartKey& key) const
+    {
+        const uint64_t g = reinterpret_cast<uintptr_t>(key.mGeometry) >> 4;
+        return static_cast<std::size_t>((g * 0x9e3779b97f4a7c15ULL) ^ key.mPartId);
+    }
+};
+
+inline void
+hashCombine(std::size_t& seed, const void* ptr)
+{
+    seed ^= std::hash<const void*>()(ptr) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
 // convenience function that checks for the existence of a procedural
 // and then calls its deformed() method, returning false if it
 // does not exist.
@@ -214,6 +246,177 @@ Layer::assign(Geometry* geometry, const String& partName, const LayerAssignment&
     return idx;
 }
 
+std::vector<int32_t>
+Layer::assign(const LayerAssignmentBatch& batch)
+{
+    if (!mUpdateActive) {
+        std::stringstream errMsg;
+        errMsg << "Can only make batch assignment (" << batch.size() << " entries)"
+            " in Layer '" << mName << "' between beginUpdate() and endUpdate() calls.";
+        throw except::RuntimeError(errMsg.str());
+    }
+
+    const auto& entries = batch.getEntries();
+    const auto& partNames = batch.getPartNames();
+    const auto& palette = batch.getPalette();
+
+    std::vector<int32_t> ids(entries.size(), -1);
+    if (entries.empty()) {
+        return ids;
+    }
+
+    // Assignments with a volume shader always use the entire geometry (see
+    // the single assign() above), so they are keyed by the "" part. If the
+    // batch never interned "", it gets the id one past the part table.
+    const int64_t emptyPartId = batch.findPart("");
+    const uint32_t emptyPart = (emptyPartId >= 0) ?
+        static_cast<uint32_t>(emptyPartId) : static_cast<uint32_t>(partNames.size());
+    auto partNameOf = [&](uint32_t partId) -> const String& {
+        static const String sEmpty;
+        return (partId < partNames.size()) ? partNames[partId] : sEmpty;
+    };
+
+    // Get mutable references to the attribute vectors.
+    auto& geometries = getMutable(sGeometriesKey);
+    auto& parts = getMutable(sPartsKey);
+    auto& surfaceShaders = getMutable(sSurfaceShadersKey);
+    auto& lightSets = getMutable(sLightSetsKey);
+    auto& displacements = getMutable(sDisplacementsKey);
+    auto& volumeShaders = getMutable(sVolumeShadersKey);
+    auto& lightFilterSets = getMutable(sLightFilterSetsKey);
+    auto& shadowSets = getMutable(sShadowSetsKey);
+    auto& shadowReceiverSets = getMutable(sShadowReceiverSetsKey);
+
+    const std::size_t existingCount = geometries.size();
+    MNRY_ASSERT(surfaceShaders.size() == existingCount);
+
+    // Compute the keys of the existing assignments and of the batch entries in
+    // parallel. Existing part names which the batch never interned can't be
+    // matched by any entry, so they get a null key.
+    std::vector<GeometryPartKey> existingKeys(existingCount);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, existingCount),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+            const String& part = parts[i];
+            const int64_t partId = part.empty() ? emptyPart : batch.findPart(part);
+            existingKeys[i] = (partId < 0) ?
+                GeometryPartKey {nullptr, 0} :
+                GeometryPartKey {geometries[i], static_cast<uint32_t>(partId)};
+        }
+    });
+
+    std::atomic<bool> badEntry(false);
+    std::vector<GeometryPartKey> entryKeys(entries.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, entries.size()),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+            const auto& entry = entries[i];
+            if (!entry.mGeometry ||
+                entry.mPartId >= partNames.size() ||
+                entry.mAssignmentId >= palette.size()) {
+                badEntry = true;
+                continue;
+            }
+            const bool wholeGeometry = palette[entry.mAssignmentId].mVolumeShader != nullptr;
+            entryKeys[i] = GeometryPartKey {entry.mGeometry,
+                                            wholeGeometry ? emptyPart : entry.mPartId};
+        }
+    });
+    if (badEntry) {
+        std::stringstream errMsg;
+        errMsg << "Batch assignment in Layer '" << mName << "' has entries with a null"
+            " Geometry or with a part/assignment id out of the batch tables.";
+        throw except::IndexError(errMsg.str());
+    }
+
+    std::unordered_map<GeometryPartKey, int32_t, GeometryPartKeyHash> index;
+    index.reserve(existingCount + entries.size());
+    for (std::size_t i = 0; i < existingCount; ++i) {
+        if (existingKeys[i].mGeometry) {
+            index.emplace(existingKeys[i], static_cast<int32_t>(i));
+        }
+    }
+
+    // Resolve the entries in order. New assignments only record their palette
+    // id here (a later entry for the same key overrides it), existing ones are
+    // reassigned in place like the single assign() does.
+    bool shouldDirtyAssignments = false;
+    std::vector<uint32_t> newAssignments;
+    std::vector<const GeometryPartKey*> newKeys;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const auto& key = entryKeys[i];
+        const uint32_t assignmentId = entries[i].mAssignmentId;
+        const auto result =
+            index.emplace(key, static_cast<int32_t>(existingCount + newAssignments.size()));
+        const int32_t idx = result.first->second;
+        ids[i] = idx;
+
+        if (result.second) {
+            newAssignments.push_back(assignmentId);
+            newKeys.push_back(&key);
+        } else if (static_cast<std::size_t>(idx) >= existingCount) {
+            newAssignments[idx - existingCount] = assignmentId;
+        } else {
+            const LayerAssignment& la = palette[assignmentId];
+            auto update = [&](SceneObjectVector& column, SceneObject* value) {
+                if (column[idx] != value) {
+                    column[idx] = value;
+                    shouldDirtyAssignments = true;
+                }
+            };
+            update(surfaceShaders, la.mMaterial);
+            update(lightSets, la.mLightSet);
+            update(displacements, la.mDisplacement);
+            update(volumeShaders, la.mVolumeShader);
+            update(lightFilterSets, la.mLightFilterSet);
+            update(shadowSets, la.mShadowSet);
+            update(shadowReceiverSets, la.mShadowReceiverSet);
+        }
+    }
+
+    const std::size_t newCount = newAssignments.size();
+    if (newCount > 0) {
+        shouldDirtyAssignments = true;
+
+        // The geometry index has to be appended serially, the assignment
+        // columns are filled in parallel from the palette.
+        parts.reserve(existingCount + newCount);
+        for (const GeometryPartKey* key : newKeys) {
+            geometries.push_back(const_cast<SceneObject*>(key->mGeometry));
+            parts.push_back(partNameOf(key->mPartId));
+        }
+
+        const std::size_t total = existingCount + newCount;
+        surfaceShaders.resize(total);
+        lightSets.resize(total);
+        displacements.resize(total);
+        volumeShaders.resize(total);
+        lightFilterSets.resize(total);
+        shadowSets.resize(total);
+        shadowReceiverSets.resize(total);
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, newCount),
+                          [&](const tbb::blocked_range<std::size_t>& range) {
+            for (std::size_t j = range.begin(); j != range.end(); ++j) {
+                const LayerAssignment& la = palette[newAssignments[j]];
+                const std::size_t idx = existingCount + j;
+                surfaceShaders[idx] = la.mMaterial;
+                lightSets[idx] = la.mLightSet;
+                displacements[idx] = la.mDisplacement;
+                volumeShaders[idx] = la.mVolumeShader;
+                lightFilterSets[idx] = la.mLightFilterSet;
+                shadowSets[idx] = la.mShadowSet;
+                shadowReceiverSets[idx] = la.mShadowReceiverSet;
+            }
+        });
+    }
+
+    if (shouldDirtyAssignments) {
+        dirtyAssignments();
+    }
+
+    return ids;
+}
+
 const Material*
 Layer::lookupMaterial(int32_t assignmentId) const
 {
@@ -846,6 +1049,57 @@ Layer::end(const LightSet* lightSet) const
                             lightSet);
 }
 
+std::size_t
+LayerAssignmentHash::operator()(const LayerAssignment& a) const
+{
+    std::size_t seed = 0;
+    hashCombine(seed, a.mMaterial);
+    hashCombine(seed, a.mLightSet);
+    hashCombine(seed, a.mDisplacement);
+    hashCombine(seed, a.mVolumeShader);
+    hashCombine(seed, a.mLightFilterSet);
+    hashCombine(seed, a.mShadowSet);
+    hashCombine(seed, a.mShadowReceiverSet);
+    return seed;
+}
+
+void
+LayerAssignmentBatch::clear()
+{
+    mEntries.clear();
+    mPartNames.clear();
+    mPartIds.clear();
+    mPalette.clear();
+    mPaletteIds.clear();
+}
+
+uint32_t
+LayerAssignmentBatch::internPart(const String& partName)
+{
+    const auto result = mPartIds.emplace(partName, static_cast<uint32_t>(mPartNames.size()));
+    if (result.second) {
+        mPartNames.push_back(partName);
+    }
+    return result.first->second;
+}
+
+uint32_t
+LayerAssignmentBatch::internAssignment(const LayerAssignment& layerAssignment)
+{
+    const auto result = mPaletteIds.emplace(layerAssignment, static_cast<uint32_t>(mPalette.size()));
+    if (result.second) {
+        mPalette.push_back(layerAssignment);
+    }
+    return result.first->second;
+}
+
+int64_t
+LayerAssignmentBatch::findPart(const String& partName) const
+{
+    const auto it = mPartIds.find(partName);
+    return (it == mPartIds.end()) ? -1 : static_cast<int64_t>(it->second);
+}
+
 } // namespace rdl2
 } // namespace scene_rdl2
 
@@ -18,6 +18,7 @@
 #include <utility>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace scene_rdl2 {
 namespace rdl2 {
@@ -41,6 +42,100 @@ struct LayerAssignment {
     ShadowReceiverSet* mShadowReceiverSet;
 };
 
+inline bool
+operator==(const LayerAssignment& a, const LayerAssignment& b)
+{
+    return a.mMaterial == b.mMaterial &&
+           a.mLightSet == b.mLightSet &&
+           a.mDisplacement == b.mDisplacement &&
+           a.mVolumeShader == b.mVolumeShader &&
+           a.mLightFilterSet == b.mLightFilterSet &&
+           a.mShadowSet == b.mShadowSet &&
+           a.mShadowReceiverSet == b.mShadowReceiverSet;
+}
+
+inline bool
+operator!=(const LayerAssignment& a, const LayerAssignment& b)
+{
+    return !(a == b);
+}
+
+struct LayerAssignmentHash {
+    std::size_t operator()(const LayerAssignment& a) const;
+};
+
+/**
+ * LayerAssignmentBatch collects Geometry/part/LayerAssignment entries for
+ * Layer::assign(const LayerAssignmentBatch&).
+ *
+ * Big layers (crowds, instanced sets) hold millions of assignments which
+ * mostly repeat a few hundred part names and LayerAssignment tuples. The batch
+ * keeps every part name and every distinct LayerAssignment once and each
+ * entry refers to them by 32-bit ids, so Layer::assign() resolves the keys by
+ * integer ids instead of string compares.
+ *
+ * This is a build path only. Layer::assign() expands every entry into the
+ * Layer's per-assignment attribute columns (parts, materials, lightsets, ...),
+ * which are the ASCII/binary I/O and renderer contract, so the Layer's memory
+ * footprint is the same as with the single assign().
+ *
+ * Sample usage:
+ *
+ *      LayerAssignmentBatch batch;
+ *      const uint32_t lidPart = batch.internPart("lid");
+ *      const uint32_t red = batch.internAssignment(redAssignment);
+ *      for (Geometry* g : crowd) batch.add(g, lidPart, red);
+ *      layer->beginUpdate();
+ *      const std::vector<int32_t> ids = layer->assign(batch);
+ *      layer->endUpdate();
+ */
+class LayerAssignmentBatch
+{
+public:
+    struct Entry {
+        Geometry* mGeometry;
+        uint32_t mPartId;       // index into getPartNames()
+        uint32_t mAssignmentId; // index into getPalette()
+    };
+
+    void reserve(std::size_t entryCount) { mEntries.reserve(entryCount); }
+    void clear();
+
+    /// Returns the id of the part name, adding it to the part table if needed.
+    uint32_t internPart(const String& partName);
+
+    /// Returns the palette id of the assignment tuple, adding it to the
+    /// palette if needed.
+    uint32_t internAssignment(const LayerAssignment& layerAssignment);
+
+    void add(Geometry* geometry, uint32_t partId, uint32_t assignmentId)
+    {
+        mEntries.push_back(Entry {geometry, partId, assignmentId});
+    }
+    void add(Geometry* geometry, const String& partName, const LayerAssignment& layerAssignment)
+    {
+        add(geometry, internPart(partName), internAssignment(layerAssignment));
+    }
+
+    std::size_t size() const { return mEntries.size(); }
+    bool empty() const { return mEntries.empty(); }
+    const Entry& operator[](std::size_t i) const { return mEntries[i]; }
+
+    const std::vector<Entry>& getEntries() const { return mEntries; }
+    const StringVector& getPartNames() const { return mPartNames; }
+    const std::vector<LayerAssignment>& getPalette() const { return mPalette; }
+
+    /// Returns the part id of the name, or -1 if the name was never interned.
+    int64_t findPart(const String& partName) const;
+
+private:
+    std::vector<Entry> mEntries;
+    StringVector mPartNames;
+    std::unordered_map<String, uint32_t> mPartIds;
+    std::vector<LayerAssignment> mPalette;
+    std::unordered_map<LayerAssignment, uint32_t, LayerAssignmentHash> mPaletteIds;
+};
+
 /**
  * The Layer is a subclass of the TraceSet. It stores material and light
  * assignments to parts on a Geometry. Each assignment is made up of the
@@ -152,6 +247,20 @@ public:
      */
     int32_t assign(Geometry* geometry, const String& partName, const LayerAssignment& layerAssignment);
 
+    /**
+     * Makes all the assignments of the batch, with the same semantics as
+     * calling assign(geometry, partName, layerAssignment) for every entry in
+     * order (a later entry for the same Geometry/part reassigns it). Part
+     * names are resolved through the interned part ids, the existing
+     * assignments are indexed in parallel and the new assignment columns are
+     * filled in parallel from the batch palette. The Layer stores the
+     * expanded values, not palette ids.
+     *
+     * @param   batch   The assignments to make.
+     * @return  The assignment IDs, one for each batch entry in batch order.
+     */
+    std::vector<int32_t> assign(const LayerAssignmentBatch& batch);
+
     /**
      * Given a valid assignment ID, this will return a std::pair containing the
      * Material and LightSet assignments which are set in the Layer. If the
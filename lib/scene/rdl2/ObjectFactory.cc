@@ -7,6 +7,7 @@
 #include "Camera.h"
 #include "Displacement.h"
 #include "Dso.h"
+#include "DsoDeclarationCache.h"
 #include "GeometrySet.h"
 #include "RenderOutput.h"
 #include "Layer.h"
@@ -122,10 +123,31 @@ ObjectFactory::ObjectFactory(ClassDeclareFunc declareFunc, ObjectCreateFunc crea
     MNRY_ASSERT(mDestroyFunc, "ObjectFactory must have a destroy function pointer!");
 }
 
+ObjectFactory::ObjectFactory(std::shared_ptr<const CachedClassDeclaration> declaration,
+                             ObjectCreateFunc createFunc, ObjectDestroyFunc destroyFunc) :
+    mCachedDeclaration(std::move(declaration)),
+    mDeclareFunc(nullptr),
+    mCreateFunc(createFunc),
+    mDestroyFunc(destroyFunc)
+{
+    MNRY_ASSERT(mCachedDeclaration, "ObjectFactory must have a cached declaration!");
+    MNRY_ASSERT(mCreateFunc, "ObjectFactory must have a create function pointer!");
+    MNRY_ASSERT(mDestroyFunc, "ObjectFactory must have a destroy function pointer!");
+}
+
+SceneObjectInterface
+ObjectFactory::declareCached(SceneClass& sceneClass)
+{
+    return mCachedDeclaration->declare(sceneClass);
+}
+
 std::string
 ObjectFactory::getSourcePath() const
 {
-    return (mDso) ? mDso->getFilePath() : std::string();
+    if (mDso) {
+        return mDso->getFilePath();
+    }
+    return (mCachedDeclaration) ? mCachedDeclaration->getFilePath() : std::string();
 }
 
 template <typename T>
@@ -182,6 +204,13 @@ ObjectFactory::createProxyFactory(const std::string& className, const std::strin
         new ObjectFactory(declarer, proxyCreate, proxyDestroy, std::move(dso)));
 }
 
+std::unique_ptr<ObjectFactory>
+ObjectFactory::createCachedProxyFactory(std::shared_ptr<const CachedClassDeclaration> declaration)
+{
+    return std::unique_ptr<ObjectFactory>(
+        new ObjectFactory(std::move(declaration), proxyCreate, proxyDestroy));
+}
+
 } // namespace rdl2
 } // namespace scene_rdl2
 
@@ -23,7 +23,8 @@ namespace rdl2 {
  * attribute declarations, but are constructed from built in proxy types).
  *
  * The ObjectFactory also takes ownership of a Dso object, if loading symbols
- * from any DSO is required.
+ * from any DSO is required. A cached proxy factory replays declarations
+ * recorded in a DsoDeclarationCache instead, and never loads the DSO.
  *
  * Thread Safety:
  *  - Creating ObjectFactories for the same SceneClass from different threads
@@ -111,11 +112,30 @@ public:
      */
     static std::unique_ptr<ObjectFactory> createProxyFactory(const std::string& className, const std::string& dsoPath);
 
+    /**
+     * Create an ObjectFactory that replays the given cached declarations of a
+     * proxy DSO, and creates and destroys objects through built in proxy
+     * objects. The DSO itself is never opened.
+     *
+     * @param   declaration The declarations recorded from the proxy DSO.
+     * @return  An ObjectFactory that can declare, create, and destroy these
+     *          proxy objects.
+     */
+    static std::unique_ptr<ObjectFactory> createCachedProxyFactory(
+        std::shared_ptr<const CachedClassDeclaration> declaration);
+
 private:
     ObjectFactory(ClassDeclareFunc declareFunc, ObjectCreateFunc createFunc,
                   ObjectDestroyFunc destroyFunc, std::unique_ptr<Dso> dso = nullptr);
 
+    ObjectFactory(std::shared_ptr<const CachedClassDeclaration> declaration,
+                  ObjectCreateFunc createFunc, ObjectDestroyFunc destroyFunc);
+
+    // Replays the cached declarations when there is no declare function.
+    SceneObjectInterface declareCached(SceneClass& sceneClass);
+
     std::unique_ptr<Dso> mDso;
+    std::shared_ptr<const CachedClassDeclaration> mCachedDeclaration;
     ClassDeclareFunc mDeclareFunc;
     ObjectCreateFunc mCreateFunc;
     ObjectDestroyFunc mDestroyFunc;
@@ -124,7 +144,7 @@ private:
 SceneObjectInterface
 ObjectFactory::declare(SceneClass& sceneClass)
 {
-    return mDeclareFunc(sceneClass);
+    return (mDeclareFunc) ? mDeclareFunc(sceneClass) : declareCached(sceneClass);
 }
 
 SceneObject*
@@ -32,6 +32,7 @@ namespace rdl2 {
 
 // Forward declarations necessary for unit tests.
 namespace unittest {
+    class TestISPCSupport;
     class TestSceneClass;
     class TestSceneObject;
     class TestValueContainer;
@@ -501,6 +502,12 @@ private:
     static finline bool setValue(const void* storage, AttributeKey<T> key,
                                  AttributeTimestep timestep, const T& value);
 
+    // Same as above, but the value is moved into the storage instead of
+    // copied. Large vector attributes only pay for the equality check.
+    template <typename T>
+    static finline bool setValue(const void* storage, AttributeKey<T> key,
+                                 AttributeTimestep timestep, T&& value);
+
     // Helper function to compare an attribute value at a specific memory
     // location with a given value. The function returns true if equal and
     // false otherwise
@@ -578,8 +585,10 @@ private:
     // Classes requiring access for serialization.
     friend class BinaryWriter;
     friend class BinaryReader;
+    friend class CachedClassDeclaration;
 
     // Classes that need access for testing purposes.
+    friend class unittest::TestISPCSupport;
     friend class unittest::TestSceneClass;
     friend class unittest::TestSceneObject;
     friend class unittest::TestValueContainer;
@@ -875,8 +884,22 @@ SceneClass::setValue(const void* storage, AttributeKey<T> key,
     if (isEqualToValue(&(base[timestep]), value)) {
         return false;
     }
-    destructValue(&(base[timestep]));
-    constructValue(&(base[timestep]), value);
+    // Copy assignment reuses the existing allocation of vector types when it
+    // is large enough, destruct + construct always reallocates.
+    base[timestep] = value;
+    return true;
+}
+
+template <typename T>
+bool
+SceneClass::setValue(const void* storage, AttributeKey<T> key,
+                     AttributeTimestep timestep, T&& value)
+{
+    T* base = reinterpret_cast<T*>((uintptr_t)storage + key.mOffset);
+    if (isEqualToValue(&(base[timestep]), static_cast<const T&>(value))) {
+        return false;
+    }
+    base[timestep] = std::move(value);
     return true;
 }
 
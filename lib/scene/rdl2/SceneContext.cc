@@ -6,6 +6,7 @@
 
 #include "Camera.h"
 #include "Dso.h"
+#include "DsoDeclarationCache.h"
 #include "DsoFinder.h"
 #include "Geometry.h"
 #include "GeometrySet.h"
@@ -27,11 +28,15 @@
 
 #include <scene_rdl2/common/platform/Platform.h>
 #include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecZone.h>
+#include <scene_rdl2/render/util/Files.h>
 #include <scene_rdl2/render/util/Strings.h>
 #include <scene_rdl2/render/logging/logging.h>
 
 #include <tbb/concurrent_hash_map.h>
 #include <tbb/mutex.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
 
 #include <algorithm>
@@ -40,10 +45,12 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <libgen.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -86,6 +93,8 @@ SceneContext::createBuiltInSceneClass(const std::string& className)
 }
 
 SceneContext::SceneContext() :
+    mTimeRescalingCoeffs(TimeRescalingCoeffs{0.0f, 0.0f}),
+    mTimeRescalingCoeffsVersion(0),
     mProxyModeEnabled(false),
     mSceneVariables(nullptr),
     mRender2World(nullptr),
@@ -333,13 +342,34 @@ SceneContext::createSceneClass(const std::string& className)
         try {
             std::string dsoPath = getDsoPath();
             if (mProxyModeEnabled) {
-                sc.reset(new SceneClass(this, className,
-                    ObjectFactory::createProxyFactory(className, dsoPath)));
+                // Proxy SceneClasses only need the declarations, which may
+                // come from the declaration cache without opening the DSO.
+                std::shared_ptr<const CachedClassDeclaration> cached;
+                if (mDeclarationCache) {
+                    std::string proxyFilePath = className + ".so.proxy";
+                    if (!dsoPath.empty()) {
+                        proxyFilePath = util::findFile(proxyFilePath, dsoPath);
+                    }
+                    cached = mDeclarationCache->find(proxyFilePath);
+                }
+
+                if (cached) {
+                    sc.reset(new SceneClass(this, className,
+                        ObjectFactory::createCachedProxyFactory(std::move(cached))));
+                    sc->declare();
+                } else {
+                    sc.reset(new SceneClass(this, className,
+                        ObjectFactory::createProxyFactory(className, dsoPath)));
+                    sc->declare();
+                    if (mDeclarationCache) {
+                        mDeclarationCache->record(*sc, sc->getSourcePath());
+                    }
+                }
             } else {
                 sc.reset(new SceneClass(this, className,
                     ObjectFactory::createDsoFactory(className, dsoPath)));
+                sc->declare();
             }
-            sc->declare();
             sc->setComplete();
         } catch (...) {
             // Something went wrong when creating the SceneClass. Roll back
@@ -479,6 +509,8 @@ SceneContext::createSceneObject(const std::string& className,
 void
 SceneContext::applyUpdates(Layer * const layer)
 {
+    REC_ZONE("SceneContext::applyUpdates");
+
     // Now that the scene variables and the camera are available, we can update the
     // coefficients in the scene context that hold information about the shutter interval and
     // motion steps.
@@ -499,6 +531,7 @@ SceneContext::applyUpdates(Layer * const layer)
     // cache primitive attributes contained in the shader network of all materials.
     // This must be done before any updates to SceneObjects.
     if (layer) {
+        REC_ZONE("SceneContext::applyUpdates cacheShaderGraphPrimAttributes");
         Layer::MaterialSet materials;
         layer->getAllMaterials(materials);
         for (const Material* m : materials) {
@@ -549,15 +582,19 @@ SceneContext::applyUpdates(Layer * const layer)
         Logger::info("Updating ", s, " leaf scene objects...");
     } 
 
-    tbb::parallel_for_each(mSceneObjectUpdateGraph.cbegin(), mSceneObjectUpdateGraph.cend(),
-            [&] (SceneObject* const obj)
     {
-        obj->debug("Updating");
-        obj->update();
-    });
+        REC_ZONE("SceneContext::applyUpdates update leaves");
+        tbb::parallel_for_each(mSceneObjectUpdateGraph.cbegin(), mSceneObjectUpdateGraph.cend(),
+                [&] (SceneObject* const obj)
+        {
+            obj->debug("Updating");
+            obj->update();
+        });
+    }
 
     // Update the objects from bottom up
     for (int i = mSceneObjectUpdateGraph.getMaxDepth()-1; i >= 0; --i) {
+        REC_ZONE("SceneContext::applyUpdates update level");
         int s = mSceneObjectUpdateGraph.size(i);
         if (s == 0){
             Logger::info("There is no scene object need to be updated at level ", i);
@@ -720,41 +757,18 @@ SceneContext::commitAllChanges()
 void
 SceneContext::loadAllSceneClasses()
 {
+    const char* extension = (mProxyModeEnabled) ? ".so.proxy" : ".so";
+    const std::size_t extensionSize = std::strlen(extension);
+
+    // Split the DSO path into its directories.
+    std::vector<std::string> directories;
     std::string remaining(getDsoPath());
     while (!remaining.empty()) {
-        // Grab the next path entry.
         std::size_t colonPos = remaining.find_first_of(':');
         std::string directory = remaining.substr(0, colonPos);
-
-        // Grab the contents of each directory.
-        DIR* directoryPtr = opendir(directory.c_str());
-        if (directoryPtr != nullptr) {
-            struct dirent* entryPtr;
-            while ((entryPtr = readdir(directoryPtr))) {
-                std::string fileName(entryPtr->d_name);
-
-                // If the file is a valid DSO, then create a SceneClass from it.
-                if (Dso::isValidDso(directory + '/' + fileName, mProxyModeEnabled)) {
-                    // Class name is the file name without ".so" (or
-                    // ".so.proxy" in proxy mode).
-                    std::string className;
-                    if (mProxyModeEnabled) {
-                        className = fileName.substr(0, fileName.size() - 9);
-                    } else {
-                        className = fileName.substr(0, fileName.size() - 3);
-                    }
-
-                    try {
-                        createSceneClass(className);
-                    } catch (...) {
-                        // Swallow exceptions here. If something was wrong with
-                        // the declare() function, just move on to the next
-                        // SceneClass.
-                    }
-                }
-            }
+        if (!directory.empty()) {
+            directories.push_back(std::move(directory));
         }
-        closedir(directoryPtr);
 
         // Move to the next path entry.
         if (colonPos != std::string::npos) {
@@ -763,26 +777,131 @@ SceneContext::loadAllSceneClasses()
             remaining = "";
         }
     }
+
+    // Scan all the directories in parallel. Each directory keeps its class
+    // names (the file name without ".so", or ".so.proxy" in proxy mode) sorted
+    // by name, so the result does not depend on the readdir() order.
+    std::vector<std::vector<std::string>> directoryClassNames(directories.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, directories.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+            DIR* directoryPtr = opendir(directories[i].c_str());
+            if (directoryPtr == nullptr) {
+                continue;
+            }
+            std::vector<std::string>& classNames = directoryClassNames[i];
+            struct dirent* entryPtr;
+            while ((entryPtr = readdir(directoryPtr))) {
+                const std::size_t nameSize = std::strlen(entryPtr->d_name);
+                if (nameSize > extensionSize &&
+                    std::strcmp(entryPtr->d_name + nameSize - extensionSize, extension) == 0) {
+                    classNames.emplace_back(entryPtr->d_name, nameSize - extensionSize);
+                }
+            }
+            closedir(directoryPtr);
+            std::sort(classNames.begin(), classNames.end());
+        }
+    });
+
+    // Only the first directory providing a class is used, which is also the
+    // DSO that createSceneClass() will find in the DSO path.
+    std::vector<std::pair<std::string, std::string>> candidates; // (className, filePath)
+    std::unordered_set<std::string> seenClassNames;
+    for (std::size_t i = 0; i < directories.size(); ++i) {
+        for (std::string& className : directoryClassNames[i]) {
+            if (seenClassNames.insert(className).second) {
+                std::string filePath = directories[i] + '/' + className + extension;
+                candidates.emplace_back(std::move(className), std::move(filePath));
+            }
+        }
+    }
+
+    // dlopen() is serialized by the dynamic loader lock, so opening the DSOs
+    // from multiple threads doesn't help. Instead we read the DSO files into
+    // the page cache in parallel, which takes the I/O latency out of the
+    // serial dlopen() calls below. DSOs declared from the cache are skipped.
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, candidates.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t>& range) {
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+            const std::string& filePath = candidates[i].second;
+            if (mProxyModeEnabled && mDeclarationCache && mDeclarationCache->find(filePath)) {
+                continue;
+            }
+            int fd = open(filePath.c_str(), O_RDONLY);
+            if (fd < 0) {
+                continue;
+            }
+            posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+            close(fd);
+        }
+    });
+
+    // Create the SceneClasses serially, so they are always registered in the
+    // same order.
+    for (const auto& candidate : candidates) {
+        try {
+            createSceneClass(candidate.first);
+        } catch (...) {
+            // Swallow exceptions here. If something was wrong with the DSO
+            // or its declare() function, just move on to the next SceneClass.
+        }
+    }
+
+    if (mDeclarationCache && mDeclarationCache->isDirty()) {
+        try {
+            saveDeclarationCache();
+        } catch (const except::IoError& e) {
+            Logger::warn(e.what());
+        }
+    }
+}
+
+void
+SceneContext::setDeclarationCacheFile(const std::string& cacheFile)
+{
+    mDeclarationCacheFile = cacheFile;
+    if (cacheFile.empty()) {
+        mDeclarationCache.reset();
+        return;
+    }
+
+    mDeclarationCache.reset(new DsoDeclarationCache);
+    mDeclarationCache->load(cacheFile);
 }
 
+void
+SceneContext::saveDeclarationCache()
+{
+    if (mDeclarationCache && mDeclarationCache->isDirty()) {
+        mDeclarationCache->save(mDeclarationCacheFile);
+    }
+}
+
+static_assert(std::atomic<TimeRescalingCoeffs>::is_always_lock_free,
+              "Interpolated get() relies on lock free TimeRescalingCoeffs snapshots");
+
 void
 SceneContext::computeTimeRescalingCoeffs(float shutterOpen, float shutterClose, const std::vector<float> &motionSteps)
 {
     // See declaration of TimeRescalingCoeffs in Types.h for details.
 
-    tbb::mutex::scoped_lock lock(mTimeRescalingCoeffsMutex);
-
     MNRY_ASSERT_REQUIRE(motionSteps.size() >= 1 && motionSteps.size() <= 2);
+    TimeRescalingCoeffs coeffs;
     if (motionSteps.size() == 1  ||  motionSteps[0] == motionSteps[1]) {
         // Handle extraordinary case where we don't have 2 distinct motion steps
         // (denominator of the coefficients would be 0).
-        mTimeRescalingCoeffs.mScale = 0.0f;
-        mTimeRescalingCoeffs.mOffset = 0.0f;
+        coeffs.mScale = 0.0f;
+        coeffs.mOffset = 0.0f;
     } else {
         float oneOverDenom = 1.0f / (motionSteps[1] - motionSteps[0]);
-        mTimeRescalingCoeffs.mScale  = (shutterClose - shutterOpen   ) * oneOverDenom;
-        mTimeRescalingCoeffs.mOffset = (shutterOpen  - motionSteps[0]) * oneOverDenom;
+        coeffs.mScale  = (shutterClose - shutterOpen   ) * oneOverDenom;
+        coeffs.mOffset = (shutterOpen  - motionSteps[0]) * oneOverDenom;
     }
+
+    // Publish the new snapshot. Concurrent interpolated gets keep using the
+    // previous one until they load again.
+    mTimeRescalingCoeffs.store(coeffs, std::memory_order_release);
+    mTimeRescalingCoeffsVersion.fetch_add(1, std::memory_order_release);
 }
 
 void
@@ -15,6 +15,8 @@
 #include <tbb/concurrent_hash_map.h>
 #include <tbb/mutex.h>
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 namespace scene_rdl2 {
@@ -145,6 +147,22 @@ public:
     /// Return the render to world transform, if set.  nullptr if not.
     finline const Mat4d* getRender2World() const;
 
+    /**
+     * Returns a snapshot of the time rescaling coefficients used by the
+     * interpolated get(). The coefficients are published atomically as a
+     * whole, so this never blocks and never returns a mix of old and new
+     * values, even while applyUpdates() changes the shutter interval or the
+     * motion steps on another thread.
+     */
+    finline TimeRescalingCoeffs getTimeRescalingCoeffs() const;
+
+    /**
+     * Returns the number of times the time rescaling coefficients have been
+     * published. Readers which cache data derived from the coefficients can
+     * compare versions to know when to refresh it.
+     */
+    finline uint32_t getTimeRescalingCoeffsVersion() const;
+
     finline bool getCheckpointActive() const;
     finline bool getResumableOutput() const;
     finline bool getResumeRender() const;
@@ -304,9 +322,43 @@ public:
      * opened as RDL DSOs are ignored. This can be used to fill up the SceneClass
      * map with all the available SceneClasses, and then iterate over them
      * exploring their attributes and attribute metadata.
+     *
+     * The directories are scanned in parallel and the DSO files are prefetched
+     * into the page cache in parallel, but the SceneClasses are always created
+     * in the same order: DSO path order, then file name order. If a class is
+     * found in several directories, the first one in the DSO path wins.
+     *
+     * If a declaration cache file is set, the cache is saved at the end when
+     * new declarations were recorded.
      */
     void loadAllSceneClasses();
 
+    /**
+     * Sets the file used to cache the attribute declarations of proxy DSOs and
+     * loads it. An empty file name disables the cache.
+     *
+     * In proxy mode, a SceneClass whose proxy DSO has a valid cache entry
+     * (same path, modification time and size) is declared from the cache
+     * without dlopen()'ing the DSO. Other proxy DSOs are loaded as usual and
+     * their declarations are recorded for the next saveDeclarationCache().
+     * SceneClasses which declare blind data with declareDataPtr() are never
+     * cached. The cache has no effect when proxy mode is disabled.
+     *
+     * @param   cacheFile   Path of the cache file. It doesn't need to exist.
+     */
+    void setDeclarationCacheFile(const std::string& cacheFile);
+
+    /// The declaration cache file, or an empty string if there is none.
+    finline const std::string& getDeclarationCacheFile() const;
+
+    /**
+     * Writes the declaration cache file if any declaration was recorded since
+     * it was loaded or last saved.
+     *
+     * @throw   except::IoError     If the cache file can't be written.
+     */
+    void saveDeclarationCache();
+
     void setFatalShadeFunc(ShadeFunc f) {mFatalShadeFunc = f;}
     ShadeFunc getFatalShadeFunc() const {return mFatalShadeFunc;}
     void setFatalSampleFunc(SampleFunc f) {mFatalSampleFunc = f;}
@@ -347,14 +399,18 @@ private:
     template <typename T>
     void createBuiltInSceneClass(const std::string& className);
 
-    // Computes the fast time rescaling coefficients for use by interpolated get().
-    // No interpolated gets should be happening on other threads while these are updated.
+    // Computes the fast time rescaling coefficients for use by interpolated
+    // get() and publishes them. Interpolated gets on other threads see either
+    // the old or the new coefficients.
     void computeTimeRescalingCoeffs(float shutterOpen, float shutterClose, const std::vector<float> &motionSteps);
 
     // Precomputed coefficients for fast time rescaling, which is used by the
     // interpolated get(). For more information, see the declaration of
-    // TimeRescalingCoeffs in Types.h.
-    TimeRescalingCoeffs mTimeRescalingCoeffs;
+    // TimeRescalingCoeffs in Types.h. Both coefficients fit in a single lock
+    // free atomic, so every store publishes a complete snapshot and readers
+    // never lock.
+    std::atomic<TimeRescalingCoeffs> mTimeRescalingCoeffs;
+    std::atomic<uint32_t> mTimeRescalingCoeffsVersion;
 
     // If we're in proxy mode, new scene classes will be created with a proxy
     // object factory instead of a DSO factory.
@@ -376,14 +432,6 @@ private:
     GeometryVector mGeometries;
     GeometrySetVector mGeometrySets;
 
-    // We also need a mutex to protect them, since the two SceneObjects could
-    // be updated concurrently in different threads. HOWEVER, this does NOT
-    // protect against the value of mTimeRescalingCoeffs being *read* while
-    // it's being updated. In other words, doing an interpolated get() against
-    // ANY object while the camera's shutter interval or SceneVariables motion
-    // steps are being updated is a recipe for threading errors.
-    tbb::mutex mTimeRescalingCoeffsMutex;
-
     // All cameras in the rdl context (including the primary camera).
     // This is in creation order.  The primary camera can't be assumed to be
     // the first one.  Use getPrimaryCamera() if you need the primary camera.
@@ -419,6 +467,10 @@ private:
     RenderOutputVector mRenderOutputs;
     std::string mDsoPath;
 
+    // Optional cache of proxy DSO declarations and the file backing it.
+    std::unique_ptr<DsoDeclarationCache> mDeclarationCache;
+    std::string mDeclarationCacheFile;
+
     // DAG of scene objects to update. It is a member variable of SceneContext so that we can call
     // updatePrep on multiple scene objects, or on the same scene object multiple times, without
     // the possibility of redundantly updating the same scene object multiple times.
@@ -437,6 +489,12 @@ SceneContext::setDsoPath(const std::string& dsoPath)
     mDsoPath = dsoPath;
 }
 
+const std::string&
+SceneContext::getDeclarationCacheFile() const
+{
+    return mDeclarationCacheFile;
+}
+
 bool
 SceneContext::getProxyModeEnabled() const
 {
@@ -529,6 +587,18 @@ SceneContext::getRender2World() const
     return mRender2World;
 }
 
+TimeRescalingCoeffs
+SceneContext::getTimeRescalingCoeffs() const
+{
+    return mTimeRescalingCoeffs.load(std::memory_order_acquire);
+}
+
+uint32_t
+SceneContext::getTimeRescalingCoeffsVersion() const
+{
+    return mTimeRescalingCoeffsVersion.load(std::memory_order_acquire);
+}
+
 bool
 SceneContext::getCheckpointActive() const
 {
@@ -8,12 +8,19 @@
 #include "SceneClass.h"
 #include "SceneContext.h"
 #include "Types.h"
+#include "ValueContainerDeq.h"
 
 #include <scene_rdl2/render/util/Strings.h>
 #include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/math/simd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <type_traits>
 #include <stdint.h>
 
 namespace scene_rdl2 {
@@ -66,8 +73,174 @@ interpolate(const Mat4d& begin, const Mat4d& end, float t)
     return math::slerp(begin, end, double(t));
 }
 
+// Interpolates one begin/end pair at many rescaled times, for
+// getInterpolated(). The generic version calls interpolate() per time.
+template <typename T>
+class BatchInterpolator
+{
+public:
+    BatchInterpolator(const T& begin, const T& end) : mBegin(begin), mEnd(end) {}
+
+    void
+    operator()(const float* t, std::size_t count, T* results) const
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = interpolate(mBegin, mEnd, t[i]);
+        }
+    }
+
+private:
+    T mBegin;
+    T mEnd;
+};
+
+template <>
+class BatchInterpolator<Float>
+{
+public:
+    BatchInterpolator(const Float& begin, const Float& end) : mBegin(begin), mEnd(end) {}
+
+    void
+    operator()(const float* t, std::size_t count, Float* results) const
+    {
+        std::size_t i = 0;
+#if defined(__AVX__)
+        const simd::avxf begin(mBegin);
+        const simd::avxf end(mEnd);
+        const simd::avxf one(1.0f);
+        for (; i + 8 <= count; i += 8) {
+            const simd::avxf t8(_mm256_loadu_ps(t + i));
+            _mm256_storeu_ps(results + i, (begin * (one - t8)) + (end * t8));
+        }
+#endif
+        for (; i < count; ++i) {
+            results[i] = interpolate(mBegin, mEnd, t[i]);
+        }
+    }
+
+private:
+    Float mBegin;
+    Float mEnd;
+};
+
+template <>
+class BatchInterpolator<Vec3f>
+{
+public:
+    BatchInterpolator(const Vec3f& begin, const Vec3f& end) : mBegin(begin), mEnd(end) {}
+
+    void
+    operator()(const float* t, std::size_t count, Vec3f* results) const
+    {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Vec3f must be tightly packed");
+
+        // 8 results are 24 floats, which is 3 AVX registers. Register r holds
+        // the components (xyz xyz xy), (z xyz xyz x) or (yz xyz xyz) of the
+        // times selected by timeIndex<r>.
+        const __m256i timeIndex0 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+        const __m256i timeIndex1 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+        const __m256i timeIndex2 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+        const simd::avxf b0(mBegin.x, mBegin.y, mBegin.z, mBegin.x, mBegin.y, mBegin.z, mBegin.x, mBegin.y);
+        const simd::avxf b1(mBegin.z, mBegin.x, mBegin.y, mBegin.z, mBegin.x, mBegin.y, mBegin.z, mBegin.x);
+        const simd::avxf b2(mBegin.y, mBegin.z, mBegin.x, mBegin.y, mBegin.z, mBegin.x, mBegin.y, mBegin.z);
+        const simd::avxf e0(mEnd.x, mEnd.y, mEnd.z, mEnd.x, mEnd.y, mEnd.z, mEnd.x, mEnd.y);
+        const simd::avxf e1(mEnd.z, mEnd.x, mEnd.y, mEnd.z, mEnd.x, mEnd.y, mEnd.z, mEnd.x);
+        const simd::avxf e2(mEnd.y, mEnd.z, mEnd.x, mEnd.y, mEnd.z, mEnd.x, mEnd.y, mEnd.z);
+        const simd::avxf one(1.0f);
+
+        float* out = reinterpret_cast<float*>(results);
+        for (; i + 8 <= count; i += 8) {
+            const __m256 t8 = _mm256_loadu_ps(t + i);
+            const simd::avxf t0(_mm256_permutevar8x32_ps(t8, timeIndex0));
+            const simd::avxf t1(_mm256_permutevar8x32_ps(t8, timeIndex1));
+            const simd::avxf t2(_mm256_permutevar8x32_ps(t8, timeIndex2));
+            _mm256_storeu_ps(out + 3 * i,      (b0 * (one - t0)) + (e0 * t0));
+            _mm256_storeu_ps(out + 3 * i + 8,  (b1 * (one - t1)) + (e1 * t1));
+            _mm256_storeu_ps(out + 3 * i + 16, (b2 * (one - t2)) + (e2 * t2));
+        }
+#endif
+        for (; i < count; ++i) {
+            results[i] = interpolate(mBegin, mEnd, t[i]);
+        }
+    }
+
+private:
+    Vec3f mBegin;
+    Vec3f mEnd;
+};
+
+// Same steps as math::slerp() on Mat4, but the begin and end matrices are
+// decomposed only once for all the times.
+template <typename M>
+class MatrixBatchInterpolator
+{
+public:
+    using Scalar = typename M::Scalar;
+    using XformComponent33 = math::XformComponent<typename M::Mat3T>;
+
+    MatrixBatchInterpolator(const M& begin, const M& end)
+    {
+        math::decompose(math::xform<typename M::Xform>(begin), mBegin);
+        math::decompose(math::xform<typename M::Xform>(end), mEnd);
+        if (dot(mBegin.r, mEnd.r) < 0) {
+            mEnd.r *= Scalar(-1.0);
+        }
+    }
+
+    void
+    operator()(const float* t, std::size_t count, M* results) const
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = M(math::slerp(mBegin, mEnd, Scalar(t[i])).combined());
+        }
+    }
+
+private:
+    XformComponent33 mBegin;
+    XformComponent33 mEnd;
+};
+
+template <>
+class BatchInterpolator<Mat4f> : public MatrixBatchInterpolator<Mat4f>
+{
+    using MatrixBatchInterpolator<Mat4f>::MatrixBatchInterpolator;
+};
+
+template <>
+class BatchInterpolator<Mat4d> : public MatrixBatchInterpolator<Mat4d>
+{
+    using MatrixBatchInterpolator<Mat4d>::MatrixBatchInterpolator;
+};
+
 } // namespace
 
+// Lazy values are only registered by the BinaryReader while nobody else
+// accesses the object. After that, the first get() of each value decodes it
+// under mMutex, and every other access only tests the atomic flags.
+struct SceneObject::LazyValues
+{
+    struct Entry
+    {
+        Entry(uint32_t index, const ValueContainerDeq& valueDeq) :
+            mIndex(index), mValueDeq(valueDeq), mPending(true) {}
+
+        uint32_t mIndex;
+        ValueContainerDeq mValueDeq; // positioned at the encoded value
+        std::atomic<bool> mPending;
+    };
+
+    std::deque<Entry> mEntries; // entries never move, the flags are atomic.
+                                // At most one entry per attribute is pending.
+    std::vector<Entry*> mLatest; // attribute index -> last registered entry (or nullptr)
+    std::atomic<size_t> mPendingCount {0};
+    std::mutex mMutex;
+
+    // Payloads the pending entries point into. Released with the last one.
+    std::vector<std::shared_ptr<const std::string>> mPayloads;
+};
+
 SceneObject::SceneObject(const SceneClass& sceneClass, const std::string& name) :
     mAttributeStorage(nullptr),
     mBindings(nullptr),
@@ -153,6 +326,8 @@ template <typename T>
 T
 SceneObject::get(AttributeKey<T> key, float t) const
 {
+    resolveLazyValue(key.mIndex);
+
     // If the attribute isn't blurrable, it's constant at all timesteps.
     if (!key.isBlurrable()) {
         return SceneClass::getValue(mAttributeStorage, key, TIMESTEP_BEGIN);
@@ -160,7 +335,7 @@ SceneObject::get(AttributeKey<T> key, float t) const
 
     // Rescale time according to the fast time rescaling coefficients. See
     // Types.h for more info.
-    TimeRescalingCoeffs coeffs = mSceneClass.mContext->mTimeRescalingCoeffs;
+    TimeRescalingCoeffs coeffs = mSceneClass.mContext->getTimeRescalingCoeffs();
     float tScaled = coeffs.mScale * t + coeffs.mOffset;
 
     return interpolate(
@@ -169,6 +344,206 @@ SceneObject::get(AttributeKey<T> key, float t) const
             tScaled);
 }
 
+template <typename T>
+void
+SceneObject::getInterpolated(AttributeKey<T> key,
+                             const SceneObject* const* objects, std::size_t objectCount,
+                             const float* times, std::size_t timeCount,
+                             T* results)
+{
+    // If the attribute isn't blurrable, it's constant at all timesteps.
+    if (!key.isBlurrable()) {
+        for (std::size_t i = 0; i < objectCount; ++i) {
+            const SceneObject* object = objects[i];
+            object->resolveLazyValue(key.mIndex);
+            std::fill(results + i * timeCount, results + (i + 1) * timeCount,
+                      SceneClass::getValue(object->mAttributeStorage, key, TIMESTEP_BEGIN));
+        }
+        return;
+    }
+
+    // Rescaled times only depend on the SceneContext, which all the objects
+    // normally share. See Types.h for more info.
+    std::vector<float> tScaled(timeCount);
+    const SceneContext* context = nullptr;
+
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        const SceneObject* object = objects[i];
+        if (object->mSceneClass.mContext != context) {
+            context = object->mSceneClass.mContext;
+            TimeRescalingCoeffs coeffs = context->getTimeRescalingCoeffs();
+            for (std::size_t j = 0; j < timeCount; ++j) {
+                tScaled[j] = coeffs.mScale * times[j] + coeffs.mOffset;
+            }
+        }
+
+        object->resolveLazyValue(key.mIndex);
+        BatchInterpolator<T> interpolator(
+                SceneClass::getValue(object->mAttributeStorage, key, TIMESTEP_BEGIN),
+                SceneClass::getValue(object->mAttributeStorage, key, TIMESTEP_END));
+        interpolator(tScaled.data(), timeCount, results + i * timeCount);
+    }
+}
+
+template <typename T, typename V>
+bool
+SceneObject::storeValue(AttributeKey<T> key, AttributeTimestep timestep, V&& value)
+{
+    if (unlikely(mSharedValues != nullptr)) {
+        std::shared_ptr<const void> shared = takeSharedValue(key.mIndex, timestep);
+        if (shared) {
+            // The storage of a shared value is empty, the new value replaces
+            // the shared buffer, which is left untouched.
+            const bool changed = !(*static_cast<const T*>(shared.get()) == static_cast<const T&>(value));
+            SceneClass::getValue(mAttributeStorage, key, timestep) = std::forward<V>(value);
+            return changed;
+        }
+    }
+    return SceneClass::setValue(mAttributeStorage, key, timestep, std::forward<V>(value));
+}
+
+std::shared_ptr<const void>
+SceneObject::takeSharedValue(uint32_t index, AttributeTimestep timestep)
+{
+    std::shared_ptr<const void> result;
+    std::vector<SharedValue>& sharedValues = *mSharedValues;
+    for (auto iter = sharedValues.begin(); iter != sharedValues.end(); ++iter) {
+        if (iter->mIndex == index && iter->mTimestep == timestep) {
+            result = std::move(iter->mValue);
+            sharedValues.erase(iter);
+            break;
+        }
+    }
+    if (sharedValues.empty()) {
+        mSharedValues.reset();
+    }
+    return result;
+}
+
+template <typename T>
+void
+SceneObject::shareValue(AttributeKey<std::vector<T>> key, const std::shared_ptr<const std::vector<T>>& value,
+                        AttributeTimestep timestep, bool& changed)
+{
+    if (!mSharedValues) mSharedValues.reset(new std::vector<SharedValue>);
+    for (SharedValue& shared : *mSharedValues) {
+        if (shared.mIndex == key.mIndex && shared.mTimestep == timestep) {
+            if (shared.mValue != value) {
+                changed |= !(*static_cast<const std::vector<T>*>(shared.mValue.get()) == *value);
+                shared.mValue = value;
+            }
+            return;
+        }
+    }
+
+    // Release the object's own copy, the shared buffer takes its place.
+    std::vector<T>& stored = SceneClass::getValue(mAttributeStorage, key, timestep);
+    changed |= !(stored == *value);
+    std::vector<T>().swap(stored);
+    mSharedValues->push_back(SharedValue {key.mIndex, timestep, value});
+}
+
+template <typename T>
+void
+SceneObject::setShared(AttributeKey<std::vector<T>> key, const std::shared_ptr<const std::vector<T>>& value)
+{
+    static_assert(!std::is_pointer<T>::value, "SceneObject vectors are type checked by set(), they can't be shared");
+
+    if (!mUpdateActive) {
+        std::stringstream errMsg;
+        errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
+            "' of SceneObject '" << mName << "' can only be set between"
+            " beginUpdate() and endUpdate() calls.";
+        throw except::RuntimeError(errMsg.str());
+    }
+    if (!value) {
+        std::stringstream errMsg;
+        errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
+            "' of SceneObject '" << mName << "' can't be set to a null shared buffer.";
+        throw except::ValueError(errMsg.str());
+    }
+
+    resolveLazyValue(key.mIndex);
+
+    int timestep = TIMESTEP_BEGIN;
+    bool changed = false;
+    do {
+        shareValue(key, value, static_cast<AttributeTimestep>(timestep), changed);
+        ++timestep;
+    } while (key.isBlurrable() && timestep < NUM_TIMESTEPS);
+
+    if (changed) {
+        mAttributeSetMask.set(key.mIndex, true);
+        mAttributeUpdateMask.set(key.mIndex, true);
+        mDirty = true;
+    }
+}
+
+template <typename T>
+void
+SceneObject::setShared(AttributeKey<std::vector<T>> key, const std::shared_ptr<const std::vector<T>>& value,
+                       AttributeTimestep timestep)
+{
+    static_assert(!std::is_pointer<T>::value, "SceneObject vectors are type checked by set(), they can't be shared");
+
+    // If the attribute isn't blurrable, it's constant at all timesteps.
+    if (!key.isBlurrable()) {
+        setShared(key, value);
+        return;
+    }
+
+    if (!mUpdateActive) {
+        std::stringstream errMsg;
+        errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
+            "' of SceneObject '" << mName << "' can only be set between"
+            " beginUpdate() and endUpdate() calls.";
+        throw except::RuntimeError(errMsg.str());
+    }
+    if (!value) {
+        std::stringstream errMsg;
+        errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
+            "' of SceneObject '" << mName << "' can't be set to a null shared buffer.";
+        throw except::ValueError(errMsg.str());
+    }
+
+    resolveLazyValue(key.mIndex);
+
+    bool changed = false;
+    shareValue(key, value, timestep, changed);
+    if (changed) {
+        mAttributeSetMask.set(key.mIndex, true);
+        mAttributeUpdateMask.set(key.mIndex, true);
+        mDirty = true;
+    }
+}
+
+template <typename T>
+std::shared_ptr<const std::vector<T>>
+SceneObject::makeShared(AttributeKey<std::vector<T>> key, AttributeTimestep timestep)
+{
+    static_assert(!std::is_pointer<T>::value, "SceneObject vectors are type checked by set(), they can't be shared");
+
+    // If the attribute isn't blurrable, it's constant at all timesteps.
+    if (!key.isBlurrable()) {
+        timestep = TIMESTEP_BEGIN;
+    }
+
+    resolveLazyValue(key.mIndex);
+    std::shared_ptr<const std::vector<T>> shared = getShared(key, timestep);
+    if (shared) {
+        return shared;
+    }
+
+    // The moved from storage is left empty, like the storage of a value set
+    // by setShared().
+    shared = std::make_shared<const std::vector<T>>(
+        std::move(SceneClass::getValue(mAttributeStorage, key, timestep)));
+    std::vector<T>().swap(SceneClass::getValue(mAttributeStorage, key, timestep));
+    if (!mSharedValues) mSharedValues.reset(new std::vector<SharedValue>);
+    mSharedValues->push_back(SharedValue {key.mIndex, timestep, shared});
+    return shared;
+}
+
 template <typename T>
 void
 SceneObject::set(AttributeKey<T> key, const T& value)
@@ -181,10 +556,13 @@ SceneObject::set(AttributeKey<T> key, const T& value)
         throw except::RuntimeError(errMsg.str());
     }
 
+    // Compare against the decoded value, like an eager read would.
+    resolveLazyValue(key.mIndex);
+
     int timestep = TIMESTEP_BEGIN;
     bool changed = false;
     do {
-        changed |= SceneClass::setValue(mAttributeStorage, key, static_cast<AttributeTimestep>(timestep), value);
+        changed |= storeValue(key, static_cast<AttributeTimestep>(timestep), value);
         ++timestep;
     } while (key.isBlurrable() && timestep < NUM_TIMESTEPS);
 
@@ -195,9 +573,16 @@ SceneObject::set(AttributeKey<T> key, const T& value)
     }
 }
 
-template <typename Container>
+template <typename T>
 void
-SceneObject::setSequenceContainer(AttributeKey<Container> key, const Container& value)
+SceneObject::set(AttributeKey<T> key, T&& value)
+{
+    moveValue(key, std::move(value));
+}
+
+template <typename T>
+void
+SceneObject::moveValue(AttributeKey<T> key, T&& value)
 {
     if (!mUpdateActive) {
         std::stringstream errMsg;
@@ -207,6 +592,28 @@ SceneObject::setSequenceContainer(AttributeKey<Container> key, const Container&
         throw except::RuntimeError(errMsg.str());
     }
 
+    resolveLazyValue(key.mIndex);
+
+    // Every timestep but the last one gets a copy, the last one takes over
+    // the value.
+    const int lastTimestep = key.isBlurrable() ? NUM_TIMESTEPS - 1 : TIMESTEP_BEGIN;
+    bool changed = false;
+    for (int timestep = TIMESTEP_BEGIN; timestep < lastTimestep; ++timestep) {
+        changed |= storeValue(key, static_cast<AttributeTimestep>(timestep), static_cast<const T&>(value));
+    }
+    changed |= storeValue(key, static_cast<AttributeTimestep>(lastTimestep), std::move(value));
+
+    if (changed) {
+        mAttributeSetMask.set(key.mIndex, true);
+        mAttributeUpdateMask.set(key.mIndex, true);
+        mDirty = true;
+    }
+}
+
+template <typename Container>
+void
+SceneObject::checkSequenceContainer(AttributeKey<Container> key, const Container& value) const
+{
     // Type check each value in the vector against the attribute's object type.
     for (typename Container::const_iterator iter = value.begin();
          iter != value.end(); ++iter) {
@@ -219,11 +626,26 @@ SceneObject::setSequenceContainer(AttributeKey<Container> key, const Container&
             throw except::TypeError(errMsg.str());
         }
     }
+}
+
+template <typename Container>
+void
+SceneObject::setSequenceContainer(AttributeKey<Container> key, const Container& value)
+{
+    if (!mUpdateActive) {
+        std::stringstream errMsg;
+        errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
+            "' of SceneObject '" << mName << "' can only be set between"
+            " beginUpdate() and endUpdate() calls.";
+        throw except::RuntimeError(errMsg.str());
+    }
+
+    checkSequenceContainer(key, value);
 
     int timestep = TIMESTEP_BEGIN;
     bool changed = false;
     do {
-        changed |= SceneClass::setValue(mAttributeStorage, key, static_cast<AttributeTimestep>(timestep), value);
+        changed |= storeValue(key, static_cast<AttributeTimestep>(timestep), value);
         ++timestep;
     } while (key.isBlurrable() && timestep < NUM_TIMESTEPS);
 
@@ -248,6 +670,28 @@ SceneObject::set(AttributeKey<SceneObjectIndexable> key, const SceneObjectIndexa
     setSequenceContainer(key, value);
 }
 
+template <typename Container>
+void
+SceneObject::setSequenceContainer(AttributeKey<Container> key, Container&& value)
+{
+    checkSequenceContainer(key, value);
+    moveValue(key, std::move(value));
+}
+
+template <>
+void
+SceneObject::set(AttributeKey<SceneObjectVector> key, SceneObjectVector&& value)
+{
+    setSequenceContainer(key, std::move(value));
+}
+
+template <>
+void
+SceneObject::set(AttributeKey<SceneObjectIndexable> key, SceneObjectIndexable&& value)
+{
+    setSequenceContainer(key, std::move(value));
+}
+
 void
 SceneObject::set(AttributeKey<SceneObject*> key, SceneObject* value)
 {
@@ -272,7 +716,7 @@ SceneObject::set(AttributeKey<SceneObject*> key, SceneObject* value)
     int timestep = TIMESTEP_BEGIN;
     bool changed = false;
     do {
-        changed |= SceneClass::setValue(mAttributeStorage, key, static_cast<AttributeTimestep>(timestep), value);
+        changed |= storeValue(key, static_cast<AttributeTimestep>(timestep), value);
         ++timestep;
     } while (key.isBlurrable() && timestep < NUM_TIMESTEPS);
 
@@ -300,7 +744,8 @@ SceneObject::set(AttributeKey<T> key, const T& value, AttributeTimestep timestep
         timestep = TIMESTEP_BEGIN;
     }
 
-    if (SceneClass::setValue(mAttributeStorage, key, timestep, value)) {
+    resolveLazyValue(key.mIndex);
+    if (storeValue(key, timestep, value)) {
         mAttributeSetMask.set(key.mIndex, true);
         mAttributeUpdateMask.set(key.mIndex, true);
         mDirty = true;
@@ -319,25 +764,15 @@ SceneObject::setSequenceContainer(AttributeKey<Container> key, const Container&
         throw except::RuntimeError(errMsg.str());
     }
 
-    // Type check each value in the vector against the attribute's object type.
-    for (typename Container::const_iterator iter = value.begin();
-         iter != value.end(); ++iter) {
-        if ((*iter) && !(*iter)->isA(key.mObjectType)) {
-            std::stringstream errMsg;
-            errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
-                "' only allows values of type '" << interfaceTypeName(key.mObjectType) <<
-                "', but an element in the vector, SceneObject '" << (*iter)->getName() <<
-                "' is type '" << interfaceTypeName((*iter)->getType()) << "'.";
-            throw except::TypeError(errMsg.str());
-        }
-    }
+    checkSequenceContainer(key, value);
 
     // If the attribute isn't blurrable, it's constant at all timesteps.
     if (!key.isBlurrable()) {
         timestep = TIMESTEP_BEGIN;
     }
 
-    if (SceneClass::setValue(mAttributeStorage, key, timestep, value)) {
+    resolveLazyValue(key.mIndex);
+    if (storeValue(key, timestep, value)) {
         mAttributeSetMask.set(key.mIndex, true);
         mAttributeUpdateMask.set(key.mIndex, true);
         mDirty = true;
@@ -358,6 +793,60 @@ SceneObject::set(AttributeKey<SceneObjectIndexable> key, const SceneObjectIndexa
     setSequenceContainer(key, value, timestep);
 }
 
+template <typename T>
+void
+SceneObject::set(AttributeKey<T> key, T&& value, AttributeTimestep timestep)
+{
+    moveValue(key, std::move(value), timestep);
+}
+
+template <typename T>
+void
+SceneObject::moveValue(AttributeKey<T> key, T&& value, AttributeTimestep timestep)
+{
+    if (!mUpdateActive) {
+        std::stringstream errMsg;
+        errMsg << "Attribute '" << mSceneClass.getAttribute(key)->getName() <<
+            "' of SceneObject '" << mName << "' can only be set between"
+            " beginUpdate() and endUpdate() calls.";
+        throw except::RuntimeError(errMsg.str());
+    }
+
+    // If the attribute isn't blurrable, it's constant at all timesteps.
+    if (!key.isBlurrable()) {
+        timestep = TIMESTEP_BEGIN;
+    }
+
+    resolveLazyValue(key.mIndex);
+    if (storeValue(key, timestep, std::move(value))) {
+        mAttributeSetMask.set(key.mIndex, true);
+        mAttributeUpdateMask.set(key.mIndex, true);
+        mDirty = true;
+    }
+}
+
+template <typename Container>
+void
+SceneObject::setSequenceContainer(AttributeKey<Container> key, Container&& value, AttributeTimestep timestep)
+{
+    checkSequenceContainer(key, value);
+    moveValue(key, std::move(value), timestep);
+}
+
+template <>
+void
+SceneObject::set(AttributeKey<SceneObjectVector> key, SceneObjectVector&& value, AttributeTimestep timestep)
+{
+    setSequenceContainer(key, std::move(value), timestep);
+}
+
+template <>
+void
+SceneObject::set(AttributeKey<SceneObjectIndexable> key, SceneObjectIndexable&& value, AttributeTimestep timestep)
+{
+    setSequenceContainer(key, std::move(value), timestep);
+}
+
 void
 SceneObject::set(AttributeKey<SceneObject*> key, SceneObject* value, AttributeTimestep timestep)
 {
@@ -384,7 +873,8 @@ SceneObject::set(AttributeKey<SceneObject*> key, SceneObject* value, AttributeTi
         timestep = TIMESTEP_BEGIN;
     }
 
-    if (SceneClass::setValue(mAttributeStorage, key, timestep, value)) {
+    resolveLazyValue(key.mIndex);
+    if (storeValue(key, timestep, value)) {
         mAttributeSetMask.set(key.mIndex, true);
         mAttributeUpdateMask.set(key.mIndex, true);
         mDirty = true;
@@ -548,6 +1038,137 @@ SceneObject::isDefaultAndUnbound(const Attribute& attr) const
     return isDefault(attr);
 }
 
+bool
+SceneObject::hasLazyValues() const
+{
+    return mLazyValues && mLazyValues->mPendingCount.load(std::memory_order_acquire) > 0;
+}
+
+void
+SceneObject::materializeLazyValues() const
+{
+    if (!mLazyValues) return;
+    for (const LazyValues::Entry& entry : mLazyValues->mEntries) {
+        materializeLazyValue(entry.mIndex);
+    }
+}
+
+void
+SceneObject::materializeLazyValue(uint32_t index) const
+{
+    LazyValues& lazyValues = *mLazyValues;
+    if (lazyValues.mPendingCount.load(std::memory_order_acquire) == 0) return;
+
+    if (index >= lazyValues.mLatest.size()) return;
+    LazyValues::Entry* const entryPtr = lazyValues.mLatest[index];
+    if (!entryPtr || !entryPtr->mPending.load(std::memory_order_acquire)) return;
+    LazyValues::Entry& entry = *entryPtr;
+
+    std::lock_guard<std::mutex> lock(lazyValues.mMutex);
+    if (!entry.mPending.load(std::memory_order_relaxed)) return; // decoded by another thread
+
+    // Lazy values are never blurrable vectors, decode straight into the
+    // storage without touching the set/update masks.
+    const Attribute& attr = *mSceneClass.mAttributes[index];
+    ValueContainerDeq valueDeq(entry.mValueDeq);
+    switch (attr.getType()) {
+    case TYPE_BOOL_VECTOR:
+        valueDeq.deqBoolVector(SceneClass::getValue(mAttributeStorage, AttributeKey<BoolVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_INT_VECTOR:
+        valueDeq.deqVLIntVector(SceneClass::getValue(mAttributeStorage, AttributeKey<IntVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_LONG_VECTOR:
+        valueDeq.deqVLLongVector(SceneClass::getValue(mAttributeStorage, AttributeKey<LongVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_FLOAT_VECTOR:
+        valueDeq.deqFloatVector(SceneClass::getValue(mAttributeStorage, AttributeKey<FloatVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_DOUBLE_VECTOR:
+        valueDeq.deqDoubleVector(SceneClass::getValue(mAttributeStorage, AttributeKey<DoubleVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_STRING_VECTOR:
+        valueDeq.deqStringVector(SceneClass::getValue(mAttributeStorage, AttributeKey<StringVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_RGB_VECTOR:
+        valueDeq.deqRgbVector(SceneClass::getValue(mAttributeStorage, AttributeKey<RgbVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_RGBA_VECTOR:
+        valueDeq.deqRgbaVector(SceneClass::getValue(mAttributeStorage, AttributeKey<RgbaVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_VEC2F_VECTOR:
+        valueDeq.deqVec2fVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Vec2fVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_VEC2D_VECTOR:
+        valueDeq.deqVec2dVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Vec2dVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_VEC3F_VECTOR:
+        valueDeq.deqVec3fVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Vec3fVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_VEC3D_VECTOR:
+        valueDeq.deqVec3dVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Vec3dVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_VEC4F_VECTOR:
+        valueDeq.deqVec4fVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Vec4fVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_VEC4D_VECTOR:
+        valueDeq.deqVec4dVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Vec4dVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_MAT4F_VECTOR:
+        valueDeq.deqMat4fVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Mat4fVector>(attr), TIMESTEP_BEGIN));
+        break;
+    case TYPE_MAT4D_VECTOR:
+        valueDeq.deqMat4dVector(SceneClass::getValue(mAttributeStorage, AttributeKey<Mat4dVector>(attr), TIMESTEP_BEGIN));
+        break;
+    default:
+        MNRY_ASSERT(0, "unexpected lazy attribute type");
+        break;
+    }
+
+    entry.mPending.store(false, std::memory_order_release);
+    if (lazyValues.mPendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        lazyValues.mPayloads.clear();
+    }
+}
+
+void
+SceneObject::addLazyValue(const Attribute& attribute, const ValueContainerDeq& valueDeq,
+                          const std::shared_ptr<const std::string>& payload)
+{
+    if (!mLazyValues) mLazyValues.reset(new LazyValues);
+    LazyValues& lazyValues = *mLazyValues;
+
+    if (lazyValues.mPayloads.empty() || lazyValues.mPayloads.back() != payload) {
+        lazyValues.mPayloads.push_back(payload);
+    }
+
+    // The object may be read again before the value was accessed, the new
+    // entry supersedes the pending one.
+    if (lazyValues.mLatest.size() <= attribute.mIndex) {
+        lazyValues.mLatest.resize(mSceneClass.mAttributes.size(), nullptr);
+    }
+    LazyValues::Entry*& latest = lazyValues.mLatest[attribute.mIndex];
+    if (latest && latest->mPending.exchange(false)) {
+        --lazyValues.mPendingCount;
+    }
+    lazyValues.mEntries.emplace_back(attribute.mIndex, valueDeq);
+    latest = &lazyValues.mEntries.back();
+    ++lazyValues.mPendingCount;
+
+    // The lazy value is decoded into the attribute storage, it replaces a
+    // shared value.
+    if (mSharedValues) {
+        for (int timestep = TIMESTEP_BEGIN; timestep < NUM_TIMESTEPS && mSharedValues; ++timestep) {
+            takeSharedValue(attribute.mIndex, static_cast<AttributeTimestep>(timestep));
+        }
+    }
+
+    // The same flags an eager set() of a changed value raises.
+    mAttributeSetMask.set(attribute.mIndex, true);
+    mAttributeUpdateMask.set(attribute.mIndex, true);
+    mDirty = true;
+}
+
 template <typename F>
 void
 SceneObject::setBinding(uint32_t index, bool bindable,
@@ -624,6 +1245,36 @@ template Vec4d SceneObject::get(AttributeKey<Vec4d>, float) const;
 template Mat4f SceneObject::get(AttributeKey<Mat4f>, float) const;
 template Mat4d SceneObject::get(AttributeKey<Mat4d>, float) const;
 
+// Explicit instantiations of the batch interpolated get().
+template void SceneObject::getInterpolated(AttributeKey<Int>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Int*);
+template void SceneObject::getInterpolated(AttributeKey<Long>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Long*);
+template void SceneObject::getInterpolated(AttributeKey<Float>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Float*);
+template void SceneObject::getInterpolated(AttributeKey<Double>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Double*);
+template void SceneObject::getInterpolated(AttributeKey<Rgb>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Rgb*);
+template void SceneObject::getInterpolated(AttributeKey<Rgba>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Rgba*);
+template void SceneObject::getInterpolated(AttributeKey<Vec2f>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Vec2f*);
+template void SceneObject::getInterpolated(AttributeKey<Vec2d>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Vec2d*);
+template void SceneObject::getInterpolated(AttributeKey<Vec3f>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Vec3f*);
+template void SceneObject::getInterpolated(AttributeKey<Vec3d>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Vec3d*);
+template void SceneObject::getInterpolated(AttributeKey<Vec4f>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Vec4f*);
+template void SceneObject::getInterpolated(AttributeKey<Vec4d>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Vec4d*);
+template void SceneObject::getInterpolated(AttributeKey<Mat4f>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Mat4f*);
+template void SceneObject::getInterpolated(AttributeKey<Mat4d>, const SceneObject* const*, std::size_t,
+                                           const float*, std::size_t, Mat4d*);
+
 // Explicit instantiations of set() and setBinding() for all attribute types.
 template void SceneObject::set(AttributeKey<Bool>, const Bool&);
 template void SceneObject::set(AttributeKey<Int>, const Int&);
@@ -693,6 +1344,74 @@ template void SceneObject::set(AttributeKey<Mat4fVector>, const Mat4fVector&, At
 template void SceneObject::set(AttributeKey<Mat4dVector>, const Mat4dVector&, AttributeTimestep);
 // SceneObjectVector specialized above.
 
+template void SceneObject::set(AttributeKey<Bool>, Bool&&);
+template void SceneObject::set(AttributeKey<Int>, Int&&);
+template void SceneObject::set(AttributeKey<Long>, Long&&);
+template void SceneObject::set(AttributeKey<Float>, Float&&);
+template void SceneObject::set(AttributeKey<Double>, Double&&);
+template void SceneObject::set(AttributeKey<String>, String&&);
+template void SceneObject::set(AttributeKey<Rgb>, Rgb&&);
+template void SceneObject::set(AttributeKey<Rgba>, Rgba&&);
+template void SceneObject::set(AttributeKey<Vec2f>, Vec2f&&);
+template void SceneObject::set(AttributeKey<Vec2d>, Vec2d&&);
+template void SceneObject::set(AttributeKey<Vec3f>, Vec3f&&);
+template void SceneObject::set(AttributeKey<Vec3d>, Vec3d&&);
+template void SceneObject::set(AttributeKey<Vec4f>, Vec4f&&);
+template void SceneObject::set(AttributeKey<Vec4d>, Vec4d&&);
+template void SceneObject::set(AttributeKey<Mat4f>, Mat4f&&);
+template void SceneObject::set(AttributeKey<Mat4d>, Mat4d&&);
+template void SceneObject::set(AttributeKey<BoolVector>, BoolVector&&);
+template void SceneObject::set(AttributeKey<IntVector>, IntVector&&);
+template void SceneObject::set(AttributeKey<LongVector>, LongVector&&);
+template void SceneObject::set(AttributeKey<FloatVector>, FloatVector&&);
+template void SceneObject::set(AttributeKey<DoubleVector>, DoubleVector&&);
+template void SceneObject::set(AttributeKey<StringVector>, StringVector&&);
+template void SceneObject::set(AttributeKey<RgbVector>, RgbVector&&);
+template void SceneObject::set(AttributeKey<RgbaVector>, RgbaVector&&);
+template void SceneObject::set(AttributeKey<Vec2fVector>, Vec2fVector&&);
+template void SceneObject::set(AttributeKey<Vec2dVector>, Vec2dVector&&);
+template void SceneObject::set(AttributeKey<Vec3fVector>, Vec3fVector&&);
+template void SceneObject::set(AttributeKey<Vec3dVector>, Vec3dVector&&);
+template void SceneObject::set(AttributeKey<Vec4fVector>, Vec4fVector&&);
+template void SceneObject::set(AttributeKey<Vec4dVector>, Vec4dVector&&);
+template void SceneObject::set(AttributeKey<Mat4fVector>, Mat4fVector&&);
+template void SceneObject::set(AttributeKey<Mat4dVector>, Mat4dVector&&);
+// SceneObjectVector specialized above.
+
+template void SceneObject::set(AttributeKey<Bool>, Bool&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Int>, Int&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Long>, Long&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Float>, Float&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Double>, Double&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<String>, String&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Rgb>, Rgb&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Rgba>, Rgba&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec2f>, Vec2f&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec2d>, Vec2d&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec3f>, Vec3f&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec3d>, Vec3d&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec4f>, Vec4f&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec4d>, Vec4d&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Mat4f>, Mat4f&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Mat4d>, Mat4d&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<BoolVector>, BoolVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<IntVector>, IntVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<LongVector>, LongVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<FloatVector>, FloatVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<DoubleVector>, DoubleVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<StringVector>, StringVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<RgbVector>, RgbVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<RgbaVector>, RgbaVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec2fVector>, Vec2fVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec2dVector>, Vec2dVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec3fVector>, Vec3fVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec3dVector>, Vec3dVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec4fVector>, Vec4fVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Vec4dVector>, Vec4dVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Mat4fVector>, Mat4fVector&&, AttributeTimestep);
+template void SceneObject::set(AttributeKey<Mat4dVector>, Mat4dVector&&, AttributeTimestep);
+// SceneObjectVector specialized above.
+
 template void SceneObject::set(const std::string&, const Bool&);
 template void SceneObject::set(const std::string&, const Int&);
 template void SceneObject::set(const std::string&, const Long&);
@@ -801,6 +1520,69 @@ template void SceneObject::setBinding(AttributeKey<Mat4dVector>, SceneObject* sc
 template void SceneObject::setBinding(AttributeKey<SceneObjectVector>, SceneObject* sceneObject);
 template void SceneObject::setBinding(AttributeKey<SceneObjectIndexable>, SceneObject* sceneObject);
 
+template void SceneObject::setShared(AttributeKey<IntVector>, const std::shared_ptr<const IntVector>&);
+template void SceneObject::setShared(AttributeKey<LongVector>, const std::shared_ptr<const LongVector>&);
+template void SceneObject::setShared(AttributeKey<FloatVector>, const std::shared_ptr<const FloatVector>&);
+template void SceneObject::setShared(AttributeKey<DoubleVector>, const std::shared_ptr<const DoubleVector>&);
+template void SceneObject::setShared(AttributeKey<StringVector>, const std::shared_ptr<const StringVector>&);
+template void SceneObject::setShared(AttributeKey<RgbVector>, const std::shared_ptr<const RgbVector>&);
+template void SceneObject::setShared(AttributeKey<RgbaVector>, const std::shared_ptr<const RgbaVector>&);
+template void SceneObject::setShared(AttributeKey<Vec2fVector>, const std::shared_ptr<const Vec2fVector>&);
+template void SceneObject::setShared(AttributeKey<Vec2dVector>, const std::shared_ptr<const Vec2dVector>&);
+template void SceneObject::setShared(AttributeKey<Vec3fVector>, const std::shared_ptr<const Vec3fVector>&);
+template void SceneObject::setShared(AttributeKey<Vec3dVector>, const std::shared_ptr<const Vec3dVector>&);
+template void SceneObject::setShared(AttributeKey<Vec4fVector>, const std::shared_ptr<const Vec4fVector>&);
+template void SceneObject::setShared(AttributeKey<Vec4dVector>, const std::shared_ptr<const Vec4dVector>&);
+template void SceneObject::setShared(AttributeKey<Mat4fVector>, const std::shared_ptr<const Mat4fVector>&);
+template void SceneObject::setShared(AttributeKey<Mat4dVector>, const std::shared_ptr<const Mat4dVector>&);
+
+template void SceneObject::setShared(AttributeKey<IntVector>, const std::shared_ptr<const IntVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<LongVector>, const std::shared_ptr<const LongVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<FloatVector>, const std::shared_ptr<const FloatVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<DoubleVector>, const std::shared_ptr<const DoubleVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<StringVector>, const std::shared_ptr<const StringVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<RgbVector>, const std::shared_ptr<const RgbVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<RgbaVector>, const std::shared_ptr<const RgbaVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Vec2fVector>, const std::shared_ptr<const Vec2fVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Vec2dVector>, const std::shared_ptr<const Vec2dVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Vec3fVector>, const std::shared_ptr<const Vec3fVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Vec3dVector>, const std::shared_ptr<const Vec3dVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Vec4fVector>, const std::shared_ptr<const Vec4fVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Vec4dVector>, const std::shared_ptr<const Vec4dVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Mat4fVector>, const std::shared_ptr<const Mat4fVector>&,
+                                      AttributeTimestep);
+template void SceneObject::setShared(AttributeKey<Mat4dVector>, const std::shared_ptr<const Mat4dVector>&,
+                                      AttributeTimestep);
+
+template std::shared_ptr<const IntVector> SceneObject::makeShared(AttributeKey<IntVector>, AttributeTimestep);
+template std::shared_ptr<const LongVector> SceneObject::makeShared(AttributeKey<LongVector>, AttributeTimestep);
+template std::shared_ptr<const FloatVector> SceneObject::makeShared(AttributeKey<FloatVector>, AttributeTimestep);
+template std::shared_ptr<const DoubleVector> SceneObject::makeShared(AttributeKey<DoubleVector>, AttributeTimestep);
+template std::shared_ptr<const StringVector> SceneObject::makeShared(AttributeKey<StringVector>, AttributeTimestep);
+template std::shared_ptr<const RgbVector> SceneObject::makeShared(AttributeKey<RgbVector>, AttributeTimestep);
+template std::shared_ptr<const RgbaVector> SceneObject::makeShared(AttributeKey<RgbaVector>, AttributeTimestep);
+template std::shared_ptr<const Vec2fVector> SceneObject::makeShared(AttributeKey<Vec2fVector>, AttributeTimestep);
+template std::shared_ptr<const Vec2dVector> SceneObject::makeShared(AttributeKey<Vec2dVector>, AttributeTimestep);
+template std::shared_ptr<const Vec3fVector> SceneObject::makeShared(AttributeKey<Vec3fVector>, AttributeTimestep);
+template std::shared_ptr<const Vec3dVector> SceneObject::makeShared(AttributeKey<Vec3dVector>, AttributeTimestep);
+template std::shared_ptr<const Vec4fVector> SceneObject::makeShared(AttributeKey<Vec4fVector>, AttributeTimestep);
+template std::shared_ptr<const Vec4dVector> SceneObject::makeShared(AttributeKey<Vec4dVector>, AttributeTimestep);
+template std::shared_ptr<const Mat4fVector> SceneObject::makeShared(AttributeKey<Mat4fVector>, AttributeTimestep);
+template std::shared_ptr<const Mat4dVector> SceneObject::makeShared(AttributeKey<Mat4dVector>, AttributeTimestep);
+
 template void SceneObject::resetToDefault(AttributeKey<Bool>);
 template void SceneObject::resetToDefault(AttributeKey<Int>);
 template void SceneObject::resetToDefault(AttributeKey<Long>);
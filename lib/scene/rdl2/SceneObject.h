@@ -42,6 +42,8 @@ using logging::Logger;
 
 namespace rdl2 {
 
+class ValueContainerDeq;
+
 // Forward declarations necessary for unit tests.
 namespace unittest {
     class TestSceneObject;
@@ -207,6 +209,32 @@ public:
     template <typename T>
     T get(AttributeKey<T> key, float t) const;
 
+    /**
+     * Batch version of the interpolated get(), which evaluates the same
+     * attribute on many objects at many times, e.g. node_xform of every
+     * instance at every shutter time. Results are stored object major:
+     *
+     *      results[i * timeCount + j] = objects[i]->get(key, times[j])
+     *
+     * The rescaled times are computed once per batch instead of once per
+     * get(), Float and Vec3f values are blended 8 times at once with AVX2,
+     * and Mat4f/Mat4d values are decomposed once per object instead of once
+     * per time. Results match get() up to floating point rounding.
+     *
+     * @param   key         An AttributeKey valid for all the objects.
+     * @param   objects     Array of objectCount objects.
+     * @param   objectCount Number of objects.
+     * @param   times       Array of timeCount parameterized times, as in
+     *                      get(key, t).
+     * @param   timeCount   Number of times.
+     * @param   results     Array of objectCount * timeCount values.
+     */
+    template <typename T>
+    static void getInterpolated(AttributeKey<T> key,
+                                const SceneObject* const* objects, std::size_t objectCount,
+                                const float* times, std::size_t timeCount,
+                                T* results);
+
     /**
      * Convenience attribute getters that behave like their AttributeKey
      * counterparts, but take an attribute name instead of an AttributeKey.
@@ -234,6 +262,19 @@ public:
     template <typename T>
     void set(AttributeKey<T> key, const T& value);
 
+    /**
+     * Move overload of set(). The value is moved into the attribute storage
+     * instead of copied, which avoids a full copy of large vector attributes
+     * (e.g. set(key, std::move(points))). If the attribute is blurrable, the
+     * begin timestep gets a copy and the end timestep takes over the value.
+     * The value is left in a valid but unspecified state.
+     *
+     * @param   key     An AttributeKey for the value you want to set.
+     * @param   value   The value you want to move into the attribute.
+     */
+    template <typename T>
+    void set(AttributeKey<T> key, T&& value);
+
     /**
      * An overload of the generic set() method specifically for SceneObject*s
      * which will check the value's object type against allowed object types
@@ -256,6 +297,17 @@ public:
     template <typename T>
     void set(AttributeKey<T> key, const T& value, AttributeTimestep timestep);
 
+    /**
+     * Move overload of the timestep set(). The value is moved into the
+     * attribute storage of the timestep instead of copied.
+     *
+     * @param   key         An AttributeKey for the value you want to set.
+     * @param   value       The value you want to move into the attribute.
+     * @param   timestep    The timestep you want to set the value at.
+     */
+    template <typename T>
+    void set(AttributeKey<T> key, T&& value, AttributeTimestep timestep);
+
     /**
      * An overload of the timestep set() method specifically for SceneObject*s,
      * which will check the value's object type against allowed object types
@@ -267,6 +319,54 @@ public:
      */
     void set(AttributeKey<SceneObject*> key, SceneObject* value, AttributeTimestep timestep);
 
+    /**
+     * Sets a vector attribute to an immutable buffer which is shared with
+     * other objects and timesteps instead of copied. get() returns the shared
+     * vector, and the object releases its own copy of the value. The next
+     * set() of the attribute replaces the shared buffer, internal mutable
+     * access copies it back into the object first (copy-on-write). If the
+     * attribute is blurrable, all timesteps share the buffer.
+     *
+     * Code which reads the attribute storage directly (e.g. ISPC shaders)
+     * doesn't see shared values, only share vectors which are read through
+     * get().
+     *
+     * @param   key     An AttributeKey for the vector you want to set.
+     * @param   value   The shared buffer, must not be null.
+     */
+    template <typename T>
+    void setShared(AttributeKey<std::vector<T>> key, const std::shared_ptr<const std::vector<T>>& value);
+
+    /**
+     * Timestep version of setShared(). If the attribute is not blurrable, the
+     * timestep is ignored.
+     */
+    template <typename T>
+    void setShared(AttributeKey<std::vector<T>> key, const std::shared_ptr<const std::vector<T>>& value,
+                   AttributeTimestep timestep);
+
+    /**
+     * Moves the value of a vector attribute into a shared buffer, without
+     * copying it, and returns the buffer. The value doesn't change, so the
+     * object isn't marked as changed. If the value is already shared, returns
+     * the existing buffer. The buffer stays valid after the attribute is set
+     * again and after the object is destroyed.
+     *
+     * Not thread safe with any other access to the attribute. If the
+     * attribute is not blurrable, the timestep is ignored.
+     */
+    template <typename T>
+    std::shared_ptr<const std::vector<T>> makeShared(AttributeKey<std::vector<T>> key,
+                                                     AttributeTimestep timestep = TIMESTEP_BEGIN);
+
+    /**
+     * Returns the buffer set by setShared() at the given timestep, or nullptr
+     * if the object owns the value.
+     */
+    template <typename T>
+    finline std::shared_ptr<const std::vector<T>> getShared(AttributeKey<std::vector<T>> key,
+                                                            AttributeTimestep timestep = TIMESTEP_BEGIN) const;
+
     /**
      * A template version of set that is called from sequence container
      * specializations.
@@ -275,6 +375,10 @@ public:
     void setSequenceContainer(AttributeKey<Container> key, const Container& value);
     template <typename Container>
     void setSequenceContainer(AttributeKey<Container> key, const Container& value, AttributeTimestep timestep);
+    template <typename Container>
+    void setSequenceContainer(AttributeKey<Container> key, Container&& value);
+    template <typename Container>
+    void setSequenceContainer(AttributeKey<Container> key, Container&& value, AttributeTimestep timestep);
 
     /**
      * Convenience attribute setters that behave like their AttributeKey
@@ -741,6 +845,20 @@ public:
      */
     finline void commitChanges();
 
+    /**
+     * Returns true if some attribute values of this object were read by a
+     * BinaryReader with lazy decoding (see BinaryReader::setLazyDecoding())
+     * and are not decoded yet.
+     */
+    bool hasLazyValues() const;
+
+    /**
+     * Decodes all the pending lazy attribute values. get() decodes a pending
+     * value on first access, but code which reads the attribute storage
+     * directly (e.g. ISPC shaders) has to call this first. Thread safe.
+     */
+    void materializeLazyValues() const;
+
     // The memory block where we store attribute values.
     void* mAttributeStorage;
 
@@ -958,6 +1076,61 @@ private:
     // type. Not exposed publicly because you really shouldn't need it.
     finline bool isA(SceneObjectInterface type) const;
 
+    // Type checks each element of a sequence container value against the
+    // attribute's object type. Throws except::TypeError on mismatch.
+    template <typename Container>
+    void checkSequenceContainer(AttributeKey<Container> key, const Container& value) const;
+
+    // Pending values of a lazy BinaryReader. Defined in SceneObject.cc.
+    struct LazyValues;
+
+    // Decodes the pending lazy value of the attribute (if any) before its
+    // storage is accessed. Only costs a pointer test for regular objects.
+    finline void resolveLazyValue(uint32_t index) const;
+    void materializeLazyValue(uint32_t index) const;
+
+    // Called by the BinaryReader to defer the decode of a vector value.
+    // valueDeq points at the encoded value inside payload, which is kept
+    // alive until the value is decoded.
+    void addLazyValue(const Attribute& attribute, const ValueContainerDeq& valueDeq,
+                      const std::shared_ptr<const std::string>& payload);
+
+    // Values set by setShared(). At most one entry per attribute and
+    // timestep, the attribute storage of a shared value is left empty.
+    struct SharedValue
+    {
+        uint32_t mIndex;
+        AttributeTimestep mTimestep;
+        std::shared_ptr<const void> mValue;
+    };
+
+    // Returns the shared value of the attribute at the timestep, or nullptr.
+    finline const void* findSharedValue(uint32_t index, AttributeTimestep timestep) const;
+
+    // Removes the shared value of the attribute at the timestep and returns it.
+    std::shared_ptr<const void> takeSharedValue(uint32_t index, AttributeTimestep timestep);
+
+    // Copies the shared values of the attribute back into the attribute
+    // storage, before the storage is modified in place.
+    template <typename T>
+    finline void unshareValue(AttributeKey<T> key);
+
+    // SceneClass::setValue() for the set() paths, which also replaces a
+    // shared value. Returns true if the value changed.
+    template <typename T, typename V>
+    bool storeValue(AttributeKey<T> key, AttributeTimestep timestep, V&& value);
+
+    template <typename T>
+    void shareValue(AttributeKey<std::vector<T>> key, const std::shared_ptr<const std::vector<T>>& value,
+                    AttributeTimestep timestep, bool& changed);
+
+    // Shared implementation of the move set() overloads. The sequence
+    // container specializations call it after their type check.
+    template <typename T>
+    void moveValue(AttributeKey<T> key, T&& value);
+    template <typename T>
+    void moveValue(AttributeKey<T> key, T&& value, AttributeTimestep timestep);
+
     /**
      * Retrieves a mutable reference to the attribute value for the corresponding
      * AttributeKey. Only useful for expensive attribute types, like matrices or
@@ -1047,6 +1220,14 @@ private:
     //  updated.  (E.g. a displacement assignment in a layer.)
     bool mUpdateRequested;
 
+    // Attribute values which are decoded on first access. Only allocated by
+    // a lazy BinaryReader.
+    std::unique_ptr<LazyValues> mLazyValues;
+
+    // Attribute values shared with other objects (see setShared()). Only
+    // allocated once a value is shared.
+    std::unique_ptr<std::vector<SharedValue>> mSharedValues;
+
     // Classes requiring access for serialization.
     friend class AsciiWriter;
     friend class BinaryWriter;
@@ -1095,6 +1276,12 @@ template <typename T>
 const T&
 SceneObject::get(AttributeKey<T> key) const
 {
+    resolveLazyValue(key.mIndex);
+    if (unlikely(mSharedValues != nullptr)) {
+        if (const void* shared = findSharedValue(key.mIndex, TIMESTEP_BEGIN)) {
+            return *static_cast<const T*>(shared);
+        }
+    }
     return SceneClass::getValue(mAttributeStorage, key, TIMESTEP_BEGIN);
 }
 
@@ -1107,6 +1294,12 @@ SceneObject::get(AttributeKey<T> key, AttributeTimestep timestep) const
         timestep = TIMESTEP_BEGIN;
     }
 
+    resolveLazyValue(key.mIndex);
+    if (unlikely(mSharedValues != nullptr)) {
+        if (const void* shared = findSharedValue(key.mIndex, timestep)) {
+            return *static_cast<const T*>(shared);
+        }
+    }
     return SceneClass::getValue(mAttributeStorage, key, timestep);
 }
 
@@ -1130,10 +1323,66 @@ SceneObject::isA(SceneObjectInterface type) const
     return mType & type;
 }
 
+void
+SceneObject::resolveLazyValue(uint32_t index) const
+{
+    if (unlikely(mLazyValues != nullptr)) {
+        materializeLazyValue(index);
+    }
+}
+
+const void*
+SceneObject::findSharedValue(uint32_t index, AttributeTimestep timestep) const
+{
+    for (const SharedValue& shared : *mSharedValues) {
+        if (shared.mIndex == index && shared.mTimestep == timestep) {
+            return shared.mValue.get();
+        }
+    }
+    return nullptr;
+}
+
+template <typename T>
+void
+SceneObject::unshareValue(AttributeKey<T> key)
+{
+    if (likely(mSharedValues == nullptr)) {
+        return;
+    }
+    for (int timestep = TIMESTEP_BEGIN; timestep < NUM_TIMESTEPS; ++timestep) {
+        std::shared_ptr<const void> shared =
+            takeSharedValue(key.mIndex, static_cast<AttributeTimestep>(timestep));
+        if (shared) {
+            SceneClass::getValue(mAttributeStorage, key, static_cast<AttributeTimestep>(timestep)) =
+                *static_cast<const T*>(shared.get());
+        }
+    }
+}
+
+template <typename T>
+std::shared_ptr<const std::vector<T>>
+SceneObject::getShared(AttributeKey<std::vector<T>> key, AttributeTimestep timestep) const
+{
+    // If the attribute isn't blurrable, it's constant at all timesteps.
+    if (!key.isBlurrable()) {
+        timestep = TIMESTEP_BEGIN;
+    }
+    if (mSharedValues) {
+        for (const SharedValue& shared : *mSharedValues) {
+            if (shared.mIndex == key.mIndex && shared.mTimestep == timestep) {
+                return std::static_pointer_cast<const std::vector<T>>(shared.mValue);
+            }
+        }
+    }
+    return nullptr;
+}
+
 template <typename T>
 T&
 SceneObject::getMutable(AttributeKey<T> key)
 {
+    resolveLazyValue(key.mIndex);
+    unshareValue(key);
     return SceneClass::getValue(mAttributeStorage, key, TIMESTEP_BEGIN);
 }
 
@@ -1146,6 +1395,8 @@ SceneObject::getMutable(AttributeKey<T> key, AttributeTimestep timestep)
         timestep = TIMESTEP_BEGIN;
     }
 
+    resolveLazyValue(key.mIndex);
+    unshareValue(key);
     return SceneClass::getValue(mAttributeStorage, key, timestep);
 }
 
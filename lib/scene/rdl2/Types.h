@@ -68,10 +68,12 @@ class Attribute;
 template <typename T> class AttributeKey;
 class BinaryReader;
 class BinaryWriter;
+class CachedClassDeclaration;
 class Camera;
 class Displacement;
 class DisplayFilter;
 class Dso;
+class DsoDeclarationCache;
 class EnvMap;
 class Geometry;
 class GeometrySet;
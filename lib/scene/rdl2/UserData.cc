@@ -5,6 +5,8 @@
 
 #include "UserData.h"
 
+#include <utility>
+
 namespace scene_rdl2 {
 namespace rdl2 {
 
@@ -161,6 +163,13 @@ UserData::setBoolData(const String& key, const BoolVector& values)
     set(sAttrBoolValues, values);
 }
 
+void
+UserData::setBoolData(const String& key, BoolVector&& values)
+{
+    set(sAttrBoolKey, key);
+    set(sAttrBoolValues, std::move(values));
+}
+
 const String&
 UserData::getBoolKey() const
 {
@@ -186,6 +195,13 @@ UserData::setIntData(const String& key, const IntVector& values)
     set(sAttrIntValues, values);
 }
 
+void
+UserData::setIntData(const String& key, IntVector&& values)
+{
+    set(sAttrIntKey, key);
+    set(sAttrIntValues, std::move(values));
+}
+
 const String&
 UserData::getIntKey() const
 {
@@ -231,6 +247,21 @@ UserData::setFloatData(const String& key, const FloatVector& values0, const Floa
     set(sAttrFloatValues1, values1);
 }
 
+void
+UserData::setFloatData(const String& key, FloatVector&& values)
+{
+    set(sAttrFloatKey, key);
+    set(sAttrFloatValues0, std::move(values));
+}
+
+void
+UserData::setFloatData(const String& key, FloatVector&& values0, FloatVector&& values1)
+{
+    set(sAttrFloatKey, key);
+    set(sAttrFloatValues0, std::move(values0));
+    set(sAttrFloatValues1, std::move(values1));
+}
+
 const String&
 UserData::getFloatKey() const
 {
@@ -268,6 +299,13 @@ UserData::setStringData(const String& key, const StringVector& values)
     set(sAttrStringValues, values);
 }
 
+void
+UserData::setStringData(const String& key, StringVector&& values)
+{
+    set(sAttrStringKey, key);
+    set(sAttrStringValues, std::move(values));
+}
+
 const String&
 UserData::getStringKey() const
 {
@@ -313,6 +351,21 @@ UserData::setColorData(const String& key, const RgbVector& values0, const RgbVec
     set(sAttrColorValues1, values1);
 }
 
+void
+UserData::setColorData(const String& key, RgbVector&& values)
+{
+    set(sAttrColorKey, key);
+    set(sAttrColorValues0, std::move(values));
+}
+
+void
+UserData::setColorData(const String& key, RgbVector&& values0, RgbVector&& values1)
+{
+    set(sAttrColorKey, key);
+    set(sAttrColorValues0, std::move(values0));
+    set(sAttrColorValues1, std::move(values1));
+}
+
 const String&
 UserData::getColorKey() const
 {
@@ -370,6 +423,21 @@ UserData::setVec2fData(const String& key, const Vec2fVector& values0, const Vec2
     set(sAttrVec2fValues1, values1);
 }
 
+void
+UserData::setVec2fData(const String& key, Vec2fVector&& values)
+{
+    set(sAttrVec2fKey, key);
+    set(sAttrVec2fValues0, std::move(values));
+}
+
+void
+UserData::setVec2fData(const String& key, Vec2fVector&& values0, Vec2fVector&& values1)
+{
+    set(sAttrVec2fKey, key);
+    set(sAttrVec2fValues0, std::move(values0));
+    set(sAttrVec2fValues1, std::move(values1));
+}
+
 
 const String&
 UserData::getVec2fKey() const
@@ -434,6 +502,21 @@ UserData::setVec3fData(const String& key, const Vec3fVector& values0, const Vec3
     set(sAttrVec3fValues1, values1);
 }
 
+void
+UserData::setVec3fData(const String& key, Vec3fVector&& values)
+{
+    set(sAttrVec3fKey, key);
+    set(sAttrVec3fValues0, std::move(values));
+}
+
+void
+UserData::setVec3fData(const String& key, Vec3fVector&& values0, Vec3fVector&& values1)
+{
+    set(sAttrVec3fKey, key);
+    set(sAttrVec3fValues0, std::move(values0));
+    set(sAttrVec3fValues1, std::move(values1));
+}
+
 const Vec3fVector&
 UserData::getVec3fValues() const
 {
@@ -485,6 +568,21 @@ UserData::setMat4fData(const String& key, const Mat4fVector& values0, const Mat4
     set(sAttrMat4fValues1, values1);
 }
 
+void
+UserData::setMat4fData(const String& key, Mat4fVector&& values)
+{
+    set(sAttrMat4fKey, key);
+    set(sAttrMat4fValues0, std::move(values));
+}
+
+void
+UserData::setMat4fData(const String& key, Mat4fVector&& values0, Mat4fVector&& values1)
+{
+    set(sAttrMat4fKey, key);
+    set(sAttrMat4fValues0, std::move(values0));
+    set(sAttrMat4fValues1, std::move(values1));
+}
+
 const String&
 UserData::getMat4fKey() const
 {
@@ -28,11 +28,13 @@ public:
 
     bool hasBoolData() const;
     void setBoolData(const String& key, const BoolVector& values);
+    void setBoolData(const String& key, BoolVector&& values);
     const String& getBoolKey() const;
     const BoolVector& getBoolValues() const;
 
     bool hasIntData() const;
     void setIntData(const String& key, const IntVector& values);
+    void setIntData(const String& key, IntVector&& values);
     const String& getIntKey() const;
     const IntVector& getIntValues() const;
 
@@ -41,6 +43,8 @@ public:
     bool hasFloatData1() const;
     void setFloatData(const String& key, const FloatVector& values);
     void setFloatData(const String& key, const FloatVector& values0, const FloatVector& values1);
+    void setFloatData(const String& key, FloatVector&& values);
+    void setFloatData(const String& key, FloatVector&& values0, FloatVector&& values1);
     const String& getFloatKey() const;
     const FloatVector& getFloatValues() const;
     const FloatVector& getFloatValues0() const;
@@ -48,6 +52,7 @@ public:
 
     bool hasStringData() const;
     void setStringData(const String& key, const StringVector& values);
+    void setStringData(const String& key, StringVector&& values);
     const String& getStringKey() const;
     const StringVector& getStringValues() const;
 
@@ -56,6 +61,8 @@ public:
     bool hasColorData1() const;
     void setColorData(const String& key, const RgbVector& values);
     void setColorData(const String& key, const RgbVector& values0, const RgbVector& values1);
+    void setColorData(const String& key, RgbVector&& values);
+    void setColorData(const String& key, RgbVector&& values0, RgbVector&& values1);
     const String& getColorKey() const;
     const RgbVector& getColorValues() const;
     const RgbVector& getColorValues0() const;
@@ -66,6 +73,8 @@ public:
     bool hasVec2fData1() const;
     void setVec2fData(const String& key, const Vec2fVector& values);
     void setVec2fData(const String& key, const Vec2fVector& values0, const Vec2fVector& values1);
+    void setVec2fData(const String& key, Vec2fVector&& values);
+    void setVec2fData(const String& key, Vec2fVector&& values0, Vec2fVector&& values1);
     const String& getVec2fKey() const;
     const Vec2fVector& getVec2fValues() const;
     const Vec2fVector& getVec2fValues0() const;
@@ -76,6 +85,8 @@ public:
     bool hasVec3fData1() const;
     void setVec3fData(const String& key, const Vec3fVector& values);
     void setVec3fData(const String& key, const Vec3fVector& values0, const Vec3fVector& values1);
+    void setVec3fData(const String& key, Vec3fVector&& values);
+    void setVec3fData(const String& key, Vec3fVector&& values0, Vec3fVector&& values1);
     const String& getVec3fKey() const;
     const Vec3fVector& getVec3fValues() const;
     const Vec3fVector& getVec3fValues0() const;
@@ -86,6 +97,8 @@ public:
     bool hasMat4fData1() const;
     void setMat4fData(const String& key, const Mat4fVector& values);
     void setMat4fData(const String& key, const Mat4fVector& values0, const Mat4fVector& values1);
+    void setMat4fData(const String& key, Mat4fVector&& values);
+    void setMat4fData(const String& key, Mat4fVector&& values0, Mat4fVector&& values1);
     const String& getMat4fKey() const;
     const Mat4fVector& getMat4fValues() const;
     const Mat4fVector& getMat4fValues0() const;
@@ -16,6 +16,8 @@
 #include <scene_rdl2/render/util/Files.h>
 #include <scene_rdl2/render/util/Strings.h>
 
+#include <tbb/parallel_invoke.h>
+
 #include <algorithm>
 #include <cctype>
 #include <set>
@@ -33,6 +35,12 @@ namespace rdl2 {
 
 void
 readSceneFromFile(const std::string& filePath, SceneContext& context)
+{
+    readSceneFromFile(filePath, context, false);
+}
+
+void
+readSceneFromFile(const std::string& filePath, SceneContext& context, bool parallel)
 {
     // Grab the file extension and convert it to lower case.
     auto ext = util::lowerCaseExtension(filePath);
@@ -47,6 +55,7 @@ readSceneFromFile(const std::string& filePath, SceneContext& context)
         reader.fromFile(filePath);
     } else if (ext == "rdlb") {
         BinaryReader reader(context);
+        reader.setParallelDecoding(parallel);
         reader.fromFile(filePath);
     } else {
         throw except::RuntimeError(util::buildString(
@@ -58,6 +67,13 @@ readSceneFromFile(const std::string& filePath, SceneContext& context)
 void
 writeSceneToFile(const SceneContext& context, const std::string& filePath,
                  bool deltaEncoding, bool skipDefaults, size_t elemsPerLine)
+{
+    writeSceneToFile(context, filePath, deltaEncoding, skipDefaults, elemsPerLine, false);
+}
+
+void
+writeSceneToFile(const SceneContext& context, const std::string& filePath,
+                 bool deltaEncoding, bool skipDefaults, size_t elemsPerLine, bool parallel)
 {
     // Grab the file extension and convert it to lower case.
     auto ext = util::lowerCaseExtension(filePath);
@@ -73,20 +89,33 @@ writeSceneToFile(const SceneContext& context, const std::string& filePath,
         writer.setTransientEncoding(false);
         writer.setDeltaEncoding(deltaEncoding);
         writer.setSkipDefaults(skipDefaults);
+        writer.setParallelEncoding(parallel);
         writer.toFile(filePath);
     } else if (ext.empty()) {
-        AsciiWriter awriter(context);
-        awriter.setSkipDefaults(skipDefaults);
-        awriter.setDeltaEncoding(deltaEncoding);
-        awriter.setElementsPerLine(elemsPerLine);
-        awriter.setMaxVectorSize(SPLIT_VEC_SIZE);
-        awriter.toFile(filePath + ".rdla");
-        BinaryWriter bwriter(context);
-        bwriter.setSkipDefaults(skipDefaults);
-        bwriter.setTransientEncoding(false);
-        bwriter.setDeltaEncoding(deltaEncoding);
-        bwriter.setSplitMode(SPLIT_VEC_SIZE + 1);
-        bwriter.toFile(filePath + ".rdlb");
+        auto writeAscii = [&]() {
+            AsciiWriter awriter(context);
+            awriter.setSkipDefaults(skipDefaults);
+            awriter.setDeltaEncoding(deltaEncoding);
+            awriter.setElementsPerLine(elemsPerLine);
+            awriter.setMaxVectorSize(SPLIT_VEC_SIZE);
+            awriter.toFile(filePath + ".rdla");
+        };
+        auto writeBinary = [&]() {
+            BinaryWriter bwriter(context);
+            bwriter.setSkipDefaults(skipDefaults);
+            bwriter.setTransientEncoding(false);
+            bwriter.setDeltaEncoding(deltaEncoding);
+            bwriter.setSplitMode(SPLIT_VEC_SIZE + 1);
+            bwriter.setParallelEncoding(parallel);
+            bwriter.toFile(filePath + ".rdlb");
+        };
+        if (parallel) {
+            // Both writers only read the context
+            tbb::parallel_invoke(writeAscii, writeBinary);
+        } else {
+            writeAscii();
+            writeBinary();
+        }
     } else {
         throw except::RuntimeError(util::buildString(
                 "File '", filePath, "' has an unknown extension."
@@ -23,6 +23,17 @@ namespace rdl2 {
 void
 readSceneFromFile(const std::string& filePath, SceneContext& context);
 
+/**
+ * Same as above, but .rdlb records are unpacked in parallel when parallel is
+ * set (see BinaryReader::setParallelDecoding()).
+ *
+ * @param   filePath    The path to the .rdla or .rdlb file.
+ * @param   context     The SceneContext to read into.
+ * @param   parallel    Enables parallel decoding of .rdlb files.
+ */
+void
+readSceneFromFile(const std::string& filePath, SceneContext& context, bool parallel);
+
 /**
  * Convenience function for easily dumping a SceneContext to a file, with the
  * type of writer inferred from the file extension.
@@ -73,6 +84,18 @@ void
 writeSceneToFile(const SceneContext& context, const std::string& filePath,
                  bool deltaEncoding, bool skipDefaults, size_t elemsPerLine);
 
+/**
+ * Same as above, but when parallel is set .rdlb data is encoded in parallel
+ * (see BinaryWriter::setParallelEncoding()) and, in split mode, the .rdla and
+ * .rdlb files are written concurrently. The output is identical to the serial
+ * version.
+ *
+ * @param   parallel         Enables parallel encoding.
+ */
+void
+writeSceneToFile(const SceneContext& context, const std::string& filePath,
+                 bool deltaEncoding, bool skipDefaults, size_t elemsPerLine, bool parallel);
+
 /**
  * Replace each '#' character found in the path string with the string
  * representation of sampleNum. The new, replaced string is returned.
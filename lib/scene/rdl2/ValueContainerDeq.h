@@ -115,6 +115,8 @@ public:
 
     // return current data pointer and move internal ptr by dataSize
     inline const void *skipByteData(const size_t dataSize);
+    // skip count variable length encoded values (i.e. deqVLInt() or deqVLLong() data)
+    inline void skipVLValues(const size_t count);
 
     // padding related API
     inline void deqAlignPad();
@@ -248,6 +250,12 @@ public:
     inline IntVector     deqVLIntVector()  { IntVector vec; deqVLIntVector(vec); return vec; }
     inline LongVector    deqVLLongVector() { LongVector vec; deqVLLongVector(vec); return vec; }
 
+    // stream VByte block coding internally, see ValueContainerUtil::streamVByteDecoding()
+    inline void deqStreamVByteIntVector(IntVector &vec);
+    inline void deqStreamVByteUIntVector(UIntVector &vec);
+    inline IntVector  deqStreamVByteIntVector()  { IntVector vec; deqStreamVByteIntVector(vec); return vec; }
+    inline UIntVector deqStreamVByteUIntVector() { UIntVector vec; deqStreamVByteUIntVector(vec); return vec; }
+
     // return rest of data size by byte
     inline size_t getRestSize() const { return mDataSize - ((uintptr_t)mCurrPtr - (uintptr_t)mAddr); }
     inline size_t getDataSize() const { return mDataSize; }
@@ -448,6 +456,16 @@ ValueContainerDeq::skipByteData(const size_t dataSize)
     return getDeqDataAddrUpdate(dataSize);
 }
 
+inline void
+ValueContainerDeq::skipVLValues(const size_t count)
+{
+    const char *in = static_cast<const char *>(mCurrPtr);
+    for (size_t i = 0; i < count; ++i) {
+        while (*in++ & 0x80) {}
+    }
+    updateCurrPtr(static_cast<size_t>(in - static_cast<const char *>(mCurrPtr)));
+}
+
 inline void
 ValueContainerDeq::deqAlignPad()
 {
@@ -604,6 +622,26 @@ ValueContainerDeq::deqVLLongVector(LongVector &vec)
     }
 }
 
+inline void
+ValueContainerDeq::deqStreamVByteIntVector(IntVector &vec)
+{
+    unsigned long size;
+    updateCurrPtr(ValueContainerUtil::variableLengthDecoding(mCurrPtr, size));
+    VALUE_CONTAINER_DEQ_DEBUG_MSG("deqStreamVByteIntVector() vec.size():>" << size << "<\n");
+    vec.resize(static_cast<size_t>(size));
+    updateCurrPtr(ValueContainerUtil::streamVByteDecoding(mCurrPtr, vec.size(), vec.data()));
+}
+
+inline void
+ValueContainerDeq::deqStreamVByteUIntVector(UIntVector &vec)
+{
+    unsigned long size;
+    updateCurrPtr(ValueContainerUtil::variableLengthDecoding(mCurrPtr, size));
+    VALUE_CONTAINER_DEQ_DEBUG_MSG("deqStreamVByteUIntVector() vec.size():>" << size << "<\n");
+    vec.resize(static_cast<size_t>(size));
+    updateCurrPtr(ValueContainerUtil::streamVByteDecoding(mCurrPtr, vec.size(), vec.data()));
+}
+
 inline bool    
 ValueContainerDeq::isSameEncodedData(const ValueContainerDeq &src) const
 {
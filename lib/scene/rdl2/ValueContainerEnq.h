@@ -5,8 +5,11 @@
 //
 #pragma once
 
+#include "ValueContainerSink.h"
 #include "ValueContainerUtil.h"
 
+#include <algorithm>
+
 // This is a directive for debug message dump. Use this directive, all enqueue operations
 // are displayed to std::cout
 //#define VALUE_CONTAINER_ENQ_DEBUG_MSG_ON
@@ -44,12 +47,32 @@ public:
     explicit ValueContainerEnq(std::string *bytes) :
         mStartId(bytes->size()),
         mId(mStartId),
-        mBuff(bytes)
+        mBuff(bytes),
+        mSink(nullptr),
+        mSinkStartOffset(0),
+        mFlushedSize(0)
     {
         // dummy entire data size of enqueue. finalize() fills this field
         saveSizeT(getEnqDataAddrUpdate(sizeof(size_t)), 0x0);
     }
 
+    // Streams the encoded data to the sink instead of keeping it in one contiguous buffer.
+    // Data is encoded into the sink's staging buffer and appended to the sink each time the
+    // staging buffer is full. Data is appended after whatever the sink already holds.
+    // Addresses returned by enqReserveMem() and getCurrAddr() are only valid until the next
+    // enqueue, the same as with a std::string which might be reallocated.
+    explicit ValueContainerEnq(ValueContainerSink *sink) :
+        mStartId(0),
+        mId(0),
+        mBuff(sink->getStagingBuff()),
+        mSink(sink),
+        mSinkStartOffset(sink->size()),
+        mFlushedSize(0)
+    {
+        mBuff->clear();
+        saveSizeT(getEnqDataAddrUpdate(sizeof(size_t)), 0x0);
+    }
+
     // These are shallow copies and this is intentional.
     // Purpose of ValueContainerEnq is dequeueing data from original data memory and
     // we don't want to copy original data memory when we do copy/move
@@ -151,6 +174,7 @@ public:
     inline void enqSceneObjectIndexable(const SceneObjectIndexable &vec);
 
     inline void enqAttributeType(AttributeType rdlType);
+    inline void enqValueType(ValueContainerUtil::ValueType valType);
 
     //------------------------------
     //
@@ -164,6 +188,10 @@ public:
     inline void enqVLIntVector(const IntVector &vec);   // all variable length encoding internally
     inline void enqVLLongVector(const LongVector &vec); // all variable length encoding internally
 
+    // stream VByte block coding internally, see ValueContainerUtil::streamVByteEncoding()
+    inline void enqStreamVByteIntVector(const IntVector &vec);
+    inline void enqStreamVByteUIntVector(const UIntVector &vec);
+
     //------------------------------
 
     inline void * enqReserveMem(const size_t size) { return getEnqDataAddrUpdate(size); }
@@ -173,7 +201,8 @@ public:
 
     inline size_t finalize();          // return total data size
 
-    inline size_t currentSize() const { return mId - mStartId; } // return current data size
+    // return current data size
+    inline size_t currentSize() const { return mFlushedSize + mId - mStartId; }
 
     static inline void memoryCopy(void *dest, const void *src, const size_t n)
     {
@@ -211,7 +240,10 @@ private:
 
     void *getEnqDataAddr(size_t len)
     {
-        if (capacity() < len) expandBuff(len);
+        if (capacity() < len) {
+            if (mSink) flushToSink(len);
+            if (capacity() < len) expandBuff(len);
+        }
         return reinterpret_cast<void *>((uintptr_t)(mBuff->data()) + (uintptr_t)mId);
     }
 
@@ -227,15 +259,36 @@ private:
         size_t expandSizeOrg = requestAddSize - capacity() + mBuff->size();
         size_t expandSize = expandSizeOrg / stepIncreaseSize * stepIncreaseSize;
         if (expandSize < expandSizeOrg) expandSize += stepIncreaseSize;
+        if (expandSize > mBuff->capacity()) {
+            // Reserve geometrically, so that encoding N bytes only reallocates and copies
+            // O(log N) times. resize() below stays in 1KByte steps, which only zero-fills
+            // the part of the reserved memory that is about to be written.
+            mBuff->reserve(std::max(expandSize, mBuff->capacity() * 2));
+        }
         mBuff->resize(expandSize);
     }
 
+    void flushToSink(size_t requestAddSize)
+    {
+        // The top 8 bytes keep the total data size, which finalize() patches through the sink.
+        if (mId > mStartId) mSink->append(mBuff->data() + mStartId, mId - mStartId);
+        mFlushedSize += mId - mStartId;
+        mStartId = 0;
+        mId = 0;
+        mBuff->resize(std::min(std::max(requestAddSize, mSink->getStagingSize()),
+                               mBuff->capacity()));
+    }
+
     size_t capacity() const { return mBuff->size() - mId; } // current available size
 
     size_t mStartId;            // initial start position of mBuff
     size_t mId;                 // current data enqueue position of mBuff
     std::string *mBuff;
 
+    ValueContainerSink *mSink;  // nullptr unless streaming to a sink
+    size_t mSinkStartOffset;    // position of this data in the sink
+    size_t mFlushedSize;        // data size already appended to the sink
+
 #ifdef VALUE_CONTAINER_ENQ_DEBUG_MSG_ON
     std::string showEnqCounterResult() const;
 
@@ -526,6 +579,16 @@ ValueContainerEnq::enqAttributeType(AttributeType rdlType)
     VALUE_CONTAINER_ENQ_COUNTER(rdlType);
 }
 
+inline void
+ValueContainerEnq::enqValueType(ValueContainerUtil::ValueType valType)
+{
+    void *ptr = getEnqDataAddr(ValueContainerUtil::variableLengthIntMaxSize);
+    mId += ValueContainerUtil::variableLengthEncoding(static_cast<unsigned int>(valType), ptr);
+    VALUE_CONTAINER_ENQ_DEBUG_MSG("enqValueType() valType:>"
+                                  << ValueContainerUtil::valueType2Str(valType) << " ");
+    VALUE_CONTAINER_ENQ_COUNTER(valType);
+}
+
 inline void
 ValueContainerEnq::enqVLInt(const int i)
 {
@@ -601,10 +664,52 @@ ValueContainerEnq::enqVLLongVector(const LongVector &vec)
     VALUE_CONTAINER_ENQ_COUNTER(vec);
 }
 
+inline void
+ValueContainerEnq::enqStreamVByteIntVector(const IntVector &vec)
+{
+    void *ptr =
+        getEnqDataAddr(ValueContainerUtil::variableLengthLongMaxSize +
+                       ValueContainerUtil::streamVByteMaxSize(vec.size()));
+    ptr =
+        updatePtr
+        (ptr, ValueContainerUtil::variableLengthEncoding(static_cast<unsigned long>(vec.size()), ptr));
+    ptr = updatePtr(ptr, ValueContainerUtil::streamVByteEncoding(vec.data(), vec.size(), ptr));
+    VALUE_CONTAINER_ENQ_DEBUG_MSG("enqStreamVByteIntVector() vec.size():>" << vec.size() << "<\n");
+    updateId(ptr);
+    VALUE_CONTAINER_ENQ_COUNTER(vec);
+}
+
+inline void
+ValueContainerEnq::enqStreamVByteUIntVector(const UIntVector &vec)
+{
+    void *ptr =
+        getEnqDataAddr(ValueContainerUtil::variableLengthLongMaxSize +
+                       ValueContainerUtil::streamVByteMaxSize(vec.size()));
+    ptr =
+        updatePtr
+        (ptr, ValueContainerUtil::variableLengthEncoding(static_cast<unsigned long>(vec.size()), ptr));
+    ptr = updatePtr(ptr, ValueContainerUtil::streamVByteEncoding(vec.data(), vec.size(), ptr));
+    VALUE_CONTAINER_ENQ_DEBUG_MSG("enqStreamVByteUIntVector() vec.size():>" << vec.size() << "<\n");
+    updateId(ptr);
+    VALUE_CONTAINER_ENQ_COUNTER(vec);
+}
+
 inline size_t
 ValueContainerEnq::finalize()
 {
     size_t size = currentSize();
+    if (mSink) {
+        if (mId > mStartId) mSink->append(mBuff->data() + mStartId, mId - mStartId);
+        mFlushedSize += mId - mStartId;
+        mStartId = 0;
+        mId = 0;
+        mBuff->clear();
+        char sizeBuff[sizeof(size_t)];
+        saveSizeT(sizeBuff, size);
+        mSink->overwrite(mSinkStartOffset, sizeBuff, sizeof(size_t)); // save total dataSize
+        VALUE_CONTAINER_ENQ_DEBUG_MSG("finalize() " << showEnqCounterResult() << '\n');
+        return size;
+    }
     saveSizeT((void *)((uintptr_t)mBuff->data() + (uintptr_t)mStartId), size); // save total dataSize
     // debugDump("", "finalize()");
     mBuff->resize(mId);         // resize to current mId but not change reserved capacity
@@ -0,0 +1,173 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "ValueContainerSink.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/render/util/Strings.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+
+void
+ValueContainerChunkSink::append(const void *data, size_t size)
+{
+    const char *src = static_cast<const char *>(data);
+    while (size) {
+        const size_t chunkId = mSize / mChunkSize;
+        const size_t chunkOffset = mSize % mChunkSize;
+        if (chunkId == mChunks.size()) {
+            // new char[] instead of std::make_unique<char[]>(), which would zero-fill the chunk
+            mChunks.emplace_back(new char[mChunkSize]);
+        }
+        const size_t copySize = std::min(size, mChunkSize - chunkOffset);
+        std::memcpy(mChunks[chunkId].get() + chunkOffset, src, copySize);
+        src += copySize;
+        size -= copySize;
+        mSize += copySize;
+    }
+}
+
+void
+ValueContainerChunkSink::overwrite(size_t offset, const void *data, size_t size)
+{
+    const char *src = static_cast<const char *>(data);
+    while (size) {
+        const size_t chunkId = offset / mChunkSize;
+        const size_t chunkOffset = offset % mChunkSize;
+        const size_t copySize = std::min(size, mChunkSize - chunkOffset);
+        std::memcpy(mChunks[chunkId].get() + chunkOffset, src, copySize);
+        src += copySize;
+        size -= copySize;
+        offset += copySize;
+    }
+}
+
+void
+ValueContainerChunkSink::crawl(size_t offset, size_t size,
+                               const std::function<void(const char *data, size_t size)> &func) const
+{
+    while (size) {
+        const size_t chunkId = offset / mChunkSize;
+        const size_t chunkOffset = offset % mChunkSize;
+        const size_t crawlSize = std::min(size, mChunkSize - chunkOffset);
+        func(mChunks[chunkId].get() + chunkOffset, crawlSize);
+        size -= crawlSize;
+        offset += crawlSize;
+    }
+}
+
+void
+ValueContainerChunkSink::crawlAllChunks(const std::function<void(const char *data, size_t size)> &func) const
+{
+    crawl(0, mSize, func);
+}
+
+void
+ValueContainerChunkSink::copyTo(std::string &out) const
+{
+    out.clear();
+    out.reserve(mSize);
+    crawlAllChunks([&](const char *data, size_t size) { out.append(data, size); });
+}
+
+//------------------------------------------------------------------------------
+
+ValueContainerFileSink::ValueContainerFileSink(const std::string &filename, size_t stagingSize) :
+    ValueContainerSink(stagingSize),
+    mFilename(filename),
+    mFd(-1),
+    mSize(0)
+{
+    // read access for crawl()
+    mFd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (mFd < 0) {
+        throw except::IoError(util::buildString("Failed to open \"", filename,
+                                                "\" for writing: ", std::strerror(errno)));
+    }
+}
+
+ValueContainerFileSink::~ValueContainerFileSink()
+{
+    if (mFd >= 0) ::close(mFd);
+}
+
+void
+ValueContainerFileSink::append(const void *data, size_t size)
+{
+    const char *src = static_cast<const char *>(data);
+    while (size) {
+        const ssize_t written = ::write(mFd, src, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw except::IoError(util::buildString("Failed to write \"", mFilename,
+                                                    "\": ", std::strerror(errno)));
+        }
+        src += written;
+        size -= static_cast<size_t>(written);
+        mSize += static_cast<size_t>(written);
+    }
+}
+
+void
+ValueContainerFileSink::overwrite(size_t offset, const void *data, size_t size)
+{
+    const char *src = static_cast<const char *>(data);
+    while (size) {
+        const ssize_t written = ::pwrite(mFd, src, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw except::IoError(util::buildString("Failed to write \"", mFilename,
+                                                    "\": ", std::strerror(errno)));
+        }
+        src += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+}
+
+void
+ValueContainerFileSink::crawl(size_t offset, size_t size,
+                              const std::function<void(const char *data, size_t size)> &func) const
+{
+    constexpr size_t readSize = 64 * 1024;
+    std::vector<char> buff(std::min(size, readSize));
+    while (size) {
+        const ssize_t got = ::pread(mFd, buff.data(), std::min(size, buff.size()), static_cast<off_t>(offset));
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR) continue;
+            throw except::IoError(util::buildString("Failed to read \"", mFilename, "\": ",
+                                                    (got < 0) ? std::strerror(errno) : "unexpected EOF"));
+        }
+        func(buff.data(), static_cast<size_t>(got));
+        size -= static_cast<size_t>(got);
+        offset += static_cast<size_t>(got);
+    }
+}
+
+void
+ValueContainerFileSink::close()
+{
+    if (mFd < 0) return;
+    const int fd = mFd;
+    mFd = -1;
+    if (::close(fd) != 0) {
+        throw except::IoError(util::buildString("Failed to close \"", mFilename,
+                                                "\": ", std::strerror(errno)));
+    }
+}
+
+} // namespace rdl2
+} // namespace scene_rdl2
+
@@ -0,0 +1,117 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+
+class ValueContainerSink
+//
+// Destination of a ValueContainerEnq which does not need the whole encoded data in one
+// contiguous buffer.
+// ValueContainerEnq encodes into a fixed size staging buffer owned by the sink and hands
+// it to append() each time it is full. finalize() patches the total data size at the top
+// of the data by overwrite(), so a sink has to keep the appended data addressable.
+//
+{
+public:
+    explicit ValueContainerSink(size_t stagingSize = 1024 * 1024)
+    {
+        mStaging.reserve(stagingSize);
+    }
+    virtual ~ValueContainerSink() = default;
+
+    ValueContainerSink(const ValueContainerSink &) = delete;
+    ValueContainerSink &operator = (const ValueContainerSink &) = delete;
+
+    virtual void append(const void *data, size_t size) = 0;
+    virtual void overwrite(size_t offset, const void *data, size_t size) = 0; // already appended data
+    virtual size_t size() const = 0; // total appended data size
+
+    // Reads back already appended data [offset, offset + size) and calls func(data, size)
+    // for each contiguous piece in order. Used to hash the encoded data (i.e. PackTiles SHA1).
+    virtual void crawl(size_t offset, size_t size,
+                       const std::function<void(const char *data, size_t size)> &func) const = 0;
+
+    std::string *getStagingBuff() { return &mStaging; }
+    size_t getStagingSize() const { return mStaging.capacity(); }
+
+protected:
+    std::string mStaging;
+};
+
+class ValueContainerChunkSink : public ValueContainerSink
+//
+// Keeps the encoded data as a chain of fixed size chunks. Chunks are not zero-filled and
+// are kept by clear() for the next encode, so a sink reused for every frame stops
+// allocating once it has reached the size of the largest frame.
+//
+{
+public:
+    explicit ValueContainerChunkSink(size_t chunkSize = 4 * 1024 * 1024) :
+        ValueContainerSink(chunkSize),
+        mChunkSize(chunkSize),
+        mSize(0)
+    {}
+
+    void append(const void *data, size_t size) override;
+    void overwrite(size_t offset, const void *data, size_t size) override;
+    size_t size() const override { return mSize; }
+    void crawl(size_t offset, size_t size,
+               const std::function<void(const char *data, size_t size)> &func) const override;
+
+    void clear() { mSize = 0; } // keeps allocated chunks
+
+    size_t getChunkSize() const { return mChunkSize; }
+    size_t getChunkTotal() const { return (mSize + mChunkSize - 1) / mChunkSize; } // used chunks
+    size_t getAllocatedChunkTotal() const { return mChunks.size(); }
+
+    // calls func(data, size) for each used chunk in order
+    void crawlAllChunks(const std::function<void(const char *data, size_t size)> &func) const;
+
+    void copyTo(std::string &out) const; // out is replaced by the whole data
+
+private:
+    const size_t mChunkSize;
+    size_t mSize;
+    std::vector<std::unique_ptr<char[]>> mChunks;
+};
+
+class ValueContainerFileSink : public ValueContainerSink
+//
+// Writes the encoded data to a file as it is produced.
+//
+{
+public:
+    // Creates or truncates the file. throw except::IoError if the file can't be opened.
+    explicit ValueContainerFileSink(const std::string &filename,
+                                    size_t stagingSize = 4 * 1024 * 1024);
+    ~ValueContainerFileSink() override;
+
+    // throw except::IoError when write failed
+    void append(const void *data, size_t size) override;
+    void overwrite(size_t offset, const void *data, size_t size) override;
+    size_t size() const override { return mSize; }
+    // throw except::IoError when read failed
+    void crawl(size_t offset, size_t size,
+               const std::function<void(const char *data, size_t size)> &func) const override;
+
+    void close(); // throw except::IoError when close failed
+
+private:
+    const std::string mFilename;
+    int mFd;
+    size_t mSize;
+};
+
+} // namespace rdl2
+} // namespace scene_rdl2
+
@@ -9,9 +9,140 @@
 #include <iomanip>
 #include <sstream>
 
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
 namespace scene_rdl2 {
 namespace rdl2 {
 
+namespace {
+
+//
+// Lookup tables of the stream VByte decoder, indexed by control byte.
+// mLength is the total data bytes of the 4 values and mShuffle is the byte shuffle
+// which expands them into 4 little endian 32bit values.
+//
+struct StreamVByteTables
+{
+    StreamVByteTables()
+    {
+        for (int ctrl = 0; ctrl < 256; ++ctrl) {
+            uint8_t offset = 0;
+            for (int i = 0; i < 4; ++i) {
+                const uint8_t len = static_cast<uint8_t>(((ctrl >> (i * 2)) & 0x3) + 1);
+                for (uint8_t b = 0; b < 4; ++b) {
+                    mShuffle[ctrl][i * 4 + b] = (b < len) ? static_cast<uint8_t>(offset + b) : 0x80;
+                }
+                offset += len;
+            }
+            mLength[ctrl] = offset;
+        }
+    }
+
+    alignas(16) uint8_t mShuffle[256][16];
+    uint8_t mLength[256];
+};
+
+const StreamVByteTables sStreamVByteTables;
+
+inline uint32_t
+zigZagEncode32(const int32_t i)
+{
+    return (static_cast<uint32_t>(i) << 1) ^ static_cast<uint32_t>(i >> 31);
+}
+
+inline uint32_t
+zigZagDecode32(const uint32_t ui)
+{
+    return (ui >> 1) ^ (0u - (ui & 1u));
+}
+
+template <bool zigZag, typename T>
+size_t
+streamVByteEncodingMain(const T *in, const size_t n, void *outPtr)
+{
+    uint8_t *out = static_cast<uint8_t *>(outPtr);
+    uint8_t *ctrl = out;
+    uint8_t *data = out + (n + 3) / 4;
+    for (size_t i = 0; i < n; i += 4) {
+        const size_t groupSize = (n - i < 4) ? n - i : 4;
+        uint8_t ctrlByte = 0x0;
+        for (size_t j = 0; j < groupSize; ++j) {
+            const uint32_t v =
+                zigZag ? zigZagEncode32(static_cast<int32_t>(in[i + j])) : static_cast<uint32_t>(in[i + j]);
+            const uint32_t code = (v > 0xff) + (v > 0xffff) + (v > 0xffffff);
+            // Always store 4 bytes (little endian), and only advance by the used bytes.
+            // This stays inside streamVByteMaxSize().
+            std::memcpy(data, &v, sizeof(uint32_t));
+            data += code + 1;
+            ctrlByte |= static_cast<uint8_t>(code << (j * 2));
+        }
+        *ctrl++ = ctrlByte;
+    }
+    return static_cast<size_t>(data - out);
+}
+
+template <bool zigZag>
+size_t
+streamVByteDecodingMain(const void *inPtr, const size_t n, uint32_t *out)
+{
+    const StreamVByteTables &tbl = sStreamVByteTables;
+    const uint8_t *in = static_cast<const uint8_t *>(inPtr);
+    const uint8_t *ctrl = in;
+    const uint8_t *data = in + (n + 3) / 4;
+
+    // A 16 byte load from the data of a group stays inside the encoded data as long as 3 more
+    // full groups follow it, since each group is at least 4 bytes. The rest is decoded by the
+    // scalar loop.
+    const size_t groupTotal = n / 4;
+    size_t group = 0;
+#if defined(__AVX2__)
+    for (; group + 5 <= groupTotal; group += 2) {
+        const uint8_t c0 = ctrl[group];
+        const uint8_t c1 = ctrl[group + 1];
+        const uint8_t len0 = tbl.mLength[c0];
+        __m256i v =
+            _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)data)),
+                                    _mm_loadu_si128((const __m128i *)(data + len0)), 1);
+        const __m256i shuffle =
+            _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_load_si128((const __m128i *)tbl.mShuffle[c0])),
+                                    _mm_load_si128((const __m128i *)tbl.mShuffle[c1]), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        if (zigZag) {
+            const __m256i sign = _mm256_sub_epi32(_mm256_setzero_si256(),
+                                                  _mm256_and_si256(v, _mm256_set1_epi32(1)));
+            v = _mm256_xor_si256(_mm256_srli_epi32(v, 1), sign);
+        }
+        _mm256_storeu_si256((__m256i *)(out + group * 4), v);
+        data += len0 + tbl.mLength[c1];
+    }
+#endif // end __AVX2__
+#if defined(__SSSE3__)
+    for (; group + 4 <= groupTotal; ++group) {
+        const uint8_t c = ctrl[group];
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data),
+                                     _mm_load_si128((const __m128i *)tbl.mShuffle[c]));
+        if (zigZag) {
+            const __m128i sign = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi32(1)));
+            v = _mm_xor_si128(_mm_srli_epi32(v, 1), sign);
+        }
+        _mm_storeu_si128((__m128i *)(out + group * 4), v);
+        data += tbl.mLength[c];
+    }
+#endif // end __SSSE3__
+    for (size_t i = group * 4; i < n; ++i) {
+        const uint32_t len = ((ctrl[i / 4] >> ((i % 4) * 2)) & 0x3) + 1;
+        uint32_t v = 0x0;
+        std::memcpy(&v, data, len); // little endian
+        data += len;
+        out[i] = zigZag ? zigZagDecode32(v) : v;
+    }
+    return static_cast<size_t>(data - in);
+}
+
+} // namespace
+
 // static function
 std::string
 ValueContainerUtil::valueType2Str(ValueType valueType)
@@ -55,6 +186,7 @@ ValueContainerUtil::valueType2Str(ValueType valueType)
     case ValueType::SCENE_OBJECT :           return std::string("SCENE_OBJECT");
     case ValueType::SCENE_OBJECT_VECTOR :    return std::string("SCENE_OBJECT_VECTOR");
     case ValueType::SCENE_OBJECT_INDEXABLE : return std::string("SCENE_OBJECT_INDEXABLE");
+    case ValueType::INT_VECTOR_STREAM_VBYTE : return std::string("INT_VECTOR_STREAM_VBYTE");
     default :                                return std::string("UNKNOWN");
     }
 }
@@ -136,6 +268,34 @@ ValueContainerUtil::hexDump(const std::string &hd, const std::string &titleMsg,
     return ostr.str();
 }
 
+// static function
+size_t
+ValueContainerUtil::streamVByteEncoding(const unsigned int *in, const size_t n, void *out)
+{
+    return streamVByteEncodingMain<false>(in, n, out);
+}
+
+// static function
+size_t
+ValueContainerUtil::streamVByteDecoding(const void *in, const size_t n, unsigned int *out)
+{
+    return streamVByteDecodingMain<false>(in, n, reinterpret_cast<uint32_t *>(out));
+}
+
+// static function
+size_t
+ValueContainerUtil::streamVByteEncoding(const int *in, const size_t n, void *out)
+{
+    return streamVByteEncodingMain<true>(in, n, out);
+}
+
+// static function
+size_t
+ValueContainerUtil::streamVByteDecoding(const void *in, const size_t n, int *out)
+{
+    return streamVByteDecodingMain<true>(in, n, reinterpret_cast<uint32_t *>(out));
+}
+
 } // namespace rdl2
 } // namespace scene_rdl2
 
@@ -49,7 +49,8 @@ public:
         MAT4D_VECTOR,
         SCENE_OBJECT,
         SCENE_OBJECT_VECTOR,
-        SCENE_OBJECT_INDEXABLE
+        SCENE_OBJECT_INDEXABLE,
+        INT_VECTOR_STREAM_VBYTE // IntVector by streamVByteEncoding(), see BinaryWriter::setStreamVByteEncoding()
     };
 
     static std::string valueType2Str(ValueType valueType); // for debug
@@ -82,6 +83,17 @@ public:
     static inline size_t variableLengthDecoding(const void *in, long &l);
     static inline size_t variableLengthEncodingSize(long l); // return encoded data size only
 
+    // Stream VByte block coding for 32bit integer arrays : n values are stored as (n+3)/4 control
+    // bytes (2bit byte length - 1 for each value) followed by the 1 ~ 4 data bytes of each value.
+    // Unlike variableLengthEncoding(), data bytes don't depend on each other and the decoder
+    // expands 4 or 8 values at a time by byte shuffle. Signed values use zig-zag coding.
+    static constexpr size_t streamVByteMaxSize(const size_t n) { return (n + 3) / 4 + n * 4; }
+
+    static size_t streamVByteEncoding(const unsigned int *in, const size_t n, void *out); // return encoded size
+    static size_t streamVByteDecoding(const void *in, const size_t n, unsigned int *out); // return encoded size
+    static size_t streamVByteEncoding(const int *in, const size_t n, void *out); // return encoded size
+    static size_t streamVByteDecoding(const void *in, const size_t n, int *out); // return encoded size
+
     static inline size_t alignedSize(const size_t byte, const size_t align);
     static inline bool isAlignedSize(const size_t byte, const size_t align);
 
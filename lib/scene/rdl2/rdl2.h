@@ -87,6 +87,7 @@
  */
 
 #include "AsciiReader.h"
+#include "AsciiSubsetExtractor.h"
 #include "AsciiWriter.h"
 #include "Attribute.h"
 #include "AttributeKey.h"
@@ -97,6 +98,7 @@
 #include "Displacement.h"
 #include "DisplayFilter.h"
 #include "Dso.h"
+#include "DsoDeclarationCache.h"
 #include "DsoFinder.h"
 #include "EnvMap.h"
 #include "Geometry.h"
@@ -22,6 +22,7 @@ BOOST_PYTHON_MODULE(__scene_rdl2__)
 
     registerRdl2AttrTypes();
     registerRdl2AttrVectorTypes();
+    registerRdl2VectorBufferPyBinding();
     registerRdl2MiscTypes();
 
     registerAttributePyBinding();
@@ -60,6 +60,7 @@ namespace py_scene_rdl2
 
     void registerRdl2AttrTypes();
     void registerRdl2AttrVectorTypes();
+    void registerRdl2VectorBufferPyBinding();
     void registerRdl2MiscTypes();
 
     void registerAttributePyBinding();
@@ -0,0 +1,611 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+#include "boost_python.h"
+#include "py_scene_rdl2.h"
+#include "py_scene_rdl2_helpers.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// scene_rdl2
+#include <scene_rdl2/scene/rdl2/rdl2.h>
+using namespace scene_rdl2;
+
+namespace py_scene_rdl2
+{
+    //------------------------------------
+    // Buffer layout of the attribute vector element types
+    //------------------------------------
+
+    // Vectors and colors: (n, components)
+    template <typename T>
+    struct BufferTraits
+    {
+        using Scalar = typename T::Scalar;
+        static constexpr int sInnerNDim = 1;
+        static constexpr Py_ssize_t sInnerShape[2] = { getElementCount<T>(), 0 };
+    };
+
+    // Primitives: (n)
+    template <typename S>
+    struct PrimitiveBufferTraits
+    {
+        using Scalar = S;
+        static constexpr int sInnerNDim = 0;
+        static constexpr Py_ssize_t sInnerShape[2] = { 0, 0 };
+    };
+
+    template <> struct BufferTraits<rdl2::Int> : PrimitiveBufferTraits<rdl2::Int> {};
+    template <> struct BufferTraits<rdl2::Long> : PrimitiveBufferTraits<rdl2::Long> {};
+    template <> struct BufferTraits<rdl2::Float> : PrimitiveBufferTraits<rdl2::Float> {};
+    template <> struct BufferTraits<rdl2::Double> : PrimitiveBufferTraits<rdl2::Double> {};
+
+    // Matrices: (n, 4, 4), row major
+    template <typename M>
+    struct MatrixBufferTraits
+    {
+        using Scalar = typename M::Scalar;
+        static constexpr int sInnerNDim = 2;
+        static constexpr Py_ssize_t sInnerShape[2] = { 4, 4 };
+    };
+
+    template <> struct BufferTraits<rdl2::Mat4f> : MatrixBufferTraits<rdl2::Mat4f> {};
+    template <> struct BufferTraits<rdl2::Mat4d> : MatrixBufferTraits<rdl2::Mat4d> {};
+
+    template <typename T>
+    constexpr std::size_t
+    getBufferComponentCount()
+    {
+        return (BufferTraits<T>::sInnerNDim == 0) ? 1 :
+               (BufferTraits<T>::sInnerNDim == 1) ? BufferTraits<T>::sInnerShape[0] :
+               BufferTraits<T>::sInnerShape[0] * BufferTraits<T>::sInnerShape[1];
+    }
+
+    // struct module format character of a scalar type.
+    template <typename S>
+    constexpr const char*
+    getBufferFormat()
+    {
+        return std::is_same<S, float>::value   ? "f" :
+               std::is_same<S, double>::value  ? "d" :
+               std::is_same<S, int32_t>::value ? "i" : "q";
+    }
+
+    // NumPy __array_interface__ type string of a scalar type.
+    template <typename S>
+    std::string
+    getArrayInterfaceTypestr()
+    {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        std::string typestr("<");
+#else
+        std::string typestr(">");
+#endif
+        typestr += std::is_floating_point<S>::value ? 'f' : 'i';
+        typestr += std::to_string(sizeof(S));
+        return typestr;
+    }
+
+    //------------------------------------
+    // VectorAttributeView
+    //------------------------------------
+
+    // Read-only view of a vector attribute value. The view holds the shared
+    // buffer of the attribute (see SceneObject::makeShared()), so it doesn't
+    // copy the value, and the view (and every NumPy array or memoryview made
+    // from it, which keep a reference to the view) stays valid after the
+    // attribute is set again or the SceneContext is destroyed. Exposes the
+    // buffer protocol (Python 3) and the NumPy array interface, so
+    // numpy.asarray(view) and memoryview(view) don't copy anything either.
+    class VectorAttributeView
+    {
+    public:
+        VectorAttributeView() = default;
+
+        template <typename T>
+        static VectorAttributeView
+        create(std::shared_ptr<const std::vector<T>> storage, const std::string& typeName)
+        {
+            using Traits = BufferTraits<T>;
+            using Scalar = typename Traits::Scalar;
+            static_assert(sizeof(T) == getBufferComponentCount<T>() * sizeof(Scalar),
+                          "VectorAttributeView requires tightly packed element types.");
+
+            // Empty vectors may not have any storage, point at something valid.
+            static const T sEmpty { };
+
+            VectorAttributeView view;
+            view.mData = storage->empty() ? static_cast<const void*>(&sEmpty) : storage->data();
+            view.mSize = storage->size();
+            view.mStorage = std::move(storage);
+            view.mItemSize = sizeof(Scalar);
+            view.mFormat = getBufferFormat<Scalar>();
+            view.mTypestr = getArrayInterfaceTypestr<Scalar>();
+            view.mTypeName = typeName;
+            view.mNDim = 1 + Traits::sInnerNDim;
+            view.mShape[0] = static_cast<Py_ssize_t>(view.mSize);
+            for (int i = 0; i < Traits::sInnerNDim; ++i) {
+                view.mShape[i + 1] = Traits::sInnerShape[i];
+            }
+            Py_ssize_t stride = view.mItemSize;
+            for (int i = view.mNDim - 1; i >= 0; --i) {
+                view.mStrides[i] = stride;
+                stride *= view.mShape[i];
+            }
+            return view;
+        }
+
+        std::size_t len() const { return static_cast<std::size_t>(mShape[0]); }
+
+        Py_ssize_t
+        byteSize() const
+        {
+            Py_ssize_t size = mItemSize;
+            for (int i = 0; i < mNDim; ++i) {
+                size *= mShape[i];
+            }
+            return size;
+        }
+
+        bp::tuple
+        shape() const
+        {
+            bp::list result;
+            for (int i = 0; i < mNDim; ++i) {
+                result.append(mShape[i]);
+            }
+            return bp::tuple(result);
+        }
+
+        bp::dict
+        arrayInterface() const
+        {
+            bp::dict result;
+            result["version"] = 3;
+            result["shape"] = shape();
+            result["typestr"] = mTypestr;
+            result["data"] = bp::make_tuple(reinterpret_cast<std::uintptr_t>(mData), true);
+            return result;
+        }
+
+        bp::list
+        toList() const
+        {
+            bp::object self(*this);
+            return bp::list(bp::object(bp::handle<>(
+                PyMemoryView_FromObject(self.ptr()))).attr("tolist")());
+        }
+
+        std::string
+        repr() const
+        {
+            std::ostringstream oss;
+            oss << "<" << "scene_rdl2.VectorAttributeView of " << mTypeName
+                << " shape=(";
+            for (int i = 0; i < mNDim; ++i) {
+                oss << mShape[i] << ((i + 1 < mNDim || mNDim == 1) ? "," : "");
+            }
+            oss << ") at " << mData << ">";
+            return oss.str();
+        }
+
+        int
+        getBuffer(PyObject* exporter, Py_buffer* view, int flags)
+        {
+            if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+                PyErr_SetString(PyExc_BufferError,
+                                "VectorAttributeView is read-only, use SceneObject.set() to modify "
+                                "the attribute.");
+                view->obj = nullptr;
+                return -1;
+            }
+
+            view->obj = exporter;
+            Py_INCREF(exporter);
+            view->buf = const_cast<void*>(mData);
+            view->len = byteSize();
+            view->readonly = 1;
+            view->itemsize = mItemSize;
+            view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(mFormat) : nullptr;
+            view->ndim = mNDim;
+            view->shape = ((flags & PyBUF_ND) == PyBUF_ND) ? mShape : nullptr;
+            view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? mStrides : nullptr;
+            view->suboffsets = nullptr;
+            view->internal = nullptr;
+            return 0;
+        }
+
+    private:
+        std::shared_ptr<const void> mStorage; // shared with the SceneObject and the copies boost::python makes
+        const void* mData = nullptr;
+        std::size_t mSize = 0;
+        Py_ssize_t mItemSize = 0;
+        const char* mFormat = nullptr;
+        std::string mTypestr;
+        std::string mTypeName;
+        int mNDim = 1;
+        Py_ssize_t mShape[3] = { 0, 0, 0 };
+        Py_ssize_t mStrides[3] = { 0, 0, 0 };
+    };
+
+#ifdef IS_PY3
+    int
+    VectorAttributeView_getbuffer(PyObject* exporter, Py_buffer* view, int flags)
+    {
+        bp::extract<VectorAttributeView&> self(exporter);
+        if (!self.check()) {
+            PyErr_SetString(PyExc_BufferError, "Object is not a VectorAttributeView.");
+            view->obj = nullptr;
+            return -1;
+        }
+        return self().getBuffer(exporter, view, flags);
+    }
+
+    PyBufferProcs VectorAttributeView_bufferProcs = { &VectorAttributeView_getbuffer, nullptr };
+#endif
+
+    //------------------------------------
+    // Get
+    //------------------------------------
+
+    template <typename T>
+    bp::object
+    internal_getVectorAttrBuffer(scene_rdl2::rdl2::SceneObject& sceneObject,
+                                 const scene_rdl2::rdl2::SceneClass& sc,
+                                 const std::string& attrName,
+                                 const std::string& typeName)
+    {
+        const scene_rdl2::rdl2::AttributeKey<std::vector<T>> attrKey =
+                sc.getAttributeKey<std::vector<T>>(attrName);
+        std::shared_ptr<const std::vector<T>> storage;
+        {
+            // makeShared() moves the value into a shared buffer the first
+            // time, which changes the object, but not the value.
+            ScopedSceneContextIO io(sc.getSceneContext(), ScopedSceneContextIO::Access::WRITE);
+            storage = sceneObject.makeShared(attrKey);
+        }
+        return bp::object(VectorAttributeView::create(std::move(storage), typeName));
+    }
+
+    bool
+    isBufferAttributeType(scene_rdl2::rdl2::AttributeType attrType)
+    {
+        switch (attrType) {
+        case scene_rdl2::rdl2::AttributeType::TYPE_INT_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_LONG_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_FLOAT_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_DOUBLE_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_RGB_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_RGBA_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC2F_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC2D_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC3F_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC3D_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC4F_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC4D_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_MAT4F_VECTOR:
+        case scene_rdl2::rdl2::AttributeType::TYPE_MAT4D_VECTOR:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bp::object
+    getAttributeBufferByName(scene_rdl2::rdl2::SceneObject& sceneObject, const std::string& attrName)
+    {
+        const scene_rdl2::rdl2::SceneClass& sc = sceneObject.getSceneClass();
+        const scene_rdl2::rdl2::Attribute* attr = sc.getAttribute(attrName);
+        const std::string typeName = getAttrTypeName(attr);
+
+        switch (attr->getType()) {
+        case scene_rdl2::rdl2::AttributeType::TYPE_INT_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Int>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_LONG_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Long>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_FLOAT_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Float>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_DOUBLE_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Double>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_RGB_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Rgb>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_RGBA_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Rgba>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC2F_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Vec2f>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC2D_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Vec2d>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC3F_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Vec3f>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC3D_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Vec3d>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC4F_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Vec4f>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC4D_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Vec4d>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_MAT4F_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Mat4f>(sceneObject, sc, attrName, typeName);
+        case scene_rdl2::rdl2::AttributeType::TYPE_MAT4D_VECTOR:
+            return internal_getVectorAttrBuffer<scene_rdl2::rdl2::Mat4d>(sceneObject, sc, attrName, typeName);
+        default:
+            throw std::runtime_error("in getAttributeBufferByName, attribute '" + attrName +
+                    "' of type " + typeName + " has no buffer representation.");
+        }
+    }
+
+    //------------------------------------
+    // Set
+    //------------------------------------
+
+    // Releases a Py_buffer on scope exit.
+    class ScopedPyBuffer
+    {
+    public:
+        ScopedPyBuffer(PyObject* obj, int flags)
+        {
+            if (PyObject_GetBuffer(obj, &mView, flags) != 0) {
+                bp::throw_error_already_set();
+            }
+        }
+
+        ~ScopedPyBuffer() { PyBuffer_Release(&mView); }
+
+        ScopedPyBuffer(const ScopedPyBuffer&) = delete;
+        ScopedPyBuffer& operator=(const ScopedPyBuffer&) = delete;
+
+        const Py_buffer& get() const { return mView; }
+
+    private:
+        Py_buffer mView;
+    };
+
+    // True if the integer value fits into the Dst type.
+    template <typename Dst, typename Src>
+    bool
+    isInRange(Src value)
+    {
+        if constexpr (std::is_floating_point<Dst>::value || std::is_floating_point<Src>::value) {
+            return true;
+        } else if constexpr (std::is_signed<Src>::value) {
+            if (value < 0) {
+                return std::is_signed<Dst>::value &&
+                       static_cast<intmax_t>(value) >= static_cast<intmax_t>(std::numeric_limits<Dst>::min());
+            }
+        }
+        return static_cast<uintmax_t>(value) <= static_cast<uintmax_t>(std::numeric_limits<Dst>::max());
+    }
+
+    // Throws std::overflow_error (OverflowError in Python) for integer values
+    // which don't fit into Dst.
+    template <typename Src, typename Dst>
+    void
+    convertScalars(const void* src, Dst* dst, std::size_t count)
+    {
+        if (std::is_same<Src, Dst>::value) {
+            std::memcpy(dst, src, count * sizeof(Dst));
+            return;
+        }
+        const Src* s = static_cast<const Src*>(src);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!isInRange<Dst>(s[i])) {
+                throw std::overflow_error("value " + std::to_string(s[i]) + " at index " +
+                        std::to_string(i) + " is out of the range of the attribute type");
+            }
+            dst[i] = static_cast<Dst>(s[i]);
+        }
+    }
+
+    // Copies count scalars described by a struct module format into dst.
+    // Integer sources can go to any destination if the values fit, floating
+    // point sources only to floating point destinations (no silent
+    // truncation).
+    // Returns false if the format is not supported.
+    template <typename Dst>
+    bool
+    copyBufferScalars(const void* src, const char* format, Py_ssize_t itemSize,
+                      Dst* dst, std::size_t count)
+    {
+        // Native or explicit little endian byte order only.
+        const char* fmt = (format != nullptr) ? format : "B";
+        if (*fmt == '@' || *fmt == '=' ||
+            (*fmt == '<' && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) {
+            ++fmt;
+        }
+        if (fmt[0] == '\0' || fmt[1] != '\0') {
+            return false;
+        }
+
+        switch (fmt[0]) {
+        case 'f':
+            if (!std::is_floating_point<Dst>::value || itemSize != sizeof(float)) return false;
+            convertScalars<float>(src, dst, count);
+            return true;
+        case 'd':
+            if (!std::is_floating_point<Dst>::value || itemSize != sizeof(double)) return false;
+            convertScalars<double>(src, dst, count);
+            return true;
+        case 'b': case 'h': case 'i': case 'l': case 'q':
+            switch (itemSize) {
+            case 1: convertScalars<int8_t>(src, dst, count); return true;
+            case 2: convertScalars<int16_t>(src, dst, count); return true;
+            case 4: convertScalars<int32_t>(src, dst, count); return true;
+            case 8: convertScalars<int64_t>(src, dst, count); return true;
+            default: return false;
+            }
+        case 'B': case 'H': case 'I': case 'L': case 'Q': case '?':
+            switch (itemSize) {
+            case 1: convertScalars<uint8_t>(src, dst, count); return true;
+            case 2: convertScalars<uint16_t>(src, dst, count); return true;
+            case 4: convertScalars<uint32_t>(src, dst, count); return true;
+            case 8: convertScalars<uint64_t>(src, dst, count); return true;
+            default: return false;
+            }
+        default:
+            return false;
+        }
+    }
+
+    template <typename T>
+    void
+    internal_setVectorAttrFromBuffer(scene_rdl2::rdl2::SceneObject& sceneObject,
+                                     const scene_rdl2::rdl2::SceneClass& sc,
+                                     const std::string& attrName,
+                                     bp::object& pyValue)
+    {
+        using Scalar = typename BufferTraits<T>::Scalar;
+        constexpr std::size_t components = getBufferComponentCount<T>();
+        static_assert(sizeof(T) == components * sizeof(Scalar),
+                      "internal_setVectorAttrFromBuffer<T> requires tightly packed element types.");
+
+        scene_rdl2::rdl2::AttributeKey<std::vector<T>> attrKey =
+                sc.getAttributeKey<std::vector<T>>(attrName);
+
+        ScopedPyBuffer buffer(pyValue.ptr(), PyBUF_C_CONTIGUOUS | PyBUF_FORMAT);
+        const Py_buffer& view = buffer.get();
+
+        const std::size_t scalarCount = static_cast<std::size_t>(view.len / view.itemsize);
+        if (scalarCount % components != 0) {
+            throw std::runtime_error("in setAttributeValueFromBuffer, buffer of " +
+                    std::to_string(scalarCount) + " values can't be split into elements of " +
+                    std::to_string(components) + " values for attribute '" + attrName + "'.");
+        }
+
+        std::vector<T> value(scalarCount / components);
+        bool converted = false;
+        try {
+            // The copy doesn't touch any Python object, the buffer stays
+            // valid until it is released.
+            ScopedGILRelease noGil;
+            converted = copyBufferScalars(view.buf, view.format, view.itemsize,
+                                          reinterpret_cast<Scalar*>(value.data()), scalarCount);
+        } catch (const std::overflow_error& e) {
+            throw std::overflow_error(std::string("in setAttributeValueFromBuffer, ") + e.what() +
+                    " for attribute '" + attrName + "'.");
+        }
+        if (!converted) {
+            throw std::runtime_error(std::string("in setAttributeValueFromBuffer, unsupported buffer "
+                    "format '") + (view.format ? view.format : "B") + "' for attribute '" +
+                    attrName + "'.");
+        }
+
+        // Set the value (setAttributeValueLocked() adds the UpdateGuard)
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
+    }
+
+    void
+    setAttributeValueFromBuffer(scene_rdl2::rdl2::SceneObject& sceneObject,
+                                const std::string& attrName,
+                                bp::object& pyValue)
+    {
+        const scene_rdl2::rdl2::SceneClass& sc = sceneObject.getSceneClass();
+        const scene_rdl2::rdl2::Attribute* attr = sc.getAttribute(attrName);
+
+        if (!PyObject_CheckBuffer(pyValue.ptr())) {
+            throw std::runtime_error("in setAttributeValueFromBuffer, Python object passed in "
+                    "doesn't support the buffer protocol.");
+        }
+
+        switch (attr->getType()) {
+        case scene_rdl2::rdl2::AttributeType::TYPE_INT_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Int>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_LONG_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Long>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_FLOAT_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Float>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_DOUBLE_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Double>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_RGB_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Rgb>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_RGBA_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Rgba>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC2F_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Vec2f>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC2D_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Vec2d>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC3F_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Vec3f>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC3D_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Vec3d>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC4F_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Vec4f>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_VEC4D_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Vec4d>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_MAT4F_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Mat4f>(sceneObject, sc, attrName, pyValue);
+            break;
+        case scene_rdl2::rdl2::AttributeType::TYPE_MAT4D_VECTOR:
+            internal_setVectorAttrFromBuffer<scene_rdl2::rdl2::Mat4d>(sceneObject, sc, attrName, pyValue);
+            break;
+        default:
+            throw std::runtime_error("in setAttributeValueFromBuffer, attribute '" + attrName +
+                    "' of type " + getAttrTypeName(attr) + " can't be set from a buffer.");
+        }
+    }
+
+    //------------------------------------
+    // Register
+    //------------------------------------
+
+    void
+    registerRdl2VectorBufferPyBinding()
+    {
+        bp::class_<VectorAttributeView> pyClass(
+                "VectorAttributeView",
+                "(Python only) Read-only view of the value of a vector attribute, returned by "
+                "SceneObject.getBuffer(). It exposes the buffer protocol and the NumPy array "
+                "interface, so numpy.asarray(view) and memoryview(view) give access to the "
+                "data without copying it.\n"
+                "\n"
+                "The view shares the attribute's buffer: it keeps the value at the time of "
+                "getBuffer() and stays valid after the attribute is set again or the SceneContext "
+                "is destroyed.",
+                bp::no_init);
+
+        pyClass
+            .def("__len__",
+                 &VectorAttributeView::len)
+
+            .add_property("shape",
+                          &VectorAttributeView::shape,
+                          "Shape of the data: (n,) for Int/Long/Float/Double vectors, (n, k) for "
+                          "vectors of k component types (Rgb, Vec3f, ...) and (n, 4, 4) for matrix "
+                          "vectors.")
+
+            .add_property("__array_interface__",
+                          &VectorAttributeView::arrayInterface)
+
+            .def("toList",
+                 &VectorAttributeView::toList,
+                 "Returns a copy of the data as a (nested) Python list.")
+
+            .def("__repr__",
+                 &VectorAttributeView::repr);
+
+#ifdef IS_PY3
+        PyTypeObject* type = reinterpret_cast<PyTypeObject*>(pyClass.ptr());
+        type->tp_as_buffer = &VectorAttributeView_bufferProcs;
+        PyType_Modified(type);
+#endif
+    }
+
+} // namespace py_scene_rdl2
+
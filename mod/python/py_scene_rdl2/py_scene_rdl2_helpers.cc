@@ -5,7 +5,10 @@
 
 #include <algorithm>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include <scene_rdl2/scene/rdl2/SceneObject.h>
@@ -188,7 +191,7 @@ getAttributeValueByName(scene_rdl2::rdl2::SceneObject& sceneObject, const std::s
     else if (checkType(attr, scene_rdl2::rdl2::AttributeType::TYPE_BOOL_VECTOR)) {
 
         return bp::object(
-                BoolVectorWrapper(sceneObject.get<scene_rdl2::rdl2::BoolVector>(
+                BoolVectorWrapper(getAttributeValueLocked(sceneObject,
                         sc.getAttributeKey<scene_rdl2::rdl2::BoolVector>(attrName))));
     }
     else if (checkType(attr, scene_rdl2::rdl2::AttributeType::TYPE_INT_VECTOR)) {
@@ -238,7 +241,7 @@ getAttributeValueByName(scene_rdl2::rdl2::SceneObject& sceneObject, const std::s
     }
     else if (checkType(attr, scene_rdl2::rdl2::AttributeType::TYPE_SCENE_OBJECT_VECTOR)) {
         return bp::object{ SceneObjectVectorWrapper(
-                            sceneObject.get<scene_rdl2::rdl2::SceneObjectVector>(
+                            getAttributeValueLocked(sceneObject,
                                     sc.getAttributeKey<scene_rdl2::rdl2::SceneObjectVector>(attrName))) };
     }
 
@@ -388,10 +391,9 @@ internal_setPrimitiveAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
     // Extract value from boost::python::object
     T value = static_cast<T>(bp::extract<T>(pyValue));
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -440,10 +442,9 @@ internal_setVecAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
         }
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -495,10 +496,9 @@ internal_setMatrixAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
         }
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -520,10 +520,9 @@ internal_setSceneObjectAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
     // Extract value from boost::python::object
     scene_rdl2::rdl2::SceneObject* value = bp::extract<scene_rdl2::rdl2::SceneObject*>(pyValue);
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -558,10 +557,9 @@ internal_setSceneObjectVectorAttrValue(scene_rdl2::rdl2::SceneObject& sceneObjec
                 "Python object passed in must be either a list or a tuple.");
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -593,10 +591,9 @@ internal_setBoolVectorAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
         value = conversions::PyContainerToStdDeque<scene_rdl2::rdl2::Bool>(pyTuple);
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -642,10 +639,9 @@ internal_setPrimitiveVectorAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
                 "Python object passed in must be either a list or a tuple.");
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -697,10 +693,9 @@ internal_setVecVectorAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
                 "Python object passed in must be either a list or a tuple.");
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -744,10 +739,9 @@ internal_setMatrixVectorAttrValue(scene_rdl2::rdl2::SceneObject& sceneObject,
                 "Python object passed in must be either a list or a tuple.");
     }
 
-    // Set the value (NOTE: needs an UpdateGuard)
+    // Set the value (setAttributeValueLocked() adds the UpdateGuard)
     if (isValid) {
-        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
-        sceneObject.set(attrKey, value);
+        setAttributeValueLocked(sceneObject, attrKey, std::move(value));
     }
 }
 
@@ -771,6 +765,18 @@ extractAndSetAttributeValue(scene_rdl2::rdl2::SceneObject& sceneObject,
     //const std::string objType = bp::extract<std::string>(
     //        pyValue.attr("__class__").attr("__name__"));
 
+    //-------------------------------------------
+    // Vector attributes given as a buffer (NumPy arrays, array.array, ...)
+    // are copied in bulk instead of element by element
+
+    if (isBufferAttributeType(attrType) &&
+        !PyList_CheckExact(pyValue.ptr()) &&
+        !PyTuple_CheckExact(pyValue.ptr()) &&
+        PyObject_CheckBuffer(pyValue.ptr())) {
+        setAttributeValueFromBuffer(sceneObject, attrName, pyValue);
+        return;
+    }
+
     //-------------------------------------------
     // First, deal with non-array types
 
@@ -1112,5 +1118,45 @@ getAttributeAt(scene_rdl2::rdl2::SceneClass& sceneClass, unsigned int index)
     return *iter;
 }
 
-} // namespace py_scene_rdl2
+namespace {
 
+// Locks of the SceneContexts created by makeSceneContext(). An entry is
+// removed when its context is deleted, so the map only holds live contexts
+// and an address reused by a new context gets a new lock.
+std::mutex sSceneContextMutexMapMutex;
+std::unordered_map<const scene_rdl2::rdl2::SceneContext*,
+                   std::shared_ptr<std::shared_mutex>> sSceneContextMutexMap;
+
+} // namespace
+
+std::shared_ptr<scene_rdl2::rdl2::SceneContext>
+makeSceneContext()
+{
+    std::unique_ptr<scene_rdl2::rdl2::SceneContext> context(new scene_rdl2::rdl2::SceneContext);
+    {
+        std::lock_guard<std::mutex> lock(sSceneContextMutexMapMutex);
+        sSceneContextMutexMap[context.get()] = std::make_shared<std::shared_mutex>();
+    }
+    return std::shared_ptr<scene_rdl2::rdl2::SceneContext>(
+        context.release(),
+        [](scene_rdl2::rdl2::SceneContext* ptr) {
+            {
+                std::lock_guard<std::mutex> lock(sSceneContextMutexMapMutex);
+                sSceneContextMutexMap.erase(ptr);
+            }
+            delete ptr;
+        });
+}
+
+std::shared_ptr<std::shared_mutex>
+getSceneContextMutex(const scene_rdl2::rdl2::SceneContext& context)
+{
+    static const std::shared_ptr<std::shared_mutex> sForeignContextMutex =
+        std::make_shared<std::shared_mutex>();
+
+    std::lock_guard<std::mutex> lock(sSceneContextMutexMapMutex);
+    auto iter = sSceneContextMutexMap.find(&context);
+    return (iter != sSceneContextMutexMap.end()) ? iter->second : sForeignContextMutex;
+}
+
+} // namespace py_scene_rdl2
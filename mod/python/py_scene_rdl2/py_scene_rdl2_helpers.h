@@ -7,6 +7,8 @@
 #include "boost_python.h"
 
 // C++
+#include <memory>
+#include <shared_mutex>
 #include <stdexcept>
 
 // scene_rdl2
@@ -681,6 +683,130 @@ namespace py_scene_rdl2
         }
     } // namespace conversions
 
+    //-----------------------------------------
+    // Releases the GIL for the lifetime of the object. Only use it around
+    // code which doesn't touch any Python object.
+
+    class ScopedGILRelease
+    {
+    public:
+        ScopedGILRelease()
+            : mThreadState(PyEval_SaveThread())
+        {
+        }
+
+        ~ScopedGILRelease()
+        {
+            PyEval_RestoreThread(mThreadState);
+        }
+
+        ScopedGILRelease(const ScopedGILRelease&) = delete;
+        ScopedGILRelease& operator=(const ScopedGILRelease&) = delete;
+
+    private:
+        PyThreadState* mThreadState;
+    };
+
+    //-----------------------------------------
+    // Per SceneContext lock of the bindings.
+    //
+    // The GIL used to serialize every call on a SceneContext shared by several
+    // Python threads. The scene I/O bindings release the GIL, so everything
+    // which touches the context or its objects takes the lock of the context
+    // instead: reading a scene or modifying the context (createSceneClass,
+    // createSceneObject, loadAllSceneClasses, commitAllChanges, SceneObject
+    // set) takes it exclusively, writing a scene or getting attribute values
+    // takes it shared.
+    //
+    // The lock is always taken after the GIL is released, and released before
+    // the GIL is reacquired (ScopedSceneContextIO), so a thread waiting for
+    // the lock never holds the GIL.
+
+    // Creates a SceneContext whose lock lives exactly as long as the context.
+    // Every SceneContext made by the bindings must be created here.
+    std::shared_ptr<rdl2::SceneContext> makeSceneContext();
+
+    // Returns the lock of a SceneContext created by makeSceneContext(), or a
+    // lock shared by all the other contexts (owned by an embedding
+    // application). Must be called without the GIL.
+    std::shared_ptr<std::shared_mutex> getSceneContextMutex(const rdl2::SceneContext& context);
+
+    // Releases the GIL, then locks the SceneContext. The lock is released before
+    // the GIL is reacquired. A null context (SceneObjects created outside of a
+    // SceneContext) only releases the GIL.
+    class ScopedSceneContextIO
+    {
+    public:
+        enum class Access { READ, WRITE };
+
+        ScopedSceneContextIO(const rdl2::SceneContext& context, Access access)
+            : ScopedSceneContextIO(&context, access)
+        {
+        }
+
+        ScopedSceneContextIO(const rdl2::SceneContext* context, Access access)
+            : mNoGil()
+            , mMutex(context ? getSceneContextMutex(*context) : nullptr)
+            , mAccess(access)
+        {
+            if (!mMutex) {
+                return;
+            }
+            if (mAccess == Access::WRITE) {
+                mMutex->lock();
+            } else {
+                mMutex->lock_shared();
+            }
+        }
+
+        ~ScopedSceneContextIO()
+        {
+            if (!mMutex) {
+                return;
+            }
+            if (mAccess == Access::WRITE) {
+                mMutex->unlock();
+            } else {
+                mMutex->unlock_shared();
+            }
+        }
+
+        ScopedSceneContextIO(const ScopedSceneContextIO&) = delete;
+        ScopedSceneContextIO& operator=(const ScopedSceneContextIO&) = delete;
+
+    private:
+        ScopedGILRelease mNoGil; // destructed last
+        std::shared_ptr<std::shared_mutex> mMutex;
+        Access mAccess;
+    };
+
+    // Copies an attribute value out of a SceneObject under the shared lock of
+    // its SceneContext. The Python object is made from the copy once the GIL
+    // is back.
+    template <typename T>
+    inline T
+    getAttributeValueLocked(const scene_rdl2::rdl2::SceneObject& sceneObject,
+                            scene_rdl2::rdl2::AttributeKey<T> attrKey)
+    {
+        ScopedSceneContextIO io(sceneObject.getSceneClass().getSceneContext(),
+                                ScopedSceneContextIO::Access::READ);
+        return sceneObject.get(attrKey);
+    }
+
+    // Sets an attribute value (inside an UpdateGuard) under the exclusive lock
+    // of the SceneObject's SceneContext.
+    template <typename T>
+    inline void
+    setAttributeValueLocked(scene_rdl2::rdl2::SceneObject& sceneObject,
+                            scene_rdl2::rdl2::AttributeKey<T> attrKey,
+                            T value)
+    {
+        ScopedSceneContextIO io(sceneObject.getSceneClass().getSceneContext(),
+                                ScopedSceneContextIO::Access::WRITE);
+        scene_rdl2::rdl2::SceneObject::UpdateGuard updateGuard(&sceneObject);
+        sceneObject.set(attrKey, std::move(value));
+    }
+
     //-------------------------------------
 
     template <typename T>
@@ -701,7 +827,7 @@ namespace py_scene_rdl2
         static_assert(std::is_same<T, scene_rdl2::rdl2::BoolVector>::value == false,
                 "py_scene_rdl2::extractPrimitiveAttrValueAsPyObj<T>(...) : Cannot handle rdl2::BoolVector.");
 
-        return bp::object{ sceneObject.get<T>(sceneClass.getAttributeKey<T>(attrName)) };
+        return bp::object{ getAttributeValueLocked(sceneObject, sceneClass.getAttributeKey<T>(attrName)) };
     }
 
     template <typename T>
@@ -720,7 +846,7 @@ namespace py_scene_rdl2
         static_assert(std::is_same<T, scene_rdl2::rdl2::BoolVector>::value == false,
                 "py_scene_rdl2::extractAttrValueAsPyObj<T>(...) : Cannot handle rdl2::BoolVector.");
 
-        return bp::object{ boost::cref(sceneObject.get<T>(sceneClass.getAttributeKey<T>(attrName))) };
+        return bp::object{ getAttributeValueLocked(sceneObject, sceneClass.getAttributeKey<T>(attrName)) };
     }
 
     template <typename T>
@@ -754,7 +880,7 @@ namespace py_scene_rdl2
 
         return bp::object{
             StdVectorWrapper<T>(
-                    sceneObject.get<VecType>(sceneClass.getAttributeKey<VecType>(attrName))) };
+                    getAttributeValueLocked(sceneObject, sceneClass.getAttributeKey<VecType>(attrName))) };
     }
 
     inline bool
@@ -810,6 +936,29 @@ namespace py_scene_rdl2
     const scene_rdl2::rdl2::Attribute*
     getAttributeAt(scene_rdl2::rdl2::SceneClass& sceneClass, unsigned int index);
 
+    //-----------------------------------------
+    // Bulk access to vector attributes of plain data types (Int, Long, Float,
+    // Double, Rgb, Rgba, Vec2/3/4 f/d and Mat4 f/d) through the buffer
+    // protocol. See py_scene_rdl2_buffer.cc.
+
+    // True if the attribute type can be read and written as a buffer.
+    bool
+    isBufferAttributeType(scene_rdl2::rdl2::AttributeType attrType);
+
+    // Returns a read-only VectorAttributeView which shares the attribute value
+    // with the SceneObject (no copy). The view keeps the value of the call
+    // when the attribute is set again.
+    bp::object
+    getAttributeBufferByName(scene_rdl2::rdl2::SceneObject& sceneObject, const std::string& attrName);
+
+    // Sets the attribute value from any object exporting a C-contiguous
+    // buffer (NumPy array, array.array, memoryview, bytes...) with a single
+    // copy.
+    void
+    setAttributeValueFromBuffer(scene_rdl2::rdl2::SceneObject& sceneObject,
+                                const std::string& attrName,
+                                bp::object& value);
+
     //-----------------------------------------
     // Wrapper for rdl2::BoolVector
 
@@ -3,6 +3,7 @@
 
 #include "boost_python.h"
 #include "py_scene_rdl2.h"
+#include "py_scene_rdl2_helpers.h"
 
 // scene_rdl2
 #include <scene_rdl2/scene/rdl2/AsciiReader.h>
@@ -14,6 +15,11 @@
 #include <scene_rdl2/scene/rdl2/rdl2.h>
 using namespace scene_rdl2;
 
+#include <tbb/parallel_for.h>
+
+#include <string>
+#include <vector>
+
 namespace py_scene_rdl2
 {
     //------------------------------------
@@ -40,6 +46,7 @@ namespace py_scene_rdl2
         void
         fromFile(const std::string& filename)
         {
+            ScopedSceneContextIO io(*mSceneContextPtr, ScopedSceneContextIO::Access::WRITE);
             mBinaryReader.fromFile(filename);
         }
     };
@@ -131,12 +138,14 @@ namespace py_scene_rdl2
         void
         fromFile(const std::string& filename)
         {
+            ScopedSceneContextIO io(*mSceneContextPtr, ScopedSceneContextIO::Access::WRITE);
             mAsciiReader.fromFile(filename);
         }
 
         void
         fromString(const std::string& code, const std::string& chunkName = "@rdla")
         {
+            ScopedSceneContextIO io(*mSceneContextPtr, ScopedSceneContextIO::Access::WRITE);
             mAsciiReader.fromString(code, chunkName);
         }
     };
@@ -222,12 +231,14 @@ namespace py_scene_rdl2
         void
         toFile(const std::string& filename)
         {
+            ScopedSceneContextIO io(*mSceneContextPtr, ScopedSceneContextIO::Access::READ);
             mAsciiWriter.toFile(filename);
         }
 
         std::string
         toString()
         {
+            ScopedSceneContextIO io(*mSceneContextPtr, ScopedSceneContextIO::Access::READ);
             return mAsciiWriter.toString();
         }
     };
@@ -293,6 +304,7 @@ namespace py_scene_rdl2
         void
         toFile(const std::string& filename)
         {
+            ScopedSceneContextIO io(*mSceneContextPtr, ScopedSceneContextIO::Access::READ);
             mBinaryWriter.toFile(filename);
         }
 
@@ -388,9 +400,60 @@ namespace py_scene_rdl2
     static void
     writeSceneToFileHelper(const rdl2::SceneContext& context, const std::string& filePath)
     {
+        ScopedSceneContextIO io(context, ScopedSceneContextIO::Access::READ);
         rdl2::writeSceneToFile(context, filePath);
     }
 
+    static void
+    readSceneFromFileHelper(const std::string& filePath, rdl2::SceneContext& context)
+    {
+        ScopedSceneContextIO io(context, ScopedSceneContextIO::Access::WRITE);
+        rdl2::readSceneFromFile(filePath, context);
+    }
+
+    static bp::list
+    readScenesFromFilesHelper(const bp::object& filePaths,
+                              const std::string& dsoPath,
+                              bool proxyModeEnabled)
+    {
+        std::vector<std::string> paths;
+        for (bp::stl_input_iterator<std::string> iter(filePaths), end; iter != end; ++iter) {
+            paths.push_back(*iter);
+        }
+
+        std::vector<std::shared_ptr<rdl2::SceneContext>> contexts(paths.size());
+        std::vector<std::string> errors(paths.size());
+        {
+            ScopedGILRelease noGil;
+            tbb::parallel_for(std::size_t(0), paths.size(), [&](std::size_t i) {
+                try {
+                    auto context = makeSceneContext();
+                    if (!dsoPath.empty()) {
+                        context->setDsoPath(dsoPath);
+                    }
+                    context->setProxyModeEnabled(proxyModeEnabled);
+                    rdl2::readSceneFromFile(paths[i], *context);
+                    contexts[i] = std::move(context);
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+        }
+
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            if (!contexts[i]) {
+                throw std::runtime_error("in readScenesFromFiles, failed to read '" + paths[i] +
+                        "': " + errors[i]);
+            }
+        }
+
+        bp::list result;
+        for (const auto& context : contexts) {
+            result.append(context);
+        }
+        return result;
+    }
+
     void
     registerSceneRdl2UtilsPyBinding()
     {
@@ -401,6 +464,25 @@ namespace py_scene_rdl2
                 "\n"
                 "Inputs:    context     The SceneContext to write out. \n"
                 "           filePath    The path to the .rdla or .rdlb file.");
+
+        bp::def("readSceneFromFile",
+                &readSceneFromFileHelper,
+                ( bp::arg("filePath"), bp::arg("sceneContext") ),
+                "Convenience function for easily loading a file into a SceneContext, with the type of reader inferred from the file extension."
+                "\n"
+                "Inputs:    filePath    The path to the .rdla or .rdlb file. \n"
+                "           context     The SceneContext to load into.");
+
+        bp::def("readScenesFromFiles",
+                &readScenesFromFilesHelper,
+                ( bp::arg("filePaths"), bp::arg("dsoPath") = "", bp::arg("proxyModeEnabled") = false ),
+                "(Python only) Loads each file into its own new SceneContext, reading the files in parallel "
+                "with the GIL released, and returns the list of SceneContexts in the order of the file paths. "
+                "If any file fails to load, raises an error naming the first failing file. \n"
+                "\n"
+                "Inputs:    filePaths           Iterable of paths to .rdla or .rdlb files. \n"
+                "           dsoPath             DSO path of the new SceneContexts, the default DSO path if empty. \n"
+                "           proxyModeEnabled    Whether the new SceneContexts create proxy SceneObjects.");
     }
 
 } // namespace py_scene_rdl2
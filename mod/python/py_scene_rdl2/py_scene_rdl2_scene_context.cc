@@ -124,6 +124,40 @@ namespace py_scene_rdl2
         return res;
     }
 
+    // The following modify the SceneContext. They release the GIL (DSO
+    // loading in particular can take a while) and take the context lock
+    // exclusively, see ScopedSceneContextIO.
+
+    void
+    PySceneContext_commitAllChanges(rdl2::SceneContext& self)
+    {
+        ScopedSceneContextIO io(self, ScopedSceneContextIO::Access::WRITE);
+        self.commitAllChanges();
+    }
+
+    void
+    PySceneContext_loadAllSceneClasses(rdl2::SceneContext& self)
+    {
+        ScopedSceneContextIO io(self, ScopedSceneContextIO::Access::WRITE);
+        self.loadAllSceneClasses();
+    }
+
+    rdl2::SceneClass*
+    PySceneContext_createSceneClass(rdl2::SceneContext& self, const std::string& className)
+    {
+        ScopedSceneContextIO io(self, ScopedSceneContextIO::Access::WRITE);
+        return self.createSceneClass(className);
+    }
+
+    rdl2::SceneObject*
+    PySceneContext_createSceneObject(rdl2::SceneContext& self,
+                                     const std::string& className,
+                                     const std::string& objectName)
+    {
+        ScopedSceneContextIO io(self, ScopedSceneContextIO::Access::WRITE);
+        return self.createSceneObject(className, objectName);
+    }
+
     void
     registerSceneContextPyBinding()
     {
@@ -159,7 +193,10 @@ namespace py_scene_rdl2
                                                  std::shared_ptr<rdl2::SceneContext>,
                                                  boost::noncopyable>;
 
-        PySceneContextClass_t("SceneContext", rdl2SceneContextDocstring.c_str())
+        PySceneContextClass_t("SceneContext", rdl2SceneContextDocstring.c_str(), bp::no_init)
+            // The lock of the bindings lives as long as the context.
+            .def("__init__", bp::make_constructor(&makeSceneContext))
+
             .def("getDsoPath",
                  &rdl2::SceneContext::getDsoPath,
                  "Retrieves the DSO path this SceneContext is using to locate DSO SceneClasses. "
@@ -223,13 +260,13 @@ namespace py_scene_rdl2
                  "Returns the render to world transform, if set, None if not.")
 
             .def("commitAllChanges",
-                 &rdl2::SceneContext::commitAllChanges,
+                 &PySceneContext_commitAllChanges,
                  "Clears all flags on all attributes of all objects that are tracking "
                  "what has changed. This effectively puts the SceneContext in its 'base' "
                  "state, where nothing has changed.")
 
             .def("loadAllSceneClasses",
-                 &rdl2::SceneContext::loadAllSceneClasses,
+                 &PySceneContext_loadAllSceneClasses,
                  "Searches every directory in the DSO path looking for '.so' files and "
                  "attempts to load them as RDL DSOs. Files that are not successfully "
                  "opened as RDL DSOs are ignored. This can be used to fill up the SceneClass "
@@ -280,7 +317,7 @@ namespace py_scene_rdl2
                  "Retrieves a mutable reference to the SceneVariables object.")
 
             .def("createSceneClass",
-                 &rdl2::SceneContext::createSceneClass,
+                 &PySceneContext_createSceneClass,
                  bp::arg("className"),
                  bp::return_internal_reference<>(),
                  "Creates a SceneClass of the given name. \n"
@@ -296,7 +333,7 @@ namespace py_scene_rdl2
                  "Returns the new SceneClass or the existing SceneClass (if it already existed).")
 
             .def("createSceneObject",
-                 &rdl2::SceneContext::createSceneObject,
+                 &PySceneContext_createSceneObject,
                  ( bp::arg("className"), bp::arg("objectName") ),
                  bp::return_internal_reference<>(),
                  "Create a SceneObject from the given SceneClass name with the given object name. \n"
@@ -181,6 +181,22 @@ namespace py_scene_rdl2
         return getAttributeNamesAndTypes(const_cast<rdl2::SceneClass&>(sc));
     }
 
+    void
+    PySceneObject_resetToDefault(rdl2::SceneObject& self, const std::string& name)
+    {
+        ScopedSceneContextIO io(self.getSceneClass().getSceneContext(),
+                                ScopedSceneContextIO::Access::WRITE);
+        self.resetToDefault(name);
+    }
+
+    void
+    PySceneObject_resetAllToDefault(rdl2::SceneObject& self)
+    {
+        ScopedSceneContextIO io(self.getSceneClass().getSceneContext(),
+                                ScopedSceneContextIO::Access::WRITE);
+        self.resetAllToDefault();
+    }
+
     void
     registerSceneObjectPyBinding()
     {
@@ -211,7 +227,7 @@ namespace py_scene_rdl2
                  "Retrieves the object type name as a string.")
 
             .def("resetToDefault",
-                 ( void (rdl2::SceneObject::*) (const std::string&) ) &rdl2::SceneObject::resetToDefault,
+                 &PySceneObject_resetToDefault,
                  bp::arg("name"),
                  "Convenience function to reset an attribute value to its default value by name rather "
                  "than by AttributeKey. If no default value is supplied by the SceneClass, a "
@@ -220,7 +236,7 @@ namespace py_scene_rdl2
                  "Inputs:    name    The name of an attribute which you want to reset to its default value.")
 
             .def("resetAllToDefault",
-                 &rdl2::SceneObject::resetAllToDefault,
+                 &PySceneObject_resetAllToDefault,
                  "Resets all attributes in the SceneObject to their default values. If no default value "
                  "is supplied for an attribute by the SceneClass, a reasonable default is supplied for "
                  "you (0, empty string, null, etc.)")
@@ -273,6 +289,15 @@ namespace py_scene_rdl2
                  bp::arg("attrName"),
                  "WRITE HELP LATER")
 
+            .def("getBuffer",
+                 &getAttributeBufferByName,
+                 bp::arg("attrName"),
+                 "Returns a read-only scene_rdl2.VectorAttributeView of the value of a vector "
+                 "attribute (Int, Long, Float, Double, Rgb, Rgba, Vec2/3/4 and Mat4 vectors). The "
+                 "view shares the attribute value with the SceneObject instead of copying it, "
+                 "numpy.asarray() of the view is a zero-copy NumPy array over that value. The view "
+                 "is not affected by later set() calls and may outlive the SceneObject.")
+
              //------------------------------------------------
              // Set Attribute values
 
@@ -281,6 +306,15 @@ namespace py_scene_rdl2
                  (bp::arg("attrName"), bp::arg("attrValue")),
                  "WRITE HELP LATER")
 
+            .def("setFromBuffer",
+                 &setAttributeValueFromBuffer,
+                 (bp::arg("attrName"), bp::arg("attrValue")),
+                 "Sets a vector attribute from any C-contiguous object supporting the buffer protocol "
+                 "(NumPy arrays, array.array, memoryview, ...) in a single copy. The number of values "
+                 "must be a multiple of the number of components of the attribute element type. "
+                 "Integer values which don't fit into the attribute type raise OverflowError. "
+                 "set() uses this automatically when given such an object.")
+
             //------------------------------------------------
             // Downcasting to derived types:
 
@@ -8,6 +8,9 @@
 // scene_rdl2
 #include <scene_rdl2/scene/rdl2/SceneObject.h>
 #include <scene_rdl2/scene/rdl2/UserData.h>
+
+#include <utility>
+
 using namespace scene_rdl2;
 
 namespace py_scene_rdl2
@@ -31,84 +34,84 @@ namespace py_scene_rdl2
     void
     PyUserData_setIntData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::Int> stdVect =
+        std::vector<rdl2::Int> stdVect =
                 conversions::PyPrimitiveContainerToStdVector<rdl2::Int>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setIntData(key, stdVect);
+            self.setIntData(key, std::move(stdVect));
         }
     }
 
     void
     PyUserData_setFloatData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::Float> stdVect =
+        std::vector<rdl2::Float> stdVect =
                 conversions::PyPrimitiveContainerToStdVector<rdl2::Float>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setFloatData(key, stdVect);
+            self.setFloatData(key, std::move(stdVect));
         }
     }
 
     void
     PyUserData_setStringData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::String> stdVect =
+        std::vector<rdl2::String> stdVect =
                 conversions::PyPrimitiveContainerToStdVector<rdl2::String>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setStringData(key, stdVect);
+            self.setStringData(key, std::move(stdVect));
         }
     }
 
     void
     PyUserData_setColorData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::Rgb> stdVect =
+        std::vector<rdl2::Rgb> stdVect =
                 conversions::PyVecContainerToStdVector<rdl2::Rgb>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setColorData(key, stdVect);
+            self.setColorData(key, std::move(stdVect));
         }
     }
 
     void
     PyUserData_setVec2fData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::Vec2f> stdVect =
+        std::vector<rdl2::Vec2f> stdVect =
                 conversions::PyVecContainerToStdVector<rdl2::Vec2f>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setVec2fData(key, stdVect);
+            self.setVec2fData(key, std::move(stdVect));
         }
     }
 
     void
     PyUserData_setVec3fData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::Vec3f> stdVect =
+        std::vector<rdl2::Vec3f> stdVect =
                 conversions::PyVecContainerToStdVector<rdl2::Vec3f>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setVec3fData(key, stdVect);
+            self.setVec3fData(key, std::move(stdVect));
         }
     }
 
     void
     PyUserData_setMat4fData(rdl2::UserData& self, const std::string& key, bp::list& values)
     {
-        const std::vector<rdl2::Mat4f> stdVect =
+        std::vector<rdl2::Mat4f> stdVect =
                 conversions::PyMatrixContainerToStdVector<rdl2::Mat4f>(values);
 
         {
             rdl2::SceneObject::UpdateGuard guard(&self);
-            self.setMat4fData(key, stdVect);
+            self.setMat4fData(key, std::move(stdVect));
         }
     }
 
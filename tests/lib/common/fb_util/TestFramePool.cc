@@ -0,0 +1,284 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestFramePool.h"
+#include <scene_rdl2/common/fb_util/FbTypes.h>
+#include <scene_rdl2/common/fb_util/FramePool.h>
+#include <scene_rdl2/common/fb_util/VariablePixelBuffer.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+namespace {
+
+bool
+isAllZero(const void *ptr, size_t size)
+{
+    const unsigned char *cPtr = static_cast<const unsigned char *>(ptr);
+    for (size_t i = 0; i < size; ++i) {
+        if (cPtr[i]) return false;
+    }
+    return true;
+}
+
+struct StormStep
+{
+    VariablePixelBuffer::Format mFormat;
+    unsigned mWidth;
+    unsigned mHeight;
+    unsigned mSizeOfPixel;
+};
+
+// interactive session which toggles resolution and AOV format
+const std::vector<StormStep> sStormSteps = {
+    {VariablePixelBuffer::FLOAT4, 1920, 1080, 16},
+    {VariablePixelBuffer::FLOAT4, 3840, 2160, 16},
+    {VariablePixelBuffer::FLOAT, 3840, 2160, 4},
+    {VariablePixelBuffer::FLOAT3, 1920, 1080, 12},
+    {VariablePixelBuffer::RGBA8888, 1920, 1080, 4},
+    {VariablePixelBuffer::FLOAT4, 3840, 2160, 16},
+};
+
+// write 1 pixel of each 8x8 tile like a coarse pass of the progressive rendering
+void
+sparseWrite(void *ptr, unsigned width, unsigned height, unsigned sizeOfPixel)
+{
+    unsigned char *cPtr = static_cast<unsigned char *>(ptr);
+    for (unsigned y = 0; y < height; y += 8) {
+        for (unsigned x = 0; x < width; x += 8) {
+            cPtr[(static_cast<size_t>(y) * width + x) * sizeOfPixel] = 1;
+        }
+    }
+}
+
+// return millisec
+float
+resizeStormDirect(const int loopMax)
+{
+    // same as the previous PixelBuffer : allocate new aligned block every time and memset by clear()
+    rec_time::RecTime recTime;
+    recTime.start();
+    for (int loop = 0; loop < loopMax; ++loop) {
+        for (const StormStep &step : sStormSteps) {
+            const size_t size = static_cast<size_t>(step.mWidth) * step.mHeight * step.mSizeOfPixel;
+            void *ptr = util::alignedMalloc(size, CACHE_LINE_SIZE);
+            std::memset(ptr, 0, size);
+            sparseWrite(ptr, step.mWidth, step.mHeight, step.mSizeOfPixel);
+            util::alignedFree(ptr);
+        }
+    }
+    return recTime.end() * 1000.0f;
+}
+
+// return millisec
+float
+resizeStormPool(const int loopMax)
+{
+    rec_time::RecTime recTime;
+    recTime.start();
+    for (int loop = 0; loop < loopMax; ++loop) {
+        for (const StormStep &step : sStormSteps) {
+            VariablePixelBuffer buff;
+            buff.init(step.mFormat, step.mWidth, step.mHeight);
+            buff.clear();
+            sparseWrite(buff.getData(), step.mWidth, step.mHeight, buff.getSizeOfPixel());
+        }
+    }
+    return recTime.end() * 1000.0f;
+}
+
+} // namespace
+
+void
+TestFramePool::setUp()
+{
+    FramePool &pool = FramePool::get();
+    pool.setHugePage(false);
+    pool.setLazyZero(false);
+    pool.trim();
+    pool.resetStats();
+}
+
+void
+TestFramePool::tearDown()
+{
+    setUp();
+}
+
+void
+TestFramePool::testReuse()
+{
+    FramePool &pool = FramePool::get();
+
+    Float4Buffer buff;
+    buff.init(1920, 1080);
+    const void *ptr = buff.getData();
+    CPPUNIT_ASSERT(pool.getOsAllocTotal() == 1);
+    CPPUNIT_ASSERT(pool.getInUseBytes() >= 1920 * 1080 * sizeof(math::Vec4f));
+
+    buff.cleanUp();
+    CPPUNIT_ASSERT(pool.getInUseBytes() == 0);
+    CPPUNIT_ASSERT(pool.getCachedBytes() >= 1920 * 1080 * sizeof(math::Vec4f));
+
+    // same byte size (1920x1080 x 4 floats = 3840x1080 x 2 floats) : cached block is returned
+    Float2Buffer buff2;
+    buff2.init(3840, 1080);
+    CPPUNIT_ASSERT(buff2.getData() == ptr);
+    CPPUNIT_ASSERT(pool.getOsAllocTotal() == 1);
+    CPPUNIT_ASSERT(pool.getReuseTotal() == 1);
+    CPPUNIT_ASSERT(pool.getCachedBytes() == 0);
+
+    // smaller request does not reallocate
+    buff2.init(640, 480);
+    CPPUNIT_ASSERT(buff2.getData() == ptr);
+
+    // small block keeps its own size and is reused by the same size
+    FloatBuffer small;
+    small.init(60, 60);
+    CPPUNIT_ASSERT(pool.getInUseBytes() >= 1920 * 1080 * sizeof(math::Vec4f) + 60 * 60 * sizeof(float));
+    const size_t inUse = pool.getInUseBytes();
+    small.cleanUp();
+    CPPUNIT_ASSERT(pool.getInUseBytes() == inUse - 60 * 60 * sizeof(float));
+    CPPUNIT_ASSERT(pool.getCachedBytes() == 60 * 60 * sizeof(float));
+    small.init(60, 60);
+    CPPUNIT_ASSERT(pool.getOsAllocTotal() == 2);
+    CPPUNIT_ASSERT(pool.getReuseTotal() == 2);
+}
+
+void
+TestFramePool::testDataShared()
+{
+    FramePool &pool = FramePool::get();
+
+    std::shared_ptr<math::Vec4f> shared;
+    {
+        Float4Buffer buff;
+        buff.init(1920, 1080);
+        buff.clear(math::Vec4f(1.0f, 2.0f, 3.0f, 4.0f));
+        shared = buff.getDataShared();
+    }
+    // block is still owned by shared
+    CPPUNIT_ASSERT(pool.getCachedBytes() == 0);
+    CPPUNIT_ASSERT(shared.get()[1920 * 1080 - 1] == math::Vec4f(1.0f, 2.0f, 3.0f, 4.0f));
+
+    Float4Buffer buff;
+    buff.init(1920, 1080);
+    CPPUNIT_ASSERT(buff.getData() != shared.get());
+    CPPUNIT_ASSERT(pool.getOsAllocTotal() == 2);
+
+    shared.reset();
+    CPPUNIT_ASSERT(pool.getCachedBytes() > 0);
+}
+
+void
+TestFramePool::testClear()
+{
+    FramePool &pool = FramePool::get();
+
+    for (bool lazyZero : {false, true}) {
+        pool.setLazyZero(lazyZero);
+
+        // odd size in order to test partial page
+        for (unsigned width : {33u, 1921u}) {
+            Rgb888Buffer buff;
+            buff.init(width, 1081);
+            std::memset(buff.getData(), 0xff, width * 1081 * sizeof(ByteColor));
+            buff.clear();
+            CPPUNIT_ASSERT(isAllZero(buff.getData(), width * 1081 * sizeof(ByteColor)));
+
+            // cleared pages are still writable
+            buff.setPixel(width - 1, 1080, ByteColor {1, 2, 3});
+            CPPUNIT_ASSERT(buff.getPixel(width - 1, 1080).b == 3);
+            CPPUNIT_ASSERT(isAllZero(buff.getData(), (width * 1081 - 1) * sizeof(ByteColor)));
+        }
+    }
+}
+
+void
+TestFramePool::testHugePage()
+{
+    FramePool &pool = FramePool::get();
+
+    pool.setHugePage(true);
+    Float4Buffer buff;
+    buff.init(1920, 1080);
+    CPPUNIT_ASSERT((reinterpret_cast<uintptr_t>(buff.getData()) & (FramePool::sHugePageSize - 1)) == 0);
+    CPPUNIT_ASSERT(pool.getInUseBytes() % FramePool::sHugePageSize == 0);
+    buff.clear(math::Vec4f(1.0f));
+
+    // turn off before release. Block is still returned with the huge page size
+    pool.setHugePage(false);
+    const size_t inUse = pool.getInUseBytes();
+    buff.cleanUp();
+    CPPUNIT_ASSERT(pool.getInUseBytes() == 0);
+    CPPUNIT_ASSERT(pool.getCachedBytes() == inUse);
+}
+
+void
+TestFramePool::testMaxCachedBytes()
+{
+    FramePool &pool = FramePool::get();
+    const size_t maxCachedBytes = pool.getMaxCachedBytes();
+    CPPUNIT_ASSERT(maxCachedBytes == FramePool::sDefaultMaxCachedBytes);
+
+    pool.setMaxCachedBytes(16 * 1024 * 1024);
+    {
+        Float4Buffer buffA, buffB; // 8MB x 2
+        buffA.init(1024, 512);
+        buffB.init(1024, 512);
+        Float4Buffer buffC;     // 32MB : bigger than the limit
+        buffC.init(2048, 1024);
+    }
+    CPPUNIT_ASSERT(pool.getCachedBytes() == 16 * 1024 * 1024);
+
+    pool.setMaxCachedBytes(0);
+    CPPUNIT_ASSERT(pool.getCachedBytes() == 0);
+    {
+        Float4Buffer buff;      // no caching
+        buff.init(1024, 512);
+    }
+    CPPUNIT_ASSERT(pool.getCachedBytes() == 0);
+
+    pool.setMaxCachedBytes(maxCachedBytes);
+    CPPUNIT_ASSERT(pool.getMaxCachedBytes() == maxCachedBytes);
+}
+
+void
+TestFramePool::testResizeStorm()
+{
+    FramePool &pool = FramePool::get();
+    constexpr int loopMax = 10;
+
+    const float direct = resizeStormDirect(loopMax);
+    const float pooled = resizeStormPool(loopMax);
+    const size_t osAllocTotal = pool.getOsAllocTotal();
+    const size_t reuseTotal = pool.getReuseTotal();
+    pool.setLazyZero(true);
+    const float lazyZero = resizeStormPool(loopMax);
+    pool.setHugePage(true);
+    pool.trim();
+    const float hugePage = resizeStormPool(loopMax);
+
+    std::cerr << "\n>> TestFramePool resize storm " << loopMax * sStormSteps.size() << " steps"
+              << " direct:" << direct << " ms"
+              << " pool:" << pooled << " ms"
+              << " pool+lazyZero:" << lazyZero << " ms"
+              << " pool+lazyZero+hugePage:" << hugePage << " ms\n"
+              << pool.show() << '\n';
+
+    // only the first round goes to the OS
+    CPPUNIT_ASSERT(osAllocTotal <= sStormSteps.size());
+    CPPUNIT_ASSERT(osAllocTotal + reuseTotal == loopMax * sStormSteps.size());
+}
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
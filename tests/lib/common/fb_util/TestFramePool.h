@@ -0,0 +1,39 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+class TestFramePool : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    void testReuse();
+    void testDataShared();      // block is not reused while getDataShared() result is alive
+    void testClear();           // memset and LazyZero
+    void testHugePage();
+    void testMaxCachedBytes();
+    void testResizeStorm();     // benchmark
+
+    CPPUNIT_TEST_SUITE(TestFramePool);
+    CPPUNIT_TEST(testReuse);
+    CPPUNIT_TEST(testDataShared);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST(testHugePage);
+    CPPUNIT_TEST(testMaxCachedBytes);
+    CPPUNIT_TEST(testResizeStorm);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
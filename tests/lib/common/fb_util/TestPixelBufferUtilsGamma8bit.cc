@@ -0,0 +1,424 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestPixelBufferUtilsGamma8bit.h"
+#include <scene_rdl2/common/fb_util/PixelBufferUtilsGamma8bit.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+namespace {
+
+constexpr PixelBufferUtilOptions sNoSimd = PIXEL_BUFFER_UTIL_OPTIONS_NO_SIMD;
+
+float
+randomValue(std::mt19937 &rng, bool nonFinite)
+{
+    std::uniform_real_distribution<float> dist(-0.5f, 2.0f);
+    if (nonFinite && rng() % 64 == 0) {
+        switch (rng() % 3) {
+        case 0 : return std::numeric_limits<float>::infinity();
+        case 1 : return -std::numeric_limits<float>::infinity();
+        default : return std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    return dist(rng);
+}
+
+template <typename T>
+void
+fillRandom(PixelBuffer<T> &buff, unsigned w, unsigned h, unsigned numChan, bool nonFinite)
+{
+    std::mt19937 rng(w * 31 + h);
+    buff.init(w, h);
+    float *data = reinterpret_cast<float *>(buff.getData());
+    for (unsigned i = 0; i < w * h * numChan; ++i) {
+        data[i] = randomValue(rng, nonFinite);
+    }
+}
+
+template <typename T>
+bool
+sameBuffer(const PixelBuffer<T> &a, const PixelBuffer<T> &b)
+{
+    return (a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+            std::memcmp(a.getData(), b.getData(), a.getArea() * sizeof(T)) == 0);
+}
+
+// Run func with and without SIMD for all option combinations and compare the results.
+template <typename DEST_BUFFER>
+bool
+compareSimd(const std::function<void(DEST_BUFFER &, PixelBufferUtilOptions, float exposure, float gamma)> &func,
+            bool normalize)
+{
+    for (PixelBufferUtilOptions options = 0; options < 8; ++options) {
+        if (!normalize && (options & PIXEL_BUFFER_UTIL_OPTIONS_NORMALIZE)) continue;
+        for (float gamma : {1.0f, 2.2f}) {
+            DEST_BUFFER simd, scalar;
+            func(simd, options, 0.5f, gamma);
+            func(scalar, options | sNoSimd, 0.5f, gamma);
+            if (!sameBuffer(simd, scalar)) {
+                std::cerr << "options:0x" << std::hex << options << std::dec << " gamma:" << gamma << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Deterministic input which does not depend on the std::random implementation.
+// Value range is [-0.5, 2.0).
+template <typename T>
+void
+fillPattern(PixelBuffer<T> &buff, unsigned w, unsigned h, unsigned numChan)
+{
+    buff.init(w, h);
+    float *data = reinterpret_cast<float *>(buff.getData());
+    uint32_t seed = w * 31 + h;
+    for (unsigned i = 0; i < w * h * numChan; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        data[i] = static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) * 2.5f - 0.5f;
+    }
+}
+
+// 64bit FNV-1a hash of the 8bit result
+template <typename T>
+uint64_t
+hashBuffer(const PixelBuffer<T> &buff)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char *ptr = reinterpret_cast<const unsigned char *>(buff.getData());
+    for (size_t i = 0; i < buff.getArea() * sizeof(T); ++i) {
+        hash = (hash ^ ptr[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+void
+TestPixelBufferUtilsGamma8bit::setUp()
+{
+}
+
+void
+TestPixelBufferUtilsGamma8bit::tearDown()
+{
+}
+
+void
+TestPixelBufferUtilsGamma8bit::testGammaAndQuantize()
+{
+    // width is not a multiple of 8 in order to test the scalar tail of each row
+    for (unsigned w : {1u, 8u, 67u}) {
+        const unsigned h = 13;
+
+        // non finite values are only used without normalize, uint8_t(NaN) is undefined
+        RenderBuffer renderBuff, renderBuffNF;
+        fillRandom(renderBuff, w, h, 4, false);
+        fillRandom(renderBuffNF, w, h, 4, true);
+        CPPUNIT_ASSERT(compareSimd<Rgb888Buffer>([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                    gammaAndQuantizeTo8bit(dst, renderBuff, opt, e, g);
+                }, true));
+        CPPUNIT_ASSERT(compareSimd<Rgb888Buffer>([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                    gammaAndQuantizeTo8bit(dst, renderBuffNF, opt | PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA, e, g);
+                }, false));
+        CPPUNIT_ASSERT(compareSimd<Rgba8888Buffer>([&](Rgba8888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                    gammaAndQuantizeTo8bit(dst, renderBuff, opt, e, g);
+                }, true));
+
+        for (VariablePixelBuffer::Format format : {VariablePixelBuffer::FLOAT,
+                                                   VariablePixelBuffer::FLOAT2,
+                                                   VariablePixelBuffer::FLOAT3}) {
+            VariablePixelBuffer buff;
+            buff.init(format, w, h);
+            switch (format) {
+            case VariablePixelBuffer::FLOAT : fillRandom(buff.getFloatBuffer(), w, h, 1, false); break;
+            case VariablePixelBuffer::FLOAT2 : fillRandom(buff.getFloat2Buffer(), w, h, 2, false); break;
+            default : fillRandom(buff.getFloat3Buffer(), w, h, 3, false); break;
+            }
+            CPPUNIT_ASSERT(compareSimd<Rgb888Buffer>([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                        gammaAndQuantizeTo8bit(dst, buff, opt, e, g);
+                    }, true));
+        }
+    }
+}
+
+void
+TestPixelBufferUtilsGamma8bit::testExtractChannel()
+{
+    for (unsigned w : {3u, 16u, 45u}) {
+        const unsigned h = 11;
+
+        RenderBuffer renderBuff;
+        fillRandom(renderBuff, w, h, 4, true);
+        VariablePixelBuffer float3Buff;
+        float3Buff.init(VariablePixelBuffer::FLOAT3, w, h);
+        fillRandom(float3Buff.getFloat3Buffer(), w, h, 3, true);
+
+        using ExtractFunc = void (*)(Rgb888Buffer &, const RenderBuffer &, PixelBufferUtilOptions, float, float);
+        using ExtractVFunc = void (*)(Rgb888Buffer &, const VariablePixelBuffer &, PixelBufferUtilOptions, float, float);
+        const std::vector<std::pair<ExtractFunc, ExtractVFunc>> funcs = {
+            {extractRedChannel, extractRedChannel},
+            {extractGreenChannel, extractGreenChannel},
+            {extractBlueChannel, extractBlueChannel},
+            {extractLuminance, extractLuminance},
+        };
+        for (const auto &func : funcs) {
+            CPPUNIT_ASSERT(compareSimd<Rgb888Buffer>([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                        func.first(dst, renderBuff, opt, e, g);
+                    }, false));
+            CPPUNIT_ASSERT(compareSimd<Rgb888Buffer>([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                        func.second(dst, float3Buff, opt, e, g);
+                    }, false));
+        }
+    }
+}
+
+void
+TestPixelBufferUtilsGamma8bit::testReference()
+{
+    // Hash of the result of each format x options x exposure x gamma combination, computed by the
+    // scalar per-pixel code before the SIMD kernels were introduced. Both SIMD and scalar
+    // kernels have to reproduce them bit by bit.
+    static const uint64_t sReference[] = {
+        0x5a6f79d877189270, 0x67751e48d29ef1fc, 0x69a2d4f0b51423d6, 0x818db07433610d4b,
+        0x2987d7672b7407ec, 0x19846823003ae5d2, 0x916c0b3d6229f113, 0xbc3926d792b35da9,
+        0x2654cb8c3179fd4e, 0x2654cb8c3179fd4e, 0x2654cb8c3179fd4e, 0x2654cb8c3179fd4e,
+        0xc53c1a0721318b32, 0xc53c1a0721318b32, 0xc53c1a0721318b32, 0xc53c1a0721318b32,
+        0xd4e355f616900294, 0x15451eeeb15abcc2, 0xca98b37c9ef47b0c, 0xb362f91fb7ec8a01,
+        0x475d93754fda9c62, 0xfcf1ab48b361ef94, 0xab1bcc16ae5016b1, 0x5fdf9383a14f0363,
+        0x52ac66120a2736a0, 0x52ac66120a2736a0, 0x52ac66120a2736a0, 0x52ac66120a2736a0,
+        0x9a3a54ed9e73e432, 0x9a3a54ed9e73e432, 0x9a3a54ed9e73e432, 0x9a3a54ed9e73e432,
+        0x5193327b486def81, 0x9a7595a12f0bbc5c, 0x0b7607bd5c847b43, 0xdd17fe2e13f096b6,
+        0x4815628a7e5849d1, 0xce73da6b351bb1e9, 0x18ad13de3f2bd01b, 0xfbd6c6477b7f5230,
+        0xafb0e2dbba4d2483, 0xafb0e2dbba4d2483, 0xafb0e2dbba4d2483, 0xafb0e2dbba4d2483,
+        0xe060865311f946e8, 0xe060865311f946e8, 0xe060865311f946e8, 0xe060865311f946e8,
+        0xcf4250236bb45a55, 0xa43c52d7e3e20d85, 0xd2b4743501b26c49, 0x0b36237f33f67f5a,
+        0x08c96ce30cd0b515, 0xe0ff7eeec0529bb1, 0xa72d88d3126d0641, 0xff7f6764c3658f64,
+        0x38117d09ca8d225f, 0x38117d09ca8d225f, 0x38117d09ca8d225f, 0x38117d09ca8d225f,
+        0xa6508365ab0458db, 0xa6508365ab0458db, 0xa6508365ab0458db, 0xa6508365ab0458db,
+        0xef833219f24284e2, 0x6dd2c20f6a989382, 0xc51f8c8fb2953130, 0x5dedead39f8a6c3f,
+        0xb7011843812d5003, 0x435ecfab1d9fd15e, 0xb6c7a63e89896004, 0xbcbc2db00cda5ecb,
+        0x4240c10728c9890c, 0x4240c10728c9890c, 0x4240c10728c9890c, 0x4240c10728c9890c,
+        0xcc58bc7b0971d30f, 0xcc58bc7b0971d30f, 0xcc58bc7b0971d30f, 0xcc58bc7b0971d30f,
+        0x83b352ebdcb28dec, 0xe55b528aa6faa724, 0x3ce76d6ef4e73904, 0x6aa7bd7d6d63b839,
+        0x83b352ebdcb28dec, 0xe55b528aa6faa724, 0x3ce76d6ef4e73904, 0x6aa7bd7d6d63b839,
+        0x83b352ebdcb28dec, 0xe55b528aa6faa724, 0x3ce76d6ef4e73904, 0x6aa7bd7d6d63b839,
+        0x83b352ebdcb28dec, 0xe55b528aa6faa724, 0x3ce76d6ef4e73904, 0x6aa7bd7d6d63b839,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x204887e9b3d6794c, 0xfded2b64fccd6cc9, 0xd3e78ec1c8f6a350, 0x3ba6b4eae5dc30da,
+        0x204887e9b3d6794c, 0xfded2b64fccd6cc9, 0xd3e78ec1c8f6a350, 0x3ba6b4eae5dc30da,
+        0x204887e9b3d6794c, 0xfded2b64fccd6cc9, 0xd3e78ec1c8f6a350, 0x3ba6b4eae5dc30da,
+        0x204887e9b3d6794c, 0xfded2b64fccd6cc9, 0xd3e78ec1c8f6a350, 0x3ba6b4eae5dc30da,
+        0x31ff695b23aa7829, 0xda6cf0358f465243, 0xf12f383271204449, 0x6a8a7ace73fc412e,
+        0x31ff695b23aa7829, 0xda6cf0358f465243, 0xf12f383271204449, 0x6a8a7ace73fc412e,
+        0x31ff695b23aa7829, 0xda6cf0358f465243, 0xf12f383271204449, 0x6a8a7ace73fc412e,
+        0x31ff695b23aa7829, 0xda6cf0358f465243, 0xf12f383271204449, 0x6a8a7ace73fc412e,
+        0xfb21d72dc17ee9c8, 0x31f4e0c74c5dc391, 0x6e2586adc2a9def9, 0xf0bbfc8bdbf3c415,
+        0xfb21d72dc17ee9c8, 0x31f4e0c74c5dc391, 0x6e2586adc2a9def9, 0xf0bbfc8bdbf3c415,
+        0xfb21d72dc17ee9c8, 0x31f4e0c74c5dc391, 0x6e2586adc2a9def9, 0xf0bbfc8bdbf3c415,
+        0xfb21d72dc17ee9c8, 0x31f4e0c74c5dc391, 0x6e2586adc2a9def9, 0xf0bbfc8bdbf3c415,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x95ec585354386648, 0x53268f2540b1f884, 0x66e76c327485f028, 0x0b317a8556c79028,
+        0x95ec585354386648, 0x53268f2540b1f884, 0x66e76c327485f028, 0x0b317a8556c79028,
+        0x95ec585354386648, 0x53268f2540b1f884, 0x66e76c327485f028, 0x0b317a8556c79028,
+        0x95ec585354386648, 0x53268f2540b1f884, 0x66e76c327485f028, 0x0b317a8556c79028,
+        0x3df8b9c6e26dcbb3, 0x7c9ca9aa3f3dab63, 0x9062a9b2f74149b0, 0xe04cb45874bc58af,
+        0x3df8b9c6e26dcbb3, 0x7c9ca9aa3f3dab63, 0x9062a9b2f74149b0, 0xe04cb45874bc58af,
+        0x3df8b9c6e26dcbb3, 0x7c9ca9aa3f3dab63, 0x9062a9b2f74149b0, 0xe04cb45874bc58af,
+        0x3df8b9c6e26dcbb3, 0x7c9ca9aa3f3dab63, 0x9062a9b2f74149b0, 0xe04cb45874bc58af,
+        0xe9c5dafda302527c, 0xf59069a5f6b805e8, 0x624eaeb7b1d5a3d2, 0x7d4f07a929f20b10,
+        0xe9c5dafda302527c, 0xf59069a5f6b805e8, 0x624eaeb7b1d5a3d2, 0x7d4f07a929f20b10,
+        0xe9c5dafda302527c, 0xf59069a5f6b805e8, 0x624eaeb7b1d5a3d2, 0x7d4f07a929f20b10,
+        0xe9c5dafda302527c, 0xf59069a5f6b805e8, 0x624eaeb7b1d5a3d2, 0x7d4f07a929f20b10,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727,
+        0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727,
+        0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727,
+        0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727, 0xa98454ca80068727,
+        0xd723d84def479fb9, 0x4cdd527ca64ad44f, 0xc5ab51f559049b39, 0xac86261daf9a2b71,
+        0xd723d84def479fb9, 0x4cdd527ca64ad44f, 0xc5ab51f559049b39, 0xac86261daf9a2b71,
+        0xd723d84def479fb9, 0x4cdd527ca64ad44f, 0xc5ab51f559049b39, 0xac86261daf9a2b71,
+        0xd723d84def479fb9, 0x4cdd527ca64ad44f, 0xc5ab51f559049b39, 0xac86261daf9a2b71,
+        0xf45e00ad060cdedc, 0xafaa7e7756066251, 0x93b7bd5dd475b437, 0x14f9d84b38a4777f,
+        0xf45e00ad060cdedc, 0xafaa7e7756066251, 0x93b7bd5dd475b437, 0x14f9d84b38a4777f,
+        0xf45e00ad060cdedc, 0xafaa7e7756066251, 0x93b7bd5dd475b437, 0x14f9d84b38a4777f,
+        0xf45e00ad060cdedc, 0xafaa7e7756066251, 0x93b7bd5dd475b437, 0x14f9d84b38a4777f,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0x4815628a7e5849d1, 0x747594f6e2f2c9bc, 0x18ad13de3f2bd01b, 0x2a0c25c59b6fe705,
+        0xcb025b865bac19cd, 0x8089fb701d9ac5bb, 0x0bb28ddbdc03e52f, 0xc25b44bb72a99655,
+        0xcb025b865bac19cd, 0x8089fb701d9ac5bb, 0x0bb28ddbdc03e52f, 0xc25b44bb72a99655,
+        0xcb025b865bac19cd, 0x8089fb701d9ac5bb, 0x0bb28ddbdc03e52f, 0xc25b44bb72a99655,
+        0xcb025b865bac19cd, 0x8089fb701d9ac5bb, 0x0bb28ddbdc03e52f, 0xc25b44bb72a99655,
+        0x4119bea2d42d833d, 0xe0ed2656ea0ce712, 0x0659ddec74c0d09a, 0xd817746fb8725d03,
+        0x4119bea2d42d833d, 0xe0ed2656ea0ce712, 0x0659ddec74c0d09a, 0xd817746fb8725d03,
+        0x4119bea2d42d833d, 0xe0ed2656ea0ce712, 0x0659ddec74c0d09a, 0xd817746fb8725d03,
+        0x4119bea2d42d833d, 0xe0ed2656ea0ce712, 0x0659ddec74c0d09a, 0xd817746fb8725d03,
+    };
+
+    const unsigned w = 37;
+    const unsigned h = 9;
+    RenderBuffer renderBuff;
+    fillPattern(renderBuff, w, h, 4);
+    VariablePixelBuffer floatBuff, float2Buff, float3Buff;
+    floatBuff.init(VariablePixelBuffer::FLOAT, w, h);
+    fillPattern(floatBuff.getFloatBuffer(), w, h, 1);
+    float2Buff.init(VariablePixelBuffer::FLOAT2, w, h);
+    fillPattern(float2Buff.getFloat2Buffer(), w, h, 2);
+    float3Buff.init(VariablePixelBuffer::FLOAT3, w, h);
+    fillPattern(float3Buff.getFloat3Buffer(), w, h, 3);
+
+    using Func = std::function<uint64_t(PixelBufferUtilOptions, float, float)>;
+    auto toRgb = [](const std::function<void(Rgb888Buffer &, PixelBufferUtilOptions, float, float)> &func) {
+        return Func([=](PixelBufferUtilOptions opt, float e, float g) {
+                Rgb888Buffer dst;
+                func(dst, opt, e, g);
+                return hashBuffer(dst);
+            });
+    };
+    using ExtractFunc = void (*)(Rgb888Buffer &, const RenderBuffer &, PixelBufferUtilOptions, float, float);
+    using ExtractVFunc = void (*)(Rgb888Buffer &, const VariablePixelBuffer &, PixelBufferUtilOptions, float, float);
+    auto extract = [&](ExtractFunc func) {
+        return toRgb([&, func](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                func(dst, renderBuff, opt, e, g);
+            });
+    };
+    auto extractV = [&](ExtractVFunc func, const VariablePixelBuffer &src) {
+        return toRgb([&, func](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                func(dst, src, opt, e, g);
+            });
+    };
+
+    std::vector<std::pair<std::string, Func>> funcs = {
+        {"RenderBuffer->Rgb888", toRgb([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                    gammaAndQuantizeTo8bit(dst, renderBuff, opt, e, g);
+                })},
+        {"RenderBuffer->Rgba8888", [&](PixelBufferUtilOptions opt, float e, float g) {
+                Rgba8888Buffer dst;
+                gammaAndQuantizeTo8bit(dst, renderBuff, opt, e, g);
+                return hashBuffer(dst);
+            }},
+    };
+    const std::vector<std::pair<std::string, const VariablePixelBuffer *>> variableBuffs = {
+        {"Float", &floatBuff}, {"Float2", &float2Buff}, {"Float3", &float3Buff},
+    };
+    for (const auto &itr : variableBuffs) {
+        const VariablePixelBuffer &src = *itr.second;
+        funcs.emplace_back(itr.first + "->Rgb888",
+                           toRgb([&](Rgb888Buffer &dst, PixelBufferUtilOptions opt, float e, float g) {
+                                   gammaAndQuantizeTo8bit(dst, src, opt, e, g);
+                               }));
+    }
+    const std::vector<std::tuple<std::string, ExtractFunc, ExtractVFunc>> extractFuncs = {
+        {"extractRedChannel", extractRedChannel, extractRedChannel},
+        {"extractGreenChannel", extractGreenChannel, extractGreenChannel},
+        {"extractBlueChannel", extractBlueChannel, extractBlueChannel},
+        {"extractLuminance", extractLuminance, extractLuminance},
+    };
+    for (const auto &itr : extractFuncs) {
+        funcs.emplace_back(std::get<0>(itr) + "(RenderBuffer)", extract(std::get<1>(itr)));
+        for (const auto &vItr : variableBuffs) {
+            funcs.emplace_back(std::get<0>(itr) + "(" + vItr.first + ")", extractV(std::get<2>(itr), *vItr.second));
+        }
+    }
+
+    size_t id = 0;
+    bool result = true;
+    for (const auto &func : funcs) {
+        for (PixelBufferUtilOptions options = 0; options < 4; ++options) { // APPLY_GAMMA x NORMALIZE
+            for (float exposure : {0.0f, 0.5f}) {
+                for (float gamma : {1.0f, 2.2f}) {
+                    CPPUNIT_ASSERT(id < sizeof(sReference) / sizeof(sReference[0]));
+                    for (PixelBufferUtilOptions simd : {PixelBufferUtilOptions(0), sNoSimd}) {
+                        const uint64_t hash = func.second(options | simd, exposure, gamma);
+                        if (hash != sReference[id]) {
+                            std::cerr << func.first << " options:0x" << std::hex << (options | simd)
+                                      << " exposure:" << std::dec << exposure << " gamma:" << gamma
+                                      << " hash:0x" << std::hex << hash << std::dec << '\n';
+                            result = false;
+                        }
+                    }
+                    ++id;
+                }
+            }
+        }
+    }
+    CPPUNIT_ASSERT(id == sizeof(sReference) / sizeof(sReference[0]));
+    CPPUNIT_ASSERT(result);
+}
+
+void
+TestPixelBufferUtilsGamma8bit::testBenchmark()
+{
+    const unsigned w = 3840;
+    const unsigned h = 2160;
+    const int loopMax = 8;
+
+    RenderBuffer renderBuff;
+    fillRandom(renderBuff, w, h, 4, false);
+    VariablePixelBuffer floatBuff, float3Buff;
+    floatBuff.init(VariablePixelBuffer::FLOAT, w, h);
+    fillRandom(floatBuff.getFloatBuffer(), w, h, 1, false);
+    float3Buff.init(VariablePixelBuffer::FLOAT3, w, h);
+    fillRandom(float3Buff.getFloat3Buffer(), w, h, 3, false);
+
+    Rgb888Buffer rgb;
+    Rgba8888Buffer rgba;
+    rec_time::RecTime recTime;
+    auto timeIt = [&](const std::function<void(PixelBufferUtilOptions)> &func, PixelBufferUtilOptions options) {
+        func(options);      // warm up
+        recTime.start();
+        for (int loop = 0; loop < loopMax; ++loop) func(options);
+        return recTime.end() / static_cast<float>(loopMax) * 1000.0f; // millisec
+    };
+
+    const PixelBufferUtilOptions gamma = PIXEL_BUFFER_UTIL_OPTIONS_APPLY_GAMMA;
+    const PixelBufferUtilOptions parallel = PIXEL_BUFFER_UTIL_OPTIONS_PARALLEL;
+    const std::vector<std::pair<std::string, std::function<void(PixelBufferUtilOptions)>>> formats = {
+        {"RenderBuffer->Rgb888  ", [&](PixelBufferUtilOptions opt) { gammaAndQuantizeTo8bit(rgb, renderBuff, opt, 0.f, 1.f); }},
+        {"RenderBuffer->Rgba8888", [&](PixelBufferUtilOptions opt) { gammaAndQuantizeTo8bit(rgba, renderBuff, opt, 0.f, 1.f); }},
+        {"Float->Rgb888         ", [&](PixelBufferUtilOptions opt) { gammaAndQuantizeTo8bit(rgb, floatBuff, opt, 0.f, 1.f); }},
+        {"Float3->Rgb888        ", [&](PixelBufferUtilOptions opt) { gammaAndQuantizeTo8bit(rgb, float3Buff, opt, 0.f, 1.f); }},
+        {"extractRedChannel     ", [&](PixelBufferUtilOptions opt) { extractRedChannel(rgb, renderBuff, opt, 0.f, 1.f); }},
+        {"extractLuminance      ", [&](PixelBufferUtilOptions opt) { extractLuminance(rgb, renderBuff, opt, 0.f, 1.f); }},
+    };
+
+    std::cerr << "\n>> TestPixelBufferUtilsGamma8bit " << w << 'x' << h << " (ms)\n";
+    for (const auto &itr : formats) {
+        const float scalar = timeIt(itr.second, gamma | sNoSimd);
+        const float simd = timeIt(itr.second, gamma);
+        const float simdParallel = timeIt(itr.second, gamma | parallel);
+        std::cerr << "   " << itr.first
+                  << " scalar:" << scalar << " SIMD:" << simd << " SIMD+parallel:" << simdParallel
+                  << " (" << static_cast<float>(w) * h / (simdParallel * 1000.0f) << " Mpix/s)\n";
+    }
+}
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,40 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+class TestPixelBufferUtilsGamma8bit : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    // SIMD kernels return the same result as scalar code
+    void testGammaAndQuantize();
+    void testExtractChannel();
+
+    // result is the same as the code before the SIMD kernels
+    void testReference();
+
+    // throughput of each format at 4K resolution
+    void testBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestPixelBufferUtilsGamma8bit);
+    CPPUNIT_TEST(testGammaAndQuantize);
+    CPPUNIT_TEST(testExtractChannel);
+    CPPUNIT_TEST(testReference);
+    CPPUNIT_TEST(testBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -4,6 +4,13 @@
 
 #include "TestRunningStats.h"
 #include <scene_rdl2/common/fb_util/RunningStats.h>
+#include <scene_rdl2/common/fb_util/RunningStatsTiledBuffer.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
 
 namespace scene_rdl2 {
 namespace fb_util {
@@ -32,6 +39,279 @@ TestRunningStats::testRunningStats()
     CPPUNIT_ASSERT_DOUBLES_EQUAL(0.825, stats.mean(), 0.00001);
 }
 
+void
+TestRunningStats::testCombine()
+{
+    const std::vector<double> data = {0.2, 0.3, 0.9, 1.9, -0.7, 4.1, 2.2};
+
+    RunningStatsLightWeight<double> all;
+    for (double d : data) all.push(d);
+
+    for (size_t split = 0; split <= data.size(); ++split) {
+        RunningStatsLightWeight<double> a, b;
+        for (size_t i = 0; i < split; ++i) a.push(data[i]);
+        for (size_t i = split; i < data.size(); ++i) b.push(data[i]);
+        a += b;
+
+        CPPUNIT_ASSERT_EQUAL(all.numDataValues(), a.numDataValues());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(all.mean(), a.mean(), 0.00001);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(all.variance(), a.variance(), 0.00001);
+    }
+}
+
+namespace {
+
+void
+fillTileValues(std::mt19937 &rng, std::vector<float> &val)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 4.0f);
+    for (float &v : val) v = dist(rng);
+}
+
+uint64_t
+tileMask(const RunningStatsTiledBuffer &buff, const unsigned tileId, const uint64_t mask)
+// clip mask by original resolution
+{
+    const unsigned numTilesX = buff.getAlignedWidth() >> 3;
+    const unsigned x0 = (tileId % numTilesX) << 3;
+    const unsigned y0 = (tileId / numTilesX) << 3;
+    uint64_t result = 0x0;
+    for (unsigned pixId = 0; pixId < 64; ++pixId) {
+        if (x0 + (pixId & 7) < buff.getWidth() && y0 + (pixId >> 3) < buff.getHeight()) {
+            result |= (static_cast<uint64_t>(0x1) << pixId);
+        }
+    }
+    return result & mask;
+}
+
+void
+pushRef(PixelBuffer<RunningStatsLightWeight<math::Vec3f>> &ref,
+        const RunningStatsTiledBuffer &buff,
+        const unsigned tileId,
+        const std::vector<float> &val,
+        const uint64_t mask)
+// push same tile values to non tiled RunningStatsLightWeight buffer
+{
+    const unsigned numTilesX = buff.getAlignedWidth() >> 3;
+    for (unsigned pixId = 0; pixId < 64; ++pixId) {
+        if (!(mask & (static_cast<uint64_t>(0x1) << pixId))) continue;
+        const unsigned x = ((tileId % numTilesX) << 3) + (pixId & 7);
+        const unsigned y = ((tileId / numTilesX) << 3) + (pixId >> 3);
+        ref.getPixel(x, y).push(math::Vec3f(val[pixId], val[64 + pixId], val[128 + pixId]));
+    }
+}
+
+bool
+compareStats(const PixelBuffer<RunningStatsLightWeight<math::Vec3f>> &ref,
+             const RunningStatsTiledBuffer &buff)
+{
+    for (unsigned y = 0; y < ref.getHeight(); ++y) {
+        for (unsigned x = 0; x < ref.getWidth(); ++x) {
+            const RunningStatsLightWeight<math::Vec3f> &pix = ref.getPixel(x, y);
+            if (pix.numDataValues() != buff.numDataValues(x, y)) return false;
+            for (unsigned chan = 0; chan < 3; ++chan) {
+                if (std::abs(pix.mean()[chan] - buff.mean(x, y, chan)) > 0.0001f ||
+                    std::abs(pix.variance()[chan] - buff.variance(x, y, chan)) > 0.001f) {
+                    std::cerr << "x:" << x << " y:" << y << " chan:" << chan
+                              << " ref:" << pix.show()
+                              << " mean:" << buff.mean(x, y, chan)
+                              << " variance:" << buff.variance(x, y, chan) << '\n';
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void
+TestRunningStats::testTiledBuffer()
+{
+    const unsigned w = 37;      // not tile aligned
+    const unsigned h = 21;
+
+    PixelBuffer<RunningStatsLightWeight<math::Vec3f>> refA, refB;
+    refA.init(w, h);
+    refB.init(w, h);
+    refA.clear();
+    refB.clear();
+
+    RunningStatsTiledBuffer a, aSISD, b;
+    for (RunningStatsTiledBuffer *buff : {&a, &aSISD, &b}) {
+        buff->init(w, h, 3);
+        buff->clear();
+    }
+    CPPUNIT_ASSERT(a.getAlignedWidth() == 40 && a.getAlignedHeight() == 24);
+
+    std::mt19937 rng(1234);
+    std::vector<float> val(64 * 3);
+    for (int sample = 0; sample < 24; ++sample) {
+        for (unsigned tileId = 0; tileId < a.getNumTiles(); ++tileId) {
+            const uint64_t mask = tileMask(a, tileId, (static_cast<uint64_t>(rng()) << 32) | rng());
+            fillTileValues(rng, val);
+            a.pushTile(tileId, val.data(), mask);
+            aSISD.pushTile_SISD(tileId, val.data(), mask);
+            pushRef(refA, a, tileId, val, mask);
+
+            const uint64_t maskB = tileMask(b, tileId, (sample % 3) ? ~static_cast<uint64_t>(0x0) : 0x0);
+            fillTileValues(rng, val);
+            b.pushTile(tileId, val.data(), maskB);
+            pushRef(refB, b, tileId, val, maskB);
+        }
+    }
+    CPPUNIT_ASSERT(compareStats(refA, a));
+    CPPUNIT_ASSERT(compareStats(refA, aSISD));
+    CPPUNIT_ASSERT(compareStats(refB, b));
+
+    // snapshot : only updated pixels are copied
+    RunningStatsTiledBuffer snapshot;
+    snapshot.init(w, h, 3);
+    snapshot.clear();
+    for (unsigned tileId = 0; tileId < a.getNumTiles(); ++tileId) {
+        CPPUNIT_ASSERT(snapshot.snapshotTile(tileId, a) == tileMask(a, tileId, ~static_cast<uint64_t>(0x0)));
+    }
+    CPPUNIT_ASSERT(compareStats(refA, snapshot));
+
+    // parallel Welford merge
+    for (unsigned y = 0; y < h; ++y) {
+        for (unsigned x = 0; x < w; ++x) {
+            refA.getPixel(x, y) += refB.getPixel(x, y);
+        }
+    }
+    a += b;
+    for (unsigned tileId = 0; tileId < aSISD.getNumTiles(); ++tileId) {
+        aSISD.combineTile_SISD(tileId, b, ~static_cast<uint64_t>(0x0));
+    }
+    CPPUNIT_ASSERT(compareStats(refA, a));
+    CPPUNIT_ASSERT(compareStats(refA, aSISD));
+
+    // conversion from/to RunningStatsLightWeight buffer
+    PixelBuffer<RunningStatsLightWeight<math::Vec3f>> conv;
+    a.toPixelBuffer(conv);
+    RunningStatsTiledBuffer c;
+    c.fromPixelBuffer(refA);
+    CPPUNIT_ASSERT(compareStats(conv, c));
+
+    PixelBuffer<float> variance;
+    a.extractVariance(variance);
+    for (unsigned y = 0; y < h; ++y) {
+        for (unsigned x = 0; x < w; ++x) {
+            const math::Vec3f v = refA.getPixel(x, y).variance();
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(std::max(v[0], std::max(v[1], v[2])), variance.getPixel(x, y), 0.001);
+        }
+    }
+}
+
+void
+TestRunningStats::testTypedPush()
+{
+    const unsigned w = 37;
+    const unsigned h = 21;
+
+    RunningStatsTiledBuffer buff;
+    buff.init(w, h, 3);
+    buff.clear();
+
+    PixelBuffer<RunningStatsLightWeight<math::Vec3f>> ref;
+    ref.init(w, h);
+    ref.clear();
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1.0f, 4.0f);
+    for (int i = 0; i < 4; ++i) {
+        for (unsigned y = 0; y < h; ++y) {
+            for (unsigned x = 0; x < w; ++x) {
+                const math::Vec3f v(dist(rng), dist(rng), dist(rng));
+                buff.push(x, y, v);
+                ref.getPixel(x, y).push(v);
+            }
+        }
+    }
+    CPPUNIT_ASSERT(compareStats(ref, buff));
+
+    RunningStatsTiledBuffer single;
+    single.init(w, h, 1);
+    single.clear();
+    single.push(0u, 0u, 1.0f);
+    single.push(0u, 0u, 3.0f);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, single.variance(0, 0, 0), 0.00001);
+}
+
+void
+TestRunningStats::testTiledBufferBenchmark()
+{
+    const unsigned w = 1920;
+    const unsigned h = 1080;
+    const int loopMax = 16;
+
+    PixelBuffer<RunningStatsLightWeight<math::Vec3f>> aos, aos2;
+    aos.init(w, h);
+    aos2.init(w, h);
+    aos.clear();
+    aos2.clear();
+    RunningStatsTiledBuffer soa, soa2;
+    soa.init(w, h, 3);
+    soa2.init(w, h, 3);
+    soa.clear();
+    soa2.clear();
+
+    std::mt19937 rng(5678);
+    std::vector<float> val(64 * 3);
+    fillTileValues(rng, val);
+
+    rec_time::RecTime recTime;
+    auto timeIt = [&](const std::function<void()> &func) {
+        recTime.start();
+        for (int loop = 0; loop < loopMax; ++loop) func();
+        return recTime.end() / static_cast<float>(loopMax) * 1000.0f; // millisec
+    };
+
+    const float pushAoS = timeIt([&] {
+            for (unsigned y = 0; y < h; ++y) {
+                for (unsigned x = 0; x < w; ++x) {
+                    const unsigned pixId = ((y & 7) << 3) + (x & 7);
+                    aos.getPixel(x, y).push(math::Vec3f(val[pixId], val[64 + pixId], val[128 + pixId]));
+                }
+            }
+        });
+    const float pushSISD = timeIt([&] {
+            for (unsigned tileId = 0; tileId < soa.getNumTiles(); ++tileId) {
+                soa.pushTile_SISD(tileId, val.data(), ~static_cast<uint64_t>(0x0));
+            }
+        });
+    const float pushAVX = timeIt([&] {
+            for (unsigned tileId = 0; tileId < soa.getNumTiles(); ++tileId) {
+                soa.pushTile(tileId, val.data(), ~static_cast<uint64_t>(0x0));
+            }
+        });
+    const float combineAoS = timeIt([&] {
+            for (unsigned y = 0; y < h; ++y) {
+                for (unsigned x = 0; x < w; ++x) {
+                    aos2.getPixel(x, y) += aos.getPixel(x, y);
+                }
+            }
+        });
+    const float combineSISD = timeIt([&] {
+            for (unsigned tileId = 0; tileId < soa.getNumTiles(); ++tileId) {
+                soa2.combineTile_SISD(tileId, soa, ~static_cast<uint64_t>(0x0));
+            }
+        });
+    const float combineAVX = timeIt([&] {
+            for (unsigned tileId = 0; tileId < soa.getNumTiles(); ++tileId) {
+                soa2.combineTile(tileId, soa, ~static_cast<uint64_t>(0x0));
+            }
+        });
+
+    std::cerr << "\n>> TestRunningStats Vec3f " << w << 'x' << h
+              << " memory AoS:" << (static_cast<size_t>(aos.getArea()) *
+                                    sizeof(RunningStatsLightWeight<math::Vec3f>)) / 1024 << " KB"
+              << " SoA:" << soa.getMemoryUsage() / 1024 << " KB\n"
+              << "   push    AoS:" << pushAoS << " ms SISD:" << pushSISD << " ms AVX2:" << pushAVX << " ms\n"
+              << "   combine AoS:" << combineAoS << " ms SISD:" << combineSISD << " ms AVX2:" << combineAVX << " ms\n";
+}
+
 } // namespace unittest
 } // namespace fb_util
 } // namespace scene_rdl2
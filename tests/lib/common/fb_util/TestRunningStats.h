@@ -18,9 +18,17 @@ public:
     void tearDown();
 
     void testRunningStats();
+    void testCombine();
+    void testTiledBuffer();
+    void testTypedPush();
+    void testTiledBufferBenchmark();
 
     CPPUNIT_TEST_SUITE(TestRunningStats);
     CPPUNIT_TEST(testRunningStats);
+    CPPUNIT_TEST(testCombine);
+    CPPUNIT_TEST(testTiledBuffer);
+    CPPUNIT_TEST(testTypedPush);
+    CPPUNIT_TEST(testTiledBufferBenchmark);
     CPPUNIT_TEST_SUITE_END();
 };
 
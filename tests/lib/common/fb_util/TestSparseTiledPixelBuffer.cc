@@ -0,0 +1,176 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestSparseTiledPixelBuffer.h"
+#include <scene_rdl2/common/fb_util/DirtyTileTracker.h>
+#include <scene_rdl2/common/fb_util/SparseTiledPixelBuffer.h>
+#include <scene_rdl2/common/fb_util/VariablePixelBuffer.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+namespace {
+
+void
+fillRandom(VariablePixelBuffer &buff, VariablePixelBuffer::Format format, unsigned w, unsigned h)
+{
+    buff.init(format, w, h);
+    std::mt19937 rng(w + h * 7 + static_cast<unsigned>(format));
+    uint8_t *data = buff.getData();
+    const size_t size = static_cast<size_t>(buff.getArea()) * buff.getSizeOfPixel();
+    for (size_t i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(rng());
+}
+
+// every 3rd tile plus the last tile in random order
+std::vector<Tile>
+sparseTiles(unsigned w, unsigned h)
+{
+    std::vector<Tile> tiles;
+    unsigned tileId = 0;
+    for (unsigned y = 0; y < h; y += 8) {
+        for (unsigned x = 0; x < w; x += 8, ++tileId) {
+            if (tileId % 3 == 0 || (x + 8 == w && y + 8 == h)) tiles.emplace_back(x, x + 8, y, y + 8);
+        }
+    }
+    std::shuffle(tiles.begin(), tiles.end(), std::mt19937(w));
+    return tiles;
+}
+
+// reference implementation : original serial loop
+void
+packReference(uint8_t *dst, const VariablePixelBuffer &src, const std::vector<Tile> &tiles)
+{
+    const Tiler tiler(src.getWidth(), src.getHeight());
+    const size_t tileBytes = src.getSizeOfPixel() * 64;
+    for (const Tile &tile : tiles) {
+        const unsigned ofs = tiler.linearCoordsToCoarseTileOffset(tile.mMinX, tile.mMinY);
+        std::memcpy(dst, src.getData() + ofs * src.getSizeOfPixel(), tileBytes);
+        dst += tileBytes;
+    }
+}
+
+} // namespace
+
+void
+TestSparseTiledPixelBuffer::setUp()
+{
+}
+
+void
+TestSparseTiledPixelBuffer::tearDown()
+{
+}
+
+void
+TestSparseTiledPixelBuffer::testPackUnpack()
+{
+    // 1024x1024 FLOAT4 exceeds sNonTemporalCopyThreshold and uses non-temporal stores.
+    for (unsigned size : {16u, 200u, 1024u}) {
+        for (VariablePixelBuffer::Format format : {VariablePixelBuffer::RGB888,
+                                                   VariablePixelBuffer::FLOAT,
+                                                   VariablePixelBuffer::FLOAT3,
+                                                   VariablePixelBuffer::FLOAT4}) {
+            VariablePixelBuffer src;
+            fillRandom(src, format, size, size);
+            const std::vector<Tile> tiles = sparseTiles(size, size);
+            const size_t packedSize = tiles.size() * 64 * src.getSizeOfPixel();
+
+            // +1 byte offset in order to test unaligned packed buffer
+            std::vector<uint8_t> reference(packedSize), packed(packedSize + 1);
+            packReference(reference.data(), src, tiles);
+            for (bool parallel : {false, true}) {
+                CPPUNIT_ASSERT(src.packSparseTiles(packed.data() + 1, tiles, parallel));
+                CPPUNIT_ASSERT(std::memcmp(packed.data() + 1, reference.data(), packedSize) == 0);
+
+                VariablePixelBuffer dst;
+                dst.init(format, size, size);
+                std::memcpy(dst.getData(), src.getData(), src.getArea() * src.getSizeOfPixel());
+                for (const Tile &tile : tiles) { // destroy tiles which are restored by unpack
+                    const unsigned ofs = Tiler(size, size).linearCoordsToCoarseTileOffset(tile.mMinX, tile.mMinY);
+                    std::memset(dst.getData() + ofs * src.getSizeOfPixel(), 0x0, 64 * src.getSizeOfPixel());
+                }
+                CPPUNIT_ASSERT(dst.unpackSparseTiles(reference.data(), tiles, parallel));
+                CPPUNIT_ASSERT(std::memcmp(dst.getData(), src.getData(),
+                                           src.getArea() * src.getSizeOfPixel()) == 0);
+            }
+        }
+    }
+}
+
+void
+TestSparseTiledPixelBuffer::testDirtyTileTracker()
+{
+    DirtyTileTracker tracker;
+    tracker.init(100, 75);      // 13 x 10 tiles, not multiple of 64 tiles
+    CPPUNIT_ASSERT(tracker.getNumTiles() == 130);
+    CPPUNIT_ASSERT(tracker.getNumDirtyTiles() == 0);
+
+    tracker.markPixel(99, 74);  // last tile
+    tracker.markPixel(0, 0);
+    tracker.markPixel(7, 7);    // same tile
+    tracker.markRegion(10, 20, 10, 12); // tile (1,1) and (2,1)
+
+    std::vector<Tile> tiles;
+    tracker.extractDirtyTiles(tiles);
+    CPPUNIT_ASSERT(tiles.size() == 4);
+    CPPUNIT_ASSERT(tiles[0] == Tile(0, 8, 0, 8));
+    CPPUNIT_ASSERT(tiles[1] == Tile(8, 16, 8, 16));
+    CPPUNIT_ASSERT(tiles[2] == Tile(16, 24, 8, 16));
+    CPPUNIT_ASSERT(tiles[3] == Tile(96, 100, 72, 75)); // clipped by original resolution
+    CPPUNIT_ASSERT(tracker.getNumDirtyTiles() == 0);
+
+    tracker.markAll();
+    CPPUNIT_ASSERT(tracker.getNumDirtyTiles() == 130);
+    std::vector<unsigned> tileIds;
+    tracker.extractDirtyTileIds(tileIds);
+    CPPUNIT_ASSERT(tileIds.size() == 130);
+    for (unsigned i = 0; i < 130; ++i) CPPUNIT_ASSERT(tileIds[i] == i);
+
+    tracker.extractDirtyTileIds(tileIds);
+    CPPUNIT_ASSERT(tileIds.empty());
+}
+
+void
+TestSparseTiledPixelBuffer::testBenchmark()
+{
+    // 4K FLOAT4 buffer, every 3rd tile is dirty.
+    const unsigned w = 3840;
+    const unsigned h = 2160;
+    const int loopMax = 16;
+
+    VariablePixelBuffer src;
+    fillRandom(src, VariablePixelBuffer::FLOAT4, w, h);
+    const std::vector<Tile> tiles = sparseTiles(w, h);
+    std::vector<uint8_t> packed(tiles.size() * 64 * src.getSizeOfPixel());
+
+    rec_time::RecTime recTime;
+    auto timeIt = [&](const std::function<void()> &func) {
+        func();                 // warm up
+        recTime.start();
+        for (int loop = 0; loop < loopMax; ++loop) func();
+        return recTime.end() / static_cast<float>(loopMax) * 1000.0f; // millisec
+    };
+
+    const float reference = timeIt([&]() { packReference(packed.data(), src, tiles); });
+    const float serial = timeIt([&]() { src.packSparseTiles(packed.data(), tiles, false); });
+    const float parallel = timeIt([&]() { src.packSparseTiles(packed.data(), tiles, true); });
+    const float unpackParallel = timeIt([&]() { src.unpackSparseTiles(packed.data(), tiles, true); });
+
+    std::cerr << "\n>> TestSparseTiledPixelBuffer " << w << 'x' << h << " FLOAT4 "
+              << tiles.size() << " tiles (" << packed.size() / 1024 / 1024 << " MByte)\n"
+              << "   pack reference:" << reference << " ms serial:" << serial << " ms parallel:" << parallel
+              << " ms unpack parallel:" << unpackParallel << " ms\n";
+}
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,33 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+class TestSparseTiledPixelBuffer : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    void testPackUnpack();      // serial, parallel and non-temporal copy
+    void testDirtyTileTracker();
+    void testBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestSparseTiledPixelBuffer);
+    CPPUNIT_TEST(testPackUnpack);
+    CPPUNIT_TEST(testDirtyTileTracker);
+    CPPUNIT_TEST(testBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
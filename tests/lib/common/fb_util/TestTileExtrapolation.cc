@@ -0,0 +1,179 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestTileExtrapolation.h"
+#include <scene_rdl2/common/fb_util/TileExtrapolation.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <tbb/parallel_for.h>
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+namespace {
+
+uint64_t
+latticeMask(int step, int offX, int offY)
+{
+    uint64_t mask = 0x0;
+    for (int y = offY; y < 8; y += step) {
+        for (int x = offX; x < 8; x += step) mask |= static_cast<uint64_t>(0x1) << ((y << 3) + x);
+    }
+    return mask;
+}
+
+uint64_t
+randomMask(std::mt19937_64 &rng)
+{
+    const int activeTotal = 1 + static_cast<int>(rng() % 40);
+    uint64_t mask = 0x0;
+    for (int i = 0; i < activeTotal; ++i) mask |= static_cast<uint64_t>(0x1) << (rng() & 63);
+    return mask;
+}
+
+// Tile masks of a progressive frame sequence : coarse pass 1/4/16 pixels lattice, then fine pass
+// with random partial tiles and full tiles.
+std::vector<uint64_t>
+progressiveMasks(size_t tileTotal)
+{
+    std::mt19937_64 rng(1234);
+    std::vector<uint64_t> masks;
+    masks.reserve(tileTotal * 5);
+    for (int step : {8, 4, 2}) {
+        for (size_t i = 0; i < tileTotal; ++i) masks.push_back(latticeMask(step, 0, 0));
+    }
+    for (size_t i = 0; i < tileTotal; ++i) masks.push_back((i % 8 == 0) ? randomMask(rng) : ~static_cast<uint64_t>(0x0));
+    for (size_t i = 0; i < tileTotal; ++i) masks.push_back(randomMask(rng));
+    return masks;
+}
+
+bool
+isSameResult(const TileExtrapolation &tileExtrapolation, const uint64_t mask)
+{
+    int ref[64], cached[64];
+    tileExtrapolation.searchActiveNearestPixel(mask, ref);
+    tileExtrapolation.searchActiveNearestPixelCached(mask, cached);
+    return std::memcmp(ref, cached, sizeof(ref)) == 0;
+}
+
+} // namespace
+
+void
+TestTileExtrapolation::setUp()
+{
+}
+
+void
+TestTileExtrapolation::tearDown()
+{
+}
+
+void
+TestTileExtrapolation::testCachedResult()
+{
+    TileExtrapolation tileExtrapolation;
+
+    CPPUNIT_ASSERT(isSameResult(tileExtrapolation, ~static_cast<uint64_t>(0x0)));
+    for (int step : {8, 4, 2}) {
+        for (int offY = 0; offY < step; ++offY) {
+            for (int offX = 0; offX < step; ++offX) {
+                CPPUNIT_ASSERT(isSameResult(tileExtrapolation, latticeMask(step, offX, offY)));
+            }
+        }
+    }
+    for (int pixId = 0; pixId < 64; ++pixId) {
+        CPPUNIT_ASSERT(isSameResult(tileExtrapolation, static_cast<uint64_t>(0x1) << pixId));
+    }
+
+    // random masks twice : the 1st is miss and the 2nd might hit
+    std::mt19937_64 rng(5678);
+    std::vector<uint64_t> masks(4096);
+    for (uint64_t &mask : masks) mask = randomMask(rng);
+    for (int loop = 0; loop < 2; ++loop) {
+        for (uint64_t mask : masks) CPPUNIT_ASSERT(isSameResult(tileExtrapolation, mask));
+    }
+}
+
+void
+TestTileExtrapolation::testCachedResultMT()
+{
+    // Many threads update and read the same cache entries at the same time.
+    TileExtrapolation tileExtrapolation;
+    std::mt19937_64 rng(9012);
+    std::vector<uint64_t> masks(256);
+    for (uint64_t &mask : masks) mask = randomMask(rng);
+
+    std::atomic<unsigned> errorTotal {0};
+    tbb::parallel_for(0, 200000, [&](int i) {
+            const uint64_t mask = masks[(i * 7) % masks.size()];
+            if (!isSameResult(tileExtrapolation, mask)) errorTotal.fetch_add(1);
+        });
+    CPPUNIT_ASSERT(errorTotal == 0);
+}
+
+void
+TestTileExtrapolation::testCacheStats()
+{
+    TileExtrapolation tileExtrapolation;
+    int pixIdArray[64];
+
+    tileExtrapolation.searchActiveNearestPixelCached(0x3, pixIdArray); // not counted yet
+    CPPUNIT_ASSERT(tileExtrapolation.getCacheMiss() == 0);
+
+    tileExtrapolation.setCacheStats(true);
+    tileExtrapolation.searchActiveNearestPixelCached(~static_cast<uint64_t>(0x0), pixIdArray);
+    tileExtrapolation.searchActiveNearestPixelCached(latticeMask(2, 1, 1), pixIdArray);
+    tileExtrapolation.searchActiveNearestPixelCached(0x10, pixIdArray);
+    tileExtrapolation.searchActiveNearestPixelCached(0x3, pixIdArray); // cached before
+    tileExtrapolation.searchActiveNearestPixelCached(0x7, pixIdArray);
+    tileExtrapolation.searchActiveNearestPixelCached(0x7, pixIdArray);
+    CPPUNIT_ASSERT(tileExtrapolation.getCachePresetHit() == 3);
+    CPPUNIT_ASSERT(tileExtrapolation.getCacheHit() == 2);
+    CPPUNIT_ASSERT(tileExtrapolation.getCacheMiss() == 1);
+
+    tileExtrapolation.resetCacheStats();
+    CPPUNIT_ASSERT(tileExtrapolation.getCachePresetHit() + tileExtrapolation.getCacheHit() +
+                   tileExtrapolation.getCacheMiss() == 0);
+}
+
+void
+TestTileExtrapolation::testBenchmark()
+{
+    // 4K frame (130K tiles) x 5 snapshots
+    TileExtrapolation tileExtrapolation;
+    const std::vector<uint64_t> masks = progressiveMasks(480 * 270);
+    int pixIdArray[64];
+    volatile int sink = 0;
+
+    rec_time::RecTime recTime;
+    recTime.start();
+    for (uint64_t mask : masks) {
+        tileExtrapolation.searchActiveNearestPixel(mask, pixIdArray);
+        sink = sink + pixIdArray[63];
+    }
+    const float search = recTime.end() * 1000.0f;
+
+    tileExtrapolation.setCacheStats(true);
+    recTime.start();
+    for (uint64_t mask : masks) {
+        tileExtrapolation.searchActiveNearestPixelCached(mask, pixIdArray);
+        sink = sink + pixIdArray[63];
+    }
+    const float cached = recTime.end() * 1000.0f;
+
+    std::cerr << "\n>> TestTileExtrapolation " << masks.size() << " tiles search:" << search
+              << " ms cached:" << cached << " ms\n"
+              << tileExtrapolation.showCacheStats() << '\n';
+}
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,35 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+class TestTileExtrapolation : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    void testCachedResult();    // cached result is same as non cached search
+    void testCachedResultMT();
+    void testCacheStats();
+    void testBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestTileExtrapolation);
+    CPPUNIT_TEST(testCachedResult);
+    CPPUNIT_TEST(testCachedResultMT);
+    CPPUNIT_TEST(testCacheStats);
+    CPPUNIT_TEST(testBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
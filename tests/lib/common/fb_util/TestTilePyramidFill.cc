@@ -0,0 +1,234 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestTilePyramidFill.h"
+#include <scene_rdl2/common/fb_util/FbTypes.h>
+#include <scene_rdl2/common/fb_util/TilePyramidFill.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+namespace {
+
+RenderColor
+groundTruth(unsigned sx, unsigned sy, unsigned w, unsigned h)
+{
+    const float u = static_cast<float>(sx) / static_cast<float>(w);
+    const float v = static_cast<float>(sy) / static_cast<float>(h);
+    return RenderColor(u, v, 0.5f + 0.5f * std::sin(u * 6.0f) * std::cos(v * 4.0f), 1.0f);
+}
+
+// Tiled buffer which only has ground truth values on the active tiles (tileX % step == 0 &&
+// tileY % step == 0). Other tiles are black.
+void
+setupSparseImage(unsigned w, unsigned h, unsigned step, ActivePixels &activePixels, RenderBuffer &buff)
+{
+    activePixels.init(w, h);
+    activePixels.reset();
+    buff.init(activePixels.getAlignedWidth(), activePixels.getAlignedHeight());
+    buff.clear();
+    for (unsigned tileY = 0; tileY < activePixels.getNumTilesY(); ++tileY) {
+        for (unsigned tileX = 0; tileX < activePixels.getNumTilesX(); ++tileX) {
+            if (tileX % step || tileY % step) continue;
+            const unsigned tileId = tileY * activePixels.getNumTilesX() + tileX;
+            activePixels.setTileMask(tileId, ~static_cast<uint64_t>(0x0));
+            for (unsigned pixId = 0; pixId < 64; ++pixId) {
+                buff.getData()[(tileId << 6) + pixId] =
+                    groundTruth((tileX << 3) + (pixId & 7), (tileY << 3) + (pixId >> 3), w, h);
+            }
+        }
+    }
+}
+
+// PixelBuffer copy shares the pixel data. These keep a separate copy of the pixels.
+std::vector<RenderColor>
+copyPixels(const RenderBuffer &buff)
+{
+    return std::vector<RenderColor>(buff.getData(), buff.getData() + buff.getArea());
+}
+
+void
+restorePixels(const std::vector<RenderColor> &pixels, RenderBuffer &buff)
+{
+    std::copy(pixels.begin(), pixels.end(), buff.getData());
+}
+
+// RMS error against the ground truth over the inactive tiles
+float
+inactiveRmsError(const ActivePixels &activePixels, const RenderBuffer &buff, unsigned w, unsigned h)
+{
+    double sum = 0.0;
+    size_t total = 0;
+    for (unsigned tileId = 0; tileId < activePixels.getNumTiles(); ++tileId) {
+        if (activePixels.getTileMask(tileId)) continue;
+        const unsigned tileX = tileId % activePixels.getNumTilesX();
+        const unsigned tileY = tileId / activePixels.getNumTilesX();
+        for (unsigned pixId = 0; pixId < 64; ++pixId) {
+            const RenderColor truth =
+                groundTruth((tileX << 3) + (pixId & 7), (tileY << 3) + (pixId >> 3), w, h);
+            const RenderColor &c = buff.getData()[(tileId << 6) + pixId];
+            for (int i = 0; i < 3; ++i) sum += (c[i] - truth[i]) * (c[i] - truth[i]);
+            total += 3;
+        }
+    }
+    return static_cast<float>(std::sqrt(sum / static_cast<double>(total)));
+}
+
+} // namespace
+
+void
+TestTilePyramidFill::setUp()
+{
+}
+
+void
+TestTilePyramidFill::tearDown()
+{
+}
+
+void
+TestTilePyramidFill::testPushPull()
+{
+    {
+        // single valid cell is propagated to all cells
+        std::vector<float> val(5 * 3, 0.0f);
+        std::vector<char> valid(5 * 3, 0);
+        val[7] = 2.0f;
+        valid[7] = 1;
+        TilePyramidFill::pushPull(5, 3, 1, val, valid);
+        for (size_t i = 0; i < val.size(); ++i) {
+            CPPUNIT_ASSERT(valid[i] && val[i] == 2.0f);
+        }
+    }
+    {
+        // filled values are between 2 valid cells and keep the order
+        std::vector<float> val(9, 0.0f);
+        std::vector<char> valid(9, 0);
+        val[0] = 0.0f; valid[0] = 1;
+        val[8] = 1.0f; valid[8] = 1;
+        TilePyramidFill::pushPull(9, 1, 1, val, valid);
+        CPPUNIT_ASSERT(val[0] == 0.0f && val[8] == 1.0f);
+        for (size_t i = 1; i < val.size(); ++i) {
+            CPPUNIT_ASSERT(valid[i] && val[i - 1] <= val[i] && val[i] <= 1.0f);
+        }
+    }
+}
+
+void
+TestTilePyramidFill::testQuality()
+{
+    const unsigned w = 250;     // not tile aligned
+    const unsigned h = 180;
+    ActivePixels activePixels;
+    RenderBuffer buff;
+
+    for (unsigned step : {2, 3, 5}) {
+        setupSparseImage(w, h, step, activePixels, buff);
+        const std::vector<RenderColor> org = copyPixels(buff);
+        const float blackError = inactiveRmsError(activePixels, buff, w, h); // without fill
+
+        const unsigned filled = TilePyramidFill::fill(activePixels, buff);
+        const float fillError = inactiveRmsError(activePixels, buff, w, h);
+
+        unsigned inactiveTotal = 0;
+        for (unsigned tileId = 0; tileId < activePixels.getNumTiles(); ++tileId) {
+            if (!activePixels.getTileMask(tileId)) {
+                ++inactiveTotal;
+                continue;
+            }
+            for (unsigned pixId = 0; pixId < 64; ++pixId) { // active tiles are not touched
+                CPPUNIT_ASSERT(buff.getData()[(tileId << 6) + pixId] == org[(tileId << 6) + pixId]);
+            }
+        }
+        std::cerr << "\n>> TestTilePyramidFill step:" << step << " RMS error black:" << blackError
+                  << " fill:" << fillError;
+        CPPUNIT_ASSERT(filled == inactiveTotal);
+        CPPUNIT_ASSERT(fillError < blackError * 0.1f);
+    }
+    std::cerr << '\n';
+
+    // nothing to do : all tiles are active or all tiles are inactive
+    setupSparseImage(w, h, 1, activePixels, buff);
+    CPPUNIT_ASSERT(TilePyramidFill::fill(activePixels, buff) == 0);
+    activePixels.reset();
+    buff.clear();
+    CPPUNIT_ASSERT(TilePyramidFill::fill(activePixels, buff) == 0);
+    CPPUNIT_ASSERT(buff.getData()[0] == RenderColor(0.0f));
+}
+
+void
+TestTilePyramidFill::testROI()
+{
+    const unsigned w = 128;
+    const unsigned h = 128;
+    const int minSX = 20, minSY = 30, maxSX = 100, maxSY = 90;
+    ActivePixels activePixels;
+    RenderBuffer buff;
+    setupSparseImage(w, h, 4, activePixels, buff);
+
+    TilePyramidFill::fill(activePixels, buff, minSX, minSY, maxSX, maxSY);
+
+    for (unsigned tileId = 0; tileId < activePixels.getNumTiles(); ++tileId) {
+        if (activePixels.getTileMask(tileId)) continue;
+        const int tileX = static_cast<int>(tileId % activePixels.getNumTilesX());
+        const int tileY = static_cast<int>(tileId / activePixels.getNumTilesX());
+        for (int pixId = 0; pixId < 64; ++pixId) {
+            const int sx = (tileX << 3) + (pixId & 7);
+            const int sy = (tileY << 3) + (pixId >> 3);
+            const bool inside = minSX <= sx && sx <= maxSX && minSY <= sy && sy <= maxSY;
+            const RenderColor &c = buff.getData()[(tileId << 6) + pixId];
+            CPPUNIT_ASSERT(inside == (c[3] == 1.0f)); // only fills inside ROI
+        }
+    }
+}
+
+void
+TestTilePyramidFill::testBenchmark()
+{
+    // 4K beauty buffer, 1/16 tiles are active. (early progressive frame)
+    const unsigned w = 3840;
+    const unsigned h = 2160;
+    const int loopMax = 16;
+    ActivePixels activePixels;
+    RenderBuffer buff;
+    setupSparseImage(w, h, 4, activePixels, buff);
+    std::vector<RenderColor> org = copyPixels(buff);
+
+    rec_time::RecTime recTime;
+    auto timeIt = [&](const std::function<void()> &func) {
+        float total = 0.0f;
+        for (int loop = 0; loop < loopMax; ++loop) {
+            restorePixels(org, buff); // every loop starts from the black inactive tiles
+            recTime.start();
+            func();
+            total += recTime.end();
+        }
+        return total / static_cast<float>(loopMax) * 1000.0f; // millisec
+    };
+
+    const float serial = timeIt([&]() { TilePyramidFill::fill(activePixels, buff, false); });
+    const std::vector<RenderColor> serialResult = copyPixels(buff);
+    const float parallel = timeIt([&]() { TilePyramidFill::fill(activePixels, buff, true); });
+    CPPUNIT_ASSERT(copyPixels(buff) == serialResult);
+
+    setupSparseImage(w, h, 1, activePixels, buff); // all tiles active : fast exit
+    org = copyPixels(buff);
+    const float allActive = timeIt([&]() { TilePyramidFill::fill(activePixels, buff, true); });
+
+    std::cerr << "\n>> TestTilePyramidFill " << w << 'x' << h << " RenderBuffer 1/16 tiles active\n"
+              << "   serial:" << serial << " ms parallel:" << parallel
+              << " ms all tiles active:" << allActive << " ms\n";
+}
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
@@ -0,0 +1,35 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace scene_rdl2 {
+namespace fb_util {
+namespace unittest {
+
+class TestTilePyramidFill : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    void testPushPull();
+    void testQuality();         // error against the ground truth image
+    void testROI();
+    void testBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestTilePyramidFill);
+    CPPUNIT_TEST(testPushPull);
+    CPPUNIT_TEST(testQuality);
+    CPPUNIT_TEST(testROI);
+    CPPUNIT_TEST(testBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace fb_util
+} // namespace scene_rdl2
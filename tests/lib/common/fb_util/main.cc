@@ -2,9 +2,14 @@
 // SPDX-License-Identifier: Apache-2.0
 
 
+#include "TestFramePool.h"
 #include "TestPixelBuffer.h"
+#include "TestPixelBufferUtilsGamma8bit.h"
 #include "TestRunningStats.h"
 #include "TestSnapshotUtil.h"
+#include "TestSparseTiledPixelBuffer.h"
+#include "TestTileExtrapolation.h"
+#include "TestTilePyramidFill.h"
 
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
@@ -15,9 +20,14 @@ main(int argc, char* argv[])
 {
     using namespace scene_rdl2::fb_util::unittest;
 
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestFramePool);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestPixelBuffer);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestPixelBufferUtilsGamma8bit);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestRunningStats);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestSnapshotUtil);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestSparseTiledPixelBuffer);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestTileExtrapolation);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestTilePyramidFill);
 
     return pdevunit::run(argc, argv);
 }
@@ -0,0 +1,201 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "TestLatencyLogCollector.h"
+
+#include <scene_rdl2/scene/rdl2/ValueContainerDeq.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerEnq.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+void
+TestLatencyLogCollector::testClockOffset()
+{
+    LatencyLogCollector collector;
+    setupLogs(collector, 3, 4);
+    collector.build(sNetDelay);
+
+    for (int machineId = 0; machineId < 3; ++machineId) {
+        int64_t offset;
+        CPPUNIT_ASSERT("offset exist" && collector.getClockOffset(machineId, offset));
+        CPPUNIT_ASSERT("one-way offset" && offset == -skew(machineId));
+    }
+
+    // round-trip sample overrides one-way estimation and minimum delay sample is used.
+    auto sample = [](const uint64_t t0, const uint64_t t1, const uint64_t t2, const uint64_t t3) {
+        // t1, t2 : converted to the merge clock
+        const uint64_t shift = static_cast<uint64_t>(-skew(1));
+        return LatencyLogCollector::RoundTripSample {t0, t1 + shift, t2 + shift, t3};
+    };
+    const LatencyLogCollector::RoundTripSample good = sample(1000, 1100, 1110, 1210);
+    const LatencyLogCollector::RoundTripSample bad = sample(1000, 1900, 1910, 1310);
+    collector.addRoundTripSample(1, bad);
+    collector.addRoundTripSample(1, good);
+    collector.build(0);
+
+    int64_t offset;
+    CPPUNIT_ASSERT("round-trip offset exist" && collector.getClockOffset(1, offset));
+    CPPUNIT_ASSERT("round-trip offset" && offset == -skew(1));
+    CPPUNIT_ASSERT("unknown machine" && !collector.getClockOffset(5, offset));
+}
+
+void
+TestLatencyLogCollector::testCriticalPath()
+{
+    LatencyLogCollector collector;
+    setupLogs(collector, 3, 4);
+    collector.build(sNetDelay);
+
+    const auto &timelines = collector.getTimelines();
+    CPPUNIT_ASSERT("timeline total" && timelines.size() == 4);
+    for (size_t frameId = 0; frameId < timelines.size(); ++frameId) {
+        const auto &timeline = timelines[frameId];
+        CPPUNIT_ASSERT("contribution total" && timeline.mContributions.size() == 3);
+
+        // machineId:2 has the longest compute time and arrives last
+        CPPUNIT_ASSERT("critical contribution" && timeline.mCriticalContributionId >= 0);
+        const auto &critical = timeline.mContributions[timeline.mCriticalContributionId];
+        CPPUNIT_ASSERT("critical machine" && critical.mMachineId == 2);
+
+        const uint32_t expected = computeTime(2, frameId) + sNetDelay + sMergeTime;
+        CPPUNIT_ASSERT("frame latency" && timeline.latency() == static_cast<int64_t>(expected));
+
+        // critical path segments are contiguous and cover the whole frame latency
+        int64_t total = 0;
+        uint64_t prevEnd = timeline.mStart;
+        for (const auto &segment : timeline.mCriticalPath) {
+            CPPUNIT_ASSERT("contiguous" && segment.mStart == prevEnd);
+            total += segment.duration();
+            prevEnd = segment.mEnd;
+        }
+        CPPUNIT_ASSERT("critical path total" && total == timeline.latency());
+    }
+
+    std::cerr << '\n'
+              << collector.showClockOffset("") << '\n'
+              << collector.showTimeline("", 0) << '\n'
+              << collector.showCriticalPath("") << '\n';
+}
+
+void
+TestLatencyLogCollector::testPercentile()
+{
+    LatencyLogCollector collector;
+    int64_t v;
+    CPPUNIT_ASSERT("empty" && !collector.getPercentile(LatencyLogCollector::Metric::FRAME_LATENCY, 50.0f, v));
+
+    const int frameTotal = 100;
+    setupLogs(collector, 2, frameTotal);
+    collector.build(sNetDelay);
+
+    using Metric = LatencyLogCollector::Metric;
+    auto latency = [&](const int frameId) {
+        return static_cast<int64_t>(computeTime(1, frameId) + sNetDelay + sMergeTime);
+    };
+    CPPUNIT_ASSERT(collector.getPercentile(Metric::FRAME_LATENCY, 50.0f, v) && v == latency(49));
+    CPPUNIT_ASSERT(collector.getPercentile(Metric::FRAME_LATENCY, 99.0f, v) && v == latency(98));
+    CPPUNIT_ASSERT(collector.getPercentile(Metric::FRAME_LATENCY, 100.0f, v) && v == latency(99));
+    CPPUNIT_ASSERT(collector.getPercentile(Metric::FRAME_LATENCY, 0.0f, v) && v == latency(0));
+    CPPUNIT_ASSERT(collector.getPercentile(Metric::NETWORK, 90.0f, v) && v == sNetDelay);
+    CPPUNIT_ASSERT(collector.getPercentile(Metric::RECEIVER_MERGE, 50.0f, v) && v == sMergeTime);
+
+    std::cerr << collector.showPercentile("") << '\n';
+}
+
+void
+TestLatencyLogCollector::testRecord()
+{
+    LatencyLogCollector collector;
+    setupLogs(collector, 3, 8);
+    collector.addRoundTripSample(0, LatencyLogCollector::RoundTripSample {10, 20, 30, 40});
+
+    std::string buff;
+    rdl2::ValueContainerEnq vContainerEnq(&buff);
+    collector.encode(vContainerEnq);
+    const size_t dataSize = vContainerEnq.finalize();
+
+    LatencyLogCollector loaded;
+    rdl2::ValueContainerDeq vContainerDeq(buff.data(), dataSize);
+    CPPUNIT_ASSERT("decode" && loaded.decode(vContainerDeq));
+
+    collector.build(sNetDelay);
+    loaded.build(sNetDelay);
+    CPPUNIT_ASSERT("timeline total" && collector.getTimelines().size() == loaded.getTimelines().size());
+    for (size_t frameId = 0; frameId < collector.getTimelines().size(); ++frameId) {
+        CPPUNIT_ASSERT("timeline" &&
+                       collector.showTimeline("", frameId) == loaded.showTimeline("", frameId));
+    }
+    CPPUNIT_ASSERT("clockOffset" && collector.showClockOffset("") == loaded.showClockOffset(""));
+
+    // not a record
+    std::string otherBuff;
+    rdl2::ValueContainerEnq otherEnq(&otherBuff);
+    otherEnq.enqString("notRecord");
+    otherEnq.enqVLUInt(1);
+    const size_t otherSize = otherEnq.finalize();
+    rdl2::ValueContainerDeq otherDeq(otherBuff.data(), otherSize);
+    CPPUNIT_ASSERT("bad record" && !loaded.decode(otherDeq));
+}
+
+void
+TestLatencyLogCollector::setupLogs(LatencyLogCollector &collector,
+                                   const int machineTotal,
+                                   const int frameTotal) const
+{
+    using Key = LatencyItem::Key;
+
+    const uint64_t origin = 1600000000000000; // merge clock
+
+    for (int frameId = 0; frameId < frameTotal; ++frameId) {
+        const uint64_t frameStart = origin + frameId * 100000;
+
+        // All mcrt machines start at the same time by the merge clock
+        struct Arrival { int mMachineId; uint64_t mRecv; };
+        std::vector<Arrival> arrivals;
+        for (int machineId = 0; machineId < machineTotal; ++machineId) {
+            const uint32_t snapshotId = static_cast<uint32_t>(frameId);
+            const uint32_t compute = computeTime(machineId, frameId);
+
+            LatencyLog log;
+            log.setMachineId(machineId);
+            log.setSnapshotId(snapshotId);
+            log.setTimeBase(frameStart + skew(machineId)); // by own clock
+            log.enqRecorded(Key::START, 0);
+            log.enqRecorded(Key::SNAPSHOT_END_BEAUTY, compute / 2);
+            log.enqRecorded(Key::ENCODE_END_BEAUTY, compute - 10);
+            log.enqRecorded(Key::SEND_MSG, compute);
+            collector.addSenderLog(log);
+
+            arrivals.push_back(Arrival {machineId, frameStart + compute + sNetDelay});
+        }
+
+        std::sort(arrivals.begin(), arrivals.end(),
+                  [](const Arrival &a, const Arrival &b) { return a.mRecv < b.mRecv; });
+
+        LatencyLog mergeLog;
+        mergeLog.setTimeBase(frameStart);
+        uint32_t last = 0;
+        for (const auto &arrival : arrivals) {
+            const uint32_t recv = static_cast<uint32_t>(arrival.mRecv - frameStart);
+            mergeLog.enqRecorded(Key::RECV_PROGRESSIVEFRAME_START, recv,
+                                 {static_cast<uint32_t>(arrival.mMachineId), static_cast<uint32_t>(frameId)});
+            mergeLog.enqRecorded(Key::RECV_PROGRESSIVEFRAME_END, recv);
+            last = recv;
+        }
+        mergeLog.enqRecorded(Key::MERGE_PROGRESSIVEFRAME_DEQ_START, last + sMergeTime / 5);
+        mergeLog.enqRecorded(Key::MERGE_SEND_MSG, last + sMergeTime);
+        collector.addReceiverLog(mergeLog);
+    }
+}
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
+
@@ -0,0 +1,52 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+
+#pragma once
+
+#include <scene_rdl2/common/grid_util/LatencyLogCollector.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+class TestLatencyLogCollector : public CppUnit::TestFixture
+{
+public:
+    void setUp() {}
+    void testDown() {}
+
+    void testClockOffset();
+    void testCriticalPath();
+    void testPercentile();
+    void testRecord();
+
+    CPPUNIT_TEST_SUITE(TestLatencyLogCollector);
+    CPPUNIT_TEST(testClockOffset);
+    CPPUNIT_TEST(testCriticalPath);
+    CPPUNIT_TEST(testPercentile);
+    CPPUNIT_TEST(testRecord);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    // Builds synthetic logs of frameTotal frames from machineTotal mcrt machines. Machine clock
+    // of machineId is shifted by skew(machineId) from the merge clock and one-way network
+    // delay is fixed by sNetDelay.
+    void setupLogs(LatencyLogCollector &collector, const int machineTotal, const int frameTotal) const;
+
+    static int64_t skew(const int machineId) { return (machineId + 1) * 250000 * ((machineId % 2) ? -1 : 1); }
+    static uint32_t computeTime(const int machineId, const int frameId) { return 1000 * (machineId + 1) + frameId * 10; }
+
+    static constexpr uint32_t sNetDelay = 300; // usec
+    static constexpr uint32_t sMergeTime = 500; // usec
+};
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
+
@@ -0,0 +1,261 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "TestMetrics.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/grid_util/Fb.h>
+#include <scene_rdl2/common/grid_util/LatencyLog.h>
+#include <scene_rdl2/common/grid_util/RenderPrepStats.h>
+#include <scene_rdl2/common/rec_time/RecTimeLap.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>          // inet_addr()
+#include <netinet/in.h>         // struct sockaddr_in
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>             // struct sockaddr_un
+#include <unistd.h>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+void
+TestMetrics::testSnapshot()
+{
+    MetricsRegistry registry;
+    registry.counter("test_send_total", "sent messages").inc(3);
+    registry.gauge("test_active_pixels", "active pixels", "aov=\"beauty\"").set(1024);
+    registry.gauge("test_active_pixels", "active pixels", "aov=\"depth\"").set(16);
+    MetricHistogram &histogram = registry.histogram("test_latency_seconds", "latency", {0.1, 0.01, 1.0});
+    histogram.observe(0.005);
+    histogram.observe(0.5);
+    histogram.observe(2.0);
+    registry.addCallback("test_callback", "callback\nvalue", []() { return 1.5; });
+
+    // same name and labels returns the same object
+    registry.counter("test_send_total", "sent messages").inc();
+    CPPUNIT_ASSERT(registry.getMetricTotal() == 5);
+
+    const std::string expected =
+        "# HELP test_active_pixels active pixels\n"
+        "# TYPE test_active_pixels gauge\n"
+        "test_active_pixels{aov=\"beauty\"} 1024\n"
+        "test_active_pixels{aov=\"depth\"} 16\n"
+        "# HELP test_callback callback\\nvalue\n"
+        "# TYPE test_callback gauge\n"
+        "test_callback 1.5\n"
+        "# HELP test_latency_seconds latency\n"
+        "# TYPE test_latency_seconds histogram\n"
+        "test_latency_seconds_bucket{le=\"0.01\"} 1\n"
+        "test_latency_seconds_bucket{le=\"0.1\"} 1\n"
+        "test_latency_seconds_bucket{le=\"1\"} 2\n"
+        "test_latency_seconds_bucket{le=\"+Inf\"} 3\n"
+        "test_latency_seconds_sum 2.505\n"
+        "test_latency_seconds_count 3\n"
+        "# HELP test_send_total sent messages\n"
+        "# TYPE test_send_total counter\n"
+        "test_send_total 4\n";
+    CPPUNIT_ASSERT(registry.snapshot() == expected);
+}
+
+void
+TestMetrics::testMultiThread()
+{
+    MetricsRegistry registry;
+    MetricCounter &counter = registry.counter("test_counter", "counter");
+    MetricGauge &gauge = registry.gauge("test_gauge", "gauge");
+    MetricHistogram &histogram = registry.histogram("test_histogram", "histogram", {10.0});
+
+    constexpr int threadTotal = 8;
+    constexpr int loopTotal = 100000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadTotal; ++i) {
+        threads.emplace_back([&]() {
+            for (int loop = 0; loop < loopTotal; ++loop) {
+                counter.inc();
+                gauge.add(1.0);
+                histogram.observe(static_cast<double>(loop % 20));
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    CPPUNIT_ASSERT(counter.get() == threadTotal * loopTotal);
+    CPPUNIT_ASSERT(gauge.get() == static_cast<double>(threadTotal * loopTotal));
+    std::vector<uint64_t> bucketCount;
+    double sum;
+    uint64_t count;
+    histogram.get(bucketCount, sum, count);
+    CPPUNIT_ASSERT(count == threadTotal * loopTotal);
+    CPPUNIT_ASSERT(bucketCount[0] == count / 20 * 11); // 0 ~ 10
+    CPPUNIT_ASSERT(sum == 9.5 * count);
+}
+
+void
+TestMetrics::testRegisterError()
+{
+    MetricsRegistry registry;
+    registry.counter("test_metric", "counter");
+    CPPUNIT_ASSERT_THROW(registry.gauge("test_metric", "gauge"), except::ValueError);
+    CPPUNIT_ASSERT_THROW(registry.counter("0test", "invalid name"), except::ValueError);
+    CPPUNIT_ASSERT_THROW(registry.counter("test-metric", "invalid name"), except::ValueError);
+
+    std::vector<double> bounds;
+    for (size_t i = 0; i < MetricHistogram::sMaxBucketTotal; ++i) bounds.push_back(static_cast<double>(i));
+    CPPUNIT_ASSERT_THROW(registry.histogram("test_histogram", "too many bounds", bounds), except::ValueError);
+    bounds.pop_back();
+    registry.histogram("test_histogram", "max bounds", bounds).observe(100.0);
+    CPPUNIT_ASSERT(registry.getMetricTotal() == 2);
+    CPPUNIT_ASSERT(registry.snapshot().find("test_histogram_bucket{le=\"+Inf\"} 1\n") != std::string::npos);
+}
+
+void
+TestMetrics::testAdapter()
+{
+    MetricsRegistry registry;
+
+    RenderPrepStats renderPrepStats;
+    RenderPrepStatsMetrics renderPrepMetrics(registry, "test");
+    renderPrepStats.stage() = RenderPrepStats::Stage::RENDER_PREP_DONE;
+    renderPrepMetrics.update(renderPrepStats);
+    CPPUNIT_ASSERT(registry.gauge("test_render_prep_stage", "").get() ==
+                   static_cast<double>(static_cast<unsigned>(RenderPrepStats::Stage::RENDER_PREP_DONE)));
+    CPPUNIT_ASSERT(registry.gauge("test_render_prep_steps", "").get() ==
+                   static_cast<double>(renderPrepStats.getCurrSteps()));
+    CPPUNIT_ASSERT(registry.gauge("test_render_prep_steps_total", "").get() ==
+                   static_cast<double>(renderPrepStats.getTotalSteps()));
+
+    Fb fb;
+    fb.init(math::Viewport(0, 0, 63, 63));
+    FbMetrics fbMetrics(registry, "test");
+    fb.getActivePixels().orOp(0, 0xff);
+    fbMetrics.update(fb);
+    CPPUNIT_ASSERT(registry.gauge("test_fb_active_pixels", "").get() == 8.0);
+
+    rec_time::RecTimeLap recTimeLap;
+    RecTimeLapMetrics lapMetrics(registry, "test");
+    const size_t sectionId = recTimeLap.sectionRegistration("encode \"beauty\"");
+    lapMetrics.update(recTimeLap); // no interval yet : nothing is registered
+    CPPUNIT_ASSERT(registry.snapshot().find("test_lap_section_msec") == std::string::npos);
+    recTimeLap.passStartingLine();
+    recTimeLap.sectionStart(sectionId);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    recTimeLap.sectionEnd(sectionId);
+    recTimeLap.passStartingLine();
+    lapMetrics.update(recTimeLap);
+    const double lapMs =
+        registry.gauge("test_lap_section_msec", "", "section=\"encode \\\"beauty\\\"\"").get();
+    CPPUNIT_ASSERT(lapMs > 5.0 && lapMs < 1000.0);
+
+    LatencyLog latencyLog;
+    LatencyLogMetrics latencyMetrics(registry, "test", {0.01, 0.1});
+    latencyMetrics.observe(latencyLog); // empty
+    latencyLog.setTimeBase(0);
+    latencyLog.enqRecorded(LatencyItem::Key::START, 0);
+    latencyLog.enqRecorded(LatencyItem::Key::SEND_MSG, 50000); // 50ms
+    latencyLog.addDataSize(1024);
+    latencyMetrics.observe(latencyLog);
+    std::vector<uint64_t> bucketCount;
+    double sum;
+    uint64_t count;
+    registry.histogram("test_latency_seconds", "", {}).get(bucketCount, sum, count);
+    CPPUNIT_ASSERT(count == 1 && bucketCount[1] == 1 && sum == 0.05);
+    CPPUNIT_ASSERT(registry.counter("test_latency_log_bytes_total", "").get() == 1024);
+
+    // any type which has the MemPool interface
+    struct BlockManager { unsigned getMemoryUsage() const { return 4096; } };
+    struct Pool {
+        enum { FAILED_ENTRY_ALLOCS = 1 };
+        struct Stats { size_t mCounters[2] {0, 3}; };
+        unsigned getNumEntriesAllocated() const { return 12; }
+        const BlockManager *getMemBlockManager() const { return &mBlockManager; }
+        const Stats &getStats() const { return mStats; }
+        BlockManager mBlockManager;
+        Stats mStats;
+    } pool;
+    MemPoolMetrics memPoolMetrics(registry, "test", "pool=\"shading\"");
+    memPoolMetrics.update(pool);
+    CPPUNIT_ASSERT(registry.gauge("test_mempool_entries", "", "pool=\"shading\"").get() == 12.0);
+    CPPUNIT_ASSERT(registry.gauge("test_mempool_block_bytes", "", "pool=\"shading\"").get() == 4096.0);
+    CPPUNIT_ASSERT(registry.gauge("test_mempool_failed_allocs", "", "pool=\"shading\"").get() == 3.0);
+}
+
+void
+TestMetrics::testSvrTcp()
+{
+    MetricsRegistry registry;
+    registry.counter("test_scrape_total", "scrape").inc(7);
+
+    {
+        MetricsSvr badSvr(registry);
+        CPPUNIT_ASSERT(badSvr.openTcp(0, "not.an.address") == 0);
+    }
+
+    MetricsSvr svr(registry);
+    const int port = svr.openTcp(0);
+    CPPUNIT_ASSERT(port > 0);
+
+    for (int i = 0; i < 2; ++i) { // server keeps working for the next connection
+        int sock = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in in {};
+        in.sin_family = AF_INET;
+        in.sin_addr.s_addr = inet_addr("127.0.0.1");
+        in.sin_port = htons(static_cast<uint16_t>(port));
+        CPPUNIT_ASSERT(::connect(sock, (struct sockaddr *)&in, sizeof(in)) == 0);
+
+        const std::string response = request(sock, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        CPPUNIT_ASSERT(response.compare(0, 17, "HTTP/1.0 200 OK\r\n") == 0);
+        CPPUNIT_ASSERT(response.find("\r\n\r\n" + registry.snapshot()) != std::string::npos);
+        ::close(sock);
+    }
+    svr.close();
+}
+
+void
+TestMetrics::testSvrUnix()
+{
+    MetricsRegistry registry;
+    registry.gauge("test_gauge", "gauge").set(-2.0);
+
+    const std::string path = "/tmp/scene_rdl2_TestMetrics." + std::to_string(::getpid());
+    MetricsSvr svr(registry);
+    CPPUNIT_ASSERT(svr.openUnix(path));
+
+    int sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un un {};
+    un.sun_family = AF_UNIX;
+    strncpy(un.sun_path, path.c_str(), sizeof(un.sun_path) - 1);
+    CPPUNIT_ASSERT(::connect(sock, (struct sockaddr *)&un, sizeof(un)) == 0);
+
+    // non HTTP request returns snapshot text only
+    CPPUNIT_ASSERT(request(sock, "\n") == registry.snapshot());
+    ::close(sock);
+
+    svr.close();
+    CPPUNIT_ASSERT(::access(path.c_str(), F_OK) != 0); // socket file is removed
+}
+
+std::string
+TestMetrics::request(int sock, const std::string &req) const
+{
+    if (::write(sock, req.data(), req.size()) != static_cast<ssize_t>(req.size())) return "";
+
+    std::string response;
+    char buff[1024];
+    ssize_t rSize;
+    while ((rSize = ::read(sock, buff, sizeof(buff))) > 0) {
+        response.append(buff, static_cast<size_t>(rSize));
+    }
+    return response;
+}
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
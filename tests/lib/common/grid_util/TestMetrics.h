@@ -0,0 +1,50 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+
+#pragma once
+
+#include <scene_rdl2/common/grid_util/MetricsAdapter.h>
+#include <scene_rdl2/common/grid_util/MetricsRegistry.h>
+#include <scene_rdl2/common/grid_util/MetricsSvr.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+#include <string>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+class TestMetrics : public CppUnit::TestFixture
+{
+public:
+    void setUp() {}
+    void tearDown() {}
+
+    void testSnapshot();        // Prometheus text format
+    void testMultiThread();     // lock-free update from multiple threads
+    void testRegisterError();
+    void testAdapter();         // RenderPrepStats, Fb, RecTimeLap, LatencyLog and MemPool adapters
+    void testSvrTcp();
+    void testSvrUnix();
+
+    CPPUNIT_TEST_SUITE(TestMetrics);
+    CPPUNIT_TEST(testSnapshot);
+    CPPUNIT_TEST(testMultiThread);
+    CPPUNIT_TEST(testRegisterError);
+    CPPUNIT_TEST(testAdapter);
+    CPPUNIT_TEST(testSvrTcp);
+    CPPUNIT_TEST(testSvrUnix);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    std::string request(int sock, const std::string &req) const; // send req and read until EOF
+};
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
@@ -0,0 +1,196 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "TestSparseTileStream.h"
+
+#include <scene_rdl2/common/except/exceptions.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerDeq.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerEnq.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerSink.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+void
+TestSparseTileStream::testDirtyTiles()
+{
+    const unsigned w = 128, h = 64; // tiled resolution : 16 x 8 tiles
+    VariablePixelBuffer src, dst;
+    fillRandom(src, VariablePixelBuffer::FLOAT3, w, h, 1);
+
+    fb_util::DirtyTileTracker tracker;
+    tracker.init(w, h);
+    tracker.markPixel(3, 3);        // tileId 0
+    tracker.markPixel(127, 63);     // tileId 127
+    tracker.markRegion(40, 48, 16, 24); // tileId 37
+
+    std::string data;
+    {
+        rdl2::ValueContainerEnq vContainerEnq(&data);
+        CPPUNIT_ASSERT(SparseTileStream::enqDirtyTiles(src, tracker, vContainerEnq, false) == 3);
+        vContainerEnq.finalize();
+    }
+    CPPUNIT_ASSERT(tracker.getNumDirtyTiles() == 0);
+
+    std::vector<unsigned> tileIds;
+    rdl2::ValueContainerDeq vContainerDeq(data.data(), data.size());
+    SparseTileStream::deqTiles(vContainerDeq, dst, &tileIds, false);
+    CPPUNIT_ASSERT(dst.getFormat() == VariablePixelBuffer::FLOAT3);
+    CPPUNIT_ASSERT(dst.getWidth() == w && dst.getHeight() == h);
+    CPPUNIT_ASSERT((tileIds == std::vector<unsigned>{0, 37, 127}));
+    for (unsigned tileId : tileIds) CPPUNIT_ASSERT(isSameTile(src, dst, tileId));
+
+    // no dirty tile
+    data.clear();
+    {
+        rdl2::ValueContainerEnq vContainerEnq(&data);
+        CPPUNIT_ASSERT(SparseTileStream::enqDirtyTiles(src, tracker, vContainerEnq, false) == 0);
+        vContainerEnq.finalize();
+    }
+    rdl2::ValueContainerDeq vContainerDeq2(data.data(), data.size());
+    SparseTileStream::deqTiles(vContainerDeq2, dst, &tileIds, false);
+    CPPUNIT_ASSERT(tileIds.empty());
+}
+
+void
+TestSparseTileStream::testChunkSink()
+{
+    const unsigned w = 512, h = 512; // 4096 tiles
+    VariablePixelBuffer src, dst;
+    fillRandom(src, VariablePixelBuffer::FLOAT4, w, h, 2);
+
+    // unsorted tileIds
+    std::vector<unsigned> tileIds;
+    for (unsigned i = 0; i < 4096; i += 2) tileIds.push_back(i);
+    std::shuffle(tileIds.begin(), tileIds.end(), std::mt19937(123));
+
+    rdl2::ValueContainerChunkSink sink(64 * 1024);
+    {
+        rdl2::ValueContainerEnq vContainerEnq(&sink);
+        SparseTileStream::enqTiles(src, tileIds, vContainerEnq, true);
+        vContainerEnq.finalize();
+    }
+    std::string data;
+    sink.copyTo(data);
+
+    std::vector<unsigned> deqTileIds;
+    rdl2::ValueContainerDeq vContainerDeq(data.data(), data.size());
+    SparseTileStream::deqTiles(vContainerDeq, dst, &deqTileIds, true);
+    CPPUNIT_ASSERT(deqTileIds == tileIds);
+    for (unsigned tileId = 0; tileId < 4096; ++tileId) {
+        const bool updated = (tileId % 2 == 0);
+        CPPUNIT_ASSERT(isSameTile(src, dst, tileId) == updated);
+    }
+}
+
+void
+TestSparseTileStream::testVarianceFormat()
+{
+    const unsigned w = 64, h = 64;
+    VariablePixelBuffer src;
+    src.init(VariablePixelBuffer::FLOAT_VARIANCE, w, h);
+    src.clear();
+
+    fb_util::DirtyTileTracker tracker;
+    tracker.init(w, h);
+    tracker.markTile(5);
+
+    std::string data;
+    {
+        rdl2::ValueContainerEnq vContainerEnq(&data);
+        CPPUNIT_ASSERT_THROW(SparseTileStream::enqTiles(src, {5}, vContainerEnq, false),
+                             except::RuntimeError);
+        CPPUNIT_ASSERT_THROW(SparseTileStream::enqDirtyTiles(src, tracker, vContainerEnq, false),
+                             except::RuntimeError);
+        CPPUNIT_ASSERT(tracker.getNumDirtyTiles() == 1);
+
+        VariablePixelBuffer uninitialized;
+        CPPUNIT_ASSERT_THROW(SparseTileStream::enqTiles(uninitialized, {}, vContainerEnq, false),
+                             except::RuntimeError);
+
+        // same layout as enqTiles() with a variance format
+        vContainerEnq.enqUInt(static_cast<unsigned>(VariablePixelBuffer::FLOAT_VARIANCE));
+        vContainerEnq.enqUInt(w);
+        vContainerEnq.enqUInt(h);
+        vContainerEnq.enqStreamVByteUIntVector(std::vector<unsigned>{5});
+        vContainerEnq.finalize();
+    }
+
+    VariablePixelBuffer dst;
+    rdl2::ValueContainerDeq vContainerDeq(data.data(), data.size());
+    CPPUNIT_ASSERT_THROW(SparseTileStream::deqTiles(vContainerDeq, dst, nullptr, false),
+                         except::RuntimeError);
+    CPPUNIT_ASSERT(dst.getFormat() == VariablePixelBuffer::UNINITIALIZED);
+}
+
+void
+TestSparseTileStream::testBenchmark()
+{
+    // 4K FLOAT4, 1/4 of tiles are dirty
+    const unsigned w = 3840, h = 2160;
+    VariablePixelBuffer src;
+    fillRandom(src, VariablePixelBuffer::FLOAT4, w, h, 3);
+    fb_util::DirtyTileTracker tracker;
+    tracker.init(w, h);
+
+    const int loopMax = 16;
+    rec_time::RecTime recTime;
+    float enqTime = 0.0f;
+    size_t numTiles = 0;
+    std::string data;
+    for (int loop = 0; loop < loopMax; ++loop) {
+        for (unsigned tileId = loop % 4; tileId < tracker.getNumTiles(); tileId += 4) tracker.markTile(tileId);
+
+        data.clear();
+        recTime.start();
+        rdl2::ValueContainerEnq vContainerEnq(&data);
+        numTiles = SparseTileStream::enqDirtyTiles(src, tracker, vContainerEnq, true);
+        vContainerEnq.finalize();
+        enqTime += recTime.end();
+    }
+
+    VariablePixelBuffer dst;
+    recTime.start();
+    for (int loop = 0; loop < loopMax; ++loop) {
+        rdl2::ValueContainerDeq vContainerDeq(data.data(), data.size());
+        SparseTileStream::deqTiles(vContainerDeq, dst, nullptr, true);
+    }
+    const float deqTime = recTime.end();
+
+    std::cerr << "\n>> TestSparseTileStream " << w << 'x' << h << " FLOAT4 " << numTiles << " dirty tiles ("
+              << data.size() / 1024 / 1024 << " MByte)"
+              << " enq:" << enqTime / loopMax * 1000.0f << " ms"
+              << " deq:" << deqTime / loopMax * 1000.0f << " ms\n";
+}
+
+void
+TestSparseTileStream::fillRandom(VariablePixelBuffer &buff, VariablePixelBuffer::Format format,
+                                 unsigned w, unsigned h, unsigned seed) const
+{
+    buff.init(format, w, h);
+    std::mt19937 rng(seed);
+    uint8_t *data = buff.getData();
+    const size_t size = static_cast<size_t>(buff.getArea()) * buff.getSizeOfPixel();
+    for (size_t i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(rng());
+}
+
+bool
+TestSparseTileStream::isSameTile(const VariablePixelBuffer &a, const VariablePixelBuffer &b,
+                                 unsigned tileId) const
+{
+    const size_t tileBytes = a.getSizeOfPixel() * 64;
+    return std::memcmp(a.getData() + tileId * tileBytes, b.getData() + tileId * tileBytes, tileBytes) == 0;
+}
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
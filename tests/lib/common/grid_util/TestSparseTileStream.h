@@ -0,0 +1,46 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+
+#pragma once
+
+#include <scene_rdl2/common/grid_util/SparseTileStream.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+class TestSparseTileStream : public CppUnit::TestFixture
+{
+public:
+    void setUp() {}
+    void testDown() {}
+
+    void testDirtyTiles();      // enq dirty tiles to std::string and deq
+    void testChunkSink();       // enq more than sBatchTiles tiles to ValueContainerChunkSink
+    void testVarianceFormat();  // variance formats are rejected
+    void testBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestSparseTileStream);
+    CPPUNIT_TEST(testDirtyTiles);
+    CPPUNIT_TEST(testChunkSink);
+    CPPUNIT_TEST(testVarianceFormat);
+    CPPUNIT_TEST(testBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    using VariablePixelBuffer = fb_util::VariablePixelBuffer;
+
+    void fillRandom(VariablePixelBuffer &buff, VariablePixelBuffer::Format format,
+                    unsigned w, unsigned h, unsigned seed) const;
+    bool isSameTile(const VariablePixelBuffer &a, const VariablePixelBuffer &b, unsigned tileId) const;
+};
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
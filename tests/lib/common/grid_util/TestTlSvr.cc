@@ -0,0 +1,229 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "TestTlSvr.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <arpa/inet.h>          // inet_addr()
+#include <netinet/in.h>         // struct sockaddr_in
+#include <sys/socket.h>
+#include <sys/time.h>           // struct timeval
+#include <unistd.h>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+void
+TestTlSvr::testMultiClient()
+{
+    TlSvr svr;
+    const int port = svr.open(0);
+    CPPUNIT_ASSERT(port > 0);
+
+    const int sockA = connectClient(port);
+    const int sockB = connectClient(port);
+    CPPUNIT_ASSERT(sockA >= 0 && sockB >= 0);
+
+    // "cmdA" is split into 2 packets and finished by CR LF
+    CPPUNIT_ASSERT(sendStr(sockA, "cm"));
+    CPPUNIT_ASSERT(sendStr(sockB, "cmdB\n"));
+
+    std::string line;
+    CPPUNIT_ASSERT(recvLine(svr, line) > 0);
+    CPPUNIT_ASSERT(line == "cmdB\n");
+    CPPUNIT_ASSERT(svr.getClientTotal() == 2);
+    CPPUNIT_ASSERT(svr.send("replyB\n"));  // goes to sockB only
+
+    CPPUNIT_ASSERT(sendStr(sockA, "dA\r\n"));
+    CPPUNIT_ASSERT(recvLine(svr, line) > 0);
+    CPPUNIT_ASSERT(line == "cmdA\n");
+    CPPUNIT_ASSERT(svr.send("replyA\n"));  // goes to sockA only
+
+    CPPUNIT_ASSERT(svr.broadcast("all\n"));
+    flushSend(svr);
+    CPPUNIT_ASSERT(recvStr(sockA, 11) == "replyA\nall\n");
+    CPPUNIT_ASSERT(recvStr(sockB, 11) == "replyB\nall\n");
+
+    // closed connection is reported as EOF and the other client keeps working
+    ::close(sockA);
+    CPPUNIT_ASSERT(recvLine(svr, line) == -1);
+    CPPUNIT_ASSERT(svr.getClientTotal() == 1);
+    CPPUNIT_ASSERT(sendStr(sockB, "cmdB2\n"));
+    CPPUNIT_ASSERT(recvLine(svr, line) > 0);
+    CPPUNIT_ASSERT(line == "cmdB2\n");
+
+    ::close(sockB);
+    svr.close();
+}
+
+void
+TestTlSvr::testWakeup()
+{
+    TlSvr svr;
+    CPPUNIT_ASSERT(svr.open(0) > 0);
+
+    std::thread thread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        svr.wakeup();
+    });
+    std::string line;
+    auto start = std::chrono::steady_clock::now();
+    CPPUNIT_ASSERT(svr.recvWait(line, -1) == 0);
+    auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    CPPUNIT_ASSERT(waitMs.count() >= 40); // really slept until wakeup()
+    thread.join();
+}
+
+void
+TestTlSvr::testNonBlockingSend()
+{
+    TlSvr svr;
+    const int port = svr.open(0);
+    const int sock = connectClient(port);
+    CPPUNIT_ASSERT(sock >= 0);
+    std::string line;
+    CPPUNIT_ASSERT(sendStr(sock, "stream\n"));
+    CPPUNIT_ASSERT(recvLine(svr, line) > 0);
+
+    // The client does not read. Total data is larger than socket buffers + sMaxSendBuffSize.
+    const std::string msg(1024 * 1024, 'x');
+    const size_t total = TlSvr::sMaxSendBuffSize / msg.size() + 64;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < total; ++i) {
+        CPPUNIT_ASSERT(svr.broadcast(msg));
+    }
+    auto sendMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    CPPUNIT_ASSERT(sendMs.count() < 5000); // never blocked
+    CPPUNIT_ASSERT(svr.getDroppedSendSize() > 0);
+
+    ::close(sock);
+    svr.close();
+}
+
+void
+TestTlSvr::testLongLine()
+{
+    TlSvr svr;
+    const int port = svr.open(0);
+    const int sock = connectClient(port);
+    CPPUNIT_ASSERT(sock >= 0);
+
+    // sends more than sMaxRecvLineSize without '\n'. Stops when the server closes the connection.
+    std::thread thread([&]() {
+        const std::string msg(64 * 1024, 'x');
+        for (size_t total = 0; total <= TlSvr::sMaxRecvLineSize + msg.size(); total += msg.size()) {
+            if (::send(sock, msg.data(), msg.size(), MSG_NOSIGNAL) < 0) break;
+        }
+    });
+    std::string line;
+    CPPUNIT_ASSERT(recvLine(svr, line) == -1);
+    CPPUNIT_ASSERT(svr.getClientTotal() == 0);
+    thread.join();
+
+    ::close(sock);
+    svr.close();
+}
+
+void
+TestTlSvr::testSendWhileRecvWait()
+{
+    TlSvr svr;
+    const int port = svr.open(0);
+    const int sock = connectClient(port);
+    CPPUNIT_ASSERT(sock >= 0);
+    std::string line;
+    CPPUNIT_ASSERT(sendStr(sock, "stream\n"));
+    CPPUNIT_ASSERT(recvLine(svr, line) > 0);
+
+    // recvWait() thread sleeps without timeout. Send kick does not return recvWait().
+    std::atomic<bool> stop(false);
+    std::atomic<int> returnTotal(0);
+    std::thread thread([&]() {
+        std::string str;
+        while (!stop) {
+            svr.recvWait(str, -1);
+            returnTotal++;
+        }
+    });
+
+    struct timeval tv {5, 0}; // don't hang if the data is never written
+    ::setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT(svr.broadcast("data\n"));
+        CPPUNIT_ASSERT(recvStr(sock, 5) == "data\n");
+    }
+    CPPUNIT_ASSERT(returnTotal == 0);
+
+    stop = true;
+    svr.wakeup();
+    thread.join();
+
+    ::close(sock);
+    svr.close();
+}
+
+//------------------------------------------------------------------------------------------
+
+int
+TestTlSvr::connectClient(int port) const
+{
+    int sock = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+
+    struct sockaddr_in in {};
+    in.sin_family = AF_INET;
+    in.sin_addr.s_addr = inet_addr("127.0.0.1");
+    in.sin_port = htons(static_cast<uint16_t>(port));
+    if (::connect(sock, (struct sockaddr *)&in, sizeof(in)) < 0) {
+        ::close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+bool
+TestTlSvr::sendStr(int sock, const std::string &str) const
+{
+    return ::write(sock, str.data(), str.size()) == static_cast<ssize_t>(str.size());
+}
+
+std::string
+TestTlSvr::recvStr(int sock, size_t size) const
+{
+    std::string str(size, 0x0);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t rSize = ::read(sock, &str[done], size - done);
+        if (rSize <= 0) break;
+        done += static_cast<size_t>(rSize);
+    }
+    str.resize(done);
+    return str;
+}
+
+int
+TestTlSvr::recvLine(TlSvr &svr, std::string &line) const
+{
+    for (int i = 0; i < 100; ++i) {
+        int recvByte = svr.recvWait(line, 100); // 100ms timeout
+        if (recvByte != 0) return recvByte;
+    }
+    return 0;                   // timeout
+}
+
+void
+TestTlSvr::flushSend(TlSvr &svr) const
+{
+    std::string line;
+    svr.recvWait(line, 0);
+}
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
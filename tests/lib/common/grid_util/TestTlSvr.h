@@ -0,0 +1,53 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+
+#pragma once
+
+#include <scene_rdl2/common/grid_util/TlSvr.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+#include <string>
+
+namespace scene_rdl2 {
+namespace grid_util {
+namespace unittest {
+
+class TestTlSvr : public CppUnit::TestFixture
+{
+public:
+    void setUp() {}
+    void tearDown() {}
+
+    void testMultiClient();     // command lines from multiple clients and reply to the sender
+    void testWakeup();          // recvWait() without timeout returns by wakeup()
+    void testNonBlockingSend(); // send to the client which does not read never blocks
+    void testLongLine();        // client which never sends '\n' is closed
+    void testSendWhileRecvWait(); // send from other thread is written by the sleeping recvWait()
+
+    CPPUNIT_TEST_SUITE(TestTlSvr);
+    CPPUNIT_TEST(testMultiClient);
+    CPPUNIT_TEST(testWakeup);
+    CPPUNIT_TEST(testNonBlockingSend);
+    CPPUNIT_TEST(testLongLine);
+    CPPUNIT_TEST(testSendWhileRecvWait);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    int connectClient(int port) const; // return socket fd. -1 is error
+    bool sendStr(int sock, const std::string &str) const;
+    std::string recvStr(int sock, size_t size) const; // blocking receive until size byte
+
+    // recvWait() until a command line is received or timeout.
+    int recvLine(TlSvr &svr, std::string &line) const;
+    // Send data is written by recvWait(). Non blocking recvWait() to write it.
+    void flushSend(TlSvr &svr) const;
+};
+
+} // namespace unittest
+} // namespace grid_util
+} // namespace scene_rdl2
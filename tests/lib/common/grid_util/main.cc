@@ -3,8 +3,12 @@
 
 
 #include "TestArg.h"
+#include "TestLatencyLogCollector.h"
+#include "TestMetrics.h"
 #include "TestParser.h"
 #include "TestSha1.h"
+#include "TestSparseTileStream.h"
+#include "TestTlSvr.h"
 
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
@@ -16,8 +20,12 @@ main(int ac, char **av)
     using namespace scene_rdl2::grid_util::unittest;
 
     CPPUNIT_TEST_SUITE_REGISTRATION(TestArg);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestLatencyLogCollector);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestMetrics);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestParser);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestSha1);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestSparseTileStream);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestTlSvr);
 
     return pdevunit::run(ac, av);
 }
@@ -0,0 +1,255 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestRecZone.h"
+#include <scene_rdl2/common/rec_time/RecZone.h>
+
+#include <json/json.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>             // getpid
+
+namespace scene_rdl2 {
+namespace rec_time {
+namespace unittest {
+
+namespace {
+
+struct TraceEvent
+{
+    std::string mName;
+    int mPid;
+    unsigned mTid;
+    double mTs;                 // microsec
+    double mDur;                // microsec
+    unsigned mDepth;
+
+    bool operator <(const TraceEvent &b) const
+    {
+        return std::tie(mTid, mTs, mDepth, mName) < std::tie(b.mTid, b.mTs, b.mDepth, b.mName);
+    }
+    bool operator ==(const TraceEvent &b) const
+    {
+        return std::tie(mName, mPid, mTid, mTs, mDur, mDepth) ==
+               std::tie(b.mName, b.mPid, b.mTid, b.mTs, b.mDur, b.mDepth);
+    }
+};
+
+struct Trace
+{
+    std::vector<TraceEvent> mEvents;           // sorted by tid, ts
+    std::map<unsigned, std::string> mThreadNames;
+    std::set<int> mPids;
+};
+
+bool
+parseTrace(const std::string &json, Trace &trace)
+{
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::string errs;
+    std::istringstream istr(json);
+    if (!Json::parseFromStream(builder, istr, &root, &errs)) return false;
+    if (!root.isMember("traceEvents") || !root["traceEvents"].isArray()) return false;
+
+    for (const Json::Value &item : root["traceEvents"]) {
+        const std::string ph = item["ph"].asString();
+        trace.mPids.insert(item["pid"].asInt());
+        if (ph == "M") {
+            trace.mThreadNames[item["tid"].asUInt()] = item["args"]["name"].asString();
+        } else if (ph == "X") {
+            trace.mEvents.push_back(TraceEvent {item["name"].asString(),
+                                                item["pid"].asInt(),
+                                                item["tid"].asUInt(),
+                                                item["ts"].asDouble(),
+                                                item["dur"].asDouble(),
+                                                item["args"]["depth"].asUInt()});
+        } else {
+            return false;
+        }
+    }
+    std::sort(trace.mEvents.begin(), trace.mEvents.end());
+    return true;
+}
+
+size_t
+countEvents(const Trace &trace, const std::string &name)
+{
+    return std::count_if(trace.mEvents.begin(), trace.mEvents.end(),
+                         [&](const TraceEvent &event) { return event.mName == name; });
+}
+
+void
+nestedZones(int loop)
+{
+    for (int i = 0; i < loop; ++i) {
+        REC_ZONE("outer");
+        {
+            REC_ZONE("middle");
+            {
+                REC_ZONE("inner");
+            }
+        }
+        {
+            REC_ZONE("middle");
+        }
+    }
+}
+
+} // namespace
+
+void
+TestRecZone::setUp()
+{
+    RecZoneProfiler::get().enable(false);
+    RecZoneProfiler::get().reset();
+}
+
+void
+TestRecZone::tearDown()
+{
+    setUp();
+}
+
+void
+TestRecZone::testDisabled()
+{
+    nestedZones(10);
+
+    Trace trace;
+    CPPUNIT_ASSERT(parseTrace(RecZoneProfiler::get().toChromeTraceJson(), trace));
+    CPPUNIT_ASSERT(trace.mEvents.empty());
+}
+
+void
+TestRecZone::testNesting()
+{
+    RecZoneProfiler &profiler = RecZoneProfiler::get();
+    profiler.enable(true);
+    CPPUNIT_ASSERT(profiler.getTicksPerMicroSec() > 0.0f);
+    profiler.setThreadName("main");
+    nestedZones(3);
+    profiler.enable(false);
+
+    Trace trace;
+    CPPUNIT_ASSERT(parseTrace(profiler.toChromeTraceJson(), trace));
+    CPPUNIT_ASSERT(trace.mEvents.size() == 12);
+    CPPUNIT_ASSERT(countEvents(trace, "outer") == 3);
+    CPPUNIT_ASSERT(countEvents(trace, "middle") == 6);
+    CPPUNIT_ASSERT(countEvents(trace, "inner") == 3);
+    CPPUNIT_ASSERT(trace.mPids.size() == 1 && *trace.mPids.begin() == static_cast<int>(getpid()));
+
+    const unsigned tid = trace.mEvents.front().mTid;
+    CPPUNIT_ASSERT(trace.mThreadNames[tid] == "main");
+
+    // every zone is inside of its parent zone
+    const TraceEvent *parent[3] = {nullptr, nullptr, nullptr};
+    for (const TraceEvent &event : trace.mEvents) {
+        CPPUNIT_ASSERT(event.mTid == tid);
+        const unsigned expectDepth = (event.mName == "outer") ? 0 : ((event.mName == "middle") ? 1 : 2);
+        CPPUNIT_ASSERT(event.mDepth == expectDepth);
+        CPPUNIT_ASSERT(event.mDur >= 0.0);
+        if (event.mDepth > 0) {
+            const TraceEvent *p = parent[event.mDepth - 1];
+            CPPUNIT_ASSERT(p);
+            CPPUNIT_ASSERT(p->mTs <= event.mTs);
+            CPPUNIT_ASSERT(event.mTs + event.mDur <= p->mTs + p->mDur + 0.002); // 0.002 : json precision
+        }
+        parent[event.mDepth] = &event;
+    }
+}
+
+void
+TestRecZone::testMultiThread()
+{
+    constexpr int threadTotal = 8;
+    constexpr int loop = 1000;
+
+    RecZoneProfiler &profiler = RecZoneProfiler::get();
+    profiler.enable(true);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadTotal; ++i) {
+        threads.emplace_back([i]() {
+                RecZoneProfiler::get().setThreadName("worker" + std::to_string(i));
+                nestedZones(loop);
+            });
+    }
+    for (auto &thread : threads) thread.join();
+    profiler.enable(false);
+
+    Trace trace;
+    CPPUNIT_ASSERT(parseTrace(profiler.toChromeTraceJson(), trace));
+    CPPUNIT_ASSERT(trace.mEvents.size() == threadTotal * loop * 4);
+
+    // each thread has its own tid and keeps its own nesting depth
+    std::map<unsigned, size_t> eventTotal;
+    for (const TraceEvent &event : trace.mEvents) {
+        ++eventTotal[event.mTid];
+        if (event.mName == "outer") CPPUNIT_ASSERT(event.mDepth == 0);
+        if (event.mName == "inner") CPPUNIT_ASSERT(event.mDepth == 2);
+    }
+    CPPUNIT_ASSERT(eventTotal.size() == threadTotal);
+    std::set<std::string> names;
+    for (const auto &itr : eventTotal) {
+        CPPUNIT_ASSERT(itr.second == loop * 4);
+        names.insert(trace.mThreadNames[itr.first]);
+    }
+    CPPUNIT_ASSERT(names.size() == threadTotal);
+}
+
+void
+TestRecZone::testBinaryRoundTrip()
+{
+    RecZoneProfiler &profiler = RecZoneProfiler::get();
+    profiler.enable(true);
+    profiler.setThreadName("main");
+    nestedZones(100);
+    std::thread thread([]() {
+            RecZoneProfiler::get().setThreadName("sub \"thread\"");
+            nestedZones(50);
+        });
+    thread.join();
+    profiler.enable(false);
+
+    std::string json;
+    CPPUNIT_ASSERT(RecZoneProfiler::binaryToChromeTraceJson(profiler.toBinary(), json));
+
+    Trace direct, converted;
+    CPPUNIT_ASSERT(parseTrace(profiler.toChromeTraceJson(), direct));
+    CPPUNIT_ASSERT(parseTrace(json, converted));
+    CPPUNIT_ASSERT(direct.mEvents.size() == 600);
+    CPPUNIT_ASSERT(direct.mEvents == converted.mEvents);
+    CPPUNIT_ASSERT(direct.mThreadNames == converted.mThreadNames);
+    CPPUNIT_ASSERT(direct.mPids == converted.mPids);
+}
+
+void
+TestRecZone::testBrokenBinary()
+{
+    RecZoneProfiler &profiler = RecZoneProfiler::get();
+    profiler.enable(true);
+    nestedZones(10);
+    profiler.enable(false);
+
+    const std::string binary = profiler.toBinary();
+    std::string json;
+    CPPUNIT_ASSERT(!RecZoneProfiler::binaryToChromeTraceJson("", json));
+    CPPUNIT_ASSERT(!RecZoneProfiler::binaryToChromeTraceJson("XXXX" + binary.substr(4), json));
+    for (size_t size : {binary.size() / 4, binary.size() / 2, binary.size() - 1}) {
+        CPPUNIT_ASSERT(!RecZoneProfiler::binaryToChromeTraceJson(binary.substr(0, size), json));
+    }
+}
+
+} // namespace unittest
+} // namespace rec_time
+} // namespace scene_rdl2
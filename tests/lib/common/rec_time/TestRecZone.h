@@ -0,0 +1,37 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace scene_rdl2 {
+namespace rec_time {
+namespace unittest {
+
+class TestRecZone : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    void testDisabled();
+    void testNesting();
+    void testMultiThread();
+    void testBinaryRoundTrip(); // toBinary -> binaryToChromeTraceJson == toChromeTraceJson
+    void testBrokenBinary();
+
+    CPPUNIT_TEST_SUITE(TestRecZone);
+    CPPUNIT_TEST(testDisabled);
+    CPPUNIT_TEST(testNesting);
+    CPPUNIT_TEST(testMultiThread);
+    CPPUNIT_TEST(testBinaryRoundTrip);
+    CPPUNIT_TEST(testBrokenBinary);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} // namespace unittest
+} // namespace rec_time
+} // namespace scene_rdl2
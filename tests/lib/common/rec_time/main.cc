@@ -0,0 +1,19 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestRecZone.h"
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <scene_rdl2/pdevunit/pdevunit.h>
+
+int
+main(int ac, char **av)
+{
+    using namespace scene_rdl2::rec_time::unittest;
+
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestRecZone);
+
+    return pdevunit::run(ac, av);
+}
@@ -0,0 +1,161 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+//
+//
+#include "TestObjectLogs.h"
+
+#include <scene_rdl2/common/rec_time/RecTime.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace logging {
+namespace unittest {
+
+void
+TestObjectLogs::testBasic()
+{
+    ObjectLogs logs;
+    logs.setNumEvents(3);
+    CPPUNIT_ASSERT(logs.getNumEvents() == 3);
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(0)) == 0);
+
+    logs.log(LogEvent(0));
+    logs.log(LogEvent(2));
+    logs.log(LogEvent(2));
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(0)) == 1);
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(1)) == 0);
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(2)) == 2);
+
+    // growing keeps the current counts
+    logs.setNumEvents(20);
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(2)) == 2);
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(19)) == 0);
+
+    logs.clear();
+    for (int i = 0; i < logs.getNumEvents(); ++i) {
+        CPPUNIT_ASSERT(logs.getCount(LogEvent(i)) == 0);
+    }
+}
+
+void
+TestObjectLogs::testRegistry()
+{
+    LogEventRegistry registry;
+    LogEvent a = registry.createEvent(ERROR_LEVEL, "event A");
+    LogEvent b = registry.createEvent(WARN_LEVEL, "event B");
+    LogEvent c = registry.createEvent(FATAL_LEVEL, "event C");
+    CPPUNIT_ASSERT(registry.createEvent(ERROR_LEVEL, "event A") == a);
+    CPPUNIT_ASSERT(registry.getNumEvents() == 3);
+    CPPUNIT_ASSERT(registry.getDescription(b) == "event B");
+    CPPUNIT_ASSERT(registry.getLevel(b) == WARN_LEVEL);
+    CPPUNIT_ASSERT(registry.getLevel(c) == ERROR_LEVEL); // fatal is demoted to error
+
+    ObjectLogs logs;
+    registry.initLog(logs);
+    CPPUNIT_ASSERT(logs.getNumEvents() == 3);
+
+    registry.clear();
+    CPPUNIT_ASSERT(registry.getNumEvents() == 0);
+}
+
+void
+TestObjectLogs::testMerge()
+{
+    ObjectLogs a;
+    a.setNumEvents(4);
+    a.log(LogEvent(1));
+    a.log(LogEvent(3));
+
+    ObjectLogs b;
+    b += a;
+    b += a;
+    CPPUNIT_ASSERT(b.getNumEvents() == 4);
+    CPPUNIT_ASSERT(b.getCount(LogEvent(1)) == 2);
+    CPPUNIT_ASSERT(b.getCount(LogEvent(3)) == 2);
+
+    ObjectLogs c(b);
+    CPPUNIT_ASSERT(c.getCount(LogEvent(3)) == 2);
+    c = a;
+    CPPUNIT_ASSERT(c.getCount(LogEvent(3)) == 1);
+}
+
+template <typename LogFunc>
+float
+TestObjectLogs::runThreads(const int numThreads, LogFunc logFunc) const
+{
+    rec_time::RecTime recTime;
+    recTime.start();
+    std::vector<std::thread> threads;
+    for (int threadId = 0; threadId < numThreads; ++threadId) {
+        threads.emplace_back([&, threadId]() { logFunc(threadId); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return recTime.end();
+}
+
+void
+TestObjectLogs::testMultiThreadStress()
+{
+    const int numThreads = std::max(4u, std::thread::hardware_concurrency());
+    constexpr int numEvents = 5;
+    constexpr int numLoop = 200000;
+
+    ObjectLogs logs;
+    logs.setNumEvents(numEvents);
+
+    ObjectLogs merged;
+    merged.setNumEvents(numEvents);
+
+    runThreads(numThreads, [&](int threadId) {
+        for (int i = 0; i < numLoop; ++i) {
+            logs.log(LogEvent((i + threadId) % numEvents));
+            if (i % 10000 == 0) {
+                ObjectLogs local;
+                local.setNumEvents(numEvents);
+                local.log(LogEvent(0));
+                merged += local; // concurrent merge into the same object
+            }
+        }
+    });
+
+    int total = 0;
+    for (int i = 0; i < numEvents; ++i) {
+        total += logs.getCount(LogEvent(i));
+    }
+    CPPUNIT_ASSERT(total == numThreads * numLoop);
+    CPPUNIT_ASSERT(merged.getCount(LogEvent(0)) == numThreads * (numLoop / 10000));
+}
+
+void
+TestObjectLogs::testThroughput()
+{
+    const int numThreads = std::max(4u, std::thread::hardware_concurrency());
+    constexpr int numLoop = 1000000;
+
+    ObjectLogs logs;
+    logs.setNumEvents(1);
+
+    float sec = runThreads(numThreads, [&](int) {
+        for (int i = 0; i < numLoop; ++i) {
+            logs.log(LogEvent(0));
+        }
+    });
+    CPPUNIT_ASSERT(logs.getCount(LogEvent(0)) == numThreads * numLoop);
+
+    const float total = static_cast<float>(numThreads) * numLoop;
+    std::cerr << "TestObjectLogs::testThroughput threads:" << numThreads
+              << " shards:" << ObjectLogs::getNumShards()
+              << " time:" << sec * 1000.0f << "ms"
+              << " (" << total / sec / 1000000.0f << " Mlog/sec)" << std::endl;
+}
+
+} // namespace unittest
+} // namespace logging
+} // namespace scene_rdl2
+
@@ -0,0 +1,46 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <scene_rdl2/render/logging/logging.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+namespace scene_rdl2 {
+namespace logging {
+namespace unittest {
+
+class TestObjectLogs : public CppUnit::TestFixture
+{
+public:
+    void setUp() {}
+    void tearDown() {}
+
+    void testBasic();
+    void testRegistry();
+    void testMerge();
+    void testMultiThreadStress();
+    void testThroughput();
+
+    CPPUNIT_TEST_SUITE(TestObjectLogs);
+    CPPUNIT_TEST(testBasic);
+    CPPUNIT_TEST(testRegistry);
+    CPPUNIT_TEST(testMerge);
+    CPPUNIT_TEST(testMultiThreadStress);
+    CPPUNIT_TEST(testThroughput);
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    // Runs logFunc(threadId) on numThreads threads at the same time and returns the
+    // elapsed time in sec.
+    template <typename LogFunc>
+    float runThreads(const int numThreads, LogFunc logFunc) const;
+};
+
+} // namespace unittest
+} // namespace logging
+} // namespace scene_rdl2
+
@@ -0,0 +1,204 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+// Test rdla subset extraction by AsciiSubsetExtractor and AsciiReader::fromFileSubset()
+#include "TestAsciiSubset.h"
+
+#include <scene_rdl2/common/rec_time/RecTime.h>
+#include <scene_rdl2/scene/rdl2/AsciiSubsetExtractor.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+namespace unittest {
+
+namespace {
+
+size_t
+sceneObjectCount(const SceneContext& context)
+{
+    return static_cast<size_t>(std::distance(context.beginSceneObject(), context.endSceneObject()));
+}
+
+std::string
+assetName(const std::string& type, const int id)
+{
+    return "/seq/shot/" + type + std::to_string(id);
+}
+
+} // namespace
+
+void
+TestAsciiSubset::setUp()
+{
+}
+
+void
+TestAsciiSubset::tearDown()
+{
+}
+
+void
+TestAsciiSubset::testClosure()
+{
+    static const char* rdlaCode =
+        "-- FakeMaterial(\"/in/comment\")\n"
+        "local lightSet = LightSet(\"/lightset\")\n"
+        "SceneVariables {\n"
+        "    [\"layer\"] = Layer(\"/layer\"),\n"
+        "}\n"
+        "FakeTeapot(\"/teapot\") {\n"
+        "    [\"name\"] = \"FakeTeapot('/in/string')\",\n"
+        "}\n"
+        "FakeMaterial(\"/material\")\n"
+        "{\n"
+        "    [[ FakeMaterial(\"/in/long/string\") ]],\n"
+        "}\n"
+        "FakeMaterial(\"/unused\") {}\n"
+        "FakeTeapot(\"/in/long/string\") {}\n"
+        "Layer(\"/layer\") {\n"
+        "    {FakeTeapot(\"/teapot\"), \"\", FakeMaterial(\"/material\"), lightSet},\n"
+        "}\n"
+        "FakeMaterial(\"/material\") { [\"x\"] = 1 }; FakeTeapot(\"/other\") {}\n";
+
+    AsciiSubsetExtractor extractor;
+    extractor.indexString(rdlaCode);
+    CPPUNIT_ASSERT(extractor.getStatementCount() == 9);
+
+    std::vector<std::string> names = extractor.closure({"/teapot"});
+    std::sort(names.begin(), names.end());
+    // "/lightset" is only created by the local statement which is always kept.
+    // SceneVariables is always a root and pulls in the layer and the rest through it.
+    const std::vector<std::string> expected = {"/layer", "/material", "/teapot", "__SceneVariables__"};
+    CPPUNIT_ASSERT(names == expected);
+    CPPUNIT_ASSERT(std::find(names.begin(), names.end(), "/unused") == names.end());
+
+    // unknown root is ignored, the local statement and SceneVariables are always kept.
+    const std::string code = extractor.extract({"/not/exist"});
+    CPPUNIT_ASSERT(code.find("local lightSet") != std::string::npos);
+    CPPUNIT_ASSERT(code.find("SceneVariables {") != std::string::npos);
+    CPPUNIT_ASSERT(code.find("FakeMaterial(\"/unused\")") == std::string::npos);
+    CPPUNIT_ASSERT(code.find("FakeTeapot(\"/other\")") == std::string::npos);
+
+    AsciiSubsetExtractor noSceneVars;
+    noSceneVars.indexString("FakeTeapot(\"/teapot\") {}\nFakeTeapot(\"/other\") {}\n");
+    CPPUNIT_ASSERT(noSceneVars.closure({"/teapot"}) == std::vector<std::string>{"/teapot"});
+
+    // closure() and extract() are const and safe to be called concurrently
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::string>> results(8);
+    for (size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            for (int loop = 0; loop < 100; ++loop) {
+                results[i] = extractor.closure({"/layer"});
+                extractor.extract({"/layer"});
+            }
+            std::sort(results[i].begin(), results[i].end());
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto& result : results) CPPUNIT_ASSERT(result == expected);
+}
+
+void
+TestAsciiSubset::testFromFileSubset()
+{
+    writeScene("subset_full.rdla", 8);
+
+    SceneContext context;
+    AsciiReader reader(context);
+    reader.fromFileSubset("subset_full.rdla", {assetName("layer", 3)});
+
+    CPPUNIT_ASSERT(context.sceneObjectExists(assetName("layer", 3)));
+    CPPUNIT_ASSERT(context.sceneObjectExists(assetName("teapot", 3)));
+    CPPUNIT_ASSERT(context.sceneObjectExists(assetName("material", 3)));
+    CPPUNIT_ASSERT(context.sceneObjectExists("/seq/shot/lightset"));
+    CPPUNIT_ASSERT(!context.sceneObjectExists(assetName("layer", 2)));
+    CPPUNIT_ASSERT(!context.sceneObjectExists(assetName("teapot", 4)));
+
+    const Layer* layer = context.getSceneObject(assetName("layer", 3))->asA<Layer>();
+    CPPUNIT_ASSERT(layer->getAssignmentCount() == 4);
+    CPPUNIT_ASSERT(layer->lookupMaterial(0) == context.getSceneObject(assetName("material", 3)));
+
+    // SceneVariables is kept even though no root references it
+    CPPUNIT_ASSERT(context.getSceneVariables().get(SceneVariables::sImageWidth) == 1234);
+}
+
+void
+TestAsciiSubset::testBenchmark()
+{
+    const int assetTotal = 2000;
+    writeScene("subset_bench.rdla", assetTotal);
+
+    const size_t builtinTotal = sceneObjectCount(SceneContext());
+    rec_time::RecTime recTime;
+
+    recTime.start();
+    size_t subsetTotal = 0;
+    {
+        SceneContext context;
+        AsciiReader reader(context);
+        reader.fromFileSubset("subset_bench.rdla", {assetName("layer", assetTotal / 2)});
+        CPPUNIT_ASSERT(!context.sceneObjectExists(assetName("layer", 0)));
+        subsetTotal = sceneObjectCount(context) - builtinTotal;
+    }
+    const float subsetSec = recTime.end();
+
+    recTime.start();
+    size_t fullTotal = 0;
+    {
+        SceneContext context;
+        AsciiReader reader(context);
+        reader.fromFile("subset_bench.rdla");
+        CPPUNIT_ASSERT(context.sceneObjectExists(assetName("layer", 0)));
+        fullTotal = sceneObjectCount(context) - builtinTotal;
+    }
+    const float fullSec = recTime.end();
+
+    // one asset (teapot, material, layer) + shared LightSet vs all of them
+    CPPUNIT_ASSERT(subsetTotal == 3 + 1);
+    CPPUNIT_ASSERT(fullTotal == static_cast<size_t>(assetTotal) * 3 + 1);
+
+    std::cerr << "\n>> TestAsciiSubset assets:" << assetTotal
+              << " subset:" << subsetSec * 1000.0f << " ms (objects:" << subsetTotal << ")"
+              << " full:" << fullSec * 1000.0f << " ms (objects:" << fullTotal << ")\n";
+}
+
+void
+TestAsciiSubset::writeScene(const std::string& filename, const int assetTotal) const
+{
+    SceneContext context;
+    SceneVariables& sceneVars = context.getSceneVariables();
+    sceneVars.beginUpdate();
+    sceneVars.set(SceneVariables::sImageWidth, 1234);
+    sceneVars.endUpdate();
+
+    LightSet* lightSet = context.createSceneObject("LightSet", "/seq/shot/lightset")->asA<LightSet>();
+    for (int i = 0; i < assetTotal; ++i) {
+        Geometry* teapot = context.createSceneObject("FakeTeapot", assetName("teapot", i))->asA<Geometry>();
+        Material* material = context.createSceneObject("FakeMaterial", assetName("material", i))->asA<Material>();
+        Layer* layer = context.createSceneObject("Layer", assetName("layer", i))->asA<Layer>();
+        layer->beginUpdate();
+        for (int part = 0; part < 4; ++part) {
+            layer->assign(teapot, "part" + std::to_string(part), material, lightSet);
+        }
+        layer->endUpdate();
+    }
+
+    AsciiWriter writer(context);
+    writer.toFile(filename);
+}
+
+} // namespace unittest
+} // namespace rdl2
+} // namespace scene_rdl2
+
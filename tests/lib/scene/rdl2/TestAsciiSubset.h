@@ -0,0 +1,50 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+// Test rdla subset extraction by AsciiSubsetExtractor and AsciiReader::fromFileSubset()
+
+#include <scene_rdl2/scene/rdl2/rdl2.h>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+namespace unittest {
+
+class TestAsciiSubset : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    /// Test statement splitting and reference closure on hand written rdla.
+    void testClosure();
+
+    /// Test reading a subset of a written scene back into a SceneContext.
+    void testFromFileSubset();
+
+    /// Compare time and loaded object count of the subset load against the full load.
+    void testBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestAsciiSubset);
+    CPPUNIT_TEST(testClosure);
+    CPPUNIT_TEST(testFromFileSubset);
+    CPPUNIT_TEST(testBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    // Writes assetTotal assets (teapot, material and layer per asset, one shared
+    // LightSet) into filename.
+    void writeScene(const std::string& filename, const int assetTotal) const;
+};
+
+} // namespace unittest
+} // namespace rdl2
+} // namespace scene_rdl2
+
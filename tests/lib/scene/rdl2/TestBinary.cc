@@ -4,23 +4,47 @@
 
 #include "TestBinary.h"
 
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/scene/rdl2/AttributeKey.h>
 #include <scene_rdl2/scene/rdl2/BinaryReader.h>
 #include <scene_rdl2/scene/rdl2/BinaryWriter.h>
+#include <scene_rdl2/scene/rdl2/Camera.h>
+#include <scene_rdl2/scene/rdl2/Geometry.h>
 #include <scene_rdl2/scene/rdl2/SceneClass.h>
 #include <scene_rdl2/scene/rdl2/SceneContext.h>
 #include <scene_rdl2/scene/rdl2/SceneObject.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerSink.h>
 
 #include <scene_rdl2/common/except/exceptions.h>
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
+#include <fstream>
+#include <iostream>
 #include <string>
 
+#include <unistd.h>
+
 namespace scene_rdl2 {
 namespace rdl2 {
 namespace unittest {
 
+namespace {
+
+size_t
+currentRssKB()
+{
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+} // namespace
+
 void
 TestBinary::setUp()
 {
@@ -624,7 +648,632 @@ TestBinary::testNullReferences()
     CPPUNIT_ASSERT(pizza->getBinding(stringKey) == nullptr);
 }
 
+void
+TestBinary::testParallelRoundtrip()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<Int> intKey = sceneClass->getAttributeKey<Int>("int");
+    AttributeKey<Float> floatKey = sceneClass->getAttributeKey<Float>("float");
+    AttributeKey<String> stringKey = sceneClass->getAttributeKey<String>("string");
+    AttributeKey<SceneObject*> sceneObjectKey = sceneClass->getAttributeKey<SceneObject*>("scene object");
+    AttributeKey<SceneObjectVector> sceneObjectVecKey = sceneClass->getAttributeKey<SceneObjectVector>("scene object vector");
+    AttributeKey<StringVector> stringVecKey = sceneClass->getAttributeKey<StringVector>("string vector");
+    AttributeKey<Vec3fVector> vec3fVecKey = sceneClass->getAttributeKey<Vec3fVector>("vec3f vector");
+
+    const int objTotal = 500;
+    std::vector<SceneObject*> objs;
+    for (int i = 0; i < objTotal; ++i) {
+        objs.push_back(context.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i)));
+    }
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = objs[i];
+        obj->beginUpdate();
+        obj->set(intKey, Int(i));
+        obj->set(floatKey, static_cast<float>(i), TIMESTEP_BEGIN);
+        obj->set(floatKey, static_cast<float>(i) + 0.5f, TIMESTEP_END);
+        obj->set(stringKey, "name" + std::to_string(i));
+        // forward and backward references
+        obj->set(sceneObjectKey, objs[(i + 1) % objTotal]);
+        obj->set(sceneObjectVecKey, SceneObjectVector {objs[(i + 7) % objTotal], nullptr, objs[i / 2]});
+        obj->setBinding(stringKey, (i % 3 == 0) ? objs[(i + 3) % objTotal] : nullptr);
+        obj->set(stringVecKey, StringVector(i % 5, "part" + std::to_string(i)));
+        obj->set(vec3fVecKey, Vec3fVector(i * 10, Vec3f(static_cast<float>(i), 1.0f, 2.0f)));
+        obj->endUpdate();
+    }
+
+    auto encode = [&](const SceneContext& ctx, bool parallel, std::string& manifest, std::string& payload) {
+        BinaryWriter writer(ctx);
+        writer.setParallelEncoding(parallel);
+        writer.toBytes(manifest, payload);
+    };
+
+    std::string serialManifest, serialPayload;
+    encode(context, false, serialManifest, serialPayload);
+    {
+        std::string manifest, payload;
+        encode(context, true, manifest, payload);
+        CPPUNIT_ASSERT(manifest == serialManifest);
+        CPPUNIT_ASSERT(payload == serialPayload);
+    }
+
+    // Decode serially and in parallel, then re-encode both serially. The decoded
+    // scenes have to be the same as the original one.
+    for (bool parallel : {false, true}) {
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.setParallelDecoding(parallel);
+        reader.fromBytes(serialManifest, serialPayload);
+
+        std::string manifest, payload;
+        encode(readContext, false, manifest, payload);
+        CPPUNIT_ASSERT(manifest == serialManifest);
+        CPPUNIT_ASSERT(payload == serialPayload);
+
+        for (int i = 0; i < objTotal; i += 37) {
+            const SceneObject* obj = readContext.getSceneObject("/seq/shot/obj" + std::to_string(i));
+            CPPUNIT_ASSERT(obj->get(intKey) == Int(i));
+            CPPUNIT_ASSERT(obj->get(floatKey, TIMESTEP_END) == static_cast<float>(i) + 0.5f);
+            CPPUNIT_ASSERT(obj->get(sceneObjectKey)->getName() == "/seq/shot/obj" + std::to_string((i + 1) % objTotal));
+            CPPUNIT_ASSERT(obj->get(sceneObjectVecKey)[1] == nullptr);
+            CPPUNIT_ASSERT(obj->get(vec3fVecKey).size() == static_cast<size_t>(i * 10));
+        }
+    }
+
+    // Parallel decoding of a delta update on top of a parallel decoded scene.
+    {
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.setParallelDecoding(true);
+        reader.fromBytes(serialManifest, serialPayload);
+
+        SceneObject* obj = readContext.getSceneObject("/seq/shot/obj0");
+        obj->beginUpdate();
+        obj->set(intKey, Int(-1));
+        obj->endUpdate();
+        readContext.commitAllChanges();
+        obj->beginUpdate();
+        obj->set(intKey, Int(-2));
+        obj->endUpdate();
+
+        std::string deltaManifest, deltaPayload;
+        BinaryWriter writer(readContext);
+        writer.setDeltaEncoding(true);
+        writer.toBytes(deltaManifest, deltaPayload);
+
+        SceneContext readContext2;
+        BinaryReader reader2(readContext2);
+        reader2.setParallelDecoding(true);
+        reader2.fromBytes(serialManifest, serialPayload);
+        reader2.fromBytes(deltaManifest, deltaPayload);
+        CPPUNIT_ASSERT(readContext2.getSceneObject("/seq/shot/obj0")->get(intKey) == Int(-2));
+    }
+}
+
+void
+TestBinary::testParallelCreationOrder()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<SceneObjectVector> sceneObjectVecKey = sceneClass->getAttributeKey<SceneObjectVector>("scene object vector");
+
+    // Names are in the reverse of the creation order, so the manifest order
+    // (by name) differs from the original creation order.
+    const int refTotal = 8;
+    SceneObjectVector refs;
+    for (int i = 0; i < refTotal; ++i) {
+        refs.push_back(context.createSceneObject("LibLadenCamera", "/cam" + std::to_string(refTotal - i)));
+        refs.push_back(context.createSceneObject("LibLadenGeometry", "/geom" + std::to_string(refTotal - i)));
+    }
+    const int objTotal = 64;
+    std::vector<SceneObject*> objs;
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = context.createSceneObject("ExtensiveObject", "/obj" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(sceneObjectVecKey, SceneObjectVector {refs[(i * 3) % refs.size()], refs[(i * 5 + 1) % refs.size()]});
+        obj->endUpdate();
+        objs.push_back(obj);
+    }
+
+    // What consumers of the creation order see.
+    auto creationOrder = [](const SceneContext& ctx) {
+        std::vector<std::string> names;
+        for (const Camera* camera : ctx.getCameras()) names.push_back(camera->getName());
+        for (auto itr = ctx.beginGeometry(); itr != ctx.endGeometry(); ++itr) names.push_back((*itr)->getName());
+        return names;
+    };
+    auto checkOrder = [&](const std::string& manifest, const std::string& payload) {
+        std::vector<std::string> serialOrder;
+        {
+            SceneContext readContext;
+            BinaryReader reader(readContext);
+            reader.fromBytes(manifest, payload);
+            serialOrder = creationOrder(readContext);
+        }
+        CPPUNIT_ASSERT(serialOrder.size() == refs.size());
+
+        for (int loop = 0; loop < 8; ++loop) {
+            SceneContext readContext;
+            BinaryReader reader(readContext);
+            reader.setParallelDecoding(true);
+            reader.fromBytes(manifest, payload);
+            CPPUNIT_ASSERT(creationOrder(readContext) == serialOrder);
+        }
+    };
+
+    // All the referenced objects are defined in the data.
+    std::string manifest, payload;
+    {
+        BinaryWriter writer(context);
+        writer.toBytes(manifest, payload);
+    }
+    checkOrder(manifest, payload);
+
+    // Delta update which only holds the referencing objects. The cameras and
+    // geometries are created by the references.
+    context.commitAllChanges();
+    for (int i = 0; i < objTotal; ++i) {
+        objs[i]->beginUpdate();
+        objs[i]->set(sceneObjectVecKey, SceneObjectVector {refs[(i * 7 + 2) % refs.size()], refs[i % refs.size()]});
+        objs[i]->endUpdate();
+    }
+    std::string deltaManifest, deltaPayload;
+    {
+        BinaryWriter writer(context);
+        writer.setDeltaEncoding(true);
+        writer.toBytes(deltaManifest, deltaPayload);
+    }
+    checkOrder(deltaManifest, deltaPayload);
+}
+
+void
+TestBinary::testDedupEncoding()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<FloatVector> floatVecKey = sceneClass->getAttributeKey<FloatVector>("float vector");
+    AttributeKey<StringVector> stringVecKey = sceneClass->getAttributeKey<StringVector>("string vector");
+    AttributeKey<Vec3fVector> vec3fVecKey = sceneClass->getAttributeKey<Vec3fVector>("vec3f vector");
+
+    FloatVector floats(1000);
+    StringVector strings(100);
+    for (size_t i = 0; i < floats.size(); ++i) floats[i] = static_cast<float>(i) * 0.5f;
+    for (size_t i = 0; i < strings.size(); ++i) strings[i] = "part" + std::to_string(i);
+    Vec3fVector unique(100, Vec3f(1.0f, 2.0f, 3.0f));
+
+    const int objTotal = 20;
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = context.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(floatVecKey, floats);
+        obj->set(stringVecKey, strings);
+        unique[0].x = static_cast<float>(i); // every object has its own value
+        obj->set(vec3fVecKey, unique);
+        obj->endUpdate();
+    }
+
+    auto verify = [&](const std::string& manifest, const std::string& payload, bool parallel) {
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.setParallelDecoding(parallel);
+        reader.fromBytes(manifest, payload);
+        const SceneObject* obj0 = readContext.getSceneObject("/seq/shot/obj0");
+        for (int i = 0; i < objTotal; ++i) {
+            const SceneObject* obj = readContext.getSceneObject("/seq/shot/obj" + std::to_string(i));
+            CPPUNIT_ASSERT(obj->get(floatVecKey) == floats);
+            CPPUNIT_ASSERT(obj->get(stringVecKey) == strings);
+            CPPUNIT_ASSERT(obj->get(vec3fVecKey).size() == unique.size());
+            CPPUNIT_ASSERT(obj->get(vec3fVecKey)[0].x == static_cast<float>(i));
+
+            // The entries are decoded once and shared by the objects.
+            CPPUNIT_ASSERT(obj->getShared(floatVecKey) != nullptr);
+            CPPUNIT_ASSERT(&obj->get(floatVecKey) == &obj0->get(floatVecKey));
+            CPPUNIT_ASSERT(&obj->get(stringVecKey) == &obj0->get(stringVecKey));
+        }
+    };
+
+    std::string plainManifest, plainPayload;
+    BinaryWriter plainWriter(context);
+    plainWriter.toBytes(plainManifest, plainPayload);
+
+    std::string serialManifest, serialPayload;
+    for (bool parallel : {false, true}) {
+        std::string manifest, payload;
+        BinaryWriter writer(context);
+        writer.setDedupEncoding(true);
+        writer.setParallelEncoding(parallel);
+        writer.toBytes(manifest, payload);
+
+        // float and string vectors are written once, vec3f vectors differ per object
+        CPPUNIT_ASSERT(payload.size() + (objTotal - 1) * floats.size() * sizeof(float) < plainPayload.size());
+        verify(manifest, payload, parallel);
+
+        // The entry ids don't depend on the encoding threads.
+        if (parallel) {
+            CPPUNIT_ASSERT(manifest == serialManifest);
+            CPPUNIT_ASSERT(payload == serialPayload);
+        } else {
+            serialManifest = manifest;
+            serialPayload = payload;
+        }
+    }
+
+    // The shared values are written once again.
+    {
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.fromBytes(serialManifest, serialPayload);
+        std::string manifest, payload;
+        BinaryWriter writer(readContext);
+        writer.setDedupEncoding(true);
+        writer.toBytes(manifest, payload);
+        CPPUNIT_ASSERT(payload.size() == serialPayload.size());
+        verify(manifest, payload, false);
+    }
+
+    // Vectors below the threshold are inlined.
+    {
+        std::string manifest, payload;
+        BinaryWriter writer(context);
+        writer.setDedupEncoding(true, floats.size() + 1);
+        writer.toBytes(manifest, payload);
+        CPPUNIT_ASSERT(manifest == plainManifest);
+        CPPUNIT_ASSERT(payload == plainPayload);
+    }
+
+    // Delta encoding only dedups the values of the changed objects.
+    context.commitAllChanges();
+    FloatVector floats2(floats.size(), 7.0f);
+    for (int i = 0; i < objTotal; i += 2) {
+        SceneObject* obj = context.getSceneObject("/seq/shot/obj" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(floatVecKey, floats2);
+        obj->endUpdate();
+    }
+    {
+        std::string manifest, payload;
+        BinaryWriter writer(context);
+        writer.setDeltaEncoding(true);
+        writer.setDedupEncoding(true);
+        writer.toBytes(manifest, payload);
+        CPPUNIT_ASSERT(payload.size() < 2 * floats2.size() * sizeof(float));
+
+        SceneContext readContext;
+        for (int i = 0; i < objTotal; ++i) {
+            readContext.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i));
+        }
+        const SceneObject* defaults = readContext.createSceneObject("ExtensiveObject", "/seq/shot/defaults");
+        BinaryReader reader(readContext);
+        reader.fromBytes(manifest, payload);
+        for (int i = 0; i < objTotal; ++i) {
+            const SceneObject* obj = readContext.getSceneObject("/seq/shot/obj" + std::to_string(i));
+            if (i % 2 == 0) {
+                CPPUNIT_ASSERT(obj->get(floatVecKey) == floats2);
+            } else {
+                CPPUNIT_ASSERT(obj->get(floatVecKey) == defaults->get(floatVecKey));
+            }
+        }
+    }
+}
+
+void
+TestBinary::testDedupBenchmark()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<FloatVector> floatVecKey = sceneClass->getAttributeKey<FloatVector>("float vector");
+    AttributeKey<Vec3fVector> vec3fVecKey = sceneClass->getAttributeKey<Vec3fVector>("vec3f vector");
+
+    // Instanced assets : a few distinct vectors shared by many objects.
+    const int objTotal = 2000;
+    const int variantTotal = 8;
+    std::vector<Vec3fVector> variants(variantTotal);
+    for (int v = 0; v < variantTotal; ++v) {
+        variants[v].resize(10000);
+        for (size_t i = 0; i < variants[v].size(); ++i) {
+            variants[v][i] = Vec3f(static_cast<float>(i), static_cast<float>(v), 0.0f);
+        }
+    }
+    FloatVector floats(1000, 1.0f);
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = context.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(vec3fVecKey, variants[i % variantTotal]);
+        obj->set(floatVecKey, floats);
+        obj->endUpdate();
+    }
+
+    rec_time::RecTime recTime;
+    for (bool dedup : {false, true}) {
+        std::string manifest, payload;
+        BinaryWriter writer(context);
+        writer.setDedupEncoding(dedup);
+        recTime.start();
+        writer.toBytes(manifest, payload);
+        float encodeSec = recTime.end();
+
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        recTime.start();
+        reader.fromBytes(manifest, payload);
+        float decodeSec = recTime.end();
+
+        std::cerr << "\n>> TestBinary " << (dedup ? "dedup" : "plain")
+                  << " objs:" << objTotal
+                  << " payload:" << payload.size() / 1024 << " KB"
+                  << " encode:" << encodeSec * 1000.0f << " ms"
+                  << " decode:" << decodeSec * 1000.0f << " ms";
+    }
+    std::cerr << '\n';
+}
+
+void
+TestBinary::testStreamVByteEncoding()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<IntVector> intVecKey = sceneClass->getAttributeKey<IntVector>("int vector");
+
+    const int objTotal = 16;
+    IntVector ints(1000);
+    for (size_t i = 0; i < ints.size(); ++i) {
+        ints[i] = (i % 3 == 0) ? -static_cast<int>(i * i) : static_cast<int>(i % 7);
+    }
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = context.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i));
+        obj->beginUpdate();
+        // odd objects share the same vector so that dedup kicks in
+        obj->set(intVecKey, (i % 2) ? ints : IntVector(i, i));
+        obj->endUpdate();
+    }
+
+    std::string plainManifest, plainPayload;
+    {
+        BinaryWriter writer(context);
+        writer.toBytes(plainManifest, plainPayload);
+    }
+
+    for (bool dedup : {false, true}) {
+        std::string manifest, payload;
+        BinaryWriter writer(context);
+        writer.setStreamVByteEncoding(true);
+        writer.setDedupEncoding(dedup);
+        writer.toBytes(manifest, payload);
+        if (!dedup) {
+            CPPUNIT_ASSERT(payload.size() < plainPayload.size());
+        }
+
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.fromBytes(manifest, payload);
+        for (int i = 0; i < objTotal; ++i) {
+            const SceneObject* obj = readContext.getSceneObject("/seq/shot/obj" + std::to_string(i));
+            CPPUNIT_ASSERT(obj->get(intVecKey) == ((i % 2) ? ints : IntVector(i, i)));
+        }
+    }
+}
+
+void
+TestBinary::testSinkEncoding()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<FloatVector> floatVecKey = sceneClass->getAttributeKey<FloatVector>("float vector");
+    AttributeKey<StringVector> stringVecKey = sceneClass->getAttributeKey<StringVector>("string vector");
+
+    const int objTotal = 16;
+    FloatVector floats(10000);
+    for (size_t i = 0; i < floats.size(); ++i) {
+        floats[i] = static_cast<float>(i);
+    }
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = context.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(floatVecKey, floats);
+        obj->set(stringVecKey, StringVector(i, "obj" + std::to_string(i)));
+        obj->endUpdate();
+    }
+
+    for (bool dedup : {false, true}) {
+        std::string manifest, payload;
+        BinaryWriter writer(context);
+        writer.setDedupEncoding(dedup);
+        writer.toBytes(manifest, payload);
+
+        // small chunks, so that the values are split between chunks
+        std::string sinkManifest, sinkPayload;
+        ValueContainerChunkSink sink(4096);
+        writer.toBytes(sinkManifest, sink);
+        CPPUNIT_ASSERT(sink.getChunkTotal() > 1);
+        sink.copyTo(sinkPayload);
+        CPPUNIT_ASSERT(sinkManifest == manifest);
+        CPPUNIT_ASSERT(sinkPayload == payload);
+
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.fromBytes(sinkManifest, sinkPayload);
+        for (int i = 0; i < objTotal; ++i) {
+            const SceneObject* obj = readContext.getSceneObject("/seq/shot/obj" + std::to_string(i));
+            CPPUNIT_ASSERT(obj->get(floatVecKey) == floats);
+            CPPUNIT_ASSERT(obj->get(stringVecKey) == StringVector(i, "obj" + std::to_string(i)));
+        }
+    }
+}
+
+void
+TestBinary::testLazyDecoding()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<Float> floatKey = sceneClass->getAttributeKey<Float>("float");
+    AttributeKey<FloatVector> floatVecKey = sceneClass->getAttributeKey<FloatVector>("float vector");
+    AttributeKey<StringVector> stringVecKey = sceneClass->getAttributeKey<StringVector>("string vector");
+    AttributeKey<Vec3fVector> vec3fVecKey = sceneClass->getAttributeKey<Vec3fVector>("vec3f vector");
+    AttributeKey<IntVector> intVecKey = sceneClass->getAttributeKey<IntVector>("int vector");
+    AttributeKey<LongVector> longVecKey = sceneClass->getAttributeKey<LongVector>("long vector");
+
+    // Int/Long vectors are variable length encoded, mix small and large
+    // magnitudes so the encoded element sizes differ.
+    IntVector ints(3000);
+    for (size_t i = 0; i < ints.size(); ++i) {
+        ints[i] = (i % 3 == 0) ? static_cast<Int>(i) : -static_cast<Int>(i * 100003);
+    }
+    LongVector longs(3000);
+    for (size_t i = 0; i < longs.size(); ++i) {
+        longs[i] = (i % 2 == 0) ? static_cast<Long>(i) : static_cast<Long>(i) * 4000000007L;
+    }
+
+    FloatVector floats(5000);
+    for (size_t i = 0; i < floats.size(); ++i) floats[i] = static_cast<float>(i);
+    StringVector strings(2000);
+    for (size_t i = 0; i < strings.size(); ++i) strings[i] = "s" + std::to_string(i);
+    Vec3fVector smallVec(10, Vec3f(1.0f, 2.0f, 3.0f));
+
+    SceneObject* obj = context.createSceneObject("ExtensiveObject", "/seq/shot/obj");
+    obj->beginUpdate();
+    obj->set(floatKey, 2.5f);
+    obj->set(floatVecKey, floats);
+    obj->set(stringVecKey, strings);
+    obj->set(vec3fVecKey, smallVec);
+    obj->set(intVecKey, ints);
+    obj->set(longVecKey, longs);
+    obj->endUpdate();
+
+    std::string manifest, payload;
+    BinaryWriter writer(context);
+    writer.toBytes(manifest, payload);
+
+    {
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.setLazyDecoding(true, 1000);
+        reader.fromBytes(manifest, payload);
+        std::string().swap(payload); // lazy values must not depend on the caller's buffer
+
+        SceneObject* readObj = readContext.getSceneObject("/seq/shot/obj");
+        CPPUNIT_ASSERT(readObj->hasLazyValues());
+        CPPUNIT_ASSERT(readObj->get(floatKey) == 2.5f);
+        CPPUNIT_ASSERT(readObj->get(vec3fVecKey) == smallVec); // below the threshold
+        CPPUNIT_ASSERT(readObj->get(intVecKey) == ints);
+        CPPUNIT_ASSERT(readObj->get(longVecKey) == longs);
+
+        // Concurrent first access.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, 64),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i < range.end(); ++i) {
+                                  CPPUNIT_ASSERT(readObj->get(floatVecKey) == floats);
+                              }
+                          });
+        CPPUNIT_ASSERT(readObj->hasLazyValues()); // string vector is still pending
+
+        // set() compares against the decoded value, so setting the same
+        // value leaves nothing to delta encode.
+        readContext.commitAllChanges();
+        readObj->beginUpdate();
+        readObj->set(stringVecKey, strings);
+        readObj->endUpdate();
+        CPPUNIT_ASSERT(!readObj->hasLazyValues());
+        CPPUNIT_ASSERT(readObj->get(stringVecKey) == strings);
+        {
+            std::string deltaManifest, deltaPayload;
+            BinaryWriter deltaWriter(readContext);
+            deltaWriter.setDeltaEncoding(true);
+            deltaWriter.toBytes(deltaManifest, deltaPayload);
+            CPPUNIT_ASSERT(deltaPayload.empty());
+        }
+
+        // Writers see the decoded values.
+        std::string manifest2, payload2;
+        BinaryWriter writer2(readContext);
+        writer2.toBytes(manifest2, payload2);
+        SceneContext readContext2;
+        BinaryReader reader2(readContext2);
+        reader2.fromBytes(manifest2, payload2);
+        CPPUNIT_ASSERT(readContext2.getSceneObject("/seq/shot/obj")->get(floatVecKey) == floats);
+    }
+
+    // Lazy values in the dedup table, read from a file.
+    SceneObject* obj2 = context.createSceneObject("ExtensiveObject", "/seq/shot/obj2");
+    obj2->beginUpdate();
+    obj2->set(floatVecKey, floats);
+    obj2->set(intVecKey, ints);
+    obj2->set(longVecKey, longs);
+    obj2->endUpdate();
+    BinaryWriter dedupWriter(context);
+    dedupWriter.setDedupEncoding(true);
+    dedupWriter.toFile("lazy.rdlb");
+
+    SceneContext readContext;
+    BinaryReader reader(readContext);
+    reader.setLazyDecoding(true, 1000);
+    reader.setParallelDecoding(true);
+    reader.fromFile("lazy.rdlb");
+    SceneObject* readObj2 = readContext.getSceneObject("/seq/shot/obj2");
+    CPPUNIT_ASSERT(readObj2->hasLazyValues());
+    readObj2->materializeLazyValues();
+    CPPUNIT_ASSERT(!readObj2->hasLazyValues());
+    CPPUNIT_ASSERT(readObj2->get(floatVecKey) == floats);
+    CPPUNIT_ASSERT(readObj2->get(intVecKey) == ints);
+    CPPUNIT_ASSERT(readObj2->get(longVecKey) == longs);
+    CPPUNIT_ASSERT(readContext.getSceneObject("/seq/shot/obj")->get(stringVecKey) == strings);
+}
+
+void
+TestBinary::testLazyBenchmark()
+{
+    SceneContext context;
+    const SceneClass* sceneClass = context.createSceneClass("ExtensiveObject");
+    AttributeKey<Float> floatKey = sceneClass->getAttributeKey<Float>("float");
+    AttributeKey<Vec3fVector> vec3fVecKey = sceneClass->getAttributeKey<Vec3fVector>("vec3f vector");
+
+    // Heavy geometry like objects where the consumer only queries a scalar.
+    const int objTotal = 200;
+    Vec3fVector points(50000);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = Vec3f(static_cast<float>(i), 0.0f, 1.0f);
+    }
+    for (int i = 0; i < objTotal; ++i) {
+        SceneObject* obj = context.createSceneObject("ExtensiveObject", "/seq/shot/obj" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(floatKey, static_cast<float>(i));
+        obj->set(vec3fVecKey, points);
+        obj->endUpdate();
+    }
+    std::string manifest, payload;
+    BinaryWriter writer(context);
+    writer.toBytes(manifest, payload);
+
+    rec_time::RecTime recTime;
+    for (bool lazy : {true, false}) {
+        const size_t rssStart = currentRssKB();
+
+        SceneContext readContext;
+        BinaryReader reader(readContext);
+        reader.setLazyDecoding(lazy);
+        recTime.start();
+        reader.fromBytes(manifest, payload);
+        CPPUNIT_ASSERT(readContext.getSceneObject("/seq/shot/obj0")->get(floatKey) == 0.0f);
+        const float firstQuerySec = recTime.end();
+        const size_t rssQuery = currentRssKB();
+
+        recTime.start();
+        float sum = 0.0f;
+        for (int i = 0; i < objTotal; ++i) {
+            sum += readContext.getSceneObject("/seq/shot/obj" + std::to_string(i))->get(vec3fVecKey).back().x;
+        }
+        const float allSec = recTime.end();
+        CPPUNIT_ASSERT(sum == static_cast<float>(objTotal) * points.back().x);
+
+        std::cerr << "\n>> TestBinary " << (lazy ? "lazy " : "eager")
+                  << " payload:" << payload.size() / (1024 * 1024) << " MB"
+                  << " firstQuery:" << firstQuerySec * 1000.0f << " ms"
+                  << " rss:" << (rssQuery > rssStart ? rssQuery - rssStart : 0) / 1024 << " MB"
+                  << " allVectors:" << allSec * 1000.0f << " ms"
+                  << " finalRss:" << (currentRssKB() > rssStart ? currentRssKB() - rssStart : 0) / 1024 << " MB";
+    }
+    std::cerr << '\n';
+}
+
 } // namespace unittest
 } // namespace rdl2
 } // namespace scene_rdl2
-
@@ -32,11 +32,49 @@ public:
     /// and bindings.
     void testNullReferences();
 
+    /// Test that parallel encoding is byte-identical to the serial encoding and
+    /// that parallel decoding produces the same scene as the serial decoding.
+    void testParallelRoundtrip();
+
+    /// Test that parallel decoding creates the SceneObjects (cameras and
+    /// geometries) in the same order as serial decoding, also when they are
+    /// only referenced by a delta update.
+    void testParallelCreationOrder();
+
+    /// Test that identical vector values are written once with dedup encoding,
+    /// alone and combined with delta and parallel encoding.
+    void testDedupEncoding();
+
+    /// Compare payload size and encode/decode time with and without dedup.
+    void testDedupBenchmark();
+
+    /// Test that IntVector values roundtrip with stream VByte encoding, alone
+    /// and combined with dedup encoding.
+    void testStreamVByteEncoding();
+
+    /// Test that a sink payload is the same as a std::string payload.
+    void testSinkEncoding();
+
+    /// Test that lazy decoding defers large vectors until the first get(),
+    /// also with concurrent first access, set() and re-encoding.
+    void testLazyDecoding();
+
+    /// Compare time to first query and RSS of lazy and eager decoding.
+    void testLazyBenchmark();
+
     CPPUNIT_TEST_SUITE(TestBinary);
     CPPUNIT_TEST(testRoundtrip);
     CPPUNIT_TEST(testTransientEncoding);
     CPPUNIT_TEST(testDeltaEncoding);
     CPPUNIT_TEST(testNullReferences);
+    CPPUNIT_TEST(testParallelRoundtrip);
+    CPPUNIT_TEST(testParallelCreationOrder);
+    CPPUNIT_TEST(testDedupEncoding);
+    CPPUNIT_TEST(testDedupBenchmark);
+    CPPUNIT_TEST(testStreamVByteEncoding);
+    CPPUNIT_TEST(testSinkEncoding);
+    CPPUNIT_TEST(testLazyDecoding);
+    CPPUNIT_TEST(testLazyBenchmark);
     CPPUNIT_TEST_SUITE_END();
 
 private:
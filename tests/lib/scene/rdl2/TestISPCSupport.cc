@@ -0,0 +1,246 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "TestISPCSupport.h"
+#include "TestISPCSupport_ispc_stubs.h"
+
+#include <scene_rdl2/common/platform/Platform.h>
+#include <scene_rdl2/common/rec_time/RecTime.h>
+#include <scene_rdl2/scene/rdl2/AttributeKey.h>
+#include <scene_rdl2/scene/rdl2/Dso.h>
+#include <scene_rdl2/scene/rdl2/SceneClass.h>
+#include <scene_rdl2/scene/rdl2/SceneObject.h>
+#include <scene_rdl2/scene/rdl2/Types.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+namespace unittest {
+
+namespace {
+
+// The ISPC code is built with --opt=force-aligned-memory, so the foreach
+// loops issue aligned vector loads and stores. Every array passed to it has
+// to be aligned to the widest target vector (64 bytes for avx512), which
+// std::vector doesn't guarantee.
+template <typename T>
+class AlignedArray
+{
+public:
+    static_assert(std::is_trivially_destructible<T>::value, "AlignedArray<T> requires a trivial T");
+    static constexpr size_t sAlignment = 64;
+
+    explicit AlignedArray(size_t size) :
+        mSize(size),
+        mData(static_cast<T*>(util::alignedMalloc(std::max(size, size_t(1)) * sizeof(T), sAlignment)))
+    {
+        std::memset(static_cast<void*>(mData), 0, mSize * sizeof(T));
+    }
+    explicit AlignedArray(const std::vector<T>& src) : AlignedArray(src.size())
+    {
+        std::memcpy(static_cast<void*>(mData), src.data(), mSize * sizeof(T));
+    }
+    ~AlignedArray() { util::alignedFree(mData); }
+
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+
+    T* data() { return mData; }
+    T& operator[](size_t i) { return mData[i]; }
+    const T& operator[](size_t i) const { return mData[i]; }
+
+    bool operator==(const AlignedArray& rhs) const
+    {
+        if (mSize != rhs.mSize) return false;
+        for (size_t i = 0; i < mSize; ++i) {
+            if (!(mData[i] == rhs.mData[i])) return false;
+        }
+        return true;
+    }
+
+private:
+    size_t mSize;
+    T* mData;
+};
+
+// The ISPC functions take the SceneObjects as raw byte pointers and the keys
+// as the opaque handles declared in ISPCSupport.h.
+int8_t**
+asIspc(AlignedArray<SceneObject*>& objects)
+{
+    return reinterpret_cast<int8_t**>(objects.data());
+}
+
+template <typename KeyISPC, typename T>
+const KeyISPC*
+asIspc(const AttributeKey<T>& key)
+{
+    return reinterpret_cast<const KeyISPC*>(&key);
+}
+
+} // namespace
+
+void
+TestISPCSupport::setUp()
+{
+    mDsoClass.reset(new SceneClass(nullptr, "ExampleObject", ObjectFactory::createDsoFactory("ExampleObject", ".")));
+
+    mBoolKey = mDsoClass->declareAttribute<Bool>("bool", false);
+    mIntKey = mDsoClass->declareAttribute<Int>("int", Int(0));
+    mFloatKey = mDsoClass->declareAttribute<Float>("float", 0.0f);
+    mVec2fKey = mDsoClass->declareAttribute<Vec2f>("vec2f", Vec2f(0.0f));
+    mVec3fKey = mDsoClass->declareAttribute<Vec3f>("vec3f", Vec3f(0.0f));
+    mRgbKey = mDsoClass->declareAttribute<Rgb>("rgb", Rgb(0.0f));
+    mVec4fKey = mDsoClass->declareAttribute<Vec4f>("vec4f", Vec4f(0.0f));
+
+    mDsoClass->setComplete();
+}
+
+void
+TestISPCSupport::tearDown()
+{
+    for (SceneObject* obj : mObjects) {
+        mDsoClass->destroyObject(obj);
+    }
+    mObjects.clear();
+}
+
+void
+TestISPCSupport::createObjects(std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        const float f = static_cast<float>(i);
+        SceneObject* obj = mDsoClass->createObject("/seq/shot/pizza" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(mBoolKey, Bool(i % 3 == 0));
+        obj->set(mIntKey, Int(i * 7));
+        obj->set(mFloatKey, f * 0.5f);
+        obj->set(mVec2fKey, Vec2f(f, -f));
+        obj->set(mVec3fKey, Vec3f(f, f + 1.0f, f + 2.0f));
+        obj->set(mRgbKey, Rgb(f * 0.1f, f * 0.2f, f * 0.3f));
+        obj->set(mVec4fKey, Vec4f(f, 2.0f * f, 3.0f * f, 4.0f * f));
+        obj->endUpdate();
+        mObjects.push_back(obj);
+    }
+}
+
+void
+TestISPCSupport::testGather()
+{
+    // not a multiple of the gang size, so the last foreach iteration is
+    // partial
+    createObjects(37);
+    const int count = static_cast<int>(mObjects.size());
+    AlignedArray<SceneObject*> objects(mObjects);
+
+    AlignedArray<int8_t> bools(count);
+    ispc::Test_ISPCSupport_gatherBool(asIspc(objects), count,
+        asIspc<ispc::BoolAttrKeyISPC>(mBoolKey), bools.data());
+
+    AlignedArray<int> ints(count);
+    ispc::Test_ISPCSupport_gatherInt(asIspc(objects), count,
+        asIspc<ispc::IntAttrKeyISPC>(mIntKey), ints.data());
+
+    AlignedArray<float> floats(count);
+    ispc::Test_ISPCSupport_gatherFloat(asIspc(objects), count,
+        asIspc<ispc::FloatAttrKeyISPC>(mFloatKey), floats.data());
+
+    AlignedArray<Vec2f> vec2fs(count);
+    ispc::Test_ISPCSupport_gatherFloat2(asIspc(objects), count,
+        asIspc<ispc::Float2AttrKeyISPC>(mVec2fKey), &vec2fs[0].x);
+
+    AlignedArray<Vec3f> vec3fs(count);
+    ispc::Test_ISPCSupport_gatherFloat3(asIspc(objects), count,
+        asIspc<ispc::Float3AttrKeyISPC>(mVec3fKey), &vec3fs[0].x);
+
+    AlignedArray<Rgb> rgbs(count);
+    ispc::Test_ISPCSupport_gatherFloat3(asIspc(objects), count,
+        asIspc<ispc::Float3AttrKeyISPC>(mRgbKey), &rgbs[0].r);
+
+    AlignedArray<Vec4f> vec4fs(count);
+    ispc::Test_ISPCSupport_gatherFloat4(asIspc(objects), count,
+        asIspc<ispc::Float4AttrKeyISPC>(mVec4fKey), &vec4fs[0].x);
+
+    for (int i = 0; i < count; ++i) {
+        const SceneObject* obj = mObjects[i];
+        CPPUNIT_ASSERT_EQUAL(obj->get(mBoolKey), bools[i] != 0);
+        CPPUNIT_ASSERT_EQUAL(obj->get(mIntKey), ints[i]);
+        CPPUNIT_ASSERT_EQUAL(obj->get(mFloatKey), floats[i]);
+        CPPUNIT_ASSERT(obj->get(mVec2fKey) == vec2fs[i]);
+        CPPUNIT_ASSERT(obj->get(mVec3fKey) == vec3fs[i]);
+        CPPUNIT_ASSERT(obj->get(mRgbKey) == rgbs[i]);
+        CPPUNIT_ASSERT(obj->get(mVec4fKey) == vec4fs[i]);
+    }
+}
+
+void
+TestISPCSupport::testGatherBenchmark()
+{
+    const std::size_t objectTotal = 100000;
+    const int loopTotal = 50;
+
+    createObjects(objectTotal);
+    const int count = static_cast<int>(objectTotal);
+    AlignedArray<SceneObject*> objects(mObjects);
+
+    AlignedArray<float> scalarFloats(count);
+    AlignedArray<float> gatherFloats(count);
+    AlignedArray<Vec3f> scalarVec3fs(count);
+    AlignedArray<Vec3f> gatherVec3fs(count);
+
+    rec_time::RecTime recTime;
+    auto report = [&](const char* typeName, float scalarSec, float gatherSec) {
+        const float total = static_cast<float>(objectTotal) * loopTotal;
+        std::cerr << "\n>> TestISPCSupport get() " << typeName
+                  << " objects:" << objectTotal << " loops:" << loopTotal
+                  << " scalar:" << total / scalarSec * 1.0e-6f << " M/s"
+                  << " gather:" << total / gatherSec * 1.0e-6f << " M/s"
+                  << " (x" << scalarSec / gatherSec << ")";
+    };
+
+    recTime.start();
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        ispc::Test_ISPCSupport_scalarFloat(asIspc(objects), count,
+            asIspc<ispc::FloatAttrKeyISPC>(mFloatKey), scalarFloats.data());
+    }
+    const float scalarFloatSec = recTime.end();
+
+    recTime.start();
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        ispc::Test_ISPCSupport_gatherFloat(asIspc(objects), count,
+            asIspc<ispc::FloatAttrKeyISPC>(mFloatKey), gatherFloats.data());
+    }
+    const float gatherFloatSec = recTime.end();
+    report("Float", scalarFloatSec, gatherFloatSec);
+
+    recTime.start();
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        ispc::Test_ISPCSupport_scalarFloat3(asIspc(objects), count,
+            asIspc<ispc::Float3AttrKeyISPC>(mVec3fKey), &scalarVec3fs[0].x);
+    }
+    const float scalarVec3fSec = recTime.end();
+
+    recTime.start();
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        ispc::Test_ISPCSupport_gatherFloat3(asIspc(objects), count,
+            asIspc<ispc::Float3AttrKeyISPC>(mVec3fKey), &gatherVec3fs[0].x);
+    }
+    const float gatherVec3fSec = recTime.end();
+    report("Vec3f", scalarVec3fSec, gatherVec3fSec);
+
+    CPPUNIT_ASSERT(scalarFloats == gatherFloats);
+    CPPUNIT_ASSERT(scalarVec3fs == gatherVec3fs);
+}
+
+} // namespace unittest
+} // namespace rdl2
+} // namespace scene_rdl2
+
@@ -0,0 +1,55 @@
+// Copyright 2023 DreamWorks Animation LLC
+// SPDX-License-Identifier: Apache-2.0
+
+
+#pragma once
+
+#include <scene_rdl2/scene/rdl2/rdl2.h>
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+#include <vector>
+
+namespace scene_rdl2 {
+namespace rdl2 {
+namespace unittest {
+
+class TestISPCSupport : public CppUnit::TestFixture
+{
+public:
+    void setUp();
+    void tearDown();
+
+    /// Test that the varying ISPC gets read the attribute of a different
+    /// SceneObject in each program instance.
+    void testGather();
+
+    /// Compare the varying ISPC gets against a scalar loop of uniform gets.
+    void testGatherBenchmark();
+
+    CPPUNIT_TEST_SUITE(TestISPCSupport);
+    CPPUNIT_TEST(testGather);
+    CPPUNIT_TEST(testGatherBenchmark);
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+    void createObjects(std::size_t count);
+
+    std::unique_ptr<SceneClass> mDsoClass;
+    std::vector<SceneObject*> mObjects;
+
+    AttributeKey<Bool> mBoolKey;
+    AttributeKey<Int> mIntKey;
+    AttributeKey<Float> mFloatKey;
+    AttributeKey<Vec2f> mVec2fKey;
+    AttributeKey<Vec3f> mVec3fKey;
+    AttributeKey<Rgb> mRgbKey;
+    AttributeKey<Vec4f> mVec4fKey;
+};
+
+} // namespace unittest
+} // namespace rdl2
+} // namespace scene_rdl2
+
@@ -3,6 +3,7 @@
 
 #include "TestLayer.h"
 
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/scene/rdl2/BinaryReader.h>
 #include <scene_rdl2/scene/rdl2/BinaryWriter.h>
 #include <scene_rdl2/scene/rdl2/Displacement.h>
@@ -17,13 +18,39 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace scene_rdl2 {
 namespace rdl2 {
 namespace unittest {
 
+namespace {
+
+// Approximate heap memory of the Layer's assignment columns in bytes. The geometry
+// column is an IndexableArray, its index node is estimated as hash + index + next pointer.
+std::size_t
+layerMemoryUsage(const Layer* layer)
+{
+    const SceneClass& sceneClass = layer->getSceneClass();
+    std::size_t bytes = 0;
+
+    const SceneObjectIndexable& geometries = layer->get(sceneClass.getAttributeKey<SceneObjectIndexable>("geometries"));
+    bytes += geometries.size() * (sizeof(SceneObject*) + sizeof(std::size_t) + sizeof(int32_t) + sizeof(void*));
+    for (const String& part : layer->get(sceneClass.getAttributeKey<StringVector>("parts"))) {
+        bytes += sizeof(String) + part.capacity();
+    }
+    for (const char* name : {"surface_shaders", "lightsets", "displacements", "volume_shaders",
+                             "lightfiltersets", "shadowsets", "shadowreceiversets"}) {
+        bytes += layer->get(sceneClass.getAttributeKey<SceneObjectVector>(name)).capacity() * sizeof(SceneObject*);
+    }
+    return bytes;
+}
+
+} // namespace
+
 void
 TestLayer::setUp()
 {
@@ -510,6 +537,170 @@ TestLayer::testContextLookup()
 }
 
 
+void
+TestLayer::testBatchAssign()
+{
+    Geometry* teapot1 = mContext->createSceneObject("FakeTeapot", "/seq/shot/teapot1")->asA<Geometry>();
+    Geometry* teapot2 = mContext->createSceneObject("FakeTeapot", "/seq/shot/teapot2")->asA<Geometry>();
+    Material* material1 = mContext->createSceneObject("FakeMaterial", "/seq/shot/material1")->asA<Material>();
+    Material* material2 = mContext->createSceneObject("FakeMaterial", "/seq/shot/material2")->asA<Material>();
+    LightSet* lights = mContext->createSceneObject("LightSet", "/seq/shot/lights")->asA<LightSet>();
+    VolumeShader* volume = mContext->createSceneObject("FakeVolumeShader", "/seq/shot/volume")->asA<VolumeShader>();
+
+    LayerAssignment la1;
+    la1.mMaterial = material1;
+    la1.mLightSet = lights;
+    LayerAssignment la2;
+    la2.mMaterial = material2;
+    la2.mLightSet = lights;
+    LayerAssignment laVolume;
+    laVolume.mMaterial = material1;
+    laVolume.mVolumeShader = volume;
+
+    Layer* single = mContext->createSceneObject("Layer", "/seq/shot/single")->asA<Layer>();
+    Layer* bulk = mContext->createSceneObject("Layer", "/seq/shot/bulk")->asA<Layer>();
+
+    LayerAssignmentBatch batch;
+    CPPUNIT_ASSERT_THROW(bulk->assign(batch), except::RuntimeError);
+
+    // Existing assignment which the batch reassigns.
+    single->beginUpdate();
+    bulk->beginUpdate();
+    CPPUNIT_ASSERT(single->assign(teapot1, "lid", la1) == 0);
+    CPPUNIT_ASSERT(bulk->assign(teapot1, "lid", la1) == 0);
+
+    batch.add(teapot1, "body", la1);
+    batch.add(teapot1, "lid", la2);         // reassign existing
+    batch.add(teapot2, "lid", la1);
+    batch.add(teapot1, "body", la2);        // reassign within the batch
+    batch.add(teapot2, "spout", laVolume);  // whole geometry
+    batch.add(teapot2, "handle", laVolume); // same whole geometry assignment
+    CPPUNIT_ASSERT(batch.size() == 6);
+    CPPUNIT_ASSERT(batch.getPartNames().size() == 5);
+    CPPUNIT_ASSERT(batch.getPalette().size() == 3);
+
+    std::vector<int32_t> singleIds;
+    for (const auto& entry : batch.getEntries()) {
+        singleIds.push_back(single->assign(entry.mGeometry,
+                                           batch.getPartNames()[entry.mPartId],
+                                           batch.getPalette()[entry.mAssignmentId]));
+    }
+    const std::vector<int32_t> bulkIds = bulk->assign(batch);
+    single->endUpdate();
+    bulk->endUpdate();
+
+    CPPUNIT_ASSERT(bulkIds == singleIds);
+    CPPUNIT_ASSERT(bulkIds[0] == bulkIds[3]);
+    CPPUNIT_ASSERT(bulkIds[4] == bulkIds[5]);
+    CPPUNIT_ASSERT(bulk->getAssignmentCount() == single->getAssignmentCount());
+    CPPUNIT_ASSERT(bulk->getAssignmentCount() == 4);
+    for (int32_t id = 0; id < bulk->getAssignmentCount(); ++id) {
+        CPPUNIT_ASSERT(bulk->lookupGeomAndPart(id) == single->lookupGeomAndPart(id));
+        CPPUNIT_ASSERT(bulk->lookupMaterial(id) == single->lookupMaterial(id));
+        CPPUNIT_ASSERT(bulk->lookupLightSet(id) == single->lookupLightSet(id));
+        CPPUNIT_ASSERT(bulk->lookupVolumeShader(id) == single->lookupVolumeShader(id));
+    }
+    CPPUNIT_ASSERT(bulk->lookupMaterial(0) == material2);
+    CPPUNIT_ASSERT(bulk->getAssignmentId(teapot2, "") == bulkIds[4]);
+
+    // Bad ids are rejected before anything is assigned.
+    LayerAssignmentBatch badBatch;
+    badBatch.add(teapot1, 7, 0);
+    bulk->beginUpdate();
+    CPPUNIT_ASSERT_THROW(bulk->assign(badBatch), except::IndexError);
+    bulk->endUpdate();
+    CPPUNIT_ASSERT(bulk->getAssignmentCount() == 4);
+}
+
+void
+TestLayer::testBatchBenchmark()
+{
+    const int geometryTotal = 2000;
+    const int partTotal = 50;
+    const int materialTotal = 20;
+    const int lightSetTotal = 10;
+
+    std::vector<Geometry*> geometries;
+    for (int i = 0; i < geometryTotal; ++i) {
+        geometries.push_back(mContext->createSceneObject("FakeTeapot",
+                                                         "/crowd/agent" + std::to_string(i))->asA<Geometry>());
+    }
+    std::vector<LightSet*> lightSets;
+    for (int l = 0; l < lightSetTotal; ++l) {
+        lightSets.push_back(mContext->createSceneObject("LightSet",
+                                                        "/crowd/lights" + std::to_string(l))->asA<LightSet>());
+    }
+    std::vector<LayerAssignment> tuples;
+    for (int m = 0; m < materialTotal; ++m) {
+        Material* material = mContext->createSceneObject("FakeMaterial",
+                                                         "/crowd/material" + std::to_string(m))->asA<Material>();
+        for (LightSet* lightSet : lightSets) {
+            LayerAssignment la;
+            la.mMaterial = material;
+            la.mLightSet = lightSet;
+            tuples.push_back(la);
+        }
+    }
+    std::vector<std::string> partNames;
+    for (int p = 0; p < partTotal; ++p) {
+        partNames.push_back("part" + std::to_string(p));
+    }
+    auto tupleOf = [&](int g, int p) { return (g * 7 + p) % static_cast<int>(tuples.size()); };
+
+    rec_time::RecTime recTime;
+
+    Layer* single = mContext->createSceneObject("Layer", "/crowd/single")->asA<Layer>();
+    recTime.start();
+    single->beginUpdate();
+    for (int g = 0; g < geometryTotal; ++g) {
+        for (int p = 0; p < partTotal; ++p) {
+            single->assign(geometries[g], partNames[p], tuples[tupleOf(g, p)]);
+        }
+    }
+    single->endUpdate();
+    const float singleSec = recTime.end();
+
+    Layer* bulk = mContext->createSceneObject("Layer", "/crowd/bulk")->asA<Layer>();
+    recTime.start();
+    LayerAssignmentBatch batch;
+    batch.reserve(geometryTotal * partTotal);
+    std::vector<uint32_t> partIds;
+    for (const auto& name : partNames) {
+        partIds.push_back(batch.internPart(name));
+    }
+    std::vector<uint32_t> tupleIds;
+    for (const auto& la : tuples) {
+        tupleIds.push_back(batch.internAssignment(la));
+    }
+    for (int g = 0; g < geometryTotal; ++g) {
+        for (int p = 0; p < partTotal; ++p) {
+            batch.add(geometries[g], partIds[p], tupleIds[tupleOf(g, p)]);
+        }
+    }
+    const float batchBuildSec = recTime.end();
+    recTime.start();
+    bulk->beginUpdate();
+    const std::vector<int32_t> ids = bulk->assign(batch);
+    bulk->endUpdate();
+    const float bulkSec = recTime.end();
+
+    CPPUNIT_ASSERT(bulk->getAssignmentCount() == single->getAssignmentCount());
+    CPPUNIT_ASSERT(ids.back() == bulk->getAssignmentCount() - 1);
+    for (int32_t id = 0; id < bulk->getAssignmentCount(); id += 997) {
+        CPPUNIT_ASSERT(bulk->lookupMaterial(id) == single->lookupMaterial(id));
+        CPPUNIT_ASSERT(bulk->lookupLightSet(id) == single->lookupLightSet(id));
+    }
+
+    // The Layer stores the expanded columns either way, so the footprint is the same.
+    const std::size_t singleBytes = layerMemoryUsage(single);
+    const std::size_t bulkBytes = layerMemoryUsage(bulk);
+
+    std::cerr << "\n>> TestLayer batch assignments:" << batch.size()
+              << " palette:" << batch.getPalette().size()
+              << " single:" << singleSec * 1000.0f << " ms"
+              << " batch(build:" << batchBuildSec * 1000.0f << " ms assign:" << bulkSec * 1000.0f << " ms)"
+              << " layer memory(single:" << singleBytes / 1024 << " KB batch:" << bulkBytes / 1024 << " KB)\n";
+}
 
 } // namespace unittest
 } // namespace rdl2
@@ -38,6 +38,12 @@ public:
 
     void testSerialize();
 
+    /// Test that batch assignments match the single assign() results.
+    void testBatchAssign();
+
+    /// Compare build time and Layer memory of single and batch assignments.
+    void testBatchBenchmark();
+
     CPPUNIT_TEST_SUITE(TestLayer);
     CPPUNIT_TEST(testAssignAndLookup);
     CPPUNIT_TEST(testDefaultAssignments);
@@ -45,6 +51,8 @@ public:
     CPPUNIT_TEST(testIterators);
     CPPUNIT_TEST(testContextLookup);
     CPPUNIT_TEST(testSerialize);
+    CPPUNIT_TEST(testBatchAssign);
+    CPPUNIT_TEST(testBatchBenchmark);
     CPPUNIT_TEST_SUITE_END();
 
 private:
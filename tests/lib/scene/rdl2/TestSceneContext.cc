@@ -4,22 +4,109 @@
 
 #include "TestSceneContext.h"
 
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/scene/rdl2/AttributeKey.h>
+#include <scene_rdl2/scene/rdl2/Camera.h>
+#include <scene_rdl2/scene/rdl2/DsoDeclarationCache.h>
+#include <scene_rdl2/scene/rdl2/Joint.h>
 #include <scene_rdl2/scene/rdl2/SceneContext.h>
 #include <scene_rdl2/scene/rdl2/SceneClass.h>
 #include <scene_rdl2/scene/rdl2/SceneObject.h>
 #include <scene_rdl2/scene/rdl2/SceneVariables.h>
 #include <scene_rdl2/scene/rdl2/Types.h>
+#include <scene_rdl2/scene/rdl2/UserData.h>
+#include <scene_rdl2/scene/rdl2/Utils.h>
 
 #include <scene_rdl2/common/except/exceptions.h>
 #include <scene_rdl2/common/math/Color.h>
 
+#include <tbb/parallel_for.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
 
 namespace scene_rdl2 {
 namespace rdl2 {
 namespace unittest {
 
+namespace {
+
+std::string
+tmpCacheFile(const std::string& name)
+{
+    return "/tmp/" + name + "_" + std::to_string(getpid()) + ".rdl2cache";
+}
+
+// Everything a SceneClass declared, in declaration order.
+std::string
+showDeclarations(const SceneClass& sceneClass)
+{
+    std::string result = std::to_string(sceneClass.getDeclaredInterface()) + '\n';
+    for (auto iter = sceneClass.beginAttributes(); iter != sceneClass.endAttributes(); ++iter) {
+        result += (*iter)->show() + '\n';
+    }
+    for (auto iter = sceneClass.beginGroups(); iter != sceneClass.endGroups(); ++iter) {
+        result += "group " + *iter + ':';
+        for (const Attribute* attribute : sceneClass.getAttributeGroup(*iter)) {
+            result += ' ' + attribute->getName();
+        }
+        result += '\n';
+    }
+    return result;
+}
+
+// Shutter intervals the time rescaling tests switch between, over [-1, 1]
+// motion steps. Their coefficients differ in both scale and offset, so a mix
+// of the two is detectable.
+const float sShutters[2][2] = { { -0.5f, 0.5f }, { 0.25f, 1.0f } };
+
+Camera*
+setupTimeRescaling(SceneContext& context)
+{
+    context.setProxyModeEnabled(true);
+    Camera* camera = context.createSceneObject("LibLadenCamera", "/camera")->asA<Camera>();
+
+    SceneVariables& vars = context.getSceneVariables();
+    vars.beginUpdate();
+    vars.set(SceneVariables::sMotionSteps, FloatVector{-1.0f, 1.0f});
+    vars.endUpdate();
+    return camera;
+}
+
+void
+setShutter(SceneContext& context, Camera* camera, int index)
+{
+    camera->beginUpdate();
+    camera->set(Camera::sMbShutterOpenKey, sShutters[index][0]);
+    camera->set(Camera::sMbShutterCloseKey, sShutters[index][1]);
+    camera->endUpdate();
+    context.applyUpdates(nullptr);
+}
+
+// Index of the shutter the coefficients came from, -1 if they are a mix.
+int
+shutterIndex(const TimeRescalingCoeffs& coeffs)
+{
+    for (int i = 0; i < 2; ++i) {
+        const float scale = (sShutters[i][1] - sShutters[i][0]) * 0.5f;
+        const float offset = (sShutters[i][0] + 1.0f) * 0.5f;
+        if (coeffs.mScale == scale && coeffs.mOffset == offset) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
 void
 TestSceneContext::setUp()
 {
@@ -325,6 +412,266 @@ TestSceneContext::testLoadAllSceneClasses()
     CPPUNIT_ASSERT(sawUpdateTracker);
 }
 
+void
+TestSceneContext::testDeclarationCache()
+{
+    const std::string cacheFile = tmpCacheFile("TestSceneContext_testDeclarationCache");
+    std::remove(cacheFile.c_str());
+
+    // Reference: declarations straight from the proxy DSOs.
+    SceneContext reference;
+    reference.setProxyModeEnabled(true);
+    reference.loadAllSceneClasses();
+
+    // Cold: nothing cached yet, the declarations are recorded and saved.
+    {
+        SceneContext cold;
+        cold.setProxyModeEnabled(true);
+        cold.setDeclarationCacheFile(cacheFile);
+        CPPUNIT_ASSERT(cold.getDeclarationCacheFile() == cacheFile);
+        CPPUNIT_ASSERT_NO_THROW(cold.loadAllSceneClasses());
+        CPPUNIT_ASSERT(std::ifstream(cacheFile).good());
+    }
+
+    DsoDeclarationCache cache;
+    CPPUNIT_ASSERT(cache.load(cacheFile));
+    CPPUNIT_ASSERT(cache.size() > 0);
+
+    // Warm: the classes come from the cache and must match the reference.
+    SceneContext warm;
+    warm.setProxyModeEnabled(true);
+    warm.setDeclarationCacheFile(cacheFile);
+    CPPUNIT_ASSERT_NO_THROW(warm.loadAllSceneClasses());
+
+    std::size_t cachedClasses = 0;
+    for (auto iter = reference.beginSceneClass(); iter != reference.endSceneClass(); ++iter) {
+        const SceneClass* expected = iter->second;
+        CPPUNIT_ASSERT(warm.sceneClassExists(iter->first));
+        const SceneClass* actual = warm.getSceneClass(iter->first);
+        CPPUNIT_ASSERT_EQUAL(showDeclarations(*expected), showDeclarations(*actual));
+        CPPUNIT_ASSERT_EQUAL(expected->getSourcePath(), actual->getSourcePath());
+        if (cache.find(actual->getSourcePath())) {
+            ++cachedClasses;
+        }
+    }
+    CPPUNIT_ASSERT(cachedClasses > 0);
+
+    // Objects of a cached class are proxies with the declared defaults.
+    SceneObject* cachedObj = warm.createSceneObject("ExtensiveObject", "/seq/shot/cached");
+    SceneObject* refObj = reference.createSceneObject("ExtensiveObject", "/seq/shot/ref");
+    AttributeKey<FloatVector> cachedKey =
+        warm.getSceneClass("ExtensiveObject")->getAttributeKey<FloatVector>("float_vector");
+    AttributeKey<FloatVector> refKey =
+        reference.getSceneClass("ExtensiveObject")->getAttributeKey<FloatVector>("float_vector");
+    CPPUNIT_ASSERT(cachedObj->get(cachedKey) == refObj->get(refKey));
+
+    // A corrupted cache file is ignored.
+    {
+        std::ofstream out(cacheFile, std::ios::binary | std::ios::trunc);
+        out << "not a declaration cache";
+    }
+    SceneContext corrupted;
+    corrupted.setProxyModeEnabled(true);
+    corrupted.setDeclarationCacheFile(cacheFile);
+    CPPUNIT_ASSERT_NO_THROW(corrupted.loadAllSceneClasses());
+    CPPUNIT_ASSERT(corrupted.sceneClassExists("ExtensiveObject"));
+    CPPUNIT_ASSERT(cache.load(cacheFile));
+
+    std::remove(cacheFile.c_str());
+}
+
+void
+TestSceneContext::testDeclarationCacheBenchmark()
+{
+    const std::string cacheFile = tmpCacheFile("TestSceneContext_testDeclarationCacheBenchmark");
+    std::remove(cacheFile.c_str());
+
+    rec_time::RecTime recTime;
+    const char* labels[] = {"no cache", "cold", "warm"};
+    for (int run = 0; run < 3; ++run) {
+        SceneContext context;
+        context.setProxyModeEnabled(true);
+        if (run > 0) {
+            context.setDeclarationCacheFile(cacheFile);
+        }
+        recTime.start();
+        context.loadAllSceneClasses();
+        float sec = recTime.end();
+
+        std::size_t classTotal = 0;
+        for (auto iter = context.beginSceneClass(); iter != context.endSceneClass(); ++iter) {
+            ++classTotal;
+        }
+        std::cerr << "\n>> TestSceneContext loadAllSceneClasses " << labels[run]
+                  << " classes:" << classTotal
+                  << " time:" << sec * 1000.0f << " ms";
+    }
+    std::cerr << '\n';
+
+    std::remove(cacheFile.c_str());
+}
+
+void
+TestSceneContext::testConcurrentContexts()
+{
+    const std::string base = "/tmp/TestSceneContext_testConcurrentContexts_" +
+                             std::to_string(getpid());
+
+    FloatVector values(10000);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) * 0.5f;
+    }
+
+    {
+        SceneContext context;
+        context.createSceneObject("ExampleObject", "/example");
+        UserData* data = context.createSceneObject("UserData", "/data")->asA<UserData>();
+        data->beginUpdate();
+        data->setFloatData("values", values);
+        data->endUpdate();
+        writeSceneToFile(context, base + ".rdla");
+        writeSceneToFile(context, base + ".rdlb");
+    }
+
+    // Every task reads into its own context, writes it back out and reads
+    // the result again, in parallel with all the other tasks.
+    const std::size_t taskCount = 32;
+    std::atomic<std::size_t> failures(0);
+    tbb::parallel_for(std::size_t(0), taskCount, [&](std::size_t task) {
+        try {
+            const std::string input = base + ((task & 1) ? ".rdlb" : ".rdla");
+            const std::string output = base + "_" + std::to_string(task) + ".rdlb";
+
+            SceneContext context;
+            readSceneFromFile(input, context);
+            writeSceneToFile(context, output);
+
+            SceneContext reread;
+            readSceneFromFile(output, reread);
+            std::remove(output.c_str());
+
+            const UserData* data = reread.getSceneObject("/data")->asA<UserData>();
+            if (!reread.sceneObjectExists("/example") ||
+                data->getFloatKey() != "values" || data->getFloatValues() != values) {
+                ++failures;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "\n>> TestSceneContext concurrent task " << task << ": " << e.what();
+            ++failures;
+        }
+    });
+
+    std::remove((base + ".rdla").c_str());
+    std::remove((base + ".rdlb").c_str());
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), failures.load());
+}
+
+void
+TestSceneContext::testTimeRescalingConcurrentReads()
+{
+    SceneContext context;
+    Camera* camera = setupTimeRescaling(context);
+    setShutter(context, camera, 0);
+    CPPUNIT_ASSERT(shutterIndex(context.getTimeRescalingCoeffs()) == 0);
+
+    const uint32_t version = context.getTimeRescalingCoeffsVersion();
+    setShutter(context, camera, 1);
+    CPPUNIT_ASSERT(shutterIndex(context.getTimeRescalingCoeffs()) == 1);
+    CPPUNIT_ASSERT(context.getTimeRescalingCoeffsVersion() > version);
+
+    // Interpolated get() of a translation from x = 0 to x = 1 at t = 1
+    // returns x = scale + offset.
+    SceneObject* joint = context.createSceneObject("Joint", "/joint");
+    joint->beginUpdate();
+    joint->set(Node::sNodeXformKey, Mat4d(math::one), TIMESTEP_BEGIN);
+    joint->set(Node::sNodeXformKey, Mat4d(1.0, 0.0, 0.0, 0.0,
+                                          0.0, 1.0, 0.0, 0.0,
+                                          0.0, 0.0, 1.0, 0.0,
+                                          1.0, 0.0, 0.0, 1.0), TIMESTEP_END);
+    joint->endUpdate();
+    double expectedX[2];
+    for (int i = 0; i < 2; ++i) {
+        expectedX[i] = (sShutters[i][1] - sShutters[i][0]) * 0.5 + (sShutters[i][0] + 1.0) * 0.5;
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<std::size_t> tornCoeffs(0);
+    std::atomic<std::size_t> tornGets(0);
+    std::atomic<std::size_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            std::size_t count = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (shutterIndex(context.getTimeRescalingCoeffs()) < 0) {
+                    ++tornCoeffs;
+                }
+                const double x = joint->get(Node::sNodeXformKey, 1.0f).vw.x;
+                if (std::abs(x - expectedX[0]) > 1e-5 && std::abs(x - expectedX[1]) > 1e-5) {
+                    ++tornGets;
+                }
+                ++count;
+            }
+            reads += count;
+        });
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+        setShutter(context, camera, i & 1);
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    CPPUNIT_ASSERT(reads.load() > 0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), tornCoeffs.load());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), tornGets.load());
+}
+
+void
+TestSceneContext::testTimeRescalingReadBenchmark()
+{
+    SceneContext context;
+    Camera* camera = setupTimeRescaling(context);
+    setShutter(context, camera, 0);
+
+    const std::size_t readTotal = 10 * 1000 * 1000;
+    rec_time::RecTime recTime;
+    auto readLoop = [&]() {
+        float sum = 0.0f;
+        recTime.start();
+        for (std::size_t i = 0; i < readTotal; ++i) {
+            const TimeRescalingCoeffs coeffs = context.getTimeRescalingCoeffs();
+            sum += coeffs.mScale * static_cast<float>(i & 7) + coeffs.mOffset;
+        }
+        const float sec = recTime.end();
+        CPPUNIT_ASSERT(sum > 0.0f);
+        return sec;
+    };
+
+    const float idleSec = readLoop();
+
+    std::atomic<bool> done(false);
+    std::size_t updateCount = 0;
+    std::thread writer([&]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            setShutter(context, camera, updateCount & 1);
+            ++updateCount;
+        }
+    });
+    const float busySec = readLoop();
+    done = true;
+    writer.join();
+
+    std::cerr << "\n>> TestSceneContext getTimeRescalingCoeffs() reads:" << readTotal
+              << " idle:" << idleSec * 1.0e9f / readTotal << " ns/read"
+              << " with writer:" << busySec * 1.0e9f / readTotal << " ns/read"
+              << " (updates:" << updateCount << ")\n";
+}
+
 void
 TestSceneContext::testSceneVariables()
 {
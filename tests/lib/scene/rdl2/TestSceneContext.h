@@ -54,6 +54,27 @@ public:
     /// Test that we can load all SceneClasses in our DSO path up front.
     void testLoadAllSceneClasses();
 
+    /// Test that SceneClasses declared from the DSO declaration cache are
+    /// identical to the ones declared by the proxy DSOs.
+    void testDeclarationCache();
+
+    /// Compare the cold (no cache) and warm (cache) loadAllSceneClasses()
+    /// startup time.
+    void testDeclarationCacheBenchmark();
+
+    /// Stress test reading and writing scene files into separate
+    /// SceneContexts from many threads at once.
+    void testConcurrentContexts();
+
+    /// Stress test interpolated gets while the time rescaling coefficients
+    /// are updated on another thread: readers must never see torn
+    /// coefficients.
+    void testTimeRescalingConcurrentReads();
+
+    /// Measure the time rescaling coefficient read latency, with and
+    /// without a concurrent writer.
+    void testTimeRescalingReadBenchmark();
+
     /// Test that we can get and set the SceneVariables.
     void testSceneVariables();
 
@@ -77,6 +98,11 @@ public:
     CPPUNIT_TEST(testIterateSceneObjects);
     CPPUNIT_TEST(testSetSceneObject);
     CPPUNIT_TEST(testLoadAllSceneClasses);
+    CPPUNIT_TEST(testDeclarationCache);
+    CPPUNIT_TEST(testDeclarationCacheBenchmark);
+    CPPUNIT_TEST(testConcurrentContexts);
+    CPPUNIT_TEST(testTimeRescalingConcurrentReads);
+    CPPUNIT_TEST(testTimeRescalingReadBenchmark);
     CPPUNIT_TEST(testSceneVariables);
     CPPUNIT_TEST(testCreateClassFailure);
     CPPUNIT_TEST(testCreateObjectFailure);
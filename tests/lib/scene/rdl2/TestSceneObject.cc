@@ -4,18 +4,79 @@
 
 #include "TestSceneObject.h"
 
+#include <scene_rdl2/common/rec_time/RecTime.h>
 #include <scene_rdl2/scene/rdl2/AttributeKey.h>
+#include <scene_rdl2/scene/rdl2/Camera.h>
 #include <scene_rdl2/scene/rdl2/Dso.h>
 #include <scene_rdl2/scene/rdl2/SceneClass.h>
+#include <scene_rdl2/scene/rdl2/SceneContext.h>
 #include <scene_rdl2/scene/rdl2/SceneObject.h>
+#include <scene_rdl2/scene/rdl2/SceneVariables.h>
 #include <scene_rdl2/scene/rdl2/Types.h>
 
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace scene_rdl2 {
 namespace rdl2 {
 namespace unittest {
 
+namespace {
+
+// Gives the context a non trivial time rescaling for interpolated gets:
+// a [-0.25, 0.75] shutter over [-1, 1] motion steps.
+void
+setupMotionBlur(SceneContext& context)
+{
+    context.setProxyModeEnabled(true);
+    SceneObject* camera = context.createSceneObject("LibLadenCamera", "/camera");
+    camera->beginUpdate();
+    camera->set(Camera::sMbShutterOpenKey, -0.25f);
+    camera->set(Camera::sMbShutterCloseKey, 0.75f);
+    camera->endUpdate();
+
+    SceneVariables& vars = context.getSceneVariables();
+    vars.beginUpdate();
+    vars.set(SceneVariables::sMotionSteps, FloatVector{-1.0f, 1.0f});
+    vars.endUpdate();
+
+    context.applyUpdates(nullptr);
+}
+
+Mat4d
+makeXform(double angle, const Vec3d& translation)
+{
+    const double c = std::cos(angle);
+    const double s = std::sin(angle);
+    return Mat4d(  c,   s, 0.0, 0.0,
+                  -s,   c, 0.0, 0.0,
+                 0.0, 0.0, 1.0, 0.0,
+                 translation.x, translation.y, translation.z, 1.0);
+}
+
+template <typename T, typename Scalar>
+void
+checkGetInterpolated(AttributeKey<T> key, const std::vector<SceneObject*>& objects,
+                     const std::vector<float>& times, Scalar eps)
+{
+    std::vector<T> results(objects.size() * times.size());
+    SceneObject::getInterpolated(key, objects.data(), objects.size(),
+                                 times.data(), times.size(), results.data());
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        for (std::size_t j = 0; j < times.size(); ++j) {
+            CPPUNIT_ASSERT(math::isEqual(results[i * times.size() + j],
+                                         objects[i]->get(key, times[j]), eps));
+        }
+    }
+}
+
+} // namespace
+
 void
 TestSceneObject::setUp()
 {
@@ -192,6 +253,7 @@ TestSceneObject::setUp()
     mMat4fVectorKey = mDsoClass->declareAttribute<Mat4fVector>("mat4f_vector", mMat4fVec, { "mat4f vector" });
     mMat4dVectorKey = mDsoClass->declareAttribute<Mat4dVector>("mat4d_vector", mMat4dVec, { "mat4d vector" });
     mSceneObjectVectorKey = mDsoClass->declareAttribute<SceneObjectVector>("scene_object_vector", mSceneObjectVec, { "scene object vector" });
+    mBlurFloatVectorKey = mDsoClass->declareAttribute<FloatVector>("blur_float_vector", FloatVector(), FLAGS_BLURRABLE);
 
     mBindableKey = mDsoClass->declareAttribute<Float>("bindable", FLAGS_BINDABLE);
 
@@ -617,6 +679,364 @@ TestSceneObject::testExtension()
     mDsoClass->destroyObject(obj);
 }
 
+void
+TestSceneObject::testMoveSet()
+{
+    SceneObject* obj = mDsoClass->createObject("/seq/shot/pizza");
+
+    // Non blurrable attribute takes over the buffer.
+    FloatVector values(1000, 1.0f);
+    const float* data = values.data();
+    obj->beginUpdate();
+    obj->set(mFloatVectorKey, std::move(values));
+    obj->endUpdate();
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey).size() == 1000);
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey).data() == data);
+    CPPUNIT_ASSERT(obj->mAttributeSetMask.test(mFloatVectorKey.mIndex) == true);
+
+    // Setting an equal value doesn't set the mask.
+    obj->commitChanges();
+    obj->beginUpdate();
+    obj->set(mFloatVectorKey, FloatVector(1000, 1.0f));
+    obj->endUpdate();
+    CPPUNIT_ASSERT(obj->mAttributeSetMask.test(mFloatVectorKey.mIndex) == false);
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey).data() == data);
+
+    // Blurrable attribute: the begin timestep gets a copy, the end timestep
+    // takes over the buffer.
+    FloatVector blurValues(1000, 2.0f);
+    const float* blurData = blurValues.data();
+    obj->beginUpdate();
+    obj->set(mBlurFloatVectorKey, std::move(blurValues));
+    obj->endUpdate();
+    CPPUNIT_ASSERT(obj->get(mBlurFloatVectorKey, TIMESTEP_BEGIN) == FloatVector(1000, 2.0f));
+    CPPUNIT_ASSERT(obj->get(mBlurFloatVectorKey, TIMESTEP_END) == FloatVector(1000, 2.0f));
+    CPPUNIT_ASSERT(obj->get(mBlurFloatVectorKey, TIMESTEP_BEGIN).data() != blurData);
+    CPPUNIT_ASSERT(obj->get(mBlurFloatVectorKey, TIMESTEP_END).data() == blurData);
+
+    // Timestep move set only touches that timestep.
+    obj->beginUpdate();
+    obj->set(mBlurFloatVectorKey, FloatVector(10, 3.0f), TIMESTEP_END);
+    obj->endUpdate();
+    CPPUNIT_ASSERT(obj->get(mBlurFloatVectorKey, TIMESTEP_BEGIN) == FloatVector(1000, 2.0f));
+    CPPUNIT_ASSERT(obj->get(mBlurFloatVectorKey, TIMESTEP_END) == FloatVector(10, 3.0f));
+
+    // Move set outside of an update throws and leaves the value untouched.
+    FloatVector rejected(5, 4.0f);
+    CPPUNIT_ASSERT_THROW(obj->set(mFloatVectorKey, std::move(rejected)), except::RuntimeError);
+    CPPUNIT_ASSERT(rejected.size() == 5);
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey).size() == 1000);
+
+    mDsoClass->destroyObject(obj);
+}
+
+void
+TestSceneObject::testSetBenchmark()
+{
+    const size_t elemTotal = 10 * 1000 * 1000;
+    const int loopTotal = 5;
+
+    SceneObject* obj = mDsoClass->createObject("/seq/shot/pizza");
+    rec_time::RecTime recTime;
+
+    // Every set uses a different value so that the equality check never
+    // short-cuts the assignment.
+    float copySec = 0.0f;
+    float moveSec = 0.0f;
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        FloatVector copyValues(elemTotal, static_cast<float>(loop));
+        recTime.start();
+        obj->beginUpdate();
+        obj->set(mFloatVectorKey, copyValues);
+        obj->endUpdate();
+        copySec += recTime.end();
+
+        FloatVector moveValues(elemTotal, static_cast<float>(loop) + 0.5f);
+        recTime.start();
+        obj->beginUpdate();
+        obj->set(mFloatVectorKey, std::move(moveValues));
+        obj->endUpdate();
+        moveSec += recTime.end();
+    }
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey).size() == elemTotal);
+
+    std::cerr << "\n>> TestSceneObject set() FloatVector elems:" << elemTotal
+              << " (" << elemTotal * sizeof(float) / (1024 * 1024) << " MB)"
+              << " copy:" << copySec / loopTotal * 1000.0f << " ms"
+              << " move:" << moveSec / loopTotal * 1000.0f << " ms"
+              << " (copy duplicates " << elemTotal * sizeof(float) / (1024 * 1024) << " MB per set, move 0 MB)\n";
+
+    mDsoClass->destroyObject(obj);
+}
+
+void
+TestSceneObject::testSetMemory()
+{
+    // Same mesh-sized buffer set on several objects, blurrable and not. Counts the distinct
+    // buffers (and bytes) which are alive after the sets, including the caller's one.
+    const size_t elemTotal = 1000 * 1000;
+    const int objTotal = 8;
+    const size_t bufferBytes = elemTotal * sizeof(float);
+
+    std::vector<SceneObject*> objs;
+    for (int i = 0; i < objTotal; ++i) {
+        objs.push_back(mDsoClass->createObject("/seq/shot/pizza" + std::to_string(i)));
+    }
+
+    auto liveBytes = [&](const FloatVector& source, AttributeKey<FloatVector> key) {
+        std::set<const float*> buffers;
+        if (!source.empty()) buffers.insert(source.data());
+        for (const SceneObject* obj : objs) {
+            buffers.insert(obj->get(key, TIMESTEP_BEGIN).data());
+            buffers.insert(obj->get(key, TIMESTEP_END).data());
+        }
+        return buffers.size() * bufferBytes;
+    };
+
+    enum { COPY, MOVE, SHARED, MODE_TOTAL };
+    size_t bytes[2][MODE_TOTAL]; // [blur][mode]
+    for (int blur = 0; blur < 2; ++blur) {
+        const AttributeKey<FloatVector> key = (blur) ? mBlurFloatVectorKey : mFloatVectorKey;
+        for (int mode = 0; mode < MODE_TOTAL; ++mode) {
+            const float value = static_cast<float>(blur * MODE_TOTAL + mode + 1);
+            const FloatVector source(elemTotal, value);
+            const auto shared = std::make_shared<const FloatVector>(elemTotal, value);
+            for (SceneObject* obj : objs) {
+                obj->beginUpdate();
+                if (mode == MOVE) {
+                    FloatVector values = source; // i.e. decoded by BinaryReader
+                    obj->set(key, std::move(values));
+                } else if (mode == SHARED) {
+                    obj->setShared(key, shared);
+                } else {
+                    obj->set(key, source);
+                }
+                obj->endUpdate();
+            }
+            bytes[blur][mode] = liveBytes((mode == COPY) ? source : (mode == SHARED) ? *shared : FloatVector(),
+                                          key);
+            for (const SceneObject* obj : objs) {
+                CPPUNIT_ASSERT(obj->get(key, TIMESTEP_END).size() == elemTotal);
+                CPPUNIT_ASSERT(obj->get(key, TIMESTEP_END).back() == value);
+            }
+        }
+    }
+
+    // Shared : one buffer for all the objects and timesteps.
+    CPPUNIT_ASSERT(bytes[0][SHARED] == bufferBytes);
+    CPPUNIT_ASSERT(bytes[1][SHARED] == bufferBytes);
+    CPPUNIT_ASSERT(bytes[0][MOVE] < bytes[0][COPY]);
+
+    std::cerr << "\n>> TestSceneObject set() memory FloatVector " << bufferBytes / (1024 * 1024) << " MB x "
+              << objTotal << " objects"
+              << " copy:" << bytes[0][COPY] / (1024 * 1024) << " MB"
+              << " move:" << bytes[0][MOVE] / (1024 * 1024) << " MB"
+              << " shared:" << bytes[0][SHARED] / (1024 * 1024) << " MB"
+              << " blurrable copy:" << bytes[1][COPY] / (1024 * 1024) << " MB"
+              << " blurrable move:" << bytes[1][MOVE] / (1024 * 1024) << " MB"
+              << " blurrable shared:" << bytes[1][SHARED] / (1024 * 1024) << " MB\n";
+
+    for (SceneObject* obj : objs) mDsoClass->destroyObject(obj);
+}
+
+void
+TestSceneObject::testSetShared()
+{
+    SceneObject* obj = mDsoClass->createObject("/seq/shot/pizza");
+    SceneObject* obj2 = mDsoClass->createObject("/seq/shot/pizza2");
+    const auto shared = std::make_shared<const FloatVector>(FloatVector {1.0f, 2.0f, 3.0f});
+
+    // Sharing needs an update like set().
+    CPPUNIT_ASSERT_THROW(
+        obj->setShared(mFloatVectorKey, shared);
+    , except::RuntimeError);
+
+    obj->beginUpdate();
+    CPPUNIT_ASSERT_THROW(
+        obj->setShared(mFloatVectorKey, std::shared_ptr<const FloatVector>());
+    , except::ValueError);
+    obj->setShared(mFloatVectorKey, shared);
+    obj->endUpdate();
+    obj2->beginUpdate();
+    obj2->setShared(mBlurFloatVectorKey, shared);
+    obj2->endUpdate();
+
+    CPPUNIT_ASSERT(obj->mAttributeSetMask.test(mFloatVectorKey.mIndex) == true);
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey) == *shared);
+    CPPUNIT_ASSERT(&obj->get(mFloatVectorKey) == shared.get());
+    CPPUNIT_ASSERT(obj->getShared(mFloatVectorKey) == shared);
+    CPPUNIT_ASSERT(&obj2->get(mBlurFloatVectorKey, TIMESTEP_BEGIN) == shared.get());
+    CPPUNIT_ASSERT(&obj2->get(mBlurFloatVectorKey, TIMESTEP_END) == shared.get());
+
+    // Sharing an equal buffer doesn't change the object.
+    obj->commitChanges();
+    obj->beginUpdate();
+    obj->setShared(mFloatVectorKey, std::make_shared<const FloatVector>(*shared));
+    obj->endUpdate();
+    CPPUNIT_ASSERT(obj->mAttributeSetMask.test(mFloatVectorKey.mIndex) == false);
+
+    // set() replaces the shared buffer, which is left untouched.
+    obj->commitChanges();
+    obj->beginUpdate();
+    obj->set(mFloatVectorKey, FloatVector {4.0f});
+    obj->endUpdate();
+    CPPUNIT_ASSERT(obj->mAttributeSetMask.test(mFloatVectorKey.mIndex) == true);
+    CPPUNIT_ASSERT(obj->get(mFloatVectorKey) == FloatVector({4.0f}));
+    CPPUNIT_ASSERT(!obj->getShared(mFloatVectorKey));
+    CPPUNIT_ASSERT(*shared == FloatVector({1.0f, 2.0f, 3.0f}));
+
+    // A single timestep stops sharing, the other one still shares.
+    obj2->beginUpdate();
+    obj2->set(mBlurFloatVectorKey, FloatVector {5.0f}, TIMESTEP_END);
+    obj2->endUpdate();
+    CPPUNIT_ASSERT(&obj2->get(mBlurFloatVectorKey, TIMESTEP_BEGIN) == shared.get());
+    CPPUNIT_ASSERT(obj2->get(mBlurFloatVectorKey, TIMESTEP_END) == FloatVector({5.0f}));
+
+    // Mutable access copies the shared buffer first.
+    FloatVector& mutableValues = obj2->getMutable(mBlurFloatVectorKey, TIMESTEP_BEGIN);
+    CPPUNIT_ASSERT(&mutableValues != shared.get());
+    CPPUNIT_ASSERT(mutableValues == *shared);
+    mutableValues.push_back(6.0f);
+    CPPUNIT_ASSERT(shared->size() == 3);
+    CPPUNIT_ASSERT(!obj2->getShared(mBlurFloatVectorKey, TIMESTEP_BEGIN));
+    CPPUNIT_ASSERT(shared.use_count() == 1);
+
+    // makeShared() moves the owned value into a buffer, without a change.
+    obj->commitChanges();
+    const float* data = obj->get(mFloatVectorKey).data();
+    const std::shared_ptr<const FloatVector> made = obj->makeShared(mFloatVectorKey);
+    CPPUNIT_ASSERT(made->data() == data);
+    CPPUNIT_ASSERT(obj->makeShared(mFloatVectorKey) == made);
+    CPPUNIT_ASSERT(&obj->get(mFloatVectorKey) == made.get());
+    CPPUNIT_ASSERT(obj->mAttributeSetMask.test(mFloatVectorKey.mIndex) == false);
+
+    mDsoClass->destroyObject(obj);
+    mDsoClass->destroyObject(obj2);
+}
+
+void
+TestSceneObject::testGetInterpolated()
+{
+    SceneContext context;
+    setupMotionBlur(context);
+
+    SceneClass sc(&context, "ExampleObject", ObjectFactory::createDsoFactory("ExampleObject", "."));
+    AttributeKey<Float> floatKey = sc.declareAttribute<Float>("float", 0.0f, FLAGS_BLURRABLE);
+    AttributeKey<Rgb> rgbKey = sc.declareAttribute<Rgb>("rgb", Rgb(0.0f), FLAGS_BLURRABLE);
+    AttributeKey<Vec3f> vec3fKey = sc.declareAttribute<Vec3f>("vec3f", Vec3f(0.0f), FLAGS_BLURRABLE);
+    AttributeKey<Mat4d> mat4dKey = sc.declareAttribute<Mat4d>("mat4d", Mat4d(math::one), FLAGS_BLURRABLE);
+    AttributeKey<Float> constantKey = sc.declareAttribute<Float>("constant", 0.0f);
+    sc.setComplete();
+
+    std::vector<SceneObject*> objects;
+    for (int i = 0; i < 5; ++i) {
+        const float f = static_cast<float>(i);
+        SceneObject* obj = sc.createObject("/seq/shot/pizza" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(floatKey, f, TIMESTEP_BEGIN);
+        obj->set(floatKey, 10.0f - 3.0f * f, TIMESTEP_END);
+        obj->set(rgbKey, Rgb(0.1f * f, 0.2f, 0.3f), TIMESTEP_BEGIN);
+        obj->set(rgbKey, Rgb(0.4f, 0.5f * f, 0.6f), TIMESTEP_END);
+        obj->set(vec3fKey, Vec3f(f, 2.0f * f, -f), TIMESTEP_BEGIN);
+        obj->set(vec3fKey, Vec3f(-3.0f * f, 1.0f, 5.0f + f), TIMESTEP_END);
+        obj->set(mat4dKey, makeXform(0.1 * i, Vec3d(1.0, 2.0, 3.0)), TIMESTEP_BEGIN);
+        obj->set(mat4dKey, makeXform(0.3 * i + 0.5, Vec3d(-1.0, 0.5 * i, 0.0)), TIMESTEP_END);
+        obj->set(constantKey, 7.0f + f);
+        obj->endUpdate();
+        objects.push_back(obj);
+    }
+
+    // More than one 8 wide block, with a tail, and extrapolation on both
+    // sides of the shutter interval.
+    std::vector<float> times;
+    for (int i = 0; i < 19; ++i) {
+        times.push_back(-1.0f + 0.15f * i);
+    }
+
+    checkGetInterpolated(floatKey, objects, times, 1e-5f);
+    checkGetInterpolated(rgbKey, objects, times, 1e-5f);
+    checkGetInterpolated(vec3fKey, objects, times, 1e-5f);
+    checkGetInterpolated(mat4dKey, objects, times, 1e-9);
+    checkGetInterpolated(constantKey, objects, times, 0.0f);
+
+    // Nothing to do for empty batches.
+    SceneObject::getInterpolated(floatKey, objects.data(), 0, times.data(), times.size(), (Float*)nullptr);
+    SceneObject::getInterpolated(floatKey, objects.data(), objects.size(), times.data(), 0, (Float*)nullptr);
+
+    for (SceneObject* obj : objects) {
+        sc.destroyObject(obj);
+    }
+}
+
+void
+TestSceneObject::testGetInterpolatedBenchmark()
+{
+    const std::size_t objectTotal = 20000;
+    const std::size_t timeTotal = 16;
+
+    SceneContext context;
+    setupMotionBlur(context);
+
+    SceneClass sc(&context, "ExampleObject", ObjectFactory::createDsoFactory("ExampleObject", "."));
+    AttributeKey<Float> floatKey = sc.declareAttribute<Float>("float", 0.0f, FLAGS_BLURRABLE);
+    AttributeKey<Vec3f> vec3fKey = sc.declareAttribute<Vec3f>("vec3f", Vec3f(0.0f), FLAGS_BLURRABLE);
+    AttributeKey<Mat4d> mat4dKey = sc.declareAttribute<Mat4d>("mat4d", Mat4d(math::one), FLAGS_BLURRABLE);
+    sc.setComplete();
+
+    std::vector<SceneObject*> objects;
+    for (std::size_t i = 0; i < objectTotal; ++i) {
+        const float f = static_cast<float>(i % 100);
+        SceneObject* obj = sc.createObject("/seq/shot/pizza" + std::to_string(i));
+        obj->beginUpdate();
+        obj->set(floatKey, f, TIMESTEP_BEGIN);
+        obj->set(floatKey, -f, TIMESTEP_END);
+        obj->set(vec3fKey, Vec3f(f, 1.0f, 2.0f), TIMESTEP_BEGIN);
+        obj->set(vec3fKey, Vec3f(2.0f, f, 1.0f), TIMESTEP_END);
+        obj->set(mat4dKey, makeXform(0.01 * f, Vec3d(f, 0.0, 0.0)), TIMESTEP_BEGIN);
+        obj->set(mat4dKey, makeXform(0.02 * f, Vec3d(0.0, f, 0.0)), TIMESTEP_END);
+        obj->endUpdate();
+        objects.push_back(obj);
+    }
+
+    std::vector<float> times(timeTotal);
+    for (std::size_t j = 0; j < timeTotal; ++j) {
+        times[j] = static_cast<float>(j) / static_cast<float>(timeTotal - 1);
+    }
+
+    rec_time::RecTime recTime;
+    auto bench = [&](auto key, const char* typeName) {
+        using T = typename decltype(key)::Type;
+        std::vector<T> results(objectTotal * timeTotal);
+
+        recTime.start();
+        for (std::size_t i = 0; i < objectTotal; ++i) {
+            for (std::size_t j = 0; j < timeTotal; ++j) {
+                results[i * timeTotal + j] = objects[i]->get(key, times[j]);
+            }
+        }
+        const float scalarSec = recTime.end();
+
+        recTime.start();
+        SceneObject::getInterpolated(key, objects.data(), objectTotal,
+                                     times.data(), timeTotal, results.data());
+        const float batchSec = recTime.end();
+
+        std::cerr << "\n>> TestSceneObject getInterpolated() " << typeName
+                  << " objects:" << objectTotal << " times:" << timeTotal
+                  << " scalar:" << scalarSec * 1000.0f << " ms"
+                  << " batch:" << batchSec * 1000.0f << " ms"
+                  << " (x" << scalarSec / batchSec << ")";
+    };
+    bench(floatKey, "Float");
+    bench(vec3fKey, "Vec3f");
+    bench(mat4dKey, "Mat4d");
+    std::cerr << '\n';
+
+    for (SceneObject* obj : objects) {
+        sc.destroyObject(obj);
+    }
+}
+
 } // namespace unittest
 } // namespace rdl2
 } // namespace scene_rdl2
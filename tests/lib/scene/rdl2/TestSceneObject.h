@@ -60,6 +60,23 @@ public:
     /// Mostly a compilation test.
     void testExtension();
 
+    /// Test that the move set() overloads behave like the copy ones.
+    void testMoveSet();
+
+    /// Compare copy and move set() latency for large vector attributes.
+    void testSetBenchmark();
+
+    /// Count the attribute buffers which copy and move set() leave alive.
+    void testSetMemory();
+    void testSetShared();
+
+    /// Test that the batch interpolated get matches the interpolated get().
+    void testGetInterpolated();
+
+    /// Compare the batch interpolated get against a loop of interpolated
+    /// get() calls.
+    void testGetInterpolatedBenchmark();
+
     CPPUNIT_TEST_SUITE(TestSceneObject);
     CPPUNIT_TEST(testGetClass);
     CPPUNIT_TEST(testGetName);
@@ -72,6 +89,12 @@ public:
     CPPUNIT_TEST(testAttributeSetMask);
     CPPUNIT_TEST(testBindings);
     CPPUNIT_TEST(testExtension);
+    CPPUNIT_TEST(testMoveSet);
+    CPPUNIT_TEST(testSetBenchmark);
+    CPPUNIT_TEST(testSetMemory);
+    CPPUNIT_TEST(testSetShared);
+    CPPUNIT_TEST(testGetInterpolated);
+    CPPUNIT_TEST(testGetInterpolatedBenchmark);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -111,6 +134,7 @@ private:
     AttributeKey<scene_rdl2::rdl2::Mat4fVector> mMat4fVectorKey;
     AttributeKey<scene_rdl2::rdl2::Mat4dVector> mMat4dVectorKey;
     AttributeKey<scene_rdl2::rdl2::SceneObjectVector> mSceneObjectVectorKey;
+    AttributeKey<scene_rdl2::rdl2::FloatVector> mBlurFloatVectorKey;
 
     AttributeKey<scene_rdl2::rdl2::Float> mBindableKey;
 
@@ -8,8 +8,15 @@
 #include <scene_rdl2/scene/rdl2/SceneClass.h>
 #include <scene_rdl2/scene/rdl2/SceneObject.h>
 
+#include <scene_rdl2/common/except/exceptions.h>
 #include <scene_rdl2/common/rec_time/RecTime.h>
+#include <scene_rdl2/render/util/GetEnv.h>
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <vector>
 #include <float.h>
 #include <stdio.h> // rand()
@@ -18,6 +25,40 @@ namespace scene_rdl2 {
 namespace rdl2 {
 namespace unittest {
 
+namespace {
+
+// Enqueues a mix of small values and vectors, about 1KByte for each loop.
+void
+enqMixedData(ValueContainerEnq &vcEnq, size_t loopTotal)
+{
+    FloatVector floatVec(200);
+    for (size_t i = 0; i < floatVec.size(); ++i) floatVec[i] = static_cast<float>(i) * 0.5f;
+
+    for (size_t loop = 0; loop < loopTotal; ++loop) {
+        vcEnq.enqBool(loop % 2 == 0);
+        vcEnq.enqVLSizeT(loop);
+        vcEnq.enqString("/seq/shot/object" + std::to_string(loop));
+        vcEnq.enqVec3f(Vec3f(1.0f, 2.0f, static_cast<float>(loop)));
+        vcEnq.enqFloatVector(floatVec);
+    }
+}
+
+void
+deqMixedData(ValueContainerDeq &vcDeq, size_t loopTotal)
+{
+    for (size_t loop = 0; loop < loopTotal; ++loop) {
+        CPPUNIT_ASSERT(vcDeq.deqBool() == (loop % 2 == 0));
+        CPPUNIT_ASSERT(vcDeq.deqVLSizeT() == loop);
+        CPPUNIT_ASSERT(vcDeq.deqString() == "/seq/shot/object" + std::to_string(loop));
+        CPPUNIT_ASSERT(vcDeq.deqVec3f() == Vec3f(1.0f, 2.0f, static_cast<float>(loop)));
+        const FloatVector floatVec = vcDeq.deqFloatVector();
+        CPPUNIT_ASSERT(floatVec.size() == 200);
+        CPPUNIT_ASSERT(floatVec[199] == 99.5f);
+    }
+}
+
+} // namespace
+
 void    
 TestValueContainer::setUp()
 {
@@ -1219,6 +1260,265 @@ TestValueContainer::testVLLongVector() // int64_t
              });
 }
 
+void
+TestValueContainer::testStreamVByteIntVector()
+{
+    // every size up to a few SIMD blocks, so that all the tail cases are decoded
+    for (size_t size = 0; size < 64; ++size) {
+        IntVector vec(size);
+        for (size_t i = 0; i < size; ++i) {
+            switch (i % 6) {
+            case 0 : vec[i] = static_cast<int>(i); break;
+            case 1 : vec[i] = -static_cast<int>(i); break;
+            case 2 : vec[i] = 300 * static_cast<int>(i); break;
+            case 3 : vec[i] = -70000 * static_cast<int>(i); break;
+            case 4 : vec[i] = std::numeric_limits<int>::max(); break;
+            case 5 : vec[i] = std::numeric_limits<int>::min(); break;
+            }
+        }
+
+        testMain("testStreamVByteIntVector",
+                 [&](ValueContainerEnq *vcEnq) -> size_t { // enqFunc
+                     vcEnq->enqStreamVByteIntVector(vec);
+                     std::vector<char> work(ValueContainerUtil::streamVByteMaxSize(vec.size()));
+                     return (ValueContainerUtil::variableLengthEncodingSize(vec.size()) +
+                             ValueContainerUtil::streamVByteEncoding(vec.data(), vec.size(), work.data()));
+                 },
+                 [&](ValueContainerDeq *vcDeq) { // deqFunc
+                     IntVector pVec = vcDeq->deqStreamVByteIntVector();
+                     CPPUNIT_ASSERT(compareVector(vec, pVec));
+                 });
+    }
+}
+
+void
+TestValueContainer::testStreamVByteUIntVector()
+{
+    for (size_t size = 0; size < 64; ++size) {
+        ValueContainerEnq::UIntVector vec(size);
+        for (size_t i = 0; i < size; ++i) {
+            // 1, 2, 3 and 4 byte values
+            vec[i] = static_cast<unsigned int>(i) << ((i % 4) * 8);
+        }
+
+        testMain("testStreamVByteUIntVector",
+                 [&](ValueContainerEnq *vcEnq) -> size_t { // enqFunc
+                     vcEnq->enqStreamVByteUIntVector(vec);
+                     size_t total = ValueContainerUtil::variableLengthEncodingSize(vec.size()) + (size + 3) / 4;
+                     for (unsigned int v : vec) {
+                         total += (v > 0xff) + (v > 0xffff) + (v > 0xffffff) + 1;
+                     }
+                     return total;
+                 },
+                 [&](ValueContainerDeq *vcDeq) { // deqFunc
+                     ValueContainerDeq::UIntVector pVec = vcDeq->deqStreamVByteUIntVector();
+                     CPPUNIT_ASSERT(compareVector(vec, pVec));
+                 });
+    }
+}
+
+void
+TestValueContainer::testStreamVByteBenchmark()
+{
+    // numSample like values : mostly small, some larger
+    IntVector vec(4 * 1024 * 1024);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = static_cast<int>((i * 2654435761u) % ((i % 16 == 0) ? 100000 : 64));
+    }
+
+    std::string vlBuff, svbBuff;
+    {
+        ValueContainerEnq vcEnq(&vlBuff);
+        vcEnq.enqVLIntVector(vec);
+        vcEnq.finalize();
+    }
+    {
+        ValueContainerEnq vcEnq(&svbBuff);
+        vcEnq.enqStreamVByteIntVector(vec);
+        vcEnq.finalize();
+    }
+
+    constexpr int loopTotal = 10;
+    IntVector out;
+    rec_time::RecTime recTime;
+
+    recTime.start();
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        ValueContainerDeq vcDeq(vlBuff.data(), vlBuff.size());
+        vcDeq.deqVLIntVector(out);
+    }
+    const float vlSec = recTime.end();
+    CPPUNIT_ASSERT(out == vec);
+
+    recTime.start();
+    for (int loop = 0; loop < loopTotal; ++loop) {
+        ValueContainerDeq vcDeq(svbBuff.data(), svbBuff.size());
+        vcDeq.deqStreamVByteIntVector(out);
+    }
+    const float svbSec = recTime.end();
+    CPPUNIT_ASSERT(out == vec);
+
+    // throughput of decoded data
+    const float GB = static_cast<float>(vec.size() * sizeof(int) * loopTotal) / (1024.0f * 1024.0f * 1024.0f);
+    std::cerr << "\n>> TestValueContainer IntVector decode values:" << vec.size()
+              << " variableLength:" << GB / vlSec << " GB/s (" << vlBuff.size() << " byte)"
+              << " streamVByte:" << GB / svbSec << " GB/s (" << svbBuff.size() << " byte)"
+              << " (x" << vlSec / svbSec << ")";
+}
+
+void
+TestValueContainer::testChunkSink()
+{
+    constexpr size_t loopTotal = 1000;
+
+    std::string expected;
+    {
+        ValueContainerEnq vcEnq(&expected);
+        enqMixedData(vcEnq, loopTotal);
+        vcEnq.finalize();
+    }
+
+    // small chunks, so that values and vectors are split between chunks
+    ValueContainerChunkSink sink(4096);
+    for (int frame = 0; frame < 2; ++frame) { // 2nd frame reuses the chunks
+        sink.clear();
+        ValueContainerEnq vcEnq(&sink);
+        enqMixedData(vcEnq, loopTotal);
+        const size_t finalSize = vcEnq.finalize();
+        CPPUNIT_ASSERT(finalSize == expected.size());
+        CPPUNIT_ASSERT(sink.size() == expected.size());
+        CPPUNIT_ASSERT(sink.getChunkTotal() > 1);
+
+        std::string bytes;
+        sink.copyTo(bytes);
+        CPPUNIT_ASSERT(bytes == expected);
+
+        ValueContainerDeq vcDeq(bytes.data(), finalSize);
+        deqMixedData(vcDeq, loopTotal);
+    }
+    CPPUNIT_ASSERT(sink.getAllocatedChunkTotal() == sink.getChunkTotal());
+
+    // 2 data back to back in the same sink
+    sink.clear();
+    size_t firstSize = 0;
+    {
+        ValueContainerEnq vcEnq(&sink);
+        enqMixedData(vcEnq, loopTotal);
+        firstSize = vcEnq.finalize();
+    }
+    {
+        ValueContainerEnq vcEnq(&sink);
+        enqMixedData(vcEnq, 1);
+        vcEnq.finalize();
+    }
+    std::string bytes;
+    sink.copyTo(bytes);
+    CPPUNIT_ASSERT(bytes.compare(0, firstSize, expected) == 0);
+    ValueContainerDeq vcDeq(bytes.data() + firstSize, bytes.size() - firstSize);
+    deqMixedData(vcDeq, 1);
+}
+
+void
+TestValueContainer::testFileSink()
+{
+    constexpr size_t loopTotal = 1000;
+    const std::string filename = "TestValueContainer_testFileSink.bin";
+
+    std::string expected;
+    {
+        ValueContainerEnq vcEnq(&expected);
+        enqMixedData(vcEnq, loopTotal);
+        vcEnq.finalize();
+    }
+
+    {
+        ValueContainerFileSink sink(filename, 4096);
+        ValueContainerEnq vcEnq(&sink);
+        enqMixedData(vcEnq, loopTotal);
+        CPPUNIT_ASSERT(vcEnq.finalize() == expected.size());
+        sink.close();
+    }
+
+    std::ifstream in(filename, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CPPUNIT_ASSERT(bytes == expected);
+    std::remove(filename.c_str());
+
+    CPPUNIT_ASSERT_THROW(ValueContainerFileSink("/nonexistent/dir/file.bin"), except::IoError);
+}
+
+void
+TestValueContainer::testEncodeBenchmark()
+{
+    constexpr size_t MB = 1024 * 1024;
+    constexpr size_t blockSize = 4096; // 4KByte at a time
+    FloatVector floatVec(MB / sizeof(float)); // 1MByte
+    for (size_t i = 0; i < floatVec.size(); ++i) floatVec[i] = static_cast<float>(i);
+
+    auto enqData = [&](ValueContainerEnq &vcEnq, size_t totalMB) {
+        for (size_t i = 0; i < totalMB; ++i) {
+            for (size_t j = 0; j < MB / blockSize; ++j) {
+                vcEnq.enqByteData(&floatVec[j * blockSize / sizeof(float)], blockSize);
+            }
+        }
+        return vcEnq.finalize();
+    };
+
+    // Large sizes need a few GByte of memory (std::string + chunk sink) and take a while, so
+    // only sizes up to RDL2_TEST_ENCODE_BENCHMARK_MAX_MB (default 16MB) are measured.
+    // Set it to 1024 for the full 1GB benchmark.
+    const size_t maxMB = scene_rdl2::util::getenv<unsigned>("RDL2_TEST_ENCODE_BENCHMARK_MAX_MB", 16);
+
+    rec_time::RecTime recTime;
+    for (size_t totalMB : {1, 4, 16, 128, 1024}) {
+        if (totalMB > maxMB) {
+            break;
+        }
+
+        std::string buff;
+        recTime.start();
+        size_t stringSize = 0;
+        {
+            ValueContainerEnq vcEnq(&buff);
+            stringSize = enqData(vcEnq, totalMB);
+        }
+        const float stringSec = recTime.end();
+
+        ValueContainerChunkSink sink;
+        recTime.start();
+        size_t sinkSize = 0;
+        {
+            ValueContainerEnq vcEnq(&sink);
+            sinkSize = enqData(vcEnq, totalMB);
+        }
+        const float sinkSec = recTime.end();
+
+        // both encode the same bytes and decode back to the input
+        CPPUNIT_ASSERT(stringSize == buff.size());
+        CPPUNIT_ASSERT(sinkSize == stringSize);
+        size_t offset = 0;
+        bool match = true;
+        sink.crawlAllChunks([&](const char *data, size_t size) {
+                match = match && (std::memcmp(data, buff.data() + offset, size) == 0);
+                offset += size;
+            });
+        CPPUNIT_ASSERT(match && offset == buff.size());
+
+        ValueContainerDeq vcDeq(buff.data(), stringSize);
+        std::vector<char> block(blockSize);
+        for (size_t i = 0; i < totalMB; ++i) {
+            for (size_t j = 0; j < MB / blockSize; ++j) {
+                vcDeq.deqByteData(block.data(), blockSize);
+                CPPUNIT_ASSERT(std::memcmp(block.data(), &floatVec[j * blockSize / sizeof(float)], blockSize) == 0);
+            }
+        }
+
+        std::cerr << "\n>> TestValueContainer encode " << totalMB << "MB"
+                  << " string:" << static_cast<float>(totalMB) / stringSec << " MB/s"
+                  << " chunkSink:" << static_cast<float>(totalMB) / sinkSec << " MB/s";
+    }
+}
+
 } // namespace unittest
 } // namespace rdl2
 } // namespace scene_rdl2
@@ -6,6 +6,7 @@
 
 #include <scene_rdl2/scene/rdl2/ValueContainerDeq.h>
 #include <scene_rdl2/scene/rdl2/ValueContainerEnq.h>
+#include <scene_rdl2/scene/rdl2/ValueContainerSink.h>
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/TestFixture.h>
@@ -76,6 +77,19 @@ public:
     void testSceneObjectIndexable();
     void testVLIntVector();
     void testVLLongVector();
+    void testStreamVByteIntVector();
+    void testStreamVByteUIntVector();
+
+    /// Decode throughput of stream VByte vs variable length IntVector.
+    void testStreamVByteBenchmark();
+
+    /// Test that encoding through sinks gives the same data as a std::string.
+    void testChunkSink();
+    void testFileSink();
+
+    /// Encode throughput from 1MB up to 1GB, std::string vs chunk sink, and their round trip.
+    /// Sizes above 16MB run only when RDL2_TEST_ENCODE_BENCHMARK_MAX_MB allows them.
+    void testEncodeBenchmark();
 
     CPPUNIT_TEST_SUITE(TestValueContainer);
     CPPUNIT_TEST(testBool);
@@ -131,6 +145,12 @@ public:
     CPPUNIT_TEST(testSceneObjectIndexable);
     CPPUNIT_TEST(testVLIntVector);
     CPPUNIT_TEST(testVLLongVector);
+    CPPUNIT_TEST(testStreamVByteIntVector);
+    CPPUNIT_TEST(testStreamVByteUIntVector);
+    CPPUNIT_TEST(testStreamVByteBenchmark);
+    CPPUNIT_TEST(testChunkSink);
+    CPPUNIT_TEST(testFileSink);
+    CPPUNIT_TEST(testEncodeBenchmark);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -3,11 +3,13 @@
 
 
 #include "TestAscii.h"
+#include "TestAsciiSubset.h"
 #include "TestAttribute.h"
 #include "TestAttributeKey.h"
 #include "TestBinary.h"
 #include "TestDso.h"
 #include "TestDsoFinder.h"
+#include "TestISPCSupport.h"
 #include "TestJoint.h"
 #include "TestLayer.h"
 #include "TestProxies.h"
@@ -39,6 +41,7 @@ main(int argc, char* argv[])
     CPPUNIT_TEST_SUITE_REGISTRATION(TestSceneObject);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestSceneContext);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestAscii);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestAsciiSubset);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestBinary);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestSplit);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestSets);
@@ -50,6 +53,7 @@ main(int argc, char* argv[])
     CPPUNIT_TEST_SUITE_REGISTRATION(TestRenderOutput);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestUserData);
     CPPUNIT_TEST_SUITE_REGISTRATION(TestValueContainer);
+    CPPUNIT_TEST_SUITE_REGISTRATION(TestISPCSupport);
 
     return pdevunit::run(argc, argv);
 }
@@ -0,0 +1,133 @@
+# Copyright 2023 DreamWorks Animation LLC
+# SPDX-License-Identifier: Apache-2.0
+
+# Tests of SceneObject.getBuffer() / setFromBuffer() and VectorAttributeView.
+
+import array
+import gc
+import unittest
+
+import scene_rdl2
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+
+def createUserData(context, name="/data"):
+    return context.createSceneObject("UserData", name)
+
+
+class TestBuffer(unittest.TestCase):
+
+    def setUp(self):
+        self.context = scene_rdl2.SceneContext()
+        self.obj = createUserData(self.context)
+
+    def tearDown(self):
+        self.obj = None
+        self.context = None
+        gc.collect()
+
+    def testRoundTrip(self):
+        values = array.array("f", [float(i) * 0.5 for i in range(1000)])
+        self.obj.setFromBuffer("float_values_0", values)
+
+        view = self.obj.getBuffer("float_values_0")
+        self.assertEqual(len(view), 1000)
+        self.assertEqual(view.shape, (1000,))
+        mem = memoryview(view)
+        self.assertTrue(mem.readonly)
+        self.assertEqual(mem.format, "f")
+        self.assertEqual(mem.tolist(), values.tolist())
+        self.assertEqual(view.toList(), values.tolist())
+
+        # (n, 3) vectors, set from a flat buffer
+        self.obj.setFromBuffer("vec3f_values_0", array.array("f", range(30)))
+        view = self.obj.getBuffer("vec3f_values_0")
+        self.assertEqual(view.shape, (10, 3))
+        self.assertEqual(memoryview(view).tolist()[9], [27.0, 28.0, 29.0])
+
+        # not a multiple of the element size
+        with self.assertRaises(RuntimeError):
+            self.obj.setFromBuffer("vec3f_values_0", array.array("f", range(31)))
+
+    def testEmpty(self):
+        view = self.obj.getBuffer("float_values_0")
+        self.assertEqual(len(view), 0)
+        self.assertEqual(memoryview(view).tolist(), [])
+
+    def testReadOnly(self):
+        self.obj.setFromBuffer("float_values_0", array.array("f", [1.0, 2.0]))
+        mem = memoryview(self.obj.getBuffer("float_values_0"))
+        with self.assertRaises(TypeError):
+            mem[0] = 3.0
+
+    def testViewSurvivesSet(self):
+        self.obj.setFromBuffer("float_values_0", array.array("f", [1.0] * 100000))
+        view = self.obj.getBuffer("float_values_0")
+        mem = memoryview(view)
+        del view
+
+        # the attribute storage is replaced (and freed) by the new value
+        self.obj.setFromBuffer("float_values_0", array.array("f", [2.0] * 10))
+        self.obj.setFromBuffer("float_values_0", array.array("f", [3.0] * 200000))
+        self.assertEqual(mem.tolist(), [1.0] * 100000)
+        self.assertEqual(memoryview(self.obj.getBuffer("float_values_0")).tolist(), [3.0] * 200000)
+
+    def testViewSharesValue(self):
+        self.obj.setFromBuffer("float_values_0", array.array("f", [1.0] * 1000))
+        first = self.obj.getBuffer("float_values_0").__array_interface__["data"][0]
+        second = self.obj.getBuffer("float_values_0").__array_interface__["data"][0]
+        self.assertEqual(first, second)
+
+    def testIntRange(self):
+        self.obj.setFromBuffer("int_values", array.array("q", [-2 ** 31, 2 ** 31 - 1]))
+        self.assertEqual(memoryview(self.obj.getBuffer("int_values")).tolist(), [-2 ** 31, 2 ** 31 - 1])
+        with self.assertRaises(OverflowError):
+            self.obj.setFromBuffer("int_values", array.array("q", [0, 2 ** 40]))
+        with self.assertRaises(OverflowError):
+            self.obj.setFromBuffer("int_values", array.array("I", [2 ** 32 - 1]))
+        # the attribute keeps its value
+        self.assertEqual(memoryview(self.obj.getBuffer("int_values")).tolist(), [-2 ** 31, 2 ** 31 - 1])
+
+    def testViewSurvivesContext(self):
+        self.obj.setFromBuffer("float_values_0", array.array("f", [4.0] * 1000))
+        mem = memoryview(self.obj.getBuffer("float_values_0"))
+        self.obj = None
+        self.context = None
+        gc.collect()
+
+        # allocate something in place of the released storage
+        other = scene_rdl2.SceneContext()
+        createUserData(other).setFromBuffer("float_values_0", array.array("f", [5.0] * 1000))
+        self.assertEqual(mem.tolist(), [4.0] * 1000)
+
+    @unittest.skipIf(numpy is None, "numpy is not available")
+    def testNumpy(self):
+        points = numpy.arange(300, dtype=numpy.float32).reshape(100, 3)
+        self.obj.set("vec3f_values_0", points)
+
+        # README example: the array made from the view is not touched by set()
+        current = numpy.asarray(self.obj.getBuffer("vec3f_values_0"))
+        self.assertEqual(current.shape, (100, 3))
+        self.assertTrue(numpy.array_equal(current, points))
+        self.obj.set("vec3f_values_0", current * 2.0)
+        self.assertTrue(numpy.array_equal(current, points))
+        self.assertTrue(numpy.array_equal(numpy.asarray(self.obj.getBuffer("vec3f_values_0")), points * 2.0))
+
+        # the array keeps the view alive
+        current = numpy.asarray(self.obj.getBuffer("vec3f_values_0"))
+        gc.collect()
+        self.assertTrue(numpy.array_equal(current, points * 2.0))
+
+        # float buffers are rejected for int attributes
+        with self.assertRaises(RuntimeError):
+            self.obj.setFromBuffer("int_values", numpy.zeros(4, dtype=numpy.float32))
+        self.obj.setFromBuffer("int_values", numpy.arange(4, dtype=numpy.int64))
+        self.assertEqual(memoryview(self.obj.getBuffer("int_values")).tolist(), [0, 1, 2, 3])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,143 @@
+# Copyright 2023 DreamWorks Animation LLC
+# SPDX-License-Identifier: Apache-2.0
+
+# Threading tests of the bindings which release the GIL.
+
+import os
+import shutil
+import tempfile
+import threading
+import unittest
+
+import scene_rdl2
+
+THREAD_COUNT = 8
+
+
+def userDataCode(prefix, count):
+    return "".join('UserData("%s%d") { ["float_values_0"] = {%d, %d.5} }\n' % (prefix, i, i, i)
+                   for i in range(count))
+
+
+def floatValues(context, name):
+    return list(context.getSceneObject(name).getBuffer("float_values_0").toList())
+
+
+def runThreads(target, count=THREAD_COUNT):
+    errors = []
+
+    def run(index):
+        try:
+            target(index)
+        except Exception as e:  # reported by the main thread
+            errors.append(e)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(count)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return errors
+
+
+class TestThreading(unittest.TestCase):
+
+    def setUp(self):
+        self.tmpDir = tempfile.mkdtemp(prefix="py_scene_rdl2_")
+
+    def tearDown(self):
+        shutil.rmtree(self.tmpDir)
+
+    def writeScene(self, index, count=200):
+        context = scene_rdl2.SceneContext()
+        scene_rdl2.AsciiReader(context).fromString(userDataCode("/scene%d_" % index, count))
+        path = os.path.join(self.tmpDir, "scene%d.rdla" % index)
+        scene_rdl2.writeSceneToFile(context, path)
+        return path
+
+    def testSeparateContexts(self):
+        paths = [self.writeScene(i) for i in range(THREAD_COUNT)]
+
+        def work(index):
+            for loop in range(4):
+                context = scene_rdl2.SceneContext()
+                scene_rdl2.readSceneFromFile(paths[index], context)
+                rdlb = os.path.join(self.tmpDir, "out%d.rdlb" % index)
+                scene_rdl2.writeSceneToFile(context, rdlb)
+
+                copy = scene_rdl2.SceneContext()
+                scene_rdl2.BinaryReader(copy).fromFile(rdlb)
+                name = "/scene%d_199" % index
+                assert copy.sceneObjectExists(name), name
+                assert floatValues(copy, name) == [199.0, 199.5], floatValues(copy, name)
+
+        errors = runThreads(work)
+        self.assertEqual(errors, [])
+
+    def testSharedContext(self):
+        # Readers, writers and the SceneContext calls which modify the context
+        # hit the same SceneContext from several threads.
+        context = scene_rdl2.SceneContext()
+        loopCount = 20
+
+        def work(index):
+            kind = index % 3
+            for loop in range(loopCount):
+                if kind == 0:
+                    scene_rdl2.AsciiReader(context).fromString(
+                        userDataCode("/read%d_%d_" % (index, loop), 20))
+                elif kind == 1:
+                    context.createSceneObject("UserData", "/create%d_%d" % (index, loop))
+                    context.commitAllChanges()
+                else:
+                    scene_rdl2.AsciiWriter(context).toString()
+
+        errors = runThreads(work)
+        self.assertEqual(errors, [])
+
+        for index in range(THREAD_COUNT):
+            for loop in range(loopCount):
+                if index % 3 == 0:
+                    self.assertEqual(floatValues(context, "/read%d_%d_19" % (index, loop)), [19.0, 19.5])
+                elif index % 3 == 1:
+                    self.assertTrue(context.sceneObjectExists("/create%d_%d" % (index, loop)))
+
+    def testSharedContextAttributes(self):
+        # SceneObject get()/set() run while other threads write the context
+        # without the GIL.
+        context = scene_rdl2.SceneContext()
+        scene_rdl2.AsciiReader(context).fromString(userDataCode("/attr", THREAD_COUNT))
+        loopCount = 50
+
+        def work(index):
+            obj = context.getSceneObject("/attr%d" % index)
+            for loop in range(loopCount):
+                if index % 2 == 0:
+                    values = [float(loop)] * 1000
+                    obj.set("float_values_0", values)
+                    assert list(obj.get("float_values_0")) == values
+                else:
+                    scene_rdl2.AsciiWriter(context).toString()
+                    obj.get("float_values_0")
+
+        errors = runThreads(work)
+        self.assertEqual(errors, [])
+        for index in range(0, THREAD_COUNT, 2):
+            self.assertEqual(floatValues(context, "/attr%d" % index), [float(loopCount - 1)] * 1000)
+
+    def testReadScenesFromFiles(self):
+        paths = [self.writeScene(i, 50) for i in range(4)]
+        contexts = scene_rdl2.readScenesFromFiles(paths)
+        self.assertEqual(len(contexts), len(paths))
+        for i, context in enumerate(contexts):
+            self.assertTrue(context.sceneObjectExists("/scene%d_49" % i))
+            self.assertFalse(context.sceneObjectExists("/scene%d_49" % ((i + 1) % 4)))
+
+        missing = os.path.join(self.tmpDir, "missing.rdla")
+        with self.assertRaises(RuntimeError) as cm:
+            scene_rdl2.readScenesFromFiles(paths + [missing])
+        self.assertIn(missing, str(cm.exception))
+
+
+if __name__ == "__main__":
+    unittest.main()